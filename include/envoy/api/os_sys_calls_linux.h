@@ -4,6 +4,7 @@
 #error "Linux platform file is part of non-Linux build."
 #endif
 
+#include <linux/io_uring.h>
 #include <sched.h>
 
 #include "envoy/api/os_sys_calls_common.h"
@@ -20,6 +21,57 @@ public:
    * @see sched_getaffinity (man 2 sched_getaffinity)
    */
   virtual SysCallIntResult sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t* mask) PURE;
+
+  /**
+   * @see sched_setaffinity (man 2 sched_setaffinity)
+   */
+  virtual SysCallIntResult sched_setaffinity(pid_t pid, size_t cpusetsize,
+                                             const cpu_set_t* mask) PURE;
+
+  /**
+   * @see getcpu (man 2 getcpu)
+   */
+  virtual SysCallIntResult getcpu(unsigned* cpu, unsigned* node) PURE;
+
+  /**
+   * @see set_mempolicy (man 2 set_mempolicy)
+   */
+  virtual SysCallIntResult set_mempolicy(int mode, const unsigned long* nodemask,
+                                         unsigned long maxnode) PURE;
+
+  /**
+   * @see get_mempolicy (man 2 get_mempolicy)
+   */
+  virtual SysCallIntResult get_mempolicy(int* mode, unsigned long* nodemask, unsigned long maxnode,
+                                         void* addr, unsigned long flags) PURE;
+
+  /**
+   * @see pipe2 (man 2 pipe2)
+   */
+  virtual SysCallIntResult pipe2(int pipefd[2], int flags) PURE;
+
+  /**
+   * @see splice (man 2 splice)
+   */
+  virtual SysCallSizeResult splice(int fd_in, loff_t* off_in, int fd_out, loff_t* off_out,
+                                   size_t len, unsigned int flags) PURE;
+
+  /**
+   * @see io_uring_setup (man 2 io_uring_setup)
+   */
+  virtual SysCallIntResult io_uring_setup(unsigned entries, io_uring_params* params) PURE;
+
+  /**
+   * @see io_uring_enter (man 2 io_uring_enter)
+   */
+  virtual SysCallIntResult io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                                          unsigned flags) PURE;
+
+  /**
+   * @see io_uring_register (man 2 io_uring_register)
+   */
+  virtual SysCallIntResult io_uring_register(int fd, unsigned opcode, const void* arg,
+                                             unsigned nr_args) PURE;
 };
 
 using LinuxOsSysCallsPtr = std::unique_ptr<LinuxOsSysCalls>;
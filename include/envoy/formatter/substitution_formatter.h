@@ -75,6 +75,32 @@ public:
                                          const Http::ResponseTrailerMap& response_trailers,
                                          const StreamInfo::StreamInfo& stream_info,
                                          absl::string_view local_reply_body) const PURE;
+
+  /**
+   * Extract a value from the provided headers/trailers/stream, and append it to an output buffer.
+   * Providers whose value is readily available as a string view override this to skip the
+   * temporary string format() returns.
+   * @param output supplies the buffer the value is appended to.
+   * @param request_headers supplies the request headers.
+   * @param response_headers supplies the response headers.
+   * @param response_trailers supplies the response trailers.
+   * @param stream_info supplies the stream info.
+   * @param local_reply_body supplies the local reply body.
+   * @return bool whether a value was appended. Nothing is appended when the value is unspecified.
+   */
+  virtual bool formatTo(std::string& output, const Http::RequestHeaderMap& request_headers,
+                        const Http::ResponseHeaderMap& response_headers,
+                        const Http::ResponseTrailerMap& response_trailers,
+                        const StreamInfo::StreamInfo& stream_info,
+                        absl::string_view local_reply_body) const {
+    const absl::optional<std::string> value =
+        format(request_headers, response_headers, response_trailers, stream_info, local_reply_body);
+    if (!value.has_value()) {
+      return false;
+    }
+    output.append(value.value());
+    return true;
+  }
 };
 
 using FormatterProviderPtr = std::unique_ptr<FormatterProvider>;
@@ -405,6 +405,9 @@ struct Http1Settings {
   // - if true, the HTTP/1.1 connection is left open (where possible)
   // - if false, the HTTP/1.1 connection is terminated
   bool stream_error_on_invalid_http_message_{false};
+
+  // Parse messages with the vectorized parser instead of http_parser.
+  bool use_vectorized_parser_{false};
 };
 
 /**
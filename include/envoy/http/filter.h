@@ -11,6 +11,7 @@
 #include "envoy/grpc/status.h"
 #include "envoy/http/codec.h"
 #include "envoy/http/header_map.h"
+#include "envoy/http/stream_arena.h"
 #include "envoy/matcher/matcher.h"
 #include "envoy/router/router.h"
 #include "envoy/ssl/connection.h"
@@ -554,6 +555,13 @@ public:
    */
   virtual void
   requestRouteConfigUpdate(RouteConfigUpdatedCallbackSharedPtr route_config_updated_cb) PURE;
+
+  /**
+   * @return StreamArenaOptRef the arena of the stream, from which the filter may allocate memory
+   *         that lives until the stream is destroyed. Not set unless the connection manager is
+   *         configured with a stream arena block size.
+   */
+  virtual StreamArenaOptRef streamArena() PURE;
 };
 
 /**
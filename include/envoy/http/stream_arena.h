@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "envoy/common/optref.h"
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * Monotonic memory arena whose lifetime is tied to an HTTP stream. Memory allocated from the arena
+ * is never freed individually: it is all released at once when the stream is destroyed, after the
+ * stream's filters. This makes allocating from it much cheaper than allocating from the heap, for
+ * objects which live for most of the stream anyway.
+ */
+class StreamArena {
+public:
+  virtual ~StreamArena() = default;
+
+  /**
+   * Allocate memory which remains valid until the stream is destroyed.
+   * @param size supplies the number of bytes to allocate.
+   * @param alignment supplies the alignment of the memory, which must be a power of two no larger
+   *        than alignof(std::max_align_t).
+   * @return void* the allocated memory. Never nullptr.
+   */
+  virtual void* allocate(size_t size, size_t alignment) PURE;
+
+  /**
+   * Register a function to call when the arena is released. Functions are called in the reverse
+   * order of their registration, before the memory of the arena is released.
+   * @param cleanup supplies the function to call.
+   * @param object supplies the argument to call cleanup with.
+   */
+  virtual void addCleanup(void (*cleanup)(void*), void* object) PURE;
+
+  /**
+   * Construct an object in memory allocated from the arena. Its destructor, if it is not trivial,
+   * is called when the arena is released.
+   * @param args supplies the arguments of the constructor of T.
+   * @return T& the constructed object.
+   */
+  template <class T, class... Args> T& create(Args&&... args) {
+    T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    if (!std::is_trivially_destructible<T>::value) {
+      addCleanup([](void* object) { static_cast<T*>(object)->~T(); }, object);
+    }
+    return *object;
+  }
+};
+
+using StreamArenaOptRef = OptRef<StreamArena>;
+
+/**
+ * Deleter for objects which are either allocated from a StreamArena or from the heap. Objects
+ * allocated from an arena are only destroyed: their memory is released with the arena.
+ */
+template <class T> class StreamArenaDeleter {
+public:
+  StreamArenaDeleter() = default;
+  explicit StreamArenaDeleter(bool arena_allocated) : arena_allocated_(arena_allocated) {}
+
+  void operator()(T* object) const {
+    if (arena_allocated_) {
+      object->~T();
+    } else {
+      delete object;
+    }
+  }
+
+private:
+  bool arena_allocated_{};
+};
+
+template <class T> using StreamArenaPtr = std::unique_ptr<T, StreamArenaDeleter<T>>;
+
+/**
+ * Construct an object in memory allocated from an arena, if there is one, or from the heap. The
+ * object is destroyed when the returned pointer is, and must not outlive the arena.
+ * @param arena supplies the arena to allocate from, if any.
+ * @param args supplies the arguments of the constructor of T.
+ * @return StreamArenaPtr<T> the constructed object.
+ */
+template <class T, class... Args>
+StreamArenaPtr<T> makeStreamArenaPtr(StreamArenaOptRef arena, Args&&... args) {
+  if (!arena.has_value()) {
+    return StreamArenaPtr<T>(new T(std::forward<Args>(args)...), StreamArenaDeleter<T>(false));
+  }
+  return StreamArenaPtr<T>(new (arena->allocate(sizeof(T), alignof(T)))
+                               T(std::forward<Args>(args)...),
+                           StreamArenaDeleter<T>(true));
+}
+
+} // namespace Http
+} // namespace Envoy
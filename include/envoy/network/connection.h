@@ -323,6 +323,17 @@ public:
    *  returned.
    */
   virtual absl::optional<std::chrono::milliseconds> lastRoundTripTime() const PURE;
+
+  /**
+   * Provides the underlying socket to a caller that moves data on it directly, e.g. with
+   * splice(2), bypassing the transport socket and the connection's buffers. The caller must
+   * read disable the connection while it does so, must not close the returned handle, and must
+   * stop using it when the connection is closed.
+   * @return IoHandle* the socket's IoHandle if the transport socket passes bytes through
+   *         unmodified, the connection is open and no data is buffered in either direction;
+   *         nullptr otherwise.
+   */
+  virtual IoHandle* spliceableIoHandle() PURE;
 };
 
 using ConnectionPtr = std::unique_ptr<Connection>;
@@ -190,6 +190,12 @@ public:
    */
   virtual bool supportsUdpGro() const PURE;
 
+  /**
+   * return true if received data stays in the kernel until it is read through this handle, so
+   * that it can be moved directly between file descriptors with splice(2).
+   */
+  virtual bool supportsSplice() const PURE;
+
   /**
    * Bind to address. The handle should have been created with a call to socket()
    * @param address address to bind to.
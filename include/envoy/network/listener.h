@@ -38,10 +38,12 @@ public:
 
   /**
    * Called during actual listener creation.
+   * @param worker_index supplies the index of the worker the listener is created on, or 0 for
+   * listeners which don't run on a worker.
    * @return the socket to be used for a certain listener, which might be shared
    * with other listeners of the same config on other worker threads.
    */
-  virtual SocketSharedPtr getListenSocket() PURE;
+  virtual SocketSharedPtr getListenSocket(uint32_t worker_index) PURE;
 
   /**
    * @return the type of the socket getListenSocket() returns.
@@ -153,6 +153,12 @@ public:
    * @return boolean indicating if the transport socket was able to start secure transport.
    */
   virtual bool startSecureTransport() PURE;
+
+  /**
+   * @return bool whether bytes are read from and written to the socket unmodified, so that data
+   *         may be moved on the socket directly without going through this transport socket.
+   */
+  virtual bool passesThroughBytes() const { return false; }
 };
 
 using TransportSocketPtr = std::unique_ptr<TransportSocket>;
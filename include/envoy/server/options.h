@@ -204,6 +204,12 @@ public:
    */
   virtual std::chrono::milliseconds fileFlushIntervalMsec() const PURE;
 
+  /**
+   * @return uint32_t the size in bytes of the per thread buffers of each log file, or 0 when
+   *         files buffer writes from all threads together.
+   */
+  virtual uint32_t fileFlushRingBufferBytes() const PURE;
+
   /**
    * @return const std::string& the server's cluster.
    */
@@ -239,6 +245,24 @@ public:
    */
   virtual bool cpusetThreadsEnabled() const PURE;
 
+  /**
+   * @return const std::vector<uint32_t>& the CPUs the worker threads are pinned to. Worker i is
+   *         pinned to the CPU at index i modulo the size of the list. Empty when workers aren't
+   *         pinned.
+   */
+  virtual const std::vector<uint32_t>& workerCpuSet() const PURE;
+
+  /**
+   * @return const std::vector<uint32_t>& the CPUs the main thread is pinned to, or an empty list
+   *         when it isn't pinned.
+   */
+  virtual const std::vector<uint32_t>& mainThreadCpuSet() const PURE;
+
+  /**
+   * @return bool indicating whether pinned workers allocate memory on the NUMA node of their CPU.
+   */
+  virtual bool numaLocalMemoryEnabled() const PURE;
+
   /**
    * @return the names of extensions to disable.
    */
@@ -84,6 +84,12 @@ public:
    * @return the set of capabilities for handshaker instances created by this context.
    */
   virtual HandshakerCapabilities capabilities() const PURE;
+
+  /**
+   * @return true if the record protection of connections should be offloaded to the kernel once
+   * their handshake completes.
+   */
+  virtual bool kernelTlsOffload() const PURE;
 };
 
 class ClientContextConfig : public virtual ContextConfig {
@@ -157,6 +163,12 @@ public:
    * @return True if stateless TLS session resumption is disabled, false otherwise.
    */
   virtual bool disableStatelessSessionResumption() const PURE;
+
+  /**
+   * @return True if sessions for stateful TLS session resumption are stored in the session cache
+   * shared by all server contexts, false if they are stored in a cache private to the context.
+   */
+  virtual bool sharedSessionCache() const PURE;
 };
 
 using ServerContextConfigPtr = std::unique_ptr<ServerContextConfig>;
@@ -13,6 +13,16 @@ namespace Stats {
 
 using ConstSupportedBuckets = const std::vector<double>;
 
+/**
+ * How worker threads record histogram values between merges.
+ */
+enum class HistogramBackend {
+  // Double buffered circllhist histograms, swapped and accumulated on each merge.
+  Circllhist,
+  // Fixed log-linear buckets of atomic counters, read and summed on each merge without swapping.
+  FixedBuckets,
+};
+
 class HistogramSettings {
 public:
   virtual ~HistogramSettings() = default;
@@ -24,6 +34,11 @@ public:
    * @return The buckets for the histogram. Each value is an upper bound of a bucket.
    */
   virtual ConstSupportedBuckets& buckets(absl::string_view stat_name) const PURE;
+
+  /**
+   * @return the backend used by worker threads to record histogram values.
+   */
+  virtual HistogramBackend backend() const PURE;
 };
 
 using HistogramSettingsConstPtr = std::unique_ptr<const HistogramSettings>;
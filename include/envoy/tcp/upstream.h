@@ -102,6 +102,12 @@ public:
    */
   virtual Tcp::ConnectionPool::ConnectionData*
   onDownstreamEvent(Network::ConnectionEvent event) PURE;
+
+  /**
+   * @return the upstream network connection if data is written to it directly, i.e. it is not
+   *         tunneled, nullptr otherwise.
+   */
+  virtual Network::Connection* connection() PURE;
 };
 
 using GenericConnPoolPtr = std::unique_ptr<GenericConnPool>;
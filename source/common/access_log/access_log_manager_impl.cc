@@ -7,6 +7,9 @@
 #include "common/common/lock_guard.h"
 
 #include "absl/container/fixed_array.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/types/span.h"
 
 namespace Envoy {
 namespace AccessLog {
@@ -30,6 +33,17 @@ AccessLogFileSharedPtr AccessLogManagerImpl::createAccessLog(const std::string&
     return access_logs_[file_name];
   }
 
+  if (file_flush_ring_buffer_bytes_ > 0) {
+    if (flusher_ == nullptr) {
+      flusher_ = std::make_shared<AccessLogFlusher>(
+          dispatcher_, file_stats_, file_flush_interval_msec_, api_.threadFactory());
+    }
+    access_logs_[file_name] = std::make_shared<RingBufferAccessLogFileImpl>(
+        api_.fileSystem().createFile(file_name), lock_, file_stats_, flusher_,
+        file_flush_ring_buffer_bytes_);
+    return access_logs_[file_name];
+  }
+
   access_logs_[file_name] = std::make_shared<AccessLogFileImpl>(
       api_.fileSystem().createFile(file_name), dispatcher_, lock_, file_stats_,
       file_flush_interval_msec_, api_.threadFactory());
@@ -208,5 +222,207 @@ void AccessLogFileImpl::createFlushStructures() {
                                                Thread::Options{"AccessLogFlush"});
 }
 
+AccessLogFlusher::AccessLogFlusher(Event::Dispatcher& dispatcher, AccessLogFileStats& stats,
+                                   std::chrono::milliseconds flush_interval_msec,
+                                   Thread::ThreadFactory& thread_factory)
+    : flush_timer_(dispatcher.createTimer([this]() -> void {
+        stats_.flushed_by_timer_.inc();
+        wakeUp();
+        flush_timer_->enableTimer(flush_interval_msec_);
+      })),
+      flush_interval_msec_(flush_interval_msec), stats_(stats),
+      flush_thread_(thread_factory.createThread([this]() -> void { flushThreadFunc(); },
+                                                Thread::Options{"AccessLogFlush"})) {
+  flush_timer_->enableTimer(flush_interval_msec_);
+}
+
+AccessLogFlusher::~AccessLogFlusher() {
+  {
+    Thread::LockGuard lock(wake_lock_);
+    flush_thread_exit_ = true;
+    wake_event_.notifyOne();
+  }
+  flush_thread_->join();
+}
+
+void AccessLogFlusher::addFile(RingBufferAccessLogFileImpl& file) {
+  Thread::LockGuard lock(files_lock_);
+  files_.insert(&file);
+}
+
+void AccessLogFlusher::removeFile(RingBufferAccessLogFileImpl& file) {
+  Thread::LockGuard lock(files_lock_);
+  files_.erase(&file);
+}
+
+void AccessLogFlusher::wakeUp() {
+  Thread::LockGuard lock(wake_lock_);
+  flush_requested_ = true;
+  wake_event_.notifyOne();
+}
+
+void AccessLogFlusher::flushThreadFunc() {
+  while (true) {
+    {
+      Thread::LockGuard lock(wake_lock_);
+      while (!flush_requested_ && !flush_thread_exit_) {
+        wake_event_.wait(wake_lock_);
+      }
+      if (flush_thread_exit_) {
+        return;
+      }
+      flush_requested_ = false;
+    }
+
+    Thread::LockGuard lock(files_lock_);
+    for (RingBufferAccessLogFileImpl* file : files_) {
+      file->flush();
+    }
+  }
+}
+
+namespace {
+std::atomic<uint64_t> next_ring_buffer_file_id;
+} // namespace
+
+RingBufferAccessLogFileImpl::RingBufferAccessLogFileImpl(Filesystem::FilePtr&& file,
+                                                         Thread::BasicLockable& lock,
+                                                         AccessLogFileStats& stats,
+                                                         AccessLogFlusherSharedPtr flusher,
+                                                         uint32_t ring_buffer_bytes)
+    : file_(std::move(file)), id_(next_ring_buffer_file_id++), file_lock_(lock),
+      ring_buffer_bytes_(ring_buffer_bytes), stats_(stats), flusher_(std::move(flusher)) {
+  open();
+  flusher_->addFile(*this);
+}
+
+RingBufferAccessLogFileImpl::~RingBufferAccessLogFileImpl() {
+  flusher_->removeFile(*this);
+  flush();
+
+  if (file_->isOpen()) {
+    const Api::IoCallBoolResult result = file_->close();
+    ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
+                                   result.err_->getErrorDetails()));
+  }
+}
+
+void RingBufferAccessLogFileImpl::open() {
+  const Api::IoCallBoolResult result = file_->open(AccessLogFileImpl::defaultFlags());
+  if (!result.rc_) {
+    throw EnvoyException(
+        fmt::format("unable to open file '{}': {}", file_->path(), result.err_->getErrorDetails()));
+  }
+}
+
+void RingBufferAccessLogFileImpl::reopen() { reopen_file_ = true; }
+
+void RingBufferAccessLogFileImpl::write(absl::string_view data) {
+  SpscRingBuffer& ring_buffer = threadRingBuffer();
+
+  // The gauge is updated first so that a concurrent flush never takes it below zero.
+  stats_.write_total_buffered_.add(data.length());
+  if (!ring_buffer.write(data)) {
+    stats_.write_total_buffered_.sub(data.length());
+    stats_.write_dropped_.inc();
+    wakeUpFlusher();
+    return;
+  }
+
+  stats_.write_buffered_.inc();
+  if (ring_buffer.size() > ring_buffer.capacity() / 2) {
+    wakeUpFlusher();
+  }
+}
+
+SpscRingBuffer& RingBufferAccessLogFileImpl::threadRingBuffer() {
+  // The ring buffers of the calling thread, by file id. Entries of destroyed files are never looked
+  // up again, and are only freed with the thread.
+  static thread_local absl::flat_hash_map<uint64_t, SpscRingBuffer*> ring_buffers;
+
+  SpscRingBuffer*& ring_buffer = ring_buffers[id_];
+  if (ring_buffer == nullptr) {
+    Thread::LockGuard lock(ring_buffers_lock_);
+    ring_buffers_.push_back(std::make_unique<SpscRingBuffer>(ring_buffer_bytes_));
+    ring_buffer = ring_buffers_.back().get();
+  }
+  return *ring_buffer;
+}
+
+void RingBufferAccessLogFileImpl::wakeUpFlusher() {
+  if (!flush_requested_.exchange(true)) {
+    stats_.flushed_by_backpressure_.inc();
+    flusher_->wakeUp();
+  }
+}
+
+void RingBufferAccessLogFileImpl::flush() {
+  Thread::LockGuard flush_lock(flush_lock_);
+  flush_requested_ = false;
+
+  // if we failed to open file before, then simply ignore
+  if (reopen_file_ && file_->isOpen()) {
+    reopen_file_ = false;
+    try {
+      const Api::IoCallBoolResult result = file_->close();
+      ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
+                                     result.err_->getErrorDetails()));
+      open();
+    } catch (const EnvoyException&) {
+      stats_.reopen_failed_.inc();
+    }
+  }
+
+  // Take a snapshot of what each ring buffer holds. Writers keep appending behind it.
+  absl::InlinedVector<std::pair<SpscRingBuffer*, uint64_t>, 16> ring_buffers;
+  absl::InlinedVector<absl::string_view, 32> slices;
+  uint64_t length = 0;
+  {
+    Thread::LockGuard lock(ring_buffers_lock_);
+    for (const SpscRingBufferPtr& ring_buffer : ring_buffers_) {
+      uint64_t ring_buffer_length = 0;
+      for (absl::string_view slice : ring_buffer->readableSlices()) {
+        if (!slice.empty()) {
+          slices.push_back(slice);
+          ring_buffer_length += slice.size();
+        }
+      }
+      ring_buffers.emplace_back(ring_buffer.get(), ring_buffer_length);
+      length += ring_buffer_length;
+    }
+  }
+  if (length == 0) {
+    return;
+  }
+
+  if (file_->isOpen()) {
+    // See AccessLogFileImpl::doWrite() for why this is done under the cross process lock.
+    Thread::LockGuard lock(file_lock_);
+    absl::Span<absl::string_view> remaining(slices.data(), slices.size());
+    while (!remaining.empty()) {
+      const Api::IoCallSizeResult result = file_->writev(remaining);
+      if (!result.ok() || result.rc_ <= 0) {
+        // Probably disk full.
+        stats_.write_failed_.inc();
+        break;
+      }
+      stats_.write_completed_.inc();
+      uint64_t written = result.rc_;
+      while (!remaining.empty() && written >= remaining.front().size()) {
+        written -= remaining.front().size();
+        remaining.remove_prefix(1);
+      }
+      if (written > 0) {
+        remaining.front().remove_prefix(written);
+      }
+    }
+  }
+
+  for (const auto& [ring_buffer, ring_buffer_length] : ring_buffers) {
+    ring_buffer->release(ring_buffer_length);
+  }
+  stats_.write_total_buffered_.sub(length);
+}
+
 } // namespace AccessLog
 } // namespace Envoy
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/api.h"
@@ -11,17 +13,21 @@
 
 #include "common/buffer/buffer_impl.h"
 #include "common/common/logger.h"
+#include "common/common/spsc_ring_buffer.h"
 #include "common/common/thread.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/node_hash_map.h"
 
 namespace Envoy {
 
 #define ACCESS_LOG_FILE_STATS(COUNTER, GAUGE)                                                      \
+  COUNTER(flushed_by_backpressure)                                                                 \
   COUNTER(flushed_by_timer)                                                                        \
   COUNTER(reopen_failed)                                                                           \
   COUNTER(write_buffered)                                                                          \
   COUNTER(write_completed)                                                                         \
+  COUNTER(write_dropped)                                                                           \
   COUNTER(write_failed)                                                                            \
   GAUGE(write_total_buffered, Accumulate)
 
@@ -31,15 +37,25 @@ struct AccessLogFileStats {
 
 namespace AccessLog {
 
+class AccessLogFlusher;
+using AccessLogFlusherSharedPtr = std::shared_ptr<AccessLogFlusher>;
+
 class AccessLogManagerImpl : public AccessLogManager, Logger::Loggable<Logger::Id::main> {
 public:
-  AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
+  /**
+   * @param file_flush_ring_buffer_bytes supplies the size of the per thread ring buffers of each
+   *        file. When it is 0, each file buffers writes from all threads in a single buffer and
+   *        has its own flush thread instead.
+   */
+  AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec,
+                       uint32_t file_flush_ring_buffer_bytes, Api::Api& api,
                        Event::Dispatcher& dispatcher, Thread::BasicLockable& lock,
                        Stats::Store& stats_store)
-      : file_flush_interval_msec_(file_flush_interval_msec), api_(api), dispatcher_(dispatcher),
-        lock_(lock), file_stats_{
-                         ACCESS_LOG_FILE_STATS(POOL_COUNTER_PREFIX(stats_store, "filesystem."),
-                                               POOL_GAUGE_PREFIX(stats_store, "filesystem."))} {}
+      : file_flush_interval_msec_(file_flush_interval_msec),
+        file_flush_ring_buffer_bytes_(file_flush_ring_buffer_bytes), api_(api),
+        dispatcher_(dispatcher), lock_(lock), file_stats_{ACCESS_LOG_FILE_STATS(
+                                                  POOL_COUNTER_PREFIX(stats_store, "filesystem."),
+                                                  POOL_GAUGE_PREFIX(stats_store, "filesystem."))} {}
   ~AccessLogManagerImpl() override;
 
   // AccessLog::AccessLogManager
@@ -48,10 +64,13 @@ public:
 
 private:
   const std::chrono::milliseconds file_flush_interval_msec_;
+  const uint32_t file_flush_ring_buffer_bytes_;
   Api::Api& api_;
   Event::Dispatcher& dispatcher_;
   Thread::BasicLockable& lock_;
   AccessLogFileStats file_stats_;
+  // Shared by all the files in ring buffer mode, and created with the first of them.
+  AccessLogFlusherSharedPtr flusher_;
   absl::node_hash_map<std::string, AccessLogFileSharedPtr> access_logs_;
 };
 
@@ -59,8 +78,8 @@ private:
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
  * This implementation uses a flush thread per file, with the idea there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * files. See RingBufferAccessLogFileImpl for an implementation with a single flush thread that
+ * flushes all files.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
@@ -81,15 +100,15 @@ public:
   void reopen() override;
   void flush() override;
 
+  // return default flags set which used by open
+  static Filesystem::FlagSet defaultFlags();
+
 private:
   void doWrite(Buffer::Instance& buffer);
   void flushThreadFunc();
   void open();
   void createFlushStructures();
 
-  // return default flags set which used by open
-  static Filesystem::FlagSet defaultFlags();
-
   // Minimum size before the flush thread will be told to flush.
   static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
 
@@ -136,5 +155,94 @@ private:
   AccessLogFileStats& stats_;
 };
 
+class RingBufferAccessLogFileImpl;
+
+/**
+ * Single flush thread for all the ring buffered access log files of a manager. It flushes all of
+ * them when the flush interval elapses, and when asked to by a file whose buffers are filling up.
+ */
+class AccessLogFlusher {
+public:
+  AccessLogFlusher(Event::Dispatcher& dispatcher, AccessLogFileStats& stats,
+                   std::chrono::milliseconds flush_interval_msec,
+                   Thread::ThreadFactory& thread_factory);
+  ~AccessLogFlusher();
+
+  void addFile(RingBufferAccessLogFileImpl& file);
+
+  /**
+   * Stop flushing a file. When this returns, the flush thread isn't flushing it anymore.
+   */
+  void removeFile(RingBufferAccessLogFileImpl& file);
+
+  /**
+   * Have the flush thread flush all the files as soon as possible. This can be called from any
+   * thread.
+   */
+  void wakeUp();
+
+private:
+  void flushThreadFunc();
+
+  Thread::MutexBasicLockable wake_lock_;
+  Thread::CondVar wake_event_;
+  bool flush_requested_ ABSL_GUARDED_BY(wake_lock_){};
+  bool flush_thread_exit_ ABSL_GUARDED_BY(wake_lock_){};
+  // Held by the flush thread while it flushes, so that files are not destroyed under it.
+  Thread::MutexBasicLockable files_lock_;
+  absl::flat_hash_set<RingBufferAccessLogFileImpl*> files_ ABSL_GUARDED_BY(files_lock_);
+  Event::TimerPtr flush_timer_;
+  const std::chrono::milliseconds flush_interval_msec_;
+  AccessLogFileStats& stats_;
+  Thread::ThreadPtr flush_thread_;
+};
+
+/**
+ * Access log file which buffers writes in a lock free ring buffer per writing thread, so that
+ * workers logging to the same file never contend with each other or with the flush thread. The
+ * rings are drained by the AccessLogFlusher shared by all files, with a single gather write per
+ * file and flush. A write which does not fit in the ring of its thread is dropped rather than
+ * blocking the worker.
+ */
+class RingBufferAccessLogFileImpl : public AccessLogFile {
+public:
+  RingBufferAccessLogFileImpl(Filesystem::FilePtr&& file, Thread::BasicLockable& lock,
+                              AccessLogFileStats& stats, AccessLogFlusherSharedPtr flusher,
+                              uint32_t ring_buffer_bytes);
+  ~RingBufferAccessLogFileImpl() override;
+
+  // AccessLog::AccessLogFile
+  void write(absl::string_view data) override;
+  void reopen() override;
+  void flush() override;
+
+private:
+  SpscRingBuffer& threadRingBuffer();
+  void wakeUpFlusher();
+  void open();
+
+  Filesystem::FilePtr file_;
+  // Identifies the file in the per thread caches of ring buffers. Never reused, so that a cache
+  // entry left by a destroyed file can't be mistaken for the ring buffer of a new one.
+  const uint64_t id_;
+  // These locks are always acquired in the following order if multiple locks are held:
+  //    1) flush_lock_
+  //    2) ring_buffers_lock_
+  //    3) file_lock_
+  Thread::BasicLockable& file_lock_; // Cross process lock held while writing to disk, as in
+                                     // AccessLogFileImpl.
+  Thread::MutexBasicLockable flush_lock_; // Held while flushing: only one thread at a time
+                                          // consumes the ring buffers and writes to the file.
+  Thread::MutexBasicLockable ring_buffers_lock_;
+  std::vector<SpscRingBufferPtr> ring_buffers_ ABSL_GUARDED_BY(ring_buffers_lock_);
+  const uint32_t ring_buffer_bytes_;
+  std::atomic<bool> reopen_file_{};
+  // Set when a writer has woken the flusher up, until the flusher gets to this file, so that a
+  // busy worker doesn't wake it up on every write.
+  std::atomic<bool> flush_requested_{};
+  AccessLogFileStats& stats_;
+  const AccessLogFlusherSharedPtr flusher_;
+};
+
 } // namespace AccessLog
 } // namespace Envoy
@@ -2,7 +2,10 @@
 #error "Linux platform file is part of non-Linux build."
 #endif
 
+#include <fcntl.h>
 #include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include <cerrno>
 
@@ -17,5 +20,60 @@ SysCallIntResult LinuxOsSysCallsImpl::sched_getaffinity(pid_t pid, size_t cpuset
   return {rc, errno};
 }
 
+SysCallIntResult LinuxOsSysCallsImpl::sched_setaffinity(pid_t pid, size_t cpusetsize,
+                                                        const cpu_set_t* mask) {
+  const int rc = ::sched_setaffinity(pid, cpusetsize, mask);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
+// The getcpu() wrapper only exists in recent glibc, and the NUMA memory policy calls are only
+// wrapped by libnuma, so these use the system calls directly.
+SysCallIntResult LinuxOsSysCallsImpl::getcpu(unsigned* cpu, unsigned* node) {
+  const int rc = ::syscall(__NR_getcpu, cpu, node, nullptr);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
+SysCallIntResult LinuxOsSysCallsImpl::set_mempolicy(int mode, const unsigned long* nodemask,
+                                                    unsigned long maxnode) {
+  const int rc = ::syscall(__NR_set_mempolicy, mode, nodemask, maxnode);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
+SysCallIntResult LinuxOsSysCallsImpl::get_mempolicy(int* mode, unsigned long* nodemask,
+                                                    unsigned long maxnode, void* addr,
+                                                    unsigned long flags) {
+  const int rc = ::syscall(__NR_get_mempolicy, mode, nodemask, maxnode, addr, flags);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
+SysCallIntResult LinuxOsSysCallsImpl::pipe2(int pipefd[2], int flags) {
+  const int rc = ::pipe2(pipefd, flags);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
+SysCallSizeResult LinuxOsSysCallsImpl::splice(int fd_in, loff_t* off_in, int fd_out,
+                                              loff_t* off_out, size_t len, unsigned int flags) {
+  const ssize_t rc = ::splice(fd_in, off_in, fd_out, off_out, len, flags);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
+// There are no libc wrappers for the io_uring system calls.
+SysCallIntResult LinuxOsSysCallsImpl::io_uring_setup(unsigned entries, io_uring_params* params) {
+  const int rc = ::syscall(__NR_io_uring_setup, entries, params);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
+SysCallIntResult LinuxOsSysCallsImpl::io_uring_enter(int fd, unsigned to_submit,
+                                                     unsigned min_complete, unsigned flags) {
+  const int rc = ::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
+SysCallIntResult LinuxOsSysCallsImpl::io_uring_register(int fd, unsigned opcode, const void* arg,
+                                                        unsigned nr_args) {
+  const int rc = ::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
 } // namespace Api
 } // namespace Envoy
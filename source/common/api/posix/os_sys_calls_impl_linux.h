@@ -15,6 +15,20 @@ class LinuxOsSysCallsImpl : public LinuxOsSysCalls {
 public:
   // Api::LinuxOsSysCalls
   SysCallIntResult sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t* mask) override;
+  SysCallIntResult sched_setaffinity(pid_t pid, size_t cpusetsize, const cpu_set_t* mask) override;
+  SysCallIntResult getcpu(unsigned* cpu, unsigned* node) override;
+  SysCallIntResult set_mempolicy(int mode, const unsigned long* nodemask,
+                                 unsigned long maxnode) override;
+  SysCallIntResult get_mempolicy(int* mode, unsigned long* nodemask, unsigned long maxnode,
+                                 void* addr, unsigned long flags) override;
+  SysCallIntResult pipe2(int pipefd[2], int flags) override;
+  SysCallSizeResult splice(int fd_in, loff_t* off_in, int fd_out, loff_t* off_out, size_t len,
+                           unsigned int flags) override;
+  SysCallIntResult io_uring_setup(unsigned entries, io_uring_params* params) override;
+  SysCallIntResult io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                                  unsigned flags) override;
+  SysCallIntResult io_uring_register(int fd, unsigned opcode, const void* arg,
+                                     unsigned nr_args) override;
 };
 
 using LinuxOsSysCallsSingleton = ThreadSafeSingleton<LinuxOsSysCallsImpl>;
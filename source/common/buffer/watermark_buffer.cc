@@ -1,11 +1,38 @@
 #include "common/buffer/watermark_buffer.h"
 
+#include <algorithm>
+
 #include "common/common/assert.h"
 #include "common/runtime/runtime_features.h"
 
 namespace Envoy {
 namespace Buffer {
 
+std::atomic<bool> WatermarkBufferAccounting::enabled_{false};
+std::array<WatermarkBufferAccounting::Shard, WatermarkBufferAccounting::NumShards>
+    WatermarkBufferAccounting::shards_;
+
+void WatermarkBufferAccounting::add(int64_t delta) {
+  static std::atomic<uint32_t> next_shard{0};
+  thread_local const uint32_t shard = next_shard.fetch_add(1) % NumShards;
+  shards_[shard].bytes_.fetch_add(delta, std::memory_order_relaxed);
+}
+
+uint64_t WatermarkBufferAccounting::bytes() {
+  // The counter of a thread is negative if it drained buffers filled by other threads.
+  int64_t bytes = 0;
+  for (const Shard& shard : shards_) {
+    bytes += shard.bytes_.load(std::memory_order_relaxed);
+  }
+  return std::max<int64_t>(0, bytes);
+}
+
+WatermarkBuffer::~WatermarkBuffer() {
+  if (accounted_bytes_ != 0) {
+    WatermarkBufferAccounting::add(-static_cast<int64_t>(accounted_bytes_));
+  }
+}
+
 void WatermarkBuffer::add(const void* data, uint64_t size) {
   OwnedImpl::add(data, size);
   checkHighAndOverflowWatermarks();
@@ -90,7 +117,20 @@ void WatermarkBuffer::setWatermarks(uint32_t low_watermark, uint32_t high_waterm
   checkLowWatermark();
 }
 
+void WatermarkBuffer::updateAccounting() {
+  if (!WatermarkBufferAccounting::enabled()) {
+    return;
+  }
+  const uint64_t length = OwnedImpl::length();
+  if (length != accounted_bytes_) {
+    WatermarkBufferAccounting::add(static_cast<int64_t>(length) -
+                                   static_cast<int64_t>(accounted_bytes_));
+    accounted_bytes_ = length;
+  }
+}
+
 void WatermarkBuffer::checkLowWatermark() {
+  updateAccounting();
   if (!above_high_watermark_called_ ||
       (high_watermark_ != 0 && OwnedImpl::length() > low_watermark_)) {
     return;
@@ -101,6 +141,7 @@ void WatermarkBuffer::checkLowWatermark() {
 }
 
 void WatermarkBuffer::checkHighAndOverflowWatermarks() {
+  updateAccounting();
   if (high_watermark_ == 0 || OwnedImpl::length() <= high_watermark_) {
     return;
   }
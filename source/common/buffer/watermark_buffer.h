@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <functional>
 #include <string>
 
@@ -8,6 +10,33 @@
 namespace Envoy {
 namespace Buffer {
 
+// Process-wide count of the bytes held by watermark buffers, which hold the data of the requests
+// and responses in flight on connections and streams. Counting is off until enabled by a consumer
+// such as a resource monitor, so that buffers only pay for a relaxed load when it is unused.
+// Changes are added to a counter per thread, so that workers don't contend on the same cache line.
+class WatermarkBufferAccounting {
+public:
+  static void enable() { enabled_.store(true, std::memory_order_relaxed); }
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // Adds the change in the size of a buffer to the counter of the calling thread.
+  static void add(int64_t delta);
+
+  // Returns the bytes held by watermark buffers since counting was enabled.
+  static uint64_t bytes();
+
+private:
+  static constexpr uint32_t NumShards = 64;
+
+  // Aligned so that each counter has a cache line of its own.
+  struct alignas(64) Shard {
+    std::atomic<int64_t> bytes_{0};
+  };
+
+  static std::atomic<bool> enabled_;
+  static std::array<Shard, NumShards> shards_;
+};
+
 // A subclass of OwnedImpl which does watermark validation.
 // Each time the buffer is resized (written to or drained), the watermarks are checked. As the
 // buffer size transitions from under the low watermark to above the high watermark, the
@@ -22,6 +51,7 @@ public:
                   std::function<void()> above_overflow_watermark)
       : below_low_watermark_(below_low_watermark), above_high_watermark_(above_high_watermark),
         above_overflow_watermark_(above_overflow_watermark) {}
+  ~WatermarkBuffer() override;
 
   // Override all functions from Instance which can result in changing the size
   // of the underlying buffer.
@@ -52,6 +82,9 @@ protected:
   void checkLowWatermark();
 
 private:
+  // Adds the change in size since the last call to WatermarkBufferAccounting, if enabled.
+  void updateAccounting();
+
   std::function<void()> below_low_watermark_;
   std::function<void()> above_high_watermark_;
   std::function<void()> above_overflow_watermark_;
@@ -67,6 +100,8 @@ private:
   bool above_high_watermark_called_{false};
   // Set to true when above_overflow_watermark_ is called (and isn't cleared).
   bool above_overflow_watermark_called_{false};
+  // The size of the buffer added to WatermarkBufferAccounting.
+  uint64_t accounted_bytes_{0};
 };
 
 using WatermarkBufferPtr = std::unique_ptr<WatermarkBuffer>;
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "common/common/assert.h"
+#include "common/common/non_copyable.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+
+/**
+ * Fixed-capacity byte ring buffer with a single producer thread and a single consumer thread,
+ * which don't need to synchronize beyond the buffer's own atomics. The producer appends whole
+ * records, which are either written entirely or not at all, and the consumer reads the bytes the
+ * producer has published, in place, before releasing them.
+ */
+class SpscRingBuffer : NonCopyable {
+public:
+  /**
+   * @param capacity supplies the minimum capacity of the buffer in bytes. It is rounded up to a
+   *        power of two.
+   */
+  explicit SpscRingBuffer(uint64_t capacity)
+      : capacity_(roundUpToPowerOfTwo(capacity)), data_(new char[capacity_]) {}
+
+  /**
+   * Append a record. Producer only.
+   * @param data supplies the record.
+   * @return bool whether there was room for the record. Nothing is written if there wasn't.
+   */
+  bool write(absl::string_view data) {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (data.size() > capacity_ - (tail - head_.load(std::memory_order_acquire))) {
+      return false;
+    }
+    const uint64_t offset = tail & (capacity_ - 1);
+    const uint64_t first = std::min<uint64_t>(data.size(), capacity_ - offset);
+    memcpy(data_.get() + offset, data.data(), first);
+    memcpy(data_.get(), data.data() + first, data.size() - first);
+    tail_.store(tail + data.size(), std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @return uint64_t the number of bytes written and not released yet. It is exact for the
+   *         consumer, and an upper bound for the producer.
+   */
+  uint64_t size() const {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+  }
+
+  uint64_t capacity() const { return capacity_; }
+
+  /**
+   * Get the bytes written and not released yet, which are split in two when they wrap around the
+   * end of the buffer. Consumer only.
+   * @return the readable bytes. The second view is empty unless the bytes wrap around.
+   */
+  std::array<absl::string_view, 2> readableSlices() const {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    const uint64_t size = tail_.load(std::memory_order_acquire) - head;
+    const uint64_t offset = head & (capacity_ - 1);
+    const uint64_t first = std::min(size, capacity_ - offset);
+    return {absl::string_view(data_.get() + offset, first),
+            absl::string_view(data_.get(), size - first)};
+  }
+
+  /**
+   * Release bytes at the front of the buffer, making room for the producer. Consumer only.
+   * @param size supplies the number of bytes to release, at most size().
+   */
+  void release(uint64_t size) {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    ASSERT(size <= tail_.load(std::memory_order_acquire) - head);
+    head_.store(head + size, std::memory_order_release);
+  }
+
+private:
+  static uint64_t roundUpToPowerOfTwo(uint64_t value) {
+    uint64_t power = 1;
+    while (power < value) {
+      power <<= 1;
+    }
+    return power;
+  }
+
+  const uint64_t capacity_;
+  const std::unique_ptr<char[]> data_;
+  // Total number of bytes released by the consumer and written by the producer. They are on
+  // different cache lines so that each thread mostly writes to its own.
+  alignas(64) std::atomic<uint64_t> head_{0};
+  alignas(64) std::atomic<uint64_t> tail_{0};
+};
+
+using SpscRingBufferPtr = std::unique_ptr<SpscRingBuffer>;
+
+} // namespace Envoy
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <ios>
+#include <limits>
 #include <set>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "envoy/common/interval_set.h"
@@ -646,6 +650,172 @@ template <class Value> struct TrieLookupTable {
   TrieEntry<Value> root_;
 };
 
+/**
+ * A lookup table for a set of keys which is known when the table is built. The keys are placed
+ * with a perfect hash, using hash and displace: the hash of a key selects a bucket, and each bucket
+ * holds the displacement which sends its keys to slots no other key uses. A lookup hashes the key
+ * once and compares it with at most one entry.
+ */
+template <class Value> class PerfectHashLookupTable {
+public:
+  PerfectHashLookupTable() = default;
+
+  /**
+   * Builds the table.
+   * @param entries supplies the keys, which must be unique, and their values.
+   */
+  explicit PerfectHashLookupTable(std::vector<std::pair<std::string, Value>> entries)
+      : entries_(std::move(entries)) {
+    if (entries_.empty()) {
+      return;
+    }
+    absl::flat_hash_set<absl::string_view> keys;
+    for (const auto& entry : entries_) {
+      RELEASE_ASSERT(keys.insert(entry.first).second, "duplicate key in PerfectHashLookupTable");
+    }
+
+    // Start with at least two slots per key, and double the number of slots every few seeds so
+    // that an unlucky set of keys does not take long to place.
+    size_t slot_count = 2;
+    while (slot_count < 2 * entries_.size()) {
+      slot_count <<= 1;
+    }
+    for (uint64_t seed = 0; !tryBuild(seed, slot_count); ++seed) {
+      if ((seed + 1) % SeedsPerSlotCount == 0) {
+        slot_count <<= 1;
+      }
+    }
+  }
+
+  /**
+   * Finds the value associated with the key.
+   * @param key the key used to find.
+   * @return the value associated with the key, or nullptr if there is none.
+   */
+  const Value* find(absl::string_view key) const {
+    if (entries_.empty()) {
+      return nullptr;
+    }
+    const uint64_t hash = hashKey(key);
+    const uint32_t index = slots_[slotFor(hash, displacements_[hash & bucket_mask_])];
+    if (index == EmptySlot || entries_[index].first != key) {
+      return nullptr;
+    }
+    return &entries_[index].second;
+  }
+
+  size_t size() const { return entries_.size(); }
+
+private:
+  static constexpr uint32_t EmptySlot = std::numeric_limits<uint32_t>::max();
+  static constexpr uint64_t SeedsPerSlotCount = 4;
+  static constexpr uint32_t MaxDisplacement = 1 << 16;
+
+  // Keys are short header or command names, for which this is several times faster than xxHash.
+  uint64_t hashKey(absl::string_view key) const {
+    constexpr uint64_t Multiplier = 0xff51afd7ed558ccd;
+    uint64_t hash = seed_ ^ (key.size() * 0x9e3779b97f4a7c15);
+    const char* data = key.data();
+    size_t length = key.size();
+    for (; length >= 8; data += 8, length -= 8) {
+      uint64_t word;
+      memcpy(&word, data, 8);
+      hash = (hash ^ word) * Multiplier;
+      hash ^= hash >> 32;
+    }
+    if (length > 0) {
+      // The remaining bytes are loaded with fixed size loads, which may overlap bytes already
+      // hashed: the length of the key is part of the hash, so this is still unambiguous.
+      uint64_t word;
+      if (key.size() >= 8) {
+        memcpy(&word, key.data() + key.size() - 8, 8);
+      } else if (length >= 4) {
+        uint32_t low;
+        uint32_t high;
+        memcpy(&low, data, 4);
+        memcpy(&high, data + length - 4, 4);
+        word = static_cast<uint64_t>(high) << 32 | low;
+      } else {
+        word = static_cast<uint8_t>(data[0]) | static_cast<uint8_t>(data[length / 2]) << 8 |
+               static_cast<uint8_t>(data[length - 1]) << 16;
+      }
+      hash = (hash ^ word) * Multiplier;
+    }
+    hash ^= hash >> 29;
+    hash *= 0xc4ceb9fe1a85ec53;
+    return hash ^ (hash >> 32);
+  }
+
+  // The bucket is selected with the low bits of the hash, so the slot is derived from the high
+  // bits, scattered differently by each displacement.
+  size_t slotFor(uint64_t hash, uint32_t displacement) const {
+    return (((hash >> 32) ^ displacement) * 0x9e3779b97f4a7c15) >> slot_shift_;
+  }
+
+  bool tryBuild(uint64_t seed, size_t slot_count) {
+    const size_t bucket_count = slot_count / 2;
+    seed_ = seed;
+    bucket_mask_ = bucket_count - 1;
+    slot_shift_ = 64 - __builtin_ctzll(slot_count);
+    slots_.assign(slot_count, EmptySlot);
+    displacements_.assign(bucket_count, 0);
+
+    std::vector<uint64_t> hashes(entries_.size());
+    std::vector<std::vector<uint32_t>> buckets(bucket_count);
+    for (uint32_t i = 0; i < entries_.size(); ++i) {
+      hashes[i] = hashKey(entries_[i].first);
+      buckets[hashes[i] & bucket_mask_].push_back(i);
+    }
+    // Place the largest buckets first, while most slots are free.
+    std::vector<uint32_t> order(bucket_count);
+    for (uint32_t i = 0; i < bucket_count; ++i) {
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&buckets](uint32_t a, uint32_t b) {
+      return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<size_t> bucket_slots;
+    for (const uint32_t bucket : order) {
+      if (buckets[bucket].empty()) {
+        break;
+      }
+      bool placed = false;
+      for (uint32_t displacement = 0; !placed && displacement < MaxDisplacement; ++displacement) {
+        bucket_slots.clear();
+        placed = true;
+        for (const uint32_t i : buckets[bucket]) {
+          const size_t slot = slotFor(hashes[i], displacement);
+          if (slots_[slot] != EmptySlot ||
+              std::find(bucket_slots.begin(), bucket_slots.end(), slot) != bucket_slots.end()) {
+            placed = false;
+            break;
+          }
+          bucket_slots.push_back(slot);
+        }
+        if (placed) {
+          displacements_[bucket] = displacement;
+          for (size_t j = 0; j < bucket_slots.size(); ++j) {
+            slots_[bucket_slots[j]] = buckets[bucket][j];
+          }
+        }
+      }
+      if (!placed) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::vector<std::pair<std::string, Value>> entries_;
+  // Index into entries_ of the key placed in each slot.
+  std::vector<uint32_t> slots_;
+  std::vector<uint32_t> displacements_;
+  uint64_t seed_{};
+  uint64_t bucket_mask_{};
+  uint32_t slot_shift_{};
+};
+
 /**
  * A global utility class to take care of all the exception throwing behaviors in header files.
  * Its functions simply forward the throwing into .cc file.
@@ -49,6 +49,23 @@ Api::IoCallSizeResult FileImplWin32::write(absl::string_view buffer) {
   return resultSuccess<ssize_t>(bytes_written);
 };
 
+Api::IoCallSizeResult FileImplWin32::writev(absl::Span<const absl::string_view> buffers) {
+  // There is no gather write for regular files opened without FILE_FLAG_NO_BUFFERING.
+  ssize_t total = 0;
+  for (absl::string_view buffer : buffers) {
+    DWORD bytes_written;
+    BOOL result = WriteFile(fd_, buffer.data(), buffer.length(), &bytes_written, NULL);
+    if (result == 0) {
+      return resultFailure<ssize_t>(-1, ::GetLastError());
+    }
+    total += bytes_written;
+    if (bytes_written < buffer.length()) {
+      break;
+    }
+  }
+  return resultSuccess<ssize_t>(total);
+}
+
 Api::IoCallBoolResult FileImplWin32::close() {
   ASSERT(isOpen());
 
@@ -1,7 +1,10 @@
 #include "common/formatter/substitution_formatter.h"
 
+#include <algorithm>
 #include <climits>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
 #include <regex>
 #include <string>
 #include <vector>
@@ -21,6 +24,7 @@
 #include "common/protobuf/utility.h"
 #include "common/stream_info/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "fmt/format.h"
 
@@ -52,6 +56,216 @@ const std::regex& getNewlinePattern() { CONSTRUCT_ON_FIRST_USE(std::regex, "\n")
 template <class... Ts> struct StructFormatMapVisitor : Ts... { using Ts::operator()...; };
 template <class... Ts> StructFormatMapVisitor(Ts...) -> StructFormatMapVisitor<Ts...>;
 
+// Whether a byte can be copied as is into a JSON string. The other ones are escaped, or are part
+// of UTF-8 sequences which have to be validated.
+bool isJsonSafeByte(unsigned char c) {
+  return c >= 0x20 && c < 0x7f && c != '"' && c != '\\' && c != '<' && c != '>';
+}
+
+// The code points the protobuf JSON printer escapes even though JSON doesn't require it: C1
+// controls, and format characters which some JavaScript parsers and browsers handle specially.
+bool isEscapedCodePoint(uint32_t code_point) {
+  return code_point < 0xa0 || code_point == 0xad || (code_point >= 0x600 && code_point <= 0x603) ||
+         code_point == 0x6dd || code_point == 0x70f || code_point == 0x17b4 ||
+         code_point == 0x17b5 || (code_point >= 0x200b && code_point <= 0x200f) ||
+         (code_point >= 0x2028 && code_point <= 0x202e) ||
+         (code_point >= 0x2060 && code_point <= 0x2064) ||
+         (code_point >= 0x206a && code_point <= 0x206f) || code_point == 0xfeff ||
+         (code_point >= 0xfff9 && code_point <= 0xfffb) || code_point == 0xe0001 ||
+         (code_point >= 0xe0020 && code_point <= 0xe007f);
+}
+
+void appendJsonUnicodeEscape(std::string& output, uint32_t code_point) {
+  if (code_point >= 0x10000) {
+    code_point -= 0x10000;
+    appendJsonUnicodeEscape(output, 0xd800 + (code_point >> 10));
+    appendJsonUnicodeEscape(output, 0xdc00 + (code_point & 0x3ff));
+    return;
+  }
+  static constexpr char Hex[] = "0123456789abcdef";
+  const char escape[] = {'\\',
+                         'u',
+                         Hex[(code_point >> 12) & 0xf],
+                         Hex[(code_point >> 8) & 0xf],
+                         Hex[(code_point >> 4) & 0xf],
+                         Hex[code_point & 0xf]};
+  output.append(escape, sizeof(escape));
+}
+
+// Decode the UTF-8 sequence at the start of value.
+// @return the length of the sequence, or 0 if it is invalid.
+size_t decodeUtf8(absl::string_view value, uint32_t& code_point) {
+  const auto byte = [&value](size_t i) { return static_cast<unsigned char>(value[i]); };
+  size_t length;
+  uint32_t min_code_point;
+  if (byte(0) < 0x80) {
+    code_point = byte(0);
+    return 1;
+  } else if ((byte(0) & 0xe0) == 0xc0) {
+    length = 2;
+    min_code_point = 0x80;
+    code_point = byte(0) & 0x1f;
+  } else if ((byte(0) & 0xf0) == 0xe0) {
+    length = 3;
+    min_code_point = 0x800;
+    code_point = byte(0) & 0x0f;
+  } else if ((byte(0) & 0xf8) == 0xf0) {
+    length = 4;
+    min_code_point = 0x10000;
+    code_point = byte(0) & 0x07;
+  } else {
+    return 0;
+  }
+  if (value.size() < length) {
+    return 0;
+  }
+  for (size_t i = 1; i < length; ++i) {
+    if ((byte(i) & 0xc0) != 0x80) {
+      return 0;
+    }
+    code_point = (code_point << 6) | (byte(i) & 0x3f);
+  }
+  if (code_point < min_code_point || code_point > 0x10ffff ||
+      (code_point >= 0xd800 && code_point <= 0xdfff)) {
+    return 0;
+  }
+  return length;
+}
+
+// Append the contents of a JSON string, escaped like the protobuf JSON printer does. Bytes which
+// aren't part of a valid UTF-8 sequence are dropped, so that the output is always valid UTF-8.
+void appendJsonEscaped(std::string& output, absl::string_view value) {
+  size_t i = 0;
+  while (i < value.size()) {
+    size_t safe = i;
+    while (safe < value.size() && isJsonSafeByte(value[safe])) {
+      ++safe;
+    }
+    output.append(value.data() + i, safe - i);
+    if (safe == value.size()) {
+      return;
+    }
+    i = safe;
+
+    uint32_t code_point;
+    const size_t length = decodeUtf8(value.substr(i), code_point);
+    if (length == 0) {
+      ++i;
+      continue;
+    }
+    switch (code_point) {
+    case '"':
+      output.append("\\\"");
+      break;
+    case '\\':
+      output.append("\\\\");
+      break;
+    case '\b':
+      output.append("\\b");
+      break;
+    case '\f':
+      output.append("\\f");
+      break;
+    case '\n':
+      output.append("\\n");
+      break;
+    case '\r':
+      output.append("\\r");
+      break;
+    case '\t':
+      output.append("\\t");
+      break;
+    default:
+      if (isEscapedCodePoint(code_point) || code_point == '<' || code_point == '>') {
+        appendJsonUnicodeEscape(output, code_point);
+      } else {
+        output.append(value.data() + i, length);
+      }
+    }
+    i += length;
+  }
+}
+
+// Append a quoted JSON string.
+void appendJsonString(std::string& output, absl::string_view value) {
+  output.push_back('"');
+  appendJsonEscaped(output, value);
+  output.push_back('"');
+}
+
+// Append a JSON number, formatted like the protobuf JSON printer does: as an integer when it has
+// up to 15 digits, and otherwise with as many significant digits as needed to round trip.
+void appendJsonNumber(std::string& output, double value) {
+  if (!std::isfinite(value)) {
+    appendJsonString(output, std::isnan(value) ? "NaN" : (value > 0 ? "Infinity" : "-Infinity"));
+    return;
+  }
+  // Negative zero is formatted as "-0", which the integer formatting would lose.
+  if (std::abs(value) < 1e15 && value == std::trunc(value) &&
+      !(value == 0 && std::signbit(value))) {
+    const auto digits = fmt::format_int(static_cast<int64_t>(value));
+    output.append(digits.data(), digits.size());
+    return;
+  }
+  std::string digits = fmt::format("{:.15g}", value);
+  if (std::strtod(digits.c_str(), nullptr) != value) {
+    digits = fmt::format("{:.17g}", value);
+  }
+  output.append(digits);
+}
+
+void appendJsonValue(std::string& output, const ProtobufWkt::Value& value) {
+  switch (value.kind_case()) {
+  case ProtobufWkt::Value::kBoolValue:
+    output.append(value.bool_value() ? "true" : "false");
+    break;
+  case ProtobufWkt::Value::kNumberValue:
+    appendJsonNumber(output, value.number_value());
+    break;
+  case ProtobufWkt::Value::kStringValue:
+    appendJsonString(output, value.string_value());
+    break;
+  case ProtobufWkt::Value::kStructValue: {
+    // Struct fields are stored in a hash map; order them by key like the top level fields.
+    std::vector<const Protobuf::MapPair<std::string, ProtobufWkt::Value>*> fields;
+    fields.reserve(value.struct_value().fields().size());
+    for (const auto& field : value.struct_value().fields()) {
+      fields.push_back(&field);
+    }
+    std::sort(fields.begin(), fields.end(),
+              [](const auto* lhs, const auto* rhs) { return lhs->first < rhs->first; });
+    output.push_back('{');
+    bool first = true;
+    for (const auto* field : fields) {
+      if (!first) {
+        output.push_back(',');
+      }
+      first = false;
+      appendJsonString(output, field->first);
+      output.push_back(':');
+      appendJsonValue(output, field->second);
+    }
+    output.push_back('}');
+    break;
+  }
+  case ProtobufWkt::Value::kListValue: {
+    output.push_back('[');
+    bool first = true;
+    for (const auto& element : value.list_value().values()) {
+      if (!first) {
+        output.push_back(',');
+      }
+      first = false;
+      appendJsonValue(output, element);
+    }
+    output.push_back(']');
+    break;
+  }
+  default:
+    output.append("null");
+  }
+}
+
 } // namespace
 
 const std::string SubstitutionFormatUtils::DEFAULT_FORMAT =
@@ -125,14 +339,16 @@ std::string FormatterImpl::format(const Http::RequestHeaderMap& request_headers,
                                   const StreamInfo::StreamInfo& stream_info,
                                   absl::string_view local_reply_body) const {
   std::string log_line;
-  log_line.reserve(256);
+  log_line.reserve(output_size_hint_.get());
 
   for (const FormatterProviderPtr& provider : providers_) {
-    const auto bit = provider->format(request_headers, response_headers, response_trailers,
-                                      stream_info, local_reply_body);
-    log_line += bit.value_or(empty_value_string_);
+    if (!provider->formatTo(log_line, request_headers, response_headers, response_trailers,
+                            stream_info, local_reply_body)) {
+      log_line.append(empty_value_string_);
+    }
   }
 
+  output_size_hint_.update(log_line.size());
   return log_line;
 }
 
@@ -141,11 +357,21 @@ std::string JsonFormatterImpl::format(const Http::RequestHeaderMap& request_head
                                       const Http::ResponseTrailerMap& response_trailers,
                                       const StreamInfo::StreamInfo& stream_info,
                                       absl::string_view local_reply_body) const {
-  const auto output_struct = struct_formatter_.format(
-      request_headers, response_headers, response_trailers, stream_info, local_reply_body);
+  if (!direct_output_) {
+    const ProtobufWkt::Struct output_struct = struct_formatter_.format(
+        request_headers, response_headers, response_trailers, stream_info, local_reply_body);
+    return absl::StrCat(MessageUtil::getJsonStringFromMessage(output_struct, false, true), "\n");
+  }
 
-  const std::string log_line = MessageUtil::getJsonStringFromMessage(output_struct, false, true);
-  return absl::StrCat(log_line, "\n");
+  std::string log_line;
+  log_line.reserve(output_size_hint_.get());
+
+  struct_formatter_.formatJson(log_line, request_headers, response_headers, response_trailers,
+                               stream_info, local_reply_body);
+  log_line.push_back('\n');
+
+  output_size_hint_.update(log_line.size());
+  return log_line;
 }
 
 StructFormatter::StructFormatMapWrapper
@@ -220,6 +446,118 @@ ProtobufWkt::Struct StructFormatter::format(const Http::RequestHeaderMap& reques
   return struct_format_map_callback(struct_output_format_).struct_value();
 }
 
+struct StructFormatter::JsonFormatContext {
+  JsonFormatContext(const Http::RequestHeaderMap& request_headers,
+                    const Http::ResponseHeaderMap& response_headers,
+                    const Http::ResponseTrailerMap& response_trailers,
+                    const StreamInfo::StreamInfo& stream_info, absl::string_view local_reply_body,
+                    std::string& output)
+      : request_headers_(request_headers), response_headers_(response_headers),
+        response_trailers_(response_trailers), stream_info_(stream_info),
+        local_reply_body_(local_reply_body), output_(output) {}
+
+  const Http::RequestHeaderMap& request_headers_;
+  const Http::ResponseHeaderMap& response_headers_;
+  const Http::ResponseTrailerMap& response_trailers_;
+  const StreamInfo::StreamInfo& stream_info_;
+  const absl::string_view local_reply_body_;
+  std::string& output_;
+  // Copy of string values which have to be escaped, reused across values.
+  std::string escape_buffer_;
+};
+
+void StructFormatter::formatJson(std::string& output, const Http::RequestHeaderMap& request_headers,
+                                 const Http::ResponseHeaderMap& response_headers,
+                                 const Http::ResponseTrailerMap& response_trailers,
+                                 const StreamInfo::StreamInfo& stream_info,
+                                 absl::string_view local_reply_body) const {
+  JsonFormatContext context(request_headers, response_headers, response_trailers, stream_info,
+                            local_reply_body, output);
+  formatJsonMap(struct_output_format_, context);
+}
+
+void StructFormatter::formatJsonMap(const StructFormatMapWrapper& format,
+                                    JsonFormatContext& context) const {
+  std::string& output = context.output_;
+  output.push_back('{');
+  bool first = true;
+  for (const auto& pair : *format.value_) {
+    // The key is written before the value is known, and removed if the value is omitted.
+    const size_t field_start = output.size();
+    if (!first) {
+      output.push_back(',');
+    }
+    appendJsonString(output, pair.first);
+    output.push_back(':');
+    const bool written = absl::visit(
+        StructFormatMapVisitor{
+            [this, &context](const StructFormatMapWrapper& nested) {
+              formatJsonMap(nested, context);
+              return true;
+            },
+            [this, &context](const std::vector<FormatterProviderPtr>& providers) {
+              return formatJsonValue(providers, context);
+            }},
+        pair.second);
+    if (written) {
+      first = false;
+    } else {
+      output.resize(field_start);
+    }
+  }
+  output.push_back('}');
+}
+
+bool StructFormatter::formatJsonValue(const std::vector<FormatterProviderPtr>& providers,
+                                      JsonFormatContext& context) const {
+  ASSERT(!providers.empty());
+  std::string& output = context.output_;
+  if (providers.size() == 1 && preserve_types_) {
+    const ProtobufWkt::Value value = providers.front()->formatValue(
+        context.request_headers_, context.response_headers_, context.response_trailers_,
+        context.stream_info_, context.local_reply_body_);
+    if (omit_empty_values_ && value.kind_case() == ProtobufWkt::Value::kNullValue) {
+      return false;
+    }
+    appendJsonValue(output, value);
+    return true;
+  }
+
+  // String values are written as is after the opening quote, and only escaped again when they need
+  // to be, which is rare.
+  output.push_back('"');
+  const size_t value_start = output.size();
+  if (providers.size() == 1) {
+    if (!providers.front()->formatTo(output, context.request_headers_, context.response_headers_,
+                                     context.response_trailers_, context.stream_info_,
+                                     context.local_reply_body_)) {
+      if (omit_empty_values_) {
+        return false;
+      }
+      output.append(DefaultUnspecifiedValueString);
+    }
+  } else {
+    // Multiple providers forces string output.
+    const std::string& empty_value =
+        omit_empty_values_ ? EMPTY_STRING : DefaultUnspecifiedValueString;
+    for (const auto& provider : providers) {
+      if (!provider->formatTo(output, context.request_headers_, context.response_headers_,
+                              context.response_trailers_, context.stream_info_,
+                              context.local_reply_body_)) {
+        output.append(empty_value);
+      }
+    }
+  }
+  const absl::string_view value = absl::string_view(output).substr(value_start);
+  if (!std::all_of(value.begin(), value.end(), isJsonSafeByte)) {
+    context.escape_buffer_.assign(value.data(), value.size());
+    output.resize(value_start);
+    appendJsonEscaped(output, context.escape_buffer_);
+  }
+  output.push_back('"');
+  return true;
+}
+
 void SubstitutionFormatParser::parseCommandHeader(const std::string& token, const size_t start,
                                                   std::string& main_header,
                                                   std::string& alternative_header,
@@ -461,6 +799,16 @@ public:
 
     return fmt::format_int(millis.value()).str();
   }
+  bool extractTo(std::string& output, const StreamInfo::StreamInfo& stream_info) const override {
+    const auto millis = extractMillis(stream_info);
+    if (!millis) {
+      return false;
+    }
+
+    const fmt::format_int digits(millis.value());
+    output.append(digits.data(), digits.size());
+    return true;
+  }
   ProtobufWkt::Value extractValue(const StreamInfo::StreamInfo& stream_info) const override {
     const auto millis = extractMillis(stream_info);
     if (!millis) {
@@ -493,6 +841,11 @@ public:
   absl::optional<std::string> extract(const StreamInfo::StreamInfo& stream_info) const override {
     return fmt::format_int(field_extractor_(stream_info)).str();
   }
+  bool extractTo(std::string& output, const StreamInfo::StreamInfo& stream_info) const override {
+    const fmt::format_int digits(field_extractor_(stream_info));
+    output.append(digits.data(), digits.size());
+    return true;
+  }
   ProtobufWkt::Value extractValue(const StreamInfo::StreamInfo& stream_info) const override {
     return ValueUtil::numberValue(field_extractor_(stream_info));
   }
@@ -828,6 +1181,13 @@ ProtobufWkt::Value StreamInfoFormatter::formatValue(const Http::RequestHeaderMap
   return field_extractor_->extractValue(stream_info);
 }
 
+bool StreamInfoFormatter::formatTo(std::string& output, const Http::RequestHeaderMap&,
+                                   const Http::ResponseHeaderMap&, const Http::ResponseTrailerMap&,
+                                   const StreamInfo::StreamInfo& stream_info,
+                                   absl::string_view) const {
+  return field_extractor_->extractTo(output, stream_info);
+}
+
 PlainStringFormatter::PlainStringFormatter(const std::string& str) { str_.set_string_value(str); }
 
 absl::optional<std::string> PlainStringFormatter::format(const Http::RequestHeaderMap&,
@@ -846,6 +1206,13 @@ ProtobufWkt::Value PlainStringFormatter::formatValue(const Http::RequestHeaderMa
   return str_;
 }
 
+bool PlainStringFormatter::formatTo(std::string& output, const Http::RequestHeaderMap&,
+                                    const Http::ResponseHeaderMap&, const Http::ResponseTrailerMap&,
+                                    const StreamInfo::StreamInfo&, absl::string_view) const {
+  output.append(str_.string_value());
+  return true;
+}
+
 absl::optional<std::string>
 LocalReplyBodyFormatter::format(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                 const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
@@ -861,6 +1228,15 @@ ProtobufWkt::Value LocalReplyBodyFormatter::formatValue(const Http::RequestHeade
   return ValueUtil::stringValue(std::string(local_reply_body));
 }
 
+bool LocalReplyBodyFormatter::formatTo(std::string& output, const Http::RequestHeaderMap&,
+                                       const Http::ResponseHeaderMap&,
+                                       const Http::ResponseTrailerMap&,
+                                       const StreamInfo::StreamInfo&,
+                                       absl::string_view local_reply_body) const {
+  output.append(local_reply_body.data(), local_reply_body.size());
+  return true;
+}
+
 HeaderFormatter::HeaderFormatter(const std::string& main_header,
                                  const std::string& alternative_header,
                                  absl::optional<size_t> max_length)
@@ -900,6 +1276,20 @@ ProtobufWkt::Value HeaderFormatter::formatValue(const Http::HeaderMap& headers)
   return ValueUtil::stringValue(val);
 }
 
+bool HeaderFormatter::formatTo(std::string& output, const Http::HeaderMap& headers) const {
+  const Http::HeaderEntry* header = findHeader(headers);
+  if (!header) {
+    return false;
+  }
+
+  absl::string_view val = header->value().getStringView();
+  if (max_length_) {
+    val = val.substr(0, max_length_.value());
+  }
+  output.append(val.data(), val.size());
+  return true;
+}
+
 ResponseHeaderFormatter::ResponseHeaderFormatter(const std::string& main_header,
                                                  const std::string& alternative_header,
                                                  absl::optional<size_t> max_length)
@@ -917,6 +1307,13 @@ ProtobufWkt::Value ResponseHeaderFormatter::formatValue(
   return HeaderFormatter::formatValue(response_headers);
 }
 
+bool ResponseHeaderFormatter::formatTo(std::string& output, const Http::RequestHeaderMap&,
+                                       const Http::ResponseHeaderMap& response_headers,
+                                       const Http::ResponseTrailerMap&,
+                                       const StreamInfo::StreamInfo&, absl::string_view) const {
+  return HeaderFormatter::formatTo(output, response_headers);
+}
+
 RequestHeaderFormatter::RequestHeaderFormatter(const std::string& main_header,
                                                const std::string& alternative_header,
                                                absl::optional<size_t> max_length)
@@ -936,6 +1333,14 @@ RequestHeaderFormatter::formatValue(const Http::RequestHeaderMap& request_header
   return HeaderFormatter::formatValue(request_headers);
 }
 
+bool RequestHeaderFormatter::formatTo(std::string& output,
+                                      const Http::RequestHeaderMap& request_headers,
+                                      const Http::ResponseHeaderMap&,
+                                      const Http::ResponseTrailerMap&,
+                                      const StreamInfo::StreamInfo&, absl::string_view) const {
+  return HeaderFormatter::formatTo(output, request_headers);
+}
+
 ResponseTrailerFormatter::ResponseTrailerFormatter(const std::string& main_header,
                                                    const std::string& alternative_header,
                                                    absl::optional<size_t> max_length)
@@ -955,6 +1360,13 @@ ResponseTrailerFormatter::formatValue(const Http::RequestHeaderMap&, const Http:
   return HeaderFormatter::formatValue(response_trailers);
 }
 
+bool ResponseTrailerFormatter::formatTo(std::string& output, const Http::RequestHeaderMap&,
+                                        const Http::ResponseHeaderMap&,
+                                        const Http::ResponseTrailerMap& response_trailers,
+                                        const StreamInfo::StreamInfo&, absl::string_view) const {
+  return HeaderFormatter::formatTo(output, response_trailers);
+}
+
 GrpcStatusFormatter::GrpcStatusFormatter(const std::string& main_header,
                                          const std::string& alternative_header,
                                          absl::optional<size_t> max_length)
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
 #include <string>
 #include <vector>
@@ -10,6 +12,7 @@
 #include "envoy/stream_info/stream_info.h"
 
 #include "common/common/utility.h"
+#include "common/runtime/runtime_features.h"
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/types/optional.h"
@@ -102,7 +105,33 @@ private:
 };
 
 /**
- * Composite formatter implementation.
+ * Capacity to reserve for a formatted line, so that formatters write their output into a single
+ * buffer which rarely grows. It is the size of the longest line formatted so far, up to a limit so
+ * that a few oversized lines don't make every later line reserve too much memory. It is shared by
+ * the worker threads and written only when it grows, so it is only a hint.
+ */
+class OutputSizeHint {
+public:
+  explicit OutputSizeHint(size_t size) : size_(std::min(size, MaxSize)) {}
+
+  size_t get() const { return size_.load(std::memory_order_relaxed); }
+
+  void update(size_t size) {
+    size = std::min(size, MaxSize);
+    if (size > size_.load(std::memory_order_relaxed)) {
+      size_.store(size, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  static constexpr size_t MaxSize = 4096;
+
+  std::atomic<size_t> size_;
+};
+
+/**
+ * Composite formatter implementation. Each provider appends its value directly to the output line,
+ * which is reserved up front.
  */
 class FormatterImpl : public Formatter {
 public:
@@ -120,6 +149,7 @@ public:
 private:
   const std::string& empty_value_string_;
   std::vector<FormatterProviderPtr> providers_;
+  mutable OutputSizeHint output_size_hint_{256};
 };
 
 /**
@@ -139,7 +169,20 @@ public:
                              const StreamInfo::StreamInfo& stream_info,
                              absl::string_view local_reply_body) const;
 
+  /**
+   * Format as a JSON object, which is written directly to an output buffer rather than built as a
+   * Struct first. The object has the same fields and values as the Struct format() returns, and is
+   * serialized like the protobuf JSON printer would, with the fields in the order of their keys.
+   * @param output supplies the buffer the JSON object is appended to.
+   */
+  void formatJson(std::string& output, const Http::RequestHeaderMap& request_headers,
+                  const Http::ResponseHeaderMap& response_headers,
+                  const Http::ResponseTrailerMap& response_trailers,
+                  const StreamInfo::StreamInfo& stream_info,
+                  absl::string_view local_reply_body) const;
+
 private:
+  struct JsonFormatContext;
   struct StructFormatMapWrapper;
   using StructFormatMapValue =
       absl::variant<const std::vector<FormatterProviderPtr>, const StructFormatMapWrapper>;
@@ -152,6 +195,9 @@ private:
   };
 
   StructFormatMapWrapper toFormatMap(const ProtobufWkt::Struct& struct_format) const;
+  void formatJsonMap(const StructFormatMapWrapper& format, JsonFormatContext& context) const;
+  bool formatJsonValue(const std::vector<FormatterProviderPtr>& providers,
+                       JsonFormatContext& context) const;
 
   const bool omit_empty_values_;
   const bool preserve_types_;
@@ -162,7 +208,9 @@ class JsonFormatterImpl : public Formatter {
 public:
   JsonFormatterImpl(const ProtobufWkt::Struct& format_mapping, bool preserve_types,
                     bool omit_empty_values)
-      : struct_formatter_(format_mapping, preserve_types, omit_empty_values) {}
+      : struct_formatter_(format_mapping, preserve_types, omit_empty_values),
+        direct_output_(Runtime::runtimeFeatureEnabled(
+            "envoy.reloadable_features.json_formatter_direct_output")) {}
 
   // Formatter::format
   std::string format(const Http::RequestHeaderMap& request_headers,
@@ -173,6 +221,9 @@ public:
 
 private:
   const StructFormatter struct_formatter_;
+  // Whether the JSON is written directly rather than serialized from the formatted Struct.
+  const bool direct_output_;
+  mutable OutputSizeHint output_size_hint_{256};
 };
 
 /**
@@ -190,6 +241,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
+  bool formatTo(std::string& output, const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                absl::string_view) const override;
 
 private:
   ProtobufWkt::Value str_;
@@ -209,6 +263,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view local_reply_body) const override;
+  bool formatTo(std::string& output, const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                absl::string_view local_reply_body) const override;
 };
 
 class HeaderFormatter {
@@ -219,6 +276,7 @@ public:
 protected:
   absl::optional<std::string> format(const Http::HeaderMap& headers) const;
   ProtobufWkt::Value formatValue(const Http::HeaderMap& headers) const;
+  bool formatTo(std::string& output, const Http::HeaderMap& headers) const;
 
 private:
   const Http::HeaderEntry* findHeader(const Http::HeaderMap& headers) const;
@@ -244,6 +302,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
+  bool formatTo(std::string& output, const Http::RequestHeaderMap& request_headers,
+                const Http::ResponseHeaderMap&, const Http::ResponseTrailerMap&,
+                const StreamInfo::StreamInfo&, absl::string_view) const override;
 };
 
 /**
@@ -262,6 +323,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
+  bool formatTo(std::string& output, const Http::RequestHeaderMap&,
+                const Http::ResponseHeaderMap& response_headers, const Http::ResponseTrailerMap&,
+                const StreamInfo::StreamInfo&, absl::string_view) const override;
 };
 
 /**
@@ -280,6 +344,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
+  bool formatTo(std::string& output, const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap& response_trailers, const StreamInfo::StreamInfo&,
+                absl::string_view) const override;
 };
 
 /**
@@ -315,6 +382,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
+  bool formatTo(std::string& output, const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                absl::string_view) const override;
 
   class FieldExtractor {
   public:
@@ -322,6 +392,15 @@ public:
 
     virtual absl::optional<std::string> extract(const StreamInfo::StreamInfo&) const PURE;
     virtual ProtobufWkt::Value extractValue(const StreamInfo::StreamInfo&) const PURE;
+    // Append the extracted string to output, returning whether there was one.
+    virtual bool extractTo(std::string& output, const StreamInfo::StreamInfo& stream_info) const {
+      const absl::optional<std::string> value = extract(stream_info);
+      if (!value.has_value()) {
+        return false;
+      }
+      output.append(value.value());
+      return true;
+    }
   };
   using FieldExtractorPtr = std::unique_ptr<FieldExtractor>;
 
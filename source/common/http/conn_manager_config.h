@@ -48,6 +48,7 @@ namespace Http {
   COUNTER(downstream_rq_3xx)                                                                       \
   COUNTER(downstream_rq_4xx)                                                                       \
   COUNTER(downstream_rq_5xx)                                                                       \
+  COUNTER(downstream_rq_arena_blocks)                                                              \
   COUNTER(downstream_rq_completed)                                                                 \
   COUNTER(downstream_rq_http1_total)                                                               \
   COUNTER(downstream_rq_http2_total)                                                               \
@@ -466,6 +467,11 @@ public:
    * @return LocalReply configuration which supplies mapping for local reply generated by Envoy.
    */
   virtual const LocalReply::LocalReply& localReply() const PURE;
+
+  /**
+   * @return the size of the blocks of the per-stream arenas, or 0 if streams do not have arenas.
+   */
+  virtual uint32_t streamArenaBlockSize() const PURE;
 };
 } // namespace Http
 } // namespace Envoy
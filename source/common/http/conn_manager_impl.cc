@@ -238,6 +238,10 @@ void ConnectionManagerImpl::doDeferredStreamDestroy(ActiveStream& stream) {
 
   stream.filter_manager_.destroyFilters();
 
+  if (stream.arena_.has_value()) {
+    stats_.named_.downstream_rq_arena_blocks_.add(stream.arena_->blocks());
+  }
+
   read_callbacks_->connection().dispatcher().deferredDelete(stream.removeFromList(streams_));
 
   if (connection_idle_timer_ && streams_.empty()) {
@@ -581,6 +585,9 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
       request_response_timespan_(new Stats::HistogramCompletableTimespanImpl(
           connection_manager_.stats_.named_.downstream_rq_time_,
           connection_manager_.timeSource())) {
+  if (connection_manager_.config_.streamArenaBlockSize() != 0) {
+    arena_.emplace(connection_manager_.config_.streamArenaBlockSize());
+  }
   ASSERT(!connection_manager.config_.isRoutable() ||
              ((connection_manager.config_.routeConfigProvider() == nullptr &&
                connection_manager.config_.scopedRouteConfigProvider() != nullptr) ||
@@ -41,6 +41,7 @@
 #include "common/grpc/common.h"
 #include "common/http/conn_manager_config.h"
 #include "common/http/filter_manager.h"
+#include "common/http/stream_arena_impl.h"
 #include "common/http/user_agent.h"
 #include "common/http/utility.h"
 #include "common/local_reply/local_reply.h"
@@ -276,6 +277,9 @@ private:
     void onLocalReply(Code code) override;
     Tracing::Config& tracingConfig() override;
     const ScopeTrackedObject& scope() override;
+    StreamArenaOptRef streamArena() override {
+      return arena_.has_value() ? StreamArenaOptRef(*arena_) : StreamArenaOptRef();
+    }
 
     void traceRequest();
 
@@ -339,6 +343,9 @@ private:
     // both locations, then refer to the FM when doing stream logs.
     const uint64_t stream_id_;
 
+    // Note: The arena must outlive the FM, whose filter wrappers may be allocated from it.
+    absl::optional<StreamArenaImpl> arena_;
+
     RequestHeaderMapPtr request_headers_;
     RequestTrailerMapPtr request_trailers_;
 
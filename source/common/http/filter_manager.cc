@@ -423,8 +423,8 @@ void ActiveStreamDecoderFilter::requestDataTooLarge() {
 void FilterManager::addStreamDecoderFilterWorker(StreamDecoderFilterSharedPtr filter,
                                                  FilterMatchStateSharedPtr match_state,
                                                  bool dual_filter) {
-  ActiveStreamDecoderFilterPtr wrapper(
-      new ActiveStreamDecoderFilter(*this, filter, match_state, dual_filter));
+  ActiveStreamDecoderFilterPtr wrapper = makeStreamArenaPtr<ActiveStreamDecoderFilter>(
+      filter_manager_callbacks_.streamArena(), *this, filter, match_state, dual_filter);
 
   // If we're a dual handling filter, have the encoding wrapper be the only thing registering itself
   // as the handling filter.
@@ -447,8 +447,8 @@ void FilterManager::addStreamDecoderFilterWorker(StreamDecoderFilterSharedPtr fi
 void FilterManager::addStreamEncoderFilterWorker(StreamEncoderFilterSharedPtr filter,
                                                  FilterMatchStateSharedPtr match_state,
                                                  bool dual_filter) {
-  ActiveStreamEncoderFilterPtr wrapper(
-      new ActiveStreamEncoderFilter(*this, filter, match_state, dual_filter));
+  ActiveStreamEncoderFilterPtr wrapper = makeStreamArenaPtr<ActiveStreamEncoderFilter>(
+      filter_manager_callbacks_.streamArena(), *this, filter, match_state, dual_filter);
 
   if (match_state) {
     match_state->filter_ = filter.get();
@@ -1390,6 +1390,10 @@ absl::optional<Router::ConfigConstSharedPtr> ActiveStreamDecoderFilter::routeCon
   return parent_.filter_manager_callbacks_.routeConfig();
 }
 
+StreamArenaOptRef ActiveStreamDecoderFilter::streamArena() {
+  return parent_.filter_manager_callbacks_.streamArena();
+}
+
 Buffer::InstancePtr ActiveStreamEncoderFilter::createBuffer() {
   auto buffer = dispatcher().getWatermarkFactory().create(
       [this]() -> void { this->responseDataDrained(); },
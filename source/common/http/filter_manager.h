@@ -8,6 +8,7 @@
 #include "envoy/extensions/filters/network/http_connection_manager/v3/http_connection_manager.pb.validate.h"
 #include "envoy/http/filter.h"
 #include "envoy/http/header_map.h"
+#include "envoy/http/stream_arena.h"
 #include "envoy/matcher/matcher.h"
 #include "envoy/network/socket.h"
 #include "envoy/protobuf/message_validator.h"
@@ -319,9 +320,10 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
 /**
  * Wrapper for a stream decoder filter.
  */
-struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
-                                   public StreamDecoderFilterCallbacks,
-                                   LinkedObject<ActiveStreamDecoderFilter> {
+struct ActiveStreamDecoderFilter
+    : public ActiveStreamFilterBase,
+      public StreamDecoderFilterCallbacks,
+      LinkedObject<ActiveStreamDecoderFilter, StreamArenaDeleter<ActiveStreamDecoderFilter>> {
   ActiveStreamDecoderFilter(FilterManager& parent, StreamDecoderFilterSharedPtr filter,
                             FilterMatchStateSharedPtr match_state, bool dual_filter)
       : ActiveStreamFilterBase(parent, dual_filter, std::move(match_state)), handle_(filter) {}
@@ -401,19 +403,22 @@ struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
   void requestRouteConfigUpdate(
       Http::RouteConfigUpdatedCallbackSharedPtr route_config_updated_cb) override;
   absl::optional<Router::ConfigConstSharedPtr> routeConfig();
+  StreamArenaOptRef streamArena() override;
 
   StreamDecoderFilterSharedPtr handle_;
   bool is_grpc_request_{};
 };
 
-using ActiveStreamDecoderFilterPtr = std::unique_ptr<ActiveStreamDecoderFilter>;
+// Wrappers are allocated from the arena of the stream, if it has one.
+using ActiveStreamDecoderFilterPtr = StreamArenaPtr<ActiveStreamDecoderFilter>;
 
 /**
  * Wrapper for a stream encoder filter.
  */
-struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
-                                   public StreamEncoderFilterCallbacks,
-                                   LinkedObject<ActiveStreamEncoderFilter> {
+struct ActiveStreamEncoderFilter
+    : public ActiveStreamFilterBase,
+      public StreamEncoderFilterCallbacks,
+      LinkedObject<ActiveStreamEncoderFilter, StreamArenaDeleter<ActiveStreamEncoderFilter>> {
   ActiveStreamEncoderFilter(FilterManager& parent, StreamEncoderFilterSharedPtr filter,
                             FilterMatchStateSharedPtr match_state, bool dual_filter)
       : ActiveStreamFilterBase(parent, dual_filter, std::move(match_state)), handle_(filter) {}
@@ -463,7 +468,7 @@ struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
   StreamEncoderFilterSharedPtr handle_;
 };
 
-using ActiveStreamEncoderFilterPtr = std::unique_ptr<ActiveStreamEncoderFilter>;
+using ActiveStreamEncoderFilterPtr = StreamArenaPtr<ActiveStreamEncoderFilter>;
 
 /**
  * Callbacks invoked by the FilterManager to pass filter data/events back to the caller.
@@ -674,6 +679,11 @@ public:
    * Returns the tracked scope to use for this stream.
    */
   virtual const ScopeTrackedObject& scope() PURE;
+
+  /**
+   * Returns the arena of the stream, if it has one. It must outlive the FilterManager.
+   */
+  virtual StreamArenaOptRef streamArena() PURE;
 };
 
 /**
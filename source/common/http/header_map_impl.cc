@@ -1,5 +1,7 @@
 #include "common/http/header_map_impl.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -244,19 +246,20 @@ template <> HeaderMapImpl::StaticLookupTable<RequestHeaderMap>::StaticLookupTabl
   INLINE_REQ_HEADERS(REGISTER_DEFAULT_REQUEST_HEADER)
   INLINE_REQ_RESP_HEADERS(REGISTER_DEFAULT_REQUEST_HEADER)
 
-  finalizeTable();
+  auto entries = finalizeTable();
 
   // Special case where we map a legacy host header to :authority.
   const auto handle =
       CustomInlineHeaderRegistry::getInlineHeader<RequestHeaderMap::header_map_type>(
           Headers::get().Host);
-  add(Headers::get().HostLegacy.get().c_str(), [handle](HeaderMapImpl& h) -> StaticLookupResponse {
-    return {&h.inlineHeaders()[handle.value().it_->second], &handle.value().it_->first};
-  });
+  entries.emplace_back(Headers::get().HostLegacy.get(),
+                       StaticLookupEntry{handle.value().it_->second, &handle.value().it_->first});
+
+  table_ = PerfectHashLookupTable<StaticLookupEntry>(std::move(entries));
 }
 
 template <> HeaderMapImpl::StaticLookupTable<RequestTrailerMap>::StaticLookupTable() {
-  finalizeTable();
+  table_ = PerfectHashLookupTable<StaticLookupEntry>(finalizeTable());
 }
 
 template <> HeaderMapImpl::StaticLookupTable<ResponseHeaderMap>::StaticLookupTable() {
@@ -267,7 +270,7 @@ template <> HeaderMapImpl::StaticLookupTable<ResponseHeaderMap>::StaticLookupTab
   INLINE_REQ_RESP_HEADERS(REGISTER_RESPONSE_HEADER)
   INLINE_RESP_HEADERS_TRAILERS(REGISTER_RESPONSE_HEADER)
 
-  finalizeTable();
+  table_ = PerfectHashLookupTable<StaticLookupEntry>(finalizeTable());
 }
 
 template <> HeaderMapImpl::StaticLookupTable<ResponseTrailerMap>::StaticLookupTable() {
@@ -276,7 +279,37 @@ template <> HeaderMapImpl::StaticLookupTable<ResponseTrailerMap>::StaticLookupTa
       Headers::get().name);
   INLINE_RESP_HEADERS_TRAILERS(REGISTER_RESPONSE_TRAILER)
 
-  finalizeTable();
+  table_ = PerfectHashLookupTable<StaticLookupEntry>(finalizeTable());
+}
+
+void* HeaderMapImpl::HeaderEntryArena::allocate(size_t size, size_t alignment) {
+  ASSERT(enabled());
+  ASSERT(alignment <= alignof(std::max_align_t));
+  if (entry_size_ == 0) {
+    entry_size_ = std::max(size, sizeof(FreeEntry));
+    entry_size_ = (entry_size_ + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+  }
+  // The list only allocates its nodes here, which all have the same size.
+  ASSERT(size <= entry_size_);
+
+  if (free_list_ != nullptr) {
+    FreeEntry* entry = free_list_;
+    free_list_ = entry->next_;
+    return entry;
+  }
+  if (next_ == end_) {
+    const size_t block_bytes = entry_size_ * block_size_;
+    blocks_.emplace_back(new char[block_bytes]);
+    next_ = blocks_.back().get();
+    end_ = next_ + block_bytes;
+  }
+  void* entry = next_;
+  next_ += entry_size_;
+  return entry;
+}
+
+void HeaderMapImpl::HeaderEntryArena::deallocate(void* entry) {
+  free_list_ = new (entry) FreeEntry{free_list_};
 }
 
 uint64_t HeaderMapImpl::appendToHeader(HeaderString& header, absl::string_view data,
@@ -6,6 +6,8 @@
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "envoy/http/header_map.h"
 
@@ -14,6 +16,8 @@
 #include "common/http/headers.h"
 #include "common/runtime/runtime_features.h"
 
+#include "absl/container/inlined_vector.h"
+
 namespace Envoy {
 namespace Http {
 
@@ -98,6 +102,70 @@ public:
   void dumpState(std::ostream& os, int indent_level = 0) const;
 
 protected:
+  /**
+   * Storage for the entries of a header map, allocated in blocks of a fixed number of entries.
+   * This keeps the entries of a map close together in memory, and means that adding a header
+   * allocates only once per block. Removed entries are kept on a free list for reuse, and the
+   * blocks are freed with the header map.
+   */
+  class HeaderEntryArena : NonCopyable {
+  public:
+    explicit HeaderEntryArena(uint32_t block_size) : block_size_(block_size) {}
+
+    bool enabled() const { return block_size_ > 0; }
+    void* allocate(size_t size, size_t alignment);
+    void deallocate(void* entry);
+
+  private:
+    struct FreeEntry {
+      FreeEntry* next_;
+    };
+
+    const uint32_t block_size_;
+    // The size of each entry, which is set by the first allocation.
+    size_t entry_size_{};
+    absl::InlinedVector<std::unique_ptr<char[]>, 2> blocks_;
+    char* next_{};
+    char* end_{};
+    FreeEntry* free_list_{};
+  };
+
+  /**
+   * Allocator for the nodes of the HeaderList, which uses the arena if there is one.
+   */
+  template <class T> struct HeaderEntryAllocator {
+    using value_type = T;
+
+    explicit HeaderEntryAllocator(HeaderEntryArena* arena) : arena_(arena) {}
+    template <class U>
+    HeaderEntryAllocator(const HeaderEntryAllocator<U>& other) : arena_(other.arena_) {}
+
+    T* allocate(size_t n) {
+      if (arena_ == nullptr || n != 1) {
+        return std::allocator<T>().allocate(n);
+      }
+      return static_cast<T*>(arena_->allocate(sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, size_t n) {
+      if (arena_ == nullptr || n != 1) {
+        std::allocator<T>().deallocate(p, n);
+      } else {
+        arena_->deallocate(p);
+      }
+    }
+    template <class U> bool operator==(const HeaderEntryAllocator<U>& other) const {
+      return arena_ == other.arena_;
+    }
+    template <class U> bool operator!=(const HeaderEntryAllocator<U>& other) const {
+      return arena_ != other.arena_;
+    }
+
+    HeaderEntryArena* arena_;
+  };
+
+  struct HeaderEntryImpl;
+  using HeaderEntryList = std::list<HeaderEntryImpl, HeaderEntryAllocator<HeaderEntryImpl>>;
+
   struct HeaderEntryImpl : public HeaderEntry, NonCopyable {
     HeaderEntryImpl(const LowerCaseString& key);
     HeaderEntryImpl(const LowerCaseString& key, HeaderString&& value);
@@ -113,36 +181,46 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
-    std::list<HeaderEntryImpl>::iterator entry_;
+    HeaderEntryList::iterator entry_;
   };
-  using HeaderNode = std::list<HeaderEntryImpl>::iterator;
+  using HeaderNode = HeaderEntryList::iterator;
 
   /**
    * This is the static lookup table that is used to determine whether a header is one of the O(1)
-   * headers. This uses a trie for lookup time at most equal to the size of the incoming string.
+   * headers. This uses a perfect hash, so that a lookup hashes the incoming string once and
+   * compares it with at most one of the O(1) headers.
    */
   struct StaticLookupResponse {
     HeaderEntryImpl** entry_;
     const LowerCaseString* key_;
   };
 
+  struct StaticLookupEntry {
+    // Index of the header in the inline headers.
+    size_t index_;
+    const LowerCaseString* key_;
+  };
+
   /**
    * Base class for a static lookup table that converts a string key into an O(1) header.
    */
-  template <class Interface>
-  struct StaticLookupTable
-      : public TrieLookupTable<std::function<StaticLookupResponse(HeaderMapImpl&)>> {
+  template <class Interface> struct StaticLookupTable {
     StaticLookupTable();
 
-    void finalizeTable() {
+    /**
+     * Finalizes the registered inline headers.
+     * @return an entry for each of the registered inline headers, keyed by its name.
+     */
+    std::vector<std::pair<std::string, StaticLookupEntry>> finalizeTable() {
       CustomInlineHeaderRegistry::finalize<Interface::header_map_type>();
       auto& headers = CustomInlineHeaderRegistry::headers<Interface::header_map_type>();
       size_ = headers.size();
+      std::vector<std::pair<std::string, StaticLookupEntry>> entries;
+      entries.reserve(headers.size());
       for (const auto& header : headers) {
-        this->add(header.first.get().c_str(), [&header](HeaderMapImpl& h) -> StaticLookupResponse {
-          return {&h.inlineHeaders()[header.second], &header.first};
-        });
+        entries.emplace_back(header.first.get(), StaticLookupEntry{header.second, &header.first});
       }
+      return entries;
     }
 
     static size_t size() {
@@ -158,14 +236,15 @@ protected:
 
     static absl::optional<StaticLookupResponse> lookup(HeaderMapImpl& header_map,
                                                        absl::string_view key) {
-      const auto& entry = ConstSingleton<StaticLookupTable>::get().find(key);
+      const StaticLookupEntry* entry = ConstSingleton<StaticLookupTable>::get().table_.find(key);
       if (entry != nullptr) {
-        return entry(header_map);
+        return StaticLookupResponse{&header_map.inlineHeaders()[entry->index_], entry->key_};
       } else {
         return absl::nullopt;
       }
     }
 
+    PerfectHashLookupTable<StaticLookupEntry> table_;
     size_t size_;
   };
 
@@ -176,6 +255,8 @@ protected:
    * feature value (or uint32_t max value if not set), all headers are added to a map, to allow
    * fast access given a header key. Once the map is initialized, it will be used even if the number
    * of headers decreases below the threshold.
+   * When the envoy.http.headermap.arena_block_size runtime feature value is set and not 0, the
+   * entries are allocated from a HeaderEntryArena in blocks of that many entries.
    *
    * Note: the internal iterators held in fields make this unsafe to copy and move, since the
    * reference to end() is not preserved across a move (see Notes in
@@ -190,7 +271,10 @@ protected:
     using HeaderLazyMap = absl::flat_hash_map<absl::string_view, HeaderNodeVector>;
 
     HeaderList()
-        : pseudo_headers_end_(headers_.end()),
+        : arena_(static_cast<uint32_t>(
+              Runtime::getInteger("envoy.http.headermap.arena_block_size", 0))),
+          headers_(HeaderEntryAllocator<HeaderEntryImpl>(arena_.enabled() ? &arena_ : nullptr)),
+          pseudo_headers_end_(headers_.end()),
           lazy_map_min_size_(static_cast<uint32_t>(Runtime::getInteger(
               "envoy.http.headermap.lazy_map_min_size", std::numeric_limits<uint32_t>::max()))) {}
 
@@ -283,12 +367,12 @@ protected:
      */
     size_t remove(absl::string_view key);
 
-    std::list<HeaderEntryImpl>::iterator begin() { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::iterator end() { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_iterator begin() const { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::const_iterator end() const { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rend() const { return headers_.rend(); }
+    HeaderEntryList::iterator begin() { return headers_.begin(); }
+    HeaderEntryList::iterator end() { return headers_.end(); }
+    HeaderEntryList::const_iterator begin() const { return headers_.begin(); }
+    HeaderEntryList::const_iterator end() const { return headers_.end(); }
+    HeaderEntryList::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
+    HeaderEntryList::const_reverse_iterator rend() const { return headers_.rend(); }
     HeaderLazyMap::iterator mapFind(absl::string_view key) { return lazy_map_.find(key); }
     HeaderLazyMap::iterator mapEnd() { return lazy_map_.end(); }
     size_t size() const { return headers_.size(); }
@@ -300,7 +384,9 @@ protected:
     }
 
   private:
-    std::list<HeaderEntryImpl> headers_;
+    // The arena must outlive the entries allocated from it.
+    HeaderEntryArena arena_;
+    HeaderEntryList headers_;
     HeaderNode pseudo_headers_end_;
     // The number of headers threshold for lazy map usage.
     const uint32_t lazy_map_min_size_;
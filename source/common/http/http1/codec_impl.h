@@ -1,7 +1,5 @@
 #pragma once
 
-#include <http_parser.h>
-
 #include <array>
 #include <cstdint>
 #include <list>
@@ -20,6 +18,7 @@
 #include "common/http/header_map_impl.h"
 #include "common/http/http1/codec_stats.h"
 #include "common/http/http1/header_formatter.h"
+#include "common/http/http1/parser.h"
 #include "common/http/status.h"
 
 namespace Envoy {
@@ -167,7 +166,7 @@ private:
 
 /**
  * Base class for HTTP/1.1 client and server connections.
- * Handles the callbacks of http_parser with its own base routine and then
+ * Handles the callbacks of the parser with its own base routine and then
  * virtual dispatches to its subclasses.
  */
 class ConnectionImpl : public virtual Connection, protected Logger::Loggable<Logger::Id::http> {
@@ -224,36 +223,18 @@ public:
 
   bool strict1xxAnd204Headers() { return strict_1xx_and_204_headers_; }
 
-  int setAndCheckCallbackStatus(Status&& status);
-  int setAndCheckCallbackStatusOr(Envoy::StatusOr<int>&& statusor);
+  CallbackResult setAndCheckCallbackStatus(Status&& status);
+  CallbackResult setAndCheckCallbackStatusOr(Envoy::StatusOr<CallbackResult>&& statusor);
 
-  // Codec errors found in callbacks are overridden within the http_parser library. This holds those
-  // errors to propagate them through to dispatch() where we can handle the error.
+  // Codec errors found in callbacks are overridden within the parser. This holds those errors to
+  // propagate them through to dispatch() where we can handle the error.
   Envoy::Http::Status codec_status_;
 
 protected:
   ConnectionImpl(Network::Connection& connection, CodecStats& stats, const Http1Settings& settings,
-                 http_parser_type type, uint32_t max_headers_kb, const uint32_t max_headers_count,
+                 MessageType type, uint32_t max_headers_kb, const uint32_t max_headers_count,
                  HeaderKeyFormatterPtr&& header_key_formatter);
 
-  // The following define special return values for http_parser callbacks. See:
-  // https://github.com/nodejs/http-parser/blob/5c5b3ac62662736de9e71640a8dc16da45b32503/http_parser.h#L72
-  // These codes do not overlap with standard HTTP Status codes. They are only used for user
-  // callbacks.
-  enum class HttpParserCode {
-    // Callbacks other than on_headers_complete should return a non-zero int to indicate an error
-    // and
-    // halt execution.
-    Error = -1,
-    Success = 0,
-    // Returning '1' from on_headers_complete will tell http_parser that it should not expect a
-    // body.
-    NoBody = 1,
-    // Returning '2' from on_headers_complete will tell http_parser that it should not expect a body
-    // nor any further data on the connection.
-    NoBodyData = 2,
-  };
-
   bool resetStreamCalled() { return reset_stream_called_; }
   Status onMessageBeginBase();
 
@@ -274,7 +255,7 @@ protected:
   Network::Connection& connection_;
   CodecStats& stats_;
   const Http1Settings codec_settings_;
-  http_parser parser_;
+  ParserPtr parser_;
   Buffer::Instance* current_dispatching_buffer_{};
   Http::Code error_code_{Http::Code::BadRequest};
   const HeaderKeyFormatterPtr header_key_formatter_;
@@ -334,7 +315,7 @@ private:
   Envoy::StatusOr<size_t> dispatchSlice(const char* slice, size_t len);
 
   /**
-   * Called by the http_parser when body data is received.
+   * Called by the parser when body data is received.
    * @param data supplies the start address.
    * @param length supplies the length.
    */
@@ -378,10 +359,10 @@ private:
    * Called when headers are complete. A base routine happens first then a virtual dispatch is
    * invoked. Note that this only applies to headers and NOT trailers. End of
    * trailers are signaled via onMessageCompleteBase().
-   * @return An error status or an integer representing 0 if no error, 1 if there should be no body.
+   * @return An error status or a CallbackResult indicating whether there should be a body.
    */
-  Envoy::StatusOr<int> onHeadersCompleteBase();
-  virtual Envoy::StatusOr<int> onHeadersComplete() PURE;
+  Envoy::StatusOr<CallbackResult> onHeadersCompleteBase();
+  virtual Envoy::StatusOr<CallbackResult> onHeadersComplete() PURE;
 
   /**
    * Called to see if upgrade transition is allowed.
@@ -441,7 +422,29 @@ private:
    */
   virtual Status checkHeaderNameForUnderscores() { return okStatus(); }
 
-  static http_parser_settings settings_;
+  /**
+   * Forwards the callbacks of the parser to the base routines of the connection, recording the
+   * status of any which fails in codec_status_.
+   */
+  class ParserCallbacksImpl : public ParserCallbacks {
+  public:
+    ParserCallbacksImpl(ConnectionImpl& connection) : connection_(connection) {}
+
+    // ParserCallbacks
+    CallbackResult onMessageBegin() override;
+    CallbackResult onUrl(const char* data, size_t length) override;
+    CallbackResult onHeaderField(const char* data, size_t length) override;
+    CallbackResult onHeaderValue(const char* data, size_t length) override;
+    CallbackResult onHeadersComplete() override;
+    void bufferBody(const char* data, size_t length) override;
+    CallbackResult onMessageComplete() override;
+    void onChunkHeader(bool is_final_chunk) override;
+
+  private:
+    ConnectionImpl& connection_;
+  };
+
+  ParserCallbacksImpl parser_callbacks_{*this};
 
   HeaderParsingState header_parsing_state_{HeaderParsingState::Field};
   // Used to accumulate the HTTP message body during the current dispatch call. The accumulated body
@@ -498,13 +501,13 @@ private:
    * @return Status representing success or failure. This will fail if there is an invalid url in
    * the request line.
    */
-  Status handlePath(RequestHeaderMap& headers, unsigned int method);
+  Status handlePath(RequestHeaderMap& headers, absl::string_view method);
 
   // ConnectionImpl
   void onEncodeComplete() override;
   Status onMessageBegin() override;
   Status onUrl(const char* data, size_t length) override;
-  Envoy::StatusOr<int> onHeadersComplete() override;
+  Envoy::StatusOr<CallbackResult> onHeadersComplete() override;
   // If upgrade behavior is not allowed, the HCM will have sanitized the headers out.
   bool upgradeAllowed() const override { return true; }
   void onBody(Buffer::Instance& data) override;
@@ -588,7 +591,7 @@ private:
   void onEncodeComplete() override {}
   Status onMessageBegin() override { return okStatus(); }
   Status onUrl(const char*, size_t) override { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
-  Envoy::StatusOr<int> onHeadersComplete() override;
+  Envoy::StatusOr<CallbackResult> onHeadersComplete() override;
   bool upgradeAllowed() const override;
   void onBody(Buffer::Instance& data) override;
   void onMessageComplete() override;
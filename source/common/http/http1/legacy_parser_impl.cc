@@ -0,0 +1,90 @@
+#include "common/http/http1/legacy_parser_impl.h"
+
+#include <climits>
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+ParserCallbacks& callbacks(http_parser* parser) {
+  return *static_cast<ParserCallbacks*>(parser->data);
+}
+
+} // namespace
+
+http_parser_settings LegacyHttpParserImpl::settings_{
+    [](http_parser* parser) -> int {
+      return static_cast<int>(callbacks(parser).onMessageBegin());
+    },
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      return static_cast<int>(callbacks(parser).onUrl(at, length));
+    },
+    nullptr, // on_status
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      return static_cast<int>(callbacks(parser).onHeaderField(at, length));
+    },
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      return static_cast<int>(callbacks(parser).onHeaderValue(at, length));
+    },
+    [](http_parser* parser) -> int {
+      return static_cast<int>(callbacks(parser).onHeadersComplete());
+    },
+    [](http_parser* parser, const char* at, size_t length) -> int {
+      callbacks(parser).bufferBody(at, length);
+      return 0;
+    },
+    [](http_parser* parser) -> int {
+      return static_cast<int>(callbacks(parser).onMessageComplete());
+    },
+    [](http_parser* parser) -> int {
+      // A 0-byte chunk header is used to signal the end of the chunked body.
+      // When this function is called, http-parser holds the size of the chunk in
+      // parser->content_length. See
+      // https://github.com/nodejs/http-parser/blob/v2.9.3/http_parser.h#L336
+      callbacks(parser).onChunkHeader(parser->content_length == 0);
+      return 0;
+    },
+    nullptr // on_chunk_complete
+};
+
+LegacyHttpParserImpl::LegacyHttpParserImpl(MessageType type, ParserCallbacks& callbacks) {
+  http_parser_init(&parser_, type == MessageType::Request ? HTTP_REQUEST : HTTP_RESPONSE);
+  parser_.allow_chunked_length = 1;
+  parser_.data = &callbacks;
+}
+
+size_t LegacyHttpParserImpl::execute(const char* data, size_t length) {
+  return http_parser_execute(&parser_, &settings_, data, length);
+}
+
+ParserStatus LegacyHttpParserImpl::status() const {
+  switch (HTTP_PARSER_ERRNO(&parser_)) {
+  case HPE_OK:
+    return ParserStatus::Ok;
+  case HPE_PAUSED:
+    return ParserStatus::Paused;
+  default:
+    return ParserStatus::Error;
+  }
+}
+
+absl::string_view LegacyHttpParserImpl::errorName() const {
+  return http_errno_name(HTTP_PARSER_ERRNO(&parser_));
+}
+
+absl::string_view LegacyHttpParserImpl::methodName() const {
+  return http_method_str(static_cast<http_method>(parser_.method));
+}
+
+absl::optional<uint64_t> LegacyHttpParserImpl::contentLength() const {
+  // http_parser sets content_length to ULLONG_MAX when there is no Content-Length header.
+  if (parser_.content_length == ULLONG_MAX) {
+    return absl::nullopt;
+  }
+  return parser_.content_length;
+}
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <http_parser.h>
+
+#include "common/http/http1/parser.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Parser backed by http_parser.
+ */
+class LegacyHttpParserImpl : public Parser {
+public:
+  LegacyHttpParserImpl(MessageType type, ParserCallbacks& callbacks);
+
+  // Parser
+  size_t execute(const char* data, size_t length) override;
+  void pause() override { http_parser_pause(&parser_, 1); }
+  void resume() override { http_parser_pause(&parser_, 0); }
+  ParserStatus status() const override;
+  absl::string_view errorName() const override;
+  absl::string_view methodName() const override;
+  uint16_t statusCode() const override { return parser_.status_code; }
+  bool isHttp11() const override { return parser_.http_major == 1 && parser_.http_minor == 1; }
+  absl::optional<uint64_t> contentLength() const override;
+  bool isChunked() const override { return parser_.flags & F_CHUNKED; }
+  bool hasTransferEncoding() const override { return parser_.uses_transfer_encoding != 0; }
+
+private:
+  static http_parser_settings settings_;
+
+  http_parser parser_;
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
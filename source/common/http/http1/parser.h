@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Values returned by parser callbacks. These match the return values of http_parser callbacks.
+ */
+enum class CallbackResult {
+  // Stop parsing and fail.
+  Error = -1,
+  Success = 0,
+  // Returned by onHeadersComplete(): the message has no body.
+  NoBody = 1,
+  // Returned by onHeadersComplete(): the message has no body, and the data which follows it on the
+  // connection is not HTTP/1.
+  NoBodyData = 2,
+};
+
+enum class ParserStatus {
+  Ok,
+  // A callback paused the parser. resume() must be called before parsing more data.
+  Paused,
+  // The message is malformed or a callback failed. No more data can be parsed.
+  Error,
+};
+
+enum class MessageType { Request, Response };
+
+/**
+ * Receives the elements of HTTP/1 messages from a Parser. The data passed to onUrl(),
+ * onHeaderField(), onHeaderValue() and bufferBody() is only valid for the duration of the call,
+ * and an element may be delivered in several calls when it spans several execute() calls.
+ */
+class ParserCallbacks {
+public:
+  virtual ~ParserCallbacks() = default;
+
+  /**
+   * Called when the first byte of a message is parsed.
+   */
+  virtual CallbackResult onMessageBegin() PURE;
+
+  /**
+   * Called with request target data.
+   */
+  virtual CallbackResult onUrl(const char* data, size_t length) PURE;
+
+  /**
+   * Called with header or trailer name data.
+   */
+  virtual CallbackResult onHeaderField(const char* data, size_t length) PURE;
+
+  /**
+   * Called with header or trailer value data. Leading whitespace is not included.
+   */
+  virtual CallbackResult onHeaderValue(const char* data, size_t length) PURE;
+
+  /**
+   * Called once the header block is parsed. Not called for trailers.
+   * @return NoBody or NoBodyData to override the body length implied by the headers.
+   */
+  virtual CallbackResult onHeadersComplete() PURE;
+
+  /**
+   * Called with body data.
+   */
+  virtual void bufferBody(const char* data, size_t length) PURE;
+
+  /**
+   * Called when the message, including any trailers, is complete.
+   */
+  virtual CallbackResult onMessageComplete() PURE;
+
+  /**
+   * Called when a chunk header is parsed.
+   * @param is_final_chunk whether this is the zero length chunk which ends the body.
+   */
+  virtual void onChunkHeader(bool is_final_chunk) PURE;
+};
+
+/**
+ * An incremental HTTP/1 message parser, which reports the elements of messages to its
+ * ParserCallbacks as they are parsed.
+ */
+class Parser {
+public:
+  virtual ~Parser() = default;
+
+  /**
+   * Parse data.
+   * @param data supplies the data, or nullptr if length is 0.
+   * @param length supplies the length of the data. 0 signals the end of the input, which
+   *        completes a message whose body is delimited by the connection closing.
+   * @return the number of bytes parsed. Less than length if the parser was paused or failed.
+   */
+  virtual size_t execute(const char* data, size_t length) PURE;
+
+  /**
+   * Pause the parser. Called from a callback, this makes execute() return once it completes.
+   */
+  virtual void pause() PURE;
+
+  /**
+   * Resume a paused parser.
+   */
+  virtual void resume() PURE;
+
+  virtual ParserStatus status() const PURE;
+
+  /**
+   * @return the name of the error which failed parsing, in the form used by http_parser.
+   */
+  virtual absl::string_view errorName() const PURE;
+
+  /**
+   * @return the request method. Only valid once the request line has been parsed.
+   */
+  virtual absl::string_view methodName() const PURE;
+
+  /**
+   * @return the response status code. Only valid once the status line has been parsed.
+   */
+  virtual uint16_t statusCode() const PURE;
+
+  /**
+   * @return whether the message version is HTTP/1.1. Only valid once the first line has been
+   *         parsed.
+   */
+  virtual bool isHttp11() const PURE;
+
+  /**
+   * @return the value of the Content-Length header, if any. Only valid from onHeadersComplete().
+   */
+  virtual absl::optional<uint64_t> contentLength() const PURE;
+
+  /**
+   * @return whether the final transfer coding is chunked. Only valid from onHeadersComplete().
+   */
+  virtual bool isChunked() const PURE;
+
+  /**
+   * @return whether the message has a Transfer-Encoding header. Only valid from
+   *         onHeadersComplete().
+   */
+  virtual bool hasTransferEncoding() const PURE;
+};
+
+using ParserPtr = std::unique_ptr<Parser>;
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
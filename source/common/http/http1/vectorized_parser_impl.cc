@@ -0,0 +1,675 @@
+#include "common/http/http1/vectorized_parser_impl.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "common/common/assert.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+// The methods http_parser accepts.
+constexpr absl::string_view Methods[] = {
+    "DELETE",     "GET",      "HEAD",       "POST",     "PUT",    "CONNECT",   "OPTIONS",
+    "TRACE",      "COPY",     "LOCK",       "MKCOL",    "MOVE",   "PROPFIND",  "PROPPATCH",
+    "SEARCH",     "UNLOCK",   "BIND",       "REBIND",   "UNBIND", "ACL",       "REPORT",
+    "MKACTIVITY", "CHECKOUT", "MERGE",      "M-SEARCH", "NOTIFY", "SUBSCRIBE", "UNSUBSCRIBE",
+    "PATCH",      "PURGE",    "MKCALENDAR", "LINK",     "UNLINK", "SOURCE"};
+
+bool isMethodPrefix(absl::string_view prefix) {
+  return std::any_of(std::begin(Methods), std::end(Methods), [prefix](absl::string_view method) {
+    return absl::StartsWith(method, prefix);
+  });
+}
+
+bool isMethod(absl::string_view name) {
+  return std::find(std::begin(Methods), std::end(Methods), name) != std::end(Methods);
+}
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// @return the value of a hexadecimal digit, or -1 if c is not one.
+int hexDigitValue(char c) {
+  if (isDigit(c)) {
+    return c - '0';
+  }
+  const char lower = absl::ascii_tolower(c);
+  if (lower >= 'a' && lower <= 'f') {
+    return lower - 'a' + 10;
+  }
+  return -1;
+}
+
+} // namespace
+
+VectorizedParserImpl::VectorizedParserImpl(MessageType type, ParserCallbacks& callbacks,
+                                           const VectorizedScanner& scanner)
+    : type_(type), callbacks_(callbacks), scanner_(scanner) {}
+
+size_t VectorizedParserImpl::execute(const char* data, size_t length) {
+  if (status_ != ParserStatus::Ok) {
+    return 0;
+  }
+  if (length == 0) {
+    // End of input.
+    if (state_ == State::BodyUntilEof) {
+      state_ = State::MessageDone;
+    }
+    if (state_ == State::MessageDone) {
+      onMessageDone();
+    } else if (state_ != State::MessageStart) {
+      setError("HPE_INVALID_EOF_STATE");
+    }
+    return 0;
+  }
+  return parse(data, data + length) - data;
+}
+
+void VectorizedParserImpl::pause() {
+  if (status_ == ParserStatus::Ok) {
+    status_ = ParserStatus::Paused;
+  }
+}
+
+void VectorizedParserImpl::resume() {
+  if (status_ == ParserStatus::Paused) {
+    status_ = ParserStatus::Ok;
+  }
+}
+
+absl::string_view VectorizedParserImpl::errorName() const {
+  switch (status_) {
+  case ParserStatus::Ok:
+    return "HPE_OK";
+  case ParserStatus::Paused:
+    return "HPE_PAUSED";
+  case ParserStatus::Error:
+    return error_name_;
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+const char* VectorizedParserImpl::parse(const char* p, const char* end) {
+  while (status_ == ParserStatus::Ok) {
+    if (state_ == State::MessageDone) {
+      const bool stop = stop_after_message_;
+      onMessageDone();
+      if (stop) {
+        break;
+      }
+      continue;
+    }
+    if (p == end) {
+      break;
+    }
+
+    switch (state_) {
+    case State::MessageStart:
+      p = onMessageStart(p);
+      break;
+    case State::Method:
+      p = onMethod(p, end);
+      break;
+    case State::UrlStart:
+      if (*p == ' ') {
+        ++p;
+      } else if (scanner_.findUrlEnd(p, 1) == 0) {
+        setError("HPE_INVALID_URL");
+      } else {
+        state_ = State::Url;
+      }
+      break;
+    case State::Url:
+      p = onUrlData(p, end);
+      break;
+    case State::RequestVersionStart:
+      if (*p == ' ') {
+        ++p;
+      } else {
+        version_index_ = 0;
+        state_ = State::RequestVersion;
+      }
+      break;
+    case State::RequestVersion:
+      p = onVersion(p, State::RequestLineEnd);
+      break;
+    case State::RequestLineEnd:
+      if (*p == '\r') {
+        state_ = State::FirstLineLf;
+      } else if (*p == '\n') {
+        state_ = State::HeaderFieldStart;
+      } else {
+        setError("HPE_INVALID_VERSION");
+        break;
+      }
+      ++p;
+      break;
+    case State::ResponseVersion:
+      p = onVersion(p, State::ResponseVersionEnd);
+      break;
+    case State::ResponseVersionEnd:
+      if (*p != ' ') {
+        setError("HPE_INVALID_VERSION");
+        break;
+      }
+      state_ = State::StatusCodeStart;
+      ++p;
+      break;
+    case State::StatusCodeStart:
+      if (*p == ' ') {
+        ++p;
+      } else if (isDigit(*p)) {
+        state_ = State::StatusCode;
+      } else {
+        setError("HPE_INVALID_STATUS");
+      }
+      break;
+    case State::StatusCode:
+      p = onStatusCode(p);
+      break;
+    case State::ReasonPhrase:
+      // The reason phrase is not reported.
+      p += scanner_.findLineEnd(p, end - p);
+      if (p != end) {
+        state_ = *p == '\r' ? State::FirstLineLf : State::HeaderFieldStart;
+        ++p;
+      }
+      break;
+    case State::FirstLineLf:
+      if (*p != '\n') {
+        setError("HPE_LF_EXPECTED");
+        break;
+      }
+      state_ = State::HeaderFieldStart;
+      ++p;
+      break;
+    case State::HeaderFieldStart:
+      p = onHeaderFieldStart(p);
+      break;
+    case State::HeaderField:
+      p = onHeaderFieldData(p, end);
+      break;
+    case State::HeaderValueStart:
+      if (*p == ' ' || *p == '\t') {
+        ++p;
+        break;
+      }
+      state_ = State::HeaderValue;
+      if (*p == '\r' || *p == '\n') {
+        // Empty values are reported too, so that the header is not dropped.
+        checkCallback(callbacks_.onHeaderValue(p, 0), "HPE_CB_header_value");
+      }
+      break;
+    case State::HeaderValue:
+      p = onHeaderValueData(p, end);
+      break;
+    case State::HeaderValueLf:
+      if (*p != '\n') {
+        setError("HPE_LF_EXPECTED");
+        break;
+      }
+      ++p;
+      onHeaderLineEnd();
+      break;
+    case State::HeadersLf:
+      if (*p != '\n') {
+        setError("HPE_LF_EXPECTED");
+        break;
+      }
+      ++p;
+      onHeaderBlockEnd();
+      break;
+    case State::Body:
+    case State::ChunkData: {
+      const size_t length = std::min<uint64_t>(remaining_, end - p);
+      remaining_ -= length;
+      if (remaining_ == 0) {
+        state_ = state_ == State::Body ? State::MessageDone : State::ChunkDataEnd;
+      }
+      onBodyData(p, length);
+      p += length;
+      break;
+    }
+    case State::BodyUntilEof:
+      onBodyData(p, end - p);
+      p = end;
+      break;
+    case State::ChunkSizeStart:
+      if (hexDigitValue(*p) < 0) {
+        setError("HPE_INVALID_CHUNK_SIZE");
+        break;
+      }
+      remaining_ = 0;
+      state_ = State::ChunkSize;
+      break;
+    case State::ChunkSize:
+      p = onChunkSize(p);
+      break;
+    case State::ChunkExtension:
+      // Chunk extensions are ignored.
+      p += scanner_.findLineEnd(p, end - p);
+      if (p != end) {
+        if (*p++ == '\r') {
+          state_ = State::ChunkSizeLf;
+        } else {
+          onChunkHeaderEnd();
+        }
+      }
+      break;
+    case State::ChunkSizeLf:
+      if (*p != '\n') {
+        setError("HPE_LF_EXPECTED");
+        break;
+      }
+      ++p;
+      onChunkHeaderEnd();
+      break;
+    case State::ChunkDataEnd:
+      if (*p == '\r') {
+        state_ = State::ChunkDataLf;
+      } else if (*p == '\n') {
+        state_ = State::ChunkSizeStart;
+      } else {
+        setError("HPE_STRICT");
+        break;
+      }
+      ++p;
+      break;
+    case State::ChunkDataLf:
+      if (*p != '\n') {
+        setError("HPE_LF_EXPECTED");
+        break;
+      }
+      state_ = State::ChunkSizeStart;
+      ++p;
+      break;
+    case State::MessageDone:
+      NOT_REACHED_GCOVR_EXCL_LINE;
+    }
+  }
+  return p;
+}
+
+const char* VectorizedParserImpl::onMessageStart(const char* p) {
+  if (*p == '\r' || *p == '\n') {
+    return p + 1;
+  }
+  resetMessage();
+  if (type_ == MessageType::Request) {
+    method_[0] = *p;
+    method_length_ = 1;
+    if (!isMethodPrefix(methodName())) {
+      setError("HPE_INVALID_METHOD");
+      return p;
+    }
+    state_ = State::Method;
+  } else {
+    if (*p != 'H') {
+      setError("HPE_INVALID_CONSTANT");
+      return p;
+    }
+    version_index_ = 1;
+    state_ = State::ResponseVersion;
+  }
+  checkCallback(callbacks_.onMessageBegin(), "HPE_CB_message_begin");
+  return p + 1;
+}
+
+const char* VectorizedParserImpl::onMethod(const char* p, const char* end) {
+  const size_t length = scanner_.findNonToken(p, end - p);
+  if (length > 0) {
+    if (length > MaxMethodLength - method_length_) {
+      setError("HPE_INVALID_METHOD");
+      return p;
+    }
+    memcpy(method_ + method_length_, p, length);
+    method_length_ += length;
+    if (!isMethodPrefix(methodName())) {
+      setError("HPE_INVALID_METHOD");
+      return p;
+    }
+    p += length;
+  }
+  if (p == end) {
+    return p;
+  }
+  if (*p != ' ' || !isMethod(methodName())) {
+    setError("HPE_INVALID_METHOD");
+    return p;
+  }
+  state_ = State::UrlStart;
+  return p + 1;
+}
+
+const char* VectorizedParserImpl::onUrlData(const char* p, const char* end) {
+  const size_t length = scanner_.findUrlEnd(p, end - p);
+  if (length > 0) {
+    checkCallback(callbacks_.onUrl(p, length), "HPE_CB_url");
+    p += length;
+  }
+  if (p == end || status_ == ParserStatus::Error) {
+    return p;
+  }
+  switch (*p) {
+  case ' ':
+    state_ = State::RequestVersionStart;
+    break;
+  case '\r':
+  case '\n':
+    // A request line without a version is an HTTP/0.9 request.
+    http_major_ = 0;
+    http_minor_ = 9;
+    state_ = *p == '\r' ? State::FirstLineLf : State::HeaderFieldStart;
+    break;
+  default:
+    setError("HPE_INVALID_URL");
+    return p;
+  }
+  return p + 1;
+}
+
+const char* VectorizedParserImpl::onVersion(const char* p, State next_state) {
+  static constexpr absl::string_view Prefix = "HTTP/";
+  if (version_index_ < Prefix.size()) {
+    if (*p != Prefix[version_index_]) {
+      setError("HPE_INVALID_CONSTANT");
+      return p;
+    }
+  } else if (version_index_ == Prefix.size() + 1) {
+    if (*p != '.') {
+      setError("HPE_INVALID_VERSION");
+      return p;
+    }
+  } else {
+    if (!isDigit(*p)) {
+      setError("HPE_INVALID_VERSION");
+      return p;
+    }
+    if (version_index_ == Prefix.size()) {
+      http_major_ = *p - '0';
+    } else {
+      http_minor_ = *p - '0';
+      state_ = next_state;
+    }
+  }
+  ++version_index_;
+  return p + 1;
+}
+
+const char* VectorizedParserImpl::onStatusCode(const char* p) {
+  if (isDigit(*p)) {
+    if (status_code_digits_ == 3) {
+      setError("HPE_INVALID_STATUS");
+      return p;
+    }
+    status_code_ = status_code_ * 10 + (*p - '0');
+    ++status_code_digits_;
+    return p + 1;
+  }
+  if (status_code_digits_ != 3) {
+    setError("HPE_INVALID_STATUS");
+    return p;
+  }
+  switch (*p) {
+  case ' ':
+    state_ = State::ReasonPhrase;
+    break;
+  case '\r':
+    state_ = State::FirstLineLf;
+    break;
+  case '\n':
+    state_ = State::HeaderFieldStart;
+    break;
+  default:
+    setError("HPE_INVALID_STATUS");
+    return p;
+  }
+  return p + 1;
+}
+
+const char* VectorizedParserImpl::onHeaderFieldStart(const char* p) {
+  if (*p == '\r') {
+    state_ = State::HeadersLf;
+    return p + 1;
+  }
+  if (*p == '\n') {
+    onHeaderBlockEnd();
+    return p + 1;
+  }
+  // This also rejects SP and HT, which start obsolete line folding.
+  if (!VectorizedScanner::isTokenChar(*p)) {
+    setError("HPE_INVALID_HEADER_TOKEN");
+    return p;
+  }
+  header_name_length_ = 0;
+  state_ = State::HeaderField;
+  return p;
+}
+
+const char* VectorizedParserImpl::onHeaderFieldData(const char* p, const char* end) {
+  const size_t length = scanner_.findNonToken(p, end - p);
+  if (length > 0) {
+    // Only the first bytes of the name are needed to recognize the framing headers.
+    if (header_name_length_ < MaxFramingHeaderNameLength) {
+      memcpy(header_name_ + header_name_length_, p,
+             std::min(length, MaxFramingHeaderNameLength - header_name_length_));
+    }
+    header_name_length_ += length;
+    checkCallback(callbacks_.onHeaderField(p, length), "HPE_CB_header_field");
+    p += length;
+  }
+  if (p == end || status_ == ParserStatus::Error) {
+    return p;
+  }
+  if (*p != ':') {
+    setError("HPE_INVALID_HEADER_TOKEN");
+    return p;
+  }
+  framing_header_ = FramingHeader::None;
+  if (!processing_trailers_ && header_name_length_ <= MaxFramingHeaderNameLength) {
+    const absl::string_view name(header_name_, header_name_length_);
+    if (absl::EqualsIgnoreCase(name, "content-length")) {
+      framing_header_ = FramingHeader::ContentLength;
+    } else if (absl::EqualsIgnoreCase(name, "transfer-encoding")) {
+      framing_header_ = FramingHeader::TransferEncoding;
+    }
+    framing_header_value_.clear();
+  }
+  state_ = State::HeaderValueStart;
+  return p + 1;
+}
+
+const char* VectorizedParserImpl::onHeaderValueData(const char* p, const char* end) {
+  const size_t length = scanner_.findLineEnd(p, end - p);
+  if (length > 0) {
+    if (framing_header_ != FramingHeader::None) {
+      framing_header_value_.append(p, length);
+    }
+    checkCallback(callbacks_.onHeaderValue(p, length), "HPE_CB_header_value");
+    p += length;
+  }
+  if (p == end || status_ == ParserStatus::Error) {
+    return p;
+  }
+  if (*p == '\r') {
+    state_ = State::HeaderValueLf;
+  } else {
+    onHeaderLineEnd();
+  }
+  return p + 1;
+}
+
+const char* VectorizedParserImpl::onChunkSize(const char* p) {
+  const int digit = hexDigitValue(*p);
+  if (digit >= 0) {
+    if (remaining_ > (std::numeric_limits<uint64_t>::max() >> 4)) {
+      // http_parser reports this overflow as an invalid content length too.
+      setError("HPE_INVALID_CONTENT_LENGTH");
+      return p;
+    }
+    remaining_ = (remaining_ << 4) | digit;
+    return p + 1;
+  }
+  switch (*p) {
+  case ';':
+  case ' ':
+  case '\t':
+    state_ = State::ChunkExtension;
+    return p + 1;
+  case '\r':
+    state_ = State::ChunkSizeLf;
+    return p + 1;
+  case '\n':
+    onChunkHeaderEnd();
+    return p + 1;
+  default:
+    setError("HPE_INVALID_CHUNK_SIZE");
+    return p;
+  }
+}
+
+void VectorizedParserImpl::onHeaderLineEnd() {
+  state_ = State::HeaderFieldStart;
+  if (framing_header_ != FramingHeader::None) {
+    processFramingHeader();
+    framing_header_ = FramingHeader::None;
+  }
+}
+
+void VectorizedParserImpl::onHeaderBlockEnd() {
+  if (processing_trailers_) {
+    state_ = State::MessageDone;
+    return;
+  }
+  // Content-Length is allowed along with chunked Transfer-Encoding, which then takes precedence:
+  // the codec removes Content-Length or rejects the message, depending on its configuration.
+  if (has_transfer_encoding_ && content_length_.has_value() && !chunked_) {
+    setError("HPE_UNEXPECTED_CONTENT_LENGTH");
+    return;
+  }
+
+  const CallbackResult result = callbacks_.onHeadersComplete();
+  if (result == CallbackResult::Error) {
+    setError("HPE_CB_headers_complete");
+    return;
+  }
+
+  // This follows the order in which http_parser decides how the body is delimited.
+  if (result == CallbackResult::NoBodyData) {
+    stop_after_message_ = true;
+    state_ = State::MessageDone;
+  } else if (result == CallbackResult::NoBody) {
+    state_ = State::MessageDone;
+  } else if (chunked_) {
+    state_ = State::ChunkSizeStart;
+  } else if (has_transfer_encoding_) {
+    // A request body with an unknown transfer coding cannot be delimited. A response body is
+    // delimited by the connection closing.
+    if (type_ == MessageType::Request) {
+      setError("HPE_INVALID_TRANSFER_ENCODING");
+      return;
+    }
+    state_ = State::BodyUntilEof;
+  } else if (content_length_.has_value()) {
+    remaining_ = content_length_.value();
+    state_ = remaining_ == 0 ? State::MessageDone : State::Body;
+  } else if (type_ == MessageType::Response && status_code_ / 100 != 1 && status_code_ != 204 &&
+             status_code_ != 304) {
+    state_ = State::BodyUntilEof;
+  } else {
+    state_ = State::MessageDone;
+  }
+}
+
+void VectorizedParserImpl::onChunkHeaderEnd() {
+  const bool is_final_chunk = remaining_ == 0;
+  if (is_final_chunk) {
+    processing_trailers_ = true;
+    state_ = State::HeaderFieldStart;
+  } else {
+    state_ = State::ChunkData;
+  }
+  callbacks_.onChunkHeader(is_final_chunk);
+}
+
+void VectorizedParserImpl::onMessageDone() {
+  state_ = State::MessageStart;
+  checkCallback(callbacks_.onMessageComplete(), "HPE_CB_message_complete");
+}
+
+void VectorizedParserImpl::onBodyData(const char* p, size_t length) {
+  if (length > 0) {
+    callbacks_.bufferBody(p, length);
+  }
+}
+
+void VectorizedParserImpl::resetMessage() {
+  method_length_ = 0;
+  version_index_ = 0;
+  http_major_ = 0;
+  http_minor_ = 0;
+  status_code_ = 0;
+  status_code_digits_ = 0;
+  header_name_length_ = 0;
+  framing_header_ = FramingHeader::None;
+  content_length_ = absl::nullopt;
+  has_transfer_encoding_ = false;
+  chunked_ = false;
+  processing_trailers_ = false;
+  stop_after_message_ = false;
+  remaining_ = 0;
+}
+
+void VectorizedParserImpl::processFramingHeader() {
+  const absl::string_view value = absl::StripAsciiWhitespace(framing_header_value_);
+  if (framing_header_ == FramingHeader::TransferEncoding) {
+    // The body is chunked if the last transfer coding applied is.
+    has_transfer_encoding_ = true;
+    const size_t comma = value.rfind(',');
+    const absl::string_view last_coding =
+        comma == absl::string_view::npos ? value : value.substr(comma + 1);
+    chunked_ = absl::EqualsIgnoreCase(absl::StripAsciiWhitespace(last_coding), "chunked");
+    return;
+  }
+
+  ASSERT(framing_header_ == FramingHeader::ContentLength);
+  if (content_length_.has_value()) {
+    setError("HPE_UNEXPECTED_CONTENT_LENGTH");
+    return;
+  }
+  if (value.empty()) {
+    setError("HPE_INVALID_CONTENT_LENGTH");
+    return;
+  }
+  uint64_t content_length = 0;
+  for (const char c : value) {
+    if (!isDigit(c) || content_length > (std::numeric_limits<uint64_t>::max() - 9) / 10) {
+      setError("HPE_INVALID_CONTENT_LENGTH");
+      return;
+    }
+    content_length = content_length * 10 + (c - '0');
+  }
+  content_length_ = content_length;
+}
+
+void VectorizedParserImpl::checkCallback(CallbackResult result, absl::string_view error_name) {
+  if (result != CallbackResult::Success) {
+    setError(error_name);
+  }
+}
+
+void VectorizedParserImpl::setError(absl::string_view error_name) {
+  status_ = ParserStatus::Error;
+  error_name_ = error_name;
+}
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "common/http/http1/parser.h"
+#include "common/http/http1/vectorized_scanner.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Parser which finds the end of each message element with a VectorizedScanner, instead of
+ * stepping through a state machine byte by byte as http_parser does. It reports the same elements
+ * and errors as LegacyHttpParserImpl for the messages the codec accepts, with these exceptions:
+ * - Obsolete line folding (RFC 7230 Section 3.2.4) is rejected with HPE_INVALID_HEADER_TOKEN.
+ * - Header names must be tokens, CR must be followed by LF, and chunk data by CRLF. http_parser
+ *   only checks these when built in strict mode.
+ * - Status codes must have three digits.
+ * Header values are delimited by CR or LF only: the codec validates their characters.
+ */
+class VectorizedParserImpl : public Parser {
+public:
+  VectorizedParserImpl(MessageType type, ParserCallbacks& callbacks,
+                       const VectorizedScanner& scanner = VectorizedScanner::get());
+
+  // Parser
+  size_t execute(const char* data, size_t length) override;
+  void pause() override;
+  void resume() override;
+  ParserStatus status() const override { return status_; }
+  absl::string_view errorName() const override;
+  absl::string_view methodName() const override { return {method_, method_length_}; }
+  uint16_t statusCode() const override { return status_code_; }
+  bool isHttp11() const override { return http_major_ == 1 && http_minor_ == 1; }
+  absl::optional<uint64_t> contentLength() const override { return content_length_; }
+  bool isChunked() const override { return chunked_; }
+  bool hasTransferEncoding() const override { return has_transfer_encoding_; }
+
+private:
+  enum class State : uint8_t {
+    MessageStart,
+    Method,
+    UrlStart,
+    Url,
+    RequestVersionStart,
+    RequestVersion,
+    RequestLineEnd,
+    ResponseVersion,
+    ResponseVersionEnd,
+    StatusCodeStart,
+    StatusCode,
+    ReasonPhrase,
+    FirstLineLf,
+    HeaderFieldStart,
+    HeaderField,
+    HeaderValueStart,
+    HeaderValue,
+    HeaderValueLf,
+    HeadersLf,
+    Body,
+    BodyUntilEof,
+    ChunkSizeStart,
+    ChunkSize,
+    ChunkExtension,
+    ChunkSizeLf,
+    ChunkData,
+    ChunkDataEnd,
+    ChunkDataLf,
+    // The message is complete but onMessageComplete() has not been called yet.
+    MessageDone,
+  };
+
+  // Headers which determine the framing of the body.
+  enum class FramingHeader : uint8_t { None, ContentLength, TransferEncoding };
+
+  // Longest method http_parser accepts: MKACTIVITY and UNSUBSCRIBE are 10 and 11 characters.
+  static constexpr size_t MaxMethodLength = 11;
+  // Longest framing header name: Transfer-Encoding.
+  static constexpr size_t MaxFramingHeaderNameLength = 17;
+
+  /**
+   * Parse data until it is exhausted, a callback pauses the parser or an error is found.
+   * @return the position of the first byte which was not parsed.
+   */
+  const char* parse(const char* p, const char* end);
+
+  // Each of the following handles the byte at p, or the bytes from p on, in the corresponding
+  // state, and returns the position of the first byte it did not consume. Callbacks are invoked
+  // after the bytes which trigger them are consumed, so that a callback which pauses the parser
+  // leaves them out of what remains to be parsed.
+  const char* onMessageStart(const char* p);
+  const char* onMethod(const char* p, const char* end);
+  const char* onUrlData(const char* p, const char* end);
+  const char* onVersion(const char* p, State next_state);
+  const char* onStatusCode(const char* p);
+  const char* onHeaderFieldStart(const char* p);
+  const char* onHeaderFieldData(const char* p, const char* end);
+  const char* onHeaderValueData(const char* p, const char* end);
+  const char* onChunkSize(const char* p);
+
+  void onHeaderLineEnd();
+  void onHeaderBlockEnd();
+  void onChunkHeaderEnd();
+  void onMessageDone();
+  void onBodyData(const char* p, size_t length);
+
+  void resetMessage();
+  void processFramingHeader();
+
+  // Record the result of a callback, failing with error_name if it did not succeed.
+  void checkCallback(CallbackResult result, absl::string_view error_name);
+  void setError(absl::string_view error_name);
+
+  const MessageType type_;
+  ParserCallbacks& callbacks_;
+  const VectorizedScanner& scanner_;
+  State state_{State::MessageStart};
+  ParserStatus status_{ParserStatus::Ok};
+  absl::string_view error_name_;
+
+  // First line.
+  char method_[MaxMethodLength];
+  size_t method_length_{};
+  uint8_t version_index_{};
+  uint8_t http_major_{};
+  uint8_t http_minor_{};
+  uint16_t status_code_{};
+  uint8_t status_code_digits_{};
+
+  // Headers.
+  char header_name_[MaxFramingHeaderNameLength];
+  size_t header_name_length_{};
+  FramingHeader framing_header_{FramingHeader::None};
+  std::string framing_header_value_;
+  absl::optional<uint64_t> content_length_;
+  bool has_transfer_encoding_{};
+  bool chunked_{};
+  bool processing_trailers_{};
+  // Set when onHeadersComplete() returns NoBodyData: parsing stops once the message is complete.
+  bool stop_after_message_{};
+
+  // Bytes left in the body, or in the current chunk.
+  uint64_t remaining_{};
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
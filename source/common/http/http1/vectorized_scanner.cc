@@ -0,0 +1,311 @@
+#include "common/http/http1/vectorized_scanner.h"
+
+#include <array>
+#include <cstdint>
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define ENVOY_HTTP1_VECTORIZED_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+constexpr bool tokenChar(uint8_t c) {
+  if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+    return true;
+  }
+  switch (c) {
+  case '!':
+  case '#':
+  case '$':
+  case '%':
+  case '&':
+  case '\'':
+  case '*':
+  case '+':
+  case '-':
+  case '.':
+  case '^':
+  case '_':
+  case '`':
+  case '|':
+  case '~':
+    return true;
+  default:
+    return false;
+  }
+}
+
+constexpr bool urlEndChar(uint8_t c) { return (c <= ' ' && c != '\t') || c == 0x7f; }
+
+constexpr std::array<bool, 256> makeCharTable(bool (*predicate)(uint8_t)) {
+  std::array<bool, 256> table{};
+  for (size_t c = 0; c < table.size(); ++c) {
+    table[c] = predicate(static_cast<uint8_t>(c));
+  }
+  return table;
+}
+
+constexpr std::array<bool, 256> TokenChars = makeCharTable(tokenChar);
+constexpr std::array<bool, 256> UrlEndChars = makeCharTable(urlEndChar);
+
+size_t scalarFindNonToken(const char* data, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    if (!TokenChars[static_cast<uint8_t>(data[i])]) {
+      return i;
+    }
+  }
+  return length;
+}
+
+size_t scalarFindLineEnd(const char* data, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    if (data[i] == '\r' || data[i] == '\n') {
+      return i;
+    }
+  }
+  return length;
+}
+
+size_t scalarFindUrlEnd(const char* data, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    if (UrlEndChars[static_cast<uint8_t>(data[i])]) {
+      return i;
+    }
+  }
+  return length;
+}
+
+#ifdef ENVOY_HTTP1_VECTORIZED_SCANNER_X86
+
+// Ranges of bytes which are not token characters, as pairs of inclusive bounds for
+// _mm_cmpestri(). The instruction compares against at most 8 ranges, so the last one also covers
+// '|' and '~', which are tokens: those are filtered out with TokenChars.
+alignas(16) constexpr char NonTokenRanges[] = "\x00\x20"
+                                              "\"\""
+                                              "()"
+                                              ",,"
+                                              "//"
+                                              ":@"
+                                              "[]"
+                                              "{\xff";
+
+// SP and the control characters other than HT, and DEL. Padded to the size of a vector.
+alignas(16) constexpr char UrlEndRanges[16] = "\x00\x08"
+                                            "\x0a\x20"
+                                            "\x7f\x7f";
+
+constexpr int CmpestriRangesMode = _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT;
+
+// The SSE4.2 functions are inlined into the AVX2 ones, which use them for the tail of the input:
+// calling them instead would mix legacy SSE and VEX encoded instructions, and the transitions
+// between the two cost more than scanning a short header.
+inline __attribute__((always_inline, target("sse4.2"))) size_t
+sse42FindNonTokenInline(const char* data, size_t length) {
+  const __m128i ranges = _mm_load_si128(reinterpret_cast<const __m128i*>(NonTokenRanges));
+  size_t i = 0;
+  while (i + 16 <= length) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const int index = _mm_cmpestri(ranges, 16, chunk, 16, CmpestriRangesMode);
+    if (index == 16) {
+      i += 16;
+      continue;
+    }
+    i += index;
+    if (!TokenChars[static_cast<uint8_t>(data[i])]) {
+      return i;
+    }
+    ++i;
+  }
+  return i + scalarFindNonToken(data + i, length - i);
+}
+
+inline __attribute__((always_inline, target("sse4.2"))) size_t
+sse42FindLineEndInline(const char* data, size_t length) {
+  const __m128i cr = _mm_set1_epi8('\r');
+  const __m128i lf = _mm_set1_epi8('\n');
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const uint32_t mask = _mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, lf)));
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i + scalarFindLineEnd(data + i, length - i);
+}
+
+inline __attribute__((always_inline, target("sse4.2"))) size_t
+sse42FindUrlEndInline(const char* data, size_t length) {
+  const __m128i ranges = _mm_load_si128(reinterpret_cast<const __m128i*>(UrlEndRanges));
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const int index = _mm_cmpestri(ranges, 6, chunk, 16, CmpestriRangesMode);
+    if (index != 16) {
+      return i + index;
+    }
+  }
+  return i + scalarFindUrlEnd(data + i, length - i);
+}
+
+__attribute__((target("sse4.2"))) size_t sse42FindNonToken(const char* data, size_t length) {
+  return sse42FindNonTokenInline(data, length);
+}
+
+__attribute__((target("sse4.2"))) size_t sse42FindLineEnd(const char* data, size_t length) {
+  return sse42FindLineEndInline(data, length);
+}
+
+__attribute__((target("sse4.2"))) size_t sse42FindUrlEnd(const char* data, size_t length) {
+  return sse42FindUrlEndInline(data, length);
+}
+
+// AVX2 has no equivalent of _mm_cmpestri() for 32 byte vectors, so token characters are looked up
+// in a bitmap indexed by the nibbles of each byte: TokenBitmapRows[low nibble] has bit n set if the
+// byte with high nibble n and that low nibble is a token, and TokenBitmapBits[high nibble] selects
+// bit n. Bytes with the high bit set are never tokens, so their bits are 0.
+constexpr std::array<uint8_t, 16> makeTokenBitmapRows() {
+  std::array<uint8_t, 16> rows{};
+  for (size_t low = 0; low < 16; ++low) {
+    for (size_t high = 0; high < 8; ++high) {
+      if (TokenChars[high << 4 | low]) {
+        rows[low] |= 1 << high;
+      }
+    }
+  }
+  return rows;
+}
+
+alignas(16) constexpr std::array<uint8_t, 16> TokenBitmapRows = makeTokenBitmapRows();
+alignas(16) constexpr std::array<uint8_t, 16> TokenBitmapBits = {1,  2,  4,  8,  16, 32, 64, 128,
+                                                                 0,  0,  0,  0,  0,  0,  0,  0};
+
+__attribute__((target("avx2"))) size_t avx2FindNonToken(const char* data, size_t length) {
+  const __m256i rows = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(TokenBitmapRows.data())));
+  const __m256i bits = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(TokenBitmapBits.data())));
+  const __m256i nibble_mask = _mm256_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const __m256i low = _mm256_and_si256(chunk, nibble_mask);
+    const __m256i high = _mm256_and_si256(_mm256_srli_epi16(chunk, 4), nibble_mask);
+    const __m256i token = _mm256_and_si256(_mm256_shuffle_epi8(rows, low),
+                                           _mm256_shuffle_epi8(bits, high));
+    const uint32_t mask =
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(token, _mm256_setzero_si256()));
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i + sse42FindNonTokenInline(data + i, length - i);
+}
+
+__attribute__((target("avx2"))) size_t avx2FindLineEnd(const char* data, size_t length) {
+  const __m256i cr = _mm256_set1_epi8('\r');
+  const __m256i lf = _mm256_set1_epi8('\n');
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const uint32_t mask = _mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, cr), _mm256_cmpeq_epi8(chunk, lf)));
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i + sse42FindLineEndInline(data + i, length - i);
+}
+
+__attribute__((target("avx2"))) size_t avx2FindUrlEnd(const char* data, size_t length) {
+  const __m256i sp = _mm256_set1_epi8(' ');
+  const __m256i ht = _mm256_set1_epi8('\t');
+  const __m256i del = _mm256_set1_epi8(0x7f);
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    // Unsigned chunk <= SP.
+    const __m256i control_or_sp = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, sp), chunk);
+    const __m256i end = _mm256_or_si256(
+        _mm256_andnot_si256(_mm256_cmpeq_epi8(chunk, ht), control_or_sp),
+        _mm256_cmpeq_epi8(chunk, del));
+    const uint32_t mask = _mm256_movemask_epi8(end);
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i + sse42FindUrlEndInline(data + i, length - i);
+}
+
+#endif
+
+} // namespace
+
+const VectorizedScanner& VectorizedScanner::get() {
+  static const VectorizedScanner& scanner = get(supportedIsas().back());
+  return scanner;
+}
+
+const VectorizedScanner& VectorizedScanner::get(Isa isa) {
+  switch (isa) {
+  case Isa::Scalar: {
+    CONSTRUCT_ON_FIRST_USE(VectorizedScanner, Isa::Scalar, scalarFindNonToken, scalarFindLineEnd,
+                           scalarFindUrlEnd);
+  }
+#ifdef ENVOY_HTTP1_VECTORIZED_SCANNER_X86
+  case Isa::Sse42: {
+    CONSTRUCT_ON_FIRST_USE(VectorizedScanner, Isa::Sse42, sse42FindNonToken, sse42FindLineEnd,
+                           sse42FindUrlEnd);
+  }
+  case Isa::Avx2: {
+    CONSTRUCT_ON_FIRST_USE(VectorizedScanner, Isa::Avx2, avx2FindNonToken, avx2FindLineEnd,
+                           avx2FindUrlEnd);
+  }
+#else
+  case Isa::Sse42:
+  case Isa::Avx2:
+    break;
+#endif
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+std::vector<VectorizedScanner::Isa> VectorizedScanner::supportedIsas() {
+  std::vector<Isa> isas{Isa::Scalar};
+#ifdef ENVOY_HTTP1_VECTORIZED_SCANNER_X86
+  // The AVX2 functions fall back to the SSE4.2 ones for the tail of the input.
+  if (__builtin_cpu_supports("sse4.2")) {
+    isas.push_back(Isa::Sse42);
+    if (__builtin_cpu_supports("avx2")) {
+      isas.push_back(Isa::Avx2);
+    }
+  }
+#endif
+  return isas;
+}
+
+absl::string_view VectorizedScanner::isaName(Isa isa) {
+  switch (isa) {
+  case Isa::Scalar:
+    return "scalar";
+  case Isa::Sse42:
+    return "sse4.2";
+  case Isa::Avx2:
+    return "avx2";
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+bool VectorizedScanner::isTokenChar(char c) { return TokenChars[static_cast<uint8_t>(c)]; }
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
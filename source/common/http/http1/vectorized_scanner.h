@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Locates the delimiters of HTTP/1 message elements, and the bytes which are not allowed in them,
+ * several bytes at a time when the CPU supports it. The instruction set is selected at runtime,
+ * so that builds which do not target SSE4.2 or AVX2 can still use them.
+ */
+class VectorizedScanner {
+public:
+  enum class Isa { Scalar, Sse42, Avx2 };
+
+  /**
+   * @return the scanner using the best instruction set the CPU supports.
+   */
+  static const VectorizedScanner& get();
+
+  /**
+   * @return the scanner using the given instruction set, which the CPU must support.
+   */
+  static const VectorizedScanner& get(Isa isa);
+
+  /**
+   * @return the instruction sets supported by the CPU, including Isa::Scalar.
+   */
+  static std::vector<Isa> supportedIsas();
+
+  static absl::string_view isaName(Isa isa);
+
+  /**
+   * @return whether c may appear in a header name, per the token rule of RFC 7230 Section 3.2.6.
+   */
+  static bool isTokenChar(char c);
+
+  Isa isa() const { return isa_; }
+
+  /**
+   * @return the offset of the first byte which is not a token character, or length if there is
+   *         none.
+   */
+  size_t findNonToken(const char* data, size_t length) const {
+    return find_non_token_(data, length);
+  }
+
+  /**
+   * @return the offset of the first CR or LF, or length if there is none.
+   */
+  size_t findLineEnd(const char* data, size_t length) const { return find_line_end_(data, length); }
+
+  /**
+   * @return the offset of the first byte which ends a request target: SP, or a control character
+   *         other than HT (which includes CR and LF), or DEL. length if there is none.
+   */
+  size_t findUrlEnd(const char* data, size_t length) const { return find_url_end_(data, length); }
+
+private:
+  using FindFunction = size_t (*)(const char* data, size_t length);
+
+  VectorizedScanner(Isa isa, FindFunction find_non_token, FindFunction find_line_end,
+                    FindFunction find_url_end)
+      : isa_(isa), find_non_token_(find_non_token), find_line_end_(find_line_end),
+        find_url_end_(find_url_end) {}
+
+  const Isa isa_;
+  const FindFunction find_non_token_;
+  const FindFunction find_line_end_;
+  const FindFunction find_url_end_;
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
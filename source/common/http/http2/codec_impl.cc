@@ -134,12 +134,13 @@ void ConnectionImpl::StreamImpl::destroy() {
   parent_.stats_.pending_send_bytes_.sub(pending_send_data_.length());
 }
 
-static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& header) {
+static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& header,
+                         bool reference_headers) {
   uint8_t flags = 0;
-  if (header.key().isReference()) {
+  if (reference_headers || header.key().isReference()) {
     flags |= NGHTTP2_NV_FLAG_NO_COPY_NAME;
   }
-  if (header.value().isReference()) {
+  if (reference_headers || header.value().isReference()) {
     flags |= NGHTTP2_NV_FLAG_NO_COPY_VALUE;
   }
   const absl::string_view header_key = header.key().getStringView();
@@ -150,12 +151,13 @@ static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& he
 }
 
 void ConnectionImpl::StreamImpl::buildHeaders(std::vector<nghttp2_nv>& final_headers,
-                                              const HeaderMap& headers) {
+                                              const HeaderMap& headers, bool reference_headers) {
   final_headers.reserve(headers.size());
-  headers.iterate([&final_headers](const HeaderEntry& header) -> HeaderMap::Iterate {
-    insertHeader(final_headers, header);
-    return HeaderMap::Iterate::Continue;
-  });
+  headers.iterate(
+      [&final_headers, reference_headers](const HeaderEntry& header) -> HeaderMap::Iterate {
+        insertHeader(final_headers, header, reference_headers);
+        return HeaderMap::Iterate::Continue;
+      });
 }
 
 void ConnectionImpl::ServerStreamImpl::encode100ContinueHeaders(const ResponseHeaderMap& headers) {
@@ -226,12 +228,13 @@ void ConnectionImpl::ServerStreamImpl::encodeHeaders(const ResponseHeaderMap& he
   // needed until encodeHeadersBase has been called.
   std::vector<nghttp2_nv> final_headers;
   Http::ResponseHeaderMapPtr modified_headers;
+  const bool reference_headers = canReferenceHeaders();
   if (Http::Utility::isUpgrade(headers)) {
     modified_headers = createHeaderMap<ResponseHeaderMapImpl>(headers);
     Http::Utility::transformUpgradeResponseFromH1toH2(*modified_headers);
-    buildHeaders(final_headers, *modified_headers);
+    buildHeaders(final_headers, *modified_headers, reference_headers);
   } else {
-    buildHeaders(final_headers, headers);
+    buildHeaders(final_headers, headers, reference_headers);
   }
   encodeHeadersBase(final_headers, end_stream);
 }
@@ -251,7 +254,7 @@ void ConnectionImpl::StreamImpl::encodeTrailersBase(const HeaderMap& trailers) {
       createPendingFlushTimer();
     }
   } else {
-    submitTrailers(trailers);
+    submitTrailers(trailers, canReferenceHeaders());
     if (parent_.sendPendingFramesAndHandleError()) {
       // Intended to check through coverage that this error case is tested
       return;
@@ -367,7 +370,8 @@ void ConnectionImpl::StreamImpl::saveHeader(HeaderString&& name, HeaderString&&
   }
 }
 
-void ConnectionImpl::StreamImpl::submitTrailers(const HeaderMap& trailers) {
+void ConnectionImpl::StreamImpl::submitTrailers(const HeaderMap& trailers,
+                                                bool reference_headers) {
   ASSERT(local_end_stream_);
   const bool skip_encoding_empty_trailers =
       trailers.empty() && parent_.skip_encoding_empty_trailers_;
@@ -381,7 +385,7 @@ void ConnectionImpl::StreamImpl::submitTrailers(const HeaderMap& trailers) {
   }
 
   std::vector<nghttp2_nv> final_headers;
-  buildHeaders(final_headers, trailers);
+  buildHeaders(final_headers, trailers, reference_headers);
   int rc = nghttp2_submit_trailer(parent_.session_, stream_id_, final_headers.data(),
                                   final_headers.size());
   ASSERT(rc == 0);
@@ -452,6 +456,16 @@ void ConnectionImpl::ServerStreamImpl::submitHeaders(const std::vector<nghttp2_n
   ASSERT(rc == 0);
 }
 
+bool ConnectionImpl::ServerStreamImpl::canReferenceHeaders() const {
+  // Outside of dispatch, sendPendingFrames() hands every frame queued for the connection to
+  // onSend(), which always accepts it, and nghttp2 HPACK encodes the header block of a frame while
+  // preparing it for sending. Responses are never queued for stream concurrency, unlike requests,
+  // so their headers are serialized before the encode call returns. While dispatching, frames are
+  // only sent once the dispatch completes, when the caller's header map may already be gone.
+  return parent_.reference_response_headers_ && !parent_.dispatching_ &&
+         parent_.connection_.state() != Network::Connection::State::Closed;
+}
+
 void ConnectionImpl::ServerStreamImpl::createPendingFlushTimer() {
   ASSERT(stream_idle_timer_ == nullptr);
   if (stream_idle_timeout_.count() > 0) {
@@ -568,6 +582,8 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stat
       protocol_constraints_(stats, http2_options),
       skip_encoding_empty_trailers_(Runtime::runtimeFeatureEnabled(
           "envoy.reloadable_features.http2_skip_encoding_empty_trailers")),
+      reference_response_headers_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.http2_reference_response_headers")),
       dispatching_(false), raised_goaway_(false), pending_deferred_reset_(false),
       random_(random_generator) {
   if (http2_options.has_connection_keepalive()) {
@@ -192,14 +192,20 @@ protected:
     ssize_t onDataSourceRead(uint64_t length, uint32_t* data_flags);
     void onDataSourceSend(const uint8_t* framehd, size_t length);
     void resetStreamWorker(StreamResetReason reason);
-    static void buildHeaders(std::vector<nghttp2_nv>& final_headers, const HeaderMap& headers);
+    // When reference_headers is set, nghttp2 is handed pointers into the header map rather than
+    // copying its names and values, so the header map must outlive the serialization of the frame.
+    static void buildHeaders(std::vector<nghttp2_nv>& final_headers, const HeaderMap& headers,
+                             bool reference_headers = false);
     void saveHeader(HeaderString&& name, HeaderString&& value);
     void encodeHeadersBase(const std::vector<nghttp2_nv>& final_headers, bool end_stream);
     virtual void submitHeaders(const std::vector<nghttp2_nv>& final_headers,
                                nghttp2_data_provider* provider) PURE;
     void encodeTrailersBase(const HeaderMap& headers);
-    void submitTrailers(const HeaderMap& trailers);
+    void submitTrailers(const HeaderMap& trailers, bool reference_headers = false);
     void submitMetadata(uint8_t flags);
+    // Whether headers submitted now are serialized by nghttp2 before the encode call returns, in
+    // which case they do not need to be copied.
+    virtual bool canReferenceHeaders() const { return false; }
     virtual StreamDecoder& decoder() PURE;
     virtual HeaderMap& headers() PURE;
     virtual void allocTrailers() PURE;
@@ -374,6 +380,7 @@ protected:
     // StreamImpl
     void submitHeaders(const std::vector<nghttp2_nv>& final_headers,
                        nghttp2_data_provider* provider) override;
+    bool canReferenceHeaders() const override;
     StreamDecoder& decoder() override { return *request_decoder_; }
     void decodeHeaders() override;
     void decodeTrailers() override;
@@ -505,6 +512,12 @@ protected:
   // flag.
   const bool skip_encoding_empty_trailers_;
 
+  // Response headers and trailers submitted outside of dispatch are serialized by the
+  // sendPendingFrames() call that follows their submission, so that nghttp2 can reference them in
+  // the caller's header map rather than copying every name and value. This is controlled by the
+  // "envoy.reloadable_features.http2_reference_response_headers" runtime feature flag.
+  const bool reference_response_headers_;
+
 private:
   virtual ConnectionCallbacks& callbacks() PURE;
   virtual Status onBeginHeaders(const nghttp2_frame* frame) PURE;
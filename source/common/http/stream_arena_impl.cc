@@ -0,0 +1,62 @@
+#include "common/http/stream_arena_impl.h"
+
+#include <algorithm>
+#include <new>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Http {
+
+StreamArenaImpl::~StreamArenaImpl() {
+  for (Cleanup* cleanup = cleanups_; cleanup != nullptr; cleanup = cleanup->next_) {
+    cleanup->cleanup_(cleanup->object_);
+  }
+  for (Block* block = blocks_head_; block != nullptr;) {
+    Block* next = block->next_;
+    delete[] reinterpret_cast<char*>(block);
+    block = next;
+  }
+}
+
+void* StreamArenaImpl::allocate(size_t size, size_t alignment) {
+  ++allocations_;
+  return allocateInternal(size, alignment);
+}
+
+void StreamArenaImpl::addCleanup(void (*cleanup)(void*), void* object) {
+  cleanups_ = new (allocateInternal(sizeof(Cleanup), alignof(Cleanup)))
+      Cleanup{cleanup, object, cleanups_};
+}
+
+void* StreamArenaImpl::allocateInternal(size_t size, size_t alignment) {
+  ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0 &&
+         alignment <= alignof(std::max_align_t));
+  if (size > block_size_) {
+    // Leave the current block to the allocations which fit.
+    return allocateBlock(size);
+  }
+
+  const uintptr_t aligned =
+      (reinterpret_cast<uintptr_t>(next_) + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+  if (next_ == nullptr || aligned + size > reinterpret_cast<uintptr_t>(end_)) {
+    next_ = allocateBlock(block_size_);
+    end_ = next_ + block_size_;
+    char* memory = next_;
+    next_ += size;
+    return memory;
+  }
+  next_ = reinterpret_cast<char*>(aligned + size);
+  return reinterpret_cast<void*>(aligned);
+}
+
+char* StreamArenaImpl::allocateBlock(size_t size) {
+  // Memory from new char[] is aligned for any type which fits in it.
+  char* memory = new char[sizeof(Block) + std::max<size_t>(size, 1)];
+  blocks_head_ = new (memory) Block{blocks_head_};
+  ++blocks_;
+  return memory + sizeof(Block);
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "envoy/http/stream_arena.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * StreamArena which allocates memory from blocks of a fixed size, allocating a new block from the
+ * heap whenever the current one is exhausted. An allocation larger than a block gets a block of
+ * its own.
+ */
+class StreamArenaImpl : public StreamArena, NonCopyable {
+public:
+  explicit StreamArenaImpl(uint32_t block_size) : block_size_(block_size) {}
+  ~StreamArenaImpl() override;
+
+  // Http::StreamArena
+  void* allocate(size_t size, size_t alignment) override;
+  void addCleanup(void (*cleanup)(void*), void* object) override;
+
+  /**
+   * @return uint64_t the number of allocations made from the arena.
+   */
+  uint64_t allocations() const { return allocations_; }
+
+  /**
+   * @return uint64_t the number of blocks the arena allocated from the heap.
+   */
+  uint64_t blocks() const { return blocks_; }
+
+private:
+  // Header of each block, which links it to the previously allocated block. Its size keeps the
+  // memory after it aligned for any type.
+  struct alignas(alignof(std::max_align_t)) Block {
+    Block* next_;
+  };
+
+  struct Cleanup {
+    void (*cleanup_)(void*);
+    void* object_;
+    Cleanup* next_;
+  };
+
+  void* allocateInternal(size_t size, size_t alignment);
+  char* allocateBlock(size_t size);
+
+  const uint32_t block_size_;
+  Block* blocks_head_{};
+  // Free memory in the current block.
+  char* next_{};
+  char* end_{};
+  // Cleanups in the reverse order of their registration.
+  Cleanup* cleanups_{};
+  uint64_t allocations_{};
+  uint64_t blocks_{};
+};
+
+} // namespace Http
+} // namespace Envoy
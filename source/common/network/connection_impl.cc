@@ -757,6 +757,15 @@ absl::optional<std::chrono::milliseconds> ConnectionImpl::lastRoundTripTime() co
   return socket_->lastRoundTripTime();
 };
 
+IoHandle* ConnectionImpl::spliceableIoHandle() {
+  if (!transport_socket_->passesThroughBytes() || !ioHandle().supportsSplice() ||
+      state() != State::Open || connecting_ || read_end_stream_ || write_end_stream_ ||
+      read_buffer_->length() > 0 || write_buffer_->length() > 0) {
+    return nullptr;
+  }
+  return &ioHandle();
+}
+
 void ConnectionImpl::flushWriteBuffer() {
   if (state() == State::Open && write_buffer_->length() > 0) {
     onWriteReady();
@@ -0,0 +1,102 @@
+#include "common/network/reuse_port_cpu_steering_socket_option_impl.h"
+
+#include "envoy/common/platform.h"
+#include "envoy/config/core/v3/base.pb.h"
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+#include "common/common/utility.h"
+
+#include "absl/container/flat_hash_set.h"
+
+#if defined(SO_ATTACH_REUSEPORT_CBPF) && defined(__linux__)
+#include <linux/filter.h>
+#endif
+
+namespace Envoy {
+namespace Network {
+
+ReusePortCpuSteeringSocketOptionImpl::ReusePortCpuSteeringSocketOptionImpl(
+    uint32_t socket_count, const std::vector<uint32_t>& worker_cpu_set) {
+  ASSERT(socket_count > 0);
+#if defined(SO_ATTACH_REUSEPORT_CBPF) && defined(__linux__)
+  std::vector<sock_filter> filter;
+  // ld #cpu
+  filter.push_back(
+      {BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)});
+  // A table from the CPUs the workers are pinned to to the sockets of the workers. When several
+  // workers share a CPU, its connections go to the first of them.
+  absl::flat_hash_set<uint32_t> cpus;
+  for (uint32_t worker = 0; worker < socket_count && !worker_cpu_set.empty(); ++worker) {
+    const uint32_t cpu = worker_cpu_set[worker % worker_cpu_set.size()];
+    if (!cpus.insert(cpu).second) {
+      continue;
+    }
+    // jeq #cpu, 0, 1
+    filter.push_back({BPF_JMP | BPF_JEQ | BPF_K, 0, 1, cpu});
+    // ret #worker
+    filter.push_back({BPF_RET | BPF_K, 0, 0, worker});
+  }
+  // mod #socket_count
+  filter.push_back({BPF_ALU | BPF_MOD | BPF_K, 0, 0, socket_count});
+  // ret a
+  filter.push_back({BPF_RET | BPF_A, 0, 0, 0});
+  // The CPU set holds at most CPU_SETSIZE CPUs, which keeps the program within BPF_MAXINSNS.
+  ASSERT(filter.size() <= BPF_MAXINSNS);
+  const uint8_t* begin = reinterpret_cast<const uint8_t*>(filter.data());
+  filter_.assign(begin, begin + filter.size() * sizeof(sock_filter));
+#else
+  UNREFERENCED_PARAMETER(socket_count);
+  UNREFERENCED_PARAMETER(worker_cpu_set);
+#endif
+}
+
+bool ReusePortCpuSteeringSocketOptionImpl::setOption(
+    Socket& socket, envoy::config::core::v3::SocketOption::SocketState state) const {
+  // The program has to be attached once the socket listens, as a socket which has a program
+  // before listening is put in a group of its own.
+  if (state != envoy::config::core::v3::SocketOption::STATE_LISTENING) {
+    return true;
+  }
+#if defined(SO_ATTACH_REUSEPORT_CBPF) && defined(__linux__)
+  sock_fprog program;
+  program.len = filter_.size() / sizeof(sock_filter);
+  // setsockopt() only reads the program.
+  program.filter = reinterpret_cast<sock_filter*>(const_cast<uint8_t*>(filter_.data()));
+  const Api::SysCallIntResult result = SocketOptionImpl::setSocketOption(
+      socket, ENVOY_ATTACH_REUSEPORT_CBPF, &program, sizeof(program));
+  if (result.rc_ != 0) {
+    ENVOY_LOG(warn, "Setting SO_ATTACH_REUSEPORT_CBPF option on socket failed: {}",
+              errorDetails(result.errno_));
+    return false;
+  }
+  return true;
+#else
+  UNREFERENCED_PARAMETER(socket);
+  ENVOY_LOG(warn, "Failed to set unsupported option on socket");
+  return false;
+#endif
+}
+
+absl::optional<Socket::Option::Details> ReusePortCpuSteeringSocketOptionImpl::getOptionDetails(
+    const Socket&, envoy::config::core::v3::SocketOption::SocketState state) const {
+  if (state != envoy::config::core::v3::SocketOption::STATE_LISTENING || !isSupported()) {
+    return absl::nullopt;
+  }
+
+  Socket::Option::Details info;
+  info.name_ = ENVOY_ATTACH_REUSEPORT_CBPF;
+  info.value_ = {filter_.begin(), filter_.end()};
+  return absl::make_optional(std::move(info));
+}
+
+bool ReusePortCpuSteeringSocketOptionImpl::isSupported() {
+#if defined(SO_ATTACH_REUSEPORT_CBPF) && defined(__linux__)
+  return true;
+#else
+  return false;
+#endif
+}
+
+} // namespace Network
+} // namespace Envoy
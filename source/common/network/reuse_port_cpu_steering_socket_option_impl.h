@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+#include "envoy/common/platform.h"
+#include "envoy/config/core/v3/base.pb.h"
+#include "envoy/network/listen_socket.h"
+
+#include "common/common/logger.h"
+#include "common/network/socket_option_impl.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * Attaches a classic BPF program to the SO_REUSEPORT group of a listening socket, which delivers
+ * each incoming connection to the socket of the worker pinned to the CPU that received it. Socket
+ * i of the group belongs to worker i; the sockets of a group are indexed in the order they started
+ * listening. Connections received by a CPU no worker is pinned to go to the socket whose index is
+ * that CPU modulo the number of sockets. The program is attached to the whole group, and setting
+ * it on every socket of the group replaces it with an identical one.
+ */
+class ReusePortCpuSteeringSocketOptionImpl : public Socket::Option,
+                                             Logger::Loggable<Logger::Id::connection> {
+public:
+  /**
+   * @param socket_count supplies the number of sockets in the group, one per worker.
+   * @param worker_cpu_set supplies the CPUs the workers are pinned to: worker i runs on CPU
+   *        worker_cpu_set[i % worker_cpu_set.size()]. Empty if the workers aren't pinned.
+   */
+  ReusePortCpuSteeringSocketOptionImpl(uint32_t socket_count,
+                                       const std::vector<uint32_t>& worker_cpu_set);
+
+  // Socket::Option
+  bool setOption(Socket& socket,
+                 envoy::config::core::v3::SocketOption::SocketState state) const override;
+  // The common socket options don't require a hash key.
+  void hashKey(std::vector<uint8_t>&) const override {}
+  absl::optional<Details>
+  getOptionDetails(const Socket& socket,
+                   envoy::config::core::v3::SocketOption::SocketState state) const override;
+
+  /**
+   * @return whether the platform can attach BPF programs to SO_REUSEPORT groups.
+   */
+  static bool isSupported();
+
+private:
+  // The sock_filter instructions of the program. They are kept as bytes so that this header
+  // doesn't depend on Linux headers.
+  std::vector<uint8_t> filter_;
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -4,6 +4,7 @@
 
 #include "common/common/fmt.h"
 #include "common/network/addr_family_aware_socket_option_impl.h"
+#include "common/network/reuse_port_cpu_steering_socket_option_impl.h"
 #include "common/network/socket_option_impl.h"
 
 namespace Envoy {
@@ -132,6 +133,15 @@ std::unique_ptr<Socket::Options> SocketOptionFactory::buildReusePortOptions() {
   return options;
 }
 
+std::unique_ptr<Socket::Options>
+SocketOptionFactory::buildReusePortCpuSteeringOptions(
+    uint32_t socket_count, const std::vector<uint32_t>& worker_cpu_set) {
+  std::unique_ptr<Socket::Options> options = std::make_unique<Socket::Options>();
+  options->push_back(
+      std::make_shared<ReusePortCpuSteeringSocketOptionImpl>(socket_count, worker_cpu_set));
+  return options;
+}
+
 std::unique_ptr<Socket::Options> SocketOptionFactory::buildUdpGroOptions() {
   std::unique_ptr<Socket::Options> options = std::make_unique<Socket::Options>();
   options->push_back(std::make_shared<SocketOptionImpl>(
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "envoy/common/platform.h"
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/network/socket.h"
@@ -33,6 +35,9 @@ public:
   static std::unique_ptr<Socket::Options> buildIpPacketInfoOptions();
   static std::unique_ptr<Socket::Options> buildRxQueueOverFlowOptions();
   static std::unique_ptr<Socket::Options> buildReusePortOptions();
+  static std::unique_ptr<Socket::Options>
+  buildReusePortCpuSteeringOptions(uint32_t socket_count,
+                                   const std::vector<uint32_t>& worker_cpu_set);
   static std::unique_ptr<Socket::Options> buildUdpGroOptions();
 };
 } // namespace Network
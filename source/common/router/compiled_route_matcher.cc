@@ -0,0 +1,119 @@
+#include "common/router/compiled_route_matcher.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/http/path_utility.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Router {
+
+RouteRadixTrie::RouteRadixTrie(bool ignore_case) : ignore_case_(ignore_case) {}
+
+uint8_t RouteRadixTrie::normalize(char c) const {
+  return static_cast<uint8_t>(ignore_case_ ? absl::ascii_tolower(c) : c);
+}
+
+RouteRadixTrie::Routes& RouteRadixTrie::insert(absl::string_view key) {
+  return trie_.insert(key.size(), [this, key](size_t pos) { return normalize(key[pos]); });
+}
+
+void RouteRadixTrie::addPrefix(absl::string_view prefix, uint32_t route_index) {
+  insert(prefix).prefix_routes_.push_back(route_index);
+}
+
+void RouteRadixTrie::addExact(absl::string_view path, uint32_t route_index) {
+  insert(path).exact_routes_.push_back(route_index);
+}
+
+void RouteRadixTrie::collect(absl::string_view path, Candidates& candidates) const {
+  trie_.walk(
+      path.size(), [this, path](size_t pos) { return normalize(path[pos]); },
+      [&candidates, &path](const Routes& routes, size_t pos) {
+        candidates.insert(candidates.end(), routes.prefix_routes_.begin(),
+                          routes.prefix_routes_.end());
+        if (pos == path.size()) {
+          candidates.insert(candidates.end(), routes.exact_routes_.begin(),
+                            routes.exact_routes_.end());
+        }
+      });
+}
+
+CompiledRouteMatcher::CompiledRouteMatcher()
+    : case_sensitive_trie_(false), case_insensitive_trie_(true),
+      regex_set_(std::make_unique<re2::RE2::Set>(re2::RE2::Quiet, re2::RE2::ANCHOR_BOTH)) {}
+
+void CompiledRouteMatcher::addPrefix(absl::string_view prefix, bool case_sensitive,
+                                     uint32_t route_index) {
+  ASSERT(!compiled_);
+  (case_sensitive ? case_sensitive_trie_ : case_insensitive_trie_).addPrefix(prefix, route_index);
+}
+
+void CompiledRouteMatcher::addExactPath(absl::string_view path, bool case_sensitive,
+                                        uint32_t route_index) {
+  ASSERT(!compiled_);
+  (case_sensitive ? case_sensitive_trie_ : case_insensitive_trie_).addExact(path, route_index);
+}
+
+void CompiledRouteMatcher::addRegex(const std::string& regex, uint32_t route_index) {
+  ASSERT(!compiled_);
+  const int set_index = regex_set_->Add(regex, nullptr);
+  if (set_index < 0) {
+    addUnindexed(route_index);
+    return;
+  }
+  ASSERT(static_cast<size_t>(set_index) == regex_routes_.size());
+  regex_routes_.push_back(route_index);
+}
+
+void CompiledRouteMatcher::addUnindexed(uint32_t route_index) {
+  ASSERT(!compiled_);
+  unindexed_routes_.push_back(route_index);
+}
+
+void CompiledRouteMatcher::compile() {
+  ASSERT(!compiled_);
+  compiled_ = true;
+  if (regex_routes_.empty() || !regex_set_->Compile()) {
+    // Either there is nothing to match or the combined program is too large. In the latter case
+    // the regex routes are evaluated individually, as without the index.
+    unindexed_routes_.insert(unindexed_routes_.end(), regex_routes_.begin(), regex_routes_.end());
+    regex_routes_.clear();
+    regex_set_.reset();
+  }
+  std::sort(unindexed_routes_.begin(), unindexed_routes_.end());
+}
+
+void CompiledRouteMatcher::candidates(absl::string_view path, Candidates& candidates) const {
+  ASSERT(compiled_);
+  candidates.clear();
+  const absl::string_view stripped_path = Http::PathUtil::removeQueryAndFragment(path);
+  case_sensitive_trie_.collect(stripped_path, candidates);
+  case_insensitive_trie_.collect(stripped_path, candidates);
+
+  if (regex_set_ != nullptr) {
+    // RE2::Set only fills a std::vector, so reuse one per thread rather than allocating one per
+    // request. Its capacity is bounded by the number of regex routes.
+    static thread_local std::vector<int> matched;
+    matched.clear();
+    re2::RE2::Set::ErrorInfo error_info;
+    if (regex_set_->Match(re2::StringPiece(stripped_path.data(), stripped_path.size()), &matched,
+                          &error_info)) {
+      for (const int set_index : matched) {
+        candidates.push_back(regex_routes_[set_index]);
+      }
+    } else if (error_info.kind != re2::RE2::Set::kNoError) {
+      // The DFA ran out of memory; fall back to evaluating every regex route.
+      candidates.insert(candidates.end(), regex_routes_.begin(), regex_routes_.end());
+    }
+  }
+
+  candidates.insert(candidates.end(), unindexed_routes_.begin(), unindexed_routes_.end());
+  std::sort(candidates.begin(), candidates.end());
+}
+
+} // namespace Router
+} // namespace Envoy
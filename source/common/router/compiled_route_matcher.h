@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/router/radix_trie.h"
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+#include "re2/set.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * A path keyed radix trie that records, per node, the routes whose prefix or exact path ends at
+ * that node. Walking a request path through the trie yields every prefix/exact route that can
+ * match it in O(path length), independent of the number of routes.
+ */
+class RouteRadixTrie {
+public:
+  using Candidates = absl::InlinedVector<uint32_t, 8>;
+
+  /**
+   * @param ignore_case whether keys and lookups are compared ASCII case insensitively.
+   */
+  explicit RouteRadixTrie(bool ignore_case);
+
+  /**
+   * Record a route whose path must start with the given prefix.
+   */
+  void addPrefix(absl::string_view prefix, uint32_t route_index);
+
+  /**
+   * Record a route whose path must be exactly equal to the given path.
+   */
+  void addExact(absl::string_view path, uint32_t route_index);
+
+  /**
+   * Append the indexes of every route that may match the given path (with query string and
+   * fragment already removed) to the candidate list. The appended indexes are not sorted.
+   */
+  void collect(absl::string_view path, Candidates& candidates) const;
+
+  /**
+   * @return the number of trie nodes, for tests.
+   */
+  size_t size() const { return trie_.size(); }
+
+private:
+  struct Routes {
+    std::vector<uint32_t> prefix_routes_;
+    std::vector<uint32_t> exact_routes_;
+  };
+
+  uint8_t normalize(char c) const;
+  Routes& insert(absl::string_view key);
+
+  const bool ignore_case_;
+  RadixTrie<Routes> trie_;
+};
+
+/**
+ * An index over the path matchers of a virtual host's route table. It is built once when the
+ * route configuration is loaded and, given a request path, returns the ordered set of routes that
+ * need to be evaluated. Routes whose path matcher can not be indexed are always returned as
+ * candidates, so evaluating the candidates in order preserves first-match semantics of the
+ * linear route walk.
+ */
+class CompiledRouteMatcher {
+public:
+  using Candidates = RouteRadixTrie::Candidates;
+
+  CompiledRouteMatcher();
+
+  void addPrefix(absl::string_view prefix, bool case_sensitive, uint32_t route_index);
+  void addExactPath(absl::string_view path, bool case_sensitive, uint32_t route_index);
+
+  /**
+   * Add a RE2 regex that must fully match the path for the route to be selected. If the regex
+   * can not be added to the combined regex set, the route is treated as unindexed.
+   */
+  void addRegex(const std::string& regex, uint32_t route_index);
+
+  /**
+   * Add a route that must be evaluated for every request path.
+   */
+  void addUnindexed(uint32_t route_index);
+
+  /**
+   * Finish construction. Must be called once after all routes have been added.
+   */
+  void compile();
+
+  /**
+   * Populate the candidate routes for the given request path in ascending route order.
+   * @param path supplies the :path header value, which may include a query string.
+   */
+  void candidates(absl::string_view path, Candidates& candidates) const;
+
+private:
+  RouteRadixTrie case_sensitive_trie_;
+  RouteRadixTrie case_insensitive_trie_;
+  std::unique_ptr<re2::RE2::Set> regex_set_;
+  // Route index of each pattern added to regex_set_, indexed by the pattern's set index.
+  std::vector<uint32_t> regex_routes_;
+  std::vector<uint32_t> unindexed_routes_;
+  bool compiled_{};
+};
+
+using CompiledRouteMatcherPtr = std::unique_ptr<CompiledRouteMatcher>;
+
+} // namespace Router
+} // namespace Envoy
@@ -1157,6 +1157,10 @@ VirtualHostImpl::VirtualHostImpl(
     hedge_policy_ = virtual_host.hedge_policy();
   }
 
+  if (virtual_host.compile_route_matchers()) {
+    compiled_route_matcher_ = std::make_unique<CompiledRouteMatcher>();
+  }
+
   for (const auto& route : virtual_host.routes()) {
     switch (route.match().path_specifier_case()) {
     case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPrefix: {
@@ -1180,6 +1184,10 @@ VirtualHostImpl::VirtualHostImpl(
       NOT_REACHED_GCOVR_EXCL_LINE;
     }
 
+    if (compiled_route_matcher_ != nullptr) {
+      addToCompiledRouteMatcher(route, routes_.size() - 1);
+    }
+
     if (validation_clusters.has_value()) {
       routes_.back()->validateClusters(*validation_clusters);
       for (const auto& shadow_policy : routes_.back()->shadowPolicies()) {
@@ -1192,6 +1200,10 @@ VirtualHostImpl::VirtualHostImpl(
     }
   }
 
+  if (compiled_route_matcher_ != nullptr) {
+    compiled_route_matcher_->compile();
+  }
+
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
     virtual_clusters_.push_back(
         VirtualClusterEntry(virtual_cluster, *vcluster_scope_,
@@ -1203,6 +1215,26 @@ VirtualHostImpl::VirtualHostImpl(
   }
 }
 
+void VirtualHostImpl::addToCompiledRouteMatcher(const envoy::config::route::v3::Route& route,
+                                                uint32_t route_index) {
+  const bool case_sensitive = PROTOBUF_GET_WRAPPED_OR_DEFAULT(route.match(), case_sensitive, true);
+  switch (route.match().path_specifier_case()) {
+  case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPrefix:
+    compiled_route_matcher_->addPrefix(route.match().prefix(), case_sensitive, route_index);
+    break;
+  case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPath:
+    compiled_route_matcher_->addExactPath(route.match().path(), case_sensitive, route_index);
+    break;
+  case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kSafeRegex:
+    compiled_route_matcher_->addRegex(route.match().safe_regex().regex(), route_index);
+    break;
+  default:
+    // std::regex and CONNECT matchers can not be indexed and are evaluated for every request.
+    compiled_route_matcher_->addUnindexed(route_index);
+    break;
+  }
+}
+
 VirtualHostImpl::VirtualClusterEntry::VirtualClusterEntry(
     const envoy::config::route::v3::VirtualCluster& virtual_cluster, Stats::Scope& scope,
     const VirtualClusterStatNames& stat_names)
@@ -1241,28 +1273,6 @@ const RouteSpecificFilterConfig* VirtualHostImpl::perFilterConfig(const std::str
   return per_filter_configs_.get(name);
 }
 
-const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
-    const std::string& host, const RouteMatcher::WildcardVirtualHosts& wildcard_virtual_hosts,
-    RouteMatcher::SubstringFunction substring_function) const {
-  // We do a longest wildcard match against the host that's passed in
-  // (e.g. "foo-bar.baz.com" should match "*-bar.baz.com" before matching "*.baz.com" for suffix
-  // wildcards). This is done by scanning the length => wildcards map looking for every wildcard
-  // whose size is < length.
-  for (const auto& iter : wildcard_virtual_hosts) {
-    const uint32_t wildcard_length = iter.first;
-    const auto& wildcard_map = iter.second;
-    // >= because *.foo.com shouldn't match .foo.com.
-    if (wildcard_length >= host.size()) {
-      continue;
-    }
-    const auto& match = wildcard_map.find(substring_function(host, wildcard_length));
-    if (match != wildcard_map.end()) {
-      return match->second.get();
-    }
-  }
-  return nullptr;
-}
-
 RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& route_config,
                            const ConfigImpl& global_route_config,
                            Server::Configuration::ServerFactoryContext& factory_context,
@@ -1287,15 +1297,13 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
         }
         default_virtual_host_ = virtual_host;
       } else if (!domain.empty() && '*' == domain[0]) {
-        duplicate_found = !wildcard_virtual_host_suffixes_[domain.size() - 1]
-                               .emplace(domain.substr(1), virtual_host)
-                               .second;
+        duplicate_found =
+            !virtual_host_suffixes_.addWildcard(absl::string_view(domain).substr(1), virtual_host);
       } else if (!domain.empty() && '*' == domain[domain.size() - 1]) {
-        duplicate_found = !wildcard_virtual_host_prefixes_[domain.size() - 1]
-                               .emplace(domain.substr(0, domain.size() - 1), virtual_host)
-                               .second;
+        duplicate_found = !wildcard_virtual_host_prefixes_.addWildcard(
+            absl::string_view(domain).substr(0, domain.size() - 1), virtual_host);
       } else {
-        duplicate_found = !virtual_hosts_.emplace(domain, virtual_host).second;
+        duplicate_found = !virtual_host_suffixes_.addExact(domain, virtual_host);
       }
       if (duplicate_found) {
         throw EnvoyException(fmt::format("Only unique values for domains are permitted. Duplicate "
@@ -1326,6 +1334,10 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
     return SSL_REDIRECT_ROUTE;
   }
 
+  if (compiled_route_matcher_ != nullptr && headers.Path() != nullptr) {
+    return getRouteFromCompiledMatcher(cb, headers, stream_info, random_value);
+  }
+
   // Check for a route that matches the request.
   for (auto route = routes_.begin(); route != routes_.end(); ++route) {
     if (!headers.Path() && !(*route)->supportsPathlessHeaders()) {
@@ -1358,10 +1370,45 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
   return nullptr;
 }
 
+RouteConstSharedPtr VirtualHostImpl::getRouteFromCompiledMatcher(
+    const RouteCallback& cb, const Http::RequestHeaderMap& headers,
+    const StreamInfo::StreamInfo& stream_info, uint64_t random_value) const {
+  CompiledRouteMatcher::Candidates candidates;
+  compiled_route_matcher_->candidates(headers.getPathValue(), candidates);
+
+  // Candidates are in route table order, and every route that is not a candidate can not match
+  // the path, so this yields the same result as walking all of routes_.
+  for (const uint32_t route_index : candidates) {
+    RouteConstSharedPtr route_entry =
+        routes_[route_index]->matches(headers, stream_info, random_value);
+    if (nullptr == route_entry) {
+      continue;
+    }
+
+    if (cb) {
+      RouteEvalStatus eval_status = (route_index + 1 == routes_.size())
+                                        ? RouteEvalStatus::NoMoreRoutes
+                                        : RouteEvalStatus::HasMoreRoutes;
+      RouteMatchStatus match_status = cb(route_entry, eval_status);
+      if (match_status == RouteMatchStatus::Accept) {
+        return route_entry;
+      }
+      if (match_status == RouteMatchStatus::Continue &&
+          eval_status == RouteEvalStatus::NoMoreRoutes) {
+        return nullptr;
+      }
+      continue;
+    }
+
+    return route_entry;
+  }
+
+  return nullptr;
+}
+
 const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::RequestHeaderMap& headers) const {
   // Fast path the case where we only have a default virtual host.
-  if (virtual_hosts_.empty() && wildcard_virtual_host_suffixes_.empty() &&
-      wildcard_virtual_host_prefixes_.empty()) {
+  if (virtual_host_suffixes_.empty() && wildcard_virtual_host_prefixes_.empty()) {
     return default_virtual_host_.get();
   }
 
@@ -1372,26 +1419,22 @@ const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::RequestHeaderMa
 
   // TODO (@rshriram) Match Origin header in WebSocket
   // request with VHost, using wildcard match
-  // Lower-case the value of the host header, as hostnames are case insensitive.
-  const std::string host = absl::AsciiStrToLower(headers.getHostValue());
-  const auto& iter = virtual_hosts_.find(host);
-  if (iter != virtual_hosts_.end()) {
-    return iter->second.get();
-  }
-  if (!wildcard_virtual_host_suffixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_suffixes_,
-        [](const std::string& h, int l) -> std::string { return h.substr(h.size() - l); });
-    if (vhost != nullptr) {
-      return vhost;
-    }
+  // Hostnames are case insensitive; the domain tries lower-case the host while walking it.
+  const absl::string_view host = headers.getHostValue();
+  // An exact match wins over wildcards. Otherwise the longest wildcard wins (e.g.
+  // "foo-bar.baz.com" matches "*-bar.baz.com" before "*.baz.com"), and suffix wildcards win over
+  // prefix wildcards.
+  const auto suffix_match = virtual_host_suffixes_.find(host);
+  if (suffix_match.exact_ != nullptr) {
+    return suffix_match.exact_->get();
+  }
+  if (suffix_match.wildcard_ != nullptr) {
+    return suffix_match.wildcard_->get();
   }
   if (!wildcard_virtual_host_prefixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_prefixes_,
-        [](const std::string& h, int l) -> std::string { return h.substr(0, l); });
-    if (vhost != nullptr) {
-      return vhost;
+    const auto prefix_match = wildcard_virtual_host_prefixes_.find(host);
+    if (prefix_match.wildcard_ != nullptr) {
+      return prefix_match.wildcard_->get();
     }
   }
   return default_virtual_host_.get();
@@ -23,7 +23,9 @@
 #include "common/config/metadata.h"
 #include "common/http/hash_policy.h"
 #include "common/http/header_utility.h"
+#include "common/router/compiled_route_matcher.h"
 #include "common/router/config_utility.h"
+#include "common/router/domain_trie.h"
 #include "common/router/header_formatter.h"
 #include "common/router/header_parser.h"
 #include "common/router/metadatamatchcriteria_impl.h"
@@ -230,11 +232,20 @@ private:
                              stat_names) {}
   };
 
+  void addToCompiledRouteMatcher(const envoy::config::route::v3::Route& route,
+                                 uint32_t route_index);
+  RouteConstSharedPtr getRouteFromCompiledMatcher(const RouteCallback& cb,
+                                                  const Http::RequestHeaderMap& headers,
+                                                  const StreamInfo::StreamInfo& stream_info,
+                                                  uint64_t random_value) const;
+
   static const std::shared_ptr<const SslRedirectRoute> SSL_REDIRECT_ROUTE;
 
   const Stats::StatNameManagedStorage stat_name_storage_;
   Stats::ScopePtr vcluster_scope_;
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  // Only set when compile_route_matchers is enabled for the virtual host.
+  CompiledRouteMatcherPtr compiled_route_matcher_;
   std::vector<VirtualClusterEntry> virtual_clusters_;
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
@@ -962,26 +973,12 @@ public:
   const VirtualHostImpl* findVirtualHost(const Http::RequestHeaderMap& headers) const;
 
 private:
-  using WildcardVirtualHosts =
-      std::map<int64_t, absl::node_hash_map<std::string, VirtualHostSharedPtr>, std::greater<>>;
-  using SubstringFunction = std::function<std::string(const std::string&, int)>;
-  const VirtualHostImpl* findWildcardVirtualHost(const std::string& host,
-                                                 const WildcardVirtualHosts& wildcard_virtual_hosts,
-                                                 SubstringFunction substring_function) const;
-
   Stats::ScopePtr vhost_scope_;
-  absl::node_hash_map<std::string, VirtualHostSharedPtr> virtual_hosts_;
-  // std::greater as a minor optimization to iterate from more to less specific
-  //
-  // A note on using an unordered_map versus a vector of (string, VirtualHostSharedPtr) pairs:
-  //
-  // Based on local benchmarks, each vector entry costs around 20ns for recall and (string)
-  // comparison with a fixed cost of about 25ns. For unordered_map, the empty map costs about 65ns
-  // and climbs to about 110ns once there are any entries.
-  //
-  // The break-even is 4 entries.
-  WildcardVirtualHosts wildcard_virtual_host_suffixes_;
-  WildcardVirtualHosts wildcard_virtual_host_prefixes_;
+  // Exact domains and suffix wildcards (e.g. "*.foo.com"), walked from the end of the host so a
+  // single pass finds both the exact match and the longest suffix wildcard match.
+  DomainTrie<VirtualHostSharedPtr, true> virtual_host_suffixes_;
+  // Prefix wildcards (e.g. "foo.*"), only consulted when there is no exact or suffix match.
+  DomainTrie<VirtualHostSharedPtr, false> wildcard_virtual_host_prefixes_;
 
   VirtualHostSharedPtr default_virtual_host_;
 };
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include "common/router/radix_trie.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * A radix trie over virtual host domains. Keys are inserted and looked up either front to back
+ * (for prefix wildcards such as "foo.*") or back to front (for exact domains and suffix wildcards
+ * such as "*.foo.com"), so that one walk over the Host header finds the exact match and the longest
+ * wildcard match at the same time. Lookups lower case the host on the fly, so callers do not need
+ * to allocate a lower cased copy. Keys must already be lower case.
+ */
+template <class Value, bool Reversed> class DomainTrie {
+public:
+  struct Match {
+    // Value added with addExact() for the full host, if any.
+    const Value* exact_{};
+    // Value of the longest key added with addWildcard() that is a strict prefix (or suffix when
+    // reversed) of the host, if any.
+    const Value* wildcard_{};
+  };
+
+  /**
+   * Add a value that matches only when the host is equal to the key.
+   * @return false if a value already exists for this key.
+   */
+  bool addExact(absl::string_view key, Value value) {
+    return add(trie_.insert(key.size(), keyAt(key)).exact_, std::move(value));
+  }
+
+  /**
+   * Add a value that matches when the key is a prefix (suffix when reversed) of the host and the
+   * host has at least one more character, i.e. the wildcard part is never empty.
+   * @return false if a value already exists for this key.
+   */
+  bool addWildcard(absl::string_view key, Value value) {
+    return add(trie_.insert(key.size(), keyAt(key)).wildcard_, std::move(value));
+  }
+
+  /**
+   * Walk the host once and return the exact and longest wildcard matches.
+   */
+  Match find(absl::string_view host) const {
+    Match match;
+    trie_.walk(
+        host.size(),
+        [host](size_t pos) -> uint8_t { return absl::ascii_tolower(at(host, pos)); },
+        [&match, &host](const Values& values, size_t pos) {
+          if (values.wildcard_.has_value() && pos < host.size()) {
+            match.wildcard_ = &values.wildcard_.value();
+          }
+          if (values.exact_.has_value() && pos == host.size()) {
+            match.exact_ = &values.exact_.value();
+          }
+        });
+    return match;
+  }
+
+  bool empty() const { return empty_; }
+
+  /**
+   * @return the number of trie nodes, for tests.
+   */
+  size_t size() const { return trie_.size(); }
+
+private:
+  struct Values {
+    absl::optional<Value> exact_;
+    absl::optional<Value> wildcard_;
+  };
+
+  static uint8_t at(absl::string_view key, size_t pos) {
+    return Reversed ? key[key.size() - 1 - pos] : key[pos];
+  }
+
+  static auto keyAt(absl::string_view key) {
+    return [key](size_t pos) -> uint8_t { return at(key, pos); };
+  }
+
+  bool add(absl::optional<Value>& slot, Value value) {
+    if (slot.has_value()) {
+      return false;
+    }
+    slot = std::move(value);
+    empty_ = false;
+    return true;
+  }
+
+  RadixTrie<Values> trie_;
+  bool empty_{true};
+};
+
+} // namespace Router
+} // namespace Envoy
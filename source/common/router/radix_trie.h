@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * The node storage, insertion and walk shared by the router's radix tries. Nodes live in one
+ * vector and are referenced by index; node 0 is the root and has an empty label. Each node holds a
+ * Payload, which the owning trie uses to record what ends at that node.
+ *
+ * Keys are passed as a size and a function returning the byte at a position as a uint8_t, so that
+ * owners can walk keys in reverse or normalize their case without copying them. The function must
+ * return the same bytes for a key on insertion as for a matching key on lookup.
+ */
+template <class Payload> class RadixTrie {
+public:
+  RadixTrie() { nodes_.emplace_back(); }
+
+  /**
+   * Insert a key, adding a leaf or splitting an edge if needed.
+   * @param size the length of the key.
+   * @param key_at returns the byte of the key at a position.
+   * @return Payload& the payload of the node the key ends at.
+   */
+  template <class KeyAt> Payload& insert(size_t size, const KeyAt& key_at) {
+    uint32_t current = 0;
+    size_t pos = 0;
+    while (pos < size) {
+      const uint8_t c = key_at(pos);
+      const int64_t child = findChild(nodes_[current], c);
+      if (child < 0) {
+        // No edge starts with this byte, so the rest of the key becomes a new leaf.
+        Node leaf;
+        leaf.label_.reserve(size - pos);
+        for (size_t i = pos; i < size; ++i) {
+          leaf.label_.push_back(key_at(i));
+        }
+        const uint32_t leaf_index = nodes_.size();
+        nodes_.push_back(std::move(leaf));
+        auto& children = nodes_[current].children_;
+        const auto it =
+            std::lower_bound(children.begin(), children.end(), std::make_pair(c, uint32_t(0)));
+        children.emplace(it, c, leaf_index);
+        return nodes_[leaf_index].payload_;
+      }
+
+      const size_t label_size = nodes_[child].label_.size();
+      size_t common = 1;
+      while (common < label_size && pos + common < size &&
+             static_cast<uint8_t>(nodes_[child].label_[common]) == key_at(pos + common)) {
+        ++common;
+      }
+      if (common == label_size) {
+        current = child;
+        pos += common;
+        continue;
+      }
+
+      // The key diverges (or ends) inside the child's edge. Split the edge so that the shared
+      // part becomes its own node.
+      Node middle;
+      middle.label_ = nodes_[child].label_.substr(0, common);
+      nodes_[child].label_.erase(0, common);
+      middle.children_.emplace_back(static_cast<uint8_t>(nodes_[child].label_[0]), child);
+      const uint32_t middle_index = nodes_.size();
+      nodes_.push_back(std::move(middle));
+      for (auto& entry : nodes_[current].children_) {
+        if (entry.second == child) {
+          entry.second = middle_index;
+          break;
+        }
+      }
+      current = middle_index;
+      pos += common;
+    }
+    return nodes_[current].payload_;
+  }
+
+  /**
+   * Walk a key down the trie, calling visit(payload, pos) for the root and for every node whose
+   * whole path matches the start of the key, in walk order. pos is the length of that path, so
+   * the key ends at the last visited node if pos equals its size.
+   * @param size the length of the key.
+   * @param key_at returns the byte of the key at a position.
+   */
+  template <class KeyAt, class Visit>
+  void walk(size_t size, const KeyAt& key_at, const Visit& visit) const {
+    const Node* node = &nodes_[0];
+    size_t pos = 0;
+    visit(node->payload_, pos);
+    while (pos < size) {
+      const int64_t child = findChild(*node, key_at(pos));
+      if (child < 0) {
+        return;
+      }
+      const Node& next = nodes_[child];
+      if (size - pos < next.label_.size()) {
+        return;
+      }
+      for (size_t i = 1; i < next.label_.size(); ++i) {
+        if (static_cast<uint8_t>(next.label_[i]) != key_at(pos + i)) {
+          return;
+        }
+      }
+      pos += next.label_.size();
+      node = &next;
+      visit(node->payload_, pos);
+    }
+  }
+
+  /**
+   * @return the number of trie nodes, for tests.
+   */
+  size_t size() const { return nodes_.size(); }
+
+private:
+  struct Node {
+    // Edge label leading from the parent node to this node, in walk order.
+    std::string label_;
+    // Children keyed by the first byte of their label, sorted by that byte.
+    std::vector<std::pair<uint8_t, uint32_t>> children_;
+    Payload payload_;
+  };
+
+  int64_t findChild(const Node& node, uint8_t c) const {
+    const auto it = std::lower_bound(node.children_.begin(), node.children_.end(), c,
+                                     [](const std::pair<uint8_t, uint32_t>& child, uint8_t value) {
+                                       return child.first < value;
+                                     });
+    if (it == node.children_.end() || it->first != c) {
+      return -1;
+    }
+    return it->second;
+  }
+
+  std::vector<Node> nodes_;
+};
+
+} // namespace Router
+} // namespace Envoy
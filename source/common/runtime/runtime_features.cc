@@ -76,7 +76,9 @@ constexpr const char* runtime_features[] = {
     "envoy.reloadable_features.http_set_copy_replace_all_headers",
     "envoy.reloadable_features.http_transport_failure_reason_in_body",
     "envoy.reloadable_features.http_upstream_wait_connect_response",
+    "envoy.reloadable_features.http2_reference_response_headers",
     "envoy.reloadable_features.http2_skip_encoding_empty_trailers",
+    "envoy.reloadable_features.json_formatter_direct_output",
     "envoy.reloadable_features.listener_in_place_filterchain_update",
     "envoy.reloadable_features.overload_manager_disable_keepalive_drain_http2",
     "envoy.reloadable_features.prefer_quic_kernel_bpf_packet_routing",
@@ -109,6 +111,9 @@ constexpr const char* disabled_runtime_features[] = {
     "envoy.reloadable_features.enable_type_url_downgrade_and_upgrade",
     // TODO(alyssawilk) flip true after the release.
     "envoy.reloadable_features.new_tcp_connection_pool",
+    // Enable by default once tls_throughput_benchmark shows that writing records per slice is a
+    // net win over always coalescing full sized records.
+    "envoy.reloadable_features.tls_write_records_per_slice",
     // Sentinel and test flag.
     "envoy.reloadable_features.test_feature_false",
 };
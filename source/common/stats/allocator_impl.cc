@@ -22,19 +22,40 @@ namespace Stats {
 
 const char AllocatorImpl::DecrementToZeroSyncPoint[] = "decrement-zero";
 
+AllocatorImpl::AllocatorImpl(SymbolTable& symbol_table, uint32_t num_shards)
+    : symbol_table_(symbol_table) {
+  ASSERT(num_shards >= 1 && num_shards <= MaxShards);
+  shards_.reserve(num_shards);
+  for (uint32_t i = 0; i < num_shards; ++i) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+}
+
 AllocatorImpl::~AllocatorImpl() {
-  ASSERT(counters_.empty());
-  ASSERT(gauges_.empty());
+  for (auto& shard : shards_) {
+    Thread::LockGuard lock(shard->mutex_);
+    ASSERT(shard->counters_.empty());
+    ASSERT(shard->gauges_.empty());
+  }
+}
+
+uint16_t AllocatorImpl::shardIndex(StatName name) const {
+  if (shards_.size() == 1) {
+    return 0;
+  }
+  return name.hash() % shards_.size();
 }
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void AllocatorImpl::debugPrint() {
-  Thread::LockGuard lock(mutex_);
-  for (Counter* counter : counters_) {
-    ENVOY_LOG_MISC(info, "counter: {}", symbolTable().toString(counter->statName()));
-  }
-  for (Gauge* gauge : gauges_) {
-    ENVOY_LOG_MISC(info, "gauge: {}", symbolTable().toString(gauge->statName()));
+  for (auto& shard : shards_) {
+    Thread::LockGuard lock(shard->mutex_);
+    for (Counter* counter : shard->counters_) {
+      ENVOY_LOG_MISC(info, "counter: {}", symbolTable().toString(counter->statName()));
+    }
+    for (Gauge* gauge : shard->gauges_) {
+      ENVOY_LOG_MISC(info, "gauge: {}", symbolTable().toString(gauge->statName()));
+    }
   }
 }
 #endif
@@ -46,13 +67,15 @@ void AllocatorImpl::debugPrint() {
 // when they are destroyed.
 //
 // We implement the RefcountInterface API, using 16 bits that would otherwise be
-// wasted in the alignment padding next to flags_.
+// wasted in the alignment padding next to flags_. The allocator shard holding
+// the stat is remembered in the remaining 16 bits of padding, so that the name
+// does not need to be hashed again when the stat is freed.
 template <class BaseClass> class StatsSharedImpl : public MetricImpl<BaseClass> {
 public:
   StatsSharedImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
-                  const StatNameTagVector& stat_name_tags)
+                  const StatNameTagVector& stat_name_tags, uint16_t shard_index)
       : MetricImpl<BaseClass>(name, tag_extracted_name, stat_name_tags, alloc.symbolTable()),
-        alloc_(alloc) {}
+        alloc_(alloc), shard_index_(shard_index) {}
 
   ~StatsSharedImpl() override {
     // MetricImpl must be explicitly cleared() before destruction, otherwise it
@@ -69,8 +92,8 @@ public:
   // RefcountInterface
   void incRefCount() override { ++ref_count_; }
   bool decRefCount() override {
-    // We must, unfortunately, hold the allocator's lock when decrementing the
-    // refcount. Otherwise another thread may simultaneously try to allocate the
+    // We must, unfortunately, hold the allocator shard's lock when decrementing
+    // the refcount. Otherwise another thread may simultaneously try to allocate the
     // same name'd stat after we decrement it, and we'll wind up with a
     // dtor/update race. To avoid this we must hold the lock until the stat is
     // removed from the map.
@@ -80,11 +103,12 @@ public:
     // destruct anything. But it seems preferable at to be conservative here,
     // as stats will only go out of scope when a scope is destructed (during
     // xDS) or during admin stats operations.
-    Thread::LockGuard lock(alloc_.mutex_);
+    AllocatorImpl::Shard& shard = alloc_.shard(shard_index_);
+    Thread::LockGuard lock(shard.mutex_);
     ASSERT(ref_count_ >= 1);
     if (--ref_count_ == 0) {
       alloc_.sync().syncPoint(AllocatorImpl::DecrementToZeroSyncPoint);
-      removeFromSetLockHeld();
+      removeFromSetLockHeld(shard);
       return true;
     }
     return false;
@@ -92,11 +116,12 @@ public:
   uint32_t use_count() const override { return ref_count_; }
 
   /**
-   * We must atomically remove the counter/gauges from the allocator's sets when
-   * our ref-count decrement hits zero. The counters and gauges are held in
-   * distinct sets so we virtualize this removal helper.
+   * We must atomically remove the counter/gauges from the allocator shard's
+   * sets when our ref-count decrement hits zero. The counters and gauges are
+   * held in distinct sets so we virtualize this removal helper.
    */
-  virtual void removeFromSetLockHeld() ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) PURE;
+  virtual void removeFromSetLockHeld(AllocatorImpl::Shard& shard)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_) PURE;
 
 protected:
   AllocatorImpl& alloc_;
@@ -107,22 +132,26 @@ protected:
   // but these are always in transition to ref-count 2 or higher, and thus
   // cannot race with a decrement to zero.
   //
-  // However, we must hold alloc_.mutex_ when decrementing ref_count_ so that
-  // when it hits zero we can atomically remove it from alloc_.counters_ or
-  // alloc_.gauges_. We leave it atomic to avoid taking the lock on increment.
+  // However, we must hold the shard's mutex_ when decrementing ref_count_ so
+  // that when it hits zero we can atomically remove it from the shard's
+  // counters_ or gauges_. We leave it atomic to avoid taking the lock on
+  // increment.
   std::atomic<uint32_t> ref_count_{0};
 
   std::atomic<uint16_t> flags_{0};
+
+  const uint16_t shard_index_;
 };
 
 class CounterImpl : public StatsSharedImpl<Counter> {
 public:
   CounterImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
-              const StatNameTagVector& stat_name_tags)
-      : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags) {}
+              const StatNameTagVector& stat_name_tags, uint16_t shard_index)
+      : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags, shard_index) {}
 
-  void removeFromSetLockHeld() ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) override {
-    const size_t count = alloc_.counters_.erase(statName());
+  void removeFromSetLockHeld(AllocatorImpl::Shard& shard)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_) override {
+    const size_t count = shard.counters_.erase(statName());
     ASSERT(count == 1);
   }
 
@@ -147,8 +176,8 @@ private:
 class GaugeImpl : public StatsSharedImpl<Gauge> {
 public:
   GaugeImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
-            const StatNameTagVector& stat_name_tags, ImportMode import_mode)
-      : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags) {
+            const StatNameTagVector& stat_name_tags, ImportMode import_mode, uint16_t shard_index)
+      : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags, shard_index) {
     switch (import_mode) {
     case ImportMode::Accumulate:
       flags_ |= Flags::LogicAccumulate;
@@ -165,8 +194,9 @@ public:
     }
   }
 
-  void removeFromSetLockHeld() override ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) {
-    const size_t count = alloc_.gauges_.erase(statName());
+  void removeFromSetLockHeld(AllocatorImpl::Shard& shard) override
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_) {
+    const size_t count = shard.gauges_.erase(statName());
     ASSERT(count == 1);
   }
 
@@ -234,11 +264,12 @@ private:
 class TextReadoutImpl : public StatsSharedImpl<TextReadout> {
 public:
   TextReadoutImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
-                  const StatNameTagVector& stat_name_tags)
-      : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags) {}
+                  const StatNameTagVector& stat_name_tags, uint16_t shard_index)
+      : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags, shard_index) {}
 
-  void removeFromSetLockHeld() ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) override {
-    const size_t count = alloc_.text_readouts_.erase(statName());
+  void removeFromSetLockHeld(AllocatorImpl::Shard& shard)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_) override {
+    const size_t count = shard.text_readouts_.erase(statName());
     ASSERT(count == 1);
   }
 
@@ -260,60 +291,71 @@ private:
 
 CounterSharedPtr AllocatorImpl::makeCounter(StatName name, StatName tag_extracted_name,
                                             const StatNameTagVector& stat_name_tags) {
-  Thread::LockGuard lock(mutex_);
-  ASSERT(gauges_.find(name) == gauges_.end());
-  ASSERT(text_readouts_.find(name) == text_readouts_.end());
-  auto iter = counters_.find(name);
-  if (iter != counters_.end()) {
+  const uint16_t shard_index = shardIndex(name);
+  Shard& shard = *shards_[shard_index];
+  Thread::LockGuard lock(shard.mutex_);
+  ASSERT(shard.gauges_.find(name) == shard.gauges_.end());
+  ASSERT(shard.text_readouts_.find(name) == shard.text_readouts_.end());
+  auto iter = shard.counters_.find(name);
+  if (iter != shard.counters_.end()) {
     return CounterSharedPtr(*iter);
   }
-  auto counter = CounterSharedPtr(makeCounterInternal(name, tag_extracted_name, stat_name_tags));
-  counters_.insert(counter.get());
+  auto counter = CounterSharedPtr(
+      makeCounterInternal(name, tag_extracted_name, stat_name_tags, shard_index));
+  shard.counters_.insert(counter.get());
   return counter;
 }
 
 GaugeSharedPtr AllocatorImpl::makeGauge(StatName name, StatName tag_extracted_name,
                                         const StatNameTagVector& stat_name_tags,
                                         Gauge::ImportMode import_mode) {
-  Thread::LockGuard lock(mutex_);
-  ASSERT(counters_.find(name) == counters_.end());
-  ASSERT(text_readouts_.find(name) == text_readouts_.end());
-  auto iter = gauges_.find(name);
-  if (iter != gauges_.end()) {
+  const uint16_t shard_index = shardIndex(name);
+  Shard& shard = *shards_[shard_index];
+  Thread::LockGuard lock(shard.mutex_);
+  ASSERT(shard.counters_.find(name) == shard.counters_.end());
+  ASSERT(shard.text_readouts_.find(name) == shard.text_readouts_.end());
+  auto iter = shard.gauges_.find(name);
+  if (iter != shard.gauges_.end()) {
     return GaugeSharedPtr(*iter);
   }
-  auto gauge =
-      GaugeSharedPtr(new GaugeImpl(name, *this, tag_extracted_name, stat_name_tags, import_mode));
-  gauges_.insert(gauge.get());
+  auto gauge = GaugeSharedPtr(
+      new GaugeImpl(name, *this, tag_extracted_name, stat_name_tags, import_mode, shard_index));
+  shard.gauges_.insert(gauge.get());
   return gauge;
 }
 
 TextReadoutSharedPtr AllocatorImpl::makeTextReadout(StatName name, StatName tag_extracted_name,
                                                     const StatNameTagVector& stat_name_tags) {
-  Thread::LockGuard lock(mutex_);
-  ASSERT(counters_.find(name) == counters_.end());
-  ASSERT(gauges_.find(name) == gauges_.end());
-  auto iter = text_readouts_.find(name);
-  if (iter != text_readouts_.end()) {
+  const uint16_t shard_index = shardIndex(name);
+  Shard& shard = *shards_[shard_index];
+  Thread::LockGuard lock(shard.mutex_);
+  ASSERT(shard.counters_.find(name) == shard.counters_.end());
+  ASSERT(shard.gauges_.find(name) == shard.gauges_.end());
+  auto iter = shard.text_readouts_.find(name);
+  if (iter != shard.text_readouts_.end()) {
     return TextReadoutSharedPtr(*iter);
   }
-  auto text_readout =
-      TextReadoutSharedPtr(new TextReadoutImpl(name, *this, tag_extracted_name, stat_name_tags));
-  text_readouts_.insert(text_readout.get());
+  auto text_readout = TextReadoutSharedPtr(
+      new TextReadoutImpl(name, *this, tag_extracted_name, stat_name_tags, shard_index));
+  shard.text_readouts_.insert(text_readout.get());
   return text_readout;
 }
 
 bool AllocatorImpl::isMutexLockedForTest() {
-  bool locked = mutex_.tryLock();
-  if (locked) {
-    mutex_.unlock();
+  for (auto& shard : shards_) {
+    bool locked = shard->mutex_.tryLock();
+    if (!locked) {
+      return true;
+    }
+    shard->mutex_.unlock();
   }
-  return !locked;
+  return false;
 }
 
 Counter* AllocatorImpl::makeCounterInternal(StatName name, StatName tag_extracted_name,
-                                            const StatNameTagVector& stat_name_tags) {
-  return new CounterImpl(name, *this, tag_extracted_name, stat_name_tags);
+                                            const StatNameTagVector& stat_name_tags,
+                                            uint16_t shard_index) {
+  return new CounterImpl(name, *this, tag_extracted_name, stat_name_tags, shard_index);
 }
 
 } // namespace Stats
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "envoy/stats/allocator.h"
@@ -19,7 +20,14 @@ class AllocatorImpl : public Allocator {
 public:
   static const char DecrementToZeroSyncPoint[];
 
-  AllocatorImpl(SymbolTable& symbol_table) : symbol_table_(symbol_table) {}
+  /**
+   * @param symbol_table the symbol table for the stat names.
+   * @param num_shards the number of independently locked partitions of the stat sets. Stats are
+   *        assigned to a shard by the hash of their name, so that threads allocating and freeing
+   *        stats with different names, e.g. while creating and destroying scopes, rarely contend
+   *        on the same mutex. Must be between 1 and MaxShards.
+   */
+  AllocatorImpl(SymbolTable& symbol_table, uint32_t num_shards = 1);
   ~AllocatorImpl() override;
 
   // Allocator
@@ -43,13 +51,22 @@ public:
   Thread::ThreadSynchronizer& sync() { return sync_; }
 
   /**
-   * @return whether the allocator's mutex is locked, exposed for testing purposes.
+   * @return whether any of the allocator's mutexes is locked, exposed for testing purposes.
    */
   bool isMutexLockedForTest();
 
+  /**
+   * @return the number of shards the stat sets are partitioned into.
+   */
+  uint32_t numShards() const { return shards_.size(); }
+
+  // The shard index is stored in 16 bits of each stat.
+  static constexpr uint32_t MaxShards = 1 << 16;
+
 protected:
   virtual Counter* makeCounterInternal(StatName name, StatName tag_extracted_name,
-                                       const StatNameTagVector& stat_name_tags);
+                                       const StatNameTagVector& stat_name_tags,
+                                       uint16_t shard_index);
 
 private:
   template <class BaseClass> friend class StatsSharedImpl;
@@ -58,21 +75,25 @@ private:
   friend class TextReadoutImpl;
   friend class NotifyingAllocatorImpl;
 
-  void removeCounterFromSetLockHeld(Counter* counter) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
-  void removeGaugeFromSetLockHeld(Gauge* gauge) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
-  void removeTextReadoutFromSetLockHeld(Counter* counter) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  struct Shard {
+    // A mutex is needed here to protect the stat sets from both alloc() and
+    // free() operations. Although alloc() operations are called under existing
+    // locking, free() operations are made from the destructors of the
+    // individual stat objects, which are not protected by locks.
+    Thread::MutexBasicLockable mutex_;
+
+    StatSet<Counter> counters_ ABSL_GUARDED_BY(mutex_);
+    StatSet<Gauge> gauges_ ABSL_GUARDED_BY(mutex_);
+    StatSet<TextReadout> text_readouts_ ABSL_GUARDED_BY(mutex_);
+  };
 
-  StatSet<Counter> counters_ ABSL_GUARDED_BY(mutex_);
-  StatSet<Gauge> gauges_ ABSL_GUARDED_BY(mutex_);
-  StatSet<TextReadout> text_readouts_ ABSL_GUARDED_BY(mutex_);
+  uint16_t shardIndex(StatName name) const;
+  Shard& shard(uint16_t index) { return *shards_[index]; }
 
   SymbolTable& symbol_table_;
 
-  // A mutex is needed here to protect both the stats_ object from both
-  // alloc() and free() operations. Although alloc() operations are called under existing locking,
-  // free() operations are made from the destructors of the individual stat objects, which are not
-  // protected by locks.
-  Thread::MutexBasicLockable mutex_;
+  // Shards are held by pointer as their mutexes cannot be moved.
+  std::vector<std::unique_ptr<Shard>> shards_;
 
   Thread::ThreadSynchronizer sync_;
 };
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "common/common/assert.h"
+
+#include "circllhist.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * A histogram with a fixed set of log-linear buckets, in the style of HdrHistogram: values below
+ * 2^SubBucketBits get one bucket each, and every power of two above that is split into
+ * 2^SubBucketBits equally sized buckets, bounding the relative error to 2^-SubBucketBits. Values
+ * of 2^(MaxExponent + 1) and above are clamped into the last bucket.
+ *
+ * It is designed for a single writer thread and a single reader thread: the writer increments
+ * atomic counters without read-modify-write instructions, and the reader periodically collects
+ * the counts added since its previous collection without any locking or buffer swapping.
+ *
+ * Each instance holds two arrays of NumBuckets (592) 32-bit counters, about 4.6 KiB, and every
+ * collection scans all of them regardless of how many values were recorded.
+ */
+class FixedBucketHistogram {
+public:
+  static constexpr uint32_t SubBucketBits = 4;
+  static constexpr uint32_t SubBuckets = 1 << SubBucketBits;
+  static constexpr uint32_t MaxExponent = 39;
+  static constexpr uint32_t NumBuckets = (MaxExponent - SubBucketBits + 2) * SubBuckets;
+
+  using Counts = std::array<uint64_t, NumBuckets>;
+
+  FixedBucketHistogram() {
+    for (auto& count : counts_) {
+      count.store(0, std::memory_order_relaxed);
+    }
+    collected_.fill(0);
+  }
+
+  /**
+   * @return the bucket index for a value.
+   */
+  static uint32_t bucketIndex(uint64_t value) {
+    if (value < SubBuckets) {
+      return value;
+    }
+    const uint32_t exponent = log2Floor(value);
+    if (exponent > MaxExponent) {
+      return NumBuckets - 1;
+    }
+    const uint32_t shift = exponent - SubBucketBits;
+    return (shift + 1) * SubBuckets + ((value >> shift) & (SubBuckets - 1));
+  }
+
+  /**
+   * @return the smallest value that falls into a bucket.
+   */
+  static uint64_t bucketLowerBound(uint32_t index) {
+    ASSERT(index < NumBuckets);
+    if (index < SubBuckets) {
+      return index;
+    }
+    const uint32_t shift = index / SubBuckets - 1;
+    return static_cast<uint64_t>(SubBuckets + index % SubBuckets) << shift;
+  }
+
+  /**
+   * @return the value used to represent every sample of a bucket, i.e. its midpoint.
+   */
+  static uint64_t bucketMidpoint(uint32_t index) {
+    const uint64_t lower = bucketLowerBound(index);
+    if (index < 2 * SubBuckets) {
+      return lower;
+    }
+    const uint32_t shift = index / SubBuckets - 1;
+    return lower + ((uint64_t(1) << shift) >> 1);
+  }
+
+  /**
+   * Records a value. Must only be called from the owning thread.
+   */
+  void recordValue(uint64_t value) {
+    std::atomic<uint32_t>& count = counts_[bucketIndex(value)];
+    // Single writer, so a plain load and store avoids a locked instruction on the hot path.
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Adds the counts recorded since the previous call to the totals. Must only be called from a
+   * single reader thread. Counters are 32 bits and wrap, which is harmless as long as fewer than
+   * 2^32 values land in one bucket between two collections.
+   */
+  void collect(Counts& totals) {
+    for (uint32_t i = 0; i < NumBuckets; ++i) {
+      const uint32_t current = counts_[i].load(std::memory_order_relaxed);
+      totals[i] += static_cast<uint32_t>(current - collected_[i]);
+      collected_[i] = current;
+    }
+  }
+
+  /**
+   * Inserts collected counts into a circllhist histogram so that statistics and sinks can consume
+   * them, and resets the counts.
+   */
+  static void insertInto(Counts& totals, histogram_t* target) {
+    for (uint32_t i = 0; i < NumBuckets; ++i) {
+      if (totals[i] != 0) {
+        hist_insert_intscale(target, bucketMidpoint(i), 0, totals[i]);
+        totals[i] = 0;
+      }
+    }
+  }
+
+private:
+  static uint32_t log2Floor(uint64_t value) {
+    uint32_t result = 0;
+    for (uint32_t shift = 32; shift > 0; shift >>= 1) {
+      if ((value >> shift) != 0) {
+        value >>= shift;
+        result += shift;
+      }
+    }
+    return result;
+  }
+
+  // Written by the owning thread only; read by the merging thread.
+  alignas(64) std::array<std::atomic<uint32_t>, NumBuckets> counts_;
+  // Owned by the merging thread. Kept on separate cache lines from counts_.
+  alignas(64) std::array<uint32_t, NumBuckets> collected_;
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -91,7 +91,11 @@ HistogramSettingsImpl::HistogramSettingsImpl(const envoy::config::metrics::v3::S
         }
 
         return configs;
-      }()) {}
+      }()),
+      backend_(config.histogram_backend() ==
+                       envoy::config::metrics::v3::StatsConfig::FIXED_BUCKETS
+                   ? HistogramBackend::FixedBuckets
+                   : HistogramBackend::Circllhist) {}
 
 const ConstSupportedBuckets& HistogramSettingsImpl::buckets(absl::string_view stat_name) const {
   for (const auto& config : configs_) {
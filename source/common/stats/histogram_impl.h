@@ -24,12 +24,14 @@ public:
 
   // HistogramSettings
   const ConstSupportedBuckets& buckets(absl::string_view stat_name) const override;
+  HistogramBackend backend() const override { return backend_; }
 
   static ConstSupportedBuckets& defaultBuckets();
 
 private:
   using Config = std::pair<Matchers::StringMatcherImpl, ConstSupportedBuckets>;
   const std::vector<Config> configs_{};
+  const HistogramBackend backend_{HistogramBackend::Circllhist};
 };
 
 /**
@@ -619,7 +619,8 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromStatNameWithTags(
       } else {
         stat = new ParentHistogramImpl(final_stat_name, unit, parent_,
                                        tag_helper.tagExtractedName(), tag_helper.statNameTags(),
-                                       *buckets, parent_.next_histogram_id_++);
+                                       *buckets, parent_.histogram_settings_->backend(),
+                                       parent_.next_histogram_id_++);
         if (!parent_.shutting_down_) {
           parent_.histogram_set_.insert(stat.get());
         }
@@ -713,9 +714,9 @@ Histogram& ThreadLocalStoreImpl::tlsHistogram(ParentHistogramImpl& parent, uint6
 
   StatNameTagHelper tag_helper(*this, parent.statName(), absl::nullopt);
 
-  TlsHistogramSharedPtr hist_tls_ptr(
-      new ThreadLocalHistogramImpl(parent.statName(), parent.unit(), tag_helper.tagExtractedName(),
-                                   tag_helper.statNameTags(), symbolTable()));
+  TlsHistogramSharedPtr hist_tls_ptr(new ThreadLocalHistogramImpl(
+      parent.statName(), parent.unit(), tag_helper.tagExtractedName(), tag_helper.statNameTags(),
+      symbolTable(), parent.backend()));
 
   parent.addTlsHistogram(hist_tls_ptr);
 
@@ -729,42 +730,70 @@ Histogram& ThreadLocalStoreImpl::tlsHistogram(ParentHistogramImpl& parent, uint6
 ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name, Histogram::Unit unit,
                                                    StatName tag_extracted_name,
                                                    const StatNameTagVector& stat_name_tags,
-                                                   SymbolTable& symbol_table)
+                                                   SymbolTable& symbol_table,
+                                                   HistogramBackend backend)
     : HistogramImplHelper(name, tag_extracted_name, stat_name_tags, symbol_table), unit_(unit),
-      current_active_(0), used_(false), created_thread_id_(std::this_thread::get_id()),
-      symbol_table_(symbol_table) {
-  histograms_[0] = hist_alloc();
-  histograms_[1] = hist_alloc();
+      current_active_(0), fixed_buckets_backend_(backend == HistogramBackend::FixedBuckets),
+      used_(false), created_thread_id_(std::this_thread::get_id()), symbol_table_(symbol_table) {
+  if (!fixed_buckets_backend_) {
+    histograms_[0] = hist_alloc();
+    histograms_[1] = hist_alloc();
+  }
 }
 
 ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
   MetricImpl::clear(symbol_table_);
-  hist_free(histograms_[0]);
-  hist_free(histograms_[1]);
+  if (fixed_buckets_backend_) {
+    delete fixed_buckets_.load(std::memory_order_acquire);
+  } else {
+    hist_free(histograms_[0]);
+    hist_free(histograms_[1]);
+  }
 }
 
 void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
   ASSERT(std::this_thread::get_id() == created_thread_id_);
-  hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  if (fixed_buckets_backend_) {
+    FixedBucketHistogram* fixed_buckets = fixed_buckets_.load(std::memory_order_relaxed);
+    if (fixed_buckets == nullptr) {
+      // Published with release semantics so that the merging thread sees initialized counters.
+      fixed_buckets = new FixedBucketHistogram();
+      fixed_buckets_.store(fixed_buckets, std::memory_order_release);
+    }
+    fixed_buckets->recordValue(value);
+  } else {
+    hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  }
   used_ = true;
 }
 
 void ThreadLocalHistogramImpl::merge(histogram_t* target) {
+  ASSERT(!fixed_buckets_backend_);
   histogram_t** other_histogram = &histograms_[otherHistogramIndex()];
   hist_accumulate(target, other_histogram, 1);
   hist_clear(*other_histogram);
 }
 
+void ThreadLocalHistogramImpl::merge(FixedBucketHistogram::Counts& totals) {
+  ASSERT(fixed_buckets_backend_);
+  FixedBucketHistogram* fixed_buckets = fixed_buckets_.load(std::memory_order_acquire);
+  if (fixed_buckets != nullptr) {
+    fixed_buckets->collect(totals);
+  }
+}
+
 ParentHistogramImpl::ParentHistogramImpl(StatName name, Histogram::Unit unit,
                                          ThreadLocalStoreImpl& thread_local_store,
                                          StatName tag_extracted_name,
                                          const StatNameTagVector& stat_name_tags,
-                                         ConstSupportedBuckets& supported_buckets, uint64_t id)
+                                         ConstSupportedBuckets& supported_buckets,
+                                         HistogramBackend backend, uint64_t id)
     : MetricImpl(name, tag_extracted_name, stat_name_tags, thread_local_store.symbolTable()),
       unit_(unit), thread_local_store_(thread_local_store), interval_histogram_(hist_alloc()),
       cumulative_histogram_(hist_alloc()),
       interval_statistics_(interval_histogram_, supported_buckets),
-      cumulative_statistics_(cumulative_histogram_, supported_buckets), merged_(false), id_(id) {}
+      cumulative_statistics_(cumulative_histogram_, supported_buckets), backend_(backend),
+      merged_(false), id_(id) {}
 
 ParentHistogramImpl::~ParentHistogramImpl() {
   thread_local_store_.releaseHistogramCrossThread(id_);
@@ -842,8 +871,21 @@ void ParentHistogramImpl::merge() {
     // then release the lock before we do the actual merge. However it is not a big deal
     // because the tls_histogram merge is not that expensive as it is a single histogram
     // merge and adding TLS histograms is rare.
-    for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
-      tls_histogram->merge(interval_histogram_);
+    if (backend_ == HistogramBackend::FixedBuckets) {
+      // Sum the buckets of all workers first so that only one insertion per non-empty bucket is
+      // needed to build the interval histogram.
+      if (fixed_bucket_totals_ == nullptr) {
+        fixed_bucket_totals_ = std::make_unique<FixedBucketHistogram::Counts>();
+        fixed_bucket_totals_->fill(0);
+      }
+      for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
+        tls_histogram->merge(*fixed_bucket_totals_);
+      }
+      FixedBucketHistogram::insertInto(*fixed_bucket_totals_, interval_histogram_);
+    } else {
+      for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
+        tls_histogram->merge(interval_histogram_);
+      }
     }
     // Since TLS merge is done, we can release the lock here.
     lock.release();
@@ -13,6 +13,7 @@
 #include "common/common/hash.h"
 #include "common/common/thread_synchronizer.h"
 #include "common/stats/allocator_impl.h"
+#include "common/stats/fixed_bucket_histogram.h"
 #include "common/stats/histogram_impl.h"
 #include "common/stats/null_counter.h"
 #include "common/stats/null_gauge.h"
@@ -30,23 +31,41 @@ namespace Stats {
 /**
  * A histogram that is stored in TLS and used to record values per thread. This holds two
  * histograms, one to collect the values and other as backup that is used for merge process. The
- * swap happens during the merge process.
+ * swap happens during the merge process. With the fixed buckets backend it instead holds a
+ * FixedBucketHistogram that the merge process reads directly, allocated when the first value is
+ * recorded so that histograms a worker never records into cost no bucket memory.
  */
 class ThreadLocalHistogramImpl : public HistogramImplHelper {
 public:
   ThreadLocalHistogramImpl(StatName name, Histogram::Unit unit, StatName tag_extracted_name,
-                           const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table);
+                           const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table,
+                           HistogramBackend backend = HistogramBackend::Circllhist);
   ~ThreadLocalHistogramImpl() override;
 
+  /**
+   * Merges the values recorded before the last beginMerge() into target. Only valid for the
+   * circllhist backend.
+   */
   void merge(histogram_t* target);
 
+  /**
+   * Adds the bucket counts recorded since the previous merge to totals. Only valid for the fixed
+   * buckets backend.
+   */
+  void merge(FixedBucketHistogram::Counts& totals);
+
   /**
    * Called in the beginning of merge process. Swaps the histogram used for collection so that we do
-   * not have to lock the histogram in high throughput TLS writes.
+   * not have to lock the histogram in high throughput TLS writes. The merge process still calls it
+   * on every worker for the fixed buckets backend, where it does nothing, as the backend of
+   * existing histograms is kept when the histogram settings change.
    */
   void beginMerge() {
-    // This switches the current_active_ between 1 and 0.
     ASSERT(std::this_thread::get_id() == created_thread_id_);
+    if (fixed_buckets_backend_) {
+      return;
+    }
+    // This switches the current_active_ between 1 and 0.
     current_active_ = otherHistogramIndex();
   }
 
@@ -66,7 +85,10 @@ private:
   Histogram::Unit unit_;
   uint64_t otherHistogramIndex() const { return 1 - current_active_; }
   uint64_t current_active_;
-  histogram_t* histograms_[2];
+  histogram_t* histograms_[2]{};
+  const bool fixed_buckets_backend_;
+  // Allocated by the owning thread on the first recorded value and read by the merging thread.
+  std::atomic<FixedBucketHistogram*> fixed_buckets_{nullptr};
   std::atomic<bool> used_;
   std::thread::id created_thread_id_;
   SymbolTable& symbol_table_;
@@ -83,9 +105,12 @@ class ParentHistogramImpl : public MetricImpl<ParentHistogram> {
 public:
   ParentHistogramImpl(StatName name, Histogram::Unit unit, ThreadLocalStoreImpl& parent,
                       StatName tag_extracted_name, const StatNameTagVector& stat_name_tags,
-                      ConstSupportedBuckets& supported_buckets, uint64_t id);
+                      ConstSupportedBuckets& supported_buckets, HistogramBackend backend,
+                      uint64_t id);
   ~ParentHistogramImpl() override;
 
+  HistogramBackend backend() const { return backend_; }
+
   void addTlsHistogram(const TlsHistogramSharedPtr& hist_ptr);
 
   // Stats::Histogram
@@ -129,6 +154,10 @@ private:
   histogram_t* cumulative_histogram_;
   HistogramStatisticsImpl interval_statistics_;
   HistogramStatisticsImpl cumulative_statistics_;
+  const HistogramBackend backend_;
+  // Scratch space for summing the worker buckets of the fixed buckets backend, allocated on the
+  // first merge of recorded values.
+  std::unique_ptr<FixedBucketHistogram::Counts> fixed_bucket_totals_;
   mutable Thread::MutexBasicLockable merge_lock_;
   std::list<TlsHistogramSharedPtr> tls_histograms_ ABSL_GUARDED_BY(merge_lock_);
   bool merged_;
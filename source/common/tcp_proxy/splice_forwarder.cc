@@ -0,0 +1,157 @@
+#include "common/tcp_proxy/splice_forwarder.h"
+
+#include "envoy/common/platform.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/common/utility.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+
+#include "common/api/os_sys_calls_impl_linux.h"
+#endif
+
+namespace Envoy {
+namespace TcpProxy {
+
+SpliceForwarder::SpliceForwarder(Callbacks& callbacks) : callbacks_(callbacks) {}
+
+SpliceForwarder::~SpliceForwarder() {
+  // Remove the file events before closing the pipes.
+  downstream_event_.reset();
+  upstream_event_.reset();
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  for (Direction* direction : {&downstream_to_upstream_, &upstream_to_downstream_}) {
+    if (direction->pipe_read_ != -1) {
+      os_sys_calls.close(direction->pipe_read_);
+    }
+    if (direction->pipe_write_ != -1) {
+      os_sys_calls.close(direction->pipe_write_);
+    }
+  }
+}
+
+SpliceForwarderPtr SpliceForwarder::create(Event::Dispatcher& dispatcher,
+                                           Network::IoHandle& downstream,
+                                           Network::IoHandle& upstream, Callbacks& callbacks) {
+#if defined(__linux__)
+  SpliceForwarderPtr forwarder(new SpliceForwarder(callbacks));
+  forwarder->downstream_to_upstream_.source_ = &downstream;
+  forwarder->downstream_to_upstream_.destination_ = &upstream;
+  forwarder->downstream_to_upstream_.downstream_to_upstream_ = true;
+  forwarder->upstream_to_downstream_.source_ = &upstream;
+  forwarder->upstream_to_downstream_.destination_ = &downstream;
+
+  auto& os_sys_calls = Api::LinuxOsSysCallsSingleton::get();
+  for (Direction* direction :
+       {&forwarder->downstream_to_upstream_, &forwarder->upstream_to_downstream_}) {
+    int fds[2];
+    const Api::SysCallIntResult result = os_sys_calls.pipe2(fds, O_NONBLOCK | O_CLOEXEC);
+    if (result.rc_ != 0) {
+      ENVOY_LOG(debug, "splice: unable to create pipe: {}", errorDetails(result.errno_));
+      return nullptr;
+    }
+    direction->pipe_read_ = fds[0];
+    direction->pipe_write_ = fds[1];
+  }
+
+  forwarder->initialize(dispatcher);
+  return forwarder;
+#else
+  UNREFERENCED_PARAMETER(dispatcher);
+  UNREFERENCED_PARAMETER(downstream);
+  UNREFERENCED_PARAMETER(upstream);
+  UNREFERENCED_PARAMETER(callbacks);
+  return nullptr;
+#endif
+}
+
+void SpliceForwarder::initialize(Event::Dispatcher& dispatcher) {
+  // Each socket's event serves both directions: it is readable for one and writable for the other.
+  downstream_event_ = dispatcher.createFileEvent(
+      downstream_to_upstream_.source_->fdDoNotUse(), [this](uint32_t) { onFileEvent(); },
+      Event::PlatformDefaultTriggerType, Event::FileReadyType::Read | Event::FileReadyType::Write);
+  upstream_event_ = dispatcher.createFileEvent(
+      upstream_to_downstream_.source_->fdDoNotUse(), [this](uint32_t) { onFileEvent(); },
+      Event::PlatformDefaultTriggerType, Event::FileReadyType::Read | Event::FileReadyType::Write);
+  // Data may already be waiting in the kernel from before the events were registered.
+  downstream_event_->activate(Event::FileReadyType::Read);
+}
+
+void SpliceForwarder::onFileEvent() {
+  const PumpResult to_upstream = pump(downstream_to_upstream_);
+  const PumpResult to_downstream =
+      to_upstream == PumpResult::Error ? PumpResult::Error : pump(upstream_to_downstream_);
+
+  if (to_upstream == PumpResult::Error || to_downstream == PumpResult::Error) {
+    callbacks_.onSpliceComplete(true);
+    return;
+  }
+  if (to_upstream == PumpResult::Done && to_downstream == PumpResult::Done) {
+    callbacks_.onSpliceComplete(false);
+    return;
+  }
+  if (to_upstream == PumpResult::Yield || to_downstream == PumpResult::Yield) {
+    // Continue on the next iteration of the event loop.
+    downstream_event_->activate(Event::FileReadyType::Read);
+  }
+}
+
+SpliceForwarder::PumpResult SpliceForwarder::pump(Direction& direction) {
+#if defined(__linux__)
+  auto& os_sys_calls = Api::LinuxOsSysCallsSingleton::get();
+  uint32_t chunks = 0;
+  while (true) {
+    // Drain the pipe before reading more, so that EAGAIN on a read means the socket is empty.
+    if (direction.buffered_ > 0) {
+      const Api::SysCallSizeResult result =
+          os_sys_calls.splice(direction.pipe_read_, nullptr, direction.destination_->fdDoNotUse(),
+                              nullptr, direction.buffered_, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      if (result.rc_ < 0) {
+        if (result.errno_ == SOCKET_ERROR_AGAIN) {
+          return PumpResult::Blocked;
+        }
+        ENVOY_LOG(debug, "splice: write failed: {}", errorDetails(result.errno_));
+        return PumpResult::Error;
+      }
+      ASSERT(static_cast<uint64_t>(result.rc_) <= direction.buffered_);
+      direction.buffered_ -= result.rc_;
+      callbacks_.onSplicedBytes(direction.downstream_to_upstream_, result.rc_);
+      continue;
+    }
+
+    if (direction.end_stream_) {
+      if (!direction.shutdown_) {
+        direction.shutdown_ = true;
+        direction.destination_->shutdown(ENVOY_SHUT_WR);
+      }
+      return PumpResult::Done;
+    }
+
+    if (chunks++ == MaxChunksPerEvent) {
+      return PumpResult::Yield;
+    }
+    const Api::SysCallSizeResult result =
+        os_sys_calls.splice(direction.source_->fdDoNotUse(), nullptr, direction.pipe_write_,
+                            nullptr, ChunkSize, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (result.rc_ < 0) {
+      if (result.errno_ == SOCKET_ERROR_AGAIN) {
+        return PumpResult::Blocked;
+      }
+      ENVOY_LOG(debug, "splice: read failed: {}", errorDetails(result.errno_));
+      return PumpResult::Error;
+    }
+    if (result.rc_ == 0) {
+      direction.end_stream_ = true;
+    }
+    direction.buffered_ += result.rc_;
+  }
+#else
+  UNREFERENCED_PARAMETER(direction);
+  NOT_REACHED_GCOVR_EXCL_LINE;
+#endif
+}
+
+} // namespace TcpProxy
+} // namespace Envoy
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/pure.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/file_event.h"
+#include "envoy/network/io_handle.h"
+
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace TcpProxy {
+
+class SpliceForwarder;
+using SpliceForwarderPtr = std::unique_ptr<SpliceForwarder>;
+
+/**
+ * Moves data in both directions between two sockets inside the kernel, using splice(2) through a
+ * pipe per direction, so that proxied bytes are never copied to user space. End of stream on one
+ * socket is propagated as a write shutdown of the other.
+ *
+ * The sockets stay owned by their connections, which must be read disabled and must not write
+ * while data is being spliced. The forwarder must be destroyed before either connection is
+ * closed.
+ */
+class SpliceForwarder : Logger::Loggable<Logger::Id::filter> {
+public:
+  class Callbacks {
+  public:
+    virtual ~Callbacks() = default;
+
+    /**
+     * Called when bytes have been written to one of the sockets.
+     * @param downstream_to_upstream whether the bytes were received from the downstream socket.
+     * @param bytes the number of bytes written.
+     */
+    virtual void onSplicedBytes(bool downstream_to_upstream, uint64_t bytes) PURE;
+
+    /**
+     * Called when both directions have ended, or when an error occurred on either socket. The
+     * forwarder may be destroyed from within this callback.
+     * @param error whether the forwarding stopped because of an error.
+     */
+    virtual void onSpliceComplete(bool error) PURE;
+  };
+
+  ~SpliceForwarder();
+
+  /**
+   * @return a forwarder moving data between the sockets, or nullptr if splicing is not supported
+   *         on this platform or its pipes could not be created.
+   */
+  static SpliceForwarderPtr create(Event::Dispatcher& dispatcher, Network::IoHandle& downstream,
+                                   Network::IoHandle& upstream, Callbacks& callbacks);
+
+  // The maximum number of bytes moved into a pipe by one splice(2) call.
+  static constexpr uint32_t ChunkSize = 64 * 1024;
+  // The maximum number of chunks read from a socket before yielding to other events, so that one
+  // busy connection cannot starve the others on the same worker.
+  static constexpr uint32_t MaxChunksPerEvent = 16;
+
+private:
+  struct Direction {
+    Network::IoHandle* source_{};
+    Network::IoHandle* destination_{};
+    bool downstream_to_upstream_{};
+    int pipe_read_{-1};
+    int pipe_write_{-1};
+    // Bytes spliced into the pipe and not yet out of it.
+    uint64_t buffered_{};
+    bool end_stream_{};
+    bool shutdown_{};
+  };
+
+  enum class PumpResult { Blocked, Yield, Done, Error };
+
+  SpliceForwarder(Callbacks& callbacks);
+
+  void initialize(Event::Dispatcher& dispatcher);
+  void onFileEvent();
+  PumpResult pump(Direction& direction);
+
+  Callbacks& callbacks_;
+  Direction downstream_to_upstream_;
+  Direction upstream_to_downstream_;
+  Event::FileEventPtr downstream_event_;
+  Event::FileEventPtr upstream_event_;
+};
+
+} // namespace TcpProxy
+} // namespace Envoy
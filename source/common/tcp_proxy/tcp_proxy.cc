@@ -128,7 +128,7 @@ Config::Config(const envoy::extensions::filters::network::tcp_proxy::v3::TcpProx
     : max_connect_attempts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_connect_attempts, 1)),
       upstream_drain_manager_slot_(context.threadLocal().allocateSlot()),
       shared_config_(std::make_shared<SharedConfig>(config, context)),
-      random_generator_(context.api().randomGenerator()) {
+      random_generator_(context.api().randomGenerator()), use_splice_(config.use_splice()) {
 
   upstream_drain_manager_slot_->set([](Event::Dispatcher&) {
     ThreadLocal::ThreadLocalObjectSharedPtr drain_manager =
@@ -515,6 +515,58 @@ void Filter::onGenericPoolReady(StreamInfo::StreamInfo* info,
   if (info) {
     read_callbacks_->connection().streamInfo().setUpstreamFilterState(info->filterState());
   }
+  if (config_->useSplice()) {
+    maybeStartSplice();
+  }
+}
+
+void Filter::maybeStartSplice() {
+  Network::Connection& downstream_connection = read_callbacks_->connection();
+  Network::Connection* upstream_connection = upstream_ ? upstream_->connection() : nullptr;
+  // Either connection may be unable to hand over its socket, e.g. because it uses TLS, or still
+  // holds data buffered before the upstream connection was established.
+  Network::IoHandle* downstream_handle = downstream_connection.spliceableIoHandle();
+  Network::IoHandle* upstream_handle =
+      upstream_connection ? upstream_connection->spliceableIoHandle() : nullptr;
+  if (downstream_handle == nullptr || upstream_handle == nullptr) {
+    ENVOY_CONN_LOG(debug, "splice: unsupported by the connections, proxying through buffers",
+                   downstream_connection);
+    return;
+  }
+
+  splice_forwarder_ = SpliceForwarder::create(downstream_connection.dispatcher(),
+                                              *downstream_handle, *upstream_handle, *this);
+  if (splice_forwarder_ == nullptr) {
+    return;
+  }
+  ENVOY_CONN_LOG(debug, "splice: forwarding data in the kernel", downstream_connection);
+  config_->stats().downstream_cx_splice_total_.inc();
+  // The forwarder reads from both sockets from now on.
+  downstream_connection.readDisable(true);
+  upstream_connection->readDisable(true);
+}
+
+void Filter::onSplicedBytes(bool downstream_to_upstream, uint64_t bytes) {
+  Upstream::ClusterStats& cluster_stats = read_callbacks_->upstreamHost()->cluster().stats();
+  if (downstream_to_upstream) {
+    config_->stats().downstream_cx_rx_bytes_total_.add(bytes);
+    cluster_stats.upstream_cx_tx_bytes_total_.add(bytes);
+    getStreamInfo().addBytesReceived(bytes);
+  } else {
+    config_->stats().downstream_cx_tx_bytes_total_.add(bytes);
+    cluster_stats.upstream_cx_rx_bytes_total_.add(bytes);
+    getStreamInfo().addBytesSent(bytes);
+  }
+  resetIdleTimer();
+}
+
+void Filter::onSpliceComplete(bool error) {
+  ENVOY_CONN_LOG(debug, "splice: {}", read_callbacks_->connection(),
+                 error ? "socket error" : "both directions ended");
+  splice_forwarder_.reset();
+  // This also closes the upstream connection.
+  read_callbacks_->connection().close(error ? Network::ConnectionCloseType::NoFlush
+                                            : Network::ConnectionCloseType::FlushWrite);
 }
 
 const Router::MetadataMatchCriteria* Filter::metadataMatchCriteria() {
@@ -570,6 +622,9 @@ Network::FilterStatus Filter::onNewConnection() {
 }
 
 void Filter::onDownstreamEvent(Network::ConnectionEvent event) {
+  if (event != Network::ConnectionEvent::Connected) {
+    splice_forwarder_.reset();
+  }
   if (upstream_) {
     Tcp::ConnectionPool::ConnectionDataPtr conn_data(upstream_->onDownstreamEvent(event));
     if (conn_data != nullptr &&
@@ -608,6 +663,7 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
 
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
+    splice_forwarder_.reset();
     upstream_.reset();
     disableIdleTimer();
 
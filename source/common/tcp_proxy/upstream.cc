@@ -55,6 +55,10 @@ TcpUpstream::onDownstreamEvent(Network::ConnectionEvent event) {
   return nullptr;
 }
 
+Network::Connection* TcpUpstream::connection() {
+  return upstream_conn_data_ == nullptr ? nullptr : &upstream_conn_data_->connection();
+}
+
 HttpUpstream::HttpUpstream(Tcp::ConnectionPool::UpstreamCallbacks& callbacks,
                            const std::string& hostname)
     : hostname_(hostname), response_decoder_(*this), upstream_callbacks_(callbacks) {}
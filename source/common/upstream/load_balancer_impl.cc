@@ -1,5 +1,6 @@
 #include "common/upstream/load_balancer_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -843,6 +844,42 @@ HostConstSharedPtr EdfLoadBalancerBase::chooseHostOnce(LoadBalancerContext* cont
   }
 }
 
+LeastRequestLoadBalancer::ActiveRequests&
+LeastRequestLoadBalancer::activeRequests(const HostsSource& source) {
+  ASSERT(source.priority_ < active_requests_.size());
+  PriorityActiveRequests& priority_active_requests = active_requests_[source.priority_];
+  switch (source.source_type_) {
+  case HostsSource::SourceType::AllHosts:
+    return priority_active_requests.all_hosts_;
+  case HostsSource::SourceType::HealthyHosts:
+    return priority_active_requests.healthy_hosts_;
+  case HostsSource::SourceType::DegradedHosts:
+    return priority_active_requests.degraded_hosts_;
+  case HostsSource::SourceType::LocalityHealthyHosts:
+    ASSERT(source.locality_index_ < priority_active_requests.healthy_hosts_per_locality_.size());
+    return priority_active_requests.healthy_hosts_per_locality_[source.locality_index_];
+  case HostsSource::SourceType::LocalityDegradedHosts:
+    ASSERT(source.locality_index_ < priority_active_requests.degraded_hosts_per_locality_.size());
+    return priority_active_requests.degraded_hosts_per_locality_[source.locality_index_];
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+}
+
+void LeastRequestLoadBalancer::buildActiveRequests(ActiveRequests& active_requests,
+                                                   const HostVector& hosts) {
+  active_requests.hosts_ = &hosts;
+  active_requests.gauges_.clear();
+  active_requests.gauges_.reserve(hosts.size());
+  for (const auto& host : hosts) {
+    active_requests.gauges_.push_back(&host->stats().rq_active_);
+  }
+}
+
+void LeastRequestLoadBalancer::refreshHostSource(const HostsSource& source) {
+  buildActiveRequests(activeRequests(source), hostSourceToHosts(source));
+}
+
 HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPeek(const HostVector&,
                                                                 const HostsSource&) {
   // LeastRequestLoadBalancer can not do deterministic preconnecting, because
@@ -852,26 +889,30 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPeek(const HostVector
 }
 
 HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector& hosts_to_use,
-                                                                const HostsSource&) {
-  HostSharedPtr candidate_host = nullptr;
+                                                                const HostsSource& source) {
+  ActiveRequests& active_requests = activeRequests(source);
+  if (active_requests.hosts_ != &hosts_to_use) {
+    // The gauges are rebuilt whenever the hosts of the source are replaced, so this only happens
+    // if a host set changes its hosts without running the priority update callbacks. The gauges
+    // of the hosts of another vector must never be read, as they may be gone.
+    buildActiveRequests(active_requests, hosts_to_use);
+  }
+  ASSERT(active_requests.gauges_.size() == hosts_to_use.size());
+
+  // The sampled gauges are all loaded before they are compared, so that their cache misses overlap
+  // rather than being taken one after the other, and the minimum is then selected from the loaded
+  // counts. The first choice wins ties, and only the host of the winner is copied.
+  absl::FixedArray<uint64_t, 8> sampled_idx(choice_count_);
+  absl::FixedArray<uint64_t, 8> sampled_active_rq(choice_count_);
   for (uint32_t choice_idx = 0; choice_idx < choice_count_; ++choice_idx) {
-    const int rand_idx = random_.random() % hosts_to_use.size();
-    HostSharedPtr sampled_host = hosts_to_use[rand_idx];
-
-    if (candidate_host == nullptr) {
-      // Make a first choice to start the comparisons.
-      candidate_host = sampled_host;
-      continue;
-    }
-
-    const auto candidate_active_rq = candidate_host->stats().rq_active_.value();
-    const auto sampled_active_rq = sampled_host->stats().rq_active_.value();
-    if (sampled_active_rq < candidate_active_rq) {
-      candidate_host = sampled_host;
-    }
+    sampled_idx[choice_idx] = random_.random() % hosts_to_use.size();
+  }
+  for (uint32_t choice_idx = 0; choice_idx < choice_count_; ++choice_idx) {
+    sampled_active_rq[choice_idx] = active_requests.gauges_[sampled_idx[choice_idx]]->value();
   }
+  const auto candidate = std::min_element(sampled_active_rq.begin(), sampled_active_rq.end());
 
-  return candidate_host;
+  return hosts_to_use[sampled_idx[candidate - sampled_active_rq.begin()]];
 }
 
 HostConstSharedPtr RandomLoadBalancer::peekAnotherHost(LoadBalancerContext* context) {
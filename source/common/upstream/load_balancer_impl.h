@@ -514,11 +514,43 @@ protected:
       active_request_bias_ = 1.0;
     }
 
+    // The arrays of the host sources of the priority are rebuilt from scratch, so that none is left
+    // for a locality which no longer exists.
+    if (active_requests_.size() <= priority) {
+      active_requests_.resize(priority + 1);
+    }
+    const HostSet& host_set = *priority_set_.hostSetsPerPriority()[priority];
+    active_requests_[priority] = PriorityActiveRequests{};
+    active_requests_[priority].healthy_hosts_per_locality_.resize(
+        host_set.healthyHostsPerLocality().get().size());
+    active_requests_[priority].degraded_hosts_per_locality_.resize(
+        host_set.degradedHostsPerLocality().get().size());
+
     EdfLoadBalancerBase::refresh(priority);
   }
 
 private:
-  void refreshHostSource(const HostsSource&) override {}
+  // The active request gauges of the hosts of a host source, in the same order as the hosts, so
+  // that unweightedHostPick() samples them without going through each host, and its reference
+  // count, to its stats.
+  struct ActiveRequests {
+    // The hosts the gauges were taken from. The gauges are only used for this very vector of hosts.
+    const HostVector* hosts_{};
+    std::vector<const Stats::PrimitiveGauge*> gauges_;
+  };
+
+  // The active request gauges of the host sources of a priority, indexed like the host sources.
+  struct PriorityActiveRequests {
+    ActiveRequests all_hosts_;
+    ActiveRequests healthy_hosts_;
+    ActiveRequests degraded_hosts_;
+    std::vector<ActiveRequests> healthy_hosts_per_locality_;
+    std::vector<ActiveRequests> degraded_hosts_per_locality_;
+  };
+
+  ActiveRequests& activeRequests(const HostsSource& source);
+  static void buildActiveRequests(ActiveRequests& active_requests, const HostVector& hosts);
+  void refreshHostSource(const HostsSource& source) override;
   double hostWeight(const Host& host) override {
     // This method is called to calculate the dynamic weight as following when all load balancing
     // weights are not equal:
@@ -561,6 +593,9 @@ private:
   double active_request_bias_{};
 
   const std::unique_ptr<Runtime::Double> active_request_bias_runtime_;
+
+  // Indexed by priority. Rebuilt along with the host sources whenever a host set is updated.
+  std::vector<PriorityActiveRequests> active_requests_;
 };
 
 /**
@@ -7,8 +7,8 @@ namespace Upstream {
 
 MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                          double max_normalized_weight, uint64_t table_size,
-                         bool use_hostname_for_hashing, MaglevLoadBalancerStats& stats)
-    : table_size_(table_size), stats_(stats) {
+                         bool use_hostname_for_hashing)
+    : table_size_(table_size) {
   // We can't do anything sensible with no hosts.
   if (normalized_host_weights.empty()) {
     return;
@@ -17,17 +17,19 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
   // Implementation of pseudocode listing 1 in the paper (see header file for more info).
   std::vector<TableBuildEntry> table_build_entries;
   table_build_entries.reserve(normalized_host_weights.size());
+  hosts_.reserve(normalized_host_weights.size());
   for (const auto& host_weight : normalized_host_weights) {
     const auto& host = host_weight.first;
     const std::string& address =
         use_hostname_for_hashing ? host->hostname() : host->address()->asString();
     ASSERT(!address.empty());
-    table_build_entries.emplace_back(host, HashUtil::xxHash64(address) % table_size_,
+    table_build_entries.emplace_back(HashUtil::xxHash64(address) % table_size_,
                                      (HashUtil::xxHash64(address, 1) % (table_size_ - 1)) + 1,
                                      host_weight.second);
+    hosts_.push_back(host);
   }
 
-  table_.resize(table_size_);
+  table_.assign(table_size_, UnassignedEntry);
 
   // Iterate through the table build entries as many times as it takes to fill up the table.
   uint64_t table_index = 0;
@@ -43,32 +45,29 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
       }
       entry.target_weight_ += max_normalized_weight;
       uint64_t c = permutation(entry);
-      while (table_[c] != nullptr) {
+      while (table_[c] != UnassignedEntry) {
         entry.next_++;
         c = permutation(entry);
       }
 
-      table_[c] = entry.host_;
+      table_[c] = i;
       entry.next_++;
       entry.count_++;
       table_index++;
     }
   }
 
-  uint64_t min_entries_per_host = table_size_;
-  uint64_t max_entries_per_host = 0;
+  min_entries_per_host_ = table_size_;
   for (const auto& entry : table_build_entries) {
-    min_entries_per_host = std::min(entry.count_, min_entries_per_host);
-    max_entries_per_host = std::max(entry.count_, max_entries_per_host);
+    min_entries_per_host_ = std::min(entry.count_, min_entries_per_host_);
+    max_entries_per_host_ = std::max(entry.count_, max_entries_per_host_);
   }
-  stats_.min_entries_per_host_.set(min_entries_per_host);
-  stats_.max_entries_per_host_.set(max_entries_per_host);
 
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
     for (uint64_t i = 0; i < table_.size(); i++) {
+      const HostConstSharedPtr& host = hosts_[table_[i]];
       ENVOY_LOG(trace, "maglev: i={} host={}", i,
-                use_hostname_for_hashing ? table_[i]->hostname()
-                                         : table_[i]->address()->asString());
+                use_hostname_for_hashing ? host->hostname() : host->address()->asString());
     }
   }
 }
@@ -85,7 +84,7 @@ HostConstSharedPtr MaglevTable::chooseHost(uint64_t hash, uint32_t attempt) cons
     hash ^= ~0ULL - attempt + 1;
   }
 
-  return table_[hash % table_size_];
+  return hosts_[table_[hash % table_size_]];
 }
 
 uint64_t MaglevTable::permutation(const TableBuildEntry& entry) {
@@ -115,6 +114,50 @@ MaglevLoadBalancer::MaglevLoadBalancer(
   }
 }
 
+ThreadAwareLoadBalancerBase::HashingLoadBalancerSharedPtr
+MaglevLoadBalancer::createLoadBalancer(uint32_t priority,
+                                       const NormalizedHostWeightVector& normalized_host_weights,
+                                       double /* min_normalized_weight */,
+                                       double max_normalized_weight) {
+  auto table = std::make_shared<MaglevTable>(normalized_host_weights, max_normalized_weight,
+                                             table_size_, use_hostname_for_hashing_);
+
+  // Only the tables of the priorities which changed are rebuilt, so the stats are aggregated
+  // across the last tables built for all the priorities.
+  if (entries_per_host_.size() <= priority) {
+    entries_per_host_.resize(priority + 1);
+  }
+  if (normalized_host_weights.empty()) {
+    entries_per_host_[priority].reset();
+  } else {
+    entries_per_host_[priority] =
+        EntriesPerHost{table->minEntriesPerHost(), table->maxEntriesPerHost()};
+  }
+  absl::optional<EntriesPerHost> aggregate;
+  for (const auto& entries : entries_per_host_) {
+    if (!entries.has_value()) {
+      continue;
+    }
+    if (!aggregate.has_value()) {
+      aggregate = entries;
+      continue;
+    }
+    aggregate->min_ = std::min(aggregate->min_, entries->min_);
+    aggregate->max_ = std::max(aggregate->max_, entries->max_);
+  }
+  if (aggregate.has_value()) {
+    stats_.min_entries_per_host_.set(aggregate->min_);
+    stats_.max_entries_per_host_.set(aggregate->max_);
+  }
+
+  if (hash_balance_factor_ == 0) {
+    return table;
+  }
+
+  return std::make_shared<BoundedLoadHashingLoadBalancer>(table, normalized_host_weights,
+                                                          hash_balance_factor_);
+}
+
 MaglevLoadBalancerStats MaglevLoadBalancer::generateStats(Stats::Scope& scope) {
   return {ALL_MAGLEV_LOAD_BALANCER_STATS(POOL_GAUGE(scope))};
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <limits>
+
 #include "envoy/common/random_generator.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/stats/scope.h"
@@ -35,21 +37,24 @@ class MaglevTable : public ThreadAwareLoadBalancerBase::HashingLoadBalancer,
                     Logger::Loggable<Logger::Id::upstream> {
 public:
   MaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
-              double max_normalized_weight, uint64_t table_size, bool use_hostname_for_hashing,
-              MaglevLoadBalancerStats& stats);
+              double max_normalized_weight, uint64_t table_size, bool use_hostname_for_hashing);
 
   // ThreadAwareLoadBalancerBase::HashingLoadBalancer
   HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const override;
 
+  // The fewest and the most table entries assigned to a single host. Both are 0 if the table has
+  // no hosts.
+  uint64_t minEntriesPerHost() const { return min_entries_per_host_; }
+  uint64_t maxEntriesPerHost() const { return max_entries_per_host_; }
+
   // Recommended table size in section 5.3 of the paper.
   static const uint64_t DefaultTableSize = 65537;
 
 private:
   struct TableBuildEntry {
-    TableBuildEntry(const HostConstSharedPtr& host, uint64_t offset, uint64_t skip, double weight)
-        : host_(host), offset_(offset), skip_(skip), weight_(weight) {}
+    TableBuildEntry(uint64_t offset, uint64_t skip, double weight)
+        : offset_(offset), skip_(skip), weight_(weight) {}
 
-    HostConstSharedPtr host_;
     const uint64_t offset_;
     const uint64_t skip_;
     const double weight_;
@@ -60,9 +65,16 @@ private:
 
   uint64_t permutation(const TableBuildEntry& entry);
 
+  // Marks the table entries which haven't been assigned a host yet while building the table.
+  static constexpr uint32_t UnassignedEntry = std::numeric_limits<uint32_t>::max();
+
   const uint64_t table_size_;
-  std::vector<HostConstSharedPtr> table_;
-  MaglevLoadBalancerStats& stats_;
+  std::vector<HostConstSharedPtr> hosts_;
+  // Indexes in hosts_ rather than hosts, so that building the table doesn't touch the hosts'
+  // reference counts, and the table takes a quarter of the memory.
+  std::vector<uint32_t> table_;
+  uint64_t min_entries_per_host_{};
+  uint64_t max_entries_per_host_{};
 };
 
 /**
@@ -81,21 +93,16 @@ public:
   uint64_t tableSize() const { return table_size_; }
 
 private:
+  // The table entries per host in the table of a priority.
+  struct EntriesPerHost {
+    uint64_t min_;
+    uint64_t max_;
+  };
+
   // ThreadAwareLoadBalancerBase
   HashingLoadBalancerSharedPtr
-  createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
-                     double /* min_normalized_weight */, double max_normalized_weight) override {
-    HashingLoadBalancerSharedPtr maglev_lb =
-        std::make_shared<MaglevTable>(normalized_host_weights, max_normalized_weight, table_size_,
-                                      use_hostname_for_hashing_, stats_);
-
-    if (hash_balance_factor_ == 0) {
-      return maglev_lb;
-    }
-
-    return std::make_shared<BoundedLoadHashingLoadBalancer>(
-        maglev_lb, std::move(normalized_host_weights), hash_balance_factor_);
-  }
+  createLoadBalancer(uint32_t priority, const NormalizedHostWeightVector& normalized_host_weights,
+                     double min_normalized_weight, double max_normalized_weight) override;
 
   static MaglevLoadBalancerStats generateStats(Stats::Scope& scope);
 
@@ -104,6 +111,8 @@ private:
   const uint64_t table_size_;
   const bool use_hostname_for_hashing_;
   const uint32_t hash_balance_factor_;
+  // Indexed by priority. Empty for the priorities without hosts, which the entry stats leave out.
+  std::vector<absl::optional<EntriesPerHost>> entries_per_host_;
 };
 
 } // namespace Upstream
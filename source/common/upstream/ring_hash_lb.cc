@@ -8,6 +8,7 @@
 #include "envoy/config/cluster/v3/cluster.pb.h"
 
 #include "common/common/assert.h"
+#include "common/common/utility.h"
 #include "common/upstream/load_balancer_impl.h"
 
 #include "absl/container/inlined_vector.h"
@@ -162,8 +163,9 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
     target_hashes += scale * entry.second;
     uint64_t i = 0;
     while (current_hashes < target_hashes) {
-      const std::string i_str = absl::StrCat("", i);
-      hash_key_buffer.insert(offset_start, i_str.begin(), i_str.end());
+      char i_str[StringUtil::MIN_ITOA_OUT_LEN];
+      const uint32_t i_len = StringUtil::itoa(i_str, sizeof(i_str), i);
+      hash_key_buffer.insert(offset_start, i_str, i_str + i_len);
 
       absl::string_view hash_key(static_cast<char*>(hash_key_buffer.data()),
                                  hash_key_buffer.size());
@@ -1,8 +1,11 @@
 #include "common/upstream/thread_aware_lb_impl.h"
 
 #include <memory>
+#include <numeric>
 #include <random>
 
+#include "absl/container/fixed_array.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -107,6 +110,7 @@ void ThreadAwareLoadBalancerBase::refresh() {
       std::make_shared<HealthyLoad>(per_priority_load_.healthy_priority_load_);
   auto degraded_per_priority_load =
       std::make_shared<DegradedLoad>(per_priority_load_.degraded_priority_load_);
+  built_lbs_.resize(priority_set_.hostSetsPerPriority().size());
 
   for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
     const uint32_t priority = host_set->priority();
@@ -122,8 +126,15 @@ void ThreadAwareLoadBalancerBase::refresh() {
     double max_normalized_weight = 0.0;
     normalizeWeights(*host_set, per_priority_state->global_panic_, normalized_host_weights,
                      min_normalized_weight, max_normalized_weight);
-    per_priority_state->current_lb_ = createLoadBalancer(
-        std::move(normalized_host_weights), min_normalized_weight, max_normalized_weight);
+    // Building a table is expensive for large host sets, and the tables only depend on the
+    // normalized weights, so an update of one priority doesn't rebuild the tables of the others.
+    BuiltLoadBalancer& built = built_lbs_[priority];
+    if (built.lb_ == nullptr || built.normalized_host_weights_ != normalized_host_weights) {
+      built.lb_ = createLoadBalancer(priority, normalized_host_weights, min_normalized_weight,
+                                     max_normalized_weight);
+      built.normalized_host_weights_ = std::move(normalized_host_weights);
+    }
+    per_priority_state->current_lb_ = built.lb_;
   }
 
   {
@@ -233,7 +244,7 @@ ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t
   if (host == nullptr) {
     return nullptr;
   }
-  const double weight = normalized_host_weights_map_.at(host);
+  const double weight = normalized_host_weights_map_.at(host.get());
   double overload_factor = hostOverloadFactor(*host, weight);
   if (overload_factor <= 1.0) {
     ENVOY_LOG_MISC(debug,
@@ -246,11 +257,11 @@ ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t
   // When a host is overloaded, we choose the next host in a random manner rather than picking the
   // next one in the ring. The random sequence is seeded by the hash, so the same input gets the
   // same sequence of hosts all the time.
+  // The shuffled indexes are on the stack for clusters of up to a few hundred hosts, so that
+  // overloaded hosts don't cost a memory allocation on every request.
   const uint32_t num_hosts = normalized_host_weights_.size();
-  auto host_index = std::vector<uint32_t>(num_hosts);
-  for (uint32_t i = 0; i < num_hosts; i++) {
-    host_index[i] = i;
-  }
+  absl::FixedArray<uint32_t, 256> host_index(num_hosts);
+  std::iota(host_index.begin(), host_index.end(), 0);
 
   // Not using Random::RandomGenerator as it does not take a seed. Seeded RNG is a requirement
   // here as we need the same shuffle sequence for the same hash every time.
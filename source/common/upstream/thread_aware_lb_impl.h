@@ -4,13 +4,15 @@
 
 #include "common/upstream/load_balancer_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Upstream {
 
 using NormalizedHostWeightVector = std::vector<std::pair<HostConstSharedPtr, double>>;
-using NormalizedHostWeightMap = std::map<HostConstSharedPtr, double>;
+// Keyed by raw pointer, as the hosts are owned by the NormalizedHostWeightVector it is built from.
+using NormalizedHostWeightMap = absl::flat_hash_map<const Host*, double>;
 
 class ThreadAwareLoadBalancerBase : public LoadBalancerBase, public ThreadAwareLoadBalancer {
 public:
@@ -57,7 +59,7 @@ public:
     initNormalizedHostWeightMap(const NormalizedHostWeightVector& normalized_host_weights) {
       NormalizedHostWeightMap normalized_host_weights_map;
       for (auto const& item : normalized_host_weights) {
-        normalized_host_weights_map[item.first] = item.second;
+        normalized_host_weights_map[item.first.get()] = item.second;
       }
       return normalized_host_weights_map;
     }
@@ -123,12 +125,22 @@ private:
     std::shared_ptr<DegradedLoad> degraded_per_priority_load_ ABSL_GUARDED_BY(mutex_);
   };
 
+  // The load balancer last built for a priority, along with the weights it was built from. Only
+  // accessed from the main thread.
+  struct BuiltLoadBalancer {
+    NormalizedHostWeightVector normalized_host_weights_;
+    HashingLoadBalancerSharedPtr lb_;
+  };
+
+  // Builds the load balancer of a priority. Only called on the main thread, and only when the
+  // normalized host weights of the priority changed since its load balancer was last built.
   virtual HashingLoadBalancerSharedPtr
-  createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
+  createLoadBalancer(uint32_t priority, const NormalizedHostWeightVector& normalized_host_weights,
                      double min_normalized_weight, double max_normalized_weight) PURE;
   void refresh();
 
   std::shared_ptr<LoadBalancerFactoryImpl> factory_;
+  std::vector<BuiltLoadBalancer> built_lbs_;
 };
 
 } // namespace Upstream
@@ -29,6 +29,14 @@
 
 namespace Envoy {
 
+namespace {
+
+// Scopes for clusters, listeners and routes are created and destroyed during xDS updates while
+// workers create stats, so the allocator's stat sets are sharded to keep those from contending.
+constexpr uint32_t StatsAllocatorShards = 16;
+
+} // namespace
+
 Server::DrainManagerPtr ProdComponentFactory::createDrainManager(Server::Instance& server) {
   // The global drain manager only triggers on listener modification, which effectively is
   // hot restart at the global level. The per-listener drain managers decide whether to
@@ -50,7 +58,7 @@ MainCommonBase::MainCommonBase(const OptionsImpl& options, Event::TimeSystem& ti
                                Filesystem::Instance& file_system,
                                std::unique_ptr<ProcessContext> process_context)
     : options_(options), component_factory_(component_factory), thread_factory_(thread_factory),
-      file_system_(file_system), stats_allocator_(symbol_table_) {
+      file_system_(file_system), stats_allocator_(symbol_table_, StatsAllocatorShards) {
   // Process the option to disable extensions as early as possible,
   // before we do any configuration loading.
   OptionsImpl::disableExtensions(options.disabledExtensions());
@@ -138,6 +138,7 @@ EXTENSIONS = {
     # Resource monitors
     #
 
+    "envoy.resource_monitors.buffer_memory":            "//source/extensions/resource_monitors/buffer_memory:config",
     "envoy.resource_monitors.fixed_heap":               "//source/extensions/resource_monitors/fixed_heap:config",
     "envoy.resource_monitors.injected_resource":        "//source/extensions/resource_monitors/injected_resource:config",
 
@@ -201,6 +202,7 @@ EXTENSIONS = {
     #
 
     "envoy.filters.http.cache.simple_http_cache":       "//source/extensions/filters/http/cache/simple_http_cache:simple_http_cache_lib",
+    "envoy.filters.http.cache.shared_memory_http_cache": "//source/extensions/filters/http/cache/shared_memory_http_cache:shared_memory_http_cache_lib",
 
     #
     # Internal redirect predicates
@@ -215,6 +217,18 @@ EXTENSIONS = {
     "envoy.upstreams.http.http":                        "//source/extensions/upstreams/http/http:config",
     "envoy.upstreams.http.tcp":                         "//source/extensions/upstreams/http/tcp:config",
 
+    #
+    # Private key providers
+    #
+
+    "envoy.tls.key_providers.thread_pool":              "//source/extensions/private_key_providers/thread_pool:config",
+
+    #
+    # Socket interfaces
+    #
+
+    "envoy.extensions.network.socket_interface.io_uring": "//source/extensions/network/socket_interface/io_uring:config",
+
     #
     # Watchdog actions
     #
@@ -0,0 +1,175 @@
+#include "extensions/filters/http/cache/buffered_http_cache.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_map_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+class BufferedLookupContext : public LookupContext {
+public:
+  BufferedLookupContext(BufferedHttpCache& cache, LookupRequest&& request)
+      : cache_(cache), request_(std::move(request)) {}
+
+  void getHeaders(LookupHeadersCallback&& cb) override {
+    auto entry = cache_.lookup(request_);
+    body_ = std::move(entry.body_);
+    cb(entry.response_headers_ ? request_.makeLookupResult(std::move(entry.response_headers_),
+                                                           std::move(entry.metadata_), body_.size())
+                               : LookupResult{});
+  }
+
+  void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
+    ASSERT(range.end() <= body_.length(), "Attempt to read past end of body.");
+    cb(std::make_unique<Buffer::OwnedImpl>(&body_[range.begin()], range.length()));
+  }
+
+  void getTrailers(LookupTrailersCallback&&) override {
+    // TODO(toddmgreer): Support trailers.
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+  }
+
+  const LookupRequest& request() const { return request_; }
+  void onDestroy() override {}
+
+private:
+  BufferedHttpCache& cache_;
+  const LookupRequest request_;
+  std::string body_;
+};
+
+class BufferedInsertContext : public InsertContext {
+public:
+  BufferedInsertContext(LookupContext& lookup_context, BufferedHttpCache& cache)
+      : key_(dynamic_cast<BufferedLookupContext&>(lookup_context).request().key()),
+        entry_vary_headers_(
+            dynamic_cast<BufferedLookupContext&>(lookup_context).request().getVaryHeaders()),
+        cache_(cache) {}
+
+  void insertHeaders(const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata, bool end_stream) override {
+    ASSERT(!committed_);
+    response_headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+    metadata_ = metadata;
+    if (end_stream) {
+      commit();
+    }
+  }
+
+  void insertBody(const Buffer::Instance& chunk, InsertCallback ready_for_next_chunk,
+                  bool end_stream) override {
+    ASSERT(!committed_);
+    ASSERT(ready_for_next_chunk || end_stream);
+
+    if (aborted_) {
+      return;
+    }
+    body_.add(chunk);
+    if (body_.length() > cache_.maxBodySize()) {
+      // The response can't be cached: stop buffering it.
+      aborted_ = true;
+      body_.drain(body_.length());
+      if (ready_for_next_chunk) {
+        ready_for_next_chunk(false);
+      }
+      return;
+    }
+    if (end_stream) {
+      commit();
+    } else {
+      ready_for_next_chunk(true);
+    }
+  }
+
+  void insertTrailers(const Http::ResponseTrailerMap&) override {
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE; // TODO(toddmgreer): support trailers
+  }
+
+  void onDestroy() override {}
+
+private:
+  void commit() {
+    committed_ = true;
+    cache_.insert(key_, {std::move(response_headers_), std::move(metadata_), body_.toString()},
+                  entry_vary_headers_);
+  }
+
+  Key key_;
+  Http::ResponseHeaderMapPtr response_headers_;
+  ResponseMetadata metadata_;
+  const Http::RequestHeaderMap& entry_vary_headers_;
+  BufferedHttpCache& cache_;
+  Buffer::OwnedImpl body_;
+  bool committed_ = false;
+  bool aborted_ = false;
+};
+
+Key variedKey(const Key& key, const Http::HeaderMap::GetResult& vary_header,
+              const Http::RequestHeaderMap& request_vary_headers) {
+  Key varied_key = key;
+  varied_key.add_custom_fields(VaryHeader::createVaryKey(vary_header, request_vary_headers));
+  return varied_key;
+}
+
+} // namespace
+
+LookupContextPtr BufferedHttpCache::makeLookupContext(LookupRequest&& request) {
+  return std::make_unique<BufferedLookupContext>(*this, std::move(request));
+}
+
+InsertContextPtr BufferedHttpCache::makeInsertContext(LookupContextPtr&& lookup_context) {
+  ASSERT(lookup_context != nullptr);
+  return std::make_unique<BufferedInsertContext>(*lookup_context, *this);
+}
+
+void BufferedHttpCache::updateHeaders(const LookupContext&, const Http::ResponseHeaderMap&,
+                                      const ResponseMetadata&) {
+  // TODO(toddmgreer): Support updating headers.
+  // Not implemented yet, however this is called during tests
+  // NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+}
+
+BufferedHttpCache::Entry BufferedHttpCache::lookup(const LookupRequest& request) {
+  Entry entry = lookupEntry(request.key());
+  if (!entry.response_headers_ || !VaryHeader::hasVary(*entry.response_headers_)) {
+    return entry;
+  }
+  // The entry only flags that the response varies: look up the variant for this request.
+  const auto vary_header = entry.response_headers_->get(Http::Headers::get().Vary);
+  return lookupEntry(variedKey(request.key(), vary_header, request.getVaryHeaders()));
+}
+
+bool BufferedHttpCache::insert(const Key& key, Entry&& entry,
+                               const Http::RequestHeaderMap& request_vary_headers) {
+  ASSERT(entry.response_headers_ != nullptr);
+  if (!VaryHeader::hasVary(*entry.response_headers_)) {
+    return insertEntry(key, std::move(entry));
+  }
+
+  // The vary header belongs to the response, which is handed over below.
+  const auto vary_header = entry.response_headers_->get(Http::Headers::get().Vary);
+  ASSERT(!vary_header.empty());
+  const Key varied_key = variedKey(key, vary_header, request_vary_headers);
+  Http::ResponseHeaderMapPtr vary_only_map =
+      Http::createHeaderMap<Http::ResponseHeaderMapImpl>({});
+  // TODO(mattklein123): Support multiple vary headers and/or just make the vary header inline.
+  vary_only_map->setCopy(Http::Headers::get().Vary, vary_header[0]->value().getStringView());
+  if (!insertEntry(varied_key, std::move(entry))) {
+    return false;
+  }
+
+  // Add a special entry to flag that this request generates varied responses.
+  // TODO(cbdm): In a cache that evicts entries, we could maintain a list of the "varykey"s that
+  // we have inserted as the body for this first lookup. This way, we would know which keys we
+  // have inserted for that resource. For the first entry simply use vary_key as the entry_list,
+  // for future entries append vary_key to existing list.
+  return insertEntry(key, {std::move(vary_only_map), {}, ""});
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "extensions/filters/http/cache/http_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * Base of the caches which store each response whole: its lookup and insert contexts buffer the
+ * body of a response, and hand it to the cache along with its headers once it is complete.
+ *
+ * A response which varies is stored under a key which includes the request headers it varies on,
+ * and an entry holding only its vary header is stored under the key of the request, to flag that
+ * lookups must look for the variant matching the request.
+ */
+class BufferedHttpCache : public HttpCache {
+public:
+  struct Entry {
+    Http::ResponseHeaderMapPtr response_headers_;
+    ResponseMetadata metadata_;
+    std::string body_;
+  };
+
+  // HttpCache
+  LookupContextPtr makeLookupContext(LookupRequest&& request) override;
+  InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context) override;
+  void updateHeaders(const LookupContext& lookup_context,
+                     const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata) override;
+
+  // Looks up the response for request, following responses which vary to the variant which
+  // matches it. Returns an Entry without headers if there is none.
+  Entry lookup(const LookupRequest& request);
+  // Inserts a response. Responses which vary are inserted under a key which includes the
+  // request_vary_headers they vary on. Returns false if the response wasn't inserted.
+  bool insert(const Key& key, Entry&& entry, const Http::RequestHeaderMap& request_vary_headers);
+
+  // Responses with a larger body aren't buffered, and can't be cached.
+  virtual uint64_t maxBodySize() const { return std::numeric_limits<uint64_t>::max(); }
+
+protected:
+  // Returns the entry stored under key, or an Entry without headers if there is none.
+  virtual Entry lookupEntry(const Key& key) PURE;
+  // Stores entry under key, replacing the previous one. Returns false if it wasn't stored.
+  virtual bool insertEntry(const Key& key, Entry&& entry) PURE;
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,178 @@
+#include "extensions/filters/http/cache/shared_memory_http_cache/shared_memory_http_cache.h"
+
+#include <chrono>
+#include <cstring>
+
+#include "envoy/registry/registry.h"
+
+#include "common/common/fmt.h"
+#include "common/http/header_map_impl.h"
+#include "common/protobuf/message_validator_impl.h"
+#include "common/protobuf/utility.h"
+
+#include "source/extensions/filters/http/cache/shared_memory_http_cache/config.pb.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+constexpr absl::string_view Name = "envoy.extensions.http.cache.shared_memory";
+
+constexpr uint64_t DefaultMaxSizeBytes = 64 * 1024 * 1024;
+constexpr uint32_t DefaultSlotSizeBytes = 64 * 1024;
+
+// Stored entries are only read by processes running on the same machine, so integers are stored
+// in native byte order.
+template <class T> void appendInteger(std::string& output, T value) {
+  output.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <class T> bool readInteger(absl::string_view& input, T& value) {
+  if (input.size() < sizeof(value)) {
+    return false;
+  }
+  memcpy(&value, input.data(), sizeof(value));
+  input.remove_prefix(sizeof(value));
+  return true;
+}
+
+bool readString(absl::string_view& input, absl::string_view& value) {
+  uint32_t size;
+  if (!readInteger(input, size) || input.size() < size) {
+    return false;
+  }
+  value = input.substr(0, size);
+  input.remove_prefix(size);
+  return true;
+}
+
+// An entry is stored as its response time, its headers, preceded by their number, each as a name
+// and value preceded by their size, and its body.
+std::string encodeEntry(const Http::ResponseHeaderMap& response_headers,
+                        const ResponseMetadata& metadata, absl::string_view body) {
+  std::string value;
+  appendInteger<int64_t>(value, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    metadata.response_time_.time_since_epoch())
+                                    .count());
+  appendInteger<uint32_t>(value, response_headers.size());
+  response_headers.iterate([&value](const Http::HeaderEntry& header) {
+    appendInteger<uint32_t>(value, header.key().size());
+    value.append(header.key().getStringView().data(), header.key().size());
+    appendInteger<uint32_t>(value, header.value().size());
+    value.append(header.value().getStringView().data(), header.value().size());
+    return Http::HeaderMap::Iterate::Continue;
+  });
+  value.append(body.data(), body.size());
+  return value;
+}
+
+bool decodeEntry(absl::string_view value, BufferedHttpCache::Entry& entry) {
+  int64_t response_time;
+  uint32_t header_count;
+  if (!readInteger(value, response_time) || !readInteger(value, header_count)) {
+    return false;
+  }
+  auto response_headers = Http::ResponseHeaderMapImpl::create();
+  for (uint32_t i = 0; i < header_count; ++i) {
+    absl::string_view header_name;
+    absl::string_view header_value;
+    if (!readString(value, header_name) || !readString(value, header_value)) {
+      return false;
+    }
+    response_headers->addCopy(Http::LowerCaseString(std::string(header_name)), header_value);
+  }
+  entry.response_headers_ = std::move(response_headers);
+  entry.metadata_.response_time_ =
+      SystemTime(std::chrono::duration_cast<SystemTime::duration>(
+          std::chrono::nanoseconds(response_time)));
+  entry.body_ = std::string(value);
+  return true;
+}
+
+} // namespace
+
+SharedMemoryHttpCache::SharedMemoryHttpCache(SharedMemoryRegionPtr&& region, uint32_t slot_size)
+    : region_(std::move(region)), store_(region_->data(), region_->size(), slot_size) {}
+
+CacheInfo SharedMemoryHttpCache::cacheInfo() const {
+  CacheInfo cache_info;
+  cache_info.name_ = Name;
+  return cache_info;
+}
+
+SharedMemoryHttpCache::Entry SharedMemoryHttpCache::lookupEntry(const Key& key) {
+  std::string value;
+  Entry entry;
+  if (!store_.lookup(stableHashKey(key), key.SerializeAsString(), value) ||
+      !decodeEntry(value, entry)) {
+    return Entry{};
+  }
+  return entry;
+}
+
+bool SharedMemoryHttpCache::insertEntry(const Key& key, Entry&& entry) {
+  return store_.insert(stableHashKey(key), key.SerializeAsString(),
+                       encodeEntry(*entry.response_headers_, entry.metadata_, entry.body_));
+}
+
+class SharedMemoryHttpCacheFactory : public HttpCacheFactory {
+public:
+  // From UntypedFactory
+  std::string name() const override { return std::string(Name); }
+  // From TypedFactory
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<
+        envoy::source::extensions::filters::http::cache::SharedMemoryHttpCacheConfig>();
+  }
+  // From HttpCacheFactory
+  HttpCache&
+  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config) override {
+    envoy::source::extensions::filters::http::cache::SharedMemoryHttpCacheConfig typed_config;
+    MessageUtil::anyConvertAndValidate(config.typed_config(), typed_config,
+                                       ProtobufMessage::getStrictValidationVisitor());
+    const uint64_t size =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(typed_config, max_size_bytes, DefaultMaxSizeBytes);
+    const uint32_t slot_size =
+        (PROTOBUF_GET_WRAPPED_OR_DEFAULT(typed_config, slot_size_bytes, DefaultSlotSizeBytes) +
+         SlabStore::SlotAlignment - 1) /
+        SlabStore::SlotAlignment * SlabStore::SlotAlignment;
+    const std::string shared_memory_name =
+        typed_config.shared_memory_name().empty()
+            ? ""
+            : fmt::format("/envoy_http_cache_{}", typed_config.shared_memory_name());
+
+    // Filters with the same configuration share the cache.
+    const std::string cache_key = fmt::format("{}/{}/{}", shared_memory_name, size, slot_size);
+    absl::MutexLock lock(&mutex_);
+    auto& cache = caches_[cache_key];
+    if (cache == nullptr) {
+      SharedMemoryRegionPtr region = SharedMemoryRegion::create(shared_memory_name, size);
+      if (SlabStore::holdsOtherLayout(region->data(), region->size(), slot_size)) {
+        // Changing the layout starts from an empty cache, which replaces the previous one rather
+        // than leaving it behind.
+        region.reset();
+        SharedMemoryRegion::remove(shared_memory_name);
+        region = SharedMemoryRegion::create(shared_memory_name, size);
+      }
+      cache = std::make_unique<SharedMemoryHttpCache>(std::move(region), slot_size);
+    }
+    return *cache;
+  }
+
+private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::unique_ptr<SharedMemoryHttpCache>>
+      caches_ ABSL_GUARDED_BY(mutex_);
+};
+
+static Registry::RegisterFactory<SharedMemoryHttpCacheFactory, HttpCacheFactory> register_;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
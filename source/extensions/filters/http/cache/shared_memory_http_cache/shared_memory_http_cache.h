@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+
+#include "extensions/filters/http/cache/buffered_http_cache.h"
+#include "extensions/filters/http/cache/shared_memory_http_cache/slab_store.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * Cache backend which stores responses in a SlabStore, in memory which may be shared with other
+ * Envoy processes, e.g. the one it hot restarts from. A response is stored along with its key, and
+ * its headers and body are copied out of the store on lookup.
+ */
+class SharedMemoryHttpCache : public BufferedHttpCache {
+public:
+  SharedMemoryHttpCache(SharedMemoryRegionPtr&& region, uint32_t slot_size);
+
+  // HttpCache
+  CacheInfo cacheInfo() const override;
+
+  // BufferedHttpCache
+  uint64_t maxBodySize() const override { return store_.maxEntrySize(); }
+
+  SlabStore& store() { return store_; }
+
+protected:
+  // BufferedHttpCache
+  Entry lookupEntry(const Key& key) override;
+  bool insertEntry(const Key& key, Entry&& entry) override;
+
+private:
+  const SharedMemoryRegionPtr region_;
+  SlabStore store_;
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,362 @@
+#include "extensions/filters/http/cache/shared_memory_http_cache/slab_store.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <thread>
+
+#include "envoy/common/exception.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/logger.h"
+#include "common/common/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+// Identifies regions holding a SlabStore: "envoyslb".
+constexpr uint64_t Magic = 0x656e766f79736c62;
+
+// Number of times a lookup retries copying an entry which a writer is updating.
+constexpr uint32_t MaxReadAttempts = 4;
+
+uint64_t roundUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+// Processes attaching to the region are expected to share a pid namespace, as with hot restart.
+bool processExists(uint32_t pid) { return ::kill(pid, 0) == 0 || errno != ESRCH; }
+
+// Readers copy slots while writers may be updating them, and only find out afterwards whether
+// they did. The copies are made of relaxed atomic accesses, a word at a time where possible, so
+// that they are not data races.
+void copyFromSlot(char* destination, const char* source, size_t size) {
+  ASSERT(reinterpret_cast<uintptr_t>(source) % sizeof(uint64_t) == 0);
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    const uint64_t word =
+        __atomic_load_n(reinterpret_cast<const uint64_t*>(source + i), __ATOMIC_RELAXED);
+    memcpy(destination + i, &word, sizeof(word));
+  }
+  for (; i < size; ++i) {
+    destination[i] = __atomic_load_n(source + i, __ATOMIC_RELAXED);
+  }
+}
+
+void copyToSlot(char* destination, const char* source, size_t size) {
+  size_t i = 0;
+  for (; i < size && reinterpret_cast<uintptr_t>(destination + i) % sizeof(uint64_t) != 0; ++i) {
+    __atomic_store_n(destination + i, source[i], __ATOMIC_RELAXED);
+  }
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, source + i, sizeof(word));
+    __atomic_store_n(reinterpret_cast<uint64_t*>(destination + i), word, __ATOMIC_RELAXED);
+  }
+  for (; i < size; ++i) {
+    __atomic_store_n(destination + i, source[i], __ATOMIC_RELAXED);
+  }
+}
+
+} // namespace
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+  // The shared memory object itself is left in place for the next process.
+  ::munmap(data_, size_);
+}
+
+std::unique_ptr<SharedMemoryRegion> SharedMemoryRegion::create(const std::string& name,
+                                                               uint64_t size) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  if (name.empty()) {
+    const Api::SysCallPtrResult result = os_sys_calls.mmap(
+        nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (result.rc_ == MAP_FAILED) {
+      throw EnvoyException(fmt::format("cannot map {} bytes of memory for the HTTP cache: {}",
+                                       size, errorDetails(result.errno_)));
+    }
+    return std::unique_ptr<SharedMemoryRegion>(new SharedMemoryRegion(result.rc_, size));
+  }
+
+  // Contrary to the hot restart segment, the object is not recreated by the first epoch: its
+  // contents remain valid across restarts, and the store checks their layout.
+  const auto open_object = [&name]() {
+    const int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+    if (fd == -1) {
+      throw EnvoyException(fmt::format("cannot open shared memory region {}: {}", name,
+                                       errorDetails(errno)));
+    }
+    return fd;
+  };
+  int fd = open_object();
+  struct stat stat_buf;
+  if (::fstat(fd, &stat_buf) == 0 && stat_buf.st_size != 0 &&
+      static_cast<uint64_t>(stat_buf.st_size) != size) {
+    // The object was sized by an earlier configuration. Resizing it would cut the mappings of the
+    // processes still using it short: replace it instead.
+    ENVOY_LOG_MISC(info, "replacing shared memory region {} of {} bytes by one of {} bytes", name,
+                   stat_buf.st_size, size);
+    os_sys_calls.close(fd);
+    remove(name);
+    fd = open_object();
+  }
+  // Growing a new object zero-fills it, and leaves an existing one of the same size untouched.
+  const Api::SysCallIntResult truncate_result = os_sys_calls.ftruncate(fd, size);
+  if (truncate_result.rc_ == -1) {
+    os_sys_calls.close(fd);
+    throw EnvoyException(fmt::format("cannot resize shared memory region {}: {}", name,
+                                     errorDetails(truncate_result.errno_)));
+  }
+  const Api::SysCallPtrResult result =
+      os_sys_calls.mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  os_sys_calls.close(fd);
+  if (result.rc_ == MAP_FAILED) {
+    throw EnvoyException(fmt::format("cannot map shared memory region {}: {}", name,
+                                     errorDetails(result.errno_)));
+  }
+  return std::unique_ptr<SharedMemoryRegion>(new SharedMemoryRegion(result.rc_, size));
+}
+
+void SharedMemoryRegion::remove(const std::string& name) {
+  if (::shm_unlink(name.c_str()) == -1 && errno != ENOENT) {
+    ENVOY_LOG_MISC(warn, "cannot remove shared memory region {}: {}", name, errorDetails(errno));
+  }
+}
+
+uint64_t SlabStore::slotCount(uint64_t size, uint32_t slot_size) {
+  // Each set needs its slots and a clock hand, and the clock hands are padded to a cache line.
+  const uint64_t available = size > sizeof(Header) + SlotAlignment
+                                 ? size - sizeof(Header) - SlotAlignment
+                                 : 0;
+  const uint64_t sets = available / (static_cast<uint64_t>(WaysPerSet) * slot_size + 1);
+  if (sets == 0) {
+    throw EnvoyException(
+        fmt::format("HTTP cache size {} is too small for {} slots of {} bytes", size, WaysPerSet,
+                    slot_size));
+  }
+  return sets * WaysPerSet;
+}
+
+bool SlabStore::holdsOtherLayout(const void* region, uint64_t size, uint32_t slot_size) {
+  const Header* header = static_cast<const Header*>(region);
+  if (header->state_.load(std::memory_order_acquire) != Ready) {
+    return false;
+  }
+  return header->magic_ != Magic || header->slot_size_ != slot_size ||
+         header->slot_count_ != slotCount(size, slot_size);
+}
+
+SlabStore::SlabStore(void* region, uint64_t size, uint32_t slot_size)
+    : header_(static_cast<Header*>(region)), pid_(::getpid()), slot_size_(slot_size),
+      slot_count_(slotCount(size, slot_size)),
+      clock_hands_(reinterpret_cast<std::atomic<uint8_t>*>(header_ + 1)),
+      slots_(reinterpret_cast<char*>(header_ + 1) +
+             roundUp(slot_count_ / WaysPerSet, SlotAlignment)) {
+  ASSERT(reinterpret_cast<uintptr_t>(region) % SlotAlignment == 0);
+  ASSERT(slot_size % SlotAlignment == 0 && slot_size > sizeof(Slot));
+  static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                "shared memory atomics must be lock free");
+
+  // A region which was just created is all zeros, i.e. Uninitialized. Only one of the processes
+  // attaching to it concurrently initializes it.
+  uint32_t state = Uninitialized;
+  if (header_->state_.compare_exchange_strong(state, Initializing, std::memory_order_acquire)) {
+    header_->initializer_.store(pid_, std::memory_order_relaxed);
+    initialize();
+    return;
+  }
+  if (state == Initializing) {
+    awaitInitialization();
+  }
+  if (header_->magic_ != Magic || header_->slot_size_ != slot_size_ ||
+      header_->slot_count_ != slot_count_) {
+    throw EnvoyException("shared memory region holds an HTTP cache with a different layout");
+  }
+}
+
+void SlabStore::awaitInitialization() {
+  for (;;) {
+    const auto deadline = std::chrono::steady_clock::now() + InitializationTimeout;
+    while (header_->state_.load(std::memory_order_acquire) == Initializing) {
+      if (std::chrono::steady_clock::now() >= deadline) {
+        break;
+      }
+      std::this_thread::yield();
+    }
+    if (header_->state_.load(std::memory_order_acquire) != Initializing) {
+      return;
+    }
+
+    // Initializing the region only takes a few stores: the process which started it, if it is
+    // still around, is stuck.
+    uint32_t initializer = header_->initializer_.load(std::memory_order_relaxed);
+    if (initializer != 0 && processExists(initializer)) {
+      throw EnvoyException(fmt::format(
+          "shared memory region of the HTTP cache is still being initialized by process {}; "
+          "remove the region to reset it",
+          initializer));
+    }
+    // It died: take over, unless another process already did, in which case wait for it.
+    if (header_->initializer_.compare_exchange_strong(initializer, pid_,
+                                                      std::memory_order_acquire)) {
+      initialize();
+      return;
+    }
+  }
+}
+
+void SlabStore::initialize() {
+  header_->magic_ = Magic;
+  header_->slot_size_ = slot_size_;
+  header_->slot_count_ = slot_count_;
+  header_->entries_.store(0, std::memory_order_relaxed);
+  header_->used_bytes_.store(0, std::memory_order_relaxed);
+  header_->evictions_.store(0, std::memory_order_relaxed);
+  // The region is only Uninitialized when it was just created, and zero filled: the clock hands
+  // and slots are already in their initial state, and are left alone so that their pages are
+  // only committed when entries are inserted.
+  static_assert(EmptyHash == 0, "zero filled slots must be empty");
+  header_->state_.store(Ready, std::memory_order_release);
+}
+
+bool SlabStore::abandoned(uint64_t sequence) const {
+  ASSERT(sequence % 2 != 0);
+  const uint32_t writer = sequence >> 32;
+  // Writers of this process may be other stores over the same region, e.g. before a
+  // configuration update, and are alive.
+  return writer != pid_ && !processExists(writer);
+}
+
+bool SlabStore::lookup(uint64_t hash, absl::string_view key, std::string& value) {
+  hash = hash == EmptyHash ? EmptyHash + 1 : hash;
+  const uint64_t first = hash % (slot_count_ / WaysPerSet) * WaysPerSet;
+  for (uint64_t i = first; i < first + WaysPerSet; ++i) {
+    Slot& entry = slot(i);
+    for (uint32_t attempt = 0; attempt < MaxReadAttempts; ++attempt) {
+      const uint64_t sequence = entry.sequence_.load(std::memory_order_acquire);
+      if (sequence % 2 != 0) {
+        std::this_thread::yield();
+        continue;
+      }
+      if (entry.hash_.load(std::memory_order_relaxed) != hash) {
+        break;
+      }
+      const uint64_t key_size = entry.key_size_.load(std::memory_order_relaxed);
+      const uint64_t value_size = entry.value_size_.load(std::memory_order_relaxed);
+      if (key_size != key.size() || key_size + value_size > maxEntrySize()) {
+        // Either a hash collision, or sizes torn by a concurrent write, which the sequence check
+        // tells apart.
+        if (entry.sequence_.load(std::memory_order_acquire) == sequence) {
+          break;
+        }
+        continue;
+      }
+      // The copy is only used if the sequence number shows that no writer touched the slot
+      // meanwhile.
+      value.resize(key_size + value_size);
+      copyFromSlot(&value[0], entry.data(), key_size + value_size);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (entry.sequence_.load(std::memory_order_relaxed) != sequence) {
+        continue;
+      }
+      if (absl::string_view(value).substr(0, key_size) != key) {
+        break;
+      }
+      value.erase(0, key_size);
+      entry.referenced_.store(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  value.clear();
+  return false;
+}
+
+SlabStore::Slot& SlabStore::victim(uint64_t set, uint64_t hash) {
+  const uint64_t first = set * WaysPerSet;
+  // Replace the entry with the same hash, which most likely has the same key, or fill an empty
+  // slot.
+  Slot* empty = nullptr;
+  for (uint64_t i = first; i < first + WaysPerSet; ++i) {
+    const uint64_t slot_hash = slot(i).hash_.load(std::memory_order_relaxed);
+    if (slot_hash == hash) {
+      return slot(i);
+    }
+    if (slot_hash == EmptyHash && empty == nullptr) {
+      empty = &slot(i);
+    }
+  }
+  if (empty != nullptr) {
+    return *empty;
+  }
+
+  // Advance the clock hand to the first entry which wasn't referenced since the hand last passed
+  // it. After a full turn all the entries are unreferenced, so this takes at most two turns.
+  std::atomic<uint8_t>& hand = clockHand(set);
+  uint8_t position = hand.load(std::memory_order_relaxed);
+  for (uint32_t step = 0; step < 2 * WaysPerSet; ++step, ++position) {
+    Slot& candidate = slot(first + position % WaysPerSet);
+    if (candidate.referenced_.exchange(0, std::memory_order_relaxed) == 0) {
+      break;
+    }
+  }
+  hand.store(static_cast<uint8_t>((position + 1) % WaysPerSet), std::memory_order_relaxed);
+  return slot(first + position % WaysPerSet);
+}
+
+bool SlabStore::insert(uint64_t hash, absl::string_view key, absl::string_view value) {
+  if (key.size() + value.size() > maxEntrySize()) {
+    return false;
+  }
+  hash = hash == EmptyHash ? EmptyHash + 1 : hash;
+  Slot& entry = victim(hash % (slot_count_ / WaysPerSet), hash);
+
+  uint64_t sequence = entry.sequence_.load(std::memory_order_relaxed);
+  const bool take_over = sequence % 2 != 0;
+  if ((take_over && !abandoned(sequence)) ||
+      !entry.sequence_.compare_exchange_strong(sequence, claimed(sequence),
+                                               std::memory_order_relaxed)) {
+    return false;
+  }
+  // Order the writes below after the sequence number becomes odd.
+  std::atomic_thread_fence(std::memory_order_release);
+
+  const uint64_t old_hash = entry.hash_.load(std::memory_order_relaxed);
+  if (take_over) {
+    // The entry may be torn, and the counters off by the update which was interrupted: they are
+    // left as they are rather than corrected with the sizes of a torn entry.
+    ENVOY_LOG_MISC(warn, "taking over HTTP cache slot left behind by process {}", sequence >> 32);
+  } else if (old_hash != EmptyHash) {
+    header_->entries_.fetch_sub(1, std::memory_order_relaxed);
+    header_->used_bytes_.fetch_sub(entry.key_size_.load(std::memory_order_relaxed) +
+                                       entry.value_size_.load(std::memory_order_relaxed),
+                                   std::memory_order_relaxed);
+    if (old_hash != hash) {
+      header_->evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  entry.hash_.store(hash, std::memory_order_relaxed);
+  entry.key_size_.store(key.size(), std::memory_order_relaxed);
+  entry.value_size_.store(value.size(), std::memory_order_relaxed);
+  entry.referenced_.store(0, std::memory_order_relaxed);
+  copyToSlot(entry.data(), key.data(), key.size());
+  copyToSlot(entry.data() + key.size(), value.data(), value.size());
+  header_->entries_.fetch_add(1, std::memory_order_relaxed);
+  header_->used_bytes_.fetch_add(key.size() + value.size(), std::memory_order_relaxed);
+
+  entry.sequence_.store(released(claimed(sequence)), std::memory_order_release);
+  return true;
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
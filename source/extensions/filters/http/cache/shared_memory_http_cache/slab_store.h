@@ -0,0 +1,203 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "common/common/non_copyable.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * Memory region mapped with MAP_SHARED. A named region is backed by a POSIX shared memory object
+ * which outlives the process, so that the next Envoy process which maps the same name, e.g. after
+ * a hot restart, finds its contents. An unnamed region is anonymous, and private to the process
+ * and its children.
+ *
+ * A named object is only removed when it must be replaced, by create() when it has another size,
+ * or by remove(). Processes which map it at that point keep their mapping, and its memory is
+ * released once the last of them unmaps it, so there is at most one object per name holding
+ * memory beyond the lifetime of the processes using it.
+ */
+class SharedMemoryRegion : NonCopyable {
+public:
+  ~SharedMemoryRegion();
+
+  /**
+   * Map a region, creating it if it doesn't exist, or replacing it with a new one if it has
+   * another size. Throws EnvoyException on failure.
+   * @param name supplies the name of the POSIX shared memory object, which must start with '/',
+   *        or an empty string for an anonymous region.
+   * @param size supplies the size of the region in bytes.
+   */
+  static std::unique_ptr<SharedMemoryRegion> create(const std::string& name, uint64_t size);
+
+  /**
+   * Remove a POSIX shared memory object, so that the next create() of the name makes a new one.
+   * @param name supplies the name of the object.
+   */
+  static void remove(const std::string& name);
+
+  void* data() const { return data_; }
+  uint64_t size() const { return size_; }
+
+private:
+  SharedMemoryRegion(void* data, uint64_t size) : data_(data), size_(size) {}
+
+  void* const data_;
+  const uint64_t size_;
+};
+
+using SharedMemoryRegionPtr = std::unique_ptr<SharedMemoryRegion>;
+
+/**
+ * Key-value store laid out in a fixed-size memory region which may be shared by several processes.
+ * The region is divided in slots of a fixed size, each of which holds at most one entry, and slots
+ * are grouped in sets of WaysPerSet: an entry can only live in the set selected by its hash.
+ *
+ * Lookups don't take any lock: each slot has a sequence number which is odd while the slot is
+ * being written, and readers retry, or give up, when it changes while they copy the entry out.
+ * Writers claim a slot by making its sequence number odd, and drop the insertion if another writer
+ * has already claimed it. When a set is full, the entry to replace is picked with the CLOCK
+ * algorithm: lookups mark the entries they find as referenced, and eviction skips, and unmarks,
+ * referenced entries.
+ *
+ * All the state of the store lives in the region, including its counters, so that a store created
+ * over a region which already holds one, with the same layout, finds its entries. A process may
+ * die while it initializes the region or writes a slot: the region and the slots record the pid of
+ * the process updating them. A store attaching to the region takes over the initialization of a
+ * process which is gone, and an insertion takes over the slot it picks if it was left claimed by
+ * one. Attaching does not scan the slots, so that it doesn't commit the pages of the region.
+ */
+class SlabStore : NonCopyable {
+public:
+  static constexpr uint32_t WaysPerSet = 8;
+
+  /**
+   * @param region supplies the memory of the store, which must be aligned on a cache line and
+   *        outlive the store.
+   * @param size supplies the size of the region in bytes.
+   * @param slot_size supplies the size of each slot, including its bookkeeping, which must be a
+   *        multiple of SlotAlignment.
+   */
+  SlabStore(void* region, uint64_t size, uint32_t slot_size);
+
+  /**
+   * @return uint64_t the number of slots a region of the given size holds. Throws EnvoyException
+   *         if the region can't hold a single set of slots.
+   */
+  static uint64_t slotCount(uint64_t size, uint32_t slot_size);
+
+  /**
+   * @return bool whether the region holds a store whose layout differs from the given one, in
+   *         which case creating a store over it would throw EnvoyException.
+   */
+  static bool holdsOtherLayout(const void* region, uint64_t size, uint32_t slot_size);
+
+  /**
+   * Look up an entry.
+   * @param hash supplies the hash of the key.
+   * @param key supplies the key.
+   * @param value receives the value of the entry, if it is found.
+   * @return bool whether the entry was found.
+   */
+  bool lookup(uint64_t hash, absl::string_view key, std::string& value);
+
+  /**
+   * Insert or replace an entry. Insertion is best effort: it fails when the entry is larger than
+   * maxEntrySize(), or when another writer is updating the slot it would go in.
+   * @param hash supplies the hash of the key.
+   * @param key supplies the key.
+   * @param value supplies the value of the entry.
+   * @return bool whether the entry was inserted.
+   */
+  bool insert(uint64_t hash, absl::string_view key, absl::string_view value);
+
+  /**
+   * @return uint64_t the maximum combined size of the key and value of an entry.
+   */
+  uint64_t maxEntrySize() const { return slot_size_ - sizeof(Slot); }
+
+  uint64_t slots() const { return slot_count_; }
+  uint64_t entries() const { return header_->entries_.load(std::memory_order_relaxed); }
+  uint64_t usedBytes() const { return header_->used_bytes_.load(std::memory_order_relaxed); }
+  uint64_t evictions() const { return header_->evictions_.load(std::memory_order_relaxed); }
+
+  static constexpr uint32_t SlotAlignment = 64;
+
+  // How long a store waits for another process to initialize the region.
+  static constexpr std::chrono::milliseconds InitializationTimeout{1000};
+
+private:
+  friend class SlabStorePeer;
+
+  // Bookkeeping at the start of the region.
+  struct alignas(SlotAlignment) Header {
+    uint64_t magic_;
+    uint64_t slot_size_;
+    uint64_t slot_count_;
+    // One of the State values.
+    std::atomic<uint32_t> state_;
+    // The pid of the process initializing the region, or 0 if it is not known yet.
+    std::atomic<uint32_t> initializer_;
+    std::atomic<uint64_t> entries_;
+    std::atomic<uint64_t> used_bytes_;
+    std::atomic<uint64_t> evictions_;
+  };
+
+  enum State : uint32_t { Uninitialized = 0, Initializing = 1, Ready = 2 };
+
+  // Bookkeeping at the start of each slot. The key, then the value, of the entry follow it.
+  struct alignas(sizeof(uint64_t)) Slot {
+    // Odd while a writer updates the slot, in which case its upper half holds the pid of the
+    // writer. Only the lower half counts the updates.
+    std::atomic<uint64_t> sequence_;
+    // Hash of the key of the entry, or EmptyHash if the slot is empty.
+    std::atomic<uint64_t> hash_;
+    std::atomic<uint32_t> key_size_;
+    std::atomic<uint32_t> value_size_;
+    // Set by lookups, cleared by the CLOCK hand.
+    std::atomic<uint8_t> referenced_;
+
+    char* data() { return reinterpret_cast<char*>(this + 1); }
+  };
+
+  static constexpr uint64_t EmptyHash = 0;
+
+  // The sequence number of a slot once the process claims it, either released or left claimed by
+  // a process which is gone, and once it releases the slot it claimed.
+  uint64_t claimed(uint64_t sequence) const {
+    return static_cast<uint64_t>(pid_) << 32 | (static_cast<uint32_t>(sequence + 1) | 1);
+  }
+  static uint64_t released(uint64_t sequence) { return static_cast<uint32_t>(sequence + 1); }
+  // Whether a slot with the given odd sequence number was left claimed by a process which is gone.
+  bool abandoned(uint64_t sequence) const;
+
+  void initialize();
+  void awaitInitialization();
+  Slot& slot(uint64_t index) {
+    return *reinterpret_cast<Slot*>(slots_ + index * static_cast<uint64_t>(slot_size_));
+  }
+  // Pick the slot of set in which to insert an entry with the given hash.
+  Slot& victim(uint64_t set, uint64_t hash);
+  std::atomic<uint8_t>& clockHand(uint64_t set) { return clock_hands_[set]; }
+
+  Header* const header_;
+  const uint32_t pid_;
+  const uint32_t slot_size_;
+  const uint64_t slot_count_;
+  std::atomic<uint8_t>* const clock_hands_;
+  char* const slots_;
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -16,6 +16,8 @@ namespace DnsFilter {
 
 static constexpr std::chrono::milliseconds DEFAULT_RESOLVER_TIMEOUT{500};
 static constexpr std::chrono::seconds DEFAULT_RESOLVER_TTL{300};
+static constexpr uint64_t DEFAULT_RESPONSE_CACHE_MAX_ENTRIES = 1024;
+static constexpr std::chrono::seconds DEFAULT_RESPONSE_CACHE_NEGATIVE_TTL{30};
 
 DnsFilterEnvoyConfig::DnsFilterEnvoyConfig(
     Server::Configuration::ListenerFactoryContext& context,
@@ -151,6 +153,16 @@ DnsFilterEnvoyConfig::DnsFilterEnvoyConfig(
 
     max_pending_lookups_ = client_config.max_pending_lookups();
   }
+
+  cache_responses_ = config.has_response_cache();
+  if (cache_responses_) {
+    const auto& cache_config = config.response_cache();
+    response_cache_max_entries_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+        cache_config, max_entries, DEFAULT_RESPONSE_CACHE_MAX_ENTRIES);
+    response_cache_negative_ttl_ = cache_config.has_negative_ttl()
+                                       ? std::chrono::seconds(cache_config.negative_ttl().seconds())
+                                       : DEFAULT_RESPONSE_CACHE_NEGATIVE_TTL;
+  }
 }
 
 bool DnsFilterEnvoyConfig::loadServerConfig(
@@ -206,6 +218,11 @@ DnsFilter::DnsFilter(Network::UdpReadFilterCallbacks& callbacks,
       return;
     }
 
+    // A failed resolution may succeed on the next query, so its response is not cached
+    if (context->resolution_status_ != Network::DnsResolver::ResolutionStatus::Success) {
+      context->cache_key_.reset();
+    }
+
     config_->stats().externally_resolved_queries_.inc();
     if (iplist.empty()) {
       config_->stats().unanswered_queries_.inc();
@@ -223,12 +240,26 @@ DnsFilter::DnsFilter(Network::UdpReadFilterCallbacks& callbacks,
   resolver_ = std::make_unique<DnsFilterResolver>(resolver_callback_, config->resolvers(),
                                                   config->resolverTimeout(), listener_.dispatcher(),
                                                   config->maxPendingLookups());
+
+  if (config->cacheResponses()) {
+    response_cache_ = std::make_unique<DnsResponseCache>(listener_.dispatcher().timeSource(),
+                                                         config->responseCacheMaxEntries());
+  }
 }
 
 void DnsFilter::onData(Network::UdpRecvData& client_request) {
   config_->stats().downstream_rx_bytes_.recordValue(client_request.buffer_->length());
   config_->stats().downstream_rx_queries_.inc();
 
+  // Answer the query from the response cache if we responded to the same question before
+  absl::optional<std::string> cache_key;
+  if (response_cache_ != nullptr) {
+    cache_key = DnsResponseCache::keyForQuery(*client_request.buffer_);
+    if (cache_key.has_value() && sendCachedResponse(client_request, cache_key.value())) {
+      return;
+    }
+  }
+
   // Setup counters for the parser
   DnsParserCounters parser_counters(config_->stats().query_buffer_underflow_,
                                     config_->stats().record_name_overflow_,
@@ -244,6 +275,12 @@ void DnsFilter::onData(Network::UdpRecvData& client_request) {
     return;
   }
 
+  // Additional records are parsed from queries as answers, which could make their way into the
+  // response. Responses to queries carrying records other than OPT are therefore not cached
+  if (query_context->additional_.empty()) {
+    query_context->cache_key_ = std::move(cache_key);
+  }
+
   // Resolve the requested name and respond to the client. If the return code is
   // External, we will respond to the client when the upstream resolver returns
   if (getResponseForQuery(query_context) == DnsLookupResponseCode::External) {
@@ -260,6 +297,9 @@ void DnsFilter::sendDnsResponse(DnsQueryContextPtr query_context) {
   // Serializes the generated response to the parsed query from the client. If there is a
   // parsing error or the incoming query is invalid, we will still generate a valid DNS response
   message_parser_.buildResponseBuffer(query_context, response);
+  if (response_cache_ != nullptr && query_context->cache_key_.has_value()) {
+    cacheResponse(*query_context, response);
+  }
   config_->stats().downstream_tx_responses_.inc();
   config_->stats().downstream_tx_bytes_.recordValue(response.length());
   Network::UdpSendData response_data{query_context->local_->ip(), *(query_context->peer_),
@@ -267,6 +307,53 @@ void DnsFilter::sendDnsResponse(DnsQueryContextPtr query_context) {
   listener_.send(response_data);
 }
 
+bool DnsFilter::sendCachedResponse(const Network::UdpRecvData& client_request,
+                                   const std::string& cache_key) {
+  Buffer::OwnedImpl response;
+  if (!response_cache_->lookup(cache_key, client_request.buffer_->peekBEInt<uint16_t>(0),
+                               response)) {
+    config_->stats().response_cache_misses_.inc();
+    return false;
+  }
+
+  config_->stats().response_cache_hits_.inc();
+  incrementQueryTypeCount(DnsResponseCache::queryType(cache_key));
+  config_->stats().downstream_tx_responses_.inc();
+  config_->stats().downstream_tx_bytes_.recordValue(response.length());
+  Network::UdpSendData response_data{client_request.addresses_.local_->ip(),
+                                     *client_request.addresses_.peer_, response};
+  listener_.send(response_data);
+  return true;
+}
+
+void DnsFilter::cacheResponse(const DnsQueryContext& context, const Buffer::Instance& response) {
+  std::chrono::seconds ttl;
+  switch (context.response_code_) {
+  case DNS_RESPONSE_CODE_NO_ERROR:
+    // Each response to a name with more answers than we return starts at a random answer
+    if (context.answers_.size() > MAX_RETURNED_RECORDS) {
+      return;
+    }
+    ttl = std::chrono::seconds::max();
+    for (const auto& answer : context.answers_) {
+      ttl = std::min(ttl, answer.second->ttl_);
+    }
+    for (const auto& additional : context.additional_) {
+      ttl = std::min(ttl, additional.second->ttl_);
+    }
+    break;
+  case DNS_RESPONSE_CODE_NAME_ERROR:
+    ttl = config_->responseCacheNegativeTtl();
+    break;
+  default:
+    return;
+  }
+
+  if (ttl.count() > 0) {
+    response_cache_->insert(context.cache_key_.value(), response, ttl);
+  }
+}
+
 DnsLookupResponseCode DnsFilter::getResponseForQuery(DnsQueryContextPtr& context) {
   /* It appears to be a rare case where we would have more than one query in a single request.
    * It is allowed by the protocol but not widely supported:
@@ -281,8 +368,10 @@ DnsLookupResponseCode DnsFilter::getResponseForQuery(DnsQueryContextPtr& context
     // Try to resolve the query locally. If forwarding the query externally is disabled we will
     // always attempt to resolve with the configured domains
     if (isKnownDomain(query->name_) || !config_->forwardQueries()) {
-      // Determine whether the name is a cluster. Move on to the next query if successful
+      // Determine whether the name is a cluster. Move on to the next query if successful. The
+      // response is not cached as the cluster's hosts may change at any time
       if (resolveViaClusters(context, *query)) {
+        context->cache_key_.reset();
         continue;
       }
 
@@ -12,6 +12,7 @@
 
 #include "extensions/filters/udp/dns_filter/dns_filter_resolver.h"
 #include "extensions/filters/udp/dns_filter/dns_parser.h"
+#include "extensions/filters/udp/dns_filter/dns_response_cache.h"
 
 #include "absl/container/flat_hash_set.h"
 
@@ -52,6 +53,8 @@ namespace DnsFilter {
   COUNTER(query_buffer_underflow)                                                                  \
   COUNTER(query_parsing_failure)                                                                   \
   COUNTER(record_name_overflow)                                                                    \
+  COUNTER(response_cache_hits)                                                                     \
+  COUNTER(response_cache_misses)                                                                   \
   HISTOGRAM(downstream_rx_bytes, Bytes)                                                            \
   HISTOGRAM(downstream_rx_query_latency, Milliseconds)                                             \
   HISTOGRAM(downstream_tx_bytes, Bytes)
@@ -93,6 +96,9 @@ public:
   uint64_t retryCount() const { return retry_count_; }
   Random::RandomGenerator& random() const { return random_; }
   uint64_t maxPendingLookups() const { return max_pending_lookups_; }
+  bool cacheResponses() const { return cache_responses_; }
+  uint64_t responseCacheMaxEntries() const { return response_cache_max_entries_; }
+  std::chrono::seconds responseCacheNegativeTtl() const { return response_cache_negative_ttl_; }
 
 private:
   static DnsFilterStats generateStats(const std::string& stat_prefix, Stats::Scope& scope) {
@@ -120,6 +126,9 @@ private:
   std::chrono::milliseconds resolver_timeout_;
   Random::RandomGenerator& random_;
   uint64_t max_pending_lookups_;
+  bool cache_responses_;
+  uint64_t response_cache_max_entries_;
+  std::chrono::seconds response_cache_negative_ttl_;
 };
 
 using DnsFilterEnvoyConfigSharedPtr = std::shared_ptr<const DnsFilterEnvoyConfig>;
@@ -153,6 +162,25 @@ private:
    */
   void sendDnsResponse(DnsQueryContextPtr context);
 
+  /**
+   * @brief Sends the cached response to a query, if there is one
+   *
+   * @param client_request the query received from the client
+   * @param cache_key the response cache key of the query
+   * @return bool true if a cached response was sent
+   */
+  bool sendCachedResponse(const Network::UdpRecvData& client_request,
+                          const std::string& cache_key);
+
+  /**
+   * @brief Stores a response in the response cache for as long as its records are valid. Responses
+   * without answers are cached for the configured negative TTL.
+   *
+   * @param context the query context from which the response was built
+   * @param response the serialized response
+   */
+  void cacheResponse(const DnsQueryContext& context, const Buffer::Instance& response);
+
   /**
    * @brief Encapsulates all of the logic required to find an answer for a DNS query
    *
@@ -367,6 +395,7 @@ private:
   Network::Address::InstanceConstSharedPtr local_;
   Network::Address::InstanceConstSharedPtr peer_;
   DnsFilterResolverCallback resolver_callback_;
+  DnsResponseCachePtr response_cache_;
 };
 
 } // namespace DnsFilter
@@ -46,6 +46,7 @@ void DnsFilterResolver::resolveExternalQuery(DnsQueryContextPtr context,
         trace,
         "Retrying query for [{}] because there are too many pending lookups: [pending {}/max {}]",
         domain_query->name_, lookups_.size(), max_pending_lookups_);
+    ctx.query_context->resolution_status_ = Network::DnsResolver::ResolutionStatus::Failure;
     ctx.resolver_status = DnsFilterResolverStatus::Complete;
     invokeCallback(ctx);
     return;
@@ -14,6 +14,8 @@
 
 #include "extensions/filters/udp/dns_filter/dns_filter_constants.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace UdpFilters {
@@ -187,6 +189,8 @@ public:
   DnsAnswerMap answers_;
   DnsAnswerMap additional_;
   bool in_callback_;
+  // The response cache key of the query, set when the response may be cached
+  absl::optional<std::string> cache_key_;
 
   /**
    * @param context the query context for which we are querying the response code
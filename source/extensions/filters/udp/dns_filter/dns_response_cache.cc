@@ -0,0 +1,211 @@
+#include "extensions/filters/udp/dns_filter/dns_response_cache.h"
+
+#include "common/common/assert.h"
+
+#include "extensions/filters/udp/dns_filter/dns_filter_constants.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace DnsFilter {
+
+namespace {
+
+// The header holds the transaction ID, the flags and the four record counts, each 2 bytes wide.
+constexpr uint64_t DNS_HEADER_SIZE = 12;
+constexpr uint64_t FLAGS_OFFSET = 2;
+constexpr uint64_t QUESTIONS_OFFSET = 4;
+
+// Labels of compressed names start with the two high bits set.
+constexpr uint8_t COMPRESSED_LABEL_MASK = 0xC0;
+
+// A resource record is its name followed by the type, class, TTL and data length, then the data.
+constexpr uint64_t RECORD_TTL_OFFSET = 2 * sizeof(uint16_t);
+constexpr uint64_t RECORD_FIXED_SIZE = RECORD_TTL_OFFSET + sizeof(uint32_t) + sizeof(uint16_t);
+
+uint16_t readBEInt16(absl::string_view data, uint64_t offset) {
+  return static_cast<uint16_t>(static_cast<uint8_t>(data[offset]) << 8 |
+                               static_cast<uint8_t>(data[offset + 1]));
+}
+
+// Returns the offset past the name starting at the offset, or absl::nullopt if the name runs past
+// the end of the data.
+absl::optional<uint64_t> skipName(absl::string_view data, uint64_t offset) {
+  while (offset < data.size()) {
+    const uint8_t label_length = data[offset];
+    if (label_length == 0) {
+      return offset + 1;
+    }
+    if ((label_length & COMPRESSED_LABEL_MASK) == COMPRESSED_LABEL_MASK) {
+      // A pointer to the rest of the name ends it.
+      if (offset + sizeof(uint16_t) > data.size()) {
+        return absl::nullopt;
+      }
+      return offset + sizeof(uint16_t);
+    }
+    if ((label_length & COMPRESSED_LABEL_MASK) != 0) {
+      return absl::nullopt;
+    }
+    offset += label_length + 1;
+  }
+  return absl::nullopt;
+}
+
+} // namespace
+
+DnsResponseCache::DnsResponseCache(TimeSource& time_source, uint64_t max_entries)
+    : time_source_(time_source), max_entries_(max_entries) {
+  ASSERT(max_entries_ > 0);
+}
+
+absl::optional<std::string> DnsResponseCache::keyForQuery(Buffer::Instance& query) {
+  const uint64_t length = query.length();
+  if (length <= DNS_HEADER_SIZE) {
+    return absl::nullopt;
+  }
+
+  const uint16_t id = query.peekBEInt<uint16_t>(0);
+  const uint16_t questions = query.peekBEInt<uint16_t>(QUESTIONS_OFFSET);
+  const uint16_t answers = query.peekBEInt<uint16_t>(QUESTIONS_OFFSET + sizeof(uint16_t));
+  const uint16_t authority_rrs = query.peekBEInt<uint16_t>(QUESTIONS_OFFSET + 2 * sizeof(uint16_t));
+  if (id == 0 || questions != 1 || answers != 0 || authority_rrs != 0) {
+    return absl::nullopt;
+  }
+
+  // Received datagrams are held in a single slice, so this does not copy.
+  const auto* data = static_cast<const char*>(query.linearize(length));
+
+  // Walk the labels of the question's name up to the terminating empty label, which is followed
+  // by the record type and class.
+  uint64_t offset = DNS_HEADER_SIZE;
+  while (offset < length && data[offset] != 0) {
+    const uint8_t label_length = data[offset];
+    if ((label_length & COMPRESSED_LABEL_MASK) != 0) {
+      return absl::nullopt;
+    }
+    offset += label_length + 1;
+  }
+  const uint64_t question_end = offset + 1 + 2 * sizeof(uint16_t);
+  if (question_end > length) {
+    return absl::nullopt;
+  }
+
+  std::string key;
+  key.reserve(sizeof(uint16_t) + question_end - DNS_HEADER_SIZE);
+  key.append(data + FLAGS_OFFSET, sizeof(uint16_t));
+  key.append(data + DNS_HEADER_SIZE, question_end - DNS_HEADER_SIZE);
+  return key;
+}
+
+uint16_t DnsResponseCache::queryType(absl::string_view key) {
+  // The key ends with the record type and class of the question.
+  ASSERT(key.size() >= 2 * sizeof(uint16_t));
+  const size_t type_offset = key.size() - 2 * sizeof(uint16_t);
+  return static_cast<uint16_t>(static_cast<uint8_t>(key[type_offset]) << 8 |
+                               static_cast<uint8_t>(key[type_offset + 1]));
+}
+
+bool DnsResponseCache::lookup(const std::string& key, uint16_t id, Buffer::Instance& response) {
+  const auto entry = entries_.find(key);
+  if (entry == entries_.end()) {
+    return false;
+  }
+  if (entry->second.expiry <= time_source_.monotonicTime()) {
+    erase(entry);
+    return false;
+  }
+  lru_.splice(lru_.begin(), lru_, entry->second.lru_position);
+
+  // The cached response starts with the transaction ID of the query it was built for, and its
+  // records carry the TTLs they had when it was inserted. Count them down by the time the response
+  // has been cached for.
+  const std::string& cached = entry->second.response;
+  const uint64_t cached_seconds = std::chrono::duration_cast<std::chrono::seconds>(
+                                      time_source_.monotonicTime() - entry->second.inserted)
+                                      .count();
+  response.writeBEInt<uint16_t>(id);
+  uint64_t offset = sizeof(uint16_t);
+  for (const RecordTtl& ttl : entry->second.ttls) {
+    response.add(cached.data() + offset, ttl.offset - offset);
+    response.writeBEInt<uint32_t>(ttl.ttl > cached_seconds ? ttl.ttl - cached_seconds : 0);
+    offset = ttl.offset + sizeof(uint32_t);
+  }
+  response.add(cached.data() + offset, cached.size() - offset);
+  return true;
+}
+
+void DnsResponseCache::insert(const std::string& key, const Buffer::Instance& response,
+                              std::chrono::seconds ttl) {
+  ASSERT(response.length() > sizeof(uint16_t));
+  std::string serialized = response.toString();
+  std::vector<RecordTtl> ttls;
+  if (!findRecordTtls(serialized, ttls)) {
+    return;
+  }
+
+  const auto existing = entries_.find(key);
+  if (existing != entries_.end()) {
+    erase(existing);
+  } else if (entries_.size() >= max_entries_) {
+    erase(entries_.find(lru_.back()));
+  }
+
+  lru_.push_front(key);
+  Entry& entry = entries_[key];
+  entry.response = std::move(serialized);
+  entry.ttls = std::move(ttls);
+  entry.inserted = time_source_.monotonicTime();
+  entry.expiry = entry.inserted + ttl;
+  entry.lru_position = lru_.begin();
+}
+
+bool DnsResponseCache::findRecordTtls(absl::string_view response, std::vector<RecordTtl>& ttls) {
+  if (response.size() < DNS_HEADER_SIZE) {
+    return false;
+  }
+  const uint16_t questions = readBEInt16(response, QUESTIONS_OFFSET);
+  // The answer, authority and additional record counts follow the question count.
+  uint32_t records = 0;
+  for (uint64_t count_offset = QUESTIONS_OFFSET + sizeof(uint16_t); count_offset < DNS_HEADER_SIZE;
+       count_offset += sizeof(uint16_t)) {
+    records += readBEInt16(response, count_offset);
+  }
+
+  uint64_t offset = DNS_HEADER_SIZE;
+  for (uint16_t i = 0; i < questions; ++i) {
+    const absl::optional<uint64_t> name_end = skipName(response, offset);
+    if (!name_end.has_value()) {
+      return false;
+    }
+    offset = name_end.value() + 2 * sizeof(uint16_t);
+  }
+
+  for (uint32_t i = 0; i < records; ++i) {
+    const absl::optional<uint64_t> name_end = skipName(response, offset);
+    if (!name_end.has_value() || name_end.value() + RECORD_FIXED_SIZE > response.size()) {
+      return false;
+    }
+    offset = name_end.value();
+    // The TTL field of an OPT pseudo-record holds the extended response code and flags.
+    if (readBEInt16(response, offset) != DNS_RECORD_TYPE_OPT) {
+      const uint64_t ttl_offset = offset + RECORD_TTL_OFFSET;
+      const uint32_t ttl = static_cast<uint32_t>(readBEInt16(response, ttl_offset)) << 16 |
+                           readBEInt16(response, ttl_offset + sizeof(uint16_t));
+      ttls.push_back({ttl_offset, ttl});
+    }
+    const uint16_t data_length =
+        readBEInt16(response, offset + RECORD_FIXED_SIZE - sizeof(uint16_t));
+    offset += RECORD_FIXED_SIZE + data_length;
+  }
+  return offset <= response.size();
+}
+
+void DnsResponseCache::erase(absl::flat_hash_map<std::string, Entry>::iterator entry) {
+  lru_.erase(entry->second.lru_position);
+  entries_.erase(entry);
+}
+
+} // namespace DnsFilter
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/time.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace DnsFilter {
+
+/**
+ * This class caches the responses sent by a filter instance, ready to be sent again. A response is
+ * keyed by the header flags and the question of the query it answers, which determine the response
+ * up to its transaction ID and TTLs, so that a query can be answered from the cache without being
+ * parsed. The TTLs of the records of a cached response are counted down by the time it has been
+ * cached for. Entries expire after the TTL they were inserted with, and the least recently used
+ * entry is evicted once the cache is full. The cache is not thread safe, each worker has its own.
+ */
+class DnsResponseCache {
+public:
+  DnsResponseCache(TimeSource& time_source, uint64_t max_entries);
+
+  /**
+   * @param query the datagram received from a client
+   * @return the key of the response to the query if it has a transaction ID, a single question
+   * whose name is not compressed, and neither answer nor authority records
+   */
+  static absl::optional<std::string> keyForQuery(Buffer::Instance& query);
+
+  /**
+   * @param key a key returned by keyForQuery()
+   * @return uint16_t the type of the record requested by the query the key was built from
+   */
+  static uint16_t queryType(absl::string_view key);
+
+  /**
+   * @brief Retrieves the unexpired response for a key and marks it as the most recently used
+   *
+   * @param key the key of the response
+   * @param id the transaction ID of the query being answered, which is written into the response
+   * @param response the buffer to which the response is added
+   * @return bool true if a response was found
+   */
+  bool lookup(const std::string& key, uint16_t id, Buffer::Instance& response);
+
+  /**
+   * @brief Stores the response for a key, replacing any response already stored for it. Responses
+   * whose records can't be walked are not stored.
+   *
+   * @param key the key of the response
+   * @param response the serialized response
+   * @param ttl how long the response may be sent from the cache
+   */
+  void insert(const std::string& key, const Buffer::Instance& response, std::chrono::seconds ttl);
+
+  /**
+   * @return size_t the number of responses in the cache, including expired ones not yet evicted
+   */
+  size_t size() const { return entries_.size(); }
+
+private:
+  using LruList = std::list<std::string>;
+
+  // The TTL field of a record of a cached response, and the TTL it held on insertion.
+  struct RecordTtl {
+    uint64_t offset;
+    uint32_t ttl;
+  };
+
+  struct Entry {
+    std::string response;
+    // In the order of their offsets.
+    std::vector<RecordTtl> ttls;
+    MonotonicTime inserted;
+    MonotonicTime expiry;
+    LruList::iterator lru_position;
+  };
+
+  // Appends the TTL fields of the records of a response to ttls, and returns false if the records
+  // run past the end of the response.
+  static bool findRecordTtls(absl::string_view response, std::vector<RecordTtl>& ttls);
+  void erase(absl::flat_hash_map<std::string, Entry>::iterator entry);
+
+  TimeSource& time_source_;
+  const uint64_t max_entries_;
+  absl::flat_hash_map<std::string, Entry> entries_;
+  // The keys of the entries, from the most to the least recently used.
+  LruList lru_;
+};
+
+using DnsResponseCachePtr = std::unique_ptr<DnsResponseCache>;
+
+} // namespace DnsFilter
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
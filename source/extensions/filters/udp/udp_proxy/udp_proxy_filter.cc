@@ -1,7 +1,9 @@
 #include "extensions/filters/udp/udp_proxy/udp_proxy_filter.h"
 
 #include "envoy/network/listener.h"
+#include "envoy/network/udp_packet_writer_config.h"
 
+#include "common/config/utility.h"
 #include "common/network/socket_option_factory.h"
 
 namespace Envoy {
@@ -9,6 +11,23 @@ namespace Extensions {
 namespace UdpFilters {
 namespace UdpProxy {
 
+Network::UdpPacketWriterFactoryPtr UdpProxyFilterConfig::buildUpstreamWriterFactory(
+    const envoy::extensions::filters::udp::udp_proxy::v3::UdpProxyConfig& config,
+    ProtobufMessage::ValidationVisitor& validation_visitor) {
+  auto writer_config = config.upstream_writer_config();
+  if (!Api::OsSysCallsSingleton::get().supportsUdpGso() ||
+      writer_config.typed_config().type_url().empty()) {
+    const std::string default_type_url =
+        "type.googleapis.com/envoy.config.listener.v3.UdpDefaultWriterOptions";
+    writer_config.mutable_typed_config()->set_type_url(default_type_url);
+  }
+  auto& config_factory =
+      Config::Utility::getAndCheckFactory<Network::UdpPacketWriterConfigFactory>(writer_config);
+  ProtobufTypes::MessagePtr message = Config::Utility::translateAnyToFactoryConfig(
+      writer_config.typed_config(), validation_visitor, config_factory);
+  return config_factory.createUdpPacketWriterFactory(*message);
+}
+
 UdpProxyFilter::UdpProxyFilter(Network::UdpReadFilterCallbacks& callbacks,
                                const UdpProxyFilterConfigSharedPtr& config)
     : UdpListenerReadFilter(callbacks), config_(config),
@@ -82,6 +101,7 @@ UdpProxyFilter::ClusterInfo::~ClusterInfo() {
     removeSession(sessions_.begin()->get());
   }
   ASSERT(host_to_sessions_.empty());
+  ASSERT(sessions_to_flush_.empty());
 }
 
 void UdpProxyFilter::ClusterInfo::onData(Network::UdpRecvData& data) {
@@ -139,6 +159,29 @@ UdpProxyFilter::ClusterInfo::createSession(Network::UdpRecvData::LocalPeerAddres
   return new_session_ptr;
 }
 
+void UdpProxyFilter::ClusterInfo::scheduleFlush(ActiveSession& session) {
+  if (flush_cb_ == nullptr) {
+    flush_cb_ = filter_.read_callbacks_->udpListener().dispatcher().createSchedulableCallback(
+        [this]() { onFlush(); });
+  }
+  sessions_to_flush_.insert(&session);
+  // The listener hands all the datagrams of a read event to the filter before this runs, so the
+  // datagrams each session forwards during the event are sent together.
+  flush_cb_->scheduleCallbackCurrentIteration();
+}
+
+void UdpProxyFilter::ClusterInfo::cancelFlush(ActiveSession& session) {
+  sessions_to_flush_.erase(&session);
+}
+
+void UdpProxyFilter::ClusterInfo::onFlush() {
+  absl::flat_hash_set<ActiveSession*> sessions_to_flush;
+  sessions_to_flush.swap(sessions_to_flush_);
+  for (ActiveSession* session : sessions_to_flush) {
+    session->flush();
+  }
+}
+
 void UdpProxyFilter::ClusterInfo::removeSession(const ActiveSession* session) {
   // First remove from the host to sessions map.
   ASSERT(host_to_sessions_[&session->host()].count(session) == 1);
@@ -162,12 +205,21 @@ UdpProxyFilter::ActiveSession::ActiveSession(ClusterInfo& cluster,
           [this] { onIdleTimer(); })),
       // NOTE: The socket call can only fail due to memory/fd exhaustion. No local ephemeral port
       //       is bound until the first packet is sent to the upstream host.
-      socket_(cluster.filter_.createSocket(host)) {
+      socket_(cluster.filter_.createSocket(host)),
+      writer_(cluster.filter_.config_->upstreamWriterFactory().createUdpPacketWriter(
+          socket_->ioHandle(), cluster.filter_.config_->upstreamWriterScope())) {
 
   socket_->ioHandle().initializeFileEvent(
       cluster.filter_.read_callbacks_->udpListener().dispatcher(),
-      [this](uint32_t) { onReadReady(); }, Event::PlatformDefaultTriggerType,
-      Event::FileReadyType::Read);
+      [this](uint32_t events) {
+        if (events & Event::FileReadyType::Write) {
+          onWriteReady();
+        }
+        if (events & Event::FileReadyType::Read) {
+          onReadReady();
+        }
+      },
+      Event::PlatformDefaultTriggerType, Event::FileReadyType::Read);
   ENVOY_LOG(debug, "creating new session: downstream={} local={} upstream={}",
             addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host->address()->asStringView());
@@ -189,6 +241,19 @@ UdpProxyFilter::ActiveSession::ActiveSession(ClusterInfo& cluster,
               addresses_.peer_->asStringView());
   }
 
+  if (Api::OsSysCallsSingleton::get().supportsUdpGro()) {
+    // Lets the kernel coalesce the datagrams received from the upstream host, so that
+    // readPacketsFromSocket() gets several of them from a single system call.
+    const Network::Socket::OptionsSharedPtr socket_options =
+        Network::SocketOptionFactory::buildUdpGroOptions();
+    const bool ok = Network::Socket::applyOptions(
+        socket_options, *socket_, envoy::config::core::v3::SocketOption::STATE_BOUND);
+    if (!ok) {
+      ENVOY_LOG(debug, "failed to enable UDP_GRO for the session: downstream={} upstream={}",
+                addresses_.peer_->asStringView(), host->address()->asStringView());
+    }
+  }
+
   // TODO(mattklein123): Enable dropped packets socket option. In general the Socket abstraction
   // does not work well right now for client sockets. It's too heavy weight and is aimed at listener
   // sockets. We need to figure out how to either refactor Socket into something that works better
@@ -200,6 +265,12 @@ UdpProxyFilter::ActiveSession::~ActiveSession() {
   ENVOY_LOG(debug, "deleting the session: downstream={} local={} upstream={}",
             addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host_->address()->asStringView());
+  if (writer_->isBatchMode()) {
+    cluster_.cancelFlush(*this);
+    // Make a last attempt at sending the datagrams even if an earlier flush was blocked.
+    writer_->setWritable();
+    flush();
+  }
   cluster_.filter_.config_->stats().downstream_sess_active_.dec();
   cluster_.cluster_.info()
       ->resourceManager(Upstream::ResourcePriority::Default)
@@ -231,6 +302,13 @@ void UdpProxyFilter::ActiveSession::onReadReady() {
   cluster_.filter_.read_callbacks_->udpListener().flush();
 }
 
+void UdpProxyFilter::ActiveSession::onWriteReady() {
+  ASSERT(writer_->isBatchMode());
+  socket_->ioHandle().enableFileEvents(Event::FileReadyType::Read);
+  writer_->setWritable();
+  flush();
+}
+
 void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
   ENVOY_LOG(trace, "writing {} byte datagram upstream: downstream={} local={} upstream={}",
             buffer.length(), addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
@@ -241,22 +319,61 @@ void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
 
   idle_timer_->enableTimer(cluster_.filter_.config_->sessionTimeout());
 
+  if (writer_->isWriteBlocked()) {
+    // A batch mode writer is still holding datagrams for a socket which is not writable yet. This
+    // datagram is dropped rather than queued behind them.
+    ASSERT(writer_->isBatchMode());
+    cluster_.cluster_stats_.sess_tx_errors_.inc();
+    return;
+  }
+
   // NOTE: On the first write, a local ephemeral port is bound, and thus this write can fail due to
   //       port exhaustion.
   // NOTE: We do not specify the local IP to use for the sendmsg call if use_original_src_ip_ is not
   //       set. We allow the OS to select the right IP based on outbound routing rules if
   //       use_original_src_ip_ is not set, else use downstream peer IP as local IP.
   const Network::Address::Ip* local_ip = use_original_src_ip_ ? addresses_.peer_->ip() : nullptr;
-  Api::IoCallUint64Result rc =
-      Network::Utility::writeToSocket(socket_->ioHandle(), buffer, local_ip, *host_->address());
+  const Api::IoCallUint64Result rc = writer_->writePacket(buffer, local_ip, *host_->address());
+  if (writer_->isWriteBlocked()) {
+    if (writer_->isBatchMode()) {
+      // The writer keeps the datagrams it buffered until the socket becomes writable again.
+      waitForWritable();
+    } else {
+      // Datagrams which cannot be sent right away are dropped rather than waiting for the socket
+      // to become writable.
+      writer_->setWritable();
+    }
+  }
   if (!rc.ok()) {
     cluster_.cluster_stats_.sess_tx_errors_.inc();
   } else {
     cluster_.cluster_stats_.sess_tx_datagrams_.inc();
     cluster_.cluster_.info()->stats().upstream_cx_tx_bytes_total_.add(buffer_length);
+    if (writer_->isBatchMode() && !writer_->isWriteBlocked()) {
+      cluster_.scheduleFlush(*this);
+    }
   }
 }
 
+void UdpProxyFilter::ActiveSession::flush() {
+  if (writer_->isWriteBlocked()) {
+    // onWriteReady() flushes once the socket becomes writable.
+    return;
+  }
+  const Api::IoCallUint64Result rc = writer_->flush();
+  if (writer_->isWriteBlocked()) {
+    waitForWritable();
+  } else if (!rc.ok()) {
+    cluster_.cluster_stats_.sess_tx_errors_.inc();
+  }
+}
+
+void UdpProxyFilter::ActiveSession::waitForWritable() {
+  ENVOY_LOG(trace, "upstream socket is write blocked: downstream={} upstream={}",
+            addresses_.peer_->asStringView(), host_->address()->asStringView());
+  socket_->ioHandle().enableFileEvents(Event::FileReadyType::Read | Event::FileReadyType::Write);
+}
+
 void UdpProxyFilter::ActiveSession::processPacket(Network::Address::InstanceConstSharedPtr,
                                                   Network::Address::InstanceConstSharedPtr,
                                                   Buffer::InstancePtr buffer, MonotonicTime) {
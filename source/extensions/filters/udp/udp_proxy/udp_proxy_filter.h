@@ -1,9 +1,11 @@
 #pragma once
 
 #include "envoy/event/file_event.h"
+#include "envoy/event/schedulable_cb.h"
 #include "envoy/event/timer.h"
 #include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.h"
 #include "envoy/network/filter.h"
+#include "envoy/network/udp_packet_writer_handler.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/api/os_sys_calls_impl.h"
@@ -65,11 +67,15 @@ class UdpProxyFilterConfig {
 public:
   UdpProxyFilterConfig(Upstream::ClusterManager& cluster_manager, TimeSource& time_source,
                        Stats::Scope& root_scope,
-                       const envoy::extensions::filters::udp::udp_proxy::v3::UdpProxyConfig& config)
+                       const envoy::extensions::filters::udp::udp_proxy::v3::UdpProxyConfig& config,
+                       ProtobufMessage::ValidationVisitor& validation_visitor)
       : cluster_manager_(cluster_manager), time_source_(time_source), cluster_(config.cluster()),
         session_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(config, idle_timeout, 60 * 1000)),
         use_original_src_ip_(config.use_original_src_ip()),
-        stats_(generateStats(config.stat_prefix(), root_scope)) {
+        stats_(generateStats(config.stat_prefix(), root_scope)),
+        upstream_writer_scope_(root_scope.createScope(
+            absl::StrCat("udp.", config.stat_prefix(), ".upstream_writer."))),
+        upstream_writer_factory_(buildUpstreamWriterFactory(config, validation_visitor)) {
     if (use_original_src_ip_ && !Api::OsSysCallsSingleton::get().supportsIpTransparent()) {
       ExceptionUtil::throwEnvoyException(
           "The platform does not support either IP_TRANSPARENT or IPV6_TRANSPARENT. Or the envoy "
@@ -87,8 +93,15 @@ public:
   const Udp::HashPolicy* hashPolicy() const { return hash_policy_.get(); }
   UdpProxyDownstreamStats& stats() const { return stats_; }
   TimeSource& timeSource() const { return time_source_; }
+  Network::UdpPacketWriterFactory& upstreamWriterFactory() const {
+    return *upstream_writer_factory_;
+  }
+  Stats::Scope& upstreamWriterScope() const { return *upstream_writer_scope_; }
 
 private:
+  static Network::UdpPacketWriterFactoryPtr buildUpstreamWriterFactory(
+      const envoy::extensions::filters::udp::udp_proxy::v3::UdpProxyConfig& config,
+      ProtobufMessage::ValidationVisitor& validation_visitor);
   static UdpProxyDownstreamStats generateStats(const std::string& stat_prefix,
                                                Stats::Scope& scope) {
     const auto final_prefix = absl::StrCat("udp.", stat_prefix);
@@ -103,6 +116,8 @@ private:
   const bool use_original_src_ip_;
   std::unique_ptr<const HashPolicyImpl> hash_policy_;
   mutable UdpProxyDownstreamStats stats_;
+  const Stats::ScopePtr upstream_writer_scope_;
+  const Network::UdpPacketWriterFactoryPtr upstream_writer_factory_;
 };
 
 using UdpProxyFilterConfigSharedPtr = std::shared_ptr<const UdpProxyFilterConfig>;
@@ -155,10 +170,16 @@ private:
     const Network::UdpRecvData::LocalPeerAddresses& addresses() const { return addresses_; }
     const Upstream::Host& host() const { return *host_; }
     void write(const Buffer::Instance& buffer);
+    // Sends the datagrams buffered by a batch mode writer. If the socket is not writable, the
+    // datagrams stay buffered and are sent when it becomes writable again.
+    void flush();
 
   private:
     void onIdleTimer();
     void onReadReady();
+    void onWriteReady();
+    // Watches the socket for writability so that a blocked batch mode writer can be flushed.
+    void waitForWritable();
 
     // Network::UdpPacketProcessor
     void processPacket(Network::Address::InstanceConstSharedPtr local_address,
@@ -185,6 +206,9 @@ private:
     // packets from the upstream host. Note that a a local ephemeral port is bound on the first
     // write to the upstream host.
     const Network::SocketPtr socket_;
+    // Writes the datagrams to the upstream host through socket_. A batch mode writer buffers
+    // them until the session is flushed at the end of the current event loop iteration.
+    const Network::UdpPacketWriterPtr writer_;
   };
 
   using ActiveSessionPtr = std::unique_ptr<ActiveSession>;
@@ -236,6 +260,10 @@ private:
     ~ClusterInfo();
     void onData(Network::UdpRecvData& data);
     void removeSession(const ActiveSession* session);
+    // Schedules a flush of the session's writer once all the datagrams received in the current
+    // event loop iteration have been written.
+    void scheduleFlush(ActiveSession& session);
+    void cancelFlush(ActiveSession& session);
 
     UdpProxyFilter& filter_;
     Upstream::ThreadLocalCluster& cluster_;
@@ -244,6 +272,7 @@ private:
   private:
     ActiveSession* createSession(Network::UdpRecvData::LocalPeerAddresses&& addresses,
                                  const Upstream::HostConstSharedPtr& host);
+    void onFlush();
     static UdpProxyUpstreamStats generateStats(Stats::Scope& scope) {
       const auto final_prefix = "udp";
       return {ALL_UDP_PROXY_UPSTREAM_STATS(POOL_COUNTER_PREFIX(scope, final_prefix))};
@@ -255,6 +284,9 @@ private:
         sessions_;
     absl::flat_hash_map<const Upstream::Host*, absl::flat_hash_set<const ActiveSession*>>
         host_to_sessions_;
+    // Created on the first write of a batch mode writer.
+    Event::SchedulableCallbackPtr flush_cb_;
+    absl::flat_hash_set<ActiveSession*> sessions_to_flush_;
   };
 
   virtual Network::SocketPtr createSocket(const Upstream::HostConstSharedPtr& host) {
@@ -0,0 +1,581 @@
+#include "extensions/network/socket_interface/io_uring/io_uring_socket_handle_impl.h"
+
+#include <poll.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "envoy/common/exception.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/utility.h"
+#include "common/network/io_socket_error_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+IoUringSocketHandleImpl::IoUringSocketHandleImpl(const RingOptions& options, os_fd_t fd,
+                                                 bool socket_v6only, absl::optional<int> domain,
+                                                 bool connected)
+    : IoSocketHandleImpl(fd, socket_v6only, domain), options_(options), connected_(connected),
+      read_limit_(options.buffer_size_) {}
+
+IoUringSocketHandleImpl::~IoUringSocketHandleImpl() {
+  if (SOCKET_VALID(fd_)) {
+    IoUringSocketHandleImpl::close();
+  }
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::close() {
+  if (worker_ == nullptr) {
+    return IoSocketHandleImpl::close();
+  }
+  ASSERT(SOCKET_VALID(fd_));
+
+  for (Request** request : {&read_in_flight_, &accept_in_flight_, &poll_in_flight_}) {
+    if (*request != nullptr) {
+      worker_->cancel(**request);
+      *request = nullptr;
+    }
+  }
+  reads_.clear();
+  read_bytes_ = 0;
+  for (const RequestPtr& request : accepted_) {
+    Api::OsSysCallsSingleton::get().close(request->accepted_fd_);
+  }
+  accepted_.clear();
+  cb_ = nullptr;
+  enabled_events_ = 0;
+  ready_cb_.reset();
+
+  if (write_in_flight_ != nullptr) {
+    // Data accepted by writev() must still reach the peer: the worker keeps writing it after the
+    // handle is gone.
+    for (RequestPtr& request : writes_) {
+      request->handle_ = nullptr;
+    }
+    write_in_flight_->handle_ = nullptr;
+    write_in_flight_->chained_writes_ = std::move(writes_);
+    write_in_flight_ = nullptr;
+    writes_.clear();
+  }
+  ASSERT(writes_.empty());
+  worker_->closeSocket(fd_);
+  SET_SOCKET_INVALID(fd_);
+  return Api::ioCallUint64ResultNoError();
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::readv(uint64_t max_length,
+                                                       Buffer::RawSlice* slices,
+                                                       uint64_t num_slice) {
+  if (worker_ == nullptr) {
+    return IoSocketHandleImpl::readv(max_length, slices, num_slice);
+  }
+  if (read_bytes_ == 0) {
+    return receiveError();
+  }
+  const uint64_t bytes = copyReceived(slices, num_slice, max_length, false);
+  return {bytes, Api::IoErrorPtr(nullptr, Envoy::Network::IoSocketError::deleteIoError)};
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::read(Buffer::Instance& buffer,
+                                                      uint64_t max_length) {
+  if (worker_ == nullptr) {
+    return IoSocketHandleImpl::read(buffer, max_length);
+  }
+  if (max_length == 0) {
+    return Api::ioCallUint64ResultNoError();
+  }
+  if (read_bytes_ == 0) {
+    return receiveError();
+  }
+  uint64_t bytes = 0;
+  while (!reads_.empty() && bytes < max_length) {
+    RequestPtr& request = reads_.front();
+    const uint64_t length = std::min<uint64_t>(request->length(), max_length - bytes);
+    if (length < request->length()) {
+      // Only part of the read fits: copy it, and keep the rest for the next call.
+      buffer.add(request->data(), length);
+      request->offset_ += length;
+    } else {
+      buffer.addBufferFragment(worker_->fragment(std::move(request)));
+      reads_.pop_front();
+    }
+    bytes += length;
+  }
+  read_bytes_ -= bytes;
+  maybeRead();
+  return {bytes, Api::IoErrorPtr(nullptr, Envoy::Network::IoSocketError::deleteIoError)};
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::writev(const Buffer::RawSlice* slices,
+                                                        uint64_t num_slice) {
+  if (worker_ == nullptr) {
+    return IoSocketHandleImpl::writev(slices, num_slice);
+  }
+  if (write_errno_ != 0) {
+    return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, write_errno_});
+  }
+
+  uint64_t requested = 0;
+  for (uint64_t i = 0; i < num_slice; ++i) {
+    if (slices[i].mem_ != nullptr) {
+      requested += slices[i].len_;
+    }
+  }
+  uint64_t bytes = 0;
+  if (connected_ && !connecting_) {
+    for (uint64_t i = 0; i < num_slice; ++i) {
+      const uint8_t* data = static_cast<const uint8_t*>(slices[i].mem_);
+      uint64_t remaining = slices[i].mem_ != nullptr ? slices[i].len_ : 0;
+      Request* request;
+      while (remaining > 0 && (request = queuedWrite()) != nullptr) {
+        const uint64_t length =
+            std::min<uint64_t>(remaining, request->capacity() - request->write_data_.length());
+        request->write_data_.add(data, length);
+        data += length;
+        remaining -= length;
+        bytes += length;
+      }
+      if (remaining > 0) {
+        break;
+      }
+    }
+    submitWrite();
+  }
+  return writeResult(bytes, bytes < requested);
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::write(Buffer::Instance& buffer) {
+  if (worker_ == nullptr) {
+    return IoSocketHandleImpl::write(buffer);
+  }
+  if (write_errno_ != 0) {
+    return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, write_errno_});
+  }
+
+  uint64_t bytes = 0;
+  if (connected_ && !connecting_) {
+    // Whole slices are moved, so a queued write may hold more than its capacity.
+    Request* request;
+    while (buffer.length() > 0 && (request = queuedWrite()) != nullptr) {
+      const uint64_t length = buffer.frontSlice().len_;
+      request->write_data_.move(buffer, length);
+      bytes += length;
+    }
+    submitWrite();
+  }
+  return writeResult(bytes, buffer.length() > 0);
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::recv(void* buffer, size_t length, int flags) {
+  if (worker_ == nullptr) {
+    return IoSocketHandleImpl::recv(buffer, length, flags);
+  }
+  const bool peek = (flags & MSG_PEEK) != 0;
+  if (peek && length > read_bytes_) {
+    // The caller waits for more data before consuming any, so read it ahead.
+    read_limit_ = std::max<uint64_t>(read_limit_, length);
+    maybeRead();
+  }
+  if (read_bytes_ == 0) {
+    return receiveError();
+  }
+  Buffer::RawSlice slice{buffer, length};
+  const uint64_t bytes = copyReceived(&slice, 1, length, peek);
+  return {bytes, Api::IoErrorPtr(nullptr, Envoy::Network::IoSocketError::deleteIoError)};
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::listen(int backlog) {
+  listening_ = true;
+  return IoSocketHandleImpl::listen(backlog);
+}
+
+Envoy::Network::IoHandlePtr IoUringSocketHandleImpl::accept(struct sockaddr* addr,
+                                                            socklen_t* addrlen) {
+  if (worker_ == nullptr) {
+    auto result = Api::OsSysCallsSingleton::get().accept(fd_, addr, addrlen);
+    if (SOCKET_INVALID(result.rc_)) {
+      return nullptr;
+    }
+    return std::make_unique<IoUringSocketHandleImpl>(options_, result.rc_, socket_v6only_, domain_,
+                                                     true);
+  }
+  if (accepted_.empty()) {
+    maybeAccept();
+    return nullptr;
+  }
+  RequestPtr request = std::move(accepted_.front());
+  accepted_.pop_front();
+  maybeAccept();
+  if (addr != nullptr && addrlen != nullptr) {
+    memcpy(addr, &request->addr_, std::min(*addrlen, request->addr_len_));
+    *addrlen = request->addr_len_;
+  }
+  return std::make_unique<IoUringSocketHandleImpl>(options_, request->accepted_fd_,
+                                                   socket_v6only_, domain_, true);
+}
+
+Api::SysCallIntResult
+IoUringSocketHandleImpl::connect(Envoy::Network::Address::InstanceConstSharedPtr address) {
+  const Api::SysCallIntResult result = IoSocketHandleImpl::connect(address);
+  if (result.rc_ == 0) {
+    connected_ = true;
+    maybeRead();
+    signal(Event::FileReadyType::Write);
+  } else if (result.errno_ == SOCKET_ERROR_IN_PROGRESS) {
+    connecting_ = true;
+    maybePoll();
+  }
+  return result;
+}
+
+Envoy::Network::IoHandlePtr IoUringSocketHandleImpl::duplicate() {
+  auto result = Api::OsSysCallsSingleton::get().duplicate(fd_);
+  RELEASE_ASSERT(result.rc_ != -1, fmt::format("duplicate failed for '{}': ({}) {}", fd_,
+                                               result.errno_, errorDetails(result.errno_)));
+  return std::make_unique<IoUringSocketHandleImpl>(options_, result.rc_, socket_v6only_, domain_,
+                                                   connected_);
+}
+
+void IoUringSocketHandleImpl::initializeFileEvent(Event::Dispatcher& dispatcher,
+                                                  Event::FileReadyCb cb,
+                                                  Event::FileTriggerType trigger,
+                                                  uint32_t events) {
+  if (worker_ == nullptr) {
+    try {
+      worker_ = Worker::get(dispatcher, options_);
+    } catch (const EnvoyException& e) {
+      ENVOY_LOG(warn, "io_uring unavailable, using readiness based I/O: {}", e.what());
+      IoSocketHandleImpl::initializeFileEvent(dispatcher, cb, trigger, events);
+      return;
+    }
+  }
+  ASSERT(&worker_->dispatcher() == &dispatcher);
+  ASSERT(cb_ == nullptr, "Attempting to initialize two file events for the same socket.");
+  cb_ = cb;
+  trigger_ = trigger;
+  ready_cb_ = dispatcher.createSchedulableCallback([this]() { onReady(); });
+  enableFileEvents(events);
+}
+
+void IoUringSocketHandleImpl::activateFileEvents(uint32_t events) {
+  if (worker_ == nullptr) {
+    IoSocketHandleImpl::activateFileEvents(events);
+    return;
+  }
+  activated_events_ |= events;
+  signal(0);
+}
+
+void IoUringSocketHandleImpl::enableFileEvents(uint32_t events) {
+  if (worker_ == nullptr) {
+    IoSocketHandleImpl::enableFileEvents(events);
+    return;
+  }
+  enabled_events_ = events;
+  if (poll_in_flight_ != nullptr && !connecting_ && (events & Event::FileReadyType::Read)) {
+    // Reads detect the peer closing by themselves.
+    worker_->cancel(*poll_in_flight_);
+    poll_in_flight_ = nullptr;
+  }
+  maybeRead();
+  maybeAccept();
+  maybePoll();
+  // As with epoll, events which are ready fire when they are enabled.
+  signal(readyEvents() & events);
+}
+
+void IoUringSocketHandleImpl::resetFileEvents() {
+  if (worker_ == nullptr) {
+    IoSocketHandleImpl::resetFileEvents();
+    return;
+  }
+  // Operations in flight carry on, and their results are kept for the next owner of the socket.
+  cb_ = nullptr;
+  enabled_events_ = 0;
+  ready_events_ = 0;
+  activated_events_ = 0;
+  ready_cb_.reset();
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::shutdown(int how) {
+  if (worker_ != nullptr && how != ENVOY_SHUT_RD && write_in_flight_ != nullptr) {
+    // Shut down once the data accepted by writev() has been written.
+    shutdown_how_ = how;
+    return {0, 0};
+  }
+  return IoSocketHandleImpl::shutdown(how);
+}
+
+void IoUringSocketHandleImpl::onCompletion(RequestPtr request, int32_t result) {
+  switch (request->type_) {
+  case Request::Type::Read:
+    onReadCompletion(std::move(request), result);
+    break;
+  case Request::Type::Write:
+    onWriteCompletion(std::move(request), result);
+    break;
+  case Request::Type::Accept:
+    onAcceptCompletion(std::move(request), result);
+    break;
+  case Request::Type::Poll:
+    onPollCompletion(std::move(request), result);
+    break;
+  case Request::Type::Cancel:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+}
+
+void IoUringSocketHandleImpl::onReadCompletion(RequestPtr request, int32_t result) {
+  ASSERT(request.get() == read_in_flight_);
+  read_in_flight_ = nullptr;
+  if (result > 0) {
+    request->length_ = result;
+    read_bytes_ += result;
+    reads_.push_back(std::move(request));
+  } else if (result == 0) {
+    read_end_stream_ = true;
+  } else if (result != -SOCKET_ERROR_AGAIN && result != -SOCKET_ERROR_INTR) {
+    read_errno_ = -result;
+  }
+  maybeRead();
+  signal(readyEvents() & (Event::FileReadyType::Read | Event::FileReadyType::Closed));
+}
+
+void IoUringSocketHandleImpl::onWriteCompletion(RequestPtr request, int32_t result) {
+  ASSERT(request.get() == write_in_flight_);
+  write_in_flight_ = nullptr;
+  if (result < 0 && result != -SOCKET_ERROR_AGAIN && result != -SOCKET_ERROR_INTR) {
+    write_errno_ = -result;
+    writes_.clear();
+    shutdown_how_.reset();
+    signal(Event::FileReadyType::Write);
+    return;
+  }
+  if (result > 0) {
+    request->write_data_.drain(result);
+  }
+  if (request->write_data_.length() > 0) {
+    // A short write: the socket buffer is full.
+    write_in_flight_ = request.get();
+    worker_->submit(std::move(request));
+    return;
+  }
+  request.reset();
+  submitWrite();
+  if (write_in_flight_ == nullptr && shutdown_how_.has_value()) {
+    IoSocketHandleImpl::shutdown(shutdown_how_.value());
+    shutdown_how_.reset();
+  }
+  if (write_blocked_) {
+    write_blocked_ = false;
+    signal(Event::FileReadyType::Write);
+  }
+}
+
+void IoUringSocketHandleImpl::onAcceptCompletion(RequestPtr request, int32_t result) {
+  ASSERT(request.get() == accept_in_flight_);
+  accept_in_flight_ = nullptr;
+  if (result >= 0) {
+    request->accepted_fd_ = result;
+    accepted_.push_back(std::move(request));
+  } else {
+    ENVOY_LOG(debug, "io_uring accept failed: {}", errorDetails(-result));
+  }
+  maybeAccept();
+  signal(readyEvents() & Event::FileReadyType::Read);
+}
+
+void IoUringSocketHandleImpl::onPollCompletion(RequestPtr request, int32_t result) {
+  ASSERT(request.get() == poll_in_flight_);
+  poll_in_flight_ = nullptr;
+  if (request->poll_mask_ & POLLOUT) {
+    // The connect completed. Whether it succeeded is up to the caller to check with SO_ERROR.
+    connecting_ = false;
+    connected_ = true;
+    maybeRead();
+    signal(Event::FileReadyType::Write);
+  } else if (result > 0 && (result & (POLLRDHUP | POLLHUP | POLLERR))) {
+    signal(Event::FileReadyType::Closed);
+    return;
+  }
+  maybePoll();
+}
+
+void IoUringSocketHandleImpl::maybeRead() {
+  if (worker_ == nullptr || read_in_flight_ != nullptr || !connected_ || listening_ ||
+      read_end_stream_ || read_errno_ != 0 || !(enabled_events_ & Event::FileReadyType::Read) ||
+      read_bytes_ >= read_limit_) {
+    return;
+  }
+  auto request = std::make_unique<Request>(*worker_, this, Request::Type::Read, fd_);
+  request->allocateBuffer();
+  read_in_flight_ = request.get();
+  worker_->submit(std::move(request));
+}
+
+void IoUringSocketHandleImpl::maybeAccept() {
+  if (worker_ == nullptr || accept_in_flight_ != nullptr || !listening_ ||
+      !(enabled_events_ & Event::FileReadyType::Read) || accepted_.size() >= MaxQueuedAccepts) {
+    return;
+  }
+  auto request = std::make_unique<Request>(*worker_, this, Request::Type::Accept, fd_);
+  accept_in_flight_ = request.get();
+  worker_->submit(std::move(request));
+}
+
+void IoUringSocketHandleImpl::maybePoll() {
+  if (worker_ == nullptr || poll_in_flight_ != nullptr) {
+    return;
+  }
+  uint32_t poll_mask = 0;
+  if (connecting_) {
+    if (enabled_events_ & Event::FileReadyType::Write) {
+      poll_mask = POLLOUT;
+    }
+  } else if (connected_ && (enabled_events_ & Event::FileReadyType::Closed) &&
+             !(enabled_events_ & Event::FileReadyType::Read) && !read_end_stream_ &&
+             read_errno_ == 0) {
+    poll_mask = POLLRDHUP;
+  }
+  if (poll_mask == 0) {
+    return;
+  }
+  auto request = std::make_unique<Request>(*worker_, this, Request::Type::Poll, fd_);
+  request->poll_mask_ = poll_mask;
+  poll_in_flight_ = request.get();
+  worker_->submit(std::move(request));
+}
+
+Request* IoUringSocketHandleImpl::queuedWrite() {
+  if (!writes_.empty() && writes_.back()->write_data_.length() < writes_.back()->capacity()) {
+    return writes_.back().get();
+  }
+  if (writes_.size() == MaxQueuedWrites) {
+    return nullptr;
+  }
+  writes_.push_back(std::make_unique<Request>(*worker_, this, Request::Type::Write, fd_));
+  return writes_.back().get();
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::writeResult(uint64_t bytes, bool blocked) {
+  if (blocked) {
+    // Signal Write once a queued write completes, as epoll would when the socket buffer drains.
+    write_blocked_ = true;
+    if (bytes == 0) {
+      return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN});
+    }
+  }
+  return {bytes, Api::IoErrorPtr(nullptr, Envoy::Network::IoSocketError::deleteIoError)};
+}
+
+void IoUringSocketHandleImpl::submitWrite() {
+  if (write_in_flight_ != nullptr || writes_.empty()) {
+    return;
+  }
+  RequestPtr request = std::move(writes_.front());
+  writes_.pop_front();
+  write_in_flight_ = request.get();
+  worker_->submit(std::move(request));
+}
+
+uint64_t IoUringSocketHandleImpl::copyReceived(Buffer::RawSlice* slices, uint64_t num_slice,
+                                               uint64_t length, bool peek) {
+  uint64_t bytes = 0;
+  auto read = reads_.begin();
+  uint32_t offset = read != reads_.end() ? (*read)->offset_ : 0;
+  for (uint64_t i = 0; i < num_slice && bytes < length && read != reads_.end(); ++i) {
+    uint8_t* mem = static_cast<uint8_t*>(slices[i].mem_);
+    uint64_t room = std::min<uint64_t>(slices[i].len_, length - bytes);
+    while (room > 0 && read != reads_.end()) {
+      const uint32_t copy = std::min<uint64_t>(room, (*read)->length_ - offset);
+      memcpy(mem, (*read)->buffer_ + offset, copy);
+      mem += copy;
+      room -= copy;
+      bytes += copy;
+      offset += copy;
+      if (offset == (*read)->length_) {
+        ++read;
+        offset = read != reads_.end() ? (*read)->offset_ : 0;
+      }
+    }
+  }
+  if (!peek) {
+    reads_.erase(reads_.begin(), read);
+    if (read != reads_.end()) {
+      (*read)->offset_ = offset;
+    }
+    read_bytes_ -= bytes;
+    maybeRead();
+  }
+  return bytes;
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::receiveError() {
+  if (read_errno_ != 0) {
+    return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, read_errno_});
+  }
+  if (read_end_stream_) {
+    return Api::ioCallUint64ResultNoError();
+  }
+  maybeRead();
+  return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN});
+}
+
+uint32_t IoUringSocketHandleImpl::readyEvents() const {
+  uint32_t events = 0;
+  if (listening_) {
+    if (!accepted_.empty()) {
+      events |= Event::FileReadyType::Read;
+    }
+    return events;
+  }
+  if (read_bytes_ > 0 || read_end_stream_ || read_errno_ != 0) {
+    events |= Event::FileReadyType::Read;
+  }
+  if (read_end_stream_ || read_errno_ != 0) {
+    events |= Event::FileReadyType::Closed;
+  }
+  if (connected_ && !connecting_ &&
+      (write_errno_ != 0 || writes_.size() < MaxQueuedWrites ||
+       writes_.back()->write_data_.length() < writes_.back()->capacity())) {
+    events |= Event::FileReadyType::Write;
+  }
+  return events;
+}
+
+void IoUringSocketHandleImpl::signal(uint32_t events) {
+  ready_events_ |= events;
+  if (ready_cb_ != nullptr && ((ready_events_ & enabled_events_) | activated_events_) != 0 &&
+      !ready_cb_->enabled()) {
+    ready_cb_->scheduleCallbackCurrentIteration();
+  }
+}
+
+void IoUringSocketHandleImpl::onReady() {
+  uint32_t events = (ready_events_ & enabled_events_) | activated_events_;
+  if (trigger_ == Event::FileTriggerType::Level) {
+    events |= readyEvents() & enabled_events_;
+  }
+  ready_events_ = 0;
+  activated_events_ = 0;
+  if (events == 0) {
+    return;
+  }
+  if (trigger_ == Event::FileTriggerType::Level) {
+    // Events stay ready for as long as their condition holds, so look again on the next iteration.
+    // This is done ahead of the callback, after which the handle may have been destroyed.
+    ready_cb_->scheduleCallbackNextIteration();
+  }
+  cb_(events);
+}
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <list>
+#include <memory>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/schedulable_cb.h"
+
+#include "common/network/io_socket_handle_impl.h"
+
+#include "extensions/network/socket_interface/io_uring/worker.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+/**
+ * IoHandle for stream sockets whose I/O is performed by the ring of the dispatcher they are
+ * registered with. Reads and accepts are kept outstanding while the corresponding events are
+ * enabled, and their results are held by the handle until they are consumed. read() hands the
+ * received data to the caller's buffer as fragments of the buffers it was read into, and write()
+ * moves the slices of the caller's buffer into a short queue of writes performed in order, so
+ * neither copies the data. readv(), recv() and writev() copy it from or to the caller's memory.
+ * File events are emulated on top of the completions.
+ *
+ * Until initializeFileEvent() is called, or if the dispatcher's ring cannot be set up, the handle
+ * behaves as an IoSocketHandleImpl.
+ */
+class IoUringSocketHandleImpl : public Envoy::Network::IoSocketHandleImpl {
+public:
+  IoUringSocketHandleImpl(const RingOptions& options, os_fd_t fd = INVALID_SOCKET,
+                          bool socket_v6only = false, absl::optional<int> domain = absl::nullopt,
+                          bool connected = false);
+  ~IoUringSocketHandleImpl() override;
+
+  // Network::IoHandle
+  Api::IoCallUint64Result close() override;
+  Api::IoCallUint64Result readv(uint64_t max_length, Buffer::RawSlice* slices,
+                                uint64_t num_slice) override;
+  Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) override;
+  Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) override;
+  Api::IoCallUint64Result write(Buffer::Instance& buffer) override;
+  Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) override;
+  bool supportsSplice() const override { return false; }
+  Api::SysCallIntResult listen(int backlog) override;
+  Envoy::Network::IoHandlePtr accept(struct sockaddr* addr, socklen_t* addrlen) override;
+  Api::SysCallIntResult connect(Envoy::Network::Address::InstanceConstSharedPtr address) override;
+  Envoy::Network::IoHandlePtr duplicate() override;
+  void initializeFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                           Event::FileTriggerType trigger, uint32_t events) override;
+  void activateFileEvents(uint32_t events) override;
+  void enableFileEvents(uint32_t events) override;
+  void resetFileEvents() override;
+  Api::SysCallIntResult shutdown(int how) override;
+
+  /**
+   * Called by the worker when one of the handle's operations completes.
+   * @param request the operation.
+   * @param result the result of the operation: a byte count, file descriptor or poll mask on
+   *        success, or a negated errno.
+   */
+  void onCompletion(RequestPtr request, int32_t result);
+
+  // The maximum number of writes queued on a socket.
+  static constexpr uint32_t MaxQueuedWrites = 4;
+  // The maximum number of accepted sockets held by a listener.
+  static constexpr uint32_t MaxQueuedAccepts = 16;
+
+private:
+  void onReadCompletion(RequestPtr request, int32_t result);
+  void onWriteCompletion(RequestPtr request, int32_t result);
+  void onAcceptCompletion(RequestPtr request, int32_t result);
+  void onPollCompletion(RequestPtr request, int32_t result);
+
+  // Start the operations which the enabled events and the state of the socket call for.
+  void maybeRead();
+  void maybeAccept();
+  void maybePoll();
+  void submitWrite();
+  // @return the queued write to append data to, or nullptr if the queue is full.
+  Request* queuedWrite();
+  Api::IoCallUint64Result writeResult(uint64_t bytes, bool blocked);
+
+  // Copy up to length bytes of received data to the slices, consuming them unless peeking.
+  uint64_t copyReceived(Buffer::RawSlice* slices, uint64_t num_slice, uint64_t length, bool peek);
+  Api::IoCallUint64Result receiveError();
+  uint32_t readyEvents() const;
+  void signal(uint32_t events);
+  void onReady();
+
+  const RingOptions& options_;
+  // Declared first so that requests held below are released while the worker is alive.
+  std::shared_ptr<Worker> worker_;
+
+  Event::FileReadyCb cb_;
+  Event::FileTriggerType trigger_{};
+  uint32_t enabled_events_{};
+  uint32_t ready_events_{};
+  uint32_t activated_events_{};
+  Event::SchedulableCallbackPtr ready_cb_;
+
+  bool connected_;
+  bool connecting_{};
+  bool listening_{};
+
+  // Completed reads whose data has not been consumed yet.
+  std::list<RequestPtr> reads_;
+  uint64_t read_bytes_{};
+  // Data is read ahead up to this many bytes; peeks raise it to the length they ask for.
+  uint64_t read_limit_{};
+  Request* read_in_flight_{};
+  bool read_end_stream_{};
+  int read_errno_{};
+
+  // Writes queued behind the one in flight.
+  std::list<RequestPtr> writes_;
+  Request* write_in_flight_{};
+  int write_errno_{};
+  bool write_blocked_{};
+  absl::optional<int> shutdown_how_;
+
+  std::list<RequestPtr> accepted_;
+  Request* accept_in_flight_{};
+
+  // Polls for the completion of a connect, and for the peer closing while reads are disabled.
+  Request* poll_in_flight_{};
+};
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,57 @@
+#include "extensions/network/socket_interface/io_uring/io_uring_socket_interface_impl.h"
+
+#include "envoy/common/exception.h"
+#include "envoy/extensions/network/socket_interface/v3/io_uring_socket_interface.pb.h"
+#include "envoy/extensions/network/socket_interface/v3/io_uring_socket_interface.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/network/socket_interface/io_uring/io_uring_socket_handle_impl.h"
+#include "extensions/network/socket_interface/io_uring/ring.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+Envoy::Network::IoHandlePtr
+IoUringSocketInterfaceImpl::makeSocket(int socket_fd, bool socket_v6only,
+                                       absl::optional<int> domain) const {
+  int type = 0;
+  socklen_t type_len = sizeof(type);
+  const Api::SysCallIntResult result =
+      Api::OsSysCallsSingleton::get().getsockopt(socket_fd, SOL_SOCKET, SO_TYPE, &type, &type_len);
+  if (result.rc_ != 0 || type != SOCK_STREAM) {
+    return SocketInterfaceImpl::makeSocket(socket_fd, socket_v6only, domain);
+  }
+  return std::make_unique<IoUringSocketHandleImpl>(options_, socket_fd, socket_v6only, domain);
+}
+
+Server::BootstrapExtensionPtr IoUringSocketInterfaceImpl::createBootstrapExtension(
+    const Protobuf::Message& config, Server::Configuration::ServerFactoryContext& context) {
+  const auto& typed_config = MessageUtil::downcastAndValidate<
+      const envoy::extensions::network::socket_interface::v3::IoUringSocketInterface&>(
+      config, context.messageValidationContext().staticValidationVisitor());
+  if (!Ring::isSupported()) {
+    throw EnvoyException("io_uring socket interface: io_uring is not supported by the kernel");
+  }
+  options_.entries_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(typed_config, io_uring_size, 1024);
+  options_.num_buffers_ =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(typed_config, num_registered_buffers, 256);
+  options_.buffer_size_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(typed_config, buffer_size, 16384);
+  return std::make_unique<Envoy::Network::SocketInterfaceExtension>(*this);
+}
+
+ProtobufTypes::MessagePtr IoUringSocketInterfaceImpl::createEmptyConfigProto() {
+  return std::make_unique<
+      envoy::extensions::network::socket_interface::v3::IoUringSocketInterface>();
+}
+
+REGISTER_FACTORY(IoUringSocketInterfaceImpl, Server::Configuration::BootstrapExtensionFactory);
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
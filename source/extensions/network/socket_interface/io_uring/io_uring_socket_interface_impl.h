@@ -0,0 +1,42 @@
+#pragma once
+
+#include "envoy/network/socket.h"
+
+#include "common/network/socket_interface_impl.h"
+
+#include "extensions/network/socket_interface/io_uring/worker.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+/**
+ * Socket interface whose stream sockets perform their I/O through a per-dispatcher io_uring.
+ * Datagram sockets are created as by the default socket interface.
+ */
+class IoUringSocketInterfaceImpl : public Envoy::Network::SocketInterfaceImpl {
+public:
+  // Server::Configuration::BootstrapExtensionFactory
+  Server::BootstrapExtensionPtr
+  createBootstrapExtension(const Protobuf::Message& config,
+                           Server::Configuration::ServerFactoryContext& context) override;
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override;
+  std::string name() const override { return "envoy.extensions.network.socket_interface.io_uring"; }
+
+protected:
+  // Network::SocketInterfaceImpl
+  Envoy::Network::IoHandlePtr makeSocket(int socket_fd, bool socket_v6only,
+                                         absl::optional<int> domain) const override;
+
+private:
+  // Referenced by the handles, which may outlive the bootstrap extension: the factory is static.
+  RingOptions options_{1024, 256, 16384};
+};
+
+DECLARE_FACTORY(IoUringSocketInterfaceImpl);
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
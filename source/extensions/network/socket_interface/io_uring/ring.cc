@@ -0,0 +1,363 @@
+#include "extensions/network/socket_interface/io_uring/ring.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/logger.h"
+#include "common/common/utility.h"
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+#include "common/api/os_sys_calls_impl_linux.h"
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+#if defined(__linux__)
+
+struct Ring::Sqe : public io_uring_sqe {};
+
+namespace {
+
+// The kernel limit on the number of buffers registered with a ring.
+constexpr uint32_t MaxRegisteredBuffers = 1 << 14;
+
+void* mapRing(os_fd_t fd, size_t size, off_t offset) {
+  void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+  if (ptr == MAP_FAILED) {
+    throw EnvoyException(fmt::format("unable to map io_uring: {}", errorDetails(errno)));
+  }
+  return ptr;
+}
+
+} // namespace
+
+Ring::Ring(uint32_t entries, uint32_t num_buffers, uint32_t buffer_size)
+    : buffer_size_(buffer_size) {
+  auto& os_sys_calls = Api::LinuxOsSysCallsSingleton::get();
+  io_uring_params params{};
+  const Api::SysCallIntResult result = os_sys_calls.io_uring_setup(entries, &params);
+  if (result.rc_ < 0) {
+    throw EnvoyException(fmt::format("unable to create io_uring: {}", errorDetails(result.errno_)));
+  }
+  fd_ = result.rc_;
+
+  // Release whatever was set up if one of the mappings fails, as the destructor will not run.
+  try {
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+      sq_ring_ = mapRing(fd_, sq_ring_size_, IORING_OFF_SQ_RING);
+    } else {
+      sq_ring_ = mapRing(fd_, sq_ring_size_, IORING_OFF_SQ_RING);
+      cq_ring_ = mapRing(fd_, cq_ring_size_, IORING_OFF_CQ_RING);
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = mapRing(fd_, sqes_size_, IORING_OFF_SQES);
+  } catch (const EnvoyException&) {
+    release();
+    throw;
+  }
+
+  uint8_t* sq = static_cast<uint8_t*>(sq_ring_);
+  sq_head_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+  sq_mask_ = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+  sq_entries_ = params.sq_entries;
+  sq_tail_local_ = *sq_tail_;
+
+  uint8_t* cq = static_cast<uint8_t*>(cq_ring_ != nullptr ? cq_ring_ : sq_ring_);
+  cq_head_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+  cqes_ = cq + params.cq_off.cqes;
+
+  // Buffers are an optimization: without them, operations use memory supplied by the caller.
+  num_buffers = std::min(num_buffers, MaxRegisteredBuffers);
+  if (num_buffers == 0 || buffer_size == 0) {
+    return;
+  }
+  buffers_size_ = static_cast<size_t>(num_buffers) * buffer_size;
+  void* buffers =
+      ::mmap(nullptr, buffers_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (buffers == MAP_FAILED) {
+    ENVOY_LOG_MISC(warn, "io_uring: unable to allocate buffers: {}", errorDetails(errno));
+    buffers_size_ = 0;
+    return;
+  }
+  std::vector<iovec> iovecs(num_buffers);
+  for (uint32_t i = 0; i < num_buffers; ++i) {
+    iovecs[i].iov_base = static_cast<uint8_t*>(buffers) + static_cast<size_t>(i) * buffer_size;
+    iovecs[i].iov_len = buffer_size;
+  }
+  const Api::SysCallIntResult register_result =
+      os_sys_calls.io_uring_register(fd_, IORING_REGISTER_BUFFERS, iovecs.data(), num_buffers);
+  if (register_result.rc_ < 0) {
+    // Registration pins memory, which is limited by RLIMIT_MEMLOCK on older kernels.
+    ENVOY_LOG_MISC(warn, "io_uring: unable to register buffers: {}",
+                   errorDetails(register_result.errno_));
+    ::munmap(buffers, buffers_size_);
+    buffers_size_ = 0;
+    return;
+  }
+  buffers_ = static_cast<uint8_t*>(buffers);
+  free_buffers_.reserve(num_buffers);
+  for (uint32_t i = num_buffers; i > 0; --i) {
+    free_buffers_.push_back(i - 1);
+  }
+}
+
+Ring::~Ring() { release(); }
+
+void Ring::release() {
+  // Closing the ring cancels any operation still in flight.
+  if (SOCKET_VALID(fd_)) {
+    ::close(fd_);
+    fd_ = INVALID_SOCKET;
+  }
+  if (buffers_ != nullptr) {
+    ::munmap(buffers_, buffers_size_);
+    buffers_ = nullptr;
+  }
+  if (sqes_ != nullptr) {
+    ::munmap(sqes_, sqes_size_);
+    sqes_ = nullptr;
+  }
+  if (cq_ring_ != nullptr) {
+    ::munmap(cq_ring_, cq_ring_size_);
+    cq_ring_ = nullptr;
+  }
+  if (sq_ring_ != nullptr) {
+    ::munmap(sq_ring_, sq_ring_size_);
+    sq_ring_ = nullptr;
+  }
+}
+
+bool Ring::isSupported() {
+  static const bool supported = []() {
+    auto& os_sys_calls = Api::LinuxOsSysCallsSingleton::get();
+    io_uring_params params{};
+    const Api::SysCallIntResult result = os_sys_calls.io_uring_setup(2, &params);
+    if (result.rc_ < 0) {
+      return false;
+    }
+    constexpr uint32_t NumOps = 256;
+    std::vector<uint8_t> storage(sizeof(io_uring_probe) + NumOps * sizeof(io_uring_probe_op));
+    auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+    const bool probed =
+        os_sys_calls.io_uring_register(result.rc_, IORING_REGISTER_PROBE, probe, NumOps).rc_ == 0;
+    ::close(result.rc_);
+    if (!probed) {
+      return false;
+    }
+    for (const uint8_t op : {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READ_FIXED,
+                             IORING_OP_WRITE_FIXED, IORING_OP_WRITEV, IORING_OP_ACCEPT,
+                             IORING_OP_POLL_ADD, IORING_OP_ASYNC_CANCEL}) {
+      if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+        return false;
+      }
+    }
+    return true;
+  }();
+  return supported;
+}
+
+absl::optional<uint16_t> Ring::acquireBuffer() {
+  if (free_buffers_.empty()) {
+    return absl::nullopt;
+  }
+  const uint16_t index = free_buffers_.back();
+  free_buffers_.pop_back();
+  return index;
+}
+
+void Ring::releaseBuffer(uint16_t index) {
+  ASSERT(static_cast<size_t>(index) * buffer_size_ < buffers_size_);
+  free_buffers_.push_back(index);
+}
+
+uint8_t* Ring::buffer(uint16_t index) const {
+  ASSERT(static_cast<size_t>(index) * buffer_size_ < buffers_size_);
+  return buffers_ + static_cast<size_t>(index) * buffer_size_;
+}
+
+uint32_t Ring::pendingSubmissions() const {
+  return sq_tail_local_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+}
+
+Ring::Sqe* Ring::nextSqe() {
+  // Only this thread advances the tail, and the kernel only advances the head during submit().
+  if (pendingSubmissions() >= sq_entries_) {
+    return nullptr;
+  }
+  const uint32_t index = sq_tail_local_++ & sq_mask_;
+  sq_array_[index] = index;
+  auto* sqe = static_cast<Sqe*>(static_cast<io_uring_sqe*>(sqes_) + index);
+  memset(sqe, 0, sizeof(io_uring_sqe));
+  return sqe;
+}
+
+bool Ring::prepareRead(os_fd_t fd, uint8_t* buf, uint32_t len,
+                       absl::optional<uint16_t> buffer_index, uint64_t user_data) {
+  Sqe* sqe = nextSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = buffer_index.has_value() ? IORING_OP_READ_FIXED : IORING_OP_READ;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(buf);
+  sqe->len = len;
+  sqe->buf_index = buffer_index.value_or(0);
+  sqe->user_data = user_data;
+  return true;
+}
+
+bool Ring::prepareWrite(os_fd_t fd, const uint8_t* buf, uint32_t len,
+                        absl::optional<uint16_t> buffer_index, uint64_t user_data) {
+  Sqe* sqe = nextSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = buffer_index.has_value() ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(buf);
+  sqe->len = len;
+  sqe->buf_index = buffer_index.value_or(0);
+  sqe->user_data = user_data;
+  return true;
+}
+
+bool Ring::prepareWritev(os_fd_t fd, const iovec* iov, uint32_t num_iov, uint64_t user_data) {
+  Sqe* sqe = nextSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_WRITEV;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(iov);
+  sqe->len = num_iov;
+  sqe->user_data = user_data;
+  return true;
+}
+
+bool Ring::prepareAccept(os_fd_t fd, sockaddr* addr, socklen_t* addrlen, uint64_t user_data) {
+  Sqe* sqe = nextSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_ACCEPT;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(addr);
+  sqe->addr2 = reinterpret_cast<uint64_t>(addrlen);
+  sqe->accept_flags = SOCK_NONBLOCK;
+  sqe->user_data = user_data;
+  return true;
+}
+
+bool Ring::preparePoll(os_fd_t fd, uint32_t poll_mask, uint64_t user_data) {
+  Sqe* sqe = nextSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+  sqe->poll32_events = poll_mask;
+  sqe->user_data = user_data;
+  return true;
+}
+
+bool Ring::prepareCancel(uint64_t target_user_data, uint64_t user_data) {
+  Sqe* sqe = nextSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = target_user_data;
+  sqe->user_data = user_data;
+  return true;
+}
+
+uint32_t Ring::submit(bool wait_for_completion) {
+  const uint32_t to_submit = pendingSubmissions();
+  if (to_submit == 0 && !wait_for_completion) {
+    return 0;
+  }
+  // Publish the prepared entries before the kernel reads the tail.
+  __atomic_store_n(sq_tail_, sq_tail_local_, __ATOMIC_RELEASE);
+  const Api::SysCallIntResult result = Api::LinuxOsSysCallsSingleton::get().io_uring_enter(
+      fd_, to_submit, wait_for_completion ? 1 : 0,
+      wait_for_completion ? IORING_ENTER_GETEVENTS : 0);
+  if (result.rc_ < 0) {
+    // EBUSY and EAGAIN mean that completions must be reaped first. Entries not consumed by the
+    // kernel remain pending, and are submitted by the next call.
+    ENVOY_LOG_MISC(trace, "io_uring: submit failed: {}", errorDetails(result.errno_));
+    return 0;
+  }
+  return result.rc_;
+}
+
+void Ring::forEveryCompletion(const CompletionCb& cb) {
+  const auto* cqes = static_cast<const io_uring_cqe*>(cqes_);
+  uint32_t head = *cq_head_;
+  uint32_t tail;
+  while (head != (tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE))) {
+    for (; head != tail; ++head) {
+      const io_uring_cqe& cqe = cqes[head & cq_mask_];
+      const uint64_t user_data = cqe.user_data;
+      const int32_t result = cqe.res;
+      // Hand the entry back to the kernel before running the callback, which may submit more.
+      __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+      cb(user_data, result);
+    }
+  }
+}
+
+#else
+
+struct Ring::Sqe {};
+
+Ring::Ring(uint32_t, uint32_t, uint32_t buffer_size) : buffer_size_(buffer_size) {
+  throw EnvoyException("io_uring is not supported on this platform");
+}
+Ring::~Ring() = default;
+void Ring::release() {}
+bool Ring::isSupported() { return false; }
+uint32_t Ring::pendingSubmissions() const { NOT_REACHED_GCOVR_EXCL_LINE; }
+absl::optional<uint16_t> Ring::acquireBuffer() { NOT_REACHED_GCOVR_EXCL_LINE; }
+void Ring::releaseBuffer(uint16_t) { NOT_REACHED_GCOVR_EXCL_LINE; }
+uint8_t* Ring::buffer(uint16_t) const { NOT_REACHED_GCOVR_EXCL_LINE; }
+Ring::Sqe* Ring::nextSqe() { NOT_REACHED_GCOVR_EXCL_LINE; }
+bool Ring::prepareRead(os_fd_t, uint8_t*, uint32_t, absl::optional<uint16_t>, uint64_t) {
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+bool Ring::prepareWrite(os_fd_t, const uint8_t*, uint32_t, absl::optional<uint16_t>, uint64_t) {
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+bool Ring::prepareWritev(os_fd_t, const iovec*, uint32_t, uint64_t) {
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+bool Ring::prepareAccept(os_fd_t, sockaddr*, socklen_t*, uint64_t) { NOT_REACHED_GCOVR_EXCL_LINE; }
+bool Ring::preparePoll(os_fd_t, uint32_t, uint64_t) { NOT_REACHED_GCOVR_EXCL_LINE; }
+bool Ring::prepareCancel(uint64_t, uint64_t) { NOT_REACHED_GCOVR_EXCL_LINE; }
+uint32_t Ring::submit(bool) { NOT_REACHED_GCOVR_EXCL_LINE; }
+void Ring::forEveryCompletion(const CompletionCb&) { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+#endif
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/common/platform.h"
+
+#include "common/common/non_copyable.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+/**
+ * A submission and completion queue pair shared with the kernel, see io_uring(7), along with a
+ * pool of fixed size buffers registered with it. Operations are prepared into the submission
+ * queue and handed to the kernel in a batch by submit(), so that many sockets are served by a
+ * single system call. Each operation carries an opaque user data value which is returned with
+ * its completion.
+ *
+ * The ring is not thread safe and must be used from a single thread.
+ */
+class Ring : NonCopyable {
+public:
+  /**
+   * @param entries the size of the submission queue.
+   * @param num_buffers the number of buffers to register with the ring.
+   * @param buffer_size the size of each registered buffer.
+   * Throws EnvoyException if the ring cannot be created.
+   */
+  Ring(uint32_t entries, uint32_t num_buffers, uint32_t buffer_size);
+  ~Ring();
+
+  /**
+   * @return whether the kernel supports every operation used by the ring.
+   */
+  static bool isSupported();
+
+  /**
+   * @return the file descriptor of the ring. It is readable while completions are available.
+   */
+  os_fd_t fd() const { return fd_; }
+
+  /**
+   * @return the index of an unused registered buffer, or absl::nullopt if all are in use.
+   */
+  absl::optional<uint16_t> acquireBuffer();
+  void releaseBuffer(uint16_t index);
+  uint8_t* buffer(uint16_t index) const;
+  uint32_t bufferSize() const { return buffer_size_; }
+
+  /**
+   * Prepare operations in the submission queue. Each returns false if the queue is full, in which
+   * case the caller should submit() and try again.
+   * @param buffer_index the index of a registered buffer containing buf, or absl::nullopt if buf
+   *        is not registered.
+   */
+  bool prepareRead(os_fd_t fd, uint8_t* buf, uint32_t len, absl::optional<uint16_t> buffer_index,
+                   uint64_t user_data);
+  bool prepareWrite(os_fd_t fd, const uint8_t* buf, uint32_t len,
+                    absl::optional<uint16_t> buffer_index, uint64_t user_data);
+  // The iovecs must remain valid until the operation completes.
+  bool prepareWritev(os_fd_t fd, const iovec* iov, uint32_t num_iov, uint64_t user_data);
+  bool prepareAccept(os_fd_t fd, sockaddr* addr, socklen_t* addrlen, uint64_t user_data);
+  bool preparePoll(os_fd_t fd, uint32_t poll_mask, uint64_t user_data);
+  bool prepareCancel(uint64_t target_user_data, uint64_t user_data);
+
+  /**
+   * Hand all prepared operations to the kernel.
+   * @param wait_for_completion whether to block until at least one completion is available.
+   * @return the number of operations submitted.
+   */
+  uint32_t submit(bool wait_for_completion = false);
+
+  /**
+   * @return the number of operations prepared but not yet submitted.
+   */
+  uint32_t pendingSubmissions() const;
+
+  using CompletionCb = std::function<void(uint64_t user_data, int32_t result)>;
+
+  /**
+   * Invoke the callback for, and consume, every available completion.
+   */
+  void forEveryCompletion(const CompletionCb& cb);
+
+private:
+  struct Sqe;
+  Sqe* nextSqe();
+  void release();
+
+  os_fd_t fd_{INVALID_SOCKET};
+  const uint32_t buffer_size_;
+
+  // Mappings of the rings shared with the kernel.
+  void* sq_ring_{};
+  size_t sq_ring_size_{};
+  void* cq_ring_{};
+  size_t cq_ring_size_{};
+  void* sqes_{};
+  size_t sqes_size_{};
+
+  // Pointers into the submission queue ring.
+  uint32_t* sq_head_{};
+  uint32_t* sq_tail_{};
+  uint32_t sq_mask_{};
+  uint32_t* sq_array_{};
+  uint32_t sq_entries_{};
+  // The tail including prepared entries which have not been handed to the kernel yet.
+  uint32_t sq_tail_local_{};
+
+  // Pointers into the completion queue ring.
+  uint32_t* cq_head_{};
+  uint32_t* cq_tail_{};
+  uint32_t cq_mask_{};
+  void* cqes_{};
+
+  uint8_t* buffers_{};
+  size_t buffers_size_{};
+  std::vector<uint16_t> free_buffers_;
+};
+
+using RingPtr = std::unique_ptr<Ring>;
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
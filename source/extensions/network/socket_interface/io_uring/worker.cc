@@ -0,0 +1,341 @@
+#include "extensions/network/socket_interface/io_uring/worker.h"
+
+#include <vector>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+
+#include "extensions/network/socket_interface/io_uring/io_uring_socket_handle_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+Request::Request(Worker& worker, IoUringSocketHandleImpl* handle, Type type, os_fd_t fd)
+    : worker_(worker), handle_(handle), type_(type), fd_(fd) {}
+
+Request::~Request() {
+  if (buffer_index_.has_value()) {
+    worker_.ring().releaseBuffer(buffer_index_.value());
+  }
+}
+
+void Request::allocateBuffer() {
+  ASSERT(buffer_ == nullptr);
+  Ring& ring = worker_.ring();
+  buffer_index_ = ring.acquireBuffer();
+  if (buffer_index_.has_value()) {
+    buffer_ = ring.buffer(buffer_index_.value());
+  } else {
+    heap_buffer_ = std::make_unique<uint8_t[]>(ring.bufferSize());
+    buffer_ = heap_buffer_.get();
+  }
+}
+
+uint32_t Request::capacity() const { return worker_.ring().bufferSize(); }
+
+Worker::Worker(Event::Dispatcher& dispatcher, const RingOptions& options)
+    : dispatcher_(dispatcher),
+      ring_(options.entries_, options.num_buffers_, options.buffer_size_) {
+  // Completions are drained in full on every event, but level triggering guards against losing
+  // the notification for those posted while the callback runs.
+  ring_event_ = dispatcher_.createFileEvent(
+      ring_.fd(), [this](uint32_t) { reap(); }, Event::FileTriggerType::Level,
+      Event::FileReadyType::Read);
+  flush_cb_ = dispatcher_.createSchedulableCallback([this]() { flush(); });
+}
+
+Worker::~Worker() {
+  ASSERT(in_flight_.empty());
+  ASSERT(closing_sockets_.empty());
+  ASSERT(fragments_ == 0);
+}
+
+// The data of a completed read, held by a buffer. Releasing it returns the read's registered
+// buffer to the ring.
+class Worker::ReadFragment : public Buffer::BufferFragment {
+public:
+  explicit ReadFragment(RequestPtr read) : read_(std::move(read)) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return read_->data(); }
+  size_t size() const override { return read_->length(); }
+  void done() override {
+    Worker& worker = read_->worker_;
+    ASSERT(worker.dispatcher_.isThreadSafe());
+    delete this;
+    worker.onFragmentDone();
+  }
+
+private:
+  const RequestPtr read_;
+};
+
+// The workers of the dispatchers running on a thread. Each dispatcher runs on a single thread, so
+// its worker is looked up without locking.
+struct Worker::Registry {
+  ~Registry() {
+    for (auto& [worker, owned] : draining_) {
+      owned.release()->abandon();
+    }
+  }
+
+  absl::flat_hash_map<Event::Dispatcher*, std::weak_ptr<Worker>> workers_;
+  // Workers released by their handles, until their operations complete.
+  absl::flat_hash_map<Worker*, std::unique_ptr<Worker>> draining_;
+};
+
+Worker::Registry& Worker::registry() {
+  static thread_local Registry registry;
+  return registry;
+}
+
+std::shared_ptr<Worker> Worker::get(Event::Dispatcher& dispatcher, const RingOptions& options) {
+  ASSERT(dispatcher.isThreadSafe());
+  auto& workers = registry().workers_;
+  auto it = workers.find(&dispatcher);
+  if (it != workers.end()) {
+    std::shared_ptr<Worker> worker = it->second.lock();
+    ASSERT(worker != nullptr);
+    return worker;
+  }
+  // The entry is erased when the last handle releases the worker, so that a dispatcher later
+  // allocated at the same address does not find a stale one.
+  std::shared_ptr<Worker> worker(new Worker(dispatcher, options),
+                                 [](Worker* worker) { worker->drain(); });
+  workers.emplace(&dispatcher, worker);
+  return worker;
+}
+
+void Worker::submit(RequestPtr request) {
+  Request* raw = request.release();
+  in_flight_.insert(raw);
+  if (SOCKET_VALID(raw->fd_)) {
+    ++socket_operations_[raw->fd_];
+  }
+  // Keep the submission order: nothing may overtake an operation waiting in the backlog.
+  if (!backlog_.empty() || !prepare(*raw)) {
+    backlog_.push_back(raw);
+  }
+  if (!flush_cb_->enabled()) {
+    flush_cb_->scheduleCallbackCurrentIteration();
+  }
+}
+
+void Worker::cancel(Request& request) {
+  request.handle_ = nullptr;
+  auto cancel = std::make_unique<Request>(*this, nullptr, Request::Type::Cancel, INVALID_SOCKET);
+  cancel->cancel_target_ = &request;
+  submit(std::move(cancel));
+}
+
+void Worker::closeSocket(os_fd_t fd) {
+  if (socket_operations_.contains(fd)) {
+    closing_sockets_.insert(fd);
+    return;
+  }
+  Api::OsSysCallsSingleton::get().close(fd);
+}
+
+Buffer::BufferFragment& Worker::fragment(RequestPtr read) {
+  ASSERT(read->type_ == Request::Type::Read);
+  ++fragments_;
+  return *new ReadFragment(std::move(read));
+}
+
+void Worker::onFragmentDone() {
+  ASSERT(fragments_ > 0);
+  if (--fragments_ == 0 && draining_ && in_flight_.empty()) {
+    onDrained();
+  }
+}
+
+bool Worker::prepare(Request& request) {
+  const uint64_t user_data = reinterpret_cast<uint64_t>(&request);
+  switch (request.type_) {
+  case Request::Type::Read:
+    return ring_.prepareRead(request.fd_, request.buffer_ + request.length_,
+                             request.capacity() - request.length_, request.buffer_index_,
+                             user_data);
+  case Request::Type::Write:
+    request.iovecs_.clear();
+    for (const Buffer::RawSlice& slice :
+         request.write_data_.getRawSlices(Request::MaxWriteSlices)) {
+      request.iovecs_.push_back({slice.mem_, slice.len_});
+    }
+    return ring_.prepareWritev(request.fd_, request.iovecs_.data(), request.iovecs_.size(),
+                               user_data);
+  case Request::Type::Accept:
+    return ring_.prepareAccept(request.fd_, reinterpret_cast<sockaddr*>(&request.addr_),
+                               &request.addr_len_, user_data);
+  case Request::Type::Poll:
+    return ring_.preparePoll(request.fd_, request.poll_mask_, user_data);
+  case Request::Type::Cancel:
+    return ring_.prepareCancel(reinterpret_cast<uint64_t>(request.cancel_target_), user_data);
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+void Worker::flush() {
+  // Move the backlog into the submission queue as the kernel consumes it.
+  uint32_t submitted;
+  do {
+    while (!backlog_.empty() && prepare(*backlog_.front())) {
+      backlog_.pop_front();
+    }
+    submitted = ring_.submit();
+  } while (!backlog_.empty() && submitted > 0);
+
+  if (!backlog_.empty()) {
+    // The kernel is not accepting submissions until completions are reaped.
+    flush_cb_->scheduleCallbackNextIteration();
+  }
+}
+
+void Worker::reap() {
+  ring_.forEveryCompletion([this](uint64_t user_data, int32_t result) {
+    Request* request = reinterpret_cast<Request*>(user_data);
+    const size_t erased = in_flight_.erase(request);
+    ASSERT(erased == 1);
+    const os_fd_t fd = request->fd_;
+    // Operations resubmitted from the completion are counted before this one is released.
+    onCompletion(RequestPtr{request}, result);
+    if (SOCKET_VALID(fd)) {
+      releaseSocket(fd);
+    }
+  });
+  if (draining_ && in_flight_.empty() && fragments_ == 0) {
+    onDrained();
+  }
+}
+
+void Worker::releaseSocket(os_fd_t fd) {
+  auto it = socket_operations_.find(fd);
+  ASSERT(it != socket_operations_.end());
+  if (--it->second > 0) {
+    return;
+  }
+  socket_operations_.erase(it);
+  if (closing_sockets_.erase(fd) > 0) {
+    Api::OsSysCallsSingleton::get().close(fd);
+  }
+}
+
+void Worker::drain() {
+  ASSERT(dispatcher_.isThreadSafe());
+  Registry& registry = Worker::registry();
+  registry.workers_.erase(&dispatcher_);
+
+  // All handles are gone. Reads, accepts and polls are of no further use, but give the writes of
+  // sockets closed with data outstanding a chance to complete.
+  for (Request* request : std::vector<Request*>(in_flight_.begin(), in_flight_.end())) {
+    ASSERT(request->handle_ == nullptr);
+    if (request->type_ != Request::Type::Write && request->type_ != Request::Type::Cancel) {
+      cancel(*request);
+    }
+  }
+  if (in_flight_.empty() && fragments_ == 0) {
+    dispatcher_.deferredDelete(std::unique_ptr<Worker>(this));
+    return;
+  }
+
+  // The completions are reaped, and the fragments released, from the event loop as usual, which
+  // is never blocked waiting for them.
+  draining_ = true;
+  registry.draining_.emplace(this, std::unique_ptr<Worker>(this));
+  drain_timer_ = dispatcher_.createTimer([this]() {
+    // The peers are not reading.
+    for (Request* request : std::vector<Request*>(in_flight_.begin(), in_flight_.end())) {
+      if (request->type_ == Request::Type::Write) {
+        cancel(*request);
+      }
+    }
+  });
+  drain_timer_->enableTimer(DrainTimeout);
+}
+
+void Worker::onDrained() {
+  draining_ = false;
+  drain_timer_.reset();
+  Registry& registry = Worker::registry();
+  auto it = registry.draining_.find(this);
+  ASSERT(it != registry.draining_.end());
+  std::unique_ptr<Worker> worker = std::move(it->second);
+  registry.draining_.erase(it);
+  dispatcher_.deferredDelete(std::move(worker));
+}
+
+void Worker::abandon() {
+  // The event loop will not run again, and the dispatcher may already be gone: release the events
+  // without touching it. The operations in flight are leaked rather than waited for, as the kernel
+  // may still access their buffers until the ring is torn down, and nothing bounds how long a
+  // write to a peer which is not reading takes.
+  //
+  // The leak is bounded. drain() has already canceled all but the writes of sockets closed with
+  // data outstanding, and the drain timer cancels those after DrainTimeout, so this only happens
+  // to a thread exiting within DrainTimeout of closing such sockets. It then amounts to one write
+  // request per socket, along with the MaxQueuedWrites chained to it and the events released
+  // here. If buffers still hold fragments, which point into the ring's registered buffers, the
+  // worker itself is leaked along with the ring. Canceling the writes and waiting for their
+  // completions, bounded by an IORING_OP_LINK_TIMEOUT, would avoid the leak at the cost of
+  // blocking the thread's exit.
+  ring_event_.release();
+  flush_cb_.release();
+  drain_timer_.release();
+  in_flight_.clear();
+  backlog_.clear();
+  for (os_fd_t fd : closing_sockets_) {
+    Api::OsSysCallsSingleton::get().close(fd);
+  }
+  closing_sockets_.clear();
+  if (fragments_ == 0) {
+    delete this;
+  }
+}
+
+void Worker::onCompletion(RequestPtr request, int32_t result) {
+  if (request->handle_ == nullptr) {
+    onOrphanCompletion(std::move(request), result);
+    return;
+  }
+  IoUringSocketHandleImpl* handle = request->handle_;
+  handle->onCompletion(std::move(request), result);
+}
+
+void Worker::onOrphanCompletion(RequestPtr request, int32_t result) {
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  switch (request->type_) {
+  case Request::Type::Write:
+    if (result > 0) {
+      request->write_data_.drain(result);
+      if (request->write_data_.length() > 0) {
+        submit(std::move(request));
+        return;
+      }
+      if (!request->chained_writes_.empty()) {
+        RequestPtr next = std::move(request->chained_writes_.front());
+        request->chained_writes_.pop_front();
+        next->chained_writes_ = std::move(request->chained_writes_);
+        submit(std::move(next));
+        return;
+      }
+    }
+    break;
+  case Request::Type::Accept:
+    // The listener went away after the kernel accepted the connection.
+    if (result >= 0) {
+      os_sys_calls.close(result);
+    }
+    break;
+  case Request::Type::Read:
+  case Request::Type::Poll:
+  case Request::Type::Cancel:
+    break;
+  }
+}
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
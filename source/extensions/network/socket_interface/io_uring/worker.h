@@ -0,0 +1,185 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+
+#include "envoy/common/platform.h"
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/file_event.h"
+#include "envoy/event/schedulable_cb.h"
+#include "envoy/event/timer.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+
+#include "extensions/network/socket_interface/io_uring/ring.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+class IoUringSocketHandleImpl;
+class Worker;
+
+/**
+ * Sizing of the ring created for each dispatcher.
+ */
+struct RingOptions {
+  uint32_t entries_;
+  uint32_t num_buffers_;
+  uint32_t buffer_size_;
+};
+
+/**
+ * An operation on a socket. Once submitted it is owned by the worker until it completes, at which
+ * point it is handed back to its handle, or released if the handle has been closed meanwhile.
+ */
+struct Request {
+  enum class Type { Read, Write, Accept, Poll, Cancel };
+
+  Request(Worker& worker, IoUringSocketHandleImpl* handle, Type type, os_fd_t fd);
+  ~Request();
+
+  // Attach a registered buffer, or a heap buffer of the same size if none is free.
+  void allocateBuffer();
+
+  // The maximum number of slices of write_data_ handed to the kernel at once.
+  static constexpr uint32_t MaxWriteSlices = 16;
+
+  uint32_t capacity() const;
+  uint8_t* data() const { return buffer_ + offset_; }
+  uint32_t length() const { return length_ - offset_; }
+
+  Worker& worker_;
+  // nullptr once the handle has been closed.
+  IoUringSocketHandleImpl* handle_;
+  const Type type_;
+  const os_fd_t fd_;
+
+  // Read. Bytes in [offset_, length_) are yet to be consumed.
+  uint8_t* buffer_{};
+  absl::optional<uint16_t> buffer_index_;
+  std::unique_ptr<uint8_t[]> heap_buffer_;
+  uint32_t offset_{};
+  uint32_t length_{};
+
+  // Write. The data yet to be written, and the slices of it last handed to the kernel.
+  Buffer::OwnedImpl write_data_;
+  absl::InlinedVector<iovec, MaxWriteSlices> iovecs_;
+  // When the handle is closed with writes outstanding, the writes queued behind this one are
+  // chained to it.
+  std::list<std::unique_ptr<Request>> chained_writes_;
+
+  // Accept.
+  sockaddr_storage addr_{};
+  socklen_t addr_len_{sizeof(addr_)};
+  os_fd_t accepted_fd_{INVALID_SOCKET};
+
+  // Poll.
+  uint32_t poll_mask_{};
+
+  // Cancel.
+  Request* cancel_target_{};
+};
+
+using RequestPtr = std::unique_ptr<Request>;
+
+/**
+ * Drives the ring of a dispatcher: operations submitted while the dispatcher runs its callbacks
+ * are handed to the kernel with a single io_uring_enter(2) at the end of the event loop iteration,
+ * and completions are reaped when the ring's file descriptor becomes readable.
+ *
+ * There is one worker per dispatcher, shared by the handles on it. Once the last of them is gone,
+ * the worker drains the operations still in flight from the event loop and is then deferred
+ * deleted.
+ */
+class Worker : public Event::DeferredDeletable, Logger::Loggable<Logger::Id::io> {
+public:
+  Worker(Event::Dispatcher& dispatcher, const RingOptions& options);
+  ~Worker() override;
+
+  /**
+   * @return the worker of the dispatcher, which must be running on the calling thread. Throws
+   *         EnvoyException if one must be created and its ring cannot be set up.
+   */
+  static std::shared_ptr<Worker> get(Event::Dispatcher& dispatcher, const RingOptions& options);
+
+  Event::Dispatcher& dispatcher() { return dispatcher_; }
+  Ring& ring() { return ring_; }
+
+  /**
+   * Queue an operation for submission at the end of the event loop iteration.
+   */
+  void submit(RequestPtr request);
+
+  /**
+   * Detach an operation from its handle and ask the kernel to cancel it.
+   */
+  void cancel(Request& request);
+
+  /**
+   * Close a socket once the operations submitted on it have completed. Closing it earlier would
+   * let its number be reused while operations still queued in the ring or in the backlog refer to
+   * it, and they would then apply to the new socket.
+   */
+  void closeSocket(os_fd_t fd);
+
+  /**
+   * Hand the data of a completed read to a buffer without copying it. The read's buffer stays in
+   * use until the buffer releases the fragment, which must happen on the dispatcher's thread. A
+   * worker released by its handles is not deleted until all its fragments are.
+   */
+  Buffer::BufferFragment& fragment(RequestPtr read);
+
+  // How long a draining worker waits for progress on the writes of closed sockets.
+  static constexpr std::chrono::milliseconds DrainTimeout{1000};
+
+private:
+  class ReadFragment;
+  struct Registry;
+
+  static Registry& registry();
+
+  bool prepare(Request& request);
+  void flush();
+  void reap();
+  void onCompletion(RequestPtr request, int32_t result);
+  void onOrphanCompletion(RequestPtr request, int32_t result);
+  void releaseSocket(os_fd_t fd);
+  void onFragmentDone();
+  // Called when the last handle releases the worker.
+  void drain();
+  void onDrained();
+  // Called when the thread exits with the worker still draining.
+  void abandon();
+
+  Event::Dispatcher& dispatcher_;
+  Ring ring_;
+  Event::FileEventPtr ring_event_;
+  Event::SchedulableCallbackPtr flush_cb_;
+  // Submitted operations which the kernel has not completed yet.
+  absl::flat_hash_set<Request*> in_flight_;
+  // Operations which did not fit in the submission queue, in submission order.
+  std::list<Request*> backlog_;
+  // The number of operations in flight on each socket, and the closed sockets among them.
+  absl::flat_hash_map<os_fd_t, uint32_t> socket_operations_;
+  absl::flat_hash_set<os_fd_t> closing_sockets_;
+  // The number of reads handed to buffers whose fragments have not been released yet.
+  uint32_t fragments_{};
+  bool draining_{};
+  Event::TimerPtr drain_timer_;
+};
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
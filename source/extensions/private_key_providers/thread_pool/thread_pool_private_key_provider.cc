@@ -0,0 +1,355 @@
+#include "extensions/private_key_providers/thread_pool/thread_pool_private_key_provider.h"
+
+#include <algorithm>
+
+#include "envoy/common/exception.h"
+#include "envoy/singleton/manager.h"
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+#include "common/config/datasource.h"
+#include "common/protobuf/utility.h"
+
+#include "openssl/err.h"
+#include "openssl/evp.h"
+#include "openssl/pem.h"
+#include "openssl/rsa.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+namespace {
+
+// The number of threads of a provider whose configuration doesn't set it.
+constexpr uint32_t DefaultThreadCount = 4;
+
+} // namespace
+
+SINGLETON_MANAGER_REGISTRATION(private_key_thread_pool_manager);
+
+PrivateKeyOperation::PrivateKeyOperation(Ssl::PrivateKeyConnectionCallbacks& callbacks,
+                                         Event::Dispatcher& dispatcher,
+                                         bssl::UniquePtr<EVP_PKEY> pkey, bool decrypt,
+                                         uint16_t signature_algorithm, const uint8_t* in,
+                                         size_t in_len)
+    : callbacks_(callbacks), pkey_(std::move(pkey)), decrypt_(decrypt),
+      signature_algorithm_(signature_algorithm), input_(in, in + in_len), dispatcher_(&dispatcher) {
+}
+
+void PrivateKeyOperation::execute() {
+  succeeded_ = decrypt_ ? decrypt() : sign();
+  if (!succeeded_) {
+    // The error queue is per thread, and this one has no connection to report the errors of.
+    ERR_clear_error();
+  }
+
+  Thread::LockGuard lock(dispatcher_lock_);
+  if (dispatcher_ != nullptr) {
+    dispatcher_->post([operation = shared_from_this()]() { operation->onExecuted(); });
+  }
+}
+
+void PrivateKeyOperation::cancel() {
+  Thread::LockGuard lock(dispatcher_lock_);
+  dispatcher_ = nullptr;
+}
+
+void PrivateKeyOperation::onExecuted() {
+  {
+    Thread::LockGuard lock(dispatcher_lock_);
+    if (dispatcher_ == nullptr) {
+      return;
+    }
+  }
+  done_ = true;
+  callbacks_.onPrivateKeyMethodComplete();
+}
+
+ssl_private_key_result_t PrivateKeyOperation::copyOutput(uint8_t* out, size_t* out_len,
+                                                         size_t max_out) const {
+  if (!succeeded_ || output_.size() > max_out) {
+    return ssl_private_key_failure;
+  }
+  std::copy(output_.begin(), output_.end(), out);
+  *out_len = output_.size();
+  return ssl_private_key_success;
+}
+
+bool PrivateKeyOperation::sign() {
+  bssl::ScopedEVP_MD_CTX ctx;
+  EVP_PKEY_CTX* pkey_ctx;
+  // The digest is null for Ed25519, which signs the input as a whole.
+  const EVP_MD* md = SSL_get_signature_algorithm_digest(signature_algorithm_);
+  if (!EVP_DigestSignInit(ctx.get(), &pkey_ctx, md, nullptr, pkey_.get())) {
+    return false;
+  }
+  if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm_) &&
+      (!EVP_PKEY_CTX_set_rsa_padding(pkey_ctx, RSA_PKCS1_PSS_PADDING) ||
+       // A salt as long as the digest.
+       !EVP_PKEY_CTX_set_rsa_pss_saltlen(pkey_ctx, -1))) {
+    return false;
+  }
+  size_t out_len = EVP_PKEY_size(pkey_.get());
+  output_.resize(out_len);
+  if (!EVP_DigestSign(ctx.get(), output_.data(), &out_len, input_.data(), input_.size())) {
+    return false;
+  }
+  output_.resize(out_len);
+  return true;
+}
+
+bool PrivateKeyOperation::decrypt() {
+  RSA* rsa = EVP_PKEY_get0_RSA(pkey_.get());
+  if (rsa == nullptr) {
+    return false;
+  }
+  size_t out_len;
+  output_.resize(RSA_size(rsa));
+  if (!RSA_decrypt(rsa, &out_len, output_.data(), output_.size(), input_.data(), input_.size(),
+                   RSA_NO_PADDING)) {
+    return false;
+  }
+  output_.resize(out_len);
+  return true;
+}
+
+PrivateKeyThreadPool::PrivateKeyThreadPool(Thread::ThreadFactory& thread_factory,
+                                           uint32_t thread_count) {
+  ASSERT(thread_count > 0);
+  for (uint32_t i = 0; i < thread_count; ++i) {
+    threads_.push_back(thread_factory.createThread([this]() -> void { threadRoutine(); },
+                                                   Thread::Options{"private_key"}));
+  }
+}
+
+PrivateKeyThreadPool::~PrivateKeyThreadPool() {
+  {
+    Thread::LockGuard lock(queue_lock_);
+    shutdown_ = true;
+  }
+  queue_event_.notifyAll();
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+void PrivateKeyThreadPool::enqueue(PrivateKeyOperationSharedPtr operation) {
+  {
+    Thread::LockGuard lock(queue_lock_);
+    queue_.push_back(std::move(operation));
+  }
+  queue_event_.notifyOne();
+}
+
+void PrivateKeyThreadPool::threadRoutine() {
+  while (true) {
+    PrivateKeyOperationSharedPtr operation;
+    {
+      Thread::LockGuard lock(queue_lock_);
+      while (queue_.empty() && !shutdown_) {
+        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+        queue_event_.wait(queue_lock_);
+      }
+      if (shutdown_) {
+        return;
+      }
+      operation = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    operation->execute();
+  }
+}
+
+std::shared_ptr<PrivateKeyThreadPool>
+PrivateKeyThreadPoolManager::getThreadPool(uint32_t thread_count) {
+  std::weak_ptr<PrivateKeyThreadPool>& existing_pool = thread_pools_[thread_count];
+  std::shared_ptr<PrivateKeyThreadPool> thread_pool = existing_pool.lock();
+  if (thread_pool == nullptr) {
+    thread_pool = std::make_shared<PrivateKeyThreadPool>(thread_factory_, thread_count);
+    existing_pool = thread_pool;
+  }
+  return thread_pool;
+}
+
+ThreadPoolPrivateKeyConnection::ThreadPoolPrivateKeyConnection(
+    Ssl::PrivateKeyConnectionCallbacks& callbacks, Event::Dispatcher& dispatcher)
+    : callbacks_(callbacks), dispatcher_(dispatcher) {}
+
+ThreadPoolPrivateKeyConnection::~ThreadPoolPrivateKeyConnection() {
+  if (operation_ != nullptr) {
+    operation_->cancel();
+  }
+}
+
+void ThreadPoolPrivateKeyConnection::addProvider(ThreadPoolPrivateKeyMethodProvider& provider) {
+  providers_.push_back(&provider);
+}
+
+bool ThreadPoolPrivateKeyConnection::removeProvider(ThreadPoolPrivateKeyMethodProvider& provider) {
+  providers_.erase(std::remove(providers_.begin(), providers_.end(), &provider), providers_.end());
+  return !providers_.empty();
+}
+
+ThreadPoolPrivateKeyMethodProvider*
+ThreadPoolPrivateKeyConnection::selectProvider(SSL* ssl) const {
+  if (providers_.size() == 1) {
+    return providers_[0];
+  }
+  // Each certificate of the context has its own provider, holding the private key matching the
+  // public key of the certificate.
+  X509* certificate = SSL_get_certificate(ssl);
+  if (certificate == nullptr) {
+    return nullptr;
+  }
+  const EVP_PKEY* public_key = X509_get0_pubkey(certificate);
+  for (ThreadPoolPrivateKeyMethodProvider* provider : providers_) {
+    if (EVP_PKEY_cmp(public_key, provider->privateKey()) == 1) {
+      return provider;
+    }
+  }
+  return nullptr;
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyConnection::start(SSL* ssl, bool decrypt,
+                                                               uint16_t signature_algorithm,
+                                                               const uint8_t* in, size_t in_len) {
+  ThreadPoolPrivateKeyMethodProvider* provider = selectProvider(ssl);
+  if (provider == nullptr) {
+    return ssl_private_key_failure;
+  }
+  operation_ = std::make_shared<PrivateKeyOperation>(callbacks_, dispatcher_,
+                                                     bssl::UpRef(provider->privateKey()), decrypt,
+                                                     signature_algorithm, in, in_len);
+  provider->threadPool().enqueue(operation_);
+  return ssl_private_key_retry;
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyConnection::complete(uint8_t* out, size_t* out_len,
+                                                                  size_t max_out) {
+  if (operation_ == nullptr) {
+    return ssl_private_key_failure;
+  }
+  if (!operation_->done()) {
+    return ssl_private_key_retry;
+  }
+  const ssl_private_key_result_t result = operation_->copyOutput(out, out_len, max_out);
+  operation_.reset();
+  return result;
+}
+
+namespace {
+
+ThreadPoolPrivateKeyConnection* connectionForSsl(SSL* ssl) {
+  return static_cast<ThreadPoolPrivateKeyConnection*>(
+      SSL_get_ex_data(ssl, ThreadPoolPrivateKeyMethodProvider::connectionIndex()));
+}
+
+ssl_private_key_result_t privateKeySign(SSL* ssl, uint8_t*, size_t*, size_t,
+                                        uint16_t signature_algorithm, const uint8_t* in,
+                                        size_t in_len) {
+  ThreadPoolPrivateKeyConnection* connection = connectionForSsl(ssl);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  return connection->start(ssl, false, signature_algorithm, in, in_len);
+}
+
+ssl_private_key_result_t privateKeyDecrypt(SSL* ssl, uint8_t*, size_t*, size_t, const uint8_t* in,
+                                           size_t in_len) {
+  ThreadPoolPrivateKeyConnection* connection = connectionForSsl(ssl);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  return connection->start(ssl, true, 0, in, in_len);
+}
+
+ssl_private_key_result_t privateKeyComplete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                            size_t max_out) {
+  ThreadPoolPrivateKeyConnection* connection = connectionForSsl(ssl);
+  if (connection == nullptr) {
+    return ssl_private_key_failure;
+  }
+  return connection->complete(out, out_len, max_out);
+}
+
+} // namespace
+
+ThreadPoolPrivateKeyMethodProvider::ThreadPoolPrivateKeyMethodProvider(
+    const envoy::extensions::private_key_providers::thread_pool::v3alpha::
+        ThreadPoolPrivateKeyMethodConfig& config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context) {
+  const std::string private_key =
+      Config::DataSource::read(config.private_key(), false, factory_context.api());
+  bssl::UniquePtr<BIO> bio(
+      BIO_new_mem_buf(const_cast<char*>(private_key.data()), private_key.size()));
+  bssl::UniquePtr<EVP_PKEY> pkey(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+  if (pkey == nullptr) {
+    throw EnvoyException("Failed to load private key for the thread pool private key provider");
+  }
+  const int key_type = EVP_PKEY_id(pkey.get());
+  if (key_type != EVP_PKEY_RSA && key_type != EVP_PKEY_EC) {
+    throw EnvoyException("The thread pool private key provider only supports RSA and ECDSA keys");
+  }
+  pkey_ = std::move(pkey);
+
+  method_ = std::make_shared<SSL_PRIVATE_KEY_METHOD>();
+  method_->sign = privateKeySign;
+  method_->decrypt = privateKeyDecrypt;
+  method_->complete = privateKeyComplete;
+
+  thread_pool_manager_ =
+      factory_context.singletonManager().getTyped<PrivateKeyThreadPoolManager>(
+          SINGLETON_MANAGER_REGISTERED_NAME(private_key_thread_pool_manager), [&factory_context] {
+            return std::make_shared<PrivateKeyThreadPoolManager>(
+                factory_context.api().threadFactory());
+          });
+  thread_pool_ = thread_pool_manager_->getThreadPool(
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, thread_count, DefaultThreadCount));
+}
+
+void ThreadPoolPrivateKeyMethodProvider::registerPrivateKeyMethod(
+    SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher) {
+  ThreadPoolPrivateKeyConnection* connection = connectionForSsl(ssl);
+  if (connection == nullptr) {
+    connection = new ThreadPoolPrivateKeyConnection(cb, dispatcher);
+    SSL_set_ex_data(ssl, connectionIndex(), connection);
+  }
+  connection->addProvider(*this);
+}
+
+void ThreadPoolPrivateKeyMethodProvider::unregisterPrivateKeyMethod(SSL* ssl) {
+  ThreadPoolPrivateKeyConnection* connection = connectionForSsl(ssl);
+  if (connection != nullptr && !connection->removeProvider(*this)) {
+    SSL_set_ex_data(ssl, connectionIndex(), nullptr);
+    delete connection;
+  }
+}
+
+bool ThreadPoolPrivateKeyMethodProvider::checkFips() {
+  if (EVP_PKEY_id(pkey_.get()) == EVP_PKEY_RSA) {
+    const RSA* rsa_private_key = EVP_PKEY_get0_RSA(pkey_.get());
+    return rsa_private_key != nullptr && RSA_check_fips(const_cast<RSA*>(rsa_private_key));
+  }
+  const EC_KEY* ecdsa_private_key = EVP_PKEY_get0_EC_KEY(pkey_.get());
+  return ecdsa_private_key != nullptr && EC_KEY_check_fips(ecdsa_private_key);
+}
+
+Ssl::BoringSslPrivateKeyMethodSharedPtr
+ThreadPoolPrivateKeyMethodProvider::getBoringSslPrivateKeyMethod() {
+  return method_;
+}
+
+int ThreadPoolPrivateKeyMethodProvider::connectionIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() -> int {
+    int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    RELEASE_ASSERT(index >= 0, "Failed to get SSL user data index.");
+    return index;
+  }());
+}
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
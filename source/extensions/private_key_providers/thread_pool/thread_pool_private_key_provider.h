@@ -0,0 +1,201 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/extensions/private_key_providers/thread_pool/v3alpha/thread_pool.pb.h"
+#include "envoy/server/transport_socket_config.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/ssl/private_key/private_key.h"
+#include "envoy/thread/thread.h"
+
+#include "common/common/thread.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+/**
+ * A signing or decryption operation of a handshake. It is executed on a pool thread and then
+ * completed on the dispatcher of the connection, unless the connection is closed in the meantime.
+ */
+class PrivateKeyOperation : public std::enable_shared_from_this<PrivateKeyOperation> {
+public:
+  /**
+   * @param callbacks the connection, notified on its dispatcher once the operation is executed.
+   * @param dispatcher the dispatcher of the connection.
+   * @param pkey the private key used by the operation.
+   * @param decrypt whether the operation is a decryption rather than a signature.
+   * @param signature_algorithm the TLS signature algorithm of a signature.
+   * @param in the input of the operation.
+   * @param in_len the size of the input.
+   */
+  PrivateKeyOperation(Ssl::PrivateKeyConnectionCallbacks& callbacks, Event::Dispatcher& dispatcher,
+                      bssl::UniquePtr<EVP_PKEY> pkey, bool decrypt, uint16_t signature_algorithm,
+                      const uint8_t* in, size_t in_len);
+
+  /**
+   * Performs the operation, and posts its completion to the dispatcher of the connection. Called
+   * on a pool thread.
+   */
+  void execute();
+
+  /**
+   * Prevents the connection from being notified of the completion of the operation. Called on the
+   * dispatcher of the connection.
+   */
+  void cancel();
+
+  /**
+   * @return bool whether the connection was notified of the completion of the operation.
+   */
+  bool done() const { return done_; }
+
+  /**
+   * Copies the output of a completed operation.
+   * @return ssl_private_key_success if the operation succeeded and its output fits in max_out.
+   */
+  ssl_private_key_result_t copyOutput(uint8_t* out, size_t* out_len, size_t max_out) const;
+
+private:
+  bool sign();
+  bool decrypt();
+  void onExecuted();
+
+  Ssl::PrivateKeyConnectionCallbacks& callbacks_;
+  const bssl::UniquePtr<EVP_PKEY> pkey_;
+  const bool decrypt_;
+  const uint16_t signature_algorithm_;
+  const std::vector<uint8_t> input_;
+  // Written by the pool thread before the completion is posted to the dispatcher.
+  std::vector<uint8_t> output_;
+  bool succeeded_{};
+  // Only accessed on the dispatcher of the connection.
+  bool done_{};
+  Thread::MutexBasicLockable dispatcher_lock_;
+  // Reset when the operation is cancelled. The completion is posted with the lock held, so the
+  // dispatcher is not destroyed while it is posted to.
+  Event::Dispatcher* dispatcher_ ABSL_GUARDED_BY(dispatcher_lock_);
+};
+
+using PrivateKeyOperationSharedPtr = std::shared_ptr<PrivateKeyOperation>;
+
+/**
+ * Threads executing the queued operations of the connections of the providers using the pool in
+ * order.
+ */
+class PrivateKeyThreadPool {
+public:
+  PrivateKeyThreadPool(Thread::ThreadFactory& thread_factory, uint32_t thread_count);
+  ~PrivateKeyThreadPool();
+
+  /**
+   * Queues an operation for execution by the next available thread.
+   */
+  void enqueue(PrivateKeyOperationSharedPtr operation);
+
+private:
+  void threadRoutine();
+
+  Thread::MutexBasicLockable queue_lock_;
+  Thread::CondVar queue_event_;
+  std::deque<PrivateKeyOperationSharedPtr> queue_ ABSL_GUARDED_BY(queue_lock_);
+  bool shutdown_ ABSL_GUARDED_BY(queue_lock_){};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+/**
+ * Hands out the thread pools of the providers, so that the providers with the same number of
+ * threads share a pool rather than each starting its own threads. A pool is stopped once the last
+ * provider using it is destroyed. Only accessed on the main thread.
+ */
+class PrivateKeyThreadPoolManager : public Singleton::Instance {
+public:
+  explicit PrivateKeyThreadPoolManager(Thread::ThreadFactory& thread_factory)
+      : thread_factory_(thread_factory) {}
+
+  /**
+   * @return the pool with the given number of threads.
+   */
+  std::shared_ptr<PrivateKeyThreadPool> getThreadPool(uint32_t thread_count);
+
+private:
+  Thread::ThreadFactory& thread_factory_;
+  absl::flat_hash_map<uint32_t, std::weak_ptr<PrivateKeyThreadPool>> thread_pools_;
+};
+
+using PrivateKeyThreadPoolManagerSharedPtr = std::shared_ptr<PrivateKeyThreadPoolManager>;
+
+class ThreadPoolPrivateKeyMethodProvider;
+
+/**
+ * The state of a connection using thread pool providers, which may be several when the TLS
+ * context has certificates of different types.
+ */
+class ThreadPoolPrivateKeyConnection {
+public:
+  ThreadPoolPrivateKeyConnection(Ssl::PrivateKeyConnectionCallbacks& callbacks,
+                                 Event::Dispatcher& dispatcher);
+  ~ThreadPoolPrivateKeyConnection();
+
+  void addProvider(ThreadPoolPrivateKeyMethodProvider& provider);
+
+  /**
+   * @return bool whether other providers are still registered with the connection.
+   */
+  bool removeProvider(ThreadPoolPrivateKeyMethodProvider& provider);
+
+  /**
+   * Queues an operation with the key of the certificate selected for the connection.
+   */
+  ssl_private_key_result_t start(SSL* ssl, bool decrypt, uint16_t signature_algorithm,
+                                 const uint8_t* in, size_t in_len);
+
+  ssl_private_key_result_t complete(uint8_t* out, size_t* out_len, size_t max_out);
+
+private:
+  ThreadPoolPrivateKeyMethodProvider* selectProvider(SSL* ssl) const;
+
+  Ssl::PrivateKeyConnectionCallbacks& callbacks_;
+  Event::Dispatcher& dispatcher_;
+  std::vector<ThreadPoolPrivateKeyMethodProvider*> providers_;
+  PrivateKeyOperationSharedPtr operation_;
+};
+
+class ThreadPoolPrivateKeyMethodProvider : public virtual Ssl::PrivateKeyMethodProvider {
+public:
+  ThreadPoolPrivateKeyMethodProvider(
+      const envoy::extensions::private_key_providers::thread_pool::v3alpha::
+          ThreadPoolPrivateKeyMethodConfig& config,
+      Server::Configuration::TransportSocketFactoryContext& factory_context);
+
+  // Ssl::PrivateKeyMethodProvider
+  void registerPrivateKeyMethod(SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb,
+                                Event::Dispatcher& dispatcher) override;
+  void unregisterPrivateKeyMethod(SSL* ssl) override;
+  bool checkFips() override;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr getBoringSslPrivateKeyMethod() override;
+
+  EVP_PKEY* privateKey() const { return pkey_.get(); }
+  PrivateKeyThreadPool& threadPool() { return *thread_pool_; }
+
+  static int connectionIndex();
+
+private:
+  Ssl::BoringSslPrivateKeyMethodSharedPtr method_;
+  bssl::UniquePtr<EVP_PKEY> pkey_;
+  // Keeps the pools of the other providers from being stopped when they are replaced.
+  PrivateKeyThreadPoolManagerSharedPtr thread_pool_manager_;
+  std::shared_ptr<PrivateKeyThreadPool> thread_pool_;
+};
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
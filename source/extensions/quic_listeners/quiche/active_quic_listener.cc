@@ -25,8 +25,9 @@ ActiveQuicListener::ActiveQuicListener(
     const quic::QuicConfig& quic_config, Network::Socket::OptionsSharedPtr options,
     bool kernel_worker_routing, const envoy::config::core::v3::RuntimeFeatureFlag& enabled)
     : ActiveQuicListener(worker_index, concurrency, dispatcher, parent,
-                         listener_config.listenSocketFactory().getListenSocket(), listener_config,
-                         quic_config, std::move(options), kernel_worker_routing, enabled) {}
+                         listener_config.listenSocketFactory().getListenSocket(worker_index),
+                         listener_config, quic_config, std::move(options), kernel_worker_routing,
+                         enabled) {}
 
 ActiveQuicListener::ActiveQuicListener(
     uint32_t worker_index, uint32_t concurrency, Event::Dispatcher& dispatcher,
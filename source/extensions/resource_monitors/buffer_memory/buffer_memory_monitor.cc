@@ -0,0 +1,31 @@
+#include "extensions/resource_monitors/buffer_memory/buffer_memory_monitor.h"
+
+#include "common/buffer/watermark_buffer.h"
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace BufferMemoryMonitor {
+
+BufferMemoryMonitor::BufferMemoryMonitor(
+    const envoy::extensions::resource_monitors::buffer_memory::v3alpha::BufferMemoryConfig&
+        config)
+    : max_buffer_memory_(config.max_buffer_memory_bytes()) {
+  ASSERT(max_buffer_memory_ > 0);
+  // Buffers count the data added after this point, so the pressure is accurate once the buffers
+  // allocated before the monitor, at startup, have changed.
+  Buffer::WatermarkBufferAccounting::enable();
+}
+
+void BufferMemoryMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  Server::ResourceUsage usage;
+  usage.resource_pressure_ =
+      Buffer::WatermarkBufferAccounting::bytes() / static_cast<double>(max_buffer_memory_);
+  callbacks.onSuccess(usage);
+}
+
+} // namespace BufferMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "envoy/extensions/resource_monitors/buffer_memory/v3alpha/buffer_memory.pb.h"
+#include "envoy/server/resource_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace BufferMemoryMonitor {
+
+/**
+ * Monitor of the memory held by watermark buffers with a statically configured maximum.
+ */
+class BufferMemoryMonitor : public Server::ResourceMonitor {
+public:
+  BufferMemoryMonitor(
+      const envoy::extensions::resource_monitors::buffer_memory::v3alpha::BufferMemoryConfig&
+          config);
+
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  const uint64_t max_buffer_memory_;
+};
+
+} // namespace BufferMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -16,6 +16,9 @@ public:
   // Heap monitor with statically configured max.
   const std::string FixedHeap = "envoy.resource_monitors.fixed_heap";
 
+  // Watermark buffer memory monitor with statically configured max.
+  const std::string BufferMemory = "envoy.resource_monitors.buffer_memory";
+
   // File-based injected resource monitor.
   const std::string InjectedResource = "envoy.resource_monitors.injected_resource";
 };
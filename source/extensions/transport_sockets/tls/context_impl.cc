@@ -25,7 +25,9 @@
 #include "extensions/transport_sockets/tls/utility.h"
 
 #include "absl/container/node_hash_set.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "openssl/evp.h"
 #include "openssl/hmac.h"
@@ -74,7 +76,8 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
       ssl_ciphers_(stat_name_set_->add("ssl.ciphers")),
       ssl_versions_(stat_name_set_->add("ssl.versions")),
       ssl_curves_(stat_name_set_->add("ssl.curves")),
-      ssl_sigalgs_(stat_name_set_->add("ssl.sigalgs")), capabilities_(config.capabilities()) {
+      ssl_sigalgs_(stat_name_set_->add("ssl.sigalgs")), capabilities_(config.capabilities()),
+      kernel_tls_offload_(config.kernelTlsOffload()) {
   const auto tls_certificates = config.tlsCertificates();
   tls_contexts_.resize(std::max(static_cast<size_t>(1), tls_certificates.size()));
 
@@ -1049,9 +1052,12 @@ uint16_t ClientContextImpl::parseSigningAlgorithmsForTest(const std::string& sig
 ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
                                      const Envoy::Ssl::ServerContextConfig& config,
                                      const std::vector<std::string>& server_names,
-                                     TimeSource& time_source)
+                                     TimeSource& time_source, SessionCacheSharedPtr session_cache)
     : ContextImpl(scope, config, time_source), session_ticket_keys_(config.sessionTicketKeys()),
-      ocsp_staple_policy_(config.ocspStaplePolicy()) {
+      ocsp_staple_policy_(config.ocspStaplePolicy()), session_cache_(std::move(session_cache)),
+      ssl_sni_(stat_name_set_->add("ssl.sni")), sni_other_(stat_name_set_->add("other")),
+      sni_handshake_(stat_name_set_->add("handshake")),
+      sni_session_reused_(stat_name_set_->add("session_reused")) {
   if (config.tlsCertificates().empty() && !config.capabilities().provides_certificates) {
     throw EnvoyException("Server TlsCertificates must have a certificate specified");
   }
@@ -1059,7 +1065,12 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   // Compute the session context ID hash. We use all the certificate identities,
   // since we should have a common ID for session resumption no matter what cert
   // is used. We do this early because it can throw an EnvoyException.
-  const SessionContextID session_id = generateHashForSessionContextId(server_names);
+  session_id_context_ = generateHashForSessionContextId(server_names, config);
+
+  for (const std::string& server_name : server_names) {
+    const std::string name = absl::AsciiStrToLower(server_name);
+    server_name_stat_names_.emplace(name, stat_name_set_->add(name));
+  }
 
   // First, configure the base context for ClientHello interception.
   // TODO(htuch): replace with SSL_IDENTITY when we have this as a means to do multi-cert in
@@ -1117,10 +1128,38 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
       SSL_CTX_set_timeout(ctx.ssl_ctx_.get(), uint32_t(timeout));
     }
 
-    int rc =
-        SSL_CTX_set_session_id_context(ctx.ssl_ctx_.get(), session_id.data(), session_id.size());
+    int rc = SSL_CTX_set_session_id_context(ctx.ssl_ctx_.get(), session_id_context_.data(),
+                                            session_id_context_.size());
     RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
 
+    // Sessions are stored in the shared cache instead of the internal cache of the context, so
+    // that they can be resumed by other contexts with the same session ID context, such as the
+    // ones replacing this context when its certificates are rotated.
+    if (session_cache_ != nullptr && !config.capabilities().handles_session_resumption) {
+      SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(),
+                                     SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+      SSL_CTX_sess_set_new_cb(ctx.ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
+        ContextImpl* context_impl =
+            static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+        ServerContextImpl* server_context_impl = dynamic_cast<ServerContextImpl*>(context_impl);
+        RELEASE_ASSERT(server_context_impl != nullptr, ""); // for Coverity
+        return server_context_impl->newSession(session);
+      });
+      SSL_CTX_sess_set_get_cb(
+          ctx.ssl_ctx_.get(),
+          [](SSL* ssl, const uint8_t* session_id, int session_id_length,
+             int* out_copy) -> SSL_SESSION* {
+            ContextImpl* context_impl =
+                static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+            ServerContextImpl* server_context_impl =
+                dynamic_cast<ServerContextImpl*>(context_impl);
+            RELEASE_ASSERT(server_context_impl != nullptr, ""); // for Coverity
+            // The returned reference is handed over to the connection.
+            *out_copy = 0;
+            return server_context_impl->getSession(session_id, session_id_length).release();
+          });
+    }
+
     auto& ocsp_resp_bytes = tls_certificates[i].get().ocspStaple();
     if (ocsp_resp_bytes.empty()) {
       if (Runtime::runtimeFeatureEnabled(
@@ -1141,8 +1180,69 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   }
 }
 
-ServerContextImpl::SessionContextID
-ServerContextImpl::generateHashForSessionContextId(const std::vector<std::string>& server_names) {
+void ServerContextImpl::logHandshake(SSL* ssl) const {
+  ContextImpl::logHandshake(ssl);
+
+  if (server_name_stat_names_.empty()) {
+    return;
+  }
+  const Stats::StatName server_name = serverNameStatName(ssl);
+  Stats::Utility::counterFromElements(scope_, {ssl_sni_, server_name, sni_handshake_}).inc();
+  if (SSL_session_reused(ssl)) {
+    Stats::Utility::counterFromElements(scope_, {ssl_sni_, server_name, sni_session_reused_})
+        .inc();
+  }
+}
+
+Stats::StatName ServerContextImpl::serverNameStatName(SSL* ssl) const {
+  const char* requested_server_name = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+  if (requested_server_name == nullptr) {
+    return sni_other_;
+  }
+  // Server names are matched as the filter chains are, exactly first and then by the wildcard
+  // replacing the first label. Other names are counted together, so that clients cannot create
+  // stats.
+  const std::string name = absl::AsciiStrToLower(requested_server_name);
+  auto it = server_name_stat_names_.find(name);
+  if (it != server_name_stat_names_.end()) {
+    return it->second;
+  }
+  const size_t dot = name.find('.');
+  if (dot != std::string::npos) {
+    it = server_name_stat_names_.find(absl::StrCat("*", absl::string_view(name).substr(dot)));
+    if (it != server_name_stat_names_.end()) {
+      return it->second;
+    }
+  }
+  return sni_other_;
+}
+
+int ServerContextImpl::newSession(SSL_SESSION* session) {
+  unsigned int session_id_length;
+  SSL_SESSION_get_id(session, &session_id_length);
+  if (session_id_length == 0) {
+    // The session can only be resumed with a ticket.
+    return 0;
+  }
+  // Take ownership of the reference passed by BoringSSL.
+  session_cache_->insert(bssl::UniquePtr<SSL_SESSION>(session));
+  return 1;
+}
+
+bssl::UniquePtr<SSL_SESSION> ServerContextImpl::getSession(const uint8_t* session_id,
+                                                           int session_id_length) {
+  bssl::UniquePtr<SSL_SESSION> session = session_cache_->lookup(
+      session_id_context_, absl::MakeConstSpan(session_id, session_id_length));
+  if (session != nullptr) {
+    stats_.session_cache_hit_.inc();
+  } else {
+    stats_.session_cache_miss_.inc();
+  }
+  return session;
+}
+
+ServerContextImpl::SessionContextID ServerContextImpl::generateHashForSessionContextId(
+    const std::vector<std::string>& server_names, const Envoy::Ssl::ServerContextConfig& config) {
   uint8_t hash_buffer[EVP_MAX_MD_SIZE];
   unsigned hash_length;
 
@@ -1262,6 +1362,34 @@ ServerContextImpl::generateHashForSessionContextId(const std::vector<std::string
     RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
   }
 
+  // Hash the remaining settings which decide whether a client is authenticated, so that a session
+  // established by a context which doesn't request or verify client certificates is never resumed
+  // by one which does. Contexts using the shared session cache would otherwise let clients skip
+  // client authentication.
+  const uint8_t require_client_certificate = config.requireClientCertificate();
+  rc = EVP_DigestUpdate(md.get(), &require_client_certificate, sizeof(require_client_certificate));
+  RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+
+  const Envoy::Ssl::CertificateValidationContextConfig* validation_config =
+      config.certificateValidationContext();
+  if (validation_config != nullptr) {
+    const uint8_t validation_settings[] = {
+        static_cast<uint8_t>(validation_config->allowExpiredCertificate()),
+        static_cast<uint8_t>(validation_config->trustChainVerification())};
+    rc = EVP_DigestUpdate(md.get(), validation_settings, sizeof(validation_settings));
+    RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+
+    const std::string& crl = validation_config->certificateRevocationList();
+    rc = EVP_DigestUpdate(md.get(), crl.data(), crl.size());
+    RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+
+    for (const auto& matcher : validation_config->subjectAltNameMatchers()) {
+      const uint64_t matcher_hash = MessageUtil::hash(matcher);
+      rc = EVP_DigestUpdate(md.get(), &matcher_hash, sizeof(matcher_hash));
+      RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+    }
+  }
+
   SessionContextID session_id;
 
   // Ensure that the output size of the hash we are using is no greater than
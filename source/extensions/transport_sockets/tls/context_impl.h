@@ -19,7 +19,9 @@
 
 #include "extensions/transport_sockets/tls/context_manager_impl.h"
 #include "extensions/transport_sockets/tls/ocsp/ocsp.h"
+#include "extensions/transport_sockets/tls/session_cache.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
 #include "openssl/ssl.h"
 #include "openssl/x509v3.h"
@@ -45,7 +47,14 @@ namespace Tls {
   COUNTER(ocsp_staple_failed)                                                                      \
   COUNTER(ocsp_staple_omitted)                                                                     \
   COUNTER(ocsp_staple_responses)                                                                   \
-  COUNTER(ocsp_staple_requests)
+  COUNTER(ocsp_staple_requests)                                                                    \
+  COUNTER(kernel_tls_tx_offloaded)                                                                 \
+  COUNTER(kernel_tls_rx_offloaded)                                                                 \
+  COUNTER(kernel_tls_unsupported_cipher)                                                           \
+  COUNTER(kernel_tls_unavailable)                                                                  \
+  COUNTER(write_bytes_linearized)                                                                  \
+  COUNTER(session_cache_hit)                                                                       \
+  COUNTER(session_cache_miss)
 
 /**
  * Wrapper struct for SSL stats. @see stats_macros.h
@@ -62,7 +71,7 @@ public:
    * Logs successful TLS handshake and updates stats.
    * @param ssl the connection to log
    */
-  void logHandshake(SSL* ssl) const;
+  virtual void logHandshake(SSL* ssl) const;
 
   /**
    * Performs subjectAltName verification
@@ -93,6 +102,12 @@ public:
 
   SslStats& stats() { return stats_; }
 
+  /**
+   * @return true if the record protection of connections should be offloaded to the kernel once
+   * their handshake completes.
+   */
+  bool kernelTlsOffload() const { return kernel_tls_offload_; }
+
   /**
    * The global SSL-library index used for storing a pointer to the SslExtendedSocketInfo
    * class in the SSL instance, for retrieval in callbacks.
@@ -220,6 +235,7 @@ protected:
   const Stats::StatName ssl_curves_;
   const Stats::StatName ssl_sigalgs_;
   const Ssl::HandshakerCapabilities capabilities_;
+  const bool kernel_tls_offload_;
 };
 
 using ContextImplSharedPtr = std::shared_ptr<ContextImpl>;
@@ -248,7 +264,11 @@ enum class OcspStapleAction { Staple, NoStaple, Fail, ClientNotCapable };
 class ServerContextImpl : public ContextImpl, public Envoy::Ssl::ServerContext {
 public:
   ServerContextImpl(Stats::Scope& scope, const Envoy::Ssl::ServerContextConfig& config,
-                    const std::vector<std::string>& server_names, TimeSource& time_source);
+                    const std::vector<std::string>& server_names, TimeSource& time_source,
+                    SessionCacheSharedPtr session_cache);
+
+  // ContextImpl
+  void logHandshake(SSL* ssl) const override;
 
   // Select the TLS certificate context in SSL_CTX_set_select_certificate_cb() callback with
   // ClientHello details. This is made public for use by custom TLS extensions who want to
@@ -262,15 +282,28 @@ private:
                          unsigned int inlen);
   int sessionTicketProcess(SSL* ssl, uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* ctx,
                            HMAC_CTX* hmac_ctx, int encrypt);
+  int newSession(SSL_SESSION* session);
+  bssl::UniquePtr<SSL_SESSION> getSession(const uint8_t* session_id, int session_id_length);
+  Stats::StatName serverNameStatName(SSL* ssl) const;
   bool isClientEcdsaCapable(const SSL_CLIENT_HELLO* ssl_client_hello);
   bool isClientOcspCapable(const SSL_CLIENT_HELLO* ssl_client_hello);
   OcspStapleAction ocspStapleAction(const ServerContextImpl::TlsContext& ctx,
                                     bool client_ocsp_capable);
 
-  SessionContextID generateHashForSessionContextId(const std::vector<std::string>& server_names);
+  SessionContextID generateHashForSessionContextId(const std::vector<std::string>& server_names,
+                                                   const Envoy::Ssl::ServerContextConfig& config);
 
   const std::vector<Envoy::Ssl::ServerContextConfig::SessionTicketKey> session_ticket_keys_;
   const Ssl::ServerContextConfig::OcspStaplePolicy ocsp_staple_policy_;
+  SessionContextID session_id_context_;
+  const SessionCacheSharedPtr session_cache_;
+  // The names of the per server name handshake stats, keyed by the lowercase server names the
+  // context is selected for. These are empty if it is not selected by server name.
+  absl::flat_hash_map<std::string, Stats::StatName> server_name_stat_names_;
+  const Stats::StatName ssl_sni_;
+  const Stats::StatName sni_other_;
+  const Stats::StatName sni_handshake_;
+  const Stats::StatName sni_session_reused_;
 };
 
 } // namespace Tls
@@ -15,6 +15,14 @@ namespace Extensions {
 namespace TransportSockets {
 namespace Tls {
 
+namespace {
+
+// The shared session cache holds as many sessions as the internal cache of a BoringSSL context.
+constexpr uint32_t SharedSessionCacheShards = 16;
+constexpr uint64_t SharedSessionCacheMaxSessions = 20 * 1024;
+
+} // namespace
+
 ContextManagerImpl::~ContextManagerImpl() {
   removeEmptyContexts();
   KNOWN_ISSUE_ASSERT(contexts_.empty(), "https://github.com/envoyproxy/envoy/issues/10030");
@@ -59,8 +67,13 @@ Envoy::Ssl::ServerContextSharedPtr ContextManagerImpl::createSslServerContext(
     return nullptr;
   }
 
-  Envoy::Ssl::ServerContextSharedPtr context =
-      std::make_shared<ServerContextImpl>(scope, config, server_names, time_source_);
+  if (config.sharedSessionCache() && shared_session_cache_ == nullptr) {
+    shared_session_cache_ = std::make_shared<ShardedSessionCache>(
+        time_source_, SharedSessionCacheShards, SharedSessionCacheMaxSessions);
+  }
+  Envoy::Ssl::ServerContextSharedPtr context = std::make_shared<ServerContextImpl>(
+      scope, config, server_names, time_source_,
+      config.sharedSessionCache() ? shared_session_cache_ : nullptr);
   removeOldContext(old_context);
   removeEmptyContexts();
   contexts_.emplace_back(context);
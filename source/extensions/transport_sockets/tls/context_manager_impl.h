@@ -9,6 +9,7 @@
 #include "envoy/stats/scope.h"
 
 #include "extensions/transport_sockets/tls/private_key/private_key_manager_impl.h"
+#include "extensions/transport_sockets/tls/session_cache.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -47,6 +48,9 @@ private:
   void removeOldContext(std::shared_ptr<Envoy::Ssl::Context> old_context);
   TimeSource& time_source_;
   std::list<std::weak_ptr<Envoy::Ssl::Context>> contexts_;
+  // Created along with the first server context configured to use it, and held by the contexts
+  // using it since they may outlive the manager.
+  SessionCacheSharedPtr shared_session_cache_;
   PrivateKeyMethodManagerImpl private_key_method_manager_{};
 };
 
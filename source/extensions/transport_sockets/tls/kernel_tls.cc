@@ -0,0 +1,227 @@
+#include "extensions/transport_sockets/tls/kernel_tls.h"
+
+#include <cstring>
+#include <vector>
+
+#include "envoy/common/platform.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/macros.h"
+
+#include "openssl/mem.h"
+
+#if defined(__linux__)
+#include <linux/tls.h>
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+#if defined(__linux__)
+
+namespace {
+
+// Older libc headers lack the definitions of the kernel TLS socket options.
+#ifndef SOL_TLS
+constexpr int SOL_TLS = 282;
+#endif
+#ifndef TCP_ULP
+constexpr int TCP_ULP = 31;
+#endif
+
+// The TLS 1.2 record and alert types, from RFC 5246.
+constexpr uint8_t TLS_RECORD_TYPE_ALERT = 21;
+constexpr uint8_t TLS_ALERT_LEVEL_WARNING = 1;
+constexpr uint8_t TLS_ALERT_CLOSE_NOTIFY = 0;
+
+// AES-GCM cipher suites use no MAC key, and a 4 byte implicit nonce per direction.
+constexpr size_t AES_GCM_SALT_SIZE = 4;
+
+void writeBigEndianSequence(uint64_t sequence, unsigned char* out) {
+  for (int i = 7; i >= 0; --i) {
+    out[i] = sequence & 0xff;
+    sequence >>= 8;
+  }
+}
+
+// Installs the key of one direction of a connection using the cipher described by CryptoInfo,
+// one of the tls12_crypto_info_aes_gcm_* structures.
+template <class CryptoInfo>
+bool setCryptoInfo(Network::IoHandle& io_handle, int direction, uint16_t cipher_type,
+                   const uint8_t* key, const uint8_t* salt, uint64_t sequence) {
+  CryptoInfo crypto_info{};
+  static_assert(sizeof(crypto_info.iv) == sizeof(sequence), "unexpected explicit nonce size");
+  static_assert(sizeof(crypto_info.salt) == AES_GCM_SALT_SIZE, "unexpected implicit nonce size");
+  crypto_info.info.version = TLS_1_2_VERSION;
+  crypto_info.info.cipher_type = cipher_type;
+  memcpy(crypto_info.key, key, sizeof(crypto_info.key));
+  memcpy(crypto_info.salt, salt, sizeof(crypto_info.salt));
+  // BoringSSL uses the record sequence number as the explicit nonce of each record, as the
+  // kernel does once given the sequence number of the next record as the initial nonce.
+  writeBigEndianSequence(sequence, crypto_info.iv);
+  writeBigEndianSequence(sequence, crypto_info.rec_seq);
+  const bool installed =
+      io_handle.setOption(SOL_TLS, direction, &crypto_info, sizeof(crypto_info)).rc_ == 0;
+  OPENSSL_cleanse(&crypto_info, sizeof(crypto_info));
+  return installed;
+}
+
+bool setCryptoInfo(Network::IoHandle& io_handle, int direction, int cipher_nid, const uint8_t* key,
+                   const uint8_t* salt, uint64_t sequence) {
+  switch (cipher_nid) {
+  case NID_aes_128_gcm:
+    return setCryptoInfo<tls12_crypto_info_aes_gcm_128>(io_handle, direction,
+                                                        TLS_CIPHER_AES_GCM_128, key, salt,
+                                                        sequence);
+#ifdef TLS_CIPHER_AES_GCM_256
+  case NID_aes_256_gcm:
+    return setCryptoInfo<tls12_crypto_info_aes_gcm_256>(io_handle, direction,
+                                                        TLS_CIPHER_AES_GCM_256, key, salt,
+                                                        sequence);
+#endif
+  default:
+    return false;
+  }
+}
+
+size_t keySize(int cipher_nid) {
+  switch (cipher_nid) {
+  case NID_aes_128_gcm:
+    return TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+#ifdef TLS_CIPHER_AES_GCM_256
+  case NID_aes_256_gcm:
+    return TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+#endif
+  default:
+    return 0;
+  }
+}
+
+} // namespace
+
+KernelTlsOffload enableKernelTls(SSL* ssl, Network::IoHandle& io_handle) {
+  KernelTlsOffload offload;
+  // TLS 1.3 would need the traffic secrets of the connection, which BoringSSL does not expose, and
+  // renegotiation or key updates cannot be handed to the kernel.
+  offload.unsupported_cipher_ = true;
+  if (SSL_version(ssl) != TLS1_2_VERSION) {
+    return offload;
+  }
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  if (cipher == nullptr) {
+    return offload;
+  }
+  const int cipher_nid = SSL_CIPHER_get_cipher_nid(cipher);
+  const size_t key_size = keySize(cipher_nid);
+  if (key_size == 0) {
+    return offload;
+  }
+
+  // The key block of AEAD cipher suites holds the client and server write keys, followed by the
+  // client and server implicit nonces.
+  std::vector<uint8_t> key_block(SSL_get_key_block_len(ssl));
+  if (key_block.size() != 2 * (key_size + AES_GCM_SALT_SIZE)) {
+    return offload;
+  }
+  offload.unsupported_cipher_ = false;
+  if (!SSL_generate_key_block(ssl, key_block.data(), key_block.size())) {
+    return offload;
+  }
+  const uint8_t* client_key = key_block.data();
+  const uint8_t* server_key = client_key + key_size;
+  const uint8_t* client_salt = server_key + key_size;
+  const uint8_t* server_salt = client_salt + AES_GCM_SALT_SIZE;
+  const bool is_server = SSL_is_server(ssl);
+
+  // Both directions are offloaded or neither: with only the transmit direction offloaded, the
+  // alerts BoringSSL writes while reading would be encrypted again by the kernel, as application
+  // data. A direction cannot be taken back from the kernel once offloaded, so the receive
+  // direction goes first. Records which BoringSSL already read from the socket could not be
+  // decrypted by the kernel, so it must have none buffered.
+  static const char ulp_name[] = "tls";
+  if (!SSL_has_pending(ssl) &&
+      io_handle.setOption(IPPROTO_TCP, TCP_ULP, ulp_name, sizeof(ulp_name)).rc_ == 0) {
+    offload.rx_ = setCryptoInfo(io_handle, TLS_RX, cipher_nid,
+                                is_server ? client_key : server_key,
+                                is_server ? client_salt : server_salt, SSL_get_read_sequence(ssl));
+    // Should the transmit direction fail after this succeeded, BoringSSL keeps writing records,
+    // alerts included, to the socket as before, and is no longer asked to read any.
+    if (offload.rx_) {
+      offload.tx_ = setCryptoInfo(io_handle, TLS_TX, cipher_nid,
+                                  is_server ? server_key : client_key,
+                                  is_server ? server_salt : client_salt,
+                                  SSL_get_write_sequence(ssl));
+    }
+  }
+  OPENSSL_cleanse(key_block.data(), key_block.size());
+  return offload;
+}
+
+bool sendKernelTlsCloseNotify(Network::IoHandle& io_handle) {
+  uint8_t alert[] = {TLS_ALERT_LEVEL_WARNING, TLS_ALERT_CLOSE_NOTIFY};
+  iovec iov{alert, sizeof(alert)};
+  char control[CMSG_SPACE(sizeof(uint8_t))]{};
+
+  msghdr message{};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+  *CMSG_DATA(cmsg) = TLS_RECORD_TYPE_ALERT;
+
+  const Api::SysCallSizeResult result =
+      Api::OsSysCallsSingleton::get().sendmsg(io_handle.fdDoNotUse(), &message, MSG_NOSIGNAL);
+  return result.rc_ == sizeof(alert);
+}
+
+bool readKernelTlsCloseNotify(Network::IoHandle& io_handle) {
+  uint8_t alert[2];
+  iovec iov{alert, sizeof(alert)};
+  char control[CMSG_SPACE(sizeof(uint8_t))]{};
+
+  msghdr message{};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  const Api::SysCallSizeResult result =
+      Api::OsSysCallsSingleton::get().recvmsg(io_handle.fdDoNotUse(), &message, 0);
+  if (result.rc_ != sizeof(alert)) {
+    return false;
+  }
+  const cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  return cmsg != nullptr && cmsg->cmsg_level == SOL_TLS &&
+         cmsg->cmsg_type == TLS_GET_RECORD_TYPE && *CMSG_DATA(cmsg) == TLS_RECORD_TYPE_ALERT &&
+         alert[1] == TLS_ALERT_CLOSE_NOTIFY;
+}
+
+#else
+
+KernelTlsOffload enableKernelTls(SSL* ssl, Network::IoHandle& io_handle) {
+  UNREFERENCED_PARAMETER(ssl);
+  UNREFERENCED_PARAMETER(io_handle);
+  return {};
+}
+
+bool sendKernelTlsCloseNotify(Network::IoHandle& io_handle) {
+  UNREFERENCED_PARAMETER(io_handle);
+  return false;
+}
+
+bool readKernelTlsCloseNotify(Network::IoHandle& io_handle) {
+  UNREFERENCED_PARAMETER(io_handle);
+  return false;
+}
+
+#endif
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "envoy/network/io_handle.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * The directions of a TLS connection whose records are encrypted or decrypted by the kernel.
+ */
+struct KernelTlsOffload {
+  // Records written to the socket are encrypted by the kernel.
+  bool tx_{};
+  // Records read from the socket are decrypted by the kernel.
+  bool rx_{};
+  // Nothing was offloaded because the kernel cannot protect the records of the protocol version or
+  // cipher suite of the connection, rather than because kernel TLS is unavailable.
+  bool unsupported_cipher_{};
+};
+
+/**
+ * Hands the record protection of a TLS connection to the kernel TLS (kTLS) module, so that
+ * application data is written to and read from the socket in plaintext. This is only supported on
+ * Linux for TLS 1.2 connections using AES-GCM. The transmit direction is only offloaded along with
+ * the receive direction, so that BoringSSL never writes alerts to a socket whose records the
+ * kernel encrypts, and nothing is offloaded if BoringSSL has records of the connection buffered.
+ * @param ssl the connection, whose handshake must be complete. SSL_write() must not be called on
+ *        it once the transmit direction is offloaded, nor SSL_read() once the receive direction is.
+ * @param io_handle the socket of the connection.
+ * @return KernelTlsOffload the directions which were offloaded, none if kTLS is unsupported.
+ */
+KernelTlsOffload enableKernelTls(SSL* ssl, Network::IoHandle& io_handle);
+
+/**
+ * Sends a close_notify alert on a socket whose transmit direction is offloaded to the kernel.
+ * @param io_handle the socket of the connection.
+ * @return bool whether the alert was written to the socket.
+ */
+bool sendKernelTlsCloseNotify(Network::IoHandle& io_handle);
+
+/**
+ * Reads the record at the head of a socket whose receive direction is offloaded to the kernel,
+ * when reads of application data fail because the record is of another type.
+ * @param io_handle the socket of the connection.
+ * @return bool whether the record is a close_notify alert.
+ */
+bool readKernelTlsCloseNotify(Network::IoHandle& io_handle);
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
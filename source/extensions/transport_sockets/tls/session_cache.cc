@@ -0,0 +1,106 @@
+#include "extensions/transport_sockets/tls/session_cache.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "common/common/assert.h"
+#include "common/common/hash.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+ShardedSessionCache::ShardedSessionCache(TimeSource& time_source, uint32_t num_shards,
+                                         uint64_t max_sessions)
+    : time_source_(time_source),
+      max_sessions_per_shard_(std::max<uint64_t>(1, max_sessions / num_shards)),
+      shards_(num_shards) {
+  ASSERT(num_shards > 0);
+}
+
+void ShardedSessionCache::insert(bssl::UniquePtr<SSL_SESSION> session) {
+  unsigned int session_id_length;
+  const uint8_t* session_id = SSL_SESSION_get_id(session.get(), &session_id_length);
+  unsigned int session_id_context_length;
+  const uint8_t* session_id_context =
+      SSL_SESSION_get0_id_context(session.get(), &session_id_context_length);
+  const std::string session_key =
+      key({session_id_context, session_id_context_length}, {session_id, session_id_length});
+
+  Shard& shard = shardForKey(session_key);
+  absl::MutexLock lock(&shard.mutex_);
+  const auto existing = shard.entries_.find(session_key);
+  if (existing != shard.entries_.end()) {
+    shard.erase(existing);
+  } else if (shard.entries_.size() >= max_sessions_per_shard_) {
+    shard.erase(shard.entries_.find(shard.lru_.back()));
+  }
+  shard.lru_.push_front(session_key);
+  Entry& entry = shard.entries_[session_key];
+  entry.session = std::move(session);
+  entry.lru_position = shard.lru_.begin();
+}
+
+bssl::UniquePtr<SSL_SESSION>
+ShardedSessionCache::lookup(absl::Span<const uint8_t> session_id_context,
+                            absl::Span<const uint8_t> session_id) {
+  const std::string session_key = key(session_id_context, session_id);
+  Shard& shard = shardForKey(session_key);
+  absl::MutexLock lock(&shard.mutex_);
+  const auto entry = shard.entries_.find(session_key);
+  if (entry == shard.entries_.end()) {
+    return nullptr;
+  }
+  if (expired(entry->second.session.get())) {
+    shard.erase(entry);
+    return nullptr;
+  }
+  shard.lru_.splice(shard.lru_.begin(), shard.lru_, entry->second.lru_position);
+  // The session is shared with the connection resuming it, which only reads it.
+  return bssl::UpRef(entry->second.session);
+}
+
+size_t ShardedSessionCache::size() const {
+  size_t size = 0;
+  for (const Shard& shard : shards_) {
+    absl::MutexLock lock(&shard.mutex_);
+    size += shard.entries_.size();
+  }
+  return size;
+}
+
+void ShardedSessionCache::Shard::erase(absl::flat_hash_map<std::string, Entry>::iterator entry) {
+  lru_.erase(entry->second.lru_position);
+  entries_.erase(entry);
+}
+
+std::string ShardedSessionCache::key(absl::Span<const uint8_t> session_id_context,
+                                     absl::Span<const uint8_t> session_id) {
+  // Session ID contexts are at most SSL_MAX_SID_CTX_LENGTH bytes long, so that a length byte
+  // separates them from the session ID.
+  ASSERT(session_id_context.size() <= SSL_MAX_SID_CTX_LENGTH);
+  std::string key;
+  key.reserve(1 + session_id_context.size() + session_id.size());
+  key.push_back(static_cast<char>(session_id_context.size()));
+  key.append(reinterpret_cast<const char*>(session_id_context.data()), session_id_context.size());
+  key.append(reinterpret_cast<const char*>(session_id.data()), session_id.size());
+  return key;
+}
+
+ShardedSessionCache::Shard& ShardedSessionCache::shardForKey(const std::string& key) {
+  return shards_[HashUtil::xxHash64(key) % shards_.size()];
+}
+
+bool ShardedSessionCache::expired(const SSL_SESSION* session) const {
+  // Sessions hold the time at which they were established and their lifetime in seconds.
+  const uint64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                           time_source_.systemTime().time_since_epoch())
+                           .count();
+  return SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session) <= now;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
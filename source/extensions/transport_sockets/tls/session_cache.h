@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/pure.h"
+#include "envoy/common/time.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A cache of the TLS sessions established by server contexts, from which they are resumed by
+ * session ID. Unlike the internal cache of a BoringSSL context, it may be shared by several
+ * contexts and outlive them, and it is accessed concurrently from all workers.
+ */
+class SessionCache {
+public:
+  virtual ~SessionCache() = default;
+
+  /**
+   * Stores a session, keyed by its session ID context and its session ID, replacing any session
+   * already stored for them.
+   * @param session the session established by a full handshake.
+   */
+  virtual void insert(bssl::UniquePtr<SSL_SESSION> session) PURE;
+
+  /**
+   * @param session_id_context the session ID context of the context resuming the session.
+   * @param session_id the session ID sent by the client.
+   * @return the unexpired session stored for the session ID context and the session ID, or nullptr
+   *         if there is none.
+   */
+  virtual bssl::UniquePtr<SSL_SESSION> lookup(absl::Span<const uint8_t> session_id_context,
+                                              absl::Span<const uint8_t> session_id) PURE;
+};
+
+using SessionCacheSharedPtr = std::shared_ptr<SessionCache>;
+
+/**
+ * A SessionCache split in shards by the hash of the session key, each guarded by its own lock so
+ * that handshakes on different workers rarely contend. Each shard evicts its least recently used
+ * session once it holds its share of the maximum number of sessions.
+ */
+class ShardedSessionCache : public SessionCache {
+public:
+  ShardedSessionCache(TimeSource& time_source, uint32_t num_shards, uint64_t max_sessions);
+
+  // SessionCache
+  void insert(bssl::UniquePtr<SSL_SESSION> session) override;
+  bssl::UniquePtr<SSL_SESSION> lookup(absl::Span<const uint8_t> session_id_context,
+                                      absl::Span<const uint8_t> session_id) override;
+
+  /**
+   * @return size_t the number of sessions in the cache, including expired ones not yet evicted.
+   */
+  size_t size() const;
+
+private:
+  using LruList = std::list<std::string>;
+
+  struct Entry {
+    bssl::UniquePtr<SSL_SESSION> session;
+    LruList::iterator lru_position;
+  };
+
+  struct Shard {
+    void erase(absl::flat_hash_map<std::string, Entry>::iterator entry)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+    mutable absl::Mutex mutex_;
+    absl::flat_hash_map<std::string, Entry> entries_ ABSL_GUARDED_BY(mutex_);
+    // The keys of the entries, from the most to the least recently used.
+    LruList lru_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  static std::string key(absl::Span<const uint8_t> session_id_context,
+                         absl::Span<const uint8_t> session_id);
+  Shard& shardForKey(const std::string& key);
+  bool expired(const SSL_SESSION* session) const;
+
+  TimeSource& time_source_;
+  const uint64_t max_sessions_per_shard_;
+  std::vector<Shard> shards_;
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -9,6 +9,7 @@
 #include "common/runtime/runtime_features.h"
 
 #include "extensions/transport_sockets/tls/io_handle_bio.h"
+#include "extensions/transport_sockets/tls/kernel_tls.h"
 #include "extensions/transport_sockets/tls/ssl_handshaker.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
@@ -51,6 +52,8 @@ SslSocket::SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
                      Ssl::HandshakerFactoryCb handshaker_factory_cb)
     : transport_socket_options_(transport_socket_options),
       ctx_(std::dynamic_pointer_cast<ContextImpl>(ctx)),
+      write_records_per_slice_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.tls_write_records_per_slice")),
       info_(std::dynamic_pointer_cast<SslHandshakerImpl>(
           handshaker_factory_cb(ctx_->newSsl(transport_socket_options_.get()),
                                 ctx_->sslExtendedSocketInfoIndex(), this))) {
@@ -118,6 +121,10 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
     }
   }
 
+  if (kernel_tls_.rx_) {
+    return doKernelTlsRead(read_buffer);
+  }
+
   bool keep_reading = true;
   bool end_stream = false;
   PostIoAction action = PostIoAction::KeepOpen;
@@ -177,6 +184,46 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
   return {action, bytes_read, end_stream};
 }
 
+Network::IoResult SslSocket::doKernelTlsRead(Buffer::Instance& read_buffer) {
+  PostIoAction action = PostIoAction::KeepOpen;
+  uint64_t bytes_read = 0;
+  bool end_stream = false;
+  do {
+    // The kernel decrypts the records, so the socket is read from like a raw buffer socket.
+    Api::IoCallUint64Result result = callbacks_->ioHandle().read(read_buffer, 16384);
+
+    if (result.ok()) {
+      ENVOY_CONN_LOG(trace, "kernel tls read returns: {}", callbacks_->connection(), result.rc_);
+      if (result.rc_ == 0) {
+        // Non-graceful shutdown by closing the underlying socket.
+        end_stream = true;
+        break;
+      }
+      bytes_read += result.rc_;
+      if (callbacks_->shouldDrainReadBuffer()) {
+        callbacks_->setTransportSocketIsReadable();
+        break;
+      }
+    } else {
+      ENVOY_CONN_LOG(trace, "kernel tls read error: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails());
+      if (result.err_->getErrorCode() != Api::IoError::IoErrorCode::Again) {
+        // Reads fail on records other than application data, which have to be received along
+        // with their record type.
+        if (readKernelTlsCloseNotify(callbacks_->ioHandle())) {
+          // Graceful shutdown using close_notify TLS alert.
+          end_stream = true;
+        } else {
+          action = PostIoAction::Close;
+        }
+      }
+      break;
+    }
+  } while (true);
+
+  return {action, bytes_read, end_stream};
+}
+
 void SslSocket::onPrivateKeyMethodComplete() {
   ASSERT(isThreadSafe());
   ASSERT(info_->state() == Ssl::SocketState::HandshakeInProgress);
@@ -193,9 +240,28 @@ Network::Connection& SslSocket::connection() const { return callbacks_->connecti
 
 void SslSocket::onSuccess(SSL* ssl) {
   ctx_->logHandshake(ssl);
+  if (ctx_->kernelTlsOffload()) {
+    offloadToKernelTls(ssl);
+  }
   callbacks_->raiseEvent(Network::ConnectionEvent::Connected);
 }
 
+void SslSocket::offloadToKernelTls(SSL* ssl) {
+  kernel_tls_ = enableKernelTls(ssl, callbacks_->ioHandle());
+  if (kernel_tls_.tx_) {
+    ctx_->stats().kernel_tls_tx_offloaded_.inc();
+  } else if (kernel_tls_.unsupported_cipher_) {
+    ctx_->stats().kernel_tls_unsupported_cipher_.inc();
+  } else {
+    ctx_->stats().kernel_tls_unavailable_.inc();
+  }
+  if (kernel_tls_.rx_) {
+    ctx_->stats().kernel_tls_rx_offloaded_.inc();
+  }
+  ENVOY_CONN_LOG(debug, "kernel tls offload: tx={} rx={}", callbacks_->connection(),
+                 kernel_tls_.tx_, kernel_tls_.rx_);
+}
+
 void SslSocket::onFailure() { drainErrorQueue(); }
 
 PostIoAction SslSocket::doHandshake() { return info_->doHandshake(); }
@@ -239,12 +305,16 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     }
   }
 
+  if (kernel_tls_.tx_) {
+    return doKernelTlsWrite(write_buffer, end_stream);
+  }
+
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
     bytes_to_write = bytes_to_retry_;
     bytes_to_retry_ = 0;
   } else {
-    bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+    bytes_to_write = nextRecordSize(write_buffer);
   }
 
   uint64_t total_bytes_written = 0;
@@ -262,7 +332,7 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
       ASSERT(rc == static_cast<int>(bytes_to_write));
       total_bytes_written += rc;
       write_buffer.drain(rc);
-      bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+      bytes_to_write = nextRecordSize(write_buffer);
     } else {
       int err = SSL_get_error(rawSsl(), rc);
       switch (err) {
@@ -287,6 +357,50 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
   return {PostIoAction::KeepOpen, total_bytes_written, false};
 }
 
+Network::IoResult SslSocket::doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream) {
+  PostIoAction action;
+  uint64_t bytes_written = 0;
+  do {
+    if (write_buffer.length() == 0) {
+      if (end_stream) {
+        shutdownSsl();
+      }
+      action = PostIoAction::KeepOpen;
+      break;
+    }
+    // The kernel encrypts the data into records, so the whole buffer is written at once rather
+    // than in chunks of the maximum record size.
+    Api::IoCallUint64Result result = callbacks_->ioHandle().write(write_buffer);
+
+    if (result.ok()) {
+      ENVOY_CONN_LOG(trace, "kernel tls write returns: {}", callbacks_->connection(), result.rc_);
+      bytes_written += result.rc_;
+    } else {
+      ENVOY_CONN_LOG(trace, "kernel tls write error: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails());
+      if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+        action = PostIoAction::KeepOpen;
+      } else {
+        action = PostIoAction::Close;
+      }
+      break;
+    }
+  } while (true);
+
+  return {action, bytes_written, false};
+}
+
+uint64_t SslSocket::nextRecordSize(const Buffer::Instance& write_buffer) {
+  const uint64_t record_size = write_records_per_slice_
+                                   ? Utility::nextRecordSize(write_buffer)
+                                   : std::min(write_buffer.length(), Utility::MaxTlsRecordSize);
+  // linearize() copies the record into a new slice when it spans several slices.
+  if (write_buffer.frontSlice().len_ < record_size) {
+    ctx_->stats().write_bytes_linearized_.add(record_size);
+  }
+  return record_size;
+}
+
 void SslSocket::onConnected() { ASSERT(info_->state() == Ssl::SocketState::PreHandshake); }
 
 Ssl::ConnectionInfoConstSharedPtr SslSocket::ssl() const { return info_; }
@@ -295,19 +409,25 @@ void SslSocket::shutdownSsl() {
   ASSERT(info_->state() != Ssl::SocketState::PreHandshake);
   if (info_->state() != Ssl::SocketState::ShutdownSent &&
       callbacks_->connection().state() != Network::Connection::State::Closed) {
-    int rc = SSL_shutdown(rawSsl());
-    if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
-      // Windows operate under `EmulatedEdge`. These are level events that are artificially
-      // made to behave like edge events. And if the rc is 0 then in that case we want read
-      // activation resumption. This code is protected with an `constexpr` if, to minimize the tax
-      // on POSIX systems that operate in Edge events.
-      if (rc == 0) {
-        // See https://www.openssl.org/docs/manmaster/man3/SSL_shutdown.html
-        // if return value is 0,  Call SSL_read() to do a bidirectional shutdown.
-        callbacks_->setTransportSocketIsReadable();
+    if (kernel_tls_.tx_) {
+      // BoringSSL no longer knows the sequence number of the next record written by the kernel.
+      const bool sent = sendKernelTlsCloseNotify(callbacks_->ioHandle());
+      ENVOY_CONN_LOG(debug, "kernel tls shutdown: sent={}", callbacks_->connection(), sent);
+    } else {
+      int rc = SSL_shutdown(rawSsl());
+      if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
+        // Windows operate under `EmulatedEdge`. These are level events that are artificially
+        // made to behave like edge events. And if the rc is 0 then in that case we want read
+        // activation resumption. This code is protected with an `constexpr` if, to minimize the
+        // tax on POSIX systems that operate in Edge events.
+        if (rc == 0) {
+          // See https://www.openssl.org/docs/manmaster/man3/SSL_shutdown.html
+          // if return value is 0,  Call SSL_read() to do a bidirectional shutdown.
+          callbacks_->setTransportSocketIsReadable();
+        }
       }
+      ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
     }
-    ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
     drainErrorQueue();
     info_->setState(Ssl::SocketState::ShutdownSent);
   }
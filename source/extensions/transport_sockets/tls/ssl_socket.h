@@ -16,6 +16,7 @@
 #include "common/common/logger.h"
 
 #include "extensions/transport_sockets/tls/context_impl.h"
+#include "extensions/transport_sockets/tls/kernel_tls.h"
 #include "extensions/transport_sockets/tls/ssl_handshaker.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
@@ -82,6 +83,10 @@ private:
   ReadResult sslReadIntoSlice(Buffer::RawSlice& slice);
 
   Network::PostIoAction doHandshake();
+  void offloadToKernelTls(SSL* ssl);
+  Network::IoResult doKernelTlsRead(Buffer::Instance& read_buffer);
+  Network::IoResult doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream);
+  uint64_t nextRecordSize(const Buffer::Instance& write_buffer);
   void drainErrorQueue();
   void shutdownSsl();
   void shutdownBasic();
@@ -93,7 +98,12 @@ private:
   Network::TransportSocketCallbacks* callbacks_{};
   ContextImplSharedPtr ctx_;
   uint64_t bytes_to_retry_{};
+  const bool write_records_per_slice_;
   std::string failure_reason_;
+  // Offloaded connections are not reported as passing bytes through, so that they are not spliced:
+  // splice(2) fails with EIO on the close_notify alert of the peer, and shutting the socket down
+  // does not send one.
+  KernelTlsOffload kernel_tls_;
 
   SslHandshakerImplSharedPtr info_;
 };
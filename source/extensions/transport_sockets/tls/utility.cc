@@ -214,6 +214,28 @@ absl::optional<std::string> Utility::getLastCryptoError() {
   return absl::nullopt;
 }
 
+uint64_t Utility::nextRecordSize(const Buffer::Instance& buffer) {
+  // The number of slices fits the inline storage of RawSliceVector.
+  uint64_t record_size = 0;
+  for (const Buffer::RawSlice& slice : buffer.getRawSlices(16)) {
+    if (slice.len_ >= MinUncoalescedRecordSize) {
+      if (record_size >= MinUncoalescedRecordSize) {
+        // The slices before the long slice make a large enough record of their own.
+        return record_size;
+      }
+      // A short prefix, such as an HTTP/2 frame header, is coalesced into the long slice rather
+      // than being encrypted and written as a tiny record. The record ends with the long slice, so
+      // that the slices after it don't cause it to be copied.
+      return std::min<uint64_t>(record_size + slice.len_, MaxTlsRecordSize);
+    }
+    record_size += slice.len_;
+    if (record_size >= MaxTlsRecordSize) {
+      return MaxTlsRecordSize;
+    }
+  }
+  return record_size;
+}
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 
+#include "envoy/buffer/buffer.h"
+
 #include "common/common/utility.h"
 
 #include "absl/types/optional.h"
@@ -89,6 +91,27 @@ SystemTime getExpirationTime(const X509& cert);
  */
 absl::optional<std::string> getLastCryptoError();
 
+/**
+ * The maximum size of the plaintext of a TLS record.
+ */
+constexpr uint64_t MaxTlsRecordSize = 16384;
+
+/**
+ * Slices of a buffer holding at least this many bytes end TLS records, rather than being coalesced
+ * with the slices after them. Slices before a long slice make a record of their own if they hold at
+ * least this many bytes together, and are coalesced into the long slice otherwise.
+ */
+constexpr uint64_t MinUncoalescedRecordSize = 4096;
+
+/**
+ * Returns the number of bytes from the front of a buffer to pass to SSL_write() for the next TLS
+ * record. Records end at the boundaries of long slices, so that linearize() copies as little data
+ * as possible without writing tiny records.
+ * @param buffer the buffer to write.
+ * @return uint64_t the size of the next record, 0 if the buffer is empty.
+ */
+uint64_t nextRecordSize(const Buffer::Instance& buffer);
+
 } // namespace Utility
 } // namespace Tls
 } // namespace TransportSockets
@@ -14,9 +14,11 @@
 #include "common/access_log/access_log_impl.h"
 #include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
+#include "common/common/utility.h"
 #include "common/config/utility.h"
 #include "common/network/connection_balancer_impl.h"
 #include "common/network/resolver_impl.h"
+#include "common/network/reuse_port_cpu_steering_socket_option_impl.h"
 #include "common/network/socket_option_factory.h"
 #include "common/network/socket_option_impl.h"
 #include "common/network/udp_listener_impl.h"
@@ -85,9 +87,31 @@ ListenSocketFactoryImpl::ListenSocketFactoryImpl(ListenerComponentFactory& facto
                                                  Network::Socket::Type socket_type,
                                                  const Network::Socket::OptionsSharedPtr& options,
                                                  bool bind_to_port,
-                                                 const std::string& listener_name, bool reuse_port)
+                                                 const std::string& listener_name, bool reuse_port,
+                                                 uint32_t cpu_steered_socket_count,
+                                                 uint32_t tcp_backlog_size)
     : factory_(factory), local_address_(address), socket_type_(socket_type), options_(options),
-      bind_to_port_(bind_to_port), listener_name_(listener_name), reuse_port_(reuse_port) {
+      bind_to_port_(bind_to_port), listener_name_(listener_name), reuse_port_(reuse_port),
+      tcp_backlog_size_(tcp_backlog_size) {
+
+  if (cpu_steered_socket_count > 0 && bind_to_port_ &&
+      local_address_->type() == Network::Address::Type::Ip) {
+    ASSERT(reuse_port_ && socket_type_ == Network::Socket::Type::Stream);
+    // The CPU steering program delivers the connections of a CPU to the socket at the index of
+    // the worker pinned to it, and the sockets of a SO_REUSEPORT group are indexed in the order
+    // they start listening. Create the sockets of all the workers up front, so that they can
+    // listen in worker order rather than in the order the workers add the listener.
+    for (uint32_t i = 0; i < cpu_steered_socket_count; ++i) {
+      cpu_steered_sockets_.push_back(createListenSocketAndApplyOptions());
+      if (local_address_->ip()->port() == 0) {
+        // The other sockets bind to the port the first one reserved.
+        local_address_ = cpu_steered_sockets_.back()->addressProvider().localAddress();
+      }
+    }
+    ENVOY_LOG(debug, "Set listener {} socket factory local address to {}", listener_name_,
+              local_address_->asString());
+    return;
+  }
 
   bool create_socket = false;
   if (local_address_->type() == Network::Address::Type::Ip) {
@@ -147,7 +171,11 @@ Network::SocketSharedPtr ListenSocketFactoryImpl::createListenSocketAndApplyOpti
   return socket;
 }
 
-Network::SocketSharedPtr ListenSocketFactoryImpl::getListenSocket() {
+Network::SocketSharedPtr ListenSocketFactoryImpl::getListenSocket(uint32_t worker_index) {
+  if (!cpu_steered_sockets_.empty()) {
+    return getCpuSteeredListenSocket(worker_index);
+  }
+
   if (!reuse_port_) {
     // We want to maintain the invariance that listeners do not share the same
     // underlying socket. For that reason we return a socket based on a duplicated
@@ -176,6 +204,31 @@ Network::SocketSharedPtr ListenSocketFactoryImpl::getListenSocket() {
   return createListenSocketAndApplyOptions();
 }
 
+Network::SocketSharedPtr ListenSocketFactoryImpl::getCpuSteeredListenSocket(uint32_t worker_index) {
+  ASSERT(worker_index < cpu_steered_sockets_.size());
+  {
+    absl::MutexLock lock(&listen_mutex_);
+    for (; listening_sockets_ < cpu_steered_sockets_.size(); ++listening_sockets_) {
+      const Api::SysCallIntResult result =
+          cpu_steered_sockets_[listening_sockets_]->listen(tcp_backlog_size_);
+      if (result.rc_ != 0) {
+        throw Network::CreateListenerException(
+            fmt::format("{}: cannot listen on socket {} of the SO_REUSEPORT group: {}",
+                        listener_name_, listening_sockets_, errorDetails(result.errno_)));
+      }
+    }
+  }
+
+  // Each listener of the worker, including those of in place listener updates, gets a duplicate
+  // of the worker's socket, which keeps its index in the group.
+  Network::SocketSharedPtr socket = cpu_steered_sockets_[worker_index]->duplicate();
+  if (options_ != nullptr) {
+    // The program is attached once the worker listens.
+    socket->addOptions(options_);
+  }
+  return socket;
+}
+
 ListenerFactoryContextBaseImpl::ListenerFactoryContextBaseImpl(
     Envoy::Server::Instance& server, ProtobufMessage::ValidationVisitor& validation_visitor,
     const envoy::config::listener::v3::Listener& config, DrainManagerPtr drain_manager)
@@ -311,7 +364,7 @@ ListenerImpl::ListenerImpl(const envoy::config::listener::v3::Listener& config,
   if (socket_type == Network::Socket::Type::Datagram) {
     return;
   }
-  buildSocketOptions();
+  buildSocketOptions(concurrency);
   buildOriginalDstListenerFilter();
   buildProxyProtocolListenerFilter();
   buildTlsInspectorListenerFilter();
@@ -367,7 +420,7 @@ ListenerImpl::ListenerImpl(ListenerImpl& origin,
   validateFilterChains(socket_type);
   buildFilterChains();
   // In place update is tcp only so it's safe to apply below tcp only initialization.
-  buildSocketOptions();
+  buildSocketOptions(concurrency);
   buildOriginalDstListenerFilter();
   buildProxyProtocolListenerFilter();
   buildTlsInspectorListenerFilter();
@@ -515,19 +568,34 @@ void ListenerImpl::buildFilterChains() {
       filter_chain_manager_);
 }
 
-void ListenerImpl::buildSocketOptions() {
+void ListenerImpl::buildSocketOptions(uint32_t concurrency) {
   // TCP specific setup.
   if (connection_balancer_ == nullptr) {
     // Not in place listener update.
-    if (config_.has_connection_balance_config()) {
-      // Currently exact balance is the only supported type and there are no options.
-      ASSERT(config_.connection_balance_config().has_exact_balance());
+    if (config_.connection_balance_config().has_exact_balance()) {
       connection_balancer_ = std::make_shared<Network::ExactConnectionBalancerImpl>();
     } else {
+      // With CPU balance, connections are balanced by the kernel before they are accepted.
       connection_balancer_ = std::make_shared<Network::NopConnectionBalancerImpl>();
     }
   }
 
+  if (config_.connection_balance_config().has_cpu_balance()) {
+    if (!config_.reuse_port()) {
+      throw EnvoyException(
+          fmt::format("error adding listener '{}': cpu_balance requires reuse_port to be set",
+                      address_->asString()));
+    }
+    if (!Network::ReusePortCpuSteeringSocketOptionImpl::isSupported()) {
+      throw EnvoyException(
+          fmt::format("error adding listener '{}': cpu_balance is not supported on this platform",
+                      address_->asString()));
+    }
+    addListenSocketOptions(
+        Network::SocketOptionFactory::buildReusePortCpuSteeringOptions(
+            concurrency, parent_.server_.options().workerCpuSet()));
+  }
+
   if (config_.has_tcp_fast_open_queue_length()) {
     addListenSocketOptions(Network::SocketOptionFactory::buildTcpFastOpenOptions(
         config_.tcp_fast_open_queue_length().value()));
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/config/core/v3/base.pb.h"
@@ -21,6 +22,7 @@
 #include "server/filter_chain_manager_impl.h"
 
 #include "absl/base/call_once.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Server {
@@ -43,7 +45,8 @@ public:
                           Network::Address::InstanceConstSharedPtr address,
                           Network::Socket::Type socket_type,
                           const Network::Socket::OptionsSharedPtr& options, bool bind_to_port,
-                          const std::string& listener_name, bool reuse_port);
+                          const std::string& listener_name, bool reuse_port,
+                          uint32_t cpu_steered_socket_count, uint32_t tcp_backlog_size);
 
   // Network::ListenSocketFactory
   Network::Socket::Type socketType() const override { return socket_type_; }
@@ -51,7 +54,7 @@ public:
     return local_address_;
   }
 
-  Network::SocketSharedPtr getListenSocket() override;
+  Network::SocketSharedPtr getListenSocket(uint32_t worker_index) override;
 
   /**
    * @return the socket shared by worker threads; otherwise return null.
@@ -69,6 +72,9 @@ public:
 protected:
   Network::SocketSharedPtr createListenSocketAndApplyOptions();
 
+private:
+  Network::SocketSharedPtr getCpuSteeredListenSocket(uint32_t worker_index);
+
 private:
   ListenerComponentFactory& factory_;
   // Initially, its port number might be 0. Once a socket is created, its port
@@ -81,6 +87,12 @@ private:
   const bool reuse_port_;
   Network::SocketSharedPtr socket_;
   absl::once_flag steal_once_;
+  // With CPU steering, the sockets of the workers in worker order. They make up the SO_REUSEPORT
+  // group of the listener, and listen in that order once the first worker gets its socket.
+  std::vector<Network::SocketSharedPtr> cpu_steered_sockets_;
+  const uint32_t tcp_backlog_size_;
+  absl::Mutex listen_mutex_;
+  uint32_t listening_sockets_ ABSL_GUARDED_BY(listen_mutex_){0};
 };
 
 // TODO(mattklein123): Consider getting rid of pre-worker start and post-worker start code by
@@ -355,7 +367,7 @@ private:
   void createListenerFilterFactories(Network::Socket::Type socket_type);
   void validateFilterChains(Network::Socket::Type socket_type);
   void buildFilterChains();
-  void buildSocketOptions();
+  void buildSocketOptions(uint32_t concurrency);
   void buildOriginalDstListenerFilter();
   void buildProxyProtocolListenerFilter();
   void buildTlsInspectorListenerFilter();
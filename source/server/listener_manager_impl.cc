@@ -1040,9 +1040,16 @@ Network::ListenSocketFactorySharedPtr ListenerManagerImpl::createListenSocketFac
     const envoy::config::core::v3::Address& proto_address, ListenerImpl& listener,
     bool reuse_port) {
   Network::Socket::Type socket_type = Network::Utility::protobufAddressSocketType(proto_address);
+  // CPU balance only applies to TCP listeners.
+  const uint32_t cpu_steered_socket_count =
+      socket_type == Network::Socket::Type::Stream &&
+              listener.config().connection_balance_config().has_cpu_balance()
+          ? server_.options().concurrency()
+          : 0;
   return std::make_shared<ListenSocketFactoryImpl>(
       factory_, listener.address(), socket_type, listener.listenSocketOptions(),
-      listener.bindToPort(), listener.name(), reuse_port);
+      listener.bindToPort(), listener.name(), reuse_port, cpu_steered_socket_count,
+      listener.tcpBacklogSize());
 }
 
 ApiListenerOptRef ListenerManagerImpl::apiListener() {
@@ -14,7 +14,9 @@
 #include "common/version/version.h"
 
 #include "server/options_impl_platform.h"
+#include "server/thread_placement.h"
 
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
@@ -32,6 +34,29 @@ std::vector<std::string> toArgsVector(int argc, const char* const* argv) {
   }
   return args;
 }
+
+// Parses a list of CPUs such as "0-3,8", in the format of the Linux cpuset list files.
+std::vector<uint32_t> parseCpuSet(const std::string& option, const std::string& cpu_list) {
+  std::vector<uint32_t> cpus;
+  if (cpu_list.empty()) {
+    return cpus;
+  }
+  for (const absl::string_view range : absl::StrSplit(cpu_list, ',')) {
+    const std::vector<absl::string_view> bounds = absl::StrSplit(range, absl::MaxSplits('-', 1));
+    uint32_t first;
+    uint32_t last;
+    if (!absl::SimpleAtoi(bounds[0], &first) ||
+        !absl::SimpleAtoi(bounds.size() == 2 ? bounds[1] : bounds[0], &last) || first > last ||
+        last >= Server::ThreadPlacement::MaxCpus) {
+      throw MalformedArgvException(
+          fmt::format("error: invalid CPU list '{}' for --{}", cpu_list, option));
+    }
+    for (uint32_t cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
 } // namespace
 
 OptionsImpl::OptionsImpl(int argc, const char* const* argv,
@@ -126,6 +151,10 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   TCLAP::ValueArg<uint32_t> file_flush_interval_msec("", "file-flush-interval-msec",
                                                      "Interval for log flushing in msec", false,
                                                      10000, "uint32_t", cmd);
+  TCLAP::ValueArg<uint32_t> file_flush_ring_buffer_bytes(
+      "", "file-flush-ring-buffer-bytes",
+      "Size of the per thread log buffers of each file, or 0 to share one buffer", false, 0,
+      "uint32_t", cmd);
   TCLAP::ValueArg<uint32_t> drain_time_s("", "drain-time-s",
                                          "Hot restart and LDS removal drain time in seconds", false,
                                          600, "uint32_t", cmd);
@@ -146,6 +175,16 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
       "", "enable-mutex-tracing", "Enable mutex contention tracing functionality", cmd, false);
   TCLAP::SwitchArg cpuset_threads(
       "", "cpuset-threads", "Get the default # of worker threads from cpuset size", cmd, false);
+  TCLAP::ValueArg<std::string> worker_cpu_set(
+      "", "worker-cpu-set",
+      "List of CPUs to pin the worker threads to, one per worker in order. For example 0-3,8",
+      false, "", "string", cmd);
+  TCLAP::ValueArg<std::string> main_thread_cpu_set(
+      "", "main-thread-cpu-set", "List of CPUs to pin the main thread to. For example 0-1", false,
+      "", "string", cmd);
+  TCLAP::SwitchArg numa_local_memory(
+      "", "numa-local-memory",
+      "Allocate the memory of each pinned worker on the NUMA node of its CPU", cmd, false);
 
   TCLAP::ValueArg<std::string> disable_extensions("", "disable-extensions",
                                                   "Comma-separated list of extensions to disable",
@@ -180,6 +219,18 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
 
   cpuset_threads_ = cpuset_threads.getValue();
 
+  worker_cpu_set_ = parseCpuSet("worker-cpu-set", worker_cpu_set.getValue());
+  main_thread_cpu_set_ = parseCpuSet("main-thread-cpu-set", main_thread_cpu_set.getValue());
+  numa_local_memory_ = numa_local_memory.getValue();
+  if (numa_local_memory_ && worker_cpu_set_.empty()) {
+    throw MalformedArgvException("error: --numa-local-memory requires --worker-cpu-set");
+  }
+  if ((!worker_cpu_set_.empty() || !main_thread_cpu_set_.empty()) &&
+      !Server::ThreadPlacement::supported()) {
+    throw MalformedArgvException(
+        "error: pinning threads to CPUs is not supported on this platform");
+  }
+
   if (log_level.isSet()) {
     log_level_ = parseAndValidateLogLevel(log_level.getValue());
   } else {
@@ -255,6 +306,12 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   service_node_ = service_node.getValue();
   service_zone_ = service_zone.getValue();
   file_flush_interval_msec_ = std::chrono::milliseconds(file_flush_interval_msec.getValue());
+  file_flush_ring_buffer_bytes_ = file_flush_ring_buffer_bytes.getValue();
+  if (file_flush_ring_buffer_bytes_ != 0 && file_flush_ring_buffer_bytes_ < 4096) {
+    throw MalformedArgvException(fmt::format(
+        "error: file-flush-ring-buffer-bytes must be 0 or at least 4096, got {}",
+        file_flush_ring_buffer_bytes_));
+  }
   drain_time_ = std::chrono::seconds(drain_time_s.getValue());
   parent_shutdown_time_ = std::chrono::seconds(parent_shutdown_time_s.getValue());
   socket_path_ = socket_path.getValue();
@@ -383,6 +440,7 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   }
   command_line_options->mutable_file_flush_interval()->MergeFrom(
       Protobuf::util::TimeUtil::MillisecondsToDuration(fileFlushIntervalMsec().count()));
+  command_line_options->set_file_flush_ring_buffer_bytes(fileFlushRingBufferBytes());
 
   command_line_options->mutable_drain_time()->MergeFrom(
       Protobuf::util::TimeUtil::SecondsToDuration(drainTime().count()));
@@ -395,6 +453,13 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   command_line_options->set_disable_hot_restart(hotRestartDisabled());
   command_line_options->set_enable_mutex_tracing(mutexTracingEnabled());
   command_line_options->set_cpuset_threads(cpusetThreadsEnabled());
+  for (const uint32_t cpu : workerCpuSet()) {
+    command_line_options->add_worker_cpu_set(cpu);
+  }
+  for (const uint32_t cpu : mainThreadCpuSet()) {
+    command_line_options->add_main_thread_cpu_set(cpu);
+  }
+  command_line_options->set_numa_local_memory(numaLocalMemoryEnabled());
   command_line_options->set_restart_epoch(restartEpoch());
   for (const auto& e : disabledExtensions()) {
     command_line_options->add_disabled_extensions(e);
@@ -411,11 +476,12 @@ OptionsImpl::OptionsImpl(const std::string& service_cluster, const std::string&
       local_address_ip_version_(Network::Address::IpVersion::v4), log_level_(log_level),
       log_format_(Logger::Logger::DEFAULT_LOG_FORMAT), log_format_escaped_(false),
       restart_epoch_(0u), service_cluster_(service_cluster), service_node_(service_node),
-      service_zone_(service_zone), file_flush_interval_msec_(10000), drain_time_(600),
+      service_zone_(service_zone), file_flush_interval_msec_(10000),
+      file_flush_ring_buffer_bytes_(0), drain_time_(600),
       parent_shutdown_time_(900), drain_strategy_(Server::DrainStrategy::Gradual),
       mode_(Server::Mode::Serve), hot_restart_disabled_(false), signal_handling_enabled_(true),
-      mutex_tracing_enabled_(false), cpuset_threads_(false), socket_path_("@envoy_domain_socket"),
-      socket_mode_(0) {}
+      mutex_tracing_enabled_(false), cpuset_threads_(false), numa_local_memory_(false),
+      socket_path_("@envoy_domain_socket"), socket_mode_(0) {}
 
 void OptionsImpl::disableExtensions(const std::vector<std::string>& names) {
   for (const auto& name : names) {
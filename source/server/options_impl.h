@@ -78,6 +78,9 @@ public:
   void setFileFlushIntervalMsec(std::chrono::milliseconds file_flush_interval_msec) {
     file_flush_interval_msec_ = file_flush_interval_msec;
   }
+  void setFileFlushRingBufferBytes(uint32_t file_flush_ring_buffer_bytes) {
+    file_flush_ring_buffer_bytes_ = file_flush_ring_buffer_bytes;
+  }
   void setServiceClusterName(const std::string& service_cluster) {
     service_cluster_ = service_cluster;
   }
@@ -90,6 +93,15 @@ public:
     signal_handling_enabled_ = signal_handling_enabled;
   }
   void setCpusetThreads(bool cpuset_threads_enabled) { cpuset_threads_ = cpuset_threads_enabled; }
+  void setWorkerCpuSet(const std::vector<uint32_t>& worker_cpu_set) {
+    worker_cpu_set_ = worker_cpu_set;
+  }
+  void setMainThreadCpuSet(const std::vector<uint32_t>& main_thread_cpu_set) {
+    main_thread_cpu_set_ = main_thread_cpu_set;
+  }
+  void setNumaLocalMemory(bool numa_local_memory_enabled) {
+    numa_local_memory_ = numa_local_memory_enabled;
+  }
   void setAllowUnkownFields(bool allow_unknown_static_fields) {
     allow_unknown_static_fields_ = allow_unknown_static_fields;
   }
@@ -140,6 +152,7 @@ public:
   std::chrono::milliseconds fileFlushIntervalMsec() const override {
     return file_flush_interval_msec_;
   }
+  uint32_t fileFlushRingBufferBytes() const override { return file_flush_ring_buffer_bytes_; }
   const std::string& serviceClusterName() const override { return service_cluster_; }
   const std::string& serviceNodeName() const override { return service_node_; }
   const std::string& serviceZone() const override { return service_zone_; }
@@ -149,6 +162,9 @@ public:
   Server::CommandLineOptionsPtr toCommandLineOptions() const override;
   void parseComponentLogLevels(const std::string& component_log_levels);
   bool cpusetThreadsEnabled() const override { return cpuset_threads_; }
+  const std::vector<uint32_t>& workerCpuSet() const override { return worker_cpu_set_; }
+  const std::vector<uint32_t>& mainThreadCpuSet() const override { return main_thread_cpu_set_; }
+  bool numaLocalMemoryEnabled() const override { return numa_local_memory_; }
   const std::vector<std::string>& disabledExtensions() const override {
     return disabled_extensions_;
   }
@@ -192,6 +208,7 @@ private:
   std::string service_node_;
   std::string service_zone_;
   std::chrono::milliseconds file_flush_interval_msec_;
+  uint32_t file_flush_ring_buffer_bytes_;
   std::chrono::seconds drain_time_;
   std::chrono::seconds parent_shutdown_time_;
   Server::DrainStrategy drain_strategy_;
@@ -200,6 +217,9 @@ private:
   bool signal_handling_enabled_;
   bool mutex_tracing_enabled_;
   bool cpuset_threads_;
+  std::vector<uint32_t> worker_cpu_set_;
+  std::vector<uint32_t> main_thread_cpu_set_;
+  bool numa_local_memory_;
   std::vector<std::string> disabled_extensions_;
   uint32_t count_;
 
@@ -1,5 +1,6 @@
 #include "server/overload_manager_impl.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include "envoy/common/exception.h"
@@ -137,6 +138,54 @@ private:
   OverloadActionState state_;
 };
 
+class PredictiveTriggerImpl final : public OverloadAction::Trigger {
+public:
+  PredictiveTriggerImpl(const envoy::config::overload::v3::PredictiveTrigger& config,
+                        TimeSource& time_source)
+      : threshold_(config.value()),
+        horizon_seconds_(std::chrono::duration<double>(std::chrono::milliseconds(
+                             DurationUtil::durationToMilliseconds(config.horizon())))
+                             .count()),
+        smoothing_factor_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, smoothing_factor, 0.5)),
+        time_source_(time_source), state_(OverloadActionState::inactive()) {}
+
+  bool updateValue(double value) override {
+    const OverloadActionState state = actionState();
+    const MonotonicTime now = time_source_.monotonicTime();
+    if (last_update_.has_value()) {
+      const double elapsed_seconds =
+          std::chrono::duration<double>(now - last_update_->first).count();
+      if (elapsed_seconds > 0) {
+        // Smooth the rate of change, so that a single noisy sample doesn't trigger the action.
+        const double slope = (value - last_update_->second) / elapsed_seconds;
+        slope_ = smoothing_factor_ * slope + (1 - smoothing_factor_) * slope_;
+      }
+    }
+    last_update_ = std::make_pair(now, value);
+
+    // Only rising pressure is extrapolated, so that the trigger doesn't leave saturation before
+    // the pressure actually falls under the threshold.
+    const double predicted = value + std::max(0.0, slope_) * horizon_seconds_;
+    state_ = value >= threshold_ || predicted >= threshold_ ? OverloadActionState::saturated()
+                                                            : OverloadActionState::inactive();
+    // As for ThresholdTriggerImpl, state_ is always either saturated or inactive.
+    return state.value() != actionState().value();
+  }
+
+  OverloadActionState actionState() const override { return state_; }
+
+private:
+  const double threshold_;
+  const double horizon_seconds_;
+  const double smoothing_factor_;
+  TimeSource& time_source_;
+  // The time and value of the previous update.
+  absl::optional<std::pair<MonotonicTime, double>> last_update_;
+  // The smoothed rate of change of the pressure, per second.
+  double slope_{0};
+  OverloadActionState state_;
+};
+
 Stats::Counter& makeCounter(Stats::Scope& scope, absl::string_view a, absl::string_view b) {
   Stats::StatNameManagedStorage stat_name(absl::StrCat("overload.", a, ".", b),
                                           scope.symbolTable());
@@ -227,7 +276,7 @@ bool operator==(const NamedOverloadActionSymbolTable::Symbol& lhs,
 }
 
 OverloadAction::OverloadAction(const envoy::config::overload::v3::OverloadAction& config,
-                               Stats::Scope& stats_scope)
+                               Stats::Scope& stats_scope, TimeSource& time_source)
     : state_(OverloadActionState::inactive()),
       active_gauge_(
           makeGauge(stats_scope, config.name(), "active", Stats::Gauge::ImportMode::Accumulate)),
@@ -243,6 +292,10 @@ OverloadAction::OverloadAction(const envoy::config::overload::v3::OverloadAction
     case envoy::config::overload::v3::Trigger::TriggerOneofCase::kScaled:
       trigger = std::make_unique<ScaledTriggerImpl>(trigger_config.scaled());
       break;
+    case envoy::config::overload::v3::Trigger::TriggerOneofCase::kPredictive:
+      trigger =
+          std::make_unique<PredictiveTriggerImpl>(trigger_config.predictive(), time_source);
+      break;
     default:
       NOT_REACHED_GCOVR_EXCL_LINE;
     }
@@ -318,7 +371,8 @@ OverloadManagerImpl::OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::S
     // We cannot currently use in place construction as the OverloadAction constructor may throw,
     // causing an inconsistent internal state of the actions_ map, which on destruction results in
     // an invalid free.
-    auto result = actions_.try_emplace(symbol, OverloadAction(action, stats_scope));
+    auto result = actions_.try_emplace(
+        symbol, OverloadAction(action, stats_scope, dispatcher.timeSource()));
     if (!result.second) {
       throw EnvoyException(absl::StrCat("Duplicate overload action ", name));
     }
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "envoy/api/api.h"
+#include "envoy/common/time.h"
 #include "envoy/config/overload/v3/overload.pb.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/scaled_range_timer_manager.h"
@@ -25,7 +26,7 @@ namespace Server {
 class OverloadAction {
 public:
   OverloadAction(const envoy::config::overload::v3::OverloadAction& config,
-                 Stats::Scope& stats_scope);
+                 Stats::Scope& stats_scope, TimeSource& time_source);
 
   // Updates the current pressure for the given resource and returns whether the action
   // has changed state.
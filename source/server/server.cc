@@ -55,6 +55,7 @@
 #include "server/guarddog_impl.h"
 #include "server/listener_hooks.h"
 #include "server/ssl_context_manager.h"
+#include "server/thread_placement.h"
 
 namespace Envoy {
 namespace Server {
@@ -81,9 +82,9 @@ InstanceImpl::InstanceImpl(
       dispatcher_(api_->allocateDispatcher("main_thread")),
       singleton_manager_(new Singleton::ManagerImpl(api_->threadFactory())),
       handler_(new ConnectionHandlerImpl(*dispatcher_, absl::nullopt)),
-      listener_component_factory_(*this), worker_factory_(thread_local_, *api_, hooks),
-      access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
-                          store),
+      listener_component_factory_(*this), worker_factory_(thread_local_, *api_, hooks, options),
+      access_log_manager_(options.fileFlushIntervalMsec(), options.fileFlushRingBufferBytes(),
+                          *api_, *dispatcher_, access_log_lock, store),
       terminated_(false),
       mutex_tracer_(options.mutexTracingEnabled() ? &Envoy::MutexTracerImpl::getOrCreateTracer()
                                                   : nullptr),
@@ -322,6 +323,14 @@ void InstanceImpl::initialize(const Options& options,
   ENVOY_LOG(info, "initializing epoch {} (base id={}, hot restart version={})",
             options.restartEpoch(), restarter_.baseId(), restarter_.version());
 
+  // Pin the main thread before it starts other threads, which inherit its CPUs. Worker threads
+  // pin themselves to their own CPU when they start.
+  if (!options.mainThreadCpuSet().empty() &&
+      !ThreadPlacement::pinCurrentThread(options.mainThreadCpuSet())) {
+    throw EnvoyException(fmt::format("failed to pin the main thread to CPUs {}",
+                                     absl::StrJoin(options.mainThreadCpuSet(), ",")));
+  }
+
   ENVOY_LOG(info, "statically linked extensions:");
   for (const auto& ext : Envoy::Registry::FactoryCategoryRegistry::registeredFactories()) {
     ENVOY_LOG(info, "  {}: {}", ext.first, absl::StrJoin(ext.second->registeredNames(), ", "));
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "common/common/logger.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Pins threads to CPUs and places the memory they allocate on NUMA nodes, on the platforms which
+ * support it.
+ */
+class ThreadPlacement : protected Logger::Loggable<Logger::Id::main> {
+public:
+  /**
+   * The number of CPUs a thread can be pinned to. CPUs are numbered from 0 to MaxCpus - 1.
+   */
+  static constexpr uint32_t MaxCpus = 1024;
+
+  /**
+   * @return whether threads can be pinned to CPUs and their memory placed on NUMA nodes.
+   */
+  static bool supported();
+
+  /**
+   * Restricts the calling thread to run on a set of CPUs. Threads it creates afterwards inherit
+   * the set.
+   * @param cpus supplies the CPUs, which must not be empty.
+   * @return whether the thread was pinned.
+   */
+  static bool pinCurrentThread(const std::vector<uint32_t>& cpus);
+
+  /**
+   * @return the NUMA node of the CPU the calling thread is running on, if it can be known.
+   */
+  static absl::optional<uint32_t> currentNumaNode();
+
+  /**
+   * Makes the pages the calling thread faults in from now on be allocated on a NUMA node, as
+   * long as that node has free memory. Pages which are already allocated don't move.
+   * @param node supplies the NUMA node.
+   * @return whether the memory policy of the thread was changed.
+   */
+  static bool preferNumaNode(uint32_t node);
+
+  /**
+   * @param address supplies an address in a page which has been allocated.
+   * @return the NUMA node of the page, if it can be known.
+   */
+  static absl::optional<uint32_t> numaNodeOf(const void* address);
+
+  /**
+   * @return the CPU time the calling thread has used so far, or 0 if it can't be known.
+   */
+  static std::chrono::microseconds currentThreadCpuTime();
+};
+
+} // namespace Server
+} // namespace Envoy
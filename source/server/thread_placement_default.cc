@@ -0,0 +1,27 @@
+#include "server/thread_placement.h"
+
+namespace Envoy {
+namespace Server {
+
+bool ThreadPlacement::supported() { return false; }
+
+bool ThreadPlacement::pinCurrentThread(const std::vector<uint32_t>&) {
+  ENVOY_LOG(warn, "pinning threads to CPUs is not supported on this platform");
+  return false;
+}
+
+absl::optional<uint32_t> ThreadPlacement::currentNumaNode() { return absl::nullopt; }
+
+bool ThreadPlacement::preferNumaNode(uint32_t) {
+  ENVOY_LOG(warn, "placing thread memory on NUMA nodes is not supported on this platform");
+  return false;
+}
+
+absl::optional<uint32_t> ThreadPlacement::numaNodeOf(const void*) { return absl::nullopt; }
+
+std::chrono::microseconds ThreadPlacement::currentThreadCpuTime() {
+  return std::chrono::microseconds(0);
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,92 @@
+#if !defined(__linux__)
+#error "Linux platform file is part of non-Linux build."
+#endif
+
+#include <linux/mempolicy.h>
+#include <sched.h>
+
+#include <ctime>
+
+#include "common/api/os_sys_calls_impl_linux.h"
+#include "common/common/assert.h"
+#include "common/common/utility.h"
+
+#include "server/thread_placement.h"
+
+#include "absl/strings/str_join.h"
+
+namespace Envoy {
+namespace Server {
+
+static_assert(ThreadPlacement::MaxCpus <= CPU_SETSIZE, "cpu_set_t can't hold all the CPUs");
+
+bool ThreadPlacement::supported() { return true; }
+
+bool ThreadPlacement::pinCurrentThread(const std::vector<uint32_t>& cpus) {
+  ASSERT(!cpus.empty());
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (const uint32_t cpu : cpus) {
+    if (cpu >= MaxCpus) {
+      ENVOY_LOG(warn, "cannot pin thread to CPU {}", cpu);
+      return false;
+    }
+    CPU_SET(cpu, &mask);
+  }
+  // A pid of 0 is the calling thread, rather than the whole process.
+  const Api::SysCallIntResult result =
+      Api::LinuxOsSysCallsSingleton::get().sched_setaffinity(0, sizeof(mask), &mask);
+  if (result.rc_ != 0) {
+    ENVOY_LOG(warn, "failed to pin thread to CPUs {}: {}", absl::StrJoin(cpus, ","),
+              errorDetails(result.errno_));
+    return false;
+  }
+  return true;
+}
+
+absl::optional<uint32_t> ThreadPlacement::currentNumaNode() {
+  unsigned cpu;
+  unsigned node;
+  const Api::SysCallIntResult result = Api::LinuxOsSysCallsSingleton::get().getcpu(&cpu, &node);
+  if (result.rc_ != 0) {
+    return absl::nullopt;
+  }
+  return node;
+}
+
+bool ThreadPlacement::preferNumaNode(uint32_t node) {
+  constexpr uint32_t BitsPerWord = sizeof(unsigned long) * 8;
+  std::vector<unsigned long> nodemask(node / BitsPerWord + 1);
+  nodemask[node / BitsPerWord] = 1UL << (node % BitsPerWord);
+  // maxnode is one more than the highest node in the mask, for historical reasons.
+  const Api::SysCallIntResult result = Api::LinuxOsSysCallsSingleton::get().set_mempolicy(
+      MPOL_PREFERRED, nodemask.data(), nodemask.size() * BitsPerWord + 1);
+  if (result.rc_ != 0) {
+    ENVOY_LOG(warn, "failed to prefer NUMA node {} for thread memory: {}", node,
+              errorDetails(result.errno_));
+    return false;
+  }
+  return true;
+}
+
+absl::optional<uint32_t> ThreadPlacement::numaNodeOf(const void* address) {
+  int node;
+  const Api::SysCallIntResult result = Api::LinuxOsSysCallsSingleton::get().get_mempolicy(
+      &node, nullptr, 0, const_cast<void*>(address), MPOL_F_NODE | MPOL_F_ADDR);
+  if (result.rc_ != 0 || node < 0) {
+    return absl::nullopt;
+  }
+  return node;
+}
+
+std::chrono::microseconds ThreadPlacement::currentThreadCpuTime() {
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+    return std::chrono::microseconds(0);
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec));
+}
+
+} // namespace Server
+} // namespace Envoy
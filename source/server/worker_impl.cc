@@ -10,23 +10,42 @@
 #include "envoy/thread_local/thread_local.h"
 
 #include "server/connection_handler_impl.h"
+#include "server/thread_placement.h"
 
 namespace Envoy {
 namespace Server {
 
+namespace {
+
+// How often a pinned worker updates its placement stats.
+constexpr std::chrono::milliseconds PlacementSampleInterval{1000};
+
+// The size of the block a pinned worker allocates to check where its memory comes from. This is
+// the default size of buffer slices, which make up most of the memory of connections.
+constexpr size_t MemorySampleBytes = 16384;
+
+} // namespace
+
 WorkerPtr ProdWorkerFactory::createWorker(uint32_t index, OverloadManager& overload_manager,
                                           const std::string& worker_name) {
+  WorkerPlacement placement;
+  const std::vector<uint32_t>& worker_cpu_set = options_.workerCpuSet();
+  if (!worker_cpu_set.empty()) {
+    placement.cpu_ = worker_cpu_set[index % worker_cpu_set.size()];
+    placement.numa_local_memory_ = options_.numaLocalMemoryEnabled();
+  }
   Event::DispatcherPtr dispatcher(api_.allocateDispatcher(worker_name));
   return std::make_unique<WorkerImpl>(tls_, hooks_, std::move(dispatcher),
                                       std::make_unique<ConnectionHandlerImpl>(*dispatcher, index),
-                                      overload_manager, api_);
+                                      overload_manager, api_, placement);
 }
 
 WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks,
                        Event::DispatcherPtr&& dispatcher, Network::ConnectionHandlerPtr handler,
-                       OverloadManager& overload_manager, Api::Api& api)
+                       OverloadManager& overload_manager, Api::Api& api,
+                       const WorkerPlacement& placement)
     : tls_(tls), hooks_(hooks), dispatcher_(std::move(dispatcher)), handler_(std::move(handler)),
-      api_(api) {
+      api_(api), placement_(placement) {
   tls_.registerThread(*dispatcher_, false);
   overload_manager.registerForAction(
       OverloadActionNames::get().StopAcceptingConnections, *dispatcher_,
@@ -124,16 +143,22 @@ void WorkerImpl::stopListener(Network::ListenerConfig& listener, std::function<v
 }
 
 void WorkerImpl::threadRoutine(GuardDog& guard_dog) {
+  // Pin the thread before it allocates anything, so that its memory is placed on the right node.
+  applyPlacement();
   ENVOY_LOG(debug, "worker entering dispatch loop");
   // The watch dog must be created after the dispatcher starts running and has post events flushed,
-  // as this is when TLS stat scopes start working.
+  // as this is when TLS stat scopes start working. The same goes for the placement stats.
   dispatcher_->post([this, &guard_dog]() {
     watch_dog_ = guard_dog.createWatchDog(api_.threadFactory().currentThreadId(),
                                           dispatcher_->name(), *dispatcher_);
+    if (placement_.cpu_.has_value()) {
+      initializePlacementStats();
+    }
   });
   dispatcher_->run(Event::Dispatcher::RunType::Block);
   ENVOY_LOG(debug, "worker exited dispatch loop");
   guard_dog.stopWatching(watch_dog_);
+  placement_sample_timer_.reset();
 
   // We must close all active connections before we actually exit the thread. This prevents any
   // destructors from running on the main thread which might reference thread locals. Destroying
@@ -143,6 +168,56 @@ void WorkerImpl::threadRoutine(GuardDog& guard_dog) {
   watch_dog_.reset();
 }
 
+void WorkerImpl::applyPlacement() {
+  if (!placement_.cpu_.has_value() || !ThreadPlacement::pinCurrentThread({*placement_.cpu_})) {
+    return;
+  }
+  // Pinning moves the thread to its CPU before returning, so this is the node of that CPU.
+  numa_node_ = ThreadPlacement::currentNumaNode();
+  ENVOY_LOG(debug, "worker pinned to CPU {} on NUMA node {}", *placement_.cpu_,
+            numa_node_.has_value() ? std::to_string(*numa_node_) : "unknown");
+  if (placement_.numa_local_memory_ && numa_node_.has_value()) {
+    ThreadPlacement::preferNumaNode(*numa_node_);
+  }
+}
+
+void WorkerImpl::initializePlacementStats() {
+  Stats::Scope& scope = api_.rootScope();
+  const std::string prefix = absl::StrCat("server.", dispatcher_->name(), ".");
+  placement_stats_ = std::make_unique<WorkerPlacementStats>(WorkerPlacementStats{
+      ALL_WORKER_PLACEMENT_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                 POOL_GAUGE_PREFIX(scope, prefix))});
+  if (numa_node_.has_value()) {
+    placement_stats_->numa_node_.set(*numa_node_);
+  }
+  last_cpu_time_ = ThreadPlacement::currentThreadCpuTime();
+  placement_sample_timer_ = dispatcher_->createTimer([this]() -> void { samplePlacement(); });
+  placement_sample_timer_->enableTimer(PlacementSampleInterval);
+}
+
+void WorkerImpl::samplePlacement() {
+  const std::chrono::microseconds cpu_time = ThreadPlacement::currentThreadCpuTime();
+  if (cpu_time > last_cpu_time_) {
+    placement_stats_->cpu_time_us_.add((cpu_time - last_cpu_time_).count());
+    last_cpu_time_ = cpu_time;
+  }
+
+  // Allocate and touch a block like the ones connections allocate, and check which node the
+  // allocator got it from. Blocks recycled from memory freed by other threads can be remote even
+  // when new pages are faulted in on the local node.
+  if (numa_node_.has_value()) {
+    const auto sample = std::make_unique<uint8_t[]>(MemorySampleBytes);
+    const absl::optional<uint32_t> node = ThreadPlacement::numaNodeOf(sample.get());
+    if (node.has_value()) {
+      placement_stats_->memory_samples_.inc();
+      if (node.value() != numa_node_.value()) {
+        placement_stats_->remote_memory_samples_.inc();
+      }
+    }
+  }
+  placement_sample_timer_->enableTimer(PlacementSampleInterval);
+}
+
 void WorkerImpl::stopAcceptingConnectionsCb(OverloadActionState state) {
   if (state.isSaturated()) {
     handler_->disableListeners();
@@ -7,20 +7,51 @@
 #include "envoy/network/connection_handler.h"
 #include "envoy/server/guarddog.h"
 #include "envoy/server/listener_manager.h"
+#include "envoy/server/options.h"
 #include "envoy/server/worker.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/thread_local/thread_local.h"
 
 #include "common/common/logger.h"
 
 #include "server/listener_hooks.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Server {
 
+/**
+ * Stats of a worker pinned to a CPU. @see stats_macros.h
+ */
+#define ALL_WORKER_PLACEMENT_STATS(COUNTER, GAUGE)                                                 \
+  COUNTER(cpu_time_us)                                                                             \
+  COUNTER(memory_samples)                                                                          \
+  COUNTER(remote_memory_samples)                                                                   \
+  GAUGE(numa_node, NeverImport)
+
+/**
+ * Struct definition for the stats of a worker pinned to a CPU. @see stats_macros.h
+ */
+struct WorkerPlacementStats {
+  ALL_WORKER_PLACEMENT_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Where a worker thread runs and allocates its memory.
+ */
+struct WorkerPlacement {
+  // The CPU the worker thread is pinned to, if any.
+  absl::optional<uint32_t> cpu_;
+  // Whether the worker allocates its memory on the NUMA node of its CPU.
+  bool numa_local_memory_{};
+};
+
 class ProdWorkerFactory : public WorkerFactory, Logger::Loggable<Logger::Id::main> {
 public:
-  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, ListenerHooks& hooks)
-      : tls_(tls), api_(api), hooks_(hooks) {}
+  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, ListenerHooks& hooks,
+                    const Options& options)
+      : tls_(tls), api_(api), hooks_(hooks), options_(options) {}
 
   // Server::WorkerFactory
   WorkerPtr createWorker(uint32_t index, OverloadManager& overload_manager,
@@ -30,6 +61,7 @@ private:
   ThreadLocal::Instance& tls_;
   Api::Api& api_;
   ListenerHooks& hooks_;
+  const Options& options_;
 };
 
 /**
@@ -39,7 +71,7 @@ class WorkerImpl : public Worker, Logger::Loggable<Logger::Id::main> {
 public:
   WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks, Event::DispatcherPtr&& dispatcher,
              Network::ConnectionHandlerPtr handler, OverloadManager& overload_manager,
-             Api::Api& api);
+             Api::Api& api, const WorkerPlacement& placement);
 
   // Server::Worker
   void addListener(absl::optional<uint64_t> overridden_listener, Network::ListenerConfig& listener,
@@ -57,6 +89,9 @@ public:
 
 private:
   void threadRoutine(GuardDog& guard_dog);
+  void applyPlacement();
+  void initializePlacementStats();
+  void samplePlacement();
   void stopAcceptingConnectionsCb(OverloadActionState state);
   void rejectIncomingConnectionsCb(OverloadActionState state);
 
@@ -67,6 +102,12 @@ private:
   Api::Api& api_;
   Thread::ThreadPtr thread_;
   WatchDogSharedPtr watch_dog_;
+  const WorkerPlacement placement_;
+  // The NUMA node of the CPU the worker is pinned to, once it is known.
+  absl::optional<uint32_t> numa_node_;
+  std::unique_ptr<WorkerPlacementStats> placement_stats_;
+  Event::TimerPtr placement_sample_timer_;
+  std::chrono::microseconds last_cpu_time_{};
 };
 
 } // namespace Server
@@ -29,9 +29,10 @@ namespace {
 
 class AccessLogManagerImplTest : public testing::Test {
 protected:
-  AccessLogManagerImplTest()
+  explicit AccessLogManagerImplTest(uint32_t file_flush_ring_buffer_bytes = 0)
       : file_(new NiceMock<Filesystem::MockFile>), thread_factory_(Thread::threadFactoryForTest()),
-        access_log_manager_(timeout_40ms_, api_, dispatcher_, lock_, store_) {
+        access_log_manager_(timeout_40ms_, file_flush_ring_buffer_bytes, api_, dispatcher_, lock_,
+                            store_) {
     EXPECT_CALL(file_system_, createFile("foo"))
         .WillOnce(Return(ByMove(std::unique_ptr<NiceMock<Filesystem::MockFile>>(file_))));
 
@@ -47,6 +48,13 @@ protected:
     TestUtility::waitForGaugeEq(store_, name, value, time_system_);
   }
 
+  void waitForWrites(size_t writes) {
+    Thread::LockGuard lock(file_->write_mutex_);
+    while (file_->num_writes_ != writes) {
+      file_->write_event_.wait(file_->write_mutex_);
+    }
+  }
+
   NiceMock<Api::MockApi> api_;
   NiceMock<Filesystem::MockInstance> file_system_;
   NiceMock<Filesystem::MockFile>* file_;
@@ -517,6 +525,228 @@ TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
       .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+class RingBufferAccessLogManagerImplTest : public AccessLogManagerImplTest {
+protected:
+  RingBufferAccessLogManagerImplTest() : AccessLogManagerImplTest(4096) {}
+
+  uint64_t totalBuffered() {
+    return store_.gauge("filesystem.write_total_buffered", Stats::Gauge::ImportMode::Accumulate)
+        .value();
+  }
+
+  void expectWrite(const std::string& expected) {
+    EXPECT_CALL(*file_, write_(_))
+        .WillOnce(Invoke([expected](absl::string_view data) -> Api::IoCallSizeResult {
+          EXPECT_EQ(expected, data);
+          return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+        }));
+  }
+};
+
+TEST_F(RingBufferAccessLogManagerImplTest, FlushToLogFileOnDemand) {
+  NiceMock<Event::MockTimer>* timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*timer, enableTimer(timeout_40ms_, _));
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  log_file->write("test");
+  log_file->write("test2");
+  EXPECT_EQ(2UL, store_.counter("filesystem.write_buffered").value());
+  EXPECT_EQ(9UL, totalBuffered());
+
+  // Both writes go to the file in a single flush.
+  expectWrite("testtest2");
+  log_file->flush();
+  EXPECT_EQ(1UL, file_->num_writes_);
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_completed").value());
+  EXPECT_EQ(0UL, store_.counter("filesystem.flushed_by_timer").value());
+  EXPECT_EQ(0UL, totalBuffered());
+
+  // Nothing is written when there is nothing to flush.
+  log_file->flush();
+  EXPECT_EQ(1UL, file_->num_writes_);
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(RingBufferAccessLogManagerImplTest, FlushToLogFilePeriodically) {
+  NiceMock<Event::MockTimer>* timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*timer, enableTimer(timeout_40ms_, _));
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  expectWrite("test");
+  log_file->write("test");
+
+  // make sure timer is re-enabled on callback call
+  EXPECT_CALL(*timer, enableTimer(timeout_40ms_, _));
+  timer->invokeCallback();
+  waitForWrites(1);
+
+  waitForCounterEq("filesystem.write_completed", 1);
+  EXPECT_EQ(1UL, store_.counter("filesystem.flushed_by_timer").value());
+  EXPECT_EQ(0UL, store_.counter("filesystem.flushed_by_backpressure").value());
+  waitForGaugeEq("filesystem.write_total_buffered", 0);
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+// Each thread writes to its own buffer, and a flush writes all of them.
+TEST_F(RingBufferAccessLogManagerImplTest, BufferPerThread) {
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  log_file->write("main\n");
+  Thread::ThreadPtr thread = thread_factory_.createThread([&log_file]() {
+    log_file->write("worker\n");
+    log_file->write("worker2\n");
+  });
+  thread->join();
+  log_file->write("main2\n");
+
+  expectWrite("main\nmain2\nworker\nworker2\n");
+  log_file->flush();
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(RingBufferAccessLogManagerImplTest, HalfFullBufferIsFlushedWithoutTimer) {
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  log_file->write(std::string(2048, 'a'));
+  EXPECT_EQ(0UL, store_.counter("filesystem.flushed_by_backpressure").value());
+
+  expectWrite(std::string(2048, 'a') + "b");
+  log_file->write("b");
+  waitForWrites(1);
+  EXPECT_EQ(1UL, store_.counter("filesystem.flushed_by_backpressure").value());
+  EXPECT_EQ(0UL, store_.counter("filesystem.flushed_by_timer").value());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(RingBufferAccessLogManagerImplTest, WriteLargerThanBufferIsDropped) {
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  log_file->write(std::string(4097, 'a'));
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_buffered").value());
+  EXPECT_EQ(1UL, store_.counter("filesystem.flushed_by_backpressure").value());
+  EXPECT_EQ(0UL, totalBuffered());
+
+  expectWrite("test");
+  log_file->write("test");
+  log_file->flush();
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(RingBufferAccessLogManagerImplTest, FlushCountsIOErrors) {
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  EXPECT_CALL(*file_, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("test"));
+        return Filesystem::resultFailure<ssize_t>(2UL, ENOSPC);
+      }));
+  log_file->write("test");
+  log_file->flush();
+
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_failed").value());
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_completed").value());
+  EXPECT_EQ(0UL, totalBuffered());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(RingBufferAccessLogManagerImplTest, ReopenFile) {
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  Sequence sq;
+  EXPECT_CALL(*file_, open_(_))
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  EXPECT_CALL(*file_, close_())
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  EXPECT_CALL(*file_, open_(_))
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  EXPECT_CALL(*file_, write_(_))
+      .InSequence(sq)
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("reopened"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  access_log_manager_.reopen();
+  log_file->write("reopened");
+  log_file->flush();
+
+  EXPECT_CALL(*file_, close_())
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(RingBufferAccessLogManagerImplTest, ReopenThrows) {
+  new NiceMock<Event::MockTimer>(&dispatcher_);
+  Sequence sq;
+  EXPECT_CALL(*file_, open_(_))
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  EXPECT_CALL(*file_, close_())
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  EXPECT_CALL(*file_, open_(_))
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultFailure<bool>(false, 0))));
+  EXPECT_CALL(*file_, write_(_)).Times(0);
+  access_log_manager_.reopen();
+  log_file->write("dropped");
+  log_file->flush();
+
+  EXPECT_EQ(1UL, store_.counter("filesystem.reopen_failed").value());
+  EXPECT_EQ(0UL, totalBuffered());
+}
+
+// Files created from the same manager share a single flush timer and thread.
+TEST_F(RingBufferAccessLogManagerImplTest, SingleFlusherForAllFiles) {
+  NiceMock<Event::MockTimer>* timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log = access_log_manager_.createAccessLog("foo");
+
+  NiceMock<Filesystem::MockFile>* file2 = new NiceMock<Filesystem::MockFile>;
+  EXPECT_CALL(file_system_, createFile("bar"))
+      .WillOnce(Return(ByMove(std::unique_ptr<NiceMock<Filesystem::MockFile>>(file2))));
+  EXPECT_CALL(*file2, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log2 = access_log_manager_.createAccessLog("bar");
+
+  expectWrite("foo");
+  EXPECT_CALL(*file2, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("bar"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  log->write("foo");
+  log2->write("bar");
+  timer->invokeCallback();
+
+  waitForCounterEq("filesystem.write_completed", 2);
+  EXPECT_EQ(1UL, store_.counter("filesystem.flushed_by_timer").value());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  EXPECT_CALL(*file2, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
 } // namespace
 } // namespace AccessLog
 } // namespace Envoy
@@ -0,0 +1,71 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+#include <vector>
+
+#include "common/access_log/access_log_manager_impl.h"
+#include "common/common/thread.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace AccessLog {
+namespace {
+
+constexpr uint32_t LinesPerThread = 10000;
+
+// Workers writing access log lines to the same file, which is flushed to the null device so that
+// only the cost of buffering and flushing is measured. The first argument is the number of
+// workers, and the second one the size of the per thread buffers: 0 for the shared buffer.
+void benchmarkConcurrentWrites(benchmark::State& state) {
+  const uint32_t workers = state.range(0);
+  Stats::IsolatedStoreImpl stats_store;
+  Api::ApiPtr api = Api::createApiForTest(stats_store);
+  testing::NiceMock<Event::MockDispatcher> dispatcher;
+  Thread::MutexBasicLockable lock;
+  AccessLogManagerImpl access_log_manager(std::chrono::milliseconds(1000), state.range(1), *api,
+                                          dispatcher, lock, stats_store);
+  AccessLogFileSharedPtr file =
+      access_log_manager.createAccessLog(std::string(Platform::null_device_path));
+  const std::string line = absl::StrCat(
+      "[2021-01-01T00:00:00.000Z] \"GET /some/resource HTTP/1.1\" 200 - 0 1234 5 4 \"-\" ",
+      "\"curl/7.64.1\" \"9b2a6f56-3c0a-4f0e-a0a4-b2d9bf7d9c3e\" \"example.com\" \"10.0.0.1:80\"\n");
+
+  for (auto _ : state) {
+    std::vector<Thread::ThreadPtr> threads;
+    for (uint32_t i = 0; i < workers; ++i) {
+      threads.push_back(api->threadFactory().createThread([&file, &line]() {
+        for (uint32_t j = 0; j < LinesPerThread; ++j) {
+          file->write(line);
+        }
+      }));
+    }
+    for (Thread::ThreadPtr& thread : threads) {
+      thread->join();
+    }
+  }
+  file->flush();
+
+  state.SetItemsProcessed(state.iterations() * workers * LinesPerThread);
+  state.counters["dropped"] = stats_store.counterFromString("filesystem.write_dropped").value();
+}
+BENCHMARK(benchmarkConcurrentWrites)
+    ->Apply([](benchmark::internal::Benchmark* benchmark) {
+      for (int workers : {1, 4, 16}) {
+        for (int ring_buffer_bytes : {0, 64 * 1024, 1024 * 1024}) {
+          benchmark->Args({workers, ring_buffer_bytes});
+        }
+      }
+    })
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace AccessLog
+} // namespace Envoy
@@ -568,6 +568,30 @@ TEST_F(WatermarkBufferTest, MoveWatermarksOverflow) {
   EXPECT_EQ(1, overflow_watermark_buffer1);
 }
 
+TEST_F(WatermarkBufferTest, Accounting) {
+  WatermarkBufferAccounting::enable();
+  const uint64_t initial_bytes = WatermarkBufferAccounting::bytes();
+
+  buffer_.add(TEN_BYTES, 10);
+  EXPECT_EQ(initial_bytes + 10, WatermarkBufferAccounting::bytes());
+  buffer_.drain(4);
+  EXPECT_EQ(initial_bytes + 6, WatermarkBufferAccounting::bytes());
+
+  {
+    Buffer::WatermarkBuffer buffer{[]() -> void {}, []() -> void {}, []() -> void {}};
+    buffer.move(buffer_, 2);
+    buffer.prepend("abc");
+    EXPECT_EQ(initial_bytes + 9, WatermarkBufferAccounting::bytes());
+  }
+  // Destroyed buffers no longer count.
+  EXPECT_EQ(initial_bytes + 4, WatermarkBufferAccounting::bytes());
+
+  // Moves into buffers other than watermark buffers are not counted.
+  Buffer::OwnedImpl owned;
+  owned.move(buffer_);
+  EXPECT_EQ(initial_bytes, WatermarkBufferAccounting::bytes());
+}
+
 } // namespace
 } // namespace Buffer
 } // namespace Envoy
@@ -0,0 +1,90 @@
+#include <string>
+#include <thread>
+
+#include "common/common/spsc_ring_buffer.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+std::string readAll(const SpscRingBuffer& buffer) {
+  const auto slices = buffer.readableSlices();
+  return absl::StrCat(slices[0], slices[1]);
+}
+
+TEST(SpscRingBufferTest, Capacity) {
+  EXPECT_EQ(1, SpscRingBuffer(0).capacity());
+  EXPECT_EQ(16, SpscRingBuffer(16).capacity());
+  EXPECT_EQ(32, SpscRingBuffer(17).capacity());
+}
+
+TEST(SpscRingBufferTest, WriteReadRelease) {
+  SpscRingBuffer buffer(16);
+  EXPECT_EQ("", readAll(buffer));
+  EXPECT_TRUE(buffer.write("hello "));
+  EXPECT_TRUE(buffer.write("world"));
+  EXPECT_EQ(11, buffer.size());
+  EXPECT_EQ("hello world", readAll(buffer));
+
+  buffer.release(6);
+  EXPECT_EQ(5, buffer.size());
+  EXPECT_EQ("world", readAll(buffer));
+}
+
+TEST(SpscRingBufferTest, FullBufferRejectsWholeRecord) {
+  SpscRingBuffer buffer(8);
+  EXPECT_TRUE(buffer.write("abcdef"));
+  EXPECT_FALSE(buffer.write("ghi"));
+  EXPECT_EQ("abcdef", readAll(buffer));
+  EXPECT_TRUE(buffer.write("gh"));
+  EXPECT_FALSE(buffer.write("i"));
+  EXPECT_EQ("abcdefgh", readAll(buffer));
+}
+
+TEST(SpscRingBufferTest, WrapAround) {
+  SpscRingBuffer buffer(8);
+  EXPECT_TRUE(buffer.write("abcdef"));
+  buffer.release(4);
+  EXPECT_TRUE(buffer.write("ghijkl"));
+
+  const auto slices = buffer.readableSlices();
+  EXPECT_EQ("efgh", slices[0]);
+  EXPECT_EQ("ijkl", slices[1]);
+
+  buffer.release(5);
+  EXPECT_EQ("jkl", readAll(buffer));
+  EXPECT_TRUE(buffer.readableSlices()[1].empty());
+}
+
+// The consumer sees every byte the producer wrote, in order, while they run concurrently.
+TEST(SpscRingBufferTest, ConcurrentProducerAndConsumer) {
+  constexpr uint32_t Records = 20000;
+  SpscRingBuffer buffer(256);
+  std::string expected;
+  for (uint32_t i = 0; i < Records; ++i) {
+    absl::StrAppend(&expected, i, "\n");
+  }
+
+  std::thread producer([&buffer]() {
+    for (uint32_t i = 0; i < Records; ++i) {
+      const std::string record = absl::StrCat(i, "\n");
+      while (!buffer.write(record)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+  std::string received;
+  while (received.size() < expected.size()) {
+    const auto slices = buffer.readableSlices();
+    absl::StrAppend(&received, slices[0], slices[1]);
+    buffer.release(slices[0].size() + slices[1].size());
+  }
+  producer.join();
+  EXPECT_EQ(expected, received);
+  EXPECT_EQ(0, buffer.size());
+}
+
+} // namespace
+} // namespace Envoy
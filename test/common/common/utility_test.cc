@@ -949,6 +949,45 @@ TEST(TrieLookupTable, LongestPrefix) {
   EXPECT_EQ(nullptr, trie.findLongestPrefix(" "));
 }
 
+TEST(PerfectHashLookupTable, Empty) {
+  PerfectHashLookupTable<int> table;
+  EXPECT_EQ(0, table.size());
+  EXPECT_EQ(nullptr, table.find("foo"));
+  EXPECT_EQ(nullptr, table.find(""));
+}
+
+TEST(PerfectHashLookupTable, FindItems) {
+  PerfectHashLookupTable<int> table({{"foo", 1}, {"bar", 2}, {"", 3}});
+  EXPECT_EQ(3, table.size());
+  EXPECT_EQ(1, *table.find("foo"));
+  EXPECT_EQ(2, *table.find("bar"));
+  EXPECT_EQ(3, *table.find(""));
+  EXPECT_EQ(nullptr, table.find("fo"));
+  EXPECT_EQ(nullptr, table.find("foobar"));
+  EXPECT_EQ(nullptr, table.find("baz"));
+}
+
+TEST(PerfectHashLookupTable, ManyItems) {
+  std::vector<std::pair<std::string, int>> entries;
+  for (int i = 0; i < 1000; ++i) {
+    entries.emplace_back(absl::StrCat("x-header-", i), i);
+  }
+  PerfectHashLookupTable<int> table(entries);
+  for (const auto& entry : entries) {
+    const int* value = table.find(entry.first);
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ(entry.second, *value);
+  }
+  for (int i = 1000; i < 2000; ++i) {
+    EXPECT_EQ(nullptr, table.find(absl::StrCat("x-header-", i)));
+  }
+}
+
+TEST(PerfectHashLookupTable, DuplicateKeys) {
+  EXPECT_DEATH(PerfectHashLookupTable<int>({{"foo", 1}, {"foo", 2}}),
+               "duplicate key in PerfectHashLookupTable");
+}
+
 TEST(InlineStorageTest, InlineString) {
   InlineStringPtr hello = InlineString::create("Hello, world!");
   EXPECT_EQ("Hello, world!", hello->toStringView());
@@ -20,6 +20,7 @@
 #include "test/mocks/ssl/mocks.h"
 #include "test/mocks/stream_info/mocks.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
@@ -1048,6 +1049,22 @@ TEST(SubstitutionFormatterTest, requestHeaderFormatter) {
         formatter.formatValue(request_header, response_header, response_trailer, stream_info, body),
         ProtoEq(ValueUtil::stringValue("GE")));
   }
+
+  {
+    RequestHeaderFormatter formatter(":Method", "", absl::optional<size_t>(2));
+    std::string output = "prefix ";
+    EXPECT_TRUE(formatter.formatTo(output, request_header, response_header, response_trailer,
+                                   stream_info, body));
+    EXPECT_EQ("prefix GE", output);
+  }
+
+  {
+    RequestHeaderFormatter formatter("does_not_exist", "", absl::optional<size_t>());
+    std::string output = "prefix ";
+    EXPECT_FALSE(formatter.formatTo(output, request_header, response_header, response_trailer,
+                                    stream_info, body));
+    EXPECT_EQ("prefix ", output);
+  }
 }
 
 TEST(SubstitutionFormatterTest, responseHeaderFormatter) {
@@ -2125,6 +2142,277 @@ TEST(SubstitutionFormatterTest, JsonFormatterTest) {
   EXPECT_TRUE(TestUtility::jsonStringEqual(out_json, expected));
 }
 
+// The direct JSON output is compact, ordered by key, and escaped like the protobuf JSON printer.
+TEST(SubstitutionFormatterTest, JsonFormatterOutputTest) {
+  StreamInfo::MockStreamInfo stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"user-agent", "say \"<hi>\"\\\t\u00e9"},
+                                                {":method", "GET"}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    user_agent: '%REQ(USER-AGENT)%'
+    method: '%REQ(:METHOD)%'
+    missing: '%REQ(MISSING)%'
+    multi: '%REQ(:METHOD)% %REQ(MISSING)%'
+    nested:
+      method: '%REQ(:METHOD):1%'
+  )EOF",
+                            key_mapping);
+
+  {
+    JsonFormatterImpl formatter(key_mapping, false, false);
+    EXPECT_EQ("{\"method\":\"GET\",\"missing\":\"-\",\"multi\":\"GET -\",\"nested\":{\"method\":"
+              "\"G\"},\"user_agent\":\"say \\\"\\u003chi\\u003e\\\"\\\\\\t\u00e9\"}\n",
+              formatter.format(request_header, response_header, response_trailer, stream_info,
+                               body));
+  }
+
+  {
+    JsonFormatterImpl formatter(key_mapping, false, true);
+    EXPECT_EQ("{\"method\":\"GET\",\"multi\":\"GET \",\"nested\":{\"method\":\"G\"},"
+              "\"user_agent\":\"say \\\"\\u003chi\\u003e\\\"\\\\\\t\u00e9\"}\n",
+              formatter.format(request_header, response_header, response_trailer, stream_info,
+                               body));
+  }
+}
+
+TEST(SubstitutionFormatterTest, JsonFormatterTypedTest) {
+  Http::TestRequestHeaderMapImpl request_headers;
+  Http::TestResponseHeaderMapImpl response_headers;
+  Http::TestResponseTrailerMapImpl response_trailers;
+  StreamInfo::MockStreamInfo stream_info;
+  std::string body;
+  EXPECT_CALL(Const(stream_info), lastDownstreamRxByteReceived())
+      .WillRepeatedly(Return(std::chrono::nanoseconds(5000000)));
+
+  ProtobufWkt::Value list;
+  list.mutable_list_value()->add_values()->set_bool_value(true);
+  list.mutable_list_value()->add_values()->set_string_value("two");
+  list.mutable_list_value()->add_values()->set_number_value(3.14);
+
+  ProtobufWkt::Struct s;
+  (*s.mutable_fields())["list"] = list;
+
+  stream_info.filter_state_->setData("test_obj",
+                                     std::make_unique<TestSerializedStructFilterState>(s),
+                                     StreamInfo::FilterState::StateType::ReadOnly);
+  EXPECT_CALL(Const(stream_info), filterState()).Times(testing::AtLeast(1));
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    request_duration: '%REQUEST_DURATION%'
+    request_duration_multi: '%REQUEST_DURATION%ms'
+    filter_state: '%FILTER_STATE(test_obj)%'
+    missing: '%REQ(MISSING)%'
+  )EOF",
+                            key_mapping);
+
+  {
+    JsonFormatterImpl formatter(key_mapping, true, false);
+    EXPECT_EQ("{\"filter_state\":{\"list\":[true,\"two\",3.14]},\"missing\":null,"
+              "\"request_duration\":5,\"request_duration_multi\":\"5ms\"}\n",
+              formatter.format(request_headers, response_headers, response_trailers, stream_info,
+                               body));
+  }
+
+  {
+    JsonFormatterImpl formatter(key_mapping, true, true);
+    EXPECT_EQ("{\"filter_state\":{\"list\":[true,\"two\",3.14]},\"request_duration\":5,"
+              "\"request_duration_multi\":\"5ms\"}\n",
+              formatter.format(request_headers, response_headers, response_trailers, stream_info,
+                               body));
+  }
+}
+
+// The direct JSON output is the same JSON as the serialization of the StructFormatter output.
+TEST(SubstitutionFormatterTest, JsonFormatterMatchesStructFormatterTest) {
+  StreamInfo::MockStreamInfo stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{":method", "GET"},
+                                                {":path", "/a\"b\\c"},
+                                                {"user-agent", "curl/7.64.1"},
+                                                {"x-binary", "\x01\x1f\x7f"},
+                                                {"x-unicode", "\u00ad\u2028\U0001f600"}};
+  Http::TestResponseHeaderMapImpl response_header{{":status", "200"}};
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body = "local\nreply";
+  absl::optional<Http::Protocol> protocol = Http::Protocol::Http11;
+  EXPECT_CALL(stream_info, protocol()).WillRepeatedly(Return(protocol));
+  EXPECT_CALL(Const(stream_info), lastDownstreamRxByteReceived())
+      .WillRepeatedly(Return(std::chrono::nanoseconds(5000000)));
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    request: '%REQ(:METHOD)% %REQ(:PATH)% %PROTOCOL%'
+    status: '%RESP(:STATUS)%'
+    binary: '%REQ(X-BINARY)%'
+    unicode: '%REQ(X-UNICODE)%'
+    duration: '%REQUEST_DURATION%'
+    body: '%LOCAL_REPLY_BODY%'
+    missing: '%RESP(MISSING)%'
+    nested:
+      user_agent: '%REQ(USER-AGENT)%'
+      empty: {}
+  )EOF",
+                            key_mapping);
+
+  for (const bool preserve_types : {false, true}) {
+    for (const bool omit_empty_values : {false, true}) {
+      StructFormatter struct_formatter(key_mapping, preserve_types, omit_empty_values);
+      JsonFormatterImpl json_formatter(key_mapping, preserve_types, omit_empty_values);
+      const std::string expected = MessageUtil::getJsonStringFromMessage(
+          struct_formatter.format(request_header, response_header, response_trailer, stream_info,
+                                  body),
+          false, true);
+      const std::string json = json_formatter.format(request_header, response_header,
+                                                     response_trailer, stream_info, body);
+      EXPECT_TRUE(TestUtility::jsonStringEqual(json, expected)) << json << " " << expected;
+    }
+  }
+}
+
+TEST(SubstitutionFormatterTest, JsonFormatterSortsNestedStructKeysTest) {
+  Http::TestRequestHeaderMapImpl request_headers;
+  Http::TestResponseHeaderMapImpl response_headers;
+  Http::TestResponseTrailerMapImpl response_trailers;
+  StreamInfo::MockStreamInfo stream_info;
+  std::string body;
+
+  ProtobufWkt::Struct s;
+  ProtobufWkt::Value inner;
+  for (const char* key : {"zulu", "alpha", "mike", "bravo"}) {
+    (*inner.mutable_struct_value()->mutable_fields())[key].set_string_value(key);
+    (*s.mutable_fields())[key] = inner;
+  }
+  stream_info.filter_state_->setData("test_obj",
+                                     std::make_unique<TestSerializedStructFilterState>(s),
+                                     StreamInfo::FilterState::StateType::ReadOnly);
+  EXPECT_CALL(Const(stream_info), filterState()).Times(testing::AtLeast(1));
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    filter_state: '%FILTER_STATE(test_obj)%'
+  )EOF",
+                            key_mapping);
+
+  JsonFormatterImpl formatter(key_mapping, true, false);
+  const std::string json =
+      formatter.format(request_headers, response_headers, response_trailers, stream_info, body);
+  EXPECT_EQ("{\"filter_state\":{"
+            "\"alpha\":{\"alpha\":\"alpha\",\"zulu\":\"zulu\"},"
+            "\"bravo\":{\"alpha\":\"alpha\",\"bravo\":\"bravo\",\"mike\":\"mike\","
+            "\"zulu\":\"zulu\"},"
+            "\"mike\":{\"alpha\":\"alpha\",\"mike\":\"mike\",\"zulu\":\"zulu\"},"
+            "\"zulu\":{\"zulu\":\"zulu\"}}}\n",
+            json);
+}
+
+TEST(SubstitutionFormatterTest, JsonFormatterDropsInvalidUtf8Test) {
+  StreamInfo::MockStreamInfo stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"x-bytes", "a\xff" "b\xc3\xa9\xe2\x82" "c\xc3"}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    bytes: '%REQ(X-BYTES)%'
+  )EOF",
+                            key_mapping);
+
+  JsonFormatterImpl formatter(key_mapping, false, false);
+  EXPECT_EQ("{\"bytes\":\"abéc\"}\n",
+            formatter.format(request_header, response_header, response_trailer, stream_info,
+                             body));
+}
+
+// With the direct output disabled, the formatted Struct is serialized by the protobuf printer.
+TEST(SubstitutionFormatterTest, JsonFormatterDirectOutputDisabledTest) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.json_formatter_direct_output", "false"}});
+
+  StreamInfo::MockStreamInfo stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{":method", "GET"}, {"x-text", "say \"<hi>\""}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+  EXPECT_CALL(Const(stream_info), lastDownstreamRxByteReceived())
+      .WillRepeatedly(Return(std::chrono::nanoseconds(5000000)));
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    method: '%REQ(:METHOD)%'
+    text: '%REQ(X-TEXT)%'
+    duration: '%REQUEST_DURATION%'
+    nested:
+      missing: '%REQ(MISSING)%'
+  )EOF",
+                            key_mapping);
+
+  for (const bool preserve_types : {false, true}) {
+    StructFormatter struct_formatter(key_mapping, preserve_types, false);
+    JsonFormatterImpl json_formatter(key_mapping, preserve_types, false);
+    EXPECT_EQ(absl::StrCat(MessageUtil::getJsonStringFromMessage(
+                               struct_formatter.format(request_header, response_header,
+                                                       response_trailer, stream_info, body),
+                               false, true),
+                           "\n"),
+              json_formatter.format(request_header, response_header, response_trailer,
+                                    stream_info, body));
+  }
+}
+
+// Every code point is escaped exactly like the protobuf JSON printer escapes it.
+TEST(SubstitutionFormatterTest, JsonFormatterEscapesLikeProtobufTest) {
+  StreamInfo::MockStreamInfo stream_info;
+  Http::TestRequestHeaderMapImpl request_header;
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  const auto append_utf8 = [](std::string& output, uint32_t code_point) {
+    if (code_point < 0x80) {
+      output.push_back(code_point);
+    } else if (code_point < 0x800) {
+      output.push_back(0xc0 | (code_point >> 6));
+      output.push_back(0x80 | (code_point & 0x3f));
+    } else if (code_point < 0x10000) {
+      output.push_back(0xe0 | (code_point >> 12));
+      output.push_back(0x80 | ((code_point >> 6) & 0x3f));
+      output.push_back(0x80 | (code_point & 0x3f));
+    } else {
+      output.push_back(0xf0 | (code_point >> 18));
+      output.push_back(0x80 | ((code_point >> 12) & 0x3f));
+      output.push_back(0x80 | ((code_point >> 6) & 0x3f));
+      output.push_back(0x80 | (code_point & 0x3f));
+    }
+  };
+
+  // Literal text is checked in chunks to keep the number of formatters down.
+  constexpr uint32_t ChunkSize = 0x1000;
+  for (uint32_t chunk_start = 0; chunk_start <= 0x10ffff; chunk_start += ChunkSize) {
+    std::string text;
+    for (uint32_t code_point = chunk_start; code_point < chunk_start + ChunkSize; ++code_point) {
+      // Skip surrogates, which can't be encoded, and the start of format commands.
+      if ((code_point >= 0xd800 && code_point <= 0xdfff) || code_point == '%') {
+        continue;
+      }
+      append_utf8(text, code_point);
+    }
+    ProtobufWkt::Struct key_mapping;
+    (*key_mapping.mutable_fields())["text"].set_string_value(text);
+
+    JsonFormatterImpl formatter(key_mapping, false, false);
+    EXPECT_EQ(absl::StrCat(MessageUtil::getJsonStringFromMessage(key_mapping, false, true), "\n"),
+              formatter.format(request_header, response_header, response_trailer, stream_info,
+                               body))
+        << "code points " << chunk_start << " to " << chunk_start + ChunkSize - 1;
+  }
+}
+
 TEST(SubstitutionFormatterTest, CompositeFormatterSuccess) {
   StreamInfo::MockStreamInfo stream_info;
   Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
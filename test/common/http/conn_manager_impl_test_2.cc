@@ -40,6 +40,59 @@ TEST_F(HttpConnectionManagerImplTest, ResponseBeforeRequestComplete) {
   decoder_filters_[0]->callbacks_->encodeHeaders(std::move(response_headers), true, "details");
 }
 
+TEST_F(HttpConnectionManagerImplTest, NoStreamArena) {
+  setup(false, "envoy-server-test");
+  setupFilterChain(1, 0);
+
+  EXPECT_CALL(*decoder_filters_[0], decodeHeaders(_, true))
+      .WillOnce(InvokeWithoutArgs([&]() -> FilterHeadersStatus {
+        EXPECT_FALSE(decoder_filters_[0]->callbacks_->streamArena().has_value());
+        ResponseHeaderMapPtr response_headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+        decoder_filters_[0]->callbacks_->streamInfo().setResponseCodeDetails("");
+        decoder_filters_[0]->callbacks_->encodeHeaders(std::move(response_headers), true,
+                                                       "details");
+        return FilterHeadersStatus::StopIteration;
+      }));
+  EXPECT_CALL(response_encoder_, encodeHeaders(_, true));
+  EXPECT_CALL(*decoder_filters_[0], onStreamComplete());
+  EXPECT_CALL(*decoder_filters_[0], onDestroy());
+  startRequest(true);
+
+  EXPECT_EQ(0U, stats_.named_.downstream_rq_arena_blocks_.value());
+}
+
+// With a stream arena, the filter wrappers and the objects filters create through the callbacks
+// share a block of the arena.
+TEST_F(HttpConnectionManagerImplTest, StreamArena) {
+  stream_arena_block_size_ = 1024;
+  setup(false, "envoy-server-test");
+  setupFilterChain(1, 1);
+
+  EXPECT_CALL(*decoder_filters_[0], decodeHeaders(_, true))
+      .WillOnce(InvokeWithoutArgs([&]() -> FilterHeadersStatus {
+        StreamArenaOptRef arena = decoder_filters_[0]->callbacks_->streamArena();
+        EXPECT_TRUE(arena.has_value());
+        EXPECT_EQ("value", arena->create<std::string>("value"));
+        ResponseHeaderMapPtr response_headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+        decoder_filters_[0]->callbacks_->streamInfo().setResponseCodeDetails("");
+        decoder_filters_[0]->callbacks_->encodeHeaders(std::move(response_headers), true,
+                                                       "details");
+        return FilterHeadersStatus::StopIteration;
+      }));
+  EXPECT_CALL(*encoder_filters_[0], encodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::Continue));
+  EXPECT_CALL(*encoder_filters_[0], encodeComplete());
+  EXPECT_CALL(response_encoder_, encodeHeaders(_, true));
+  EXPECT_CALL(*decoder_filters_[0], onStreamComplete());
+  EXPECT_CALL(*encoder_filters_[0], onStreamComplete());
+  EXPECT_CALL(*decoder_filters_[0], onDestroy());
+  EXPECT_CALL(*encoder_filters_[0], onDestroy());
+  startRequest(true);
+
+  // Two filter wrappers and the string fit in one block.
+  EXPECT_EQ(1U, stats_.named_.downstream_rq_arena_blocks_.value());
+}
+
 TEST_F(HttpConnectionManagerImplTest, DisconnectOnProxyConnectionDisconnect) {
   setup(false, "envoy-server-test");
 
@@ -18,11 +18,13 @@ namespace Envoy {
 // Fuzz the header map implementation.
 DEFINE_PROTO_FUZZER(const test::common::http::HeaderMapImplFuzzTestCase& input) {
   TestScopedRuntime runtime;
-  // Set the lazy header-map threshold if found.
+  // Set the lazy header-map threshold and the arena block size if found.
   if (input.has_config()) {
     Runtime::LoaderSingleton::getExisting()->mergeValues(
         {{"envoy.http.headermap.lazy_map_min_size",
-          absl::StrCat(input.config().lazy_map_min_size())}});
+          absl::StrCat(input.config().lazy_map_min_size())},
+         {"envoy.http.headermap.arena_block_size",
+          absl::StrCat(input.config().arena_block_size() % 1024)}});
   }
 
   auto header_map = Http::RequestHeaderMapImpl::create();
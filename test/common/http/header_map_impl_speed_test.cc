@@ -1,6 +1,9 @@
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 
+#include "test/test_common/test_runtime.h"
+
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -295,5 +298,109 @@ static void headerMapImplRemovePrefix(benchmark::State& state) {
 }
 BENCHMARK(headerMapImplRemovePrefix)->Arg(0)->Arg(1)->Arg(5)->Arg(10)->Arg(50);
 
+/**
+ * The following benchmarks compare the costs of the header map layouts, selected by the
+ * envoy.http.headermap.arena_block_size runtime feature value passed as the benchmark's
+ * argument: 0 allocates each entry separately, other values allocate entries in blocks of that
+ * many entries. They use the request headers of a typical browser navigation, most of which are
+ * not O(1) headers.
+ */
+static const std::pair<LowerCaseString, std::string>* browserRequestHeaders(size_t& count) {
+  static const std::pair<LowerCaseString, std::string> headers[] = {
+      {LowerCaseString(":method"), "GET"},
+      {LowerCaseString(":path"), "/en-US/docs/Web/HTTP/Headers"},
+      {LowerCaseString(":authority"), "developer.example.org"},
+      {LowerCaseString(":scheme"), "https"},
+      {LowerCaseString("upgrade-insecure-requests"), "1"},
+      {LowerCaseString("user-agent"),
+       "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/88.0"},
+      {LowerCaseString("accept"), "text/html,application/xhtml+xml,application/xml;q=0.9"},
+      {LowerCaseString("sec-fetch-site"), "same-origin"},
+      {LowerCaseString("sec-fetch-mode"), "navigate"},
+      {LowerCaseString("sec-fetch-user"), "?1"},
+      {LowerCaseString("sec-fetch-dest"), "document"},
+      {LowerCaseString("referer"), "https://developer.example.org/en-US/docs/Web/HTTP"},
+      {LowerCaseString("accept-encoding"), "gzip, deflate, br"},
+      {LowerCaseString("accept-language"), "en-US,en;q=0.9"},
+      {LowerCaseString("cookie"), "sessionid=8f1c2a6e0b7d4e5f; preferred_locale=en-US"},
+      {LowerCaseString("x-forwarded-for"), "192.0.2.1"},
+      {LowerCaseString("x-forwarded-proto"), "https"},
+      {LowerCaseString("x-request-id"), "4f0c7a1e-96b3-4d1f-8c2a-7e5b3d9f1a60"},
+  };
+  count = sizeof(headers) / sizeof(headers[0]);
+  return headers;
+}
+
+static void setArenaBlockSize(benchmark::State& state) {
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.http.headermap.arena_block_size", absl::StrCat(state.range(0))}});
+}
+
+static RequestHeaderMapPtr createBrowserRequestHeaders() {
+  size_t count;
+  const auto* headers_to_add = browserRequestHeaders(count);
+  auto headers = Http::RequestHeaderMapImpl::create();
+  for (size_t i = 0; i < count; ++i) {
+    headers->addCopy(headers_to_add[i].first, headers_to_add[i].second);
+  }
+  return headers;
+}
+
+/** Measure the speed of creating a header map and adding the headers of a request. */
+static void headerMapImplLayoutInsert(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  setArenaBlockSize(state);
+  for (auto _ : state) { // NOLINT
+    auto headers = createBrowserRequestHeaders();
+    benchmark::DoNotOptimize(headers->size());
+  }
+}
+BENCHMARK(headerMapImplLayoutInsert)->Arg(0)->Arg(8)->Arg(32);
+
+/** Measure the speed of looking up each of the headers of a request by name. */
+static void headerMapImplLayoutLookup(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  setArenaBlockSize(state);
+  auto headers = createBrowserRequestHeaders();
+  size_t count;
+  const auto* headers_to_get = browserRequestHeaders(count);
+  size_t successes = 0;
+  for (auto _ : state) { // NOLINT
+    for (size_t i = 0; i < count; ++i) {
+      successes += !headers->get(headers_to_get[i].first).empty();
+    }
+  }
+  benchmark::DoNotOptimize(successes);
+}
+BENCHMARK(headerMapImplLayoutLookup)->Arg(0)->Arg(8)->Arg(32);
+
+/** Measure the speed of iterating over the headers of a request. */
+static void headerMapImplLayoutIterate(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  setArenaBlockSize(state);
+  auto headers = createBrowserRequestHeaders();
+  size_t total_len = 0;
+  for (auto _ : state) { // NOLINT
+    headers->iterate([&total_len](const HeaderEntry& header) -> HeaderMap::Iterate {
+      total_len += header.key().size() + header.value().size();
+      return HeaderMap::Iterate::Continue;
+    });
+  }
+  benchmark::DoNotOptimize(total_len);
+}
+BENCHMARK(headerMapImplLayoutIterate)->Arg(0)->Arg(8)->Arg(32);
+
+/** Measure the speed of copying the headers of a request into a new header map. */
+static void headerMapImplLayoutCopy(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  setArenaBlockSize(state);
+  auto headers = createBrowserRequestHeaders();
+  for (auto _ : state) { // NOLINT
+    auto copy = createHeaderMap<RequestHeaderMapImpl>(*headers);
+    benchmark::DoNotOptimize(copy->size());
+  }
+}
+BENCHMARK(headerMapImplLayoutCopy)->Arg(0)->Arg(8)->Arg(32);
+
 } // namespace Http
 } // namespace Envoy
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <tuple>
 
 #include "common/http/header_list_view.h"
 #include "common/http/header_map_impl.h"
@@ -360,25 +361,68 @@ Http::RegisterCustomInlineHeader<Http::CustomInlineHeaderRegistry::Type::Request
 Http::RegisterCustomInlineHeader<Http::CustomInlineHeaderRegistry::Type::RequestHeaders>
     custom_header_1_copy(Http::LowerCaseString{"foo_custom_header"});
 
-class HeaderMapImplTest : public testing::TestWithParam<uint32_t> {
+// Parameterized on the lazy map threshold and the arena block size.
+class HeaderMapImplTest : public testing::TestWithParam<std::tuple<uint32_t, uint32_t>> {
 public:
   HeaderMapImplTest() {
-    // Set the lazy map threshold using the test parameter.
+    // Set the lazy map threshold and the arena block size using the test parameters.
     Runtime::LoaderSingleton::getExisting()->mergeValues(
-        {{"envoy.http.headermap.lazy_map_min_size", absl::StrCat(GetParam())}});
+        {{"envoy.http.headermap.lazy_map_min_size", absl::StrCat(std::get<0>(GetParam()))},
+         {"envoy.http.headermap.arena_block_size", absl::StrCat(std::get<1>(GetParam()))}});
   }
 
-  static std::string testParamsToString(const ::testing::TestParamInfo<uint32_t>& params) {
-    return absl::StrCat(params.param);
+  static std::string
+  testParamsToString(const ::testing::TestParamInfo<std::tuple<uint32_t, uint32_t>>& params) {
+    return absl::StrCat(std::get<0>(params.param), "_", std::get<1>(params.param));
   }
 
   TestScopedRuntime runtime;
 };
 
 INSTANTIATE_TEST_SUITE_P(HeaderMapThreshold, HeaderMapImplTest,
-                         testing::Values(0, 1, std::numeric_limits<uint32_t>::max()),
+                         testing::Combine(testing::Values(0, 1,
+                                                          std::numeric_limits<uint32_t>::max()),
+                                          testing::Values(0, 1, 8)),
                          HeaderMapImplTest::testParamsToString);
 
+// Add and remove more headers than fit in an arena block, so that entries are reused and more
+// blocks are allocated.
+TEST_P(HeaderMapImplTest, AddAndRemoveManyHeaders) {
+  TestRequestHeaderMapImpl headers;
+  for (int i = 0; i < 50; ++i) {
+    headers.addCopy(LowerCaseString(absl::StrCat("x-header-", i)), absl::StrCat(i));
+  }
+  for (int i = 0; i < 50; i += 2) {
+    EXPECT_EQ(1, headers.remove(LowerCaseString(absl::StrCat("x-header-", i))));
+  }
+  headers.setPath("/");
+  for (int i = 50; i < 75; ++i) {
+    headers.addCopy(LowerCaseString(absl::StrCat("x-header-", i)), absl::StrCat(i));
+  }
+  headers.verifyByteSizeInternalForTest();
+  EXPECT_EQ(51, headers.size());
+
+  std::vector<std::string> keys;
+  headers.iterate([&keys](const HeaderEntry& header) -> HeaderMap::Iterate {
+    keys.emplace_back(header.key().getStringView());
+    return HeaderMap::Iterate::Continue;
+  });
+  std::vector<std::string> expected_keys{":path"};
+  for (int i = 1; i < 50; i += 2) {
+    expected_keys.push_back(absl::StrCat("x-header-", i));
+  }
+  for (int i = 50; i < 75; ++i) {
+    expected_keys.push_back(absl::StrCat("x-header-", i));
+  }
+  EXPECT_EQ(expected_keys, keys);
+
+  TestRequestHeaderMapImpl copy(headers);
+  EXPECT_EQ(headers, copy);
+  headers.clear();
+  EXPECT_TRUE(headers.empty());
+  EXPECT_EQ(51, copy.size());
+}
+
 // Make sure that the same header registered twice points to the same location.
 TEST_P(HeaderMapImplTest, CustomRegisteredHeaders) {
   TestRequestHeaderMapImpl headers;
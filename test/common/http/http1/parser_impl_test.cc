@@ -0,0 +1,401 @@
+#include <string>
+#include <vector>
+
+#include "common/http/http1/legacy_parser_impl.h"
+#include "common/http/http1/vectorized_parser_impl.h"
+#include "common/http/http1/vectorized_scanner.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+// Records the events reported by a parser, merging the data of consecutive events of the same
+// kind, so that the events do not depend on how the input is split.
+class RecordingCallbacks : public ParserCallbacks {
+public:
+  // ParserCallbacks
+  CallbackResult onMessageBegin() override { return record("begin"); }
+  CallbackResult onUrl(const char* data, size_t length) override {
+    return recordData("url", data, length);
+  }
+  CallbackResult onHeaderField(const char* data, size_t length) override {
+    return recordData("field", data, length);
+  }
+  CallbackResult onHeaderValue(const char* data, size_t length) override {
+    return recordData("value", data, length);
+  }
+  CallbackResult onHeadersComplete() override {
+    if (record("headers") == CallbackResult::Error) {
+      return CallbackResult::Error;
+    }
+    return headers_complete_result_;
+  }
+  void bufferBody(const char* data, size_t length) override { recordData("body", data, length); }
+  CallbackResult onMessageComplete() override {
+    record("complete");
+    if (pause_on_message_complete_) {
+      parser_->pause();
+    }
+    return CallbackResult::Success;
+  }
+  void onChunkHeader(bool is_final_chunk) override {
+    record(is_final_chunk ? "last-chunk" : "chunk");
+  }
+
+  CallbackResult record(absl::string_view event) {
+    events_.emplace_back(event);
+    last_data_event_.clear();
+    return event == fail_on_ ? CallbackResult::Error : CallbackResult::Success;
+  }
+
+  CallbackResult recordData(absl::string_view event, const char* data, size_t length) {
+    if (last_data_event_ == event) {
+      events_.back().append(data, length);
+    } else {
+      events_.push_back(absl::StrCat(event, "=", absl::string_view(data, length)));
+      last_data_event_ = std::string(event);
+    }
+    return event == fail_on_ ? CallbackResult::Error : CallbackResult::Success;
+  }
+
+  std::string events() const { return absl::StrJoin(events_, " "); }
+
+  Parser* parser_{};
+  std::vector<std::string> events_;
+  std::string last_data_event_;
+  std::string fail_on_;
+  CallbackResult headers_complete_result_{CallbackResult::Success};
+  bool pause_on_message_complete_{};
+};
+
+struct ParserParam {
+  bool vectorized_;
+  VectorizedScanner::Isa isa_;
+};
+
+std::vector<ParserParam> parserParams() {
+  std::vector<ParserParam> params{{false, VectorizedScanner::Isa::Scalar}};
+  for (const VectorizedScanner::Isa isa : VectorizedScanner::supportedIsas()) {
+    params.push_back({true, isa});
+  }
+  return params;
+}
+
+std::string parserParamName(const testing::TestParamInfo<ParserParam>& info) {
+  if (!info.param.vectorized_) {
+    return "Legacy";
+  }
+  std::string name = absl::StrCat("Vectorized_", VectorizedScanner::isaName(info.param.isa_));
+  name.erase(std::remove(name.begin(), name.end(), '.'), name.end());
+  return name;
+}
+
+class ParserImplTest : public testing::TestWithParam<ParserParam> {
+protected:
+  void initialize(MessageType type) {
+    if (GetParam().vectorized_) {
+      parser_ = std::make_unique<VectorizedParserImpl>(type, callbacks_,
+                                                       VectorizedScanner::get(GetParam().isa_));
+    } else {
+      parser_ = std::make_unique<LegacyHttpParserImpl>(type, callbacks_);
+    }
+    callbacks_.parser_ = parser_.get();
+  }
+
+  // Parse the input in one call, and then again in calls of every size from 1 byte up, checking
+  // that the events and the result are the same each time.
+  void expectEvents(MessageType type, absl::string_view input, absl::string_view expected_events,
+                    ParserStatus expected_status = ParserStatus::Ok) {
+    for (size_t split = input.size(); split > 0; --split) {
+      SCOPED_TRACE(absl::StrCat("split ", split));
+      initialize(type);
+      for (size_t offset = 0; offset < input.size() && parser_->status() == ParserStatus::Ok;
+           offset += split) {
+        const size_t length = std::min(split, input.size() - offset);
+        const size_t parsed = parser_->execute(input.data() + offset, length);
+        if (parser_->status() == ParserStatus::Ok) {
+          EXPECT_EQ(length, parsed);
+        }
+      }
+      EXPECT_EQ(expected_events, callbacks_.events());
+      EXPECT_EQ(expected_status, parser_->status());
+      callbacks_.events_.clear();
+      callbacks_.last_data_event_.clear();
+    }
+  }
+
+  // Parse the input in one call and return the name of the error.
+  absl::string_view parseError(MessageType type, absl::string_view input) {
+    initialize(type);
+    parser_->execute(input.data(), input.size());
+    EXPECT_EQ(ParserStatus::Error, parser_->status());
+    return parser_->errorName();
+  }
+
+  RecordingCallbacks callbacks_;
+  ParserPtr parser_;
+};
+
+INSTANTIATE_TEST_SUITE_P(Parsers, ParserImplTest, testing::ValuesIn(parserParams()),
+                         parserParamName);
+
+TEST_P(ParserImplTest, Request) {
+  expectEvents(MessageType::Request,
+               "GET /index.html?q=1 HTTP/1.1\r\nHost: example.com\r\nAccept:  */*  \r\n"
+               "Empty:\r\n\r\n",
+               "begin url=/index.html?q=1 field=Host value=example.com field=Accept value=*/*   "
+               "field=Empty value= headers complete");
+  EXPECT_EQ("GET", parser_->methodName());
+  EXPECT_TRUE(parser_->isHttp11());
+  EXPECT_FALSE(parser_->contentLength().has_value());
+  EXPECT_FALSE(parser_->isChunked());
+  EXPECT_FALSE(parser_->hasTransferEncoding());
+}
+
+TEST_P(ParserImplTest, RequestLongElements) {
+  // Longer than the vectors of every instruction set.
+  const std::string path = absl::StrCat("/", std::string(100, 'p'));
+  const std::string name = std::string(70, 'n');
+  const std::string value = std::string(90, 'v');
+  expectEvents(MessageType::Request,
+               absl::StrCat("POST ", path, " HTTP/1.0\r\n", name, ": ", value, "\r\n\r\n"),
+               absl::StrCat("begin url=", path, " field=", name, " value=", value,
+                            " headers complete"));
+  EXPECT_EQ("POST", parser_->methodName());
+  EXPECT_FALSE(parser_->isHttp11());
+}
+
+TEST_P(ParserImplTest, LeadingLineEndings) {
+  expectEvents(MessageType::Request, "\r\n\r\nGET / HTTP/1.1\r\n\r\n",
+               "begin url=/ headers complete");
+}
+
+TEST_P(ParserImplTest, ContentLength) {
+  expectEvents(MessageType::Request,
+               "POST / HTTP/1.1\r\ncontent-length: 5\r\n\r\nhelloGET / HTTP/1.1\r\n\r\n",
+               "begin url=/ field=content-length value=5 headers body=hello complete "
+               "begin url=/ headers complete");
+}
+
+TEST_P(ParserImplTest, Chunked) {
+  expectEvents(MessageType::Request,
+               "POST / HTTP/1.1\r\nTransfer-Encoding: gzip, Chunked\r\n\r\n"
+               "5;ext=1\r\nhello\r\nA\r\n0123456789\r\n0\r\ntrailer: t\r\n\r\n",
+               "begin url=/ field=Transfer-Encoding value=gzip, Chunked headers chunk body=hello "
+               "chunk body=0123456789 last-chunk field=trailer value=t complete");
+  EXPECT_TRUE(parser_->isChunked());
+  EXPECT_TRUE(parser_->hasTransferEncoding());
+}
+
+TEST_P(ParserImplTest, ChunkedWithContentLength) {
+  expectEvents(MessageType::Request,
+               "POST / HTTP/1.1\r\ntransfer-encoding: chunked\r\ncontent-length: 1\r\n\r\n"
+               "0\r\n\r\n",
+               "begin url=/ field=transfer-encoding value=chunked field=content-length value=1 "
+               "headers last-chunk complete");
+}
+
+TEST_P(ParserImplTest, Response) {
+  expectEvents(MessageType::Response, "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nhi",
+               "begin field=Content-Length value=2 headers body=hi complete");
+  EXPECT_EQ(200, parser_->statusCode());
+}
+
+TEST_P(ParserImplTest, ResponseWithoutBody) {
+  expectEvents(MessageType::Response, "HTTP/1.1 204 No Content\r\n\r\nHTTP/1.1 304\r\n\r\n",
+               "begin headers complete begin headers complete");
+  expectEvents(MessageType::Response, "HTTP/1.1 100 Continue\r\n\r\n", "begin headers complete");
+}
+
+TEST_P(ParserImplTest, ResponseUntilEof) {
+  initialize(MessageType::Response);
+  const std::string input = "HTTP/1.0 200 OK\r\n\r\nbody";
+  EXPECT_EQ(input.size(), parser_->execute(input.data(), input.size()));
+  EXPECT_EQ("begin headers body=body", callbacks_.events());
+  EXPECT_EQ(0, parser_->execute(nullptr, 0));
+  EXPECT_EQ("begin headers body=body complete", callbacks_.events());
+  EXPECT_EQ(ParserStatus::Ok, parser_->status());
+}
+
+TEST_P(ParserImplTest, HeadersCompleteNoBody) {
+  callbacks_.headers_complete_result_ = CallbackResult::NoBody;
+  expectEvents(MessageType::Response, "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\n",
+               "begin field=Content-Length value=2 headers complete");
+}
+
+TEST_P(ParserImplTest, HeadersCompleteNoBodyData) {
+  callbacks_.headers_complete_result_ = CallbackResult::NoBodyData;
+  initialize(MessageType::Request);
+  const std::string input = "GET / HTTP/1.1\r\nUpgrade: websocket\r\n\r\nnot http";
+  const size_t parsed = parser_->execute(input.data(), input.size());
+  EXPECT_EQ(input.size() - strlen("not http"), parsed);
+  EXPECT_EQ("begin url=/ field=Upgrade value=websocket headers complete", callbacks_.events());
+}
+
+TEST_P(ParserImplTest, PauseAndResume) {
+  callbacks_.pause_on_message_complete_ = true;
+  initialize(MessageType::Request);
+  const std::string first = "POST / HTTP/1.1\r\nContent-Length: 1\r\n\r\nx";
+  const std::string input = absl::StrCat(first, "GET / HTTP/1.1\r\n\r\n");
+  EXPECT_EQ(first.size(), parser_->execute(input.data(), input.size()));
+  EXPECT_EQ(ParserStatus::Paused, parser_->status());
+  EXPECT_EQ("HPE_PAUSED", parser_->errorName());
+  EXPECT_EQ(0, parser_->execute(input.data() + first.size(), input.size() - first.size()));
+
+  parser_->resume();
+  EXPECT_EQ(input.size() - first.size(),
+            parser_->execute(input.data() + first.size(), input.size() - first.size()));
+  EXPECT_EQ(ParserStatus::Paused, parser_->status());
+  EXPECT_EQ("begin url=/ field=Content-Length value=1 headers body=x complete begin url=/ "
+            "headers complete",
+            callbacks_.events());
+}
+
+TEST_P(ParserImplTest, CallbackError) {
+  callbacks_.fail_on_ = "headers";
+  EXPECT_EQ("HPE_CB_headers_complete",
+            parseError(MessageType::Request, "GET / HTTP/1.1\r\n\r\nGET / HTTP/1.1\r\n\r\n"));
+  EXPECT_EQ("begin url=/ headers", callbacks_.events());
+  EXPECT_EQ(0, parser_->execute("GET", 3));
+}
+
+TEST_P(ParserImplTest, Errors) {
+  EXPECT_EQ("HPE_INVALID_METHOD", parseError(MessageType::Request, "get / HTTP/1.1\r\n"));
+  EXPECT_EQ("", callbacks_.events());
+  EXPECT_EQ("HPE_INVALID_METHOD", parseError(MessageType::Request, "BAD / HTTP/1.1\r\n"));
+  EXPECT_EQ("HPE_INVALID_METHOD", parseError(MessageType::Request, "GE / HTTP/1.1\r\n"));
+  EXPECT_EQ("HPE_INVALID_CONSTANT", parseError(MessageType::Request, "GET / XTTP/1.1\r\n"));
+  EXPECT_EQ("HPE_INVALID_VERSION", parseError(MessageType::Request, "GET / HTTP/1,1\r\n"));
+  EXPECT_EQ("HPE_INVALID_CONSTANT", parseError(MessageType::Response, "XTTP/1.1 200 OK\r\n"));
+  EXPECT_EQ("HPE_INVALID_STATUS", parseError(MessageType::Response, "HTTP/1.1 2x0 OK\r\n"));
+  EXPECT_EQ("HPE_INVALID_HEADER_TOKEN",
+            parseError(MessageType::Request, "GET / HTTP/1.1\r\nfoo\"bar: baz\r\n"));
+  EXPECT_EQ("HPE_INVALID_HEADER_TOKEN",
+            parseError(MessageType::Request, "GET / HTTP/1.1\r\n: baz\r\n"));
+  EXPECT_EQ("HPE_INVALID_CONTENT_LENGTH",
+            parseError(MessageType::Request, "GET / HTTP/1.1\r\ncontent-length: 1x\r\n"));
+  EXPECT_EQ("HPE_INVALID_CONTENT_LENGTH",
+            parseError(MessageType::Request,
+                       "GET / HTTP/1.1\r\ncontent-length: 99999999999999999999\r\n"));
+  EXPECT_EQ("HPE_UNEXPECTED_CONTENT_LENGTH",
+            parseError(MessageType::Request,
+                       "GET / HTTP/1.1\r\ncontent-length: 1\r\ncontent-length: 1\r\n"));
+  EXPECT_EQ("HPE_UNEXPECTED_CONTENT_LENGTH",
+            parseError(MessageType::Request,
+                       "GET / HTTP/1.1\r\ntransfer-encoding: gzip\r\ncontent-length: 1\r\n\r\n"));
+  EXPECT_EQ("HPE_INVALID_TRANSFER_ENCODING",
+            parseError(MessageType::Request, "GET / HTTP/1.1\r\ntransfer-encoding: gzip\r\n\r\n"));
+  EXPECT_EQ("HPE_INVALID_CHUNK_SIZE",
+            parseError(MessageType::Request,
+                       "POST / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\nx\r\n"));
+  EXPECT_EQ("HPE_INVALID_CONTENT_LENGTH",
+            parseError(MessageType::Request,
+                       "POST / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\n"
+                       "fffffffffffffffff\r\n"));
+}
+
+TEST_P(ParserImplTest, EofInMessage) {
+  initialize(MessageType::Request);
+  const std::string input = "POST / HTTP/1.1\r\ncontent-length: 5\r\n\r\nhel";
+  EXPECT_EQ(input.size(), parser_->execute(input.data(), input.size()));
+  parser_->execute(nullptr, 0);
+  EXPECT_EQ(ParserStatus::Error, parser_->status());
+  EXPECT_EQ("HPE_INVALID_EOF_STATE", parser_->errorName());
+}
+
+TEST_P(ParserImplTest, EofBetweenMessages) {
+  initialize(MessageType::Request);
+  const std::string input = "GET / HTTP/1.1\r\n\r\n";
+  EXPECT_EQ(input.size(), parser_->execute(input.data(), input.size()));
+  EXPECT_EQ(0, parser_->execute(nullptr, 0));
+  EXPECT_EQ(ParserStatus::Ok, parser_->status());
+}
+
+// The cases in which the vectorized parser is stricter than http_parser.
+class VectorizedParserImplTest : public testing::TestWithParam<VectorizedScanner::Isa> {
+protected:
+  absl::string_view parseError(absl::string_view input) {
+    VectorizedParserImpl parser(MessageType::Request, callbacks_,
+                                VectorizedScanner::get(GetParam()));
+    parser.execute(input.data(), input.size());
+    EXPECT_EQ(ParserStatus::Error, parser.status());
+    error_name_ = std::string(parser.errorName());
+    return error_name_;
+  }
+
+  RecordingCallbacks callbacks_;
+  std::string error_name_;
+};
+
+INSTANTIATE_TEST_SUITE_P(Isas, VectorizedParserImplTest,
+                         testing::ValuesIn(VectorizedScanner::supportedIsas()),
+                         [](const testing::TestParamInfo<VectorizedScanner::Isa>& info) {
+                           std::string name(VectorizedScanner::isaName(info.param));
+                           name.erase(std::remove(name.begin(), name.end(), '.'), name.end());
+                           return name;
+                         });
+
+TEST_P(VectorizedParserImplTest, ObsoleteLineFolding) {
+  EXPECT_EQ("HPE_INVALID_HEADER_TOKEN", parseError("GET / HTTP/1.1\r\nfoo: bar\r\n baz\r\n"));
+}
+
+TEST_P(VectorizedParserImplTest, SpaceInHeaderName) {
+  EXPECT_EQ("HPE_INVALID_HEADER_TOKEN", parseError("GET / HTTP/1.1\r\nfoo bar: baz\r\n"));
+}
+
+TEST_P(VectorizedParserImplTest, CrWithoutLf) {
+  EXPECT_EQ("HPE_LF_EXPECTED", parseError("GET / HTTP/1.1\r\nfoo: bar\rbaz: 1\r\n"));
+  EXPECT_EQ("HPE_LF_EXPECTED", parseError("GET / HTTP/1.1\rfoo: bar\r\n"));
+}
+
+TEST_P(VectorizedParserImplTest, ChunkWithoutCrlf) {
+  EXPECT_EQ("HPE_STRICT",
+            parseError("POST / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\n1\r\nab\r\n"));
+}
+
+TEST_P(VectorizedParserImplTest, InvalidUrl) {
+  EXPECT_EQ("HPE_INVALID_URL", parseError("GET /a\x01 HTTP/1.1\r\n"));
+  EXPECT_EQ("HPE_INVALID_URL", parseError("GET \r\n"));
+}
+
+TEST(VectorizedScannerTest, AllIsasAgree) {
+  const VectorizedScanner& scalar = VectorizedScanner::get(VectorizedScanner::Isa::Scalar);
+  // Every byte value at every offset of a span longer than the vectors.
+  for (const VectorizedScanner::Isa isa : VectorizedScanner::supportedIsas()) {
+    const VectorizedScanner& scanner = VectorizedScanner::get(isa);
+    for (size_t offset = 0; offset < 40; ++offset) {
+      for (int c = 0; c < 256; ++c) {
+        std::string span(70, 'a');
+        span[offset] = static_cast<char>(c);
+        EXPECT_EQ(scalar.findNonToken(span.data(), span.size()),
+                  scanner.findNonToken(span.data(), span.size()));
+        EXPECT_EQ(scalar.findLineEnd(span.data(), span.size()),
+                  scanner.findLineEnd(span.data(), span.size()));
+        EXPECT_EQ(scalar.findUrlEnd(span.data(), span.size()),
+                  scanner.findUrlEnd(span.data(), span.size()));
+      }
+    }
+  }
+}
+
+TEST(VectorizedScannerTest, Scalar) {
+  const VectorizedScanner& scanner = VectorizedScanner::get(VectorizedScanner::Isa::Scalar);
+  EXPECT_EQ(5, scanner.findNonToken("x-foo: bar", 10));
+  EXPECT_EQ(4, scanner.findNonToken("a|~b", 4));
+  EXPECT_EQ(3, scanner.findLineEnd("bar\r\n", 5));
+  EXPECT_EQ(3, scanner.findLineEnd("bar\n", 4));
+  EXPECT_EQ(4, scanner.findLineEnd("\tbar", 4));
+  EXPECT_EQ(2, scanner.findUrlEnd("/a HTTP/1.1", 11));
+  EXPECT_EQ(3, scanner.findUrlEnd("/a\t\x7f", 4));
+  EXPECT_EQ(3, scanner.findUrlEnd("/\xc3\xa9", 3));
+}
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,138 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <string>
+
+#include "envoy/config/core/v3/protocol.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/utility.h"
+
+#include "test/common/http/http2/codec_impl_test_util.h"
+#include "test/common/http/http2/http2_frame.h"
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+namespace {
+
+// Answers requests dispatched to a server codec with gRPC responses carrying a number of custom
+// metadata headers and trailers, as a gRPC service attaching tracing or auth context to its
+// responses would. The responses have no body, which keeps flow control out of the measurement.
+class Http2CodecSpeedTest {
+public:
+  Http2CodecSpeedTest(bool reference_headers, uint32_t num_headers, uint32_t header_size) {
+    Runtime::LoaderSingleton::getExisting()->mergeValues(
+        {{"envoy.reloadable_features.http2_reference_response_headers",
+          reference_headers ? "true" : "false"}});
+
+    ON_CALL(server_callbacks_, newStream(testing::_, testing::_))
+        .WillByDefault([this](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+          response_encoder_ = &encoder;
+          return request_decoder_;
+        });
+    ON_CALL(connection_, write(testing::_, testing::_))
+        .WillByDefault([this](Buffer::Instance& data, bool) {
+          bytes_written_ += data.length();
+          data.drain(data.length());
+        });
+
+    server_ = std::make_unique<TestServerConnectionImpl>(
+        connection_, server_callbacks_, stats_store_,
+        ::Envoy::Http2::Utility::initializeAndValidateOptions(
+            envoy::config::core::v3::Http2ProtocolOptions()),
+        random_, DEFAULT_MAX_REQUEST_HEADERS_KB, DEFAULT_MAX_HEADERS_COUNT,
+        envoy::config::core::v3::HttpProtocolOptions::ALLOW);
+    Buffer::OwnedImpl preface(Http2Frame::Preamble, sizeof(Http2Frame::Preamble) - 1);
+    dispatch(preface);
+    const Http2Frame settings = Http2Frame::makeEmptySettingsFrame();
+    Buffer::OwnedImpl settings_buffer(settings.data(), settings.size());
+    dispatch(settings_buffer);
+
+    response_headers_.setStatus(200);
+    response_headers_.setContentType(Headers::get().ContentTypeValues.Grpc);
+    for (uint32_t i = 0; i < num_headers; ++i) {
+      response_headers_.addCopy(LowerCaseString(fmt::format("x-metadata-{}-bin", i)),
+                                std::string(header_size, 'a'));
+      response_trailers_.addCopy(LowerCaseString(fmt::format("x-trailing-metadata-{}", i)),
+                                 std::string(header_size, 'b'));
+    }
+    response_trailers_.setGrpcStatus(0);
+  }
+
+  ~Http2CodecSpeedTest() { connection_.dispatcher_.clearDeferredDeleteList(); }
+
+  // Dispatches a request on a new stream and encodes the response to it.
+  void answerRequest() {
+    const Http2Frame request = Http2Frame::makeRequest(
+        Http2Frame::makeClientStreamId(next_stream_index_++), "host", "/service/method");
+    Buffer::OwnedImpl request_buffer(request.data(), request.size());
+    dispatch(request_buffer);
+
+    response_encoder_->encodeHeaders(response_headers_, false);
+    response_encoder_->encodeTrailers(response_trailers_);
+    // Releases the closed stream.
+    connection_.dispatcher_.clearDeferredDeleteList();
+  }
+
+  uint64_t bytesWritten() const { return bytes_written_; }
+
+private:
+  void dispatch(Buffer::Instance& data) {
+    const Status status = server_->dispatch(data);
+    RELEASE_ASSERT(status.ok(), std::string(status.message()));
+  }
+
+  TestScopedRuntime scoped_runtime_;
+  Stats::TestUtil::TestStore stats_store_;
+  NiceMock<Network::MockConnection> connection_;
+  NiceMock<MockServerConnectionCallbacks> server_callbacks_;
+  NiceMock<MockRequestDecoder> request_decoder_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  std::unique_ptr<TestServerConnectionImpl> server_;
+  ResponseEncoder* response_encoder_{};
+  TestResponseHeaderMapImpl response_headers_;
+  TestResponseTrailerMapImpl response_trailers_;
+  uint32_t next_stream_index_{};
+  uint64_t bytes_written_{};
+};
+
+// The first argument enables (1) or disables (0) referencing the response headers rather than
+// copying them, the second one is the number of custom metadata headers in the headers and in the
+// trailers of a response, and the third one the size of their values.
+void encodeGrpcResponses(benchmark::State& state) {
+  Http2CodecSpeedTest speed_test(state.range(0), state.range(1), state.range(2));
+  for (auto _ : state) {
+    speed_test.answerRequest();
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(speed_test.bytesWritten());
+}
+
+void grpcResponseArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t reference_headers : {0, 1}) {
+    // A few small metadata entries, such as request IDs.
+    b->Args({reference_headers, 4, 32});
+    // Many metadata entries, such as a tracing context and per call cost accounting.
+    b->Args({reference_headers, 32, 64});
+    // Large binary metadata entries, such as serialized auth tokens and error details.
+    b->Args({reference_headers, 8, 2048});
+  }
+}
+
+BENCHMARK(encodeGrpcResponses)->Apply(grpcResponseArgs);
+
+} // namespace
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
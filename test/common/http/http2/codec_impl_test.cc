@@ -743,6 +743,77 @@ TEST_P(Http2CodecImplTest, SubmitTrailingEmptyHeaders) {
   response_encoder_->encodeTrailers(TestResponseTrailerMapImpl{});
 }
 
+// Response headers and trailers encoded outside of dispatch are referenced by nghttp2 rather than
+// copied. Verify that they are serialized before the encode calls return, by holding back the
+// frames from the client until the header maps are gone.
+TEST_P(Http2CodecImplTest, ReferencedResponseHeadersSerializedBeforeEncodeReturns) {
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+
+  TestResponseHeaderMapImpl expected_headers{{":status", "200"},
+                                             {"content-type", "application/grpc"},
+                                             {"x-large", std::string(4096, 'a')}};
+  TestResponseTrailerMapImpl expected_trailers{{"grpc-status", "0"},
+                                               {"grpc-message", std::string(1024, 'b')}};
+
+  client_wrapper_.dispatching_ = true;
+  auto response_headers = std::make_unique<TestResponseHeaderMapImpl>(expected_headers);
+  response_encoder_->encodeHeaders(*response_headers, false);
+  response_headers.reset();
+  auto response_trailers = std::make_unique<TestResponseTrailerMapImpl>(expected_trailers);
+  response_encoder_->encodeTrailers(*response_trailers);
+  response_trailers.reset();
+
+  EXPECT_CALL(response_decoder_, decodeHeaders_(HeaderMapEqual(&expected_headers), false));
+  EXPECT_CALL(response_decoder_, decodeTrailers_(HeaderMapEqual(&expected_trailers)));
+  client_wrapper_.dispatching_ = false;
+  EXPECT_TRUE(client_wrapper_.dispatch(Buffer::OwnedImpl(), *client_).ok());
+}
+
+// Response headers encoded while the server is dispatching are only sent once the dispatch
+// completes, so they must be copied.
+TEST_P(Http2CodecImplTest, ResponseHeadersEncodedWhileDispatchingAreCopied) {
+  initialize();
+
+  TestResponseHeaderMapImpl expected_headers{{":status", "200"},
+                                             {"x-large", std::string(4096, 'a')}};
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true)).WillOnce(InvokeWithoutArgs([&]() -> void {
+    auto response_headers = std::make_unique<TestResponseHeaderMapImpl>(expected_headers);
+    response_encoder_->encodeHeaders(*response_headers, true);
+  }));
+  EXPECT_CALL(response_decoder_, decodeHeaders_(HeaderMapEqual(&expected_headers), true));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+}
+
+// With "envoy.reloadable_features.http2_reference_response_headers" turned off, response headers
+// and trailers are copied by nghttp2.
+TEST_P(Http2CodecImplTest, ReferenceResponseHeadersDisabled) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.http2_reference_response_headers", "false"}});
+
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+
+  TestResponseHeaderMapImpl expected_headers{{":status", "200"},
+                                             {"x-large", std::string(4096, 'a')}};
+  TestResponseTrailerMapImpl expected_trailers{{"grpc-status", "0"}};
+  EXPECT_CALL(response_decoder_, decodeHeaders_(HeaderMapEqual(&expected_headers), false));
+  response_encoder_->encodeHeaders(TestResponseHeaderMapImpl(expected_headers), false);
+  EXPECT_CALL(response_decoder_, decodeTrailers_(HeaderMapEqual(&expected_trailers)));
+  response_encoder_->encodeTrailers(TestResponseTrailerMapImpl(expected_trailers));
+}
+
 TEST_P(Http2CodecImplTest, TrailingHeadersLargeClientBody) {
   initialize();
 
@@ -0,0 +1,113 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/http/stream_arena_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+bool isAligned(const void* memory, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(memory) % alignment == 0;
+}
+
+TEST(StreamArenaImplTest, NoAllocations) {
+  StreamArenaImpl arena(1024);
+  EXPECT_EQ(0, arena.allocations());
+  EXPECT_EQ(0, arena.blocks());
+}
+
+TEST(StreamArenaImplTest, AllocationsShareBlocks) {
+  StreamArenaImpl arena(1024);
+  std::vector<char*> allocations;
+  for (size_t i = 0; i < 16; ++i) {
+    char* memory = static_cast<char*>(arena.allocate(48, 8));
+    EXPECT_TRUE(isAligned(memory, 8));
+    // Allocations must not overlap.
+    std::fill(memory, memory + 48, static_cast<char>(i));
+    allocations.push_back(memory);
+  }
+  for (size_t i = 0; i < allocations.size(); ++i) {
+    EXPECT_EQ(std::string(48, static_cast<char>(i)), std::string(allocations[i], 48));
+  }
+  EXPECT_EQ(16, arena.allocations());
+  EXPECT_EQ(1, arena.blocks());
+
+  // The 22nd allocation doesn't fit in the first block.
+  for (size_t i = 0; i < 6; ++i) {
+    arena.allocate(48, 8);
+  }
+  EXPECT_EQ(2, arena.blocks());
+}
+
+TEST(StreamArenaImplTest, Alignment) {
+  StreamArenaImpl arena(1024);
+  arena.allocate(1, 1);
+  EXPECT_TRUE(isAligned(arena.allocate(8, 8), 8));
+  arena.allocate(3, 1);
+  EXPECT_TRUE(isAligned(arena.allocate(16, alignof(std::max_align_t)), alignof(std::max_align_t)));
+  EXPECT_EQ(1, arena.blocks());
+}
+
+TEST(StreamArenaImplTest, LargeAllocationKeepsCurrentBlock) {
+  StreamArenaImpl arena(256);
+  char* first = static_cast<char*>(arena.allocate(16, 8));
+  char* large = static_cast<char*>(arena.allocate(4096, 8));
+  std::fill(large, large + 4096, 'a');
+  char* second = static_cast<char*>(arena.allocate(16, 8));
+  EXPECT_EQ(first + 16, second);
+  EXPECT_EQ(2, arena.blocks());
+}
+
+TEST(StreamArenaImplTest, CleanupsRunInReverseOrder) {
+  std::vector<int> order;
+  {
+    StreamArenaImpl arena(256);
+    arena.addCleanup([](void* order) { static_cast<std::vector<int>*>(order)->push_back(1); },
+                     &order);
+    arena.addCleanup([](void* order) { static_cast<std::vector<int>*>(order)->push_back(2); },
+                     &order);
+    EXPECT_TRUE(order.empty());
+    // Cleanups are not counted as allocations.
+    EXPECT_EQ(0, arena.allocations());
+  }
+  EXPECT_EQ((std::vector<int>{2, 1}), order);
+}
+
+TEST(StreamArenaImplTest, CreateDestroysObjects) {
+  struct Counted {
+    explicit Counted(int& destroyed) : destroyed_(destroyed) {}
+    ~Counted() { ++destroyed_; }
+    int& destroyed_;
+  };
+
+  int destroyed = 0;
+  {
+    StreamArenaImpl arena(256);
+    std::string& value = arena.create<std::string>(1000, 'a');
+    EXPECT_EQ(1000, value.size());
+    arena.create<Counted>(destroyed);
+    arena.create<Counted>(destroyed);
+    EXPECT_EQ(0, destroyed);
+    EXPECT_EQ(3, arena.allocations());
+  }
+  EXPECT_EQ(2, destroyed);
+}
+
+TEST(StreamArenaImplTest, MakeStreamArenaPtr) {
+  StreamArenaImpl arena(256);
+  {
+    StreamArenaPtr<std::string> in_arena = makeStreamArenaPtr<std::string>(arena, 100, 'a');
+    StreamArenaPtr<std::string> on_heap = makeStreamArenaPtr<std::string>({}, 100, 'b');
+    EXPECT_EQ(std::string(100, 'a'), *in_arena);
+    EXPECT_EQ(std::string(100, 'b'), *on_heap);
+  }
+  EXPECT_EQ(1, arena.allocations());
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
@@ -912,6 +912,23 @@ TEST_P(ConnectionImplTest, HalfClose) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+TEST_P(ConnectionImplTest, SpliceableIoHandle) {
+  setUpBasicConnection();
+  connect();
+
+  // Raw buffer sockets with nothing buffered can be spliced.
+  EXPECT_EQ(&testClientConnection()->ioHandle(), client_connection_->spliceableIoHandle());
+  EXPECT_NE(nullptr, server_connection_->spliceableIoHandle());
+
+  // Bytes waiting in the write buffer would be reordered by a splice.
+  Buffer::OwnedImpl buffer("data");
+  client_connection_->write(buffer, false);
+  EXPECT_EQ(nullptr, client_connection_->spliceableIoHandle());
+
+  disconnect(true);
+  EXPECT_EQ(nullptr, client_connection_->spliceableIoHandle());
+}
+
 // Test that connections do not detect early close when half-close is enabled
 TEST_P(ConnectionImplTest, HalfCloseNoEarlyCloseDetection) {
   setUpBasicConnection();
@@ -0,0 +1,157 @@
+#include <sched.h>
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "envoy/common/platform.h"
+#include "envoy/config/core/v3/base.pb.h"
+
+#include "common/common/assert.h"
+#include "common/network/listen_socket_impl.h"
+#include "common/network/reuse_port_cpu_steering_socket_option_impl.h"
+#include "common/network/socket_option_factory.h"
+#include "common/network/utility.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/network_utility.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+TEST(ReusePortCpuSteeringSocketOptionImplTest, OnlyAppliedWhenListening) {
+  testing::StrictMock<MockListenSocket> socket;
+  ReusePortCpuSteeringSocketOptionImpl option(4, {});
+  EXPECT_TRUE(option.setOption(socket, envoy::config::core::v3::SocketOption::STATE_PREBIND));
+  EXPECT_TRUE(option.setOption(socket, envoy::config::core::v3::SocketOption::STATE_BOUND));
+  EXPECT_EQ(absl::nullopt,
+            option.getOptionDetails(socket, envoy::config::core::v3::SocketOption::STATE_BOUND));
+
+  const auto details =
+      option.getOptionDetails(socket, envoy::config::core::v3::SocketOption::STATE_LISTENING);
+  if (ReusePortCpuSteeringSocketOptionImpl::isSupported()) {
+    ASSERT_TRUE(details.has_value());
+    EXPECT_EQ(ENVOY_ATTACH_REUSEPORT_CBPF, details->name_);
+    // The programs for different numbers of sockets differ.
+    const auto other_details = ReusePortCpuSteeringSocketOptionImpl(3, {}).getOptionDetails(
+        socket, envoy::config::core::v3::SocketOption::STATE_LISTENING);
+    ASSERT_TRUE(other_details.has_value());
+    EXPECT_NE(details->value_, other_details->value_);
+    // So do the programs for different worker CPU sets.
+    const auto pinned_details = ReusePortCpuSteeringSocketOptionImpl(4, {1, 0}).getOptionDetails(
+        socket, envoy::config::core::v3::SocketOption::STATE_LISTENING);
+    ASSERT_TRUE(pinned_details.has_value());
+    EXPECT_NE(details->value_, pinned_details->value_);
+  } else {
+    EXPECT_EQ(absl::nullopt, details);
+  }
+}
+
+#ifdef __linux__
+class ReusePortCpuSteeringLoadDistributionTest : public testing::TestWithParam<Address::IpVersion> {
+protected:
+  // Connects from each CPU the test can run on, and checks that all the connections of a CPU land
+  // on the socket of the group expected_socket() returns for it. Loopback connections are received
+  // by the CPU which makes them.
+  void testSteering(uint32_t socket_count, const std::vector<uint32_t>& worker_cpu_set,
+                    const std::function<uint32_t(uint32_t cpu)>& expected_socket) {
+    constexpr uint32_t ConnectionsPerCpu = 16;
+
+    auto options = std::make_shared<Socket::Options>();
+    Socket::appendOptions(options, SocketOptionFactory::buildReusePortOptions());
+    Socket::appendOptions(options, SocketOptionFactory::buildReusePortCpuSteeringOptions(
+                                       socket_count, worker_cpu_set));
+    Address::InstanceConstSharedPtr address =
+        Network::Test::getCanonicalLoopbackAddress(GetParam());
+    std::vector<SocketPtr> sockets;
+    for (uint32_t i = 0; i < socket_count; ++i) {
+      sockets.push_back(std::make_unique<TcpListenSocket>(address, options, true));
+      address = sockets.back()->addressProvider().localAddress();
+      ASSERT_EQ(0, sockets.back()->listen(128).rc_);
+      ASSERT_TRUE(Socket::applyOptions(options, *sockets.back(),
+                                       envoy::config::core::v3::SocketOption::STATE_LISTENING));
+    }
+
+    for (const uint32_t cpu : allowedCpus()) {
+      SCOPED_TRACE(cpu);
+
+      std::vector<SocketPtr> clients;
+      std::thread connector([cpu, &address, &clients]() {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        ASSERT_EQ(0, sched_setaffinity(0, sizeof(cpus), &cpus));
+        for (uint32_t i = 0; i < ConnectionsPerCpu; ++i) {
+          clients.push_back(std::make_unique<ClientSocketImpl>(address, nullptr));
+          clients.back()->setBlockingForTest(true);
+          ASSERT_EQ(0, clients.back()->connect(address).rc_);
+        }
+      });
+      connector.join();
+
+      std::vector<uint32_t> accepted(socket_count);
+      for (uint32_t i = 0; i < socket_count; ++i) {
+        while (sockets[i]->ioHandle().accept(nullptr, nullptr) != nullptr) {
+          ++accepted[i];
+        }
+      }
+      std::vector<uint32_t> expected(socket_count);
+      expected[expected_socket(cpu)] = ConnectionsPerCpu;
+      EXPECT_EQ(expected, accepted);
+    }
+  }
+
+  static std::vector<uint32_t> allowedCpus() {
+    cpu_set_t allowed_cpus;
+    RELEASE_ASSERT(sched_getaffinity(0, sizeof(allowed_cpus), &allowed_cpus) == 0, "");
+    std::vector<uint32_t> cpus;
+    for (uint32_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &allowed_cpus)) {
+        cpus.push_back(cpu);
+      }
+    }
+    return cpus;
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(IpVersions, ReusePortCpuSteeringLoadDistributionTest,
+                         testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
+                         TestUtility::ipTestParamsToString);
+
+// Without pinned workers, the connections of a CPU land on the socket whose index in the
+// SO_REUSEPORT group is that CPU modulo the number of sockets.
+TEST_P(ReusePortCpuSteeringLoadDistributionTest, SteersConnectionsByCpu) {
+  constexpr uint32_t SocketCount = 3;
+  testSteering(SocketCount, {}, [](uint32_t cpu) { return cpu % SocketCount; });
+}
+
+// With pinned workers, the connections of a CPU land on the socket of the first worker pinned to
+// it, whatever the number of the CPU. The workers are pinned to the allowed CPUs in reverse order,
+// and the last CPU has no worker.
+TEST_P(ReusePortCpuSteeringLoadDistributionTest, SteersConnectionsToPinnedWorker) {
+  const std::vector<uint32_t> cpus = allowedCpus();
+  if (cpus.size() < 2) {
+    return;
+  }
+  const std::vector<uint32_t> worker_cpu_set(cpus.rbegin(), cpus.rend() - 1);
+  // Two workers per pinned CPU.
+  const uint32_t socket_count = 2 * worker_cpu_set.size();
+  testSteering(socket_count, worker_cpu_set, [&](uint32_t cpu) -> uint32_t {
+    for (uint32_t worker = 0; worker < worker_cpu_set.size(); ++worker) {
+      if (worker_cpu_set[worker] == cpu) {
+        return worker;
+      }
+    }
+    return cpu % socket_count;
+  });
+}
+#endif
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
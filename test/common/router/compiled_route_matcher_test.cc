@@ -0,0 +1,121 @@
+#include <algorithm>
+
+#include "common/router/compiled_route_matcher.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+RouteRadixTrie::Candidates collect(const RouteRadixTrie& trie, absl::string_view path) {
+  RouteRadixTrie::Candidates candidates;
+  trie.collect(path, candidates);
+  std::sort(candidates.begin(), candidates.end());
+  return candidates;
+}
+
+CompiledRouteMatcher::Candidates candidates(const CompiledRouteMatcher& matcher,
+                                            absl::string_view path) {
+  CompiledRouteMatcher::Candidates candidates;
+  matcher.candidates(path, candidates);
+  return candidates;
+}
+
+TEST(RouteRadixTrieTest, PrefixAndExact) {
+  RouteRadixTrie trie(false);
+  trie.addPrefix("/", 0);
+  trie.addPrefix("/foo", 1);
+  trie.addPrefix("/foobar", 2);
+  trie.addExact("/foo", 3);
+  trie.addPrefix("/fab", 4);
+  trie.addExact("/foobar/baz", 5);
+  trie.addPrefix("", 6);
+
+  EXPECT_THAT(collect(trie, ""), ElementsAre(6));
+  EXPECT_THAT(collect(trie, "/"), ElementsAre(0, 6));
+  EXPECT_THAT(collect(trie, "/fo"), ElementsAre(0, 6));
+  EXPECT_THAT(collect(trie, "/foo"), ElementsAre(0, 1, 3, 6));
+  EXPECT_THAT(collect(trie, "/foob"), ElementsAre(0, 1, 6));
+  EXPECT_THAT(collect(trie, "/foobar/baz"), ElementsAre(0, 1, 2, 5, 6));
+  EXPECT_THAT(collect(trie, "/foobar/bazz"), ElementsAre(0, 1, 2, 6));
+  EXPECT_THAT(collect(trie, "/fab/x"), ElementsAre(0, 4, 6));
+  EXPECT_THAT(collect(trie, "/FOO"), ElementsAre(0, 6));
+  EXPECT_THAT(collect(trie, "x"), ElementsAre(6));
+}
+
+TEST(RouteRadixTrieTest, EdgeSplitting) {
+  RouteRadixTrie trie(false);
+  trie.addExact("/abcdef", 0);
+  // Root plus one leaf.
+  EXPECT_EQ(2, trie.size());
+  trie.addExact("/abc", 1);
+  // The existing edge is split at "/abc".
+  EXPECT_EQ(3, trie.size());
+  trie.addExact("/abx", 2);
+  // "/ab" becomes a branch node with "c" and "x" children.
+  EXPECT_EQ(5, trie.size());
+  trie.addExact("/abc", 3);
+  EXPECT_EQ(5, trie.size());
+
+  EXPECT_THAT(collect(trie, "/abcdef"), ElementsAre(0));
+  EXPECT_THAT(collect(trie, "/abc"), ElementsAre(1, 3));
+  EXPECT_THAT(collect(trie, "/abx"), ElementsAre(2));
+  EXPECT_THAT(collect(trie, "/ab"), IsEmpty());
+  EXPECT_THAT(collect(trie, "/abcde"), IsEmpty());
+}
+
+TEST(RouteRadixTrieTest, IgnoreCase) {
+  RouteRadixTrie trie(true);
+  trie.addPrefix("/Foo", 0);
+  trie.addExact("/foo/BAR", 1);
+
+  EXPECT_THAT(collect(trie, "/foo"), ElementsAre(0));
+  EXPECT_THAT(collect(trie, "/FOO/bar"), ElementsAre(0, 1));
+  EXPECT_THAT(collect(trie, "/fOo/bAr/"), ElementsAre(0));
+}
+
+TEST(CompiledRouteMatcherTest, CandidatesAreOrdered) {
+  CompiledRouteMatcher matcher;
+  matcher.addRegex("/users/[0-9]+", 0);
+  matcher.addPrefix("/users", true, 1);
+  matcher.addUnindexed(2);
+  matcher.addExactPath("/USERS/1", false, 3);
+  matcher.addRegex(".*", 4);
+  matcher.addPrefix("/", true, 5);
+  matcher.compile();
+
+  EXPECT_THAT(candidates(matcher, "/users/1"), ElementsAre(0, 1, 2, 3, 4, 5));
+  EXPECT_THAT(candidates(matcher, "/users/1?x=y#frag"), ElementsAre(0, 1, 2, 3, 4, 5));
+  EXPECT_THAT(candidates(matcher, "/users/a"), ElementsAre(1, 2, 4, 5));
+  EXPECT_THAT(candidates(matcher, "/other"), ElementsAre(2, 4, 5));
+  EXPECT_THAT(candidates(matcher, "nope"), ElementsAre(2, 4));
+}
+
+TEST(CompiledRouteMatcherTest, RegexIsFullyAnchored) {
+  CompiledRouteMatcher matcher;
+  matcher.addRegex("/a+", 0);
+  matcher.compile();
+
+  EXPECT_THAT(candidates(matcher, "/aaa"), ElementsAre(0));
+  EXPECT_THAT(candidates(matcher, "/aaab"), IsEmpty());
+  EXPECT_THAT(candidates(matcher, "x/aaa"), IsEmpty());
+}
+
+TEST(CompiledRouteMatcherTest, InvalidRegexIsUnindexed) {
+  CompiledRouteMatcher matcher;
+  matcher.addRegex("/(unbalanced", 0);
+  matcher.addPrefix("/x", true, 1);
+  matcher.compile();
+
+  EXPECT_THAT(candidates(matcher, "/y"), ElementsAre(0));
+  EXPECT_THAT(candidates(matcher, "/x"), ElementsAre(0, 1));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
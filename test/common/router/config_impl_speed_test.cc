@@ -40,12 +40,13 @@ static Http::TestRequestHeaderMapImpl genRequestHeaders(int route_num) {
  * Generates the route config for the type of matcher being tested.
  */
 static RouteConfiguration genRouteConfig(benchmark::State& state,
-                                         RouteMatch::PathSpecifierCase match_type) {
+                                         RouteMatch::PathSpecifierCase match_type, bool compiled) {
   // Create the base route config.
   RouteConfiguration route_config;
   VirtualHost* v_host = route_config.add_virtual_hosts();
   v_host->set_name("default");
   v_host->add_domains("*");
+  v_host->set_compile_route_matchers(compiled);
 
   // Create `n` regex routes. The last route will be the only one matched.
   for (int i = 0; i < state.range(0); ++i) {
@@ -60,7 +61,7 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
       break;
     }
     case RouteMatch::PathSpecifierCase::kPath: {
-      match->set_prefix(absl::StrCat("/shelves/shelf_", i, "/route_", i));
+      match->set_path(absl::StrCat("/shelves/shelf_", i, "/route_", i));
       break;
     }
     case RouteMatch::PathSpecifierCase::kSafeRegex: {
@@ -86,7 +87,8 @@ static RouteConfiguration genRouteConfig(benchmark::State& state,
  * We then time how long it takes for the request to be matched against the
  * last route.
  */
-static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierCase match_type) {
+static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierCase match_type,
+                             bool compiled = false) {
   // Setup router for benchmarking.
   TestScopedRuntime scoped_runtime;
   Runtime::LoaderSingleton::getExisting()->mergeValues(
@@ -97,7 +99,7 @@ static void bmRouteTableSize(benchmark::State& state, RouteMatch::PathSpecifierC
   ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
 
   // Create router config.
-  ConfigImpl config(genRouteConfig(state, match_type), factory_context,
+  ConfigImpl config(genRouteConfig(state, match_type, compiled), factory_context,
                     ProtobufMessage::getNullValidationVisitor(), true);
 
   for (auto _ : state) { // NOLINT
@@ -140,9 +142,69 @@ static void bmRouteTableSizeWithRegexMatch(benchmark::State& state) {
   bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kSafeRegex);
 }
 
+/**
+ * The same route tables as above with compile_route_matchers enabled. The per-request cost should
+ * stay flat as the number of routes grows, since only the candidate routes found through the
+ * compiled index are evaluated.
+ */
+static void bmCompiledRouteTableSizeWithPathPrefixMatch(benchmark::State& state) {
+  bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kPrefix, true);
+}
+
+static void bmCompiledRouteTableSizeWithExactPathMatch(benchmark::State& state) {
+  bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kPath, true);
+}
+
+static void bmCompiledRouteTableSizeWithRegexMatch(benchmark::State& state) {
+  bmRouteTableSize(state, RouteMatch::PathSpecifierCase::kSafeRegex, true);
+}
+
+/**
+ * Measure the speed of selecting a virtual host by suffix wildcard domain when the route
+ * configuration has `n` virtual hosts with domains of the form:
+ * - *.tenant_0.example.com
+ * - *.tenant_1.example.com
+ * - etc.
+ *
+ * The lookup walks the Host header once through the domain trie, so its cost should depend on the
+ * length of the host rather than on the number of virtual hosts.
+ */
+static void bmWildcardVirtualHostLookup(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+
+  RouteConfiguration route_config;
+  for (int i = 0; i < state.range(0); ++i) {
+    VirtualHost* v_host = route_config.add_virtual_hosts();
+    v_host->set_name(absl::StrCat("tenant_", i));
+    v_host->add_domains(absl::StrCat("*.tenant_", i, ".example.com"));
+    Route* route = v_host->add_routes();
+    route->mutable_match()->set_prefix("/");
+    route->mutable_direct_response()->set_status(200);
+  }
+  ConfigImpl config(route_config, factory_context, ProtobufMessage::getNullValidationVisitor(),
+                    true);
+
+  const Http::TestRequestHeaderMapImpl headers{
+      {":authority", absl::StrCat("www.tenant_", state.range(0) - 1, ".example.com")},
+      {":method", "GET"},
+      {":path", "/"},
+      {"x-forwarded-proto", "http"}};
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(config.route(headers, stream_info, 0));
+  }
+}
+
 BENCHMARK(bmRouteTableSizeWithPathPrefixMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithExactPathMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
 BENCHMARK(bmRouteTableSizeWithRegexMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
+BENCHMARK(bmCompiledRouteTableSizeWithPathPrefixMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
+BENCHMARK(bmCompiledRouteTableSizeWithExactPathMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
+BENCHMARK(bmCompiledRouteTableSizeWithRegexMatch)->RangeMultiplier(2)->Ranges({{1, 2 << 13}});
+BENCHMARK(bmWildcardVirtualHostLookup)->RangeMultiplier(10)->Ranges({{1, 100000}});
 
 } // namespace
 } // namespace Router
@@ -599,6 +599,115 @@ virtual_hosts:
             config.route(genHeaders("bat5.com", " ", "CONNECT"), 0)->routeEntry()->clusterName());
 }
 
+// Verify that the compiled route matcher selects the same routes as the linear route walk,
+// including first-match ordering across prefix, exact, regex and unindexed matchers.
+TEST_F(RouteMatcherTest, CompiledRouteMatchers) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+- name: compiled
+  domains:
+  - "*"
+  compile_route_matchers: true
+  routes:
+  - match:
+      prefix: "/api/v1/"
+      headers:
+      - name: x-canary
+        exact_match: "true"
+    route:
+      cluster: canary
+  - match:
+      path: "/api/v1/users"
+    route:
+      cluster: users_exact
+  - match:
+      safe_regex:
+        google_re2: {}
+        regex: "/api/v1/users/[0-9]+"
+    route:
+      cluster: user_by_id
+  - match:
+      prefix: "/API/V1/"
+      case_sensitive: false
+    route:
+      cluster: api_v1_any_case
+  - match:
+      connect_matcher:
+        {}
+    route:
+      cluster: connect
+  - match:
+      prefix: "/api/"
+    route:
+      cluster: api
+  - match:
+      path: "/other"
+    route:
+      cluster: other
+  - match:
+      prefix: "/"
+    route:
+      cluster: fallback
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters(
+      {"canary", "users_exact", "user_by_id", "api_v1_any_case", "connect", "api", "other",
+       "fallback"},
+      {});
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+
+  {
+    Http::TestRequestHeaderMapImpl headers = genHeaders("www.lyft.com", "/api/v1/users", "GET");
+    headers.addCopy("x-canary", "true");
+    EXPECT_EQ("canary", config.route(headers, 0)->routeEntry()->clusterName());
+  }
+  EXPECT_EQ("users_exact",
+            config.route(genHeaders("www.lyft.com", "/api/v1/users?limit=10", "GET"), 0)
+                ->routeEntry()
+                ->clusterName());
+  EXPECT_EQ("user_by_id", config.route(genHeaders("www.lyft.com", "/api/v1/users/123", "GET"), 0)
+                              ->routeEntry()
+                              ->clusterName());
+  EXPECT_EQ("api_v1_any_case",
+            config.route(genHeaders("www.lyft.com", "/api/v1/users/abc", "GET"), 0)
+                ->routeEntry()
+                ->clusterName());
+  EXPECT_EQ("api_v1_any_case", config.route(genHeaders("www.lyft.com", "/Api/V1/foo", "GET"), 0)
+                                   ->routeEntry()
+                                   ->clusterName());
+  EXPECT_EQ("connect", config.route(genHeaders("www.lyft.com", "/api/v2", "CONNECT"), 0)
+                           ->routeEntry()
+                           ->clusterName());
+  EXPECT_EQ("connect", config.route(genPathlessHeaders("www.lyft.com", "CONNECT"), 0)
+                           ->routeEntry()
+                           ->clusterName());
+  EXPECT_EQ("api", config.route(genHeaders("www.lyft.com", "/api/v2", "GET"), 0)
+                       ->routeEntry()
+                       ->clusterName());
+  EXPECT_EQ("other", config.route(genHeaders("www.lyft.com", "/other", "GET"), 0)
+                         ->routeEntry()
+                         ->clusterName());
+  EXPECT_EQ("fallback", config.route(genHeaders("www.lyft.com", "/other/more", "GET"), 0)
+                            ->routeEntry()
+                            ->clusterName());
+  EXPECT_EQ("fallback",
+            config.route(genHeaders("www.lyft.com", "/", "GET"), 0)->routeEntry()->clusterName());
+
+  // Route callbacks see matching routes in table order and can skip to later matches.
+  std::vector<std::string> visited;
+  RouteConstSharedPtr accepted =
+      config.route(
+          [&visited](RouteConstSharedPtr route, RouteEvalStatus route_eval_status) {
+            visited.push_back(route->routeEntry()->clusterName());
+            EXPECT_EQ(RouteEvalStatus::HasMoreRoutes, route_eval_status);
+            return route->routeEntry()->clusterName() == "api" ? RouteMatchStatus::Accept
+                                                               : RouteMatchStatus::Continue;
+          },
+          genHeaders("www.lyft.com", "/api/v1/users/1", "GET"));
+  EXPECT_EQ("api", accepted->routeEntry()->clusterName());
+  EXPECT_EQ((std::vector<std::string>{"user_by_id", "api_v1_any_case", "api"}), visited);
+}
+
 TEST_F(RouteMatcherTest, TestRoutes) {
   const std::string yaml = R"EOF(
 virtual_hosts:
@@ -0,0 +1,79 @@
+#include <string>
+
+#include "common/router/domain_trie.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+template <class Trie> std::string exact(const Trie& trie, absl::string_view host) {
+  const auto match = trie.find(host);
+  return match.exact_ == nullptr ? "" : *match.exact_;
+}
+
+template <class Trie> std::string wildcard(const Trie& trie, absl::string_view host) {
+  const auto match = trie.find(host);
+  return match.wildcard_ == nullptr ? "" : *match.wildcard_;
+}
+
+TEST(DomainTrieTest, ExactAndSuffixWildcards) {
+  DomainTrie<std::string, true> trie;
+  EXPECT_TRUE(trie.empty());
+  EXPECT_TRUE(trie.addExact("www.foo.com", "exact"));
+  EXPECT_TRUE(trie.addWildcard(".foo.com", "dot-foo"));
+  EXPECT_TRUE(trie.addWildcard("-bar.foo.com", "dash-bar"));
+  EXPECT_TRUE(trie.addWildcard("foo.com", "foo"));
+  EXPECT_FALSE(trie.empty());
+
+  EXPECT_FALSE(trie.addExact("www.foo.com", "duplicate"));
+  EXPECT_FALSE(trie.addWildcard(".foo.com", "duplicate"));
+  // The same key may be both an exact domain and a wildcard.
+  EXPECT_TRUE(trie.addExact("foo.com", "foo-exact"));
+
+  EXPECT_EQ("exact", exact(trie, "www.foo.com"));
+  EXPECT_EQ("exact", exact(trie, "WWW.Foo.COM"));
+  EXPECT_EQ("dot-foo", wildcard(trie, "www.foo.com"));
+  EXPECT_EQ("", exact(trie, "api.foo.com"));
+  EXPECT_EQ("dot-foo", wildcard(trie, "api.foo.com"));
+  EXPECT_EQ("dash-bar", wildcard(trie, "x-bar.foo.com"));
+  EXPECT_EQ("foo", wildcard(trie, "xfoo.com"));
+  EXPECT_EQ("foo-exact", exact(trie, "foo.com"));
+
+  // The wildcard part must not be empty.
+  EXPECT_EQ("foo", wildcard(trie, ".foo.com"));
+  EXPECT_EQ("", wildcard(trie, "foo.com"));
+  EXPECT_EQ("", wildcard(trie, "oo.com"));
+  EXPECT_EQ("", wildcard(trie, "bar.com"));
+  EXPECT_EQ("", wildcard(trie, ""));
+}
+
+TEST(DomainTrieTest, PrefixWildcards) {
+  DomainTrie<std::string, false> trie;
+  EXPECT_TRUE(trie.addWildcard("foo.", "foo"));
+  EXPECT_TRUE(trie.addWildcard("foo.bar.", "foo-bar"));
+  EXPECT_TRUE(trie.addWildcard("fox", "fox"));
+
+  EXPECT_EQ("foo", wildcard(trie, "foo.com"));
+  EXPECT_EQ("foo-bar", wildcard(trie, "FOO.BAR.com"));
+  EXPECT_EQ("foo", wildcard(trie, "foo.bar"));
+  EXPECT_EQ("fox", wildcard(trie, "foxes"));
+  EXPECT_EQ("", wildcard(trie, "foo."));
+  EXPECT_EQ("", wildcard(trie, "fo"));
+}
+
+TEST(DomainTrieTest, NodesAreShared) {
+  DomainTrie<int, true> trie;
+  trie.addWildcard(".a.example.com", 1);
+  trie.addWildcard(".b.example.com", 2);
+  trie.addWildcard(".c.example.com", 3);
+  // Root, the shared ".example.com" suffix and one leaf per tenant.
+  EXPECT_EQ(5, trie.size());
+  EXPECT_EQ(2, *trie.find("x.b.example.com").wildcard_);
+  EXPECT_EQ(nullptr, trie.find("x.d.example.com").wildcard_);
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
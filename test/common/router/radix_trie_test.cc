@@ -0,0 +1,72 @@
+#include <string>
+#include <vector>
+
+#include "common/router/radix_trie.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using Trie = RadixTrie<std::vector<std::string>>;
+
+void insert(Trie& trie, absl::string_view key) {
+  trie.insert(key.size(), [key](size_t pos) -> uint8_t { return key[pos]; }).push_back(
+      std::string(key));
+}
+
+// Returns the payloads visited by a walk, with the number of bytes consumed at each of them.
+std::vector<std::string> walk(const Trie& trie, absl::string_view key) {
+  std::vector<std::string> visited;
+  trie.walk(
+      key.size(), [key](size_t pos) -> uint8_t { return key[pos]; },
+      [&visited](const std::vector<std::string>& payload, size_t pos) {
+        for (const std::string& value : payload) {
+          visited.push_back(absl::StrCat(value, "@", pos));
+        }
+      });
+  return visited;
+}
+
+TEST(RadixTrieTest, SplitsEdges) {
+  Trie trie;
+  EXPECT_EQ(1U, trie.size());
+  insert(trie, "/foo/bar");
+  EXPECT_EQ(2U, trie.size());
+  // Splits the "/foo/bar" edge into "/foo/" and "bar", and adds a "qux" leaf.
+  insert(trie, "/foo/qux");
+  EXPECT_EQ(4U, trie.size());
+  // Ends on the existing "/foo/" node.
+  insert(trie, "/foo/");
+  EXPECT_EQ(4U, trie.size());
+  // Ends inside the "/foo/" edge, which is split again.
+  insert(trie, "/fo");
+  EXPECT_EQ(5U, trie.size());
+  insert(trie, "");
+  EXPECT_EQ(5U, trie.size());
+
+  EXPECT_EQ((std::vector<std::string>{"@0", "/fo@3", "/foo/@5", "/foo/bar@8"}),
+            walk(trie, "/foo/bar"));
+  EXPECT_EQ((std::vector<std::string>{"@0", "/fo@3", "/foo/@5"}), walk(trie, "/foo/b"));
+  EXPECT_EQ((std::vector<std::string>{"@0", "/fo@3"}), walk(trie, "/fox"));
+  EXPECT_EQ((std::vector<std::string>{"@0"}), walk(trie, "/f"));
+  EXPECT_EQ((std::vector<std::string>{"@0"}), walk(trie, "bar"));
+}
+
+// Bytes above 0x7f sort and compare as unsigned.
+TEST(RadixTrieTest, HighBytes) {
+  Trie trie;
+  insert(trie, "a\xff");
+  insert(trie, "a\x01");
+  insert(trie, "a\x80z");
+  EXPECT_EQ((std::vector<std::string>{"a\x80z@3"}), walk(trie, "a\x80z"));
+  EXPECT_EQ((std::vector<std::string>{"a\xff@2"}), walk(trie, "a\xff"));
+  EXPECT_EQ((std::vector<std::string>{}), walk(trie, "a\x80y"));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,86 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures contention in AllocatorImpl when many threads concurrently allocate and free stats
+// with distinct names, as happens when scopes are created and destroyed during xDS updates.
+
+#include <vector>
+
+#include "common/common/thread.h"
+#include "common/stats/allocator_impl.h"
+#include "common/stats/symbol_table_impl.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/notification.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+constexpr uint32_t ScopesPerThread = 10;
+constexpr uint32_t StatsPerScope = 50;
+
+// Each thread repeatedly "creates a scope" by allocating a set of counters and gauges under a
+// thread-specific prefix, and "destroys" it by releasing them, which frees the stats.
+// state.range(0) is the number of threads and state.range(1) the number of allocator shards.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_CreateDestroyScopes(benchmark::State& state) {
+  const uint32_t num_threads = state.range(0);
+  SymbolTableImpl symbol_table;
+  AllocatorImpl alloc(symbol_table, state.range(1));
+  StatNamePool pool(symbol_table);
+
+  std::vector<std::vector<StatName>> names(num_threads);
+  for (uint32_t t = 0; t < num_threads; ++t) {
+    for (uint32_t s = 0; s < ScopesPerThread; ++s) {
+      for (uint32_t i = 0; i < StatsPerScope; ++i) {
+        names[t].push_back(pool.add(absl::StrCat("cluster.c", t, "_", s, ".stat", i)));
+      }
+    }
+  }
+
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+  for (auto _ : state) { // NOLINT
+    absl::Notification go;
+    std::vector<Thread::ThreadPtr> threads;
+    for (uint32_t t = 0; t < num_threads; ++t) {
+      threads.push_back(thread_factory.createThread([&alloc, &go, &names, t]() {
+        go.WaitForNotification();
+        std::vector<CounterSharedPtr> counters;
+        std::vector<GaugeSharedPtr> gauges;
+        for (uint32_t round = 0; round < 10; ++round) {
+          for (uint32_t s = 0; s < ScopesPerThread; ++s) {
+            const StatName* scope_names = &names[t][s * StatsPerScope];
+            for (uint32_t i = 0; i < StatsPerScope; i += 2) {
+              counters.push_back(alloc.makeCounter(scope_names[i], StatName(), {}));
+              gauges.push_back(alloc.makeGauge(scope_names[i + 1], StatName(), {},
+                                               Gauge::ImportMode::Accumulate));
+            }
+            counters.clear();
+            gauges.clear();
+          }
+        }
+      }));
+    }
+    go.Notify();
+    for (auto& thread : threads) {
+      thread->join();
+    }
+  }
+}
+BENCHMARK(BM_CreateDestroyScopes)
+    ->Args({1, 1})
+    ->Args({4, 1})
+    ->Args({16, 1})
+    ->Args({1, 16})
+    ->Args({4, 16})
+    ->Args({16, 16})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
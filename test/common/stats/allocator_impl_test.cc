@@ -1,10 +1,12 @@
 #include <string>
+#include <vector>
 
 #include "common/stats/allocator_impl.h"
 
 #include "test/test_common/logging.h"
 #include "test/test_common/thread_factory_for_test.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/notification.h"
 #include "gtest/gtest.h"
 
@@ -125,6 +127,71 @@ TEST_F(AllocatorImplTest, RefCountDecAllocRaceSynchronized) {
   EXPECT_FALSE(alloc_.isMutexLockedForTest());
 }
 
+// Stats of all types are found again in their shard, and freeing them leaves
+// every shard empty, as asserted by the allocator destructor.
+TEST_F(AllocatorImplTest, Sharded) {
+  AllocatorImpl alloc(symbol_table_, 8);
+  EXPECT_EQ(8, alloc.numShards());
+
+  std::vector<CounterSharedPtr> counters;
+  std::vector<GaugeSharedPtr> gauges;
+  std::vector<TextReadoutSharedPtr> text_readouts;
+  for (uint32_t i = 0; i < 100; ++i) {
+    counters.push_back(alloc.makeCounter(makeStat(absl::StrCat("counter", i)), StatName(), {}));
+    gauges.push_back(alloc.makeGauge(makeStat(absl::StrCat("gauge", i)), StatName(), {},
+                                     Gauge::ImportMode::Accumulate));
+    text_readouts.push_back(
+        alloc.makeTextReadout(makeStat(absl::StrCat("text", i)), StatName(), {}));
+  }
+  for (uint32_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(counters[i].get(),
+              alloc.makeCounter(makeStat(absl::StrCat("counter", i)), StatName(), {}).get());
+    GaugeSharedPtr gauge = alloc.makeGauge(makeStat(absl::StrCat("gauge", i)), StatName(), {},
+                                           Gauge::ImportMode::Accumulate);
+    EXPECT_EQ(gauges[i].get(), gauge.get());
+    EXPECT_EQ(text_readouts[i].get(),
+              alloc.makeTextReadout(makeStat(absl::StrCat("text", i)), StatName(), {}).get());
+    EXPECT_EQ(1, counters[i]->use_count());
+    EXPECT_EQ(2, gauges[i]->use_count());
+  }
+  EXPECT_FALSE(alloc.isMutexLockedForTest());
+  counters.clear();
+  gauges.clear();
+  text_readouts.clear();
+
+  // Freed stats are allocated afresh.
+  CounterSharedPtr counter = alloc.makeCounter(makeStat("counter0"), StatName(), {});
+  EXPECT_EQ(0, counter->value());
+}
+
+// The same race as RefCountDecAllocRaceOrganic, with many names spread over
+// several shards.
+TEST_F(AllocatorImplTest, ShardedRefCountDecAllocRace) {
+  AllocatorImpl alloc(symbol_table_, 4);
+  std::vector<StatName> names;
+  for (uint32_t i = 0; i < 16; ++i) {
+    names.push_back(makeStat(absl::StrCat("counter", i)));
+  }
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+
+  const uint32_t num_threads = 8;
+  const uint32_t iters = 1000;
+  std::vector<Thread::ThreadPtr> threads;
+  absl::Notification go;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory.createThread([&]() {
+      go.WaitForNotification();
+      for (uint32_t i = 0; i < iters; ++i) {
+        alloc.makeCounter(names[i % names.size()], StatName(), {})->inc();
+      }
+    }));
+  }
+  go.Notify();
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads[i]->join();
+  }
+}
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
@@ -0,0 +1,111 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares the per-worker histogram backends of ThreadLocalStoreImpl: recording a value on a
+// worker, and merging the workers' histograms on the main thread during a stats flush.
+
+#include <memory>
+#include <vector>
+
+#include "common/common/c_smart_ptr.h"
+#include "common/stats/fixed_bucket_histogram.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+using HistogramPtr = CSmartPtr<histogram_t, hist_free>;
+
+// Latency-like values spread over several orders of magnitude.
+std::vector<uint64_t> sampleValues() {
+  std::vector<uint64_t> values;
+  for (uint64_t i = 0; i < 1000; ++i) {
+    values.push_back((i * 7919) % 100000);
+  }
+  return values;
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_CircllhistRecord(benchmark::State& state) {
+  const std::vector<uint64_t> values = sampleValues();
+  HistogramPtr histogram(hist_alloc());
+  size_t i = 0;
+  for (auto _ : state) { // NOLINT
+    hist_insert_intscale(histogram.get(), values[i++ % values.size()], 0, 1);
+  }
+}
+BENCHMARK(BM_CircllhistRecord);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_FixedBucketsRecord(benchmark::State& state) {
+  const std::vector<uint64_t> values = sampleValues();
+  auto histogram = std::make_unique<FixedBucketHistogram>();
+  size_t i = 0;
+  for (auto _ : state) { // NOLINT
+    histogram->recordValue(values[i++ % values.size()]);
+  }
+}
+BENCHMARK(BM_FixedBucketsRecord);
+
+// Merge cost for one flush of a histogram recorded on state.range(0) workers, each of which
+// recorded state.range(1) values during the interval.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_CircllhistMerge(benchmark::State& state) {
+  const std::vector<uint64_t> values = sampleValues();
+  std::vector<HistogramPtr> workers;
+  for (int64_t w = 0; w < state.range(0); ++w) {
+    workers.emplace_back(hist_alloc());
+  }
+  HistogramPtr interval(hist_alloc());
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    for (auto& worker : workers) {
+      for (int64_t i = 0; i < state.range(1); ++i) {
+        hist_insert_intscale(worker.get(), values[i % values.size()], 0, 1);
+      }
+    }
+    state.ResumeTiming();
+
+    hist_clear(interval.get());
+    for (auto& worker : workers) {
+      histogram_t* worker_histogram = worker.get();
+      hist_accumulate(interval.get(), &worker_histogram, 1);
+      hist_clear(worker_histogram);
+    }
+  }
+}
+BENCHMARK(BM_CircllhistMerge)->Ranges({{1, 32}, {10, 10000}});
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_FixedBucketsMerge(benchmark::State& state) {
+  const std::vector<uint64_t> values = sampleValues();
+  std::vector<std::unique_ptr<FixedBucketHistogram>> workers;
+  for (int64_t w = 0; w < state.range(0); ++w) {
+    workers.push_back(std::make_unique<FixedBucketHistogram>());
+  }
+  HistogramPtr interval(hist_alloc());
+  auto totals = std::make_unique<FixedBucketHistogram::Counts>();
+  totals->fill(0);
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    for (auto& worker : workers) {
+      for (int64_t i = 0; i < state.range(1); ++i) {
+        worker->recordValue(values[i % values.size()]);
+      }
+    }
+    state.ResumeTiming();
+
+    hist_clear(interval.get());
+    for (auto& worker : workers) {
+      worker->collect(*totals);
+    }
+    FixedBucketHistogram::insertInto(*totals, interval.get());
+  }
+}
+BENCHMARK(BM_FixedBucketsMerge)->Ranges({{1, 32}, {10, 10000}});
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,81 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "common/common/c_smart_ptr.h"
+#include "common/stats/fixed_bucket_histogram.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+using HistogramPtr = CSmartPtr<histogram_t, hist_free>;
+
+TEST(FixedBucketHistogramTest, SmallValuesAreExact) {
+  for (uint64_t value = 0; value < 2 * FixedBucketHistogram::SubBuckets; ++value) {
+    const uint32_t index = FixedBucketHistogram::bucketIndex(value);
+    EXPECT_EQ(value, index);
+    EXPECT_EQ(value, FixedBucketHistogram::bucketLowerBound(index));
+    EXPECT_EQ(value, FixedBucketHistogram::bucketMidpoint(index));
+  }
+}
+
+TEST(FixedBucketHistogramTest, BucketBoundaries) {
+  for (uint32_t index = 0; index < FixedBucketHistogram::NumBuckets; ++index) {
+    const uint64_t lower = FixedBucketHistogram::bucketLowerBound(index);
+    EXPECT_EQ(index, FixedBucketHistogram::bucketIndex(lower));
+    const uint64_t midpoint = FixedBucketHistogram::bucketMidpoint(index);
+    EXPECT_EQ(index, FixedBucketHistogram::bucketIndex(midpoint));
+    if (index > 0) {
+      EXPECT_EQ(index - 1, FixedBucketHistogram::bucketIndex(lower - 1));
+    }
+  }
+}
+
+TEST(FixedBucketHistogramTest, RelativeError) {
+  for (uint64_t value : {100UL, 1000UL, 12345UL, 999999UL, 123456789UL, 1UL << 39}) {
+    const uint64_t midpoint =
+        FixedBucketHistogram::bucketMidpoint(FixedBucketHistogram::bucketIndex(value));
+    const double error = std::abs(static_cast<double>(midpoint) - value) / value;
+    EXPECT_LE(error, 1.0 / FixedBucketHistogram::SubBuckets) << value;
+  }
+}
+
+TEST(FixedBucketHistogramTest, LargeValuesAreClamped) {
+  const uint32_t last = FixedBucketHistogram::NumBuckets - 1;
+  EXPECT_EQ(last, FixedBucketHistogram::bucketIndex((uint64_t(1) << 40) - 1));
+  EXPECT_EQ(last, FixedBucketHistogram::bucketIndex(uint64_t(1) << 40));
+  EXPECT_EQ(last, FixedBucketHistogram::bucketIndex(std::numeric_limits<uint64_t>::max()));
+}
+
+TEST(FixedBucketHistogramTest, CollectReturnsIntervalCounts) {
+  FixedBucketHistogram histogram;
+  FixedBucketHistogram::Counts totals;
+  totals.fill(0);
+
+  histogram.recordValue(1);
+  histogram.recordValue(1);
+  histogram.recordValue(1000);
+  histogram.collect(totals);
+  EXPECT_EQ(2, totals[FixedBucketHistogram::bucketIndex(1)]);
+  EXPECT_EQ(1, totals[FixedBucketHistogram::bucketIndex(1000)]);
+
+  // A second collection adds only what was recorded in between.
+  histogram.recordValue(1);
+  histogram.collect(totals);
+  EXPECT_EQ(3, totals[FixedBucketHistogram::bucketIndex(1)]);
+  EXPECT_EQ(1, totals[FixedBucketHistogram::bucketIndex(1000)]);
+
+  HistogramPtr target(hist_alloc());
+  FixedBucketHistogram::insertInto(totals, target.get());
+  EXPECT_EQ(4, hist_sample_count(target.get()));
+  for (const uint64_t count : totals) {
+    EXPECT_EQ(0, count);
+  }
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
@@ -1263,6 +1263,31 @@ TEST_F(HistogramTest, BasicSingleHistogramMerge) {
   EXPECT_EQ(1, validateMerge());
 }
 
+// With the fixed buckets backend, values below 32 are recorded exactly, so the merged statistics
+// must match those of a circllhist built from the same values.
+TEST_F(HistogramTest, FixedBucketsBackendMerge) {
+  envoy::config::metrics::v3::StatsConfig stats_config;
+  stats_config.set_histogram_backend(envoy::config::metrics::v3::StatsConfig::FIXED_BUCKETS);
+  store_->setHistogramSettings(std::make_unique<HistogramSettingsImpl>(stats_config));
+
+  Histogram& h1 = store_->histogramFromString("h1", Stats::Histogram::Unit::Unspecified);
+  Histogram& h2 = store_->histogramFromString("h2", Stats::Histogram::Unit::Unspecified);
+
+  expectCallAndAccumulate(h1, 0);
+  expectCallAndAccumulate(h1, 3);
+  expectCallAndAccumulate(h1, 3);
+  expectCallAndAccumulate(h1, 17);
+  expectCallAndAccumulate(h2, 31);
+  EXPECT_EQ(2, validateMerge());
+
+  // Only values recorded since the previous merge show up in the interval statistics.
+  expectCallAndAccumulate(h1, 5);
+  expectCallAndAccumulate(h2, 1);
+  EXPECT_EQ(2, validateMerge());
+
+  EXPECT_EQ(2, validateMerge());
+}
+
 TEST_F(HistogramTest, BasicMultiHistogramMerge) {
   Histogram& h1 = store_->histogramFromString("h1", Stats::Histogram::Unit::Unspecified);
   Histogram& h2 = store_->histogramFromString("h2", Stats::Histogram::Unit::Unspecified);
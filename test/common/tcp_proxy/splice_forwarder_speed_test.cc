@@ -0,0 +1,107 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares proxying a stream between two sockets through a user space buffer, as the TCP proxy
+// does with raw buffer sockets, against moving it in the kernel with a SpliceForwarder. Both
+// sides use Unix domain socket pairs, so absolute numbers differ from TCP connections.
+
+#include <memory>
+#include <string>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/buffer/buffer_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/tcp_proxy/splice_forwarder.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace TcpProxy {
+namespace {
+
+struct SocketPair {
+  SocketPair() {
+    os_fd_t fds[2];
+    RELEASE_ASSERT(
+        Api::OsSysCallsSingleton::get().socketpair(AF_UNIX, SOCK_STREAM, 0, fds).rc_ == 0, "");
+    proxy_ = std::make_unique<Network::IoSocketHandleImpl>(fds[0]);
+    peer_ = std::make_unique<Network::IoSocketHandleImpl>(fds[1]);
+    proxy_->setBlocking(false);
+    peer_->setBlocking(false);
+  }
+
+  Network::IoHandlePtr proxy_;
+  Network::IoHandlePtr peer_;
+};
+
+class NoopCallbacks : public SpliceForwarder::Callbacks {
+public:
+  void onSplicedBytes(bool, uint64_t) override {}
+  void onSpliceComplete(bool) override {}
+};
+
+// Sends size bytes from the downstream peer and reads them on the upstream peer, calling forward
+// to move data between the proxy ends whenever the sockets are full or empty.
+template <class Forward>
+void transfer(SocketPair& downstream, SocketPair& upstream, const std::string& data,
+              Forward forward) {
+  Buffer::OwnedImpl source(data);
+  Buffer::OwnedImpl sink;
+  uint64_t received = 0;
+  while (received < data.size()) {
+    if (source.length() > 0) {
+      downstream.peer_->write(source);
+    }
+    forward();
+    const Api::IoCallUint64Result result = upstream.peer_->read(sink, data.size() - received);
+    if (result.ok()) {
+      received += result.rc_;
+    }
+    sink.drain(sink.length());
+  }
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_BufferedProxy(benchmark::State& state) {
+  SocketPair downstream;
+  SocketPair upstream;
+  const std::string data(state.range(0), 'a');
+  Buffer::OwnedImpl buffer;
+  for (auto _ : state) { // NOLINT
+    transfer(downstream, upstream, data, [&]() {
+      downstream.proxy_->read(buffer, SpliceForwarder::ChunkSize);
+      if (buffer.length() > 0) {
+        upstream.proxy_->write(buffer);
+      }
+    });
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_BufferedProxy)->Range(4 * 1024, 16 * 1024 * 1024);
+
+#if defined(__linux__)
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_SplicedProxy(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  SocketPair downstream;
+  SocketPair upstream;
+  NoopCallbacks callbacks;
+  SpliceForwarderPtr forwarder =
+      SpliceForwarder::create(*dispatcher, *downstream.proxy_, *upstream.proxy_, callbacks);
+  RELEASE_ASSERT(forwarder != nullptr, "");
+  const std::string data(state.range(0), 'a');
+  for (auto _ : state) { // NOLINT
+    transfer(downstream, upstream, data,
+             [&]() { dispatcher->run(Event::Dispatcher::RunType::NonBlock); });
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_SplicedProxy)->Range(4 * 1024, 16 * 1024 * 1024);
+#endif
+
+} // namespace
+} // namespace TcpProxy
+} // namespace Envoy
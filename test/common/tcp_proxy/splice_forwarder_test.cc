@@ -0,0 +1,160 @@
+#include <memory>
+#include <string>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/buffer/buffer_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/tcp_proxy/splice_forwarder.h"
+
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace TcpProxy {
+namespace {
+
+using testing::_;
+using testing::Invoke;
+
+class MockSpliceCallbacks : public SpliceForwarder::Callbacks {
+public:
+  MOCK_METHOD(void, onSplicedBytes, (bool downstream_to_upstream, uint64_t bytes));
+  MOCK_METHOD(void, onSpliceComplete, (bool error));
+};
+
+// A connected pair of sockets: the proxy's end, which is handed to the forwarder, and the peer's.
+struct SocketPair {
+  SocketPair() {
+    os_fd_t fds[2];
+    RELEASE_ASSERT(
+        Api::OsSysCallsSingleton::get().socketpair(AF_UNIX, SOCK_STREAM, 0, fds).rc_ == 0, "");
+    proxy_ = std::make_unique<Network::IoSocketHandleImpl>(fds[0]);
+    peer_ = std::make_unique<Network::IoSocketHandleImpl>(fds[1]);
+    proxy_->setBlocking(false);
+    peer_->setBlocking(false);
+  }
+
+  Network::IoHandlePtr proxy_;
+  Network::IoHandlePtr peer_;
+};
+
+class SpliceForwarderTest : public testing::Test {
+protected:
+  SpliceForwarderTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")) {}
+
+  void write(Network::IoHandle& handle, absl::string_view data) {
+    Buffer::OwnedImpl buffer(data);
+    EXPECT_TRUE(handle.write(buffer).ok());
+  }
+
+  // Runs the event loop until the peer has read the expected data, and returns what it read.
+  std::string readUntil(Network::IoHandle& handle, uint64_t length) {
+    Buffer::OwnedImpl buffer;
+    for (uint32_t i = 0; i < 1000 && buffer.length() < length; ++i) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+      handle.read(buffer, length - buffer.length());
+    }
+    return buffer.toString();
+  }
+
+  // Runs the event loop until the peer reads end of stream.
+  bool readEndStream(Network::IoHandle& handle) {
+    for (uint32_t i = 0; i < 1000; ++i) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+      Buffer::OwnedImpl buffer;
+      Api::IoCallUint64Result result = handle.read(buffer, 1);
+      if (result.ok() && result.rc_ == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  SocketPair downstream_;
+  SocketPair upstream_;
+  MockSpliceCallbacks callbacks_;
+};
+
+#if defined(__linux__)
+
+TEST_F(SpliceForwarderTest, ForwardsBothDirections) {
+  SpliceForwarderPtr forwarder =
+      SpliceForwarder::create(*dispatcher_, *downstream_.proxy_, *upstream_.proxy_, callbacks_);
+  ASSERT_NE(nullptr, forwarder);
+
+  uint64_t to_upstream = 0;
+  uint64_t to_downstream = 0;
+  EXPECT_CALL(callbacks_, onSplicedBytes(_, _))
+      .WillRepeatedly(Invoke([&](bool downstream_to_upstream, uint64_t bytes) {
+        (downstream_to_upstream ? to_upstream : to_downstream) += bytes;
+      }));
+
+  write(*downstream_.peer_, "hello");
+  EXPECT_EQ("hello", readUntil(*upstream_.peer_, 5));
+  EXPECT_EQ(5, to_upstream);
+
+  const std::string large(3 * SpliceForwarder::ChunkSize + 1, 'a');
+  write(*upstream_.peer_, large);
+  EXPECT_EQ(large, readUntil(*downstream_.peer_, large.size()));
+  EXPECT_EQ(large.size(), to_downstream);
+
+  // Half close from the downstream is propagated upstream, while data still flows back.
+  downstream_.peer_->shutdown(ENVOY_SHUT_WR);
+  EXPECT_TRUE(readEndStream(*upstream_.peer_));
+  write(*upstream_.peer_, "bye");
+  EXPECT_EQ("bye", readUntil(*downstream_.peer_, 3));
+
+  EXPECT_CALL(callbacks_, onSpliceComplete(false)).WillOnce(Invoke([&](bool) {
+    forwarder.reset();
+  }));
+  upstream_.peer_->shutdown(ENVOY_SHUT_WR);
+  EXPECT_TRUE(readEndStream(*downstream_.peer_));
+  EXPECT_EQ(nullptr, forwarder);
+}
+
+TEST_F(SpliceForwarderTest, DataBeforeCreation) {
+  write(*downstream_.peer_, "early");
+  SpliceForwarderPtr forwarder =
+      SpliceForwarder::create(*dispatcher_, *downstream_.proxy_, *upstream_.proxy_, callbacks_);
+  ASSERT_NE(nullptr, forwarder);
+
+  EXPECT_CALL(callbacks_, onSplicedBytes(true, 5));
+  EXPECT_EQ("early", readUntil(*upstream_.peer_, 5));
+}
+
+TEST_F(SpliceForwarderTest, PeerReset) {
+  SpliceForwarderPtr forwarder =
+      SpliceForwarder::create(*dispatcher_, *downstream_.proxy_, *upstream_.proxy_, callbacks_);
+  ASSERT_NE(nullptr, forwarder);
+
+  // Data can no longer be delivered once the upstream peer is gone.
+  upstream_.peer_->close();
+  bool complete = false;
+  EXPECT_CALL(callbacks_, onSpliceComplete(true)).WillOnce(Invoke([&](bool) {
+    complete = true;
+    forwarder.reset();
+  }));
+  write(*downstream_.peer_, "lost");
+  for (uint32_t i = 0; i < 1000 && !complete; ++i) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_TRUE(complete);
+}
+
+#else
+
+TEST_F(SpliceForwarderTest, Unsupported) {
+  EXPECT_EQ(nullptr, SpliceForwarder::create(*dispatcher_, *downstream_.proxy_, *upstream_.proxy_,
+                                             callbacks_));
+}
+
+#endif
+
+} // namespace
+} // namespace TcpProxy
+} // namespace Envoy
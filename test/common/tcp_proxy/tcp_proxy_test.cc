@@ -25,6 +25,8 @@
 
 #include "test/common/upstream/utility.h"
 #include "test/mocks/buffer/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/io_handle.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/server/factory_context.h"
@@ -1058,6 +1060,52 @@ TEST_F(TcpProxyTest, HalfCloseProxy) {
   upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
 }
 
+// With use_splice, the connections' sockets are handed to a SpliceForwarder once the upstream
+// connection is established.
+TEST_F(TcpProxyTest, Splice) {
+  envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy config = defaultConfig();
+  config.set_use_splice(true);
+  setup(1, config);
+
+  NiceMock<Network::MockIoHandle> downstream_handle;
+  NiceMock<Network::MockIoHandle> upstream_handle;
+  EXPECT_CALL(filter_callbacks_.connection_, spliceableIoHandle())
+      .WillOnce(Return(&downstream_handle));
+  EXPECT_CALL(*upstream_connections_.at(0), spliceableIoHandle())
+      .WillOnce(Return(&upstream_handle));
+#if defined(__linux__)
+  EXPECT_CALL(filter_callbacks_.connection_.dispatcher_, createFileEvent_(_, _, _, _))
+      .Times(2)
+      .WillRepeatedly(InvokeWithoutArgs([]() { return new NiceMock<Event::MockFileEvent>(); }));
+  EXPECT_CALL(filter_callbacks_.connection_, readDisable(true));
+  EXPECT_CALL(*upstream_connections_.at(0), readDisable(true));
+#endif
+  raiseEventUpstreamConnected(0);
+
+#if defined(__linux__)
+  EXPECT_EQ(1, config_->stats().downstream_cx_splice_total_.value());
+#else
+  EXPECT_EQ(0, config_->stats().downstream_cx_splice_total_.value());
+#endif
+}
+
+// Connections that cannot hand over their sockets, e.g. because they use TLS, are proxied through
+// buffers even with use_splice.
+TEST_F(TcpProxyTest, SpliceUnsupported) {
+  envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy config = defaultConfig();
+  config.set_use_splice(true);
+  setup(1, config);
+
+  EXPECT_CALL(filter_callbacks_.connection_, spliceableIoHandle()).WillOnce(Return(nullptr));
+  EXPECT_CALL(filter_callbacks_.connection_.dispatcher_, createFileEvent_(_, _, _, _)).Times(0);
+  raiseEventUpstreamConnected(0);
+  EXPECT_EQ(0, config_->stats().downstream_cx_splice_total_.value());
+
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(*upstream_connections_.at(0), write(BufferEqual(&buffer), false));
+  filter_->onData(buffer, false);
+}
+
 // Test with an explicitly configured upstream.
 TEST_F(TcpProxyTest, ExplicitFactory) {
   // Explicitly configure an HTTP upstream, to test factory creation.
@@ -0,0 +1,119 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+
+#include "common/common/random_generator.h"
+#include "common/upstream/maglev_lb.h"
+#include "common/upstream/ring_hash_lb.h"
+#include "common/upstream/upstream_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+
+using ::benchmark::State;
+using Envoy::benchmark::skipExpensiveBenchmarks;
+
+namespace Envoy {
+namespace Upstream {
+
+// Measures how long a hashing load balancer takes to rebuild its tables when a single host is
+// added to or removed from a large priority, optionally next to a second, unchanged, priority of
+// the same size.
+class HashLbRebuildSpeedTest : public Event::TestUsingSimulatedTime {
+public:
+  HashLbRebuildSpeedTest(uint32_t num_hosts, bool second_priority) {
+    for (uint32_t i = 0; i < num_hosts; ++i) {
+      hosts_.push_back(makeTestHost(info_, fmt::format("tcp://10.0.{}.{}:80", i / 256, i % 256),
+                                    simTime()));
+    }
+    updateHosts(0, hosts_, {}, {});
+    if (second_priority) {
+      HostVector failover_hosts;
+      for (uint32_t i = 0; i < num_hosts; ++i) {
+        failover_hosts.push_back(makeTestHost(
+            info_, fmt::format("tcp://10.1.{}.{}:80", i / 256, i % 256), simTime()));
+      }
+      updateHosts(1, failover_hosts, {}, {});
+    }
+  }
+
+  void initialize(bool maglev) {
+    if (maglev) {
+      lb_ = std::make_unique<MaglevLoadBalancer>(priority_set_, stats_, stats_store_, runtime_,
+                                                 random_, maglev_config_, common_config_);
+    } else {
+      ring_hash_config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
+      ring_hash_config_.value().mutable_minimum_ring_size()->set_value(65536);
+      lb_ = std::make_unique<RingHashLoadBalancer>(priority_set_, stats_, stats_store_, runtime_,
+                                                   random_, ring_hash_config_, common_config_);
+    }
+    lb_->initialize();
+  }
+
+  // Removes the last host of priority 0 the first time, and adds it back the next one.
+  void toggleLastHost() {
+    if (removed_host_ == nullptr) {
+      removed_host_ = hosts_.back();
+      hosts_.pop_back();
+      updateHosts(0, hosts_, {}, {removed_host_});
+    } else {
+      hosts_.push_back(removed_host_);
+      updateHosts(0, hosts_, {removed_host_}, {});
+      removed_host_ = nullptr;
+    }
+  }
+
+private:
+  void updateHosts(uint32_t priority, const HostVector& hosts, const HostVector& added,
+                   const HostVector& removed) {
+    HostVectorConstSharedPtr updated_hosts = std::make_shared<HostVector>(hosts);
+    priority_set_.updateHosts(
+        priority, HostSetImpl::partitionHosts(updated_hosts, makeHostsPerLocality({hosts})), {},
+        added, removed, absl::nullopt);
+  }
+
+  Envoy::Thread::MutexBasicLockable lock_;
+  Envoy::Logger::Context logging_context_{spdlog::level::warn,
+                                          Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock_, false};
+
+  std::shared_ptr<MockClusterInfo> info_{new NiceMock<MockClusterInfo>()};
+  PrioritySetImpl priority_set_;
+  Stats::IsolatedStoreImpl stats_store_;
+  ClusterStatNames stat_names_{stats_store_.symbolTable()};
+  ClusterStats stats_{ClusterInfoImpl::generateStats(stats_store_, stat_names_)};
+  NiceMock<Runtime::MockLoader> runtime_;
+  Random::RandomGeneratorImpl random_;
+  envoy::config::cluster::v3::Cluster::CommonLbConfig common_config_;
+  absl::optional<envoy::config::cluster::v3::Cluster::MaglevLbConfig> maglev_config_;
+  absl::optional<envoy::config::cluster::v3::Cluster::RingHashLbConfig> ring_hash_config_;
+  std::unique_ptr<ThreadAwareLoadBalancerBase> lb_;
+  HostVector hosts_;
+  HostSharedPtr removed_host_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
+
+// The first argument selects Maglev (1) or RingHash (0), the second one the number of hosts per
+// priority, and the third one whether there is a second priority which isn't updated.
+static void hostAddedOrRemoved(State& state) {
+  const uint32_t num_hosts = skipExpensiveBenchmarks() ? 100 : state.range(1);
+  Envoy::Upstream::HashLbRebuildSpeedTest speed_test(num_hosts, state.range(2));
+  speed_test.initialize(state.range(0));
+
+  for (auto _ : state) {
+    speed_test.toggleLastHost();
+  }
+}
+
+BENCHMARK(hostAddedOrRemoved)
+    ->Ranges({{false, true}, {500, 5000}, {false, true}})
+    ->Unit(benchmark::kMillisecond);
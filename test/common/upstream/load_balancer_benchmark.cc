@@ -1,6 +1,9 @@
 // Usage: bazel run //test/common/upstream:load_balancer_benchmark
 
+#include <cmath>
+#include <deque>
 #include <memory>
+#include <random>
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
 
@@ -147,9 +150,19 @@ BENCHMARK(benchmarkRoundRobinLoadBalancerBuild)
     ->Args({50000, 100, 50})
     ->Unit(::benchmark::kMillisecond);
 
+void setHashBalanceFactor(envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config,
+                          uint32_t hash_balance_factor) {
+  if (hash_balance_factor > 0) {
+    common_config.mutable_consistent_hashing_lb_config()->mutable_hash_balance_factor()->set_value(
+        hash_balance_factor);
+  }
+}
+
 class RingHashTester : public BaseTester {
 public:
-  RingHashTester(uint64_t num_hosts, uint64_t min_ring_size) : BaseTester(num_hosts) {
+  RingHashTester(uint64_t num_hosts, uint64_t min_ring_size, uint32_t hash_balance_factor = 0)
+      : BaseTester(num_hosts) {
+    setHashBalanceFactor(common_config_, hash_balance_factor);
     config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
     config_.value().mutable_minimum_ring_size()->set_value(min_ring_size);
     ring_hash_lb_ = std::make_unique<RingHashLoadBalancer>(
@@ -162,8 +175,10 @@ public:
 
 class MaglevTester : public BaseTester {
 public:
-  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0)
+  MaglevTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0,
+               uint32_t hash_balance_factor = 0)
       : BaseTester(num_hosts, weighted_subset_percent, weight) {
+    setHashBalanceFactor(common_config_, hash_balance_factor);
     maglev_lb_ = std::make_unique<MaglevLoadBalancer>(priority_set_, stats_, stats_store_, runtime_,
                                                       random_, config_, common_config_);
   }
@@ -299,6 +314,31 @@ BENCHMARK(benchmarkLeastRequestLoadBalancerChooseHost)
     ->Args({100, 100, 1000000})
     ->Unit(::benchmark::kMillisecond);
 
+// Picks hosts from a large cluster whose hosts have different numbers of active requests, as
+// they would under load. The cost is dominated by the memory accesses needed to read the active
+// requests of the sampled hosts, which are scattered across the heap.
+void benchmarkLeastRequestLoadBalancerChooseHostLargeCluster(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t choice_count = state.range(1);
+  LeastRequestTester tester(num_hosts, choice_count);
+  const HostVector& hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+  for (uint64_t i = 0; i < hosts.size(); ++i) {
+    hosts[i]->stats().rq_active_.set(hashInt(i) % 100);
+  }
+  TestLoadBalancerContext context;
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    ::benchmark::DoNotOptimize(tester.lb_->chooseHost(&context));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(benchmarkLeastRequestLoadBalancerChooseHostLargeCluster)
+    ->Args({100, 2})
+    ->Args({10000, 2})
+    ->Args({10000, 3})
+    ->Args({10000, 10})
+    ->Args({10000, 50});
+
 void benchmarkRingHashLoadBalancerChooseHost(::benchmark::State& state) {
   for (auto _ : state) { // NOLINT: Silences warning about dead store
     // Do not time the creation of the ring.
@@ -371,6 +411,88 @@ BENCHMARK(benchmarkMaglevLoadBalancerChooseHost)
     ->Args({500, 100000})
     ->Unit(::benchmark::kMillisecond);
 
+// Requests for keys drawn from a Zipf-like distribution, in which a few keys are much more popular
+// than the others, with a fixed number of requests in flight: each request completes when the
+// InFlightRequests next ones have started. Reports the highest number of requests any host had in
+// flight, relative to the mean, which bounded loads keep close to the hash balance factor.
+// Called with the timing paused, which it resumes once the keys are drawn.
+void benchmarkSkewedKeys(::benchmark::State& state, LoadBalancer& lb, ClusterStats& cluster_stats,
+                         uint64_t num_hosts) {
+  constexpr uint64_t Keys = 10000;
+  constexpr uint64_t Requests = 100000;
+  constexpr uint64_t InFlightRequests = 1000;
+  std::mt19937_64 random(0);
+  std::uniform_real_distribution<double> uniform(0, 1);
+  std::vector<uint64_t> hashes(Requests);
+  for (uint64_t& hash : hashes) {
+    hash = hashInt(static_cast<uint64_t>(std::pow(Keys, uniform(random))));
+  }
+
+  std::deque<HostConstSharedPtr> in_flight;
+  uint64_t max_host_active = 0;
+  TestLoadBalancerContext context;
+  state.ResumeTiming();
+
+  for (uint64_t hash : hashes) {
+    context.hash_key_ = hash;
+    HostConstSharedPtr host = lb.chooseHost(&context);
+    host->stats().rq_active_.inc();
+    cluster_stats.upstream_rq_active_.inc();
+    max_host_active = std::max(max_host_active, host->stats().rq_active_.value());
+    in_flight.push_back(std::move(host));
+    if (in_flight.size() > InFlightRequests) {
+      in_flight.front()->stats().rq_active_.dec();
+      cluster_stats.upstream_rq_active_.dec();
+      in_flight.pop_front();
+    }
+  }
+
+  state.PauseTiming();
+  for (const HostConstSharedPtr& host : in_flight) {
+    host->stats().rq_active_.dec();
+    cluster_stats.upstream_rq_active_.dec();
+  }
+  state.counters["max_load"] =
+      static_cast<double>(max_host_active) / (static_cast<double>(InFlightRequests) / num_hosts);
+  state.ResumeTiming();
+}
+
+void benchmarkRingHashLoadBalancerSkewedKeys(::benchmark::State& state) {
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    const uint64_t num_hosts = 100;
+    RingHashTester tester(num_hosts, 65536, state.range(0));
+    tester.ring_hash_lb_->initialize();
+    LoadBalancerPtr lb = tester.ring_hash_lb_->factory()->create();
+
+    benchmarkSkewedKeys(state, *lb, tester.info_->stats_, num_hosts);
+  }
+}
+BENCHMARK(benchmarkRingHashLoadBalancerSkewedKeys)
+    ->Arg(0)
+    ->Arg(125)
+    ->Arg(150)
+    ->Arg(200)
+    ->Unit(::benchmark::kMillisecond);
+
+void benchmarkMaglevLoadBalancerSkewedKeys(::benchmark::State& state) {
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    const uint64_t num_hosts = 100;
+    MaglevTester tester(num_hosts, 0, 0, state.range(0));
+    tester.maglev_lb_->initialize();
+    LoadBalancerPtr lb = tester.maglev_lb_->factory()->create();
+
+    benchmarkSkewedKeys(state, *lb, tester.info_->stats_, num_hosts);
+  }
+}
+BENCHMARK(benchmarkMaglevLoadBalancerSkewedKeys)
+    ->Arg(0)
+    ->Arg(125)
+    ->Arg(150)
+    ->Arg(200)
+    ->Unit(::benchmark::kMillisecond);
+
 void benchmarkRingHashLoadBalancerHostLoss(::benchmark::State& state) {
   const uint64_t num_hosts = state.range(0);
   const uint64_t min_ring_size = state.range(1);
@@ -130,6 +130,86 @@ TEST_F(MaglevLoadBalancerTest, Basic) {
   }
 }
 
+// With a hash balance factor, requests for a key go to another host while the one it hashes to
+// is overloaded, and back to it once it isn't anymore.
+TEST_F(MaglevLoadBalancerTest, BoundedLoad) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:91", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:92", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:93", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:94", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:95", simTime())};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  common_config_.mutable_consistent_hashing_lb_config()->mutable_hash_balance_factor()->set_value(
+      150);
+  init(7);
+
+  LoadBalancerPtr lb = lb_->factory()->create();
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(host_set_.hosts_[2], lb->chooseHost(&context));
+
+  // 6 active requests, all on :92, which can have at most ceil(1.5 * 7 / 6) = 2 of them.
+  info_->stats_.upstream_rq_active_.set(6);
+  host_set_.hosts_[2]->stats().rq_active_.set(6);
+  const HostConstSharedPtr host = lb->chooseHost(&context);
+  EXPECT_NE(host_set_.hosts_[2], host);
+  EXPECT_EQ(host, lb->chooseHost(&context));
+
+  host_set_.hosts_[2]->stats().rq_active_.set(2);
+  EXPECT_EQ(host_set_.hosts_[2], lb->chooseHost(&context));
+}
+
+// Only the tables of priorities whose hosts changed are rebuilt on update. The entry stats are
+// aggregated across the tables of all the priorities, including the ones which weren't rebuilt.
+TEST_F(MaglevLoadBalancerTest, OnlyChangedPrioritiesRebuilt) {
+  MockHostSet& failover_host_set = *priority_set_.getMockHostSet(1);
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:91", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:92", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:93", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:94", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:95", simTime())};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  failover_host_set.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:96", simTime())};
+  failover_host_set.healthy_hosts_ = failover_host_set.hosts_;
+  init(7);
+  EXPECT_EQ(1, lb_->stats().min_entries_per_host_.value());
+  EXPECT_EQ(7, lb_->stats().max_entries_per_host_.value());
+
+  // Removing a host from priority 0 rebuilds its table, and the stats still account for the table
+  // of priority 1.
+  lb_->stats().min_entries_per_host_.set(0);
+  lb_->stats().max_entries_per_host_.set(0);
+  const HostSharedPtr removed = host_set_.hosts_.back();
+  host_set_.hosts_.pop_back();
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {removed});
+  EXPECT_EQ(1, lb_->stats().min_entries_per_host_.value());
+  EXPECT_EQ(7, lb_->stats().max_entries_per_host_.value());
+
+  // An update which doesn't change the weights of any priority doesn't rebuild anything.
+  lb_->stats().min_entries_per_host_.set(0);
+  lb_->stats().max_entries_per_host_.set(0);
+  failover_host_set.runCallbacks({}, {});
+  EXPECT_EQ(0, lb_->stats().min_entries_per_host_.value());
+  EXPECT_EQ(0, lb_->stats().max_entries_per_host_.value());
+
+  // Priorities without hosts are left out of the stats.
+  const HostVector failover_hosts = failover_host_set.hosts_;
+  failover_host_set.hosts_.clear();
+  failover_host_set.healthy_hosts_.clear();
+  failover_host_set.runCallbacks({}, failover_hosts);
+  EXPECT_EQ(1, lb_->stats().min_entries_per_host_.value());
+  EXPECT_EQ(2, lb_->stats().max_entries_per_host_.value());
+
+  LoadBalancerPtr lb = lb_->factory()->create();
+  for (uint32_t i = 0; i < 7; ++i) {
+    TestLoadBalancerContext context(i);
+    EXPECT_NE(removed, lb->chooseHost(&context));
+  }
+}
+
 // Basic with hostname.
 TEST_F(MaglevLoadBalancerTest, BasicWithHostName) {
   host_set_.hosts_ = {makeTestHost(info_, "90", "tcp://127.0.0.1:90", simTime()),
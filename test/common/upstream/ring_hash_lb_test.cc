@@ -175,6 +175,39 @@ TEST_P(RingHashLoadBalancerTest, Basic) {
   EXPECT_EQ(1UL, stats_.lb_healthy_panic_.value());
 }
 
+// With a hash balance factor, requests for a key go to another host while the one it hashes to
+// is overloaded, and back to it once it isn't anymore.
+TEST_P(RingHashLoadBalancerTest, BoundedLoad) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:91", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:92", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:93", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:94", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:95", simTime())};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
+  config_.value().mutable_minimum_ring_size()->set_value(12);
+  common_config_.mutable_consistent_hashing_lb_config()->mutable_hash_balance_factor()->set_value(
+      150);
+
+  init();
+  LoadBalancerPtr lb = lb_->factory()->create();
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(hostSet().hosts_[4], lb->chooseHost(&context));
+
+  // 6 active requests, all on :94, which can have at most ceil(1.5 * 7 / 6) = 2 of them.
+  info_->stats_.upstream_rq_active_.set(6);
+  hostSet().hosts_[4]->stats().rq_active_.set(6);
+  const HostConstSharedPtr host = lb->chooseHost(&context);
+  EXPECT_NE(hostSet().hosts_[4], host);
+  EXPECT_EQ(host, lb->chooseHost(&context));
+
+  hostSet().hosts_[4]->stats().rq_active_.set(2);
+  EXPECT_EQ(hostSet().hosts_[4], lb->chooseHost(&context));
+}
+
 // Ensure if all the hosts with priority 0 unhealthy, the next priority hosts are used.
 TEST_P(RingHashFailoverTest, BasicFailover) {
   host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime())};
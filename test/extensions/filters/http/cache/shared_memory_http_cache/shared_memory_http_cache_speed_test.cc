@@ -0,0 +1,130 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/utility.h"
+
+#include "extensions/filters/http/cache/shared_memory_http_cache/shared_memory_http_cache.h"
+#include "extensions/filters/http/cache/simple_http_cache/simple_http_cache.h"
+
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+constexpr uint32_t SlotSize = 16 * 1024;
+constexpr uint64_t CacheSize = 16 * 1024 * 1024;
+constexpr size_t BodySize = 8 * 1024;
+
+class CacheBenchmark {
+public:
+  explicit CacheBenchmark(HttpCache& cache) : cache_(cache), body_(BodySize, 'a') {
+    request_headers_.setMethod("GET");
+    request_headers_.setHost("example.com");
+    request_headers_.setForwardedProto("https");
+    response_headers_ = Http::TestResponseHeaderMapImpl{
+        {":status", "200"},
+        {"date", formatter_.fromTime(time_source_.systemTime())},
+        {"cache-control", "public,max-age=3600"},
+        {"content-type", "text/html; charset=utf-8"},
+        {"etag", "\"0123456789abcdef\""},
+        {"last-modified", "Thu, 01 Jan 1970 00:00:00 GMT"},
+        {"server", "envoy"}};
+  }
+
+  // Look up a resource, and insert it on a miss like the cache filter would.
+  // Returns whether the lookup hit.
+  bool lookupOrInsert(uint64_t resource) {
+    request_headers_.setPath(absl::StrCat("/resource/", resource));
+    LookupContextPtr context = cache_.makeLookupContext(
+        LookupRequest(request_headers_, time_source_.systemTime(), vary_allow_list_));
+    bool hit = false;
+    context->getHeaders([&hit](LookupResult&& result) {
+      hit = result.cache_entry_status_ == CacheEntryStatus::Ok;
+    });
+    if (hit) {
+      context->getBody(AdjustedByteRange(0, BodySize), [](Buffer::InstancePtr&& body) {
+        benchmark::DoNotOptimize(body->length());
+      });
+      return true;
+    }
+    InsertContextPtr inserter = cache_.makeInsertContext(std::move(context));
+    inserter->insertHeaders(response_headers_, {time_source_.systemTime()}, false);
+    inserter->insertBody(Buffer::OwnedImpl(body_), nullptr, true);
+    return false;
+  }
+
+private:
+  HttpCache& cache_;
+  Event::SimulatedTimeSystem time_source_;
+  DateFormatter formatter_{"%a, %d %b %Y %H:%M:%S GMT"};
+  const VaryHeader vary_allow_list_{
+      Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>()};
+  Http::TestRequestHeaderMapImpl request_headers_;
+  Http::TestResponseHeaderMapImpl response_headers_;
+  const std::string body_;
+};
+
+// Resources drawn from a Zipf-like distribution, in which a few resources are much more popular
+// than the others, like in most web traffic.
+std::vector<uint64_t> resourceSequence(uint64_t resources) {
+  std::mt19937_64 random(0);
+  std::uniform_real_distribution<double> uniform(0, 1);
+  std::vector<uint64_t> sequence(64 * 1024);
+  for (uint64_t& resource : sequence) {
+    resource = static_cast<uint64_t>(std::pow(resources, uniform(random))) - 1;
+  }
+  return sequence;
+}
+
+// Lookup latency and hit rate with a working set which is the given percentage of the number of
+// responses the cache holds.
+void benchmarkHitRate(benchmark::State& state, HttpCache& cache) {
+  CacheBenchmark benchmark(cache);
+  const uint64_t capacity = SlabStore::slotCount(CacheSize, SlotSize);
+  const std::vector<uint64_t> sequence = resourceSequence(capacity * state.range(0) / 100);
+  // Warm the cache up.
+  for (uint64_t resource : sequence) {
+    benchmark.lookupOrInsert(resource);
+  }
+  size_t i = 0;
+  uint64_t hits = 0;
+  uint64_t lookups = 0;
+  for (auto _ : state) {
+    hits += benchmark.lookupOrInsert(sequence[i]);
+    ++lookups;
+    i = (i + 1) % sequence.size();
+  }
+  state.counters["hit_rate"] = static_cast<double>(hits) / lookups;
+}
+
+void sharedMemoryHttpCacheHitRate(benchmark::State& state) {
+  SharedMemoryHttpCache cache(SharedMemoryRegion::create("", CacheSize), SlotSize);
+  benchmarkHitRate(state, cache);
+}
+BENCHMARK(sharedMemoryHttpCacheHitRate)->Arg(50)->Arg(100)->Arg(200)->Arg(800);
+
+// SimpleHttpCache never evicts: this is the hit rate with unlimited memory.
+void simpleHttpCacheHitRate(benchmark::State& state) {
+  SimpleHttpCache cache;
+  benchmarkHitRate(state, cache);
+}
+BENCHMARK(simpleHttpCacheHitRate)->Arg(50)->Arg(100)->Arg(200)->Arg(800);
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
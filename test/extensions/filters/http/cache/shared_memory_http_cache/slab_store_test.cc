@@ -0,0 +1,270 @@
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "extensions/filters/http/cache/shared_memory_http_cache/slab_store.h"
+
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+class SlabStorePeer {
+public:
+  // Leave a slot as if the given process died while writing it.
+  static void claimSlot(SlabStore& store, uint64_t index, uint32_t pid) {
+    std::atomic<uint64_t>& sequence = store.slot(index).sequence_;
+    sequence.store(static_cast<uint64_t>(pid) << 32 |
+                   static_cast<uint32_t>(sequence.load() + 1));
+  }
+
+  // Leave the region as if the given process died while initializing it.
+  static void setInitializing(SlabStore& store, uint32_t pid) {
+    store.header_->state_.store(SlabStore::Initializing);
+    store.header_->initializer_.store(pid);
+  }
+};
+
+namespace {
+
+constexpr uint32_t SlotSize = 1024;
+
+// The pid of a process which exited.
+uint32_t deadPid() {
+  const pid_t pid = fork();
+  if (pid == 0) {
+    _exit(0);
+  }
+  EXPECT_EQ(pid, waitpid(pid, nullptr, 0));
+  return pid;
+}
+
+// Size of a region which holds the given number of sets of slots.
+uint64_t regionSize(uint64_t sets) {
+  return 2 * SlabStore::SlotAlignment + sets * (SlabStore::WaysPerSet * SlotSize + 1);
+}
+
+class SlabStoreTest : public testing::Test {
+protected:
+  SlabStoreTest()
+      : region_(SharedMemoryRegion::create("", regionSize(1))),
+        store_(region_->data(), region_->size(), SlotSize) {}
+
+  std::string lookup(uint64_t hash, absl::string_view key) {
+    std::string value;
+    return store_.lookup(hash, key, value) ? value : "<miss>";
+  }
+
+  SharedMemoryRegionPtr region_;
+  SlabStore store_;
+};
+
+TEST_F(SlabStoreTest, Layout) {
+  EXPECT_EQ(SlabStore::WaysPerSet, store_.slots());
+  EXPECT_EQ(4 * SlabStore::WaysPerSet, SlabStore::slotCount(regionSize(4), SlotSize));
+  EXPECT_THROW(SlabStore::slotCount(regionSize(1) - 1, SlotSize), EnvoyException);
+}
+
+TEST_F(SlabStoreTest, InsertLookup) {
+  EXPECT_EQ("<miss>", lookup(3, "key"));
+  EXPECT_TRUE(store_.insert(3, "key", "value"));
+  EXPECT_EQ("value", lookup(3, "key"));
+  EXPECT_TRUE(store_.insert(2, "empty", ""));
+  EXPECT_EQ("", lookup(2, "empty"));
+  // The hash which marks empty slots is usable too.
+  EXPECT_TRUE(store_.insert(0, "zero", "value"));
+  EXPECT_EQ("value", lookup(0, "zero"));
+  EXPECT_EQ(3, store_.entries());
+  EXPECT_EQ(22, store_.usedBytes());
+}
+
+TEST_F(SlabStoreTest, HashCollision) {
+  EXPECT_TRUE(store_.insert(1, "key", "value"));
+  EXPECT_EQ("<miss>", lookup(1, "other"));
+  EXPECT_EQ("<miss>", lookup(1, "kez"));
+}
+
+TEST_F(SlabStoreTest, Replace) {
+  EXPECT_TRUE(store_.insert(1, "key", "value"));
+  EXPECT_TRUE(store_.insert(1, "key", "longer value"));
+  EXPECT_EQ("longer value", lookup(1, "key"));
+  EXPECT_EQ(1, store_.entries());
+  EXPECT_EQ(15, store_.usedBytes());
+  EXPECT_EQ(0, store_.evictions());
+}
+
+TEST_F(SlabStoreTest, TooLarge) {
+  const std::string key = "key";
+  EXPECT_FALSE(store_.insert(1, key, std::string(store_.maxEntrySize() - key.size() + 1, 'a')));
+  EXPECT_TRUE(store_.insert(1, key, std::string(store_.maxEntrySize() - key.size(), 'a')));
+  EXPECT_EQ(store_.maxEntrySize(), store_.usedBytes());
+}
+
+TEST_F(SlabStoreTest, ClockEviction) {
+  for (uint64_t i = 0; i < SlabStore::WaysPerSet; ++i) {
+    EXPECT_TRUE(store_.insert(i + 1, absl::StrCat("key", i), "value"));
+  }
+  EXPECT_EQ(SlabStore::WaysPerSet, store_.entries());
+
+  // Referenced entries get a second chance: the first unreferenced entry is evicted.
+  for (uint64_t i = 0; i < 4; ++i) {
+    EXPECT_EQ("value", lookup(i + 1, absl::StrCat("key", i)));
+  }
+  EXPECT_TRUE(store_.insert(100, "new", "value"));
+  EXPECT_EQ("<miss>", lookup(5, "key4"));
+  for (uint64_t i = 0; i < 4; ++i) {
+    EXPECT_EQ("value", lookup(i + 1, absl::StrCat("key", i)));
+  }
+  EXPECT_EQ("value", lookup(100, "new"));
+  EXPECT_EQ(SlabStore::WaysPerSet, store_.entries());
+  EXPECT_EQ(1, store_.evictions());
+
+  // The hand moved on: the next unreferenced entry is evicted next.
+  EXPECT_TRUE(store_.insert(101, "newer", "value"));
+  EXPECT_EQ("<miss>", lookup(6, "key5"));
+  EXPECT_EQ(2, store_.evictions());
+}
+
+// A store created over a region which already holds one, e.g. by the next Envoy process after a
+// hot restart, finds the entries of the previous one.
+TEST_F(SlabStoreTest, Attach) {
+  EXPECT_TRUE(store_.insert(1, "key", "value"));
+  SlabStore attached(region_->data(), region_->size(), SlotSize);
+  EXPECT_EQ(1, attached.entries());
+  std::string value;
+  EXPECT_TRUE(attached.lookup(1, "key", value));
+  EXPECT_EQ("value", value);
+
+  EXPECT_FALSE(SlabStore::holdsOtherLayout(region_->data(), region_->size(), SlotSize));
+  EXPECT_TRUE(SlabStore::holdsOtherLayout(region_->data(), region_->size(), SlotSize / 2));
+  EXPECT_THROW(SlabStore(region_->data(), region_->size(), SlotSize / 2), EnvoyException);
+}
+
+// The slot a process was writing when it died is taken over by the next insertion into it, and
+// is meanwhile skipped by lookups.
+TEST_F(SlabStoreTest, TakeOverSlotOfDeadWriter) {
+  EXPECT_TRUE(store_.insert(1, "key", "value"));
+  SlabStorePeer::claimSlot(store_, 0, deadPid());
+  EXPECT_EQ("<miss>", lookup(1, "key"));
+
+  EXPECT_TRUE(store_.insert(1, "key", "other"));
+  EXPECT_EQ("other", lookup(1, "key"));
+  EXPECT_TRUE(store_.insert(1, "key", "value"));
+  EXPECT_EQ("value", lookup(1, "key"));
+}
+
+// Slots being written by live processes are left alone.
+TEST_F(SlabStoreTest, KeepSlotOfLiveWriter) {
+  EXPECT_TRUE(store_.insert(1, "key", "value"));
+  SlabStorePeer::claimSlot(store_, 0, getppid());
+  EXPECT_FALSE(store_.insert(1, "key", "value"));
+}
+
+// A store takes over the initialization of a region from a process which died meanwhile.
+TEST_F(SlabStoreTest, TakeOverInitialization) {
+  SlabStorePeer::setInitializing(store_, deadPid());
+  SlabStore attached(region_->data(), region_->size(), SlotSize);
+  EXPECT_EQ(0, attached.entries());
+
+  // The process died before recording its pid.
+  SlabStorePeer::setInitializing(store_, 0);
+  SlabStore attached_again(region_->data(), region_->size(), SlotSize);
+  EXPECT_EQ(0, attached_again.entries());
+}
+
+// Waiting for a live process to initialize the region is bounded.
+TEST_F(SlabStoreTest, InitializationTimeout) {
+  SlabStorePeer::setInitializing(store_, getppid());
+  EXPECT_THROW_WITH_REGEX(SlabStore(region_->data(), region_->size(), SlotSize), EnvoyException,
+                          "still being initialized");
+}
+
+TEST(SharedMemoryRegionTest, NamedRegionOutlivesMapping) {
+  const std::string name = absl::StrCat("/envoy_slab_store_test_", getpid());
+  {
+    SharedMemoryRegionPtr region = SharedMemoryRegion::create(name, regionSize(2));
+    SlabStore store(region->data(), region->size(), SlotSize);
+    EXPECT_TRUE(store.insert(1, "key", "value"));
+  }
+  {
+    SharedMemoryRegionPtr region = SharedMemoryRegion::create(name, regionSize(2));
+    SlabStore store(region->data(), region->size(), SlotSize);
+    std::string value;
+    EXPECT_TRUE(store.lookup(1, "key", value));
+    EXPECT_EQ("value", value);
+  }
+  ::shm_unlink(name.c_str());
+}
+
+// A named region of another size is replaced by an empty one, while the previous mapping keeps
+// its contents.
+TEST(SharedMemoryRegionTest, NamedRegionOfOtherSizeIsReplaced) {
+  const std::string name = absl::StrCat("/envoy_slab_store_test_", getpid());
+  SharedMemoryRegionPtr region = SharedMemoryRegion::create(name, regionSize(2));
+  SlabStore store(region->data(), region->size(), SlotSize);
+  EXPECT_TRUE(store.insert(1, "key", "value"));
+
+  SharedMemoryRegionPtr resized = SharedMemoryRegion::create(name, regionSize(3));
+  SlabStore resized_store(resized->data(), resized->size(), SlotSize);
+  EXPECT_EQ(0, resized_store.entries());
+  std::string value;
+  EXPECT_TRUE(store.lookup(1, "key", value));
+  EXPECT_EQ("value", value);
+
+  // Removing the region starts the next one afresh too.
+  EXPECT_TRUE(resized_store.insert(1, "key", "value"));
+  SharedMemoryRegion::remove(name);
+  SharedMemoryRegionPtr recreated = SharedMemoryRegion::create(name, regionSize(3));
+  EXPECT_EQ(0, SlabStore(recreated->data(), recreated->size(), SlotSize).entries());
+  SharedMemoryRegion::remove(name);
+}
+
+TEST(SharedMemoryRegionTest, InvalidName) {
+  EXPECT_THROW(SharedMemoryRegion::create("/invalid/name", regionSize(1)), EnvoyException);
+}
+
+// Readers never see an entry which is being written: each value is made of a single repeated
+// character, and its length changes with every write.
+TEST_F(SlabStoreTest, ConcurrentReadersAndWriter) {
+  std::atomic<bool> done{false};
+  std::atomic<uint64_t> found{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 2; ++i) {
+    readers.emplace_back([this, &done, &found]() {
+      std::string value;
+      while (!done.load()) {
+        if (store_.lookup(1, "key", value)) {
+          ASSERT_FALSE(value.empty());
+          ASSERT_EQ(std::string(value.size(), value[0]), value);
+          ++found;
+        }
+      }
+    });
+  }
+  for (uint32_t i = 0; i < 100000 || found.load() == 0; ++i) {
+    store_.insert(1, "key", std::string(1 + i % 500, 'a' + i % 26));
+  }
+  done = true;
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(1, store_.entries());
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -974,6 +974,40 @@ TEST_F(HttpConnectionManagerConfigTest, NormalizePathFalse) {
   EXPECT_FALSE(config.shouldNormalizePath());
 }
 
+// Validated that by default streams do not have arenas.
+TEST_F(HttpConnectionManagerConfigTest, StreamArenaBlockSizeDefault) {
+  const std::string yaml_string = R"EOF(
+  stat_prefix: ingress_http
+  route_config:
+    name: local_route
+  http_filters:
+  - name: envoy.filters.http.router
+  )EOF";
+
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromYaml(yaml_string), context_,
+                                     date_provider_, route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_, http_tracer_manager_,
+                                     filter_config_provider_manager_);
+  EXPECT_EQ(0, config.streamArenaBlockSize());
+}
+
+TEST_F(HttpConnectionManagerConfigTest, StreamArenaBlockSize) {
+  const std::string yaml_string = R"EOF(
+  stat_prefix: ingress_http
+  route_config:
+    name: local_route
+  stream_arena_block_size: 4096
+  http_filters:
+  - name: envoy.filters.http.router
+  )EOF";
+
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromYaml(yaml_string), context_,
+                                     date_provider_, route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_, http_tracer_manager_,
+                                     filter_config_provider_manager_);
+  EXPECT_EQ(4096, config.streamArenaBlockSize());
+}
+
 // Validated that by default we don't merge slashes.
 TEST_F(HttpConnectionManagerConfigTest, MergeSlashesDefault) {
   const std::string yaml_string = R"EOF(
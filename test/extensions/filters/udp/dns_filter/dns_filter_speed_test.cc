@@ -0,0 +1,118 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/filters/udp/dns_filter/v3alpha/dns_filter.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/utility.h"
+
+#include "extensions/filters/udp/dns_filter/dns_filter.h"
+#include "extensions/filters/udp/dns_filter/dns_filter_constants.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/server/listener_factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "dns_filter_test_utils.h"
+
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace DnsFilter {
+namespace {
+
+// Answers A queries for a number of names configured with two addresses each, as a DNS server
+// serving the names of a service mesh would.
+class DnsFilterSpeedTest {
+public:
+  DnsFilterSpeedTest(bool cache_responses, uint32_t num_names) : api_(Api::createApiForTest()) {
+    ON_CALL(listener_factory_, api()).WillByDefault(ReturnRef(*api_));
+    ON_CALL(dispatcher_, createDnsResolver(testing::_, testing::_))
+        .WillByDefault(Return(std::make_shared<NiceMock<Network::MockDnsResolver>>()));
+    ON_CALL(callbacks_.udp_listener_, dispatcher()).WillByDefault(ReturnRef(dispatcher_));
+    ON_CALL(callbacks_.udp_listener_, send(testing::_))
+        .WillByDefault([this](const Network::UdpSendData& data) {
+          ++responses_;
+          auto result = Api::ioCallUint64ResultNoError();
+          result.rc_ = data.buffer_.length();
+          return result;
+        });
+
+    envoy::extensions::filters::udp::dns_filter::v3alpha::DnsFilterConfig config;
+    config.set_stat_prefix("speed_test");
+    auto* table = config.mutable_server_config()->mutable_inline_dns_table();
+    for (uint32_t i = 0; i < num_names; ++i) {
+      const std::string name = fmt::format("service{}.mesh.local", i);
+      auto* domain = table->add_virtual_domains();
+      domain->set_name(name);
+      auto* addresses = domain->mutable_endpoint()->mutable_address_list();
+      addresses->add_address(fmt::format("10.0.{}.1", i % 256));
+      addresses->add_address(fmt::format("10.0.{}.2", i % 256));
+      queries_.push_back(
+          Utils::buildQueryForDomain(name, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN, i + 1));
+    }
+    if (cache_responses) {
+      config.mutable_response_cache();
+    }
+
+    config_ = std::make_shared<DnsFilterEnvoyConfig>(listener_factory_, config);
+    filter_ = std::make_unique<DnsFilter>(callbacks_, config_);
+
+    local_address_ = Network::Utility::parseInternetAddressAndPort("127.0.0.1:53");
+    peer_address_ = Network::Utility::parseInternetAddressAndPort("10.1.0.1:1000");
+  }
+
+  // Sends one query for each configured name to the filter.
+  void sendQueries() {
+    for (const std::string& query : queries_) {
+      Network::UdpRecvData data;
+      data.addresses_.local_ = local_address_;
+      data.addresses_.peer_ = peer_address_;
+      data.buffer_ = std::make_unique<Buffer::OwnedImpl>(query);
+      filter_->onData(data);
+    }
+  }
+
+  uint64_t responses() const { return responses_; }
+
+private:
+  Api::ApiPtr api_;
+  NiceMock<Server::Configuration::MockListenerFactoryContext> listener_factory_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Network::MockUdpReadFilterCallbacks> callbacks_;
+  DnsFilterEnvoyConfigSharedPtr config_;
+  std::unique_ptr<DnsFilter> filter_;
+  Network::Address::InstanceConstSharedPtr local_address_;
+  Network::Address::InstanceConstSharedPtr peer_address_;
+  std::vector<std::string> queries_;
+  uint64_t responses_{};
+};
+
+// The first argument enables (1) or disables (0) the response cache, the second one is the number
+// of names queried in turn.
+void answerQueries(benchmark::State& state) {
+  DnsFilterSpeedTest speed_test(state.range(0), state.range(1));
+  for (auto _ : state) {
+    speed_test.sendQueries();
+  }
+  // Queries answered per second.
+  state.SetItemsProcessed(speed_test.responses());
+}
+
+BENCHMARK(answerQueries)->Ranges({{false, true}, {1, 256}});
+
+} // namespace
+} // namespace DnsFilter
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
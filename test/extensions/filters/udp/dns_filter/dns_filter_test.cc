@@ -205,6 +205,12 @@ server_config:
             - "10.0.0.1"
 )EOF";
 
+  const std::string response_cache_config = R"EOF(
+response_cache:
+  max_entries: 16
+  negative_ttl: 30s
+)EOF";
+
   const std::string external_dns_table_config = R"EOF(
 stat_prefix: "my_prefix"
 client_config:
@@ -2034,6 +2040,141 @@ TEST_F(DnsFilterTest, SrvQueryMaxRecords) {
   EXPECT_LT(exact_matches, hosts.size());
 }
 
+TEST_F(DnsFilterTest, ResponseCacheHit) {
+  InSequence s;
+
+  setup(forward_query_off_config + response_cache_config);
+  const std::string domain("www.foo3.com");
+
+  std::string first_response;
+  for (const uint16_t query_id : {1, 2}) {
+    const std::string query =
+        Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN, query_id);
+    ASSERT_FALSE(query.empty());
+    sendQueryFromClient("10.0.0.1:1000", query);
+
+    query_ctx_ = response_parser_->createQueryContext(udp_response_, counters_);
+    EXPECT_TRUE(query_ctx_->parse_status_);
+    EXPECT_EQ(query_id, query_ctx_->header_.id);
+    EXPECT_EQ(DNS_RESPONSE_CODE_NO_ERROR, query_ctx_->getQueryResponseCode());
+    ASSERT_EQ(1, query_ctx_->answers_.size());
+    Utils::verifyAddress({"10.0.3.1"}, query_ctx_->answers_.find(domain)->second);
+
+    // Apart from the transaction ID, the cached response is the one sent first
+    const std::string response = udp_response_.buffer_->toString();
+    if (first_response.empty()) {
+      first_response = response;
+    } else {
+      EXPECT_EQ(first_response.substr(sizeof(uint16_t)), response.substr(sizeof(uint16_t)));
+    }
+  }
+
+  // The second query is answered from the cache without being resolved
+  EXPECT_EQ(2, config_->stats().downstream_rx_queries_.value());
+  EXPECT_EQ(2, config_->stats().downstream_tx_responses_.value());
+  EXPECT_EQ(2, config_->stats().a_record_queries_.value());
+  EXPECT_EQ(1, config_->stats().local_a_record_answers_.value());
+  EXPECT_EQ(1, config_->stats().response_cache_misses_.value());
+  EXPECT_EQ(1, config_->stats().response_cache_hits_.value());
+
+  // The TTL of the answer counts down while the response is cached
+  simTime().advanceTimeWait(std::chrono::seconds(100));
+  sendQueryFromClient("10.0.0.1:1000", Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A,
+                                                                   DNS_RECORD_CLASS_IN, 3));
+  query_ctx_ = response_parser_->createQueryContext(udp_response_, counters_);
+  EXPECT_TRUE(query_ctx_->parse_status_);
+  ASSERT_EQ(1, query_ctx_->answers_.size());
+  EXPECT_EQ(std::chrono::seconds(200), query_ctx_->answers_.find(domain)->second->ttl_);
+  EXPECT_EQ(2, config_->stats().response_cache_hits_.value());
+
+  // The response expires with the TTL of its answer
+  simTime().advanceTimeWait(std::chrono::seconds(200));
+  sendQueryFromClient("10.0.0.1:1000", Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A,
+                                                                   DNS_RECORD_CLASS_IN, 4));
+  EXPECT_EQ(2, config_->stats().local_a_record_answers_.value());
+  EXPECT_EQ(2, config_->stats().response_cache_misses_.value());
+  EXPECT_EQ(2, config_->stats().response_cache_hits_.value());
+}
+
+TEST_F(DnsFilterTest, ResponseCacheNegativeAnswer) {
+  InSequence s;
+
+  setup(forward_query_off_config + response_cache_config);
+  const std::string query =
+      Utils::buildQueryForDomain("www.foo4.com", DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN, 1);
+  ASSERT_FALSE(query.empty());
+
+  for (int i = 0; i < 2; i++) {
+    sendQueryFromClient("10.0.0.1:1000", query);
+    query_ctx_ = response_parser_->createQueryContext(udp_response_, counters_);
+    EXPECT_TRUE(query_ctx_->parse_status_);
+    EXPECT_EQ(DNS_RESPONSE_CODE_NAME_ERROR, query_ctx_->getQueryResponseCode());
+    EXPECT_EQ(0, query_ctx_->answers_.size());
+  }
+  EXPECT_EQ(1, config_->stats().unanswered_queries_.value());
+  EXPECT_EQ(1, config_->stats().response_cache_misses_.value());
+  EXPECT_EQ(1, config_->stats().response_cache_hits_.value());
+
+  // Responses without answers expire after the negative TTL
+  simTime().advanceTimeWait(std::chrono::seconds(30));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  EXPECT_EQ(2, config_->stats().unanswered_queries_.value());
+  EXPECT_EQ(2, config_->stats().response_cache_misses_.value());
+}
+
+TEST_F(DnsFilterTest, ResponseCacheSkipsRandomizedAnswers) {
+  InSequence s;
+
+  setup(forward_query_off_config + response_cache_config);
+  const std::string query =
+      Utils::buildQueryForDomain("www.foo16.com", DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN, 1);
+  ASSERT_FALSE(query.empty());
+
+  // Responses to a name with more addresses than are returned start at a random address
+  sendQueryFromClient("10.0.0.1:1000", query);
+  sendQueryFromClient("10.0.0.1:1000", query);
+  EXPECT_EQ(32, config_->stats().local_a_record_answers_.value());
+  EXPECT_EQ(2, config_->stats().response_cache_misses_.value());
+  EXPECT_EQ(0, config_->stats().response_cache_hits_.value());
+}
+
+TEST_F(DnsFilterTest, ResponseCacheExternalResolution) {
+  InSequence s;
+
+  auto timeout_timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*timeout_timer, enableTimer(_, _));
+
+  const std::string expected_address("130.207.244.251");
+  const std::string domain("www.foobaz.com");
+  setup(forward_query_on_config + response_cache_config);
+
+  Network::DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*resolver_, resolve(domain, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  sendQueryFromClient("10.0.0.1:1000", Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A,
+                                                                   DNS_RECORD_CLASS_IN, 1));
+
+  EXPECT_CALL(*timeout_timer, disableTimer()).Times(AnyNumber());
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Success,
+             TestUtility::makeDnsResponse({expected_address}));
+
+  // The resolver is not called again for the second query
+  sendQueryFromClient("10.0.0.1:1000", Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A,
+                                                                   DNS_RECORD_CLASS_IN, 2));
+  query_ctx_ = response_parser_->createQueryContext(udp_response_, counters_);
+  EXPECT_TRUE(query_ctx_->parse_status_);
+  EXPECT_EQ(2, query_ctx_->header_.id);
+  EXPECT_EQ(DNS_RESPONSE_CODE_NO_ERROR, query_ctx_->getQueryResponseCode());
+  ASSERT_EQ(1, query_ctx_->answers_.size());
+  Utils::verifyAddress({expected_address}, query_ctx_->answers_.begin()->second);
+
+  EXPECT_EQ(1, config_->stats().external_a_record_queries_.value());
+  EXPECT_EQ(1, config_->stats().response_cache_misses_.value());
+  EXPECT_EQ(1, config_->stats().response_cache_hits_.value());
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+}
+
 } // namespace
 } // namespace DnsFilter
 } // namespace UdpFilters
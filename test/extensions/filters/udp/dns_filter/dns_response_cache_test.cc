@@ -0,0 +1,223 @@
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/udp/dns_filter/dns_filter_constants.h"
+#include "extensions/filters/udp/dns_filter/dns_response_cache.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "dns_filter_test_utils.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace DnsFilter {
+namespace {
+
+class DnsResponseCacheTest : public testing::Test, public Event::TestUsingSimulatedTime {
+public:
+  absl::optional<std::string> keyFor(const std::string& name, uint16_t type = DNS_RECORD_TYPE_A,
+                                     uint16_t id = 1) {
+    Buffer::OwnedImpl query(Utils::buildQueryForDomain(name, type, DNS_RECORD_CLASS_IN, id));
+    return DnsResponseCache::keyForQuery(query);
+  }
+
+  // Returns the transaction ID and the rest of the response.
+  std::pair<uint16_t, std::string> lookup(DnsResponseCache& cache, const std::string& key,
+                                          uint16_t id) {
+    Buffer::OwnedImpl response;
+    if (!cache.lookup(key, id, response)) {
+      return {0, ""};
+    }
+    const uint16_t response_id = response.peekBEInt<uint16_t>(0);
+    response.drain(sizeof(uint16_t));
+    return {response_id, response.toString()};
+  }
+
+  // Returns a response to the A query for www.foo1.com with transaction ID 1, with an answer
+  // with the TTL and an OPT record.
+  static std::string responseWithTtl(uint8_t ttl) {
+    const char response[] = {
+        0x00, 0x01,                               // Transaction ID
+        '\x81', '\x80',                           // Flags
+        0x00, 0x01,                               // Questions
+        0x00, 0x01,                               // Answers
+        0x00, 0x00,                               // Authority RRs
+        0x00, 0x01,                               // Additional RRs
+        0x03, 0x77, 0x77, 0x77,                   // www
+        0x04, 0x66, 0x6f, 0x6f, 0x31,             // foo1
+        0x03, 0x63, 0x6f, 0x6d, 0x00,             // com
+        0x00, 0x01,                               // Query Type - A
+        0x00, 0x01,                               // Query Class - IN
+        '\xc0', 0x0c,                             // Answer Name - pointer to the question's name
+        0x00, 0x01,                               // Answer Type - A
+        0x00, 0x01,                               // Answer Class - IN
+        0x00, 0x00, 0x00, static_cast<char>(ttl), // Answer TTL
+        0x00, 0x04,                               // Answer Data Length
+        0x0a, 0x00, 0x00, 0x01,                   // Answer Data - 10.0.0.1
+        0x00,                                     // OPT Name - root
+        0x00, 0x29,                               // OPT Type
+        0x10, 0x00,                               // OPT UDP Payload Size
+        0x00, 0x00, 0x00, 0x05,                   // OPT Extended Response Code and Flags
+        0x00, 0x00,                               // OPT Data Length
+    };
+    return {response, sizeof(response)};
+  }
+
+  const std::string response_{responseWithTtl(10)};
+};
+
+TEST_F(DnsResponseCacheTest, KeyCoversFlagsAndQuestion) {
+  const auto key = keyFor("www.foo1.com");
+  ASSERT_TRUE(key.has_value());
+  EXPECT_EQ(DNS_RECORD_TYPE_A, DnsResponseCache::queryType(key.value()));
+
+  // The transaction ID is not part of the key, unlike the name and the record type.
+  EXPECT_EQ(key, keyFor("www.foo1.com", DNS_RECORD_TYPE_A, 2));
+  EXPECT_NE(key, keyFor("www.foo2.com"));
+  const auto aaaa_key = keyFor("www.foo1.com", DNS_RECORD_TYPE_AAAA);
+  ASSERT_TRUE(aaaa_key.has_value());
+  EXPECT_NE(key, aaaa_key);
+  EXPECT_EQ(DNS_RECORD_TYPE_AAAA, DnsResponseCache::queryType(aaaa_key.value()));
+
+  // Flip a header flag.
+  Buffer::OwnedImpl query(
+      Utils::buildQueryForDomain("www.foo1.com", DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN, 1));
+  std::string bytes = query.toString();
+  bytes[2] ^= 0x01;
+  Buffer::OwnedImpl other_flags(bytes);
+  EXPECT_NE(key, DnsResponseCache::keyForQuery(other_flags));
+}
+
+TEST_F(DnsResponseCacheTest, NoKeyForUncacheableQueries) {
+  Buffer::OwnedImpl query(
+      Utils::buildQueryForDomain("www.foo1.com", DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN, 1));
+  const std::string bytes = query.toString();
+
+  // A bare header.
+  Buffer::OwnedImpl header(bytes.substr(0, 12));
+  EXPECT_FALSE(DnsResponseCache::keyForQuery(header).has_value());
+
+  // A question missing its record class.
+  Buffer::OwnedImpl truncated(bytes.substr(0, bytes.size() - 2));
+  EXPECT_FALSE(DnsResponseCache::keyForQuery(truncated).has_value());
+
+  // Two questions, an answer record and an authority record.
+  for (const size_t count_offset : {5, 7, 9}) {
+    std::string modified = bytes;
+    modified[count_offset] = 2;
+    Buffer::OwnedImpl modified_query(modified);
+    EXPECT_FALSE(DnsResponseCache::keyForQuery(modified_query).has_value());
+  }
+
+  // A compressed name.
+  const char compressed[] = {
+      0x00, 0x01,             // Transaction ID
+      0x01, 0x00,             // Flags
+      0x00, 0x01,             // Questions
+      0x00, 0x00,             // Answers
+      0x00, 0x00,             // Authority RRs
+      0x00, 0x00,             // Additional RRs
+      0x03, 0x77, 0x77, 0x77, // www
+      '\xc0', 0x0c,           // Pointer to the name
+      0x00, 0x01,             // Query Type - A
+      0x00, 0x01,             // Query Class - IN
+  };
+  Buffer::OwnedImpl compressed_query(compressed, sizeof(compressed));
+  EXPECT_FALSE(DnsResponseCache::keyForQuery(compressed_query).has_value());
+
+  // No transaction ID.
+  std::string no_id = bytes;
+  no_id[0] = 0;
+  no_id[1] = 0;
+  Buffer::OwnedImpl no_id_query(no_id);
+  EXPECT_FALSE(DnsResponseCache::keyForQuery(no_id_query).has_value());
+}
+
+TEST_F(DnsResponseCacheTest, LookupPatchesTransactionId) {
+  DnsResponseCache cache(simTime(), 16);
+  const std::string key = keyFor("www.foo1.com").value();
+  EXPECT_EQ(0, lookup(cache, key, 7).first);
+
+  cache.insert(key, Buffer::OwnedImpl(response_), std::chrono::seconds(10));
+  EXPECT_EQ(1, cache.size());
+  const auto [id, rest] = lookup(cache, key, 7);
+  EXPECT_EQ(7, id);
+  EXPECT_EQ(response_.substr(sizeof(uint16_t)), rest);
+  EXPECT_EQ(0xabcd, lookup(cache, key, 0xabcd).first);
+}
+
+TEST_F(DnsResponseCacheTest, EntriesExpire) {
+  DnsResponseCache cache(simTime(), 16);
+  const std::string key = keyFor("www.foo1.com").value();
+  cache.insert(key, Buffer::OwnedImpl(response_), std::chrono::seconds(10));
+
+  simTime().advanceTimeWait(std::chrono::seconds(9));
+  EXPECT_EQ(2, lookup(cache, key, 2).first);
+
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_EQ(0, lookup(cache, key, 2).first);
+  EXPECT_EQ(0, cache.size());
+
+  // Inserting again replaces the expiry.
+  cache.insert(key, Buffer::OwnedImpl(response_), std::chrono::seconds(10));
+  simTime().advanceTimeWait(std::chrono::seconds(5));
+  cache.insert(key, Buffer::OwnedImpl(response_), std::chrono::seconds(10));
+  simTime().advanceTimeWait(std::chrono::seconds(9));
+  EXPECT_EQ(2, lookup(cache, key, 2).first);
+  EXPECT_EQ(1, cache.size());
+}
+
+TEST_F(DnsResponseCacheTest, LookupCountsDownTtls) {
+  DnsResponseCache cache(simTime(), 16);
+  const std::string key = keyFor("www.foo1.com").value();
+  cache.insert(key, Buffer::OwnedImpl(response_), std::chrono::seconds(10));
+
+  simTime().advanceTimeWait(std::chrono::milliseconds(3500));
+  // Only the TTL of the answer changes, not the flags of the OPT record which follow it.
+  EXPECT_EQ(responseWithTtl(7).substr(sizeof(uint16_t)), lookup(cache, key, 1).second);
+
+  simTime().advanceTimeWait(std::chrono::seconds(6));
+  EXPECT_EQ(responseWithTtl(1).substr(sizeof(uint16_t)), lookup(cache, key, 1).second);
+}
+
+TEST_F(DnsResponseCacheTest, SkipsMalformedResponses) {
+  DnsResponseCache cache(simTime(), 16);
+  const std::string key = keyFor("www.foo1.com").value();
+
+  // The data of the OPT record runs past the end of the response.
+  std::string truncated = response_;
+  truncated.back() = 1;
+  cache.insert(key, Buffer::OwnedImpl(truncated), std::chrono::seconds(10));
+  EXPECT_EQ(0, cache.size());
+
+  // A label with one of the two high bits set.
+  std::string bad_label = response_;
+  bad_label[12] = 0x43;
+  cache.insert(key, Buffer::OwnedImpl(bad_label), std::chrono::seconds(10));
+  EXPECT_EQ(0, cache.size());
+}
+
+TEST_F(DnsResponseCacheTest, EvictsLeastRecentlyUsed) {
+  DnsResponseCache cache(simTime(), 2);
+  const std::string key1 = keyFor("www.foo1.com").value();
+  const std::string key2 = keyFor("www.foo2.com").value();
+  const std::string key3 = keyFor("www.foo3.com").value();
+
+  cache.insert(key1, Buffer::OwnedImpl(response_), std::chrono::seconds(10));
+  cache.insert(key2, Buffer::OwnedImpl(response_), std::chrono::seconds(10));
+  // Using the first entry makes the second one the least recently used.
+  EXPECT_EQ(1, lookup(cache, key1, 1).first);
+
+  cache.insert(key3, Buffer::OwnedImpl(response_), std::chrono::seconds(10));
+  EXPECT_EQ(2, cache.size());
+  EXPECT_EQ(1, lookup(cache, key1, 1).first);
+  EXPECT_EQ(0, lookup(cache, key2, 1).first);
+  EXPECT_EQ(1, lookup(cache, key3, 1).first);
+}
+
+} // namespace
+} // namespace DnsFilter
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
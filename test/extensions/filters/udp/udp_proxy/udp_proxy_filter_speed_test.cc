@@ -0,0 +1,168 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/listener/v3/udp_gso_batch_writer_config.pb.h"
+#include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/utility.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/udp/udp_proxy/udp_proxy_filter.h"
+#include "extensions/quic_listeners/quiche/udp_gso_batch_writer_config.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/mocks/upstream/host.h"
+#include "test/mocks/upstream/thread_local_cluster.h"
+#include "test/test_common/network_utility.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace UdpFilters {
+namespace UdpProxy {
+namespace {
+
+// The number of datagrams the listener hands to the filter after a recvmmsg() call.
+constexpr uint32_t DatagramsPerReadEvent = 16;
+
+// Forwards the datagrams of a read event from a number of downstream peers through the UDP proxy
+// filter to an upstream socket on the loopback interface, which echoes each of them back to the
+// session which sent it. Both the sessions' sockets and the upstream socket are real, so the
+// benchmark includes the system calls sending and receiving the datagrams.
+class UdpProxySpeedTest : public Network::UdpPacketProcessor {
+public:
+  UdpProxySpeedTest(bool batch_writer, uint32_t datagram_size, uint32_t num_peers)
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        upstream_(Network::Test::bindFreeLoopbackPort(Network::Address::IpVersion::v4,
+                                                      Network::Socket::Type::Datagram)),
+        datagram_(datagram_size, 'a') {
+    ON_CALL(callbacks_.udp_listener_, dispatcher()).WillByDefault(ReturnRef(*dispatcher_));
+    ON_CALL(callbacks_.udp_listener_, send(testing::_))
+        .WillByDefault([this](const Network::UdpSendData& data) {
+          ++datagrams_to_downstream_;
+          auto result = Api::ioCallUint64ResultNoError();
+          result.rc_ = data.buffer_.length();
+          return result;
+        });
+    ON_CALL(callbacks_.udp_listener_, flush()).WillByDefault([]() {
+      return Api::ioCallUint64ResultNoError();
+    });
+    ON_CALL(*cluster_manager_.thread_local_cluster_.lb_.host_, address())
+        .WillByDefault(Return(upstream_.first));
+    ON_CALL(*cluster_manager_.thread_local_cluster_.lb_.host_, health())
+        .WillByDefault(Return(Upstream::Host::Health::Healthy));
+    cluster_manager_.initializeThreadLocalClusters({"fake_cluster"});
+
+    envoy::extensions::filters::udp::udp_proxy::v3::UdpProxyConfig config;
+    config.set_stat_prefix("foo");
+    config.set_cluster("fake_cluster");
+    if (batch_writer) {
+      config.mutable_upstream_writer_config()->set_name(Quic::GsoBatchWriterName);
+      config.mutable_upstream_writer_config()->mutable_typed_config()->PackFrom(
+          envoy::config::listener::v3::UdpGsoBatchWriterOptions());
+    }
+    config_ = std::make_shared<UdpProxyFilterConfig>(cluster_manager_, api_->timeSource(),
+                                                     stats_store_, config,
+                                                     ProtobufMessage::getStrictValidationVisitor());
+    filter_ = std::make_unique<UdpProxyFilter>(callbacks_, config_);
+
+    local_address_ = Network::Utility::parseInternetAddressAndPort("127.0.0.1:53");
+    for (uint32_t i = 0; i < num_peers; ++i) {
+      peer_addresses_.push_back(
+          Network::Utility::parseInternetAddressAndPort(fmt::format("10.0.0.{}:1000", i + 1)));
+    }
+  }
+
+  ~UdpProxySpeedTest() override {
+    filter_.reset();
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+
+  // Hands a read event's worth of datagrams to the filter, lets the upstream echo them and
+  // delivers the replies to the sessions.
+  void forwardReadEvent() {
+    for (uint32_t i = 0; i < DatagramsPerReadEvent; ++i) {
+      Network::UdpRecvData data;
+      data.addresses_.local_ = local_address_;
+      data.addresses_.peer_ = peer_addresses_[i % peer_addresses_.size()];
+      data.buffer_ = std::make_unique<Buffer::OwnedImpl>(datagram_);
+      filter_->onData(data);
+    }
+    // Runs the flush of batch mode writers.
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+    uint32_t packets_dropped = 0;
+    Network::Utility::readPacketsFromSocket(upstream_.second->ioHandle(), *upstream_.first, *this,
+                                            api_->timeSource(), packets_dropped);
+    // Runs the sessions' read events.
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+
+  uint64_t datagramsToDownstream() const { return datagrams_to_downstream_; }
+
+  // Network::UdpPacketProcessor
+  void processPacket(Network::Address::InstanceConstSharedPtr,
+                     Network::Address::InstanceConstSharedPtr peer_address,
+                     Buffer::InstancePtr buffer, MonotonicTime) override {
+    Network::Utility::writeToSocket(upstream_.second->ioHandle(), *buffer, nullptr, *peer_address);
+  }
+  uint64_t maxPacketSize() const override { return Network::MAX_UDP_PACKET_SIZE; }
+
+private:
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  std::pair<Network::Address::InstanceConstSharedPtr, Network::SocketPtr> upstream_;
+  const std::string datagram_;
+  Stats::IsolatedStoreImpl stats_store_;
+  NiceMock<Upstream::MockClusterManager> cluster_manager_;
+  NiceMock<Network::MockUdpReadFilterCallbacks> callbacks_;
+  UdpProxyFilterConfigSharedPtr config_;
+  std::unique_ptr<UdpProxyFilter> filter_;
+  Network::Address::InstanceConstSharedPtr local_address_;
+  std::vector<Network::Address::InstanceConstSharedPtr> peer_addresses_;
+  uint64_t datagrams_to_downstream_{};
+};
+
+// The first argument selects the UDP GSO batch writer (1) or the default writer (0) for sending
+// datagrams upstream, the second one the datagram size and the third one the number of
+// downstream peers the datagrams of each read event come from. The batch writer falls back to
+// the default one on kernels without UDP GSO support.
+void forwardDatagrams(benchmark::State& state) {
+  UdpProxySpeedTest speed_test(state.range(0), state.range(1), state.range(2));
+  for (auto _ : state) {
+    speed_test.forwardReadEvent();
+  }
+  // Datagrams forwarded upstream and back downstream.
+  state.SetItemsProcessed(speed_test.datagramsToDownstream());
+}
+
+void datagramArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t batch_writer : {0, 1}) {
+    // DNS queries, each from another client.
+    b->Args({batch_writer, 64, DatagramsPerReadEvent});
+    // DNS responses of classic maximum size.
+    b->Args({batch_writer, 512, DatagramsPerReadEvent});
+    // Game state updates from a few players.
+    b->Args({batch_writer, 200, 2});
+  }
+}
+
+BENCHMARK(forwardDatagrams)->Apply(datagramArgs);
+
+} // namespace
+} // namespace UdpProxy
+} // namespace UdpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -1,5 +1,8 @@
+#include <list>
+
 #include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.h"
 #include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.validate.h"
+#include "envoy/network/udp_packet_writer_config.h"
 
 #include "common/common/hash.h"
 #include "common/network/socket_impl.h"
@@ -8,17 +11,20 @@
 #include "extensions/filters/udp/udp_proxy/udp_proxy_filter.h"
 
 #include "test/mocks/api/mocks.h"
+#include "test/mocks/network/mocks.h"
 #include "test/mocks/network/socket.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/mocks/upstream/cluster_update_callbacks.h"
 #include "test/mocks/upstream/cluster_update_callbacks_handle.h"
 #include "test/mocks/upstream/host.h"
 #include "test/mocks/upstream/thread_local_cluster.h"
+#include "test/test_common/registry.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::Assign;
 using testing::AtLeast;
 using testing::ByMove;
 using testing::DoAll;
@@ -26,6 +32,7 @@ using testing::InSequence;
 using testing::InvokeWithoutArgs;
 using testing::Return;
 using testing::ReturnNew;
+using testing::ReturnPointee;
 using testing::SaveArg;
 
 namespace Envoy {
@@ -52,6 +59,51 @@ Api::IoCallUint64Result makeError(int sys_errno) {
                                                     Network::IoSocketError::deleteIoError));
 }
 
+class MockUdpProxyOsSysCalls : public Api::MockOsSysCalls {
+public:
+  MOCK_METHOD(bool, supportsUdpGso, (), (const));
+};
+
+// Hands out batch mode mock writers to the sessions in the order they are created.
+class TestBatchWriterConfigFactory : public Network::UdpPacketWriterConfigFactory {
+public:
+  Network::MockUdpPacketWriter& addWriter() {
+    auto writer = std::make_unique<NiceMock<Network::MockUdpPacketWriter>>();
+    ON_CALL(*writer, isBatchMode()).WillByDefault(Return(true));
+    ON_CALL(*writer, writePacket(_, _, _))
+        .WillByDefault(Invoke([](const Buffer::Instance& buffer, const Network::Address::Ip*,
+                                 const Network::Address::Instance&) -> Api::IoCallUint64Result {
+          return makeNoError(buffer.length());
+        }));
+    ON_CALL(*writer, flush()).WillByDefault(InvokeWithoutArgs([]() -> Api::IoCallUint64Result {
+      return makeNoError(0);
+    }));
+    writers_.push_back(std::move(writer));
+    return *writers_.back();
+  }
+
+  // Network::UdpPacketWriterConfigFactory
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<ProtobufWkt::Struct>();
+  }
+  Network::UdpPacketWriterFactoryPtr
+  createUdpPacketWriterFactory(const Protobuf::Message&) override {
+    auto factory = std::make_unique<NiceMock<Network::MockUdpPacketWriterFactory>>();
+    ON_CALL(*factory, createUdpPacketWriter(_, _))
+        .WillByDefault(Invoke([this](Network::IoHandle&, Stats::Scope&) {
+          EXPECT_FALSE(writers_.empty());
+          Network::UdpPacketWriterPtr writer = std::move(writers_.front());
+          writers_.pop_front();
+          return writer;
+        }));
+    return factory;
+  }
+  std::string name() const override { return "test_batch_writer"; }
+
+private:
+  std::list<std::unique_ptr<NiceMock<Network::MockUdpPacketWriter>>> writers_;
+};
+
 class UdpProxyFilterTest : public testing::Test {
 public:
   struct TestSession {
@@ -163,6 +215,8 @@ public:
         peer_address_(std::move(peer_address)) {
     // Disable strict mock warnings.
     ON_CALL(os_sys_calls_, supportsIpTransparent()).WillByDefault(Return(true));
+    ON_CALL(os_sys_calls_, supportsUdpGro()).WillByDefault(Return(false));
+    ON_CALL(os_sys_calls_, supportsUdpGso()).WillByDefault(Return(false));
     EXPECT_CALL(callbacks_, udpListener()).Times(AtLeast(0));
     EXPECT_CALL(*cluster_manager_.thread_local_cluster_.lb_.host_, address())
         .WillRepeatedly(Return(upstream_address_));
@@ -176,7 +230,8 @@ public:
     envoy::extensions::filters::udp::udp_proxy::v3::UdpProxyConfig config;
     TestUtility::loadFromYamlAndValidate(yaml, config);
     config_ = std::make_shared<UdpProxyFilterConfig>(cluster_manager_, time_system_, stats_store_,
-                                                     config);
+                                                     config,
+                                                     ProtobufMessage::getStrictValidationVisitor());
     EXPECT_CALL(cluster_manager_, addThreadLocalClusterUpdateCallbacks_(_))
         .WillOnce(DoAll(SaveArgAddress(&cluster_update_callbacks_),
                         ReturnNew<Upstream::MockClusterUpdateCallbacksHandle>()));
@@ -271,7 +326,7 @@ use_original_src_ip: true
     return true;
   }
 
-  Api::MockOsSysCalls os_sys_calls_;
+  NiceMock<MockUdpProxyOsSysCalls> os_sys_calls_;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_;
   Upstream::MockClusterManager cluster_manager_;
   NiceMock<MockTimeSystem> time_system_;
@@ -787,6 +842,134 @@ cluster: fake_cluster
   test_sessions_[0].recvDataFromUpstream("world");
 }
 
+// Sessions ask the kernel to coalesce the datagrams received from upstream when it can.
+TEST_F(UdpProxyFilterTest, SessionSocketOptionForUdpGro) {
+  ON_CALL(os_sys_calls_, supportsUdpGro()).WillByDefault(Return(true));
+
+  setup(R"EOF(
+stat_prefix: foo
+cluster: fake_cluster
+  )EOF");
+
+  expectSessionCreate(upstream_address_);
+  test_sessions_[0].expectSetIpTransparentSocketOption();
+  test_sessions_[0].expectWriteToUpstream("hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  if (ENVOY_SOCKET_UDP_GRO.hasValue()) {
+    EXPECT_EQ(1, test_sessions_[0]
+                     .sock_opts_[ENVOY_SOCKET_UDP_GRO.level()][ENVOY_SOCKET_UDP_GRO.option()]);
+  }
+}
+
+// A batch mode writer is flushed once after all the datagrams of a read event were written.
+TEST_F(UdpProxyFilterTest, BatchWriterFlushedAtEndOfIteration) {
+  TestBatchWriterConfigFactory writer_factory;
+  Registry::InjectFactory<Network::UdpPacketWriterConfigFactory> registration(writer_factory);
+  ON_CALL(os_sys_calls_, supportsUdpGso()).WillByDefault(Return(true));
+
+  setup(R"EOF(
+stat_prefix: foo
+cluster: fake_cluster
+upstream_writer_config:
+  name: test_batch_writer
+  typed_config:
+    "@type": type.googleapis.com/google.protobuf.Struct
+  )EOF");
+
+  Network::MockUdpPacketWriter& writer = writer_factory.addWriter();
+  auto* flush_cb =
+      new NiceMock<Event::MockSchedulableCallback>(&callbacks_.udp_listener_.dispatcher_);
+  expectSessionCreate(upstream_address_);
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(_, _)).Times(2);
+  EXPECT_CALL(writer, writePacket(_, nullptr, _)).Times(2);
+  EXPECT_CALL(writer, flush()).Times(0);
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "world");
+  EXPECT_TRUE(flush_cb->enabled_);
+  checkTransferStats(10 /*rx_bytes*/, 2 /*rx_datagrams*/, 0 /*tx_bytes*/, 0 /*tx_datagrams*/);
+  EXPECT_EQ(2, TestUtility::findCounter(
+                   cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_,
+                   "udp.sess_tx_datagrams")
+                   ->value());
+
+  testing::Mock::VerifyAndClearExpectations(&writer);
+  EXPECT_CALL(writer, flush()).WillOnce(Return(ByMove(makeError(SOCKET_ERROR_MSG_SIZE))));
+  flush_cb->invokeCallback();
+  EXPECT_EQ(1, TestUtility::findCounter(
+                   cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_,
+                   "udp.sess_tx_errors")
+                   ->value());
+
+  // Datagrams still buffered when the session goes away are sent first.
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(_, _));
+  EXPECT_CALL(writer, writePacket(_, nullptr, _));
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  EXPECT_CALL(writer, flush());
+  test_sessions_[0].idle_timer_->invokeCallback();
+  EXPECT_EQ(0, config_->stats().downstream_sess_active_.value());
+  flush_cb->invokeCallback();
+}
+
+// A blocked batch mode writer keeps its datagrams and is flushed when the socket becomes writable.
+TEST_F(UdpProxyFilterTest, BatchWriterFlushedWhenWritable) {
+  TestBatchWriterConfigFactory writer_factory;
+  Registry::InjectFactory<Network::UdpPacketWriterConfigFactory> registration(writer_factory);
+  ON_CALL(os_sys_calls_, supportsUdpGso()).WillByDefault(Return(true));
+
+  setup(R"EOF(
+stat_prefix: foo
+cluster: fake_cluster
+upstream_writer_config:
+  name: test_batch_writer
+  typed_config:
+    "@type": type.googleapis.com/google.protobuf.Struct
+  )EOF");
+
+  Network::MockUdpPacketWriter& writer = writer_factory.addWriter();
+  bool write_blocked = false;
+  ON_CALL(writer, isWriteBlocked()).WillByDefault(ReturnPointee(&write_blocked));
+  ON_CALL(writer, setWritable()).WillByDefault(Assign(&write_blocked, false));
+  auto* flush_cb =
+      new NiceMock<Event::MockSchedulableCallback>(&callbacks_.udp_listener_.dispatcher_);
+  expectSessionCreate(upstream_address_);
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(_, _));
+  EXPECT_CALL(writer, writePacket(_, nullptr, _));
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+
+  EXPECT_CALL(writer, flush()).WillOnce(InvokeWithoutArgs([&write_blocked]() {
+    write_blocked = true;
+    return makeError(SOCKET_ERROR_AGAIN);
+  }));
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_,
+              enableFileEvents(Event::FileReadyType::Read | Event::FileReadyType::Write));
+  flush_cb->invokeCallback();
+  EXPECT_EQ(0, TestUtility::findCounter(
+                   cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_,
+                   "udp.sess_tx_errors")
+                   ->value());
+
+  // Datagrams are not queued behind the ones the writer is holding.
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(_, _));
+  EXPECT_CALL(writer, writePacket(_, _, _)).Times(0);
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "world");
+  EXPECT_FALSE(flush_cb->enabled_);
+  EXPECT_EQ(1, TestUtility::findCounter(
+                   cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_,
+                   "udp.sess_tx_errors")
+                   ->value());
+
+  testing::Mock::VerifyAndClearExpectations(&writer);
+  EXPECT_CALL(*test_sessions_[0].socket_->io_handle_,
+              enableFileEvents(Event::FileReadyType::Read));
+  EXPECT_CALL(writer, flush());
+  test_sessions_[0].file_event_cb_(Event::FileReadyType::Write);
+  EXPECT_FALSE(write_blocked);
+  EXPECT_EQ(1, TestUtility::findCounter(
+                   cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_,
+                   "udp.sess_tx_errors")
+                   ->value());
+}
+
 } // namespace
 } // namespace UdpProxy
 } // namespace UdpFilters
@@ -0,0 +1,202 @@
+#include <chrono>
+
+#include "common/network/socket_interface.h"
+
+#include "extensions/network/socket_interface/io_uring/ring.h"
+
+#include "test/integration/integration.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+namespace {
+
+constexpr absl::string_view IoUringSocketInterfaceName =
+    "envoy.extensions.network.socket_interface.io_uring";
+constexpr absl::string_view DefaultSocketInterfaceName =
+    "envoy.extensions.network.socket_interface.default_socket_interface";
+
+std::string socketInterfaceConfig(absl::string_view name) {
+  if (name == IoUringSocketInterfaceName) {
+    return fmt::format(R"EOF(
+bootstrap_extensions:
+  - name: {}
+    typed_config:
+      "@type": type.googleapis.com/envoy.extensions.network.socket_interface.v3.IoUringSocketInterface
+      io_uring_size: 64
+      num_registered_buffers: 32
+default_socket_interface: "{}"
+    )EOF",
+                       name, name);
+  }
+  return fmt::format(R"EOF(
+bootstrap_extensions:
+  - name: {}
+    typed_config:
+      "@type": type.googleapis.com/envoy.extensions.network.socket_interface.v3.DefaultSocketInterface
+default_socket_interface: "{}"
+    )EOF",
+                     name, name);
+}
+
+class IoUringIntegrationTest : public BaseIntegrationTest,
+                               public testing::TestWithParam<Network::Address::IpVersion> {
+public:
+  IoUringIntegrationTest()
+      : BaseIntegrationTest(GetParam(),
+                            absl::StrCat(ConfigHelper::tcpProxyConfig(),
+                                         socketInterfaceConfig(IoUringSocketInterfaceName))) {
+    enableHalfClose(true);
+  }
+
+  void SetUp() override {
+    if (!Ring::isSupported()) {
+      GTEST_SKIP() << "io_uring is not supported by the kernel";
+    }
+  }
+
+  void initialize() override {
+    config_helper_.renameListener("tcp_proxy");
+    BaseIntegrationTest::initialize();
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(IpVersions, IoUringIntegrationTest,
+                         testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
+                         TestUtility::ipTestParamsToString);
+
+TEST_P(IoUringIntegrationTest, SocketInterfaceIsDefault) {
+  initialize();
+  const Network::SocketInterface* factory =
+      Network::socketInterface(std::string(IoUringSocketInterfaceName));
+  ASSERT_NE(nullptr, factory);
+  EXPECT_EQ(factory, Network::SocketInterfaceSingleton::getExisting());
+}
+
+// Data flows in both directions, and is flushed when the upstream disconnects.
+TEST_P(IoUringIntegrationTest, TcpProxyUpstreamDisconnect) {
+  initialize();
+  IntegrationTcpClientPtr tcp_client = makeTcpConnection(lookupPort("tcp_proxy"));
+  ASSERT_TRUE(tcp_client->write("hello"));
+  FakeRawConnectionPtr fake_upstream_connection;
+  ASSERT_TRUE(fake_upstreams_[0]->waitForRawConnection(fake_upstream_connection));
+  ASSERT_TRUE(fake_upstream_connection->waitForData(5));
+  ASSERT_TRUE(fake_upstream_connection->write("world"));
+  ASSERT_TRUE(fake_upstream_connection->close());
+  ASSERT_TRUE(fake_upstream_connection->waitForDisconnect());
+  tcp_client->waitForHalfClose();
+  tcp_client->close();
+  EXPECT_EQ("world", tcp_client->data());
+}
+
+// Half closes are propagated once the data written ahead of them has been sent.
+TEST_P(IoUringIntegrationTest, TcpProxyHalfClose) {
+  initialize();
+  IntegrationTcpClientPtr tcp_client = makeTcpConnection(lookupPort("tcp_proxy"));
+  FakeRawConnectionPtr fake_upstream_connection;
+  ASSERT_TRUE(fake_upstreams_[0]->waitForRawConnection(fake_upstream_connection));
+  ASSERT_TRUE(fake_upstream_connection->write("hello", true));
+  tcp_client->waitForData("hello");
+  tcp_client->waitForHalfClose();
+  ASSERT_TRUE(tcp_client->write("world", true));
+  ASSERT_TRUE(fake_upstream_connection->waitForData(5));
+  ASSERT_TRUE(fake_upstream_connection->waitForHalfClose());
+  ASSERT_TRUE(fake_upstream_connection->waitForDisconnect());
+  tcp_client->waitForDisconnect();
+}
+
+// Payloads larger than the registered buffers and the write queue are proxied in full.
+TEST_P(IoUringIntegrationTest, TcpProxyLargePayload) {
+  initialize();
+  const std::string data(1024 * 1024, 'a');
+  IntegrationTcpClientPtr tcp_client = makeTcpConnection(lookupPort("tcp_proxy"));
+  ASSERT_TRUE(tcp_client->write(data));
+  FakeRawConnectionPtr fake_upstream_connection;
+  ASSERT_TRUE(fake_upstreams_[0]->waitForRawConnection(fake_upstream_connection));
+  std::string received;
+  ASSERT_TRUE(fake_upstream_connection->waitForData(data.size(), &received));
+  EXPECT_EQ(data, received);
+  ASSERT_TRUE(fake_upstream_connection->write(data));
+  ASSERT_TRUE(tcp_client->waitForData(data.size()));
+  EXPECT_EQ(data, tcp_client->data());
+  ASSERT_TRUE(fake_upstream_connection->close());
+  ASSERT_TRUE(fake_upstream_connection->waitForDisconnect());
+  tcp_client->waitForHalfClose();
+  tcp_client->close();
+}
+
+// Compares the throughput of the default and the io_uring socket interfaces when proxying a large
+// payload in each direction. The figures are only logged; the test checks the transfer itself.
+class IoUringThroughputTest
+    : public BaseIntegrationTest,
+      public testing::TestWithParam<std::tuple<Network::Address::IpVersion, absl::string_view>> {
+public:
+  IoUringThroughputTest()
+      : BaseIntegrationTest(std::get<0>(GetParam()),
+                            absl::StrCat(ConfigHelper::tcpProxyConfig(),
+                                         socketInterfaceConfig(std::get<1>(GetParam())))) {
+    enableHalfClose(true);
+  }
+
+  void SetUp() override {
+    if (std::get<1>(GetParam()) == IoUringSocketInterfaceName && !Ring::isSupported()) {
+      GTEST_SKIP() << "io_uring is not supported by the kernel";
+    }
+  }
+
+  static std::string
+  paramsToString(const testing::TestParamInfo<std::tuple<Network::Address::IpVersion,
+                                                         absl::string_view>>& params) {
+    return absl::StrCat(
+        std::get<0>(params.param) == Network::Address::IpVersion::v4 ? "IPv4_" : "IPv6_",
+        std::get<1>(params.param) == IoUringSocketInterfaceName ? "IoUring" : "Default");
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    IpVersionsAndSocketInterfaces, IoUringThroughputTest,
+    testing::Combine(testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
+                     testing::Values(DefaultSocketInterfaceName, IoUringSocketInterfaceName)),
+    IoUringThroughputTest::paramsToString);
+
+TEST_P(IoUringThroughputTest, TcpProxy) {
+  config_helper_.renameListener("tcp_proxy");
+  initialize();
+  const std::string data(16 * 1024 * 1024, 'a');
+
+  IntegrationTcpClientPtr tcp_client = makeTcpConnection(lookupPort("tcp_proxy"));
+  FakeRawConnectionPtr fake_upstream_connection;
+  ASSERT_TRUE(fake_upstreams_[0]->waitForRawConnection(fake_upstream_connection));
+
+  const auto start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(tcp_client->write(data));
+  ASSERT_TRUE(fake_upstream_connection->waitForData(data.size()));
+  const auto upstream = std::chrono::steady_clock::now();
+  ASSERT_TRUE(fake_upstream_connection->write(data));
+  ASSERT_TRUE(tcp_client->waitForData(data.size()));
+  const auto downstream = std::chrono::steady_clock::now();
+
+  const auto throughput = [&data](std::chrono::steady_clock::duration elapsed) {
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    return data.size() / seconds / (1024 * 1024);
+  };
+  ENVOY_LOG_MISC(info, "{}: upstream {:.1f} MiB/s, downstream {:.1f} MiB/s",
+                 std::get<1>(GetParam()), throughput(upstream - start),
+                 throughput(downstream - upstream));
+
+  ASSERT_TRUE(fake_upstream_connection->close());
+  ASSERT_TRUE(fake_upstream_connection->waitForDisconnect());
+  tcp_client->waitForHalfClose();
+  tcp_client->close();
+}
+
+} // namespace
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,128 @@
+#include <poll.h>
+
+#include <cstring>
+
+#include "extensions/network/socket_interface/io_uring/ring.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+namespace {
+
+class RingTest : public testing::Test {
+protected:
+  void SetUp() override {
+    if (!Ring::isSupported()) {
+      GTEST_SKIP() << "io_uring is not supported by the kernel";
+    }
+    ring_ = std::make_unique<Ring>(8, 4, 4096);
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds_));
+  }
+
+  void TearDown() override {
+    for (os_fd_t fd : fds_) {
+      if (SOCKET_VALID(fd)) {
+        ::close(fd);
+      }
+    }
+  }
+
+  // Wait for the completion of the operation with the given user data.
+  int32_t waitFor(uint64_t user_data) {
+    while (!results_.contains(user_data)) {
+      pollfd fds{ring_->fd(), POLLIN, 0};
+      EXPECT_EQ(1, ::poll(&fds, 1, 5000));
+      ring_->forEveryCompletion(
+          [this](uint64_t user_data, int32_t result) { results_[user_data] = result; });
+    }
+    return results_[user_data];
+  }
+
+  std::unique_ptr<Ring> ring_;
+  os_fd_t fds_[2]{INVALID_SOCKET, INVALID_SOCKET};
+  absl::flat_hash_map<uint64_t, int32_t> results_;
+};
+
+TEST_F(RingTest, ReadWriteRegisteredBuffers) {
+  const absl::optional<uint16_t> read_buffer = ring_->acquireBuffer();
+  ASSERT_TRUE(read_buffer.has_value());
+  ASSERT_TRUE(
+      ring_->prepareRead(fds_[0], ring_->buffer(*read_buffer), 4096, read_buffer, /*user_data=*/1));
+  EXPECT_EQ(1, ring_->pendingSubmissions());
+  EXPECT_EQ(1, ring_->submit());
+  EXPECT_EQ(0, ring_->pendingSubmissions());
+
+  const absl::optional<uint16_t> write_buffer = ring_->acquireBuffer();
+  ASSERT_TRUE(write_buffer.has_value());
+  EXPECT_NE(*read_buffer, *write_buffer);
+  memcpy(ring_->buffer(*write_buffer), "hello", 5);
+  ASSERT_TRUE(ring_->prepareWrite(fds_[1], ring_->buffer(*write_buffer), 5, write_buffer,
+                                  /*user_data=*/2));
+  ring_->submit();
+
+  EXPECT_EQ(5, waitFor(2));
+  EXPECT_EQ(5, waitFor(1));
+  EXPECT_EQ(0, memcmp(ring_->buffer(*read_buffer), "hello", 5));
+}
+
+TEST_F(RingTest, UnregisteredBuffer) {
+  char buffer[16];
+  ASSERT_TRUE(ring_->prepareRead(fds_[0], reinterpret_cast<uint8_t*>(buffer), sizeof(buffer),
+                                 absl::nullopt, /*user_data=*/1));
+  ring_->submit();
+  ASSERT_EQ(5, ::write(fds_[1], "hello", 5));
+  EXPECT_EQ(5, waitFor(1));
+  EXPECT_EQ(0, memcmp(buffer, "hello", 5));
+}
+
+TEST_F(RingTest, BufferPoolExhaustion) {
+  std::vector<uint16_t> buffers;
+  for (int i = 0; i < 4; ++i) {
+    const absl::optional<uint16_t> buffer = ring_->acquireBuffer();
+    ASSERT_TRUE(buffer.has_value());
+    buffers.push_back(*buffer);
+  }
+  EXPECT_FALSE(ring_->acquireBuffer().has_value());
+  ring_->releaseBuffer(buffers[2]);
+  EXPECT_EQ(buffers[2], ring_->acquireBuffer());
+}
+
+TEST_F(RingTest, CancelAndPoll) {
+  char buffer[16];
+  ASSERT_TRUE(ring_->prepareRead(fds_[0], reinterpret_cast<uint8_t*>(buffer), sizeof(buffer),
+                                 absl::nullopt, /*user_data=*/1));
+  ring_->submit();
+  ASSERT_TRUE(ring_->prepareCancel(/*target_user_data=*/1, /*user_data=*/2));
+  ring_->submit();
+  EXPECT_EQ(0, waitFor(2));
+  EXPECT_EQ(-ECANCELED, waitFor(1));
+
+  ASSERT_TRUE(ring_->preparePoll(fds_[0], POLLRDHUP, /*user_data=*/3));
+  ring_->submit();
+  ::close(fds_[1]);
+  fds_[1] = INVALID_SOCKET;
+  EXPECT_NE(0, waitFor(3) & POLLRDHUP);
+}
+
+TEST_F(RingTest, FullSubmissionQueue) {
+  uint64_t prepared = 0;
+  while (ring_->prepareCancel(/*target_user_data=*/1000, /*user_data=*/prepared)) {
+    ++prepared;
+  }
+  EXPECT_EQ(8, prepared);
+  EXPECT_EQ(8, ring_->submit());
+  for (uint64_t i = 0; i < prepared; ++i) {
+    EXPECT_EQ(-ENOENT, waitFor(i));
+  }
+  EXPECT_TRUE(ring_->prepareCancel(/*target_user_data=*/1000, /*user_data=*/prepared));
+}
+
+} // namespace
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,170 @@
+#include <fcntl.h>
+#include <sys/socket.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/network/socket_interface/io_uring/io_uring_socket_handle_impl.h"
+#include "extensions/network/socket_interface/io_uring/ring.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+namespace {
+
+class WorkerTest : public testing::Test {
+protected:
+  void SetUp() override {
+    if (!Ring::isSupported()) {
+      GTEST_SKIP() << "io_uring is not supported by the kernel";
+    }
+    api_ = Api::createApiForTest();
+    dispatcher_ = api_->allocateDispatcher("test_thread");
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds_));
+  }
+
+  void TearDown() override {
+    if (SOCKET_VALID(fds_[1])) {
+      ::close(fds_[1]);
+    }
+  }
+
+  static bool isOpen(os_fd_t fd) { return ::fcntl(fd, F_GETFD) != -1; }
+
+  // Run the event loop until the socket is closed.
+  void waitForClose(os_fd_t fd) {
+    for (int i = 0; i < 500 && isOpen(fd); ++i) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_FALSE(isOpen(fd));
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  const RingOptions options_{8, 4, 4096};
+  os_fd_t fds_[2]{INVALID_SOCKET, INVALID_SOCKET};
+};
+
+// The socket stays open while the read submitted on it is outstanding, so that its number cannot
+// be reused by a socket the read would then apply to.
+TEST_F(WorkerTest, CloseWaitsForOperations) {
+  auto handle = std::make_unique<IoUringSocketHandleImpl>(options_, fds_[0], false, absl::nullopt,
+                                                          /*connected=*/true);
+  handle->initializeFileEvent(
+      *dispatcher_, [](uint32_t) {}, Event::FileTriggerType::Edge, Event::FileReadyType::Read);
+  // Submit the read.
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+
+  EXPECT_TRUE(handle->close().ok());
+  EXPECT_FALSE(handle->isOpen());
+  EXPECT_TRUE(isOpen(fds_[0]));
+  waitForClose(fds_[0]);
+}
+
+// Releasing the last handle with a write outstanding does not block: the worker drains from the
+// event loop, and gives up on the write once the peer has not read for the drain timeout.
+TEST_F(WorkerTest, DrainDoesNotBlock) {
+  const int size = 1 << 20;
+  ASSERT_EQ(0, ::setsockopt(fds_[0], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size)));
+  auto handle = std::make_unique<IoUringSocketHandleImpl>(options_, fds_[0], false, absl::nullopt,
+                                                          /*connected=*/true);
+  handle->initializeFileEvent(
+      *dispatcher_, [](uint32_t) {}, Event::FileTriggerType::Edge, Event::FileReadyType::Write);
+  // Fill the socket buffers until a write is left waiting for the peer.
+  std::string data(options_.buffer_size_, 'a');
+  for (int i = 0; i < 1024; ++i) {
+    Buffer::RawSlice slice{data.data(), data.size()};
+    if (!handle->writev(&slice, 1).ok()) {
+      break;
+    }
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+
+  const MonotonicTime start = api_->timeSource().monotonicTime();
+  handle.reset();
+  EXPECT_LT(api_->timeSource().monotonicTime() - start, Worker::DrainTimeout);
+  EXPECT_TRUE(isOpen(fds_[0]));
+  waitForClose(fds_[0]);
+}
+
+// read() hands the registered buffer the data was received into to the buffer, which keeps it,
+// and the worker, alive after the handle is gone.
+TEST_F(WorkerTest, ReadHandsOverRegisteredBuffer) {
+  auto handle = std::make_unique<IoUringSocketHandleImpl>(options_, fds_[0], false, absl::nullopt,
+                                                          /*connected=*/true);
+  handle->initializeFileEvent(
+      *dispatcher_, [](uint32_t) {}, Event::FileTriggerType::Edge, Event::FileReadyType::Read);
+  ASSERT_EQ(5, ::write(fds_[1], "hello", 5));
+
+  Buffer::OwnedImpl buffer;
+  for (int i = 0; i < 500 && buffer.length() == 0; ++i) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    handle->read(buffer, 16384);
+  }
+  EXPECT_EQ("hello", buffer.toString());
+  std::shared_ptr<Worker> worker = Worker::get(*dispatcher_, options_);
+  bool registered = false;
+  for (uint16_t i = 0; i < options_.num_buffers_; ++i) {
+    registered |= buffer.frontSlice().mem_ == worker->ring().buffer(i);
+  }
+  EXPECT_TRUE(registered);
+
+  worker.reset();
+  handle.reset();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ("hello", buffer.toString());
+  buffer.drain(buffer.length());
+  waitForClose(fds_[0]);
+}
+
+// write() moves the slices of the buffer into the queued writes.
+TEST_F(WorkerTest, WriteMovesSlices) {
+  auto handle = std::make_unique<IoUringSocketHandleImpl>(options_, fds_[0], false, absl::nullopt,
+                                                          /*connected=*/true);
+  handle->initializeFileEvent(
+      *dispatcher_, [](uint32_t) {}, Event::FileTriggerType::Edge, Event::FileReadyType::Write);
+  const std::string data(3 * options_.buffer_size_, 'a');
+  Buffer::OwnedImpl buffer(data);
+  const Api::IoCallUint64Result result = handle->write(buffer);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(data.size(), result.rc_);
+  EXPECT_EQ(0, buffer.length());
+
+  std::string received;
+  char chunk[4096];
+  for (int i = 0; i < 500 && received.size() < data.size(); ++i) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    const ssize_t bytes = ::recv(fds_[1], chunk, sizeof(chunk), MSG_DONTWAIT);
+    if (bytes > 0) {
+      received.append(chunk, bytes);
+    }
+  }
+  EXPECT_EQ(data, received);
+}
+
+// A worker is created for a dispatcher again once the previous one has been released.
+TEST_F(WorkerTest, WorkerPerDispatcher) {
+  std::shared_ptr<Worker> worker = Worker::get(*dispatcher_, options_);
+  EXPECT_EQ(worker, Worker::get(*dispatcher_, options_));
+  std::weak_ptr<Worker> released = worker;
+  worker.reset();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  worker = Worker::get(*dispatcher_, options_);
+  EXPECT_NE(nullptr, worker);
+  EXPECT_TRUE(released.expired());
+}
+
+} // namespace
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
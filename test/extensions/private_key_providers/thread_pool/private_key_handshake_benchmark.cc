@@ -0,0 +1,203 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/singleton/manager_impl.h"
+
+#include "extensions/private_key_providers/thread_pool/thread_pool_private_key_provider.h"
+
+#include "test/mocks/server/transport_socket_factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "openssl/ssl.h"
+#include "tools/cpp/runfiles/runfiles.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+
+// Where the server performs the private key operations in testHandshakeUnderLoad.
+enum class Signing { Inline, ThreadPool };
+
+// The number of handshakes in progress on the worker in each iteration.
+constexpr int NumConcurrentHandshakes = 4;
+
+static std::string testDataPath(const std::string& file) {
+  std::string error;
+  static std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create("private_key_handshake_benchmark", &error));
+  TestEnvironment::setRunfiles(runfiles.get());
+  return TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + file);
+}
+
+// A handshake between a client and a server connected over a UNIX domain socket pair, which
+// progresses in callbacks posted to the worker as the other connections of a worker would.
+class Handshake : public Ssl::PrivateKeyConnectionCallbacks {
+public:
+  Handshake(SSL_CTX* client_ctx, SSL_CTX* server_ctx, Event::Dispatcher& dispatcher,
+            ThreadPoolPrivateKeyMethodProvider* provider, std::function<void()> on_done)
+      : dispatcher_(dispatcher), provider_(provider), on_done_(std::move(on_done)) {
+    RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets_) == 0,
+                   "socketpair");
+    server_ssl_.reset(SSL_new(server_ctx));
+    SSL_set_fd(server_ssl_.get(), sockets_[0]);
+    SSL_set_accept_state(server_ssl_.get());
+    client_ssl_.reset(SSL_new(client_ctx));
+    SSL_set_fd(client_ssl_.get(), sockets_[1]);
+    SSL_set_connect_state(client_ssl_.get());
+    if (provider_ != nullptr) {
+      provider_->registerPrivateKeyMethod(server_ssl_.get(), *this, dispatcher_);
+    }
+  }
+
+  ~Handshake() override {
+    if (provider_ != nullptr) {
+      provider_->unregisterPrivateKeyMethod(server_ssl_.get());
+    }
+    ::close(sockets_[0]);
+    ::close(sockets_[1]);
+  }
+
+  void start() {
+    dispatcher_.post([this]() { step(); });
+  }
+
+  // Ssl::PrivateKeyConnectionCallbacks
+  void onPrivateKeyMethodComplete() override { step(); }
+
+private:
+  void step() {
+    const int client_result = SSL_do_handshake(client_ssl_.get());
+    const int server_result = SSL_do_handshake(server_ssl_.get());
+    if (client_result == 1 && server_result == 1) {
+      on_done_();
+      return;
+    }
+    const int server_error = SSL_get_error(server_ssl_.get(), server_result);
+    if (server_error == SSL_ERROR_WANT_PRIVATE_KEY_OPERATION) {
+      // Resumed by onPrivateKeyMethodComplete().
+      return;
+    }
+    RELEASE_ASSERT(server_error == SSL_ERROR_WANT_READ || server_error == SSL_ERROR_WANT_WRITE,
+                   "Unexpected error during handshake");
+    dispatcher_.post([this]() { step(); });
+  }
+
+  Event::Dispatcher& dispatcher_;
+  ThreadPoolPrivateKeyMethodProvider* const provider_;
+  const std::function<void()> on_done_;
+  bssl::UniquePtr<SSL> server_ssl_;
+  bssl::UniquePtr<SSL> client_ssl_;
+  int sockets_[2];
+};
+
+// Completes batches of TLS handshakes with a 4096 bit RSA certificate on a worker, while the
+// worker also runs a stream of short callbacks standing for the requests of its established
+// connections. The argument is the Signing mode: the signatures are performed either inline on
+// the worker (0), as without a private key provider, or by the thread pool provider (1). Reports
+// how long the callbacks waited behind the handshakes.
+static void testHandshakeUnderLoad(benchmark::State& state) {
+  const auto signing = static_cast<Signing>(state.range(0));
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("worker");
+
+  bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
+  RELEASE_ASSERT(SSL_CTX_use_certificate_file(server_ctx.get(),
+                                              testDataPath("selfsigned_rsa_4096_cert.pem").c_str(),
+                                              SSL_FILETYPE_PEM) == 1,
+                 "SSL_CTX_use_certificate_file");
+  // Every handshake is a full one.
+  SSL_CTX_set_options(server_ctx.get(), SSL_OP_NO_TICKET);
+  SSL_CTX_set_session_cache_mode(server_ctx.get(), SSL_SESS_CACHE_OFF);
+
+  Singleton::ManagerImpl singleton_manager(api->threadFactory());
+  testing::NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(testing::ReturnRef(*api));
+  ON_CALL(factory_context, singletonManager())
+      .WillByDefault(testing::ReturnRef(singleton_manager));
+  std::unique_ptr<ThreadPoolPrivateKeyMethodProvider> provider;
+  switch (signing) {
+  case Signing::Inline:
+    RELEASE_ASSERT(SSL_CTX_use_PrivateKey_file(server_ctx.get(),
+                                               testDataPath("selfsigned_rsa_4096_key.pem").c_str(),
+                                               SSL_FILETYPE_PEM) == 1,
+                   "SSL_CTX_use_PrivateKey_file");
+    break;
+  case Signing::ThreadPool: {
+    envoy::extensions::private_key_providers::thread_pool::v3alpha::
+        ThreadPoolPrivateKeyMethodConfig config;
+    config.mutable_private_key()->set_filename(testDataPath("selfsigned_rsa_4096_key.pem"));
+    config.mutable_thread_count()->set_value(2);
+    provider = std::make_unique<ThreadPoolPrivateKeyMethodProvider>(config, factory_context);
+    SSL_CTX_set_private_key_method(server_ctx.get(),
+                                   provider->getBoringSslPrivateKeyMethod().get());
+    break;
+  }
+  }
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+
+  TimeSource& time_source = api->timeSource();
+  std::vector<std::chrono::microseconds> delays;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    int pending_handshakes = NumConcurrentHandshakes;
+    std::vector<std::unique_ptr<Handshake>> handshakes;
+    for (int i = 0; i < NumConcurrentHandshakes; ++i) {
+      handshakes.push_back(std::make_unique<Handshake>(
+          client_ctx.get(), server_ctx.get(), *dispatcher, provider.get(), [&]() {
+            if (--pending_handshakes == 0) {
+              dispatcher->exit();
+            }
+          }));
+      handshakes.back()->start();
+    }
+
+    // Each callback posts the next one, until the handshakes complete.
+    std::function<void()> post_request = [&]() {
+      const MonotonicTime posted = time_source.monotonicTime();
+      dispatcher->post([&, posted]() {
+        delays.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+            time_source.monotonicTime() - posted));
+        if (pending_handshakes > 0) {
+          post_request();
+        }
+      });
+    };
+    post_request();
+
+    dispatcher->run(Event::Dispatcher::RunType::RunUntilExit);
+    // Run the last request callback.
+    dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+  }
+
+  state.counters["handshakes"] = benchmark::Counter(state.iterations() * NumConcurrentHandshakes,
+                                                    benchmark::Counter::kIsRate);
+  if (!delays.empty()) {
+    std::sort(delays.begin(), delays.end());
+    state.counters["request_delay_p50_us"] = delays[delays.size() / 2].count();
+    state.counters["request_delay_p99_us"] = delays[delays.size() * 99 / 100].count();
+    state.counters["request_delay_max_us"] = delays.back().count();
+  }
+}
+
+BENCHMARK(testHandshakeUnderLoad)
+    ->Unit(::benchmark::kMillisecond)
+    ->UseRealTime()
+    ->Arg(static_cast<int64_t>(Signing::Inline))
+    ->Arg(static_cast<int64_t>(Signing::ThreadPool));
+
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
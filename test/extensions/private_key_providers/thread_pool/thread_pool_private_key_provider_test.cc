@@ -0,0 +1,221 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/private_key_providers/thread_pool/v3alpha/thread_pool.pb.h"
+#include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
+#include "envoy/registry/registry.h"
+#include "envoy/ssl/private_key/private_key_config.h"
+
+#include "common/singleton/manager_impl.h"
+
+#include "extensions/private_key_providers/thread_pool/config.h"
+#include "extensions/private_key_providers/thread_pool/thread_pool_private_key_provider.h"
+
+#include "test/mocks/server/transport_socket_factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+using testing::Invoke;
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace ThreadPool {
+namespace {
+
+class MockPrivateKeyConnectionCallbacks : public Ssl::PrivateKeyConnectionCallbacks {
+public:
+  MOCK_METHOD(void, onPrivateKeyMethodComplete, ());
+};
+
+class ThreadPoolPrivateKeyMethodProviderTest : public testing::Test {
+public:
+  ThreadPoolPrivateKeyMethodProviderTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")) {
+    ON_CALL(factory_context_, api()).WillByDefault(ReturnRef(*api_));
+    ON_CALL(factory_context_, singletonManager()).WillByDefault(ReturnRef(singleton_manager_));
+  }
+
+  std::shared_ptr<ThreadPoolPrivateKeyMethodProvider> createProvider(const std::string& key,
+                                                                     uint32_t thread_count = 2) {
+    const std::string yaml = fmt::format(R"EOF(
+private_key:
+  filename: "{{{{ test_rundir }}}}/test/extensions/transport_sockets/tls/test_data/{}_key.pem"
+thread_count: {}
+)EOF",
+                                         key, thread_count);
+    envoy::extensions::private_key_providers::thread_pool::v3alpha::
+        ThreadPoolPrivateKeyMethodConfig config;
+    TestUtility::loadFromYaml(TestEnvironment::substitute(yaml), config);
+    return std::make_shared<ThreadPoolPrivateKeyMethodProvider>(config, factory_context_);
+  }
+
+  // Sets up a server using the provider for the certificate of the given key, and a client
+  // connected to it over a UNIX domain socket pair.
+  void connect(ThreadPoolPrivateKeyMethodProvider& provider, const std::string& key) {
+    server_ctx_.reset(SSL_CTX_new(TLS_method()));
+    const std::string cert_path = TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + key + "_cert.pem");
+    ASSERT_EQ(1, SSL_CTX_use_certificate_file(server_ctx_.get(), cert_path.c_str(),
+                                              SSL_FILETYPE_PEM));
+    SSL_CTX_set_private_key_method(server_ctx_.get(),
+                                   provider.getBoringSslPrivateKeyMethod().get());
+    client_ctx_.reset(SSL_CTX_new(TLS_method()));
+
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets_));
+    server_ssl_.reset(SSL_new(server_ctx_.get()));
+    SSL_set_fd(server_ssl_.get(), sockets_[0]);
+    SSL_set_accept_state(server_ssl_.get());
+    client_ssl_.reset(SSL_new(client_ctx_.get()));
+    SSL_set_fd(client_ssl_.get(), sockets_[1]);
+    SSL_set_connect_state(client_ssl_.get());
+
+    provider.registerPrivateKeyMethod(server_ssl_.get(), callbacks_, *dispatcher_);
+  }
+
+  // Drives the handshake until the server waits for a private key operation or the handshake
+  // completes. Returns whether it completed.
+  bool handshakeUntilPrivateKeyOperation() {
+    for (int i = 0; i < 10; i++) {
+      const int client_result = SSL_do_handshake(client_ssl_.get());
+      const int server_result = SSL_do_handshake(server_ssl_.get());
+      if (client_result == 1 && server_result == 1) {
+        return true;
+      }
+      const int server_error = SSL_get_error(server_ssl_.get(), server_result);
+      if (server_error == SSL_ERROR_WANT_PRIVATE_KEY_OPERATION) {
+        return false;
+      }
+      EXPECT_TRUE(server_error == SSL_ERROR_WANT_READ || server_error == SSL_ERROR_WANT_WRITE);
+    }
+    ADD_FAILURE() << "handshake did not progress";
+    return false;
+  }
+
+  // Completes the handshake, waiting on the dispatcher for the private key operations.
+  void handshake() {
+    ON_CALL(callbacks_, onPrivateKeyMethodComplete()).WillByDefault(Invoke([this]() {
+      dispatcher_->exit();
+    }));
+    EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).Times(testing::AtLeast(1));
+    while (!handshakeUntilPrivateKeyOperation()) {
+      dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+    }
+  }
+
+  void TearDown() override {
+    if (sockets_[0] != -1) {
+      ::close(sockets_[0]);
+      ::close(sockets_[1]);
+    }
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Singleton::ManagerImpl singleton_manager_{Thread::threadFactoryForTest()};
+  NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context_;
+  NiceMock<MockPrivateKeyConnectionCallbacks> callbacks_;
+  bssl::UniquePtr<SSL_CTX> server_ctx_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  bssl::UniquePtr<SSL> server_ssl_;
+  bssl::UniquePtr<SSL> client_ssl_;
+  int sockets_[2]{-1, -1};
+};
+
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, FactoryCreatesProvider) {
+  auto* factory =
+      Registry::FactoryRegistry<Ssl::PrivateKeyMethodProviderInstanceFactory>::getFactory(
+          "thread_pool");
+  ASSERT_NE(nullptr, factory);
+
+  const std::string yaml = R"EOF(
+provider_name: thread_pool
+typed_config:
+  "@type": type.googleapis.com/envoy.extensions.private_key_providers.thread_pool.v3alpha.ThreadPoolPrivateKeyMethodConfig
+  private_key:
+    filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_key.pem"
+  thread_count: 1
+)EOF";
+  envoy::extensions::transport_sockets::tls::v3::PrivateKeyProvider config;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(yaml), config);
+  Ssl::PrivateKeyMethodProviderSharedPtr provider =
+      factory->createPrivateKeyMethodProviderInstance(config, factory_context_);
+  ASSERT_NE(nullptr, provider);
+  EXPECT_NE(nullptr, provider->getBoringSslPrivateKeyMethod());
+}
+
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, InvalidPrivateKey) {
+  envoy::extensions::private_key_providers::thread_pool::v3alpha::ThreadPoolPrivateKeyMethodConfig
+      config;
+  config.mutable_private_key()->set_inline_string("not a private key");
+  EXPECT_THROW_WITH_MESSAGE(ThreadPoolPrivateKeyMethodProvider(config, factory_context_),
+                            EnvoyException,
+                            "Failed to load private key for the thread pool private key provider");
+}
+
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, ProvidersShareThreadPools) {
+  auto provider = createProvider("unittest");
+  auto same_thread_count = createProvider("selfsigned_ecdsa_p256");
+  auto other_thread_count = createProvider("unittest", 1);
+  EXPECT_EQ(&provider->threadPool(), &same_thread_count->threadPool());
+  EXPECT_NE(&provider->threadPool(), &other_thread_count->threadPool());
+
+  // The pool outlives the provider which created it.
+  provider.reset();
+  connect(*same_thread_count, "selfsigned_ecdsa_p256");
+  handshake();
+  same_thread_count->unregisterPrivateKeyMethod(server_ssl_.get());
+}
+
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, RsaSignature) {
+  auto provider = createProvider("unittest");
+  connect(*provider, "unittest");
+  handshake();
+  provider->unregisterPrivateKeyMethod(server_ssl_.get());
+}
+
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, RsaDecryption) {
+  auto provider = createProvider("unittest");
+  connect(*provider, "unittest");
+  // The RSA key exchange of TLS 1.2 has the server decrypt the premaster secret.
+  ASSERT_EQ(1, SSL_set_max_proto_version(client_ssl_.get(), TLS1_2_VERSION));
+  ASSERT_EQ(1, SSL_set_cipher_list(client_ssl_.get(), "AES128-GCM-SHA256"));
+  handshake();
+  provider->unregisterPrivateKeyMethod(server_ssl_.get());
+}
+
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, EcdsaSignature) {
+  auto provider = createProvider("selfsigned_ecdsa_p256");
+  connect(*provider, "selfsigned_ecdsa_p256");
+  handshake();
+  provider->unregisterPrivateKeyMethod(server_ssl_.get());
+}
+
+// Connections closed while their operation is executed are not notified of its completion.
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, CloseWhilePending) {
+  auto provider = createProvider("unittest");
+  connect(*provider, "unittest");
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).Times(0);
+  ASSERT_FALSE(handshakeUntilPrivateKeyOperation());
+  provider->unregisterPrivateKeyMethod(server_ssl_.get());
+  // Destroying the last provider using the pool joins its threads, so the operation has either
+  // been executed and its completion posted, or dropped.
+  provider.reset();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+}
+
+} // namespace
+} // namespace ThreadPool
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,57 @@
+#include "envoy/extensions/resource_monitors/buffer_memory/v3alpha/buffer_memory.pb.h"
+
+#include "common/buffer/watermark_buffer.h"
+
+#include "extensions/resource_monitors/buffer_memory/buffer_memory_monitor.h"
+
+#include "absl/types/optional.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace BufferMemoryMonitor {
+namespace {
+
+class ResourcePressure : public Server::ResourceMonitor::Callbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+  }
+
+  void onFailure(const EnvoyException& error) override { error_ = error; }
+
+  bool hasPressure() const { return pressure_.has_value(); }
+  bool hasError() const { return error_.has_value(); }
+
+  double pressure() const { return *pressure_; }
+
+private:
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+TEST(BufferMemoryMonitorTest, ComputesUsageFromWatermarkBuffers) {
+  envoy::extensions::resource_monitors::buffer_memory::v3alpha::BufferMemoryConfig config;
+  config.set_max_buffer_memory_bytes(1000);
+  BufferMemoryMonitor monitor(config);
+  const uint64_t initial_bytes = Buffer::WatermarkBufferAccounting::bytes();
+
+  Buffer::WatermarkBuffer buffer{[]() -> void {}, []() -> void {}, []() -> void {}};
+  buffer.add(std::string(400, 'a'));
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  EXPECT_TRUE(resource.hasPressure());
+  EXPECT_FALSE(resource.hasError());
+  EXPECT_DOUBLE_EQ((initial_bytes + 400) / 1000.0, resource.pressure());
+
+  buffer.drain(300);
+  monitor.updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ((initial_bytes + 100) / 1000.0, resource.pressure());
+}
+
+} // namespace
+} // namespace BufferMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,117 @@
+#include <chrono>
+#include <string>
+
+#include "extensions/transport_sockets/tls/session_cache.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class ShardedSessionCacheTest : public testing::Test, public Event::TestUsingSimulatedTime {
+public:
+  ShardedSessionCacheTest() : ssl_ctx_(SSL_CTX_new(TLS_method())) {}
+
+  // Returns a session established now, with a lifetime of 10 seconds.
+  bssl::UniquePtr<SSL_SESSION> newSession(const std::string& session_id_context,
+                                          const std::string& session_id) {
+    bssl::UniquePtr<SSL_SESSION> session(SSL_SESSION_new(ssl_ctx_.get()));
+    EXPECT_EQ(1, SSL_SESSION_set1_id_context(
+                     session.get(), reinterpret_cast<const uint8_t*>(session_id_context.data()),
+                     session_id_context.size()));
+    EXPECT_EQ(1, SSL_SESSION_set1_id(session.get(),
+                                     reinterpret_cast<const uint8_t*>(session_id.data()),
+                                     session_id.size()));
+    SSL_SESSION_set_time(session.get(), std::chrono::duration_cast<std::chrono::seconds>(
+                                            simTime().systemTime().time_since_epoch())
+                                            .count());
+    SSL_SESSION_set_timeout(session.get(), 10);
+    return session;
+  }
+
+  bssl::UniquePtr<SSL_SESSION> lookup(SessionCache& cache, const std::string& session_id_context,
+                                      const std::string& session_id) {
+    return cache.lookup(
+        {reinterpret_cast<const uint8_t*>(session_id_context.data()), session_id_context.size()},
+        {reinterpret_cast<const uint8_t*>(session_id.data()), session_id.size()});
+  }
+
+  bssl::UniquePtr<SSL_CTX> ssl_ctx_;
+};
+
+TEST_F(ShardedSessionCacheTest, LookupBySessionIdAndContext) {
+  ShardedSessionCache cache(simTime(), 4, 16);
+  EXPECT_EQ(nullptr, lookup(cache, "context1", "session1"));
+
+  bssl::UniquePtr<SSL_SESSION> session = newSession("context1", "session1");
+  SSL_SESSION* inserted = session.get();
+  cache.insert(std::move(session));
+  EXPECT_EQ(1, cache.size());
+  EXPECT_EQ(inserted, lookup(cache, "context1", "session1").get());
+
+  // Contexts do not resume the sessions of other contexts, even if the session IDs are the same.
+  EXPECT_EQ(nullptr, lookup(cache, "context2", "session1"));
+  EXPECT_EQ(nullptr, lookup(cache, "context1", "session2"));
+  // The session ID context length is part of the key.
+  EXPECT_EQ(nullptr, lookup(cache, "context1s", "ession1"));
+
+  cache.insert(newSession("context2", "session1"));
+  EXPECT_EQ(2, cache.size());
+  EXPECT_NE(nullptr, lookup(cache, "context2", "session1"));
+  EXPECT_EQ(inserted, lookup(cache, "context1", "session1").get());
+}
+
+TEST_F(ShardedSessionCacheTest, SessionsExpire) {
+  ShardedSessionCache cache(simTime(), 4, 16);
+  cache.insert(newSession("context", "session"));
+
+  simTime().advanceTimeWait(std::chrono::seconds(9));
+  EXPECT_NE(nullptr, lookup(cache, "context", "session"));
+
+  simTime().advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_EQ(nullptr, lookup(cache, "context", "session"));
+  EXPECT_EQ(0, cache.size());
+
+  // Inserting again replaces the session.
+  cache.insert(newSession("context", "session"));
+  simTime().advanceTimeWait(std::chrono::seconds(5));
+  cache.insert(newSession("context", "session"));
+  simTime().advanceTimeWait(std::chrono::seconds(9));
+  EXPECT_NE(nullptr, lookup(cache, "context", "session"));
+  EXPECT_EQ(1, cache.size());
+}
+
+TEST_F(ShardedSessionCacheTest, EvictsLeastRecentlyUsed) {
+  // A single shard, so that all sessions compete for the same two entries.
+  ShardedSessionCache cache(simTime(), 1, 2);
+  cache.insert(newSession("context", "session1"));
+  cache.insert(newSession("context", "session2"));
+  // Resuming the first session makes the second one the least recently used.
+  EXPECT_NE(nullptr, lookup(cache, "context", "session1"));
+
+  cache.insert(newSession("context", "session3"));
+  EXPECT_EQ(2, cache.size());
+  EXPECT_NE(nullptr, lookup(cache, "context", "session1"));
+  EXPECT_EQ(nullptr, lookup(cache, "context", "session2"));
+  EXPECT_NE(nullptr, lookup(cache, "context", "session3"));
+}
+
+TEST_F(ShardedSessionCacheTest, ShardsHoldTheirShareOfSessions) {
+  ShardedSessionCache cache(simTime(), 4, 16);
+  for (int i = 0; i < 64; ++i) {
+    cache.insert(newSession("context", "session" + std::to_string(i)));
+  }
+  EXPECT_EQ(16, cache.size());
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,229 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+#include "common/event/real_time_system.h"
+
+#include "extensions/transport_sockets/tls/session_cache.h"
+
+#include "test/test_common/environment.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "benchmark/benchmark.h"
+#include "openssl/err.h"
+#include "openssl/ssl.h"
+#include "tools/cpp/runfiles/runfiles.h"
+
+namespace Envoy {
+namespace Extensions::TransportSockets::Tls {
+
+// How the client connects to the server in each iteration of testHandshake.
+enum class Resumption { None, SessionCache, Ticket };
+
+static const uint8_t SessionIdContext[] = "tls_handshake_benchmark";
+
+static void drainErrorQueue() {
+  while (uint64_t err = ERR_get_error()) {
+    ENVOY_LOG_MISC(error, "{}:{}:{}:{}", err, ERR_lib_error_string(err),
+                   ERR_func_error_string(err), ERR_reason_error_string(err));
+  }
+}
+
+static void handleSslError(SSL* ssl, int err, bool is_server) {
+  int error = SSL_get_error(ssl, err);
+  switch (error) {
+  case SSL_ERROR_NONE:
+  case SSL_ERROR_WANT_READ:
+  case SSL_ERROR_WANT_WRITE:
+    return;
+  default:
+    drainErrorQueue();
+    ENVOY_LOG_MISC(error, "is_server {} handshake err {} SSL_get_error {}", is_server, err, error);
+    PANIC("Unexpected error during handshake");
+  }
+}
+
+static Event::RealTimeSystem& timeSystem() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(Event::RealTimeSystem);
+}
+
+static bssl::UniquePtr<SSL_CTX> newServerContext() {
+  std::string error;
+  static std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+      bazel::tools::cpp::runfiles::Runfiles::Create("tls_handshake_benchmark", &error));
+  Envoy::TestEnvironment::setRunfiles(runfiles.get());
+
+  bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
+  std::string cert_path = TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem");
+  std::string key_path = TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_key.pem");
+  auto err = SSL_CTX_use_certificate_file(server_ctx.get(), cert_path.c_str(), SSL_FILETYPE_PEM);
+  drainErrorQueue();
+  RELEASE_ASSERT(err > 0, "SSL_CTX_use_certificate_file");
+  err = SSL_CTX_use_PrivateKey_file(server_ctx.get(), key_path.c_str(), SSL_FILETYPE_PEM);
+  RELEASE_ASSERT(err > 0, "SSL_CTX_use_PrivateKey_file");
+  err = SSL_CTX_set_session_id_context(server_ctx.get(), SessionIdContext,
+                                       sizeof(SessionIdContext));
+  RELEASE_ASSERT(err > 0, "SSL_CTX_set_session_id_context");
+  return server_ctx;
+}
+
+// Stores the sessions established by a server context in a ShardedSessionCache, as
+// ServerContextImpl does when configured with shared_session_cache.
+static void useSessionCache(SSL_CTX* server_ctx, ShardedSessionCache& cache) {
+  SSL_CTX_set_app_data(server_ctx, &cache);
+  SSL_CTX_set_session_cache_mode(server_ctx, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+  SSL_CTX_sess_set_new_cb(server_ctx, [](SSL* ssl, SSL_SESSION* session) -> int {
+    static_cast<ShardedSessionCache*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))
+        ->insert(bssl::UniquePtr<SSL_SESSION>(session));
+    return 1;
+  });
+  SSL_CTX_sess_set_get_cb(server_ctx,
+                          [](SSL* ssl, const uint8_t* session_id, int session_id_length,
+                             int* out_copy) -> SSL_SESSION* {
+                            *out_copy = 0;
+                            return static_cast<ShardedSessionCache*>(
+                                       SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))
+                                ->lookup(SessionIdContext,
+                                         absl::MakeConstSpan(session_id, session_id_length))
+                                .release();
+                          });
+}
+
+// Connects a client to the server over a UNIX domain socket pair and completes the handshake.
+// Returns the session established by the client.
+static bssl::UniquePtr<SSL_SESSION>
+connectAndHandshake(SSL_CTX* client_ctx, SSL_CTX* server_ctx, SSL_SESSION* session) {
+  int sockets[2];
+  RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets) == 0, "socketpair");
+
+  bssl::UniquePtr<SSL> server_ssl(SSL_new(server_ctx));
+  SSL_set_fd(server_ssl.get(), sockets[0]);
+  SSL_set_accept_state(server_ssl.get());
+
+  bssl::UniquePtr<SSL> client_ssl(SSL_new(client_ctx));
+  SSL_set_fd(client_ssl.get(), sockets[1]);
+  SSL_set_connect_state(client_ssl.get());
+  if (session != nullptr) {
+    SSL_set_session(client_ssl.get(), session);
+  }
+
+  bool handshake_success = false;
+  for (int i = 0; i < 50; i++) {
+    int client_err = SSL_do_handshake(client_ssl.get());
+    int server_err = SSL_do_handshake(server_ssl.get());
+    if (client_err == 1 && server_err == 1) {
+      handshake_success = true;
+      break;
+    }
+    handleSslError(client_ssl.get(), client_err, false);
+    handleSslError(server_ssl.get(), server_err, true);
+  }
+  RELEASE_ASSERT(handshake_success, "handshake completed successfully");
+  RELEASE_ASSERT(session == nullptr || SSL_session_reused(server_ssl.get()), "session reused");
+
+  ::close(sockets[0]);
+  ::close(sockets[1]);
+  return bssl::UniquePtr<SSL_SESSION>(SSL_get1_session(client_ssl.get()));
+}
+
+// Completes TLS 1.2 handshakes between a client and a server, either full ones or ones resuming
+// the session established by a first full handshake. The first argument is the Resumption mode:
+// none (0), by session ID from a ShardedSessionCache (1), or by session ticket (2). Session ID
+// resumption disables tickets, as the server would otherwise prefer them.
+static void testHandshake(benchmark::State& state) {
+  const auto resumption = static_cast<Resumption>(state.range(0));
+
+  bssl::UniquePtr<SSL_CTX> server_ctx = newServerContext();
+  ShardedSessionCache cache(timeSystem(), 16, 20 * 1024);
+  switch (resumption) {
+  case Resumption::None:
+    SSL_CTX_set_options(server_ctx.get(), SSL_OP_NO_TICKET);
+    SSL_CTX_set_session_cache_mode(server_ctx.get(), SSL_SESS_CACHE_OFF);
+    break;
+  case Resumption::SessionCache:
+    SSL_CTX_set_options(server_ctx.get(), SSL_OP_NO_TICKET);
+    useSessionCache(server_ctx.get(), cache);
+    break;
+  case Resumption::Ticket:
+    break;
+  }
+
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+  RELEASE_ASSERT(SSL_CTX_set_max_proto_version(client_ctx.get(), TLS1_2_VERSION), "");
+  bssl::UniquePtr<SSL_SESSION> session =
+      connectAndHandshake(client_ctx.get(), server_ctx.get(), nullptr);
+  if (resumption == Resumption::None) {
+    session.reset();
+  }
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    connectAndHandshake(client_ctx.get(), server_ctx.get(), session.get());
+  }
+  state.counters["handshakes"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(testHandshake)
+    ->Unit(::benchmark::kMicrosecond)
+    ->Arg(static_cast<int64_t>(Resumption::None))
+    ->Arg(static_cast<int64_t>(Resumption::SessionCache))
+    ->Arg(static_cast<int64_t>(Resumption::Ticket));
+
+// The number of sessions looked up concurrently by testSessionCacheLookup.
+constexpr uint32_t NumCachedSessions = 1024;
+
+// Returns a cache with the given number of shards, holding NumCachedSessions sessions whose IDs
+// are their index.
+static ShardedSessionCache& populatedCache(uint32_t num_shards) {
+  static bssl::UniquePtr<SSL_CTX> ssl_ctx(SSL_CTX_new(TLS_method()));
+  static absl::Mutex mutex;
+  static absl::flat_hash_map<uint32_t, std::unique_ptr<ShardedSessionCache>> caches;
+  absl::MutexLock lock(&mutex);
+  std::unique_ptr<ShardedSessionCache>& cache = caches[num_shards];
+  if (cache == nullptr) {
+    // Leave room for the shards holding more than their share of the sessions.
+    cache =
+        std::make_unique<ShardedSessionCache>(timeSystem(), num_shards, 2 * NumCachedSessions);
+    const uint64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                             timeSystem().systemTime().time_since_epoch())
+                             .count();
+    for (uint32_t i = 0; i < NumCachedSessions; ++i) {
+      bssl::UniquePtr<SSL_SESSION> session(SSL_SESSION_new(ssl_ctx.get()));
+      SSL_SESSION_set1_id(session.get(), reinterpret_cast<const uint8_t*>(&i), sizeof(i));
+      SSL_SESSION_set_time(session.get(), now);
+      SSL_SESSION_set_timeout(session.get(), 3600);
+      cache->insert(std::move(session));
+    }
+  }
+  return *cache;
+}
+
+// Looks up cached sessions from several threads, as the handshakes on all workers do. The
+// argument is the number of shards of the cache, 1 being a single lock for all sessions as in the
+// internal cache of a BoringSSL context.
+static void testSessionCacheLookup(benchmark::State& state) {
+  ShardedSessionCache& cache = populatedCache(state.range(0));
+  uint32_t i = state.thread_index;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    const uint32_t session_id = i++ % NumCachedSessions;
+    benchmark::DoNotOptimize(
+        cache.lookup({}, {reinterpret_cast<const uint8_t*>(&session_id), sizeof(session_id)}));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(testSessionCacheLookup)->Arg(1)->Arg(16)->ThreadRange(1, 16)->UseRealTime();
+
+} // namespace Extensions::TransportSockets::Tls
+} // namespace Envoy
@@ -1,4 +1,12 @@
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
 #include "common/buffer/buffer_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+
+#include "extensions/transport_sockets/tls/kernel_tls.h"
+#include "extensions/transport_sockets/tls/utility.h"
 
 #include "test/test_common/environment.h"
 
@@ -70,17 +78,13 @@ static void addFullSlices(Buffer::Instance& output_buffer, int num_slices, bool
   }
 }
 
-static void testThroughput(benchmark::State& state) {
+static bssl::UniquePtr<SSL_CTX> newServerContext() {
   std::string error;
-  std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
+  static std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
       bazel::tools::cpp::runfiles::Runfiles::Create("tls_throughput_benchmark", &error));
   Envoy::TestEnvironment::setRunfiles(runfiles.get());
 
-  int sockets[2];
-  socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets);
-
   bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
-  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
   std::string cert_path = TestEnvironment::substitute(
       "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem");
   std::string key_path = TestEnvironment::substitute(
@@ -90,28 +94,41 @@ static void testThroughput(benchmark::State& state) {
   RELEASE_ASSERT(err > 0, "SSL_CTX_use_certificate_file");
   err = SSL_CTX_use_PrivateKey_file(server_ctx.get(), key_path.c_str(), SSL_FILETYPE_PEM);
   RELEASE_ASSERT(err > 0, "SSL_CTX_use_PrivateKey_file");
+  return server_ctx;
+}
 
-  bssl::UniquePtr<SSL> server_ssl(SSL_new(server_ctx.get()));
-  SSL_set_fd(server_ssl.get(), sockets[0]);
-  SSL_set_accept_state(server_ssl.get());
-
-  bssl::UniquePtr<SSL> client_ssl(SSL_new(client_ctx.get()));
-  SSL_set_fd(client_ssl.get(), sockets[1]);
-  SSL_set_connect_state(client_ssl.get());
-
+static void doHandshake(SSL* client_ssl, SSL* server_ssl) {
   bool handshake_success = false;
   for (int i = 0; i < 50; i++) {
-    int client_err = SSL_do_handshake(client_ssl.get());
-    int server_err = SSL_do_handshake(server_ssl.get());
+    int client_err = SSL_do_handshake(client_ssl);
+    int server_err = SSL_do_handshake(server_ssl);
     if (client_err == 1 && server_err == 1) {
       handshake_success = true;
       break;
     }
-    handleSslError(client_ssl.get(), client_err, false);
-    handleSslError(server_ssl.get(), server_err, true);
+    handleSslError(client_ssl, client_err, false);
+    handleSslError(server_ssl, server_err, true);
   }
 
   RELEASE_ASSERT(handshake_success, "handshake completed successfully");
+}
+
+static void testThroughput(benchmark::State& state) {
+  int sockets[2];
+  socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets);
+
+  bssl::UniquePtr<SSL_CTX> server_ctx = newServerContext();
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+
+  bssl::UniquePtr<SSL> server_ssl(SSL_new(server_ctx.get()));
+  SSL_set_fd(server_ssl.get(), sockets[0]);
+  SSL_set_accept_state(server_ssl.get());
+
+  bssl::UniquePtr<SSL> client_ssl(SSL_new(client_ctx.get()));
+  SSL_set_fd(client_ssl.get(), sockets[1]);
+  SSL_set_connect_state(client_ssl.get());
+
+  doHandshake(client_ssl.get(), server_ssl.get());
 
   static uint8_t read_buf[1024 * 1024];
 
@@ -119,6 +136,7 @@ static void testThroughput(benchmark::State& state) {
   unsigned num_short_slices = state.range(1);
   unsigned align_to_16kb = state.range(2);
   unsigned move_slices = state.range(3);
+  unsigned record_per_slice = state.range(4);
 
   uint64_t bytes_written = 0;
   for (auto _ : state) {
@@ -155,16 +173,21 @@ static void testThroughput(benchmark::State& state) {
     state.ResumeTiming();
     uint32_t num_writes = 0;
     uint32_t num_times_linearize_did_something = 0;
+    uint64_t bytes_linearized = 0;
     while (write_buf.length() > 0) {
       const Buffer::RawSlice initial = write_buf.frontSlice();
       void* mem;
-      size_t len = std::min<uint64_t>(write_buf.length(), 16384);
+      // Chunk the buffer like SslSocket does with or without
+      // envoy.reloadable_features.tls_write_records_per_slice.
+      size_t len = record_per_slice ? Utility::nextRecordSize(write_buf)
+                                    : std::min<uint64_t>(write_buf.length(), 16384);
       mem = write_buf.linearize(len);
       if (write_buf.frontSlice() != initial) {
         ++num_times_linearize_did_something;
+        bytes_linearized += len;
       }
 
-      err = SSL_write(client_ssl.get(), mem, len);
+      int err = SSL_write(client_ssl.get(), mem, len);
       RELEASE_ASSERT(err == static_cast<int>(len),
                      absl::StrCat("SSL_write got: ", err, " expected: ", len));
       write_buf.drain(len);
@@ -173,6 +196,7 @@ static void testThroughput(benchmark::State& state) {
 
     state.counters["writes_per_iteration"] = num_writes;
     state.counters["num_linearized"] = num_times_linearize_did_something;
+    state.counters["bytes_linearized"] = bytes_linearized;
   }
   state.counters["throughput"] = benchmark::Counter(bytes_written, benchmark::Counter::kIsRate);
 
@@ -181,15 +205,19 @@ static void testThroughput(benchmark::State& state) {
 }
 
 static void testParams(benchmark::internal::Benchmark* b) {
-  for (auto move_slices : {false, true}) {
-    for (auto align_to_16kb : {false, true}) {
-      // Add a single case of no short slices; don't iterate over the sizes
-      // which duplicates test cases when count is zero.
-      b->Args({0, 0, align_to_16kb, move_slices});
-
-      for (auto short_slice_size : {1, 128, 4095, 4096, 4097}) {
-        for (auto num_short_slices : {1, 2, 3}) {
-          b->Args({short_slice_size, num_short_slices, align_to_16kb, move_slices});
+  for (auto record_per_slice : {false, true}) {
+    for (auto move_slices : {false, true}) {
+      for (auto align_to_16kb : {false, true}) {
+        // Add a single case of no short slices; don't iterate over the sizes
+        // which duplicates test cases when count is zero.
+        b->Args({0, 0, align_to_16kb, move_slices, record_per_slice});
+
+        // 9 bytes is the size of an HTTP/2 frame header.
+        for (auto short_slice_size : {1, 9, 128, 4095, 4096, 4097}) {
+          for (auto num_short_slices : {1, 2, 3}) {
+            b->Args(
+                {short_slice_size, num_short_slices, align_to_16kb, move_slices, record_per_slice});
+          }
         }
       }
     }
@@ -198,5 +226,117 @@ static void testParams(benchmark::internal::Benchmark* b) {
 
 BENCHMARK(testThroughput)->Unit(::benchmark::kMicrosecond)->Apply(testParams);
 
+// Returns a pair of non-blocking TCP sockets connected over loopback, as kernel TLS is not
+// supported on UNIX domain sockets.
+static std::pair<int, int> loopbackSocketPair() {
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t address_len = sizeof(address);
+  RELEASE_ASSERT(bind(listener, reinterpret_cast<sockaddr*>(&address), address_len) == 0, "bind");
+  RELEASE_ASSERT(listen(listener, 1) == 0, "listen");
+  RELEASE_ASSERT(getsockname(listener, reinterpret_cast<sockaddr*>(&address), &address_len) == 0,
+                 "getsockname");
+
+  int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+  RELEASE_ASSERT(connect(client_fd, reinterpret_cast<sockaddr*>(&address), address_len) == 0,
+                 "connect");
+  int server_fd = accept(listener, nullptr, nullptr);
+  RELEASE_ASSERT(server_fd >= 0, "accept");
+  ::close(listener);
+
+  for (int fd : {client_fd, server_fd}) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  }
+  return {client_fd, server_fd};
+}
+
+// Writes application data over a TLS 1.2 AES-GCM connection, with the records encrypted either by
+// BoringSSL in chunks of the maximum record size, as SslSocket does by default, or by the kernel
+// after the keys are handed to it, as SslSocket does with kernel TLS offload. The receiving side
+// decrypts the records with BoringSSL outside of the timed section. The first argument enables (1)
+// or disables (0) kernel TLS, and the second one is the number of bytes written per iteration.
+static void testKernelTlsThroughput(benchmark::State& state) {
+  const bool kernel_tls = state.range(0);
+  const uint64_t write_size = state.range(1);
+
+  const auto [client_fd, server_fd] = loopbackSocketPair();
+  // Owns and closes the client socket.
+  Network::IoSocketHandleImpl client_handle(client_fd);
+
+  bssl::UniquePtr<SSL_CTX> server_ctx = newServerContext();
+  bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+  RELEASE_ASSERT(SSL_CTX_set_max_proto_version(client_ctx.get(), TLS1_2_VERSION), "");
+  RELEASE_ASSERT(SSL_CTX_set_strict_cipher_list(client_ctx.get(), "ECDHE-RSA-AES128-GCM-SHA256"),
+                 "");
+
+  bssl::UniquePtr<SSL> server_ssl(SSL_new(server_ctx.get()));
+  SSL_set_fd(server_ssl.get(), server_fd);
+  SSL_set_accept_state(server_ssl.get());
+
+  bssl::UniquePtr<SSL> client_ssl(SSL_new(client_ctx.get()));
+  SSL_set_fd(client_ssl.get(), client_fd);
+  SSL_set_connect_state(client_ssl.get());
+
+  doHandshake(client_ssl.get(), server_ssl.get());
+
+  if (kernel_tls && !enableKernelTls(client_ssl.get(), client_handle).tx_) {
+    state.SkipWithError("kernel TLS is not supported");
+    ::close(server_fd);
+    return;
+  }
+
+  static uint8_t read_buf[1024 * 1024];
+  const auto drain_server = [&]() {
+    state.PauseTiming();
+    while (SSL_read(server_ssl.get(), read_buf, sizeof(read_buf)) > 0) {
+    }
+    state.ResumeTiming();
+  };
+
+  const std::string data(write_size, 'a');
+  uint64_t bytes_written = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Buffer::OwnedImpl write_buf(data);
+    while (write_buf.length() > 0) {
+      if (kernel_tls) {
+        Api::IoCallUint64Result result = client_handle.write(write_buf);
+        if (!result.ok()) {
+          RELEASE_ASSERT(result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again,
+                         result.err_->getErrorDetails());
+          drain_server();
+        }
+        continue;
+      }
+      // SSL_write() has to be retried with the same arguments, which linearize() returns again.
+      const size_t len = std::min<uint64_t>(write_buf.length(), 16384);
+      int err = SSL_write(client_ssl.get(), write_buf.linearize(len), len);
+      if (err > 0) {
+        write_buf.drain(err);
+      } else {
+        RELEASE_ASSERT(SSL_get_error(client_ssl.get(), err) == SSL_ERROR_WANT_WRITE,
+                       "SSL_write failed");
+        drain_server();
+      }
+    }
+    bytes_written += write_size;
+  }
+  state.counters["throughput"] = benchmark::Counter(bytes_written, benchmark::Counter::kIsRate);
+
+  ::close(server_fd);
+}
+
+static void kernelTlsParams(benchmark::internal::Benchmark* b) {
+  for (auto kernel_tls : {false, true}) {
+    for (auto write_size : {16384, 65536, 1024 * 1024}) {
+      b->Args({kernel_tls, write_size});
+    }
+  }
+}
+
+BENCHMARK(testKernelTlsThroughput)->Unit(::benchmark::kMicrosecond)->Apply(kernelTlsParams);
+
 } // namespace Extensions::TransportSockets::Tls
 } // namespace Envoy
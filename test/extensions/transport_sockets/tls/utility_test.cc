@@ -1,6 +1,8 @@
 #include <string>
 #include <vector>
 
+#include "common/buffer/buffer_impl.h"
+
 #include "extensions/transport_sockets/tls/utility.h"
 
 #include "test/extensions/transport_sockets/tls/ssl_test_utility.h"
@@ -138,6 +140,48 @@ TEST(UtilityTest, TestGetCertificationExtensionValue) {
   EXPECT_EQ("", Utility::getCertificateExtensionValue(*cert, "foo"));
 }
 
+TEST(UtilityTest, NextRecordSize) {
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(0, Utility::nextRecordSize(buffer));
+
+  // Short slices are coalesced up to a full sized record.
+  for (int i = 0; i < 5; i++) {
+    buffer.appendSliceForTest(std::string(4000, 'a'));
+  }
+  EXPECT_EQ(Utility::MaxTlsRecordSize, Utility::nextRecordSize(buffer));
+  buffer.drain(Utility::MaxTlsRecordSize);
+  EXPECT_EQ(20000 - Utility::MaxTlsRecordSize, Utility::nextRecordSize(buffer));
+
+  // A short prefix is coalesced into the long slice after it.
+  buffer.appendSliceForTest(std::string(20000, 'b'));
+  EXPECT_EQ(Utility::MaxTlsRecordSize, Utility::nextRecordSize(buffer));
+  buffer.drain(Utility::MaxTlsRecordSize);
+
+  // Long slices end records, so that the slices after them don't cause them to be copied.
+  buffer.appendSliceForTest(std::string(10000, 'c'));
+  EXPECT_EQ(40000 - 2 * Utility::MaxTlsRecordSize, Utility::nextRecordSize(buffer));
+  buffer.drain(40000 - 2 * Utility::MaxTlsRecordSize);
+  EXPECT_EQ(10000, Utility::nextRecordSize(buffer));
+  buffer.drain(10000);
+
+  // A large enough prefix is written as a record of its own rather than copying the long slice
+  // after it.
+  buffer.appendSliceForTest(std::string(3000, 'd'));
+  buffer.appendSliceForTest(std::string(3000, 'e'));
+  buffer.appendSliceForTest(std::string(Utility::MaxTlsRecordSize, 'f'));
+  EXPECT_EQ(6000, Utility::nextRecordSize(buffer));
+  buffer.drain(6000);
+  EXPECT_EQ(Utility::MaxTlsRecordSize, Utility::nextRecordSize(buffer));
+
+  // An HTTP/2 frame header goes in the same record as the DATA frame after it.
+  buffer.drain(Utility::MaxTlsRecordSize);
+  buffer.appendSliceForTest(std::string(9, 'g'));
+  buffer.appendSliceForTest(std::string(Utility::MaxTlsRecordSize, 'h'));
+  EXPECT_EQ(Utility::MaxTlsRecordSize, Utility::nextRecordSize(buffer));
+  buffer.drain(Utility::MaxTlsRecordSize);
+  EXPECT_EQ(9, Utility::nextRecordSize(buffer));
+}
+
 } // namespace
 } // namespace Tls
 } // namespace TransportSockets
@@ -660,7 +660,7 @@ private:
       return socket_->addressProvider().localAddress();
     }
 
-    Network::SocketSharedPtr getListenSocket() override { return socket_; }
+    Network::SocketSharedPtr getListenSocket(uint32_t) override { return socket_; }
     Network::SocketOptRef sharedSocket() const override { return *socket_; }
 
   private:
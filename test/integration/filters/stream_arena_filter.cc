@@ -0,0 +1,53 @@
+#include <string>
+
+#include "envoy/http/filter.h"
+#include "envoy/registry/registry.h"
+#include "envoy/server/filter_config.h"
+
+#include "extensions/filters/http/common/pass_through_filter.h"
+
+#include "test/extensions/filters/http/common/empty_http_filter_config.h"
+
+namespace Envoy {
+
+// A test filter that keeps a copy of the request path in the stream arena, if the stream has one,
+// and returns it in a response header.
+class StreamArenaFilter : public Http::PassThroughFilter {
+public:
+  Http::FilterHeadersStatus decodeHeaders(Http::RequestHeaderMap& headers, bool) override {
+    Http::StreamArenaOptRef arena = decoder_callbacks_->streamArena();
+    if (arena.has_value()) {
+      path_ = &arena->create<std::string>(headers.getPathValue());
+    }
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+  Http::FilterHeadersStatus encodeHeaders(Http::ResponseHeaderMap& headers, bool) override {
+    headers.addCopy(Http::LowerCaseString("stream-arena-path"),
+                    path_ != nullptr ? *path_ : "none");
+    return Http::FilterHeadersStatus::Continue;
+  }
+
+private:
+  // Owned by the arena, which outlives the filter.
+  const std::string* path_{};
+};
+
+class StreamArenaFilterConfig : public Extensions::HttpFilters::Common::EmptyHttpFilterConfig {
+public:
+  StreamArenaFilterConfig() : EmptyHttpFilterConfig("stream-arena-filter") {}
+
+  Http::FilterFactoryCb createFilter(const std::string&,
+                                     Server::Configuration::FactoryContext&) override {
+    return [](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+      callbacks.addStreamFilter(std::make_shared<::Envoy::StreamArenaFilter>());
+    };
+  }
+};
+
+// perform static registration
+static Registry::RegisterFactory<StreamArenaFilterConfig,
+                                 Server::Configuration::NamedHttpFilterConfigFactory>
+    register_;
+
+} // namespace Envoy
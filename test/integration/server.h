@@ -240,10 +240,12 @@ public:
 
 protected:
   Stats::Counter* makeCounterInternal(StatName name, StatName tag_extracted_name,
-                                      const StatNameTagVector& stat_name_tags) override {
-    Stats::Counter* counter = new NotifyingCounter(
-        Stats::AllocatorImpl::makeCounterInternal(name, tag_extracted_name, stat_name_tags), mutex_,
-        condvar_);
+                                      const StatNameTagVector& stat_name_tags,
+                                      uint16_t shard_index) override {
+    Stats::Counter* counter =
+        new NotifyingCounter(Stats::AllocatorImpl::makeCounterInternal(name, tag_extracted_name,
+                                                                       stat_name_tags, shard_index),
+                             mutex_, condvar_);
     {
       absl::MutexLock l(&mutex_);
       // Allow getting the counter directly from the allocator, since it's harder to
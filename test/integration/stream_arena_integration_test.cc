@@ -0,0 +1,155 @@
+#include "envoy/extensions/filters/network/http_connection_manager/v3/http_connection_manager.pb.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/integration/http_protocol_integration.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+constexpr uint32_t RequestCount = 5;
+
+class StreamArenaIntegrationTest : public HttpProtocolIntegrationTest {
+public:
+  void initialize() override {
+    config_helper_.addFilter(R"EOF(
+name: stream-arena-filter
+)EOF");
+    HttpProtocolIntegrationTest::initialize();
+  }
+
+  void setStreamArenaBlockSize(uint32_t block_size) {
+    config_helper_.addConfigModifier(
+        [block_size](
+            envoy::extensions::filters::network::http_connection_manager::v3::HttpConnectionManager&
+                hcm) { hcm.mutable_stream_arena_block_size()->set_value(block_size); });
+  }
+
+  // Sends RequestCount requests on one connection, and returns the value of the
+  // stream-arena-path response header of the last one.
+  std::string sendRequests() {
+    codec_client_ = makeHttpConnection(lookupPort("http"));
+    std::string arena_path;
+    for (uint32_t i = 0; i < RequestCount; ++i) {
+      auto response =
+          sendRequestAndWaitForResponse(default_request_headers_, 0, default_response_headers_, 0);
+      EXPECT_TRUE(response->complete());
+      EXPECT_EQ("200", response->headers().getStatusValue());
+      arena_path = std::string(response->headers()
+                                   .get(Http::LowerCaseString("stream-arena-path"))[0]
+                                   ->value()
+                                   .getStringView());
+    }
+    codec_client_->close();
+    return arena_path;
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(Protocols, StreamArenaIntegrationTest,
+                         testing::ValuesIn(HttpProtocolIntegrationTest::getProtocolTestParams(
+                             {Http::CodecClient::Type::HTTP1, Http::CodecClient::Type::HTTP2},
+                             {FakeHttpConnection::Type::HTTP1})),
+                         HttpProtocolIntegrationTest::protocolTestParamsToString);
+
+// Without a block size, streams have no arena and everything is allocated from the heap.
+TEST_P(StreamArenaIntegrationTest, Disabled) {
+  initialize();
+  EXPECT_EQ("none", sendRequests());
+
+  test_server_->waitForCounterEq("http.config_test.downstream_rq_completed", RequestCount);
+  EXPECT_EQ(0, test_server_->counter("http.config_test.downstream_rq_arena_blocks")->value());
+}
+
+// With a block size, the filter wrappers of each stream and the objects filters create through
+// their callbacks share one block per stream.
+TEST_P(StreamArenaIntegrationTest, Enabled) {
+  setStreamArenaBlockSize(4096);
+  initialize();
+  EXPECT_EQ("/test/long/url", sendRequests());
+
+  test_server_->waitForCounterEq("http.config_test.downstream_rq_completed", RequestCount);
+  EXPECT_EQ(RequestCount,
+            test_server_->counter("http.config_test.downstream_rq_arena_blocks")->value());
+}
+
+// This class itself does not add additional tests. It is a helper for measuring the heap memory
+// of in-flight streams with different arena configurations.
+class StreamArenaMemoryTestHelper : public HttpIntegrationTest {
+public:
+  StreamArenaMemoryTestHelper()
+      : HttpIntegrationTest(Http::CodecClient::Type::HTTP2,
+                            testing::TestWithParam<Network::Address::IpVersion>::GetParam()) {
+    setUpstreamProtocol(FakeHttpConnection::Type::HTTP2);
+  }
+
+  /**
+   * @param block_size the stream arena block size, or 0 for no arena.
+   * @return size_t the heap memory held by the whole test process per in-flight request.
+   */
+  static size_t memoryPerStream(uint32_t block_size) {
+    StreamArenaMemoryTestHelper helper;
+    return helper.memoryPerStreamHelper(block_size);
+  }
+
+private:
+  static constexpr uint32_t StreamCount = 100;
+
+  size_t memoryPerStreamHelper(uint32_t block_size) {
+    config_helper_.addFilter(R"EOF(
+name: stream-arena-filter
+)EOF");
+    if (block_size != 0) {
+      config_helper_.addConfigModifier(
+          [block_size](envoy::extensions::filters::network::http_connection_manager::v3::
+                           HttpConnectionManager& hcm) {
+            hcm.mutable_stream_arena_block_size()->set_value(block_size);
+          });
+    }
+    initialize();
+
+    // The first request sets up the connections, so that only the streams are measured.
+    codec_client_ = makeHttpConnection(lookupPort("http"));
+    std::vector<IntegrationStreamDecoderPtr> responses;
+    std::vector<FakeStreamPtr> upstream_requests(StreamCount + 1);
+    responses.push_back(codec_client_->makeHeaderOnlyRequest(default_request_headers_));
+    EXPECT_TRUE(fake_upstreams_[0]->waitForHttpConnection(*dispatcher_, fake_upstream_connection_));
+    EXPECT_TRUE(fake_upstream_connection_->waitForNewStream(*dispatcher_, upstream_requests[0]));
+
+    Stats::TestUtil::MemoryTest memory_test;
+    for (uint32_t i = 1; i <= StreamCount; ++i) {
+      responses.push_back(codec_client_->makeHeaderOnlyRequest(default_request_headers_));
+      EXPECT_TRUE(fake_upstream_connection_->waitForNewStream(*dispatcher_, upstream_requests[i]));
+    }
+    const size_t consumed_bytes = memory_test.consumedBytes();
+    // Close the connections while the responses and upstream requests are still alive.
+    cleanupUpstreamAndDownstream();
+    return consumed_bytes / StreamCount;
+  }
+};
+
+class StreamArenaMemoryTestRunner : public testing::TestWithParam<Network::Address::IpVersion> {};
+
+INSTANTIATE_TEST_SUITE_P(IpVersions, StreamArenaMemoryTestRunner,
+                         testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
+                         TestUtility::ipTestParamsToString);
+
+// Measures what the arena costs in heap memory per stream. The arena saves the heap allocations
+// of the decoder and encoder wrappers of the test filter and of the decoder wrapper of the router,
+// a few hundred bytes, and takes a 4 KiB block instead, so each in-flight stream holds a bit less
+// than 4 KiB more.
+TEST_P(StreamArenaMemoryTestRunner, MemoryPerStream) {
+  const size_t without_arena = StreamArenaMemoryTestHelper::memoryPerStream(0);
+  const size_t with_arena = StreamArenaMemoryTestHelper::memoryPerStream(4096);
+  ENVOY_LOG_MISC(info, "heap memory per stream: {} bytes without an arena, {} bytes with one",
+                 without_arena, with_arena);
+
+  if (Stats::TestUtil::MemoryTest::mode() != Stats::TestUtil::MemoryTest::Mode::Disabled) {
+    EXPECT_GT(with_arena, without_arena + 3072);
+    // Round up to allow for the block header and allocator size classes.
+    EXPECT_LE(with_arena, without_arena + 4608);
+  }
+}
+
+} // namespace
+} // namespace Envoy
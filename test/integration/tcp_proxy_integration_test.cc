@@ -8,6 +8,7 @@
 #include "envoy/config/filter/network/tcp_proxy/v2/tcp_proxy.pb.h"
 #include "envoy/extensions/access_loggers/file/v3/file.pb.h"
 #include "envoy/extensions/filters/network/tcp_proxy/v3/tcp_proxy.pb.h"
+#include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
 
 #include "common/config/api_version.h"
 #include "common/network/utility.h"
@@ -1297,4 +1298,30 @@ TEST_P(TcpProxySslIntegrationTest, UpstreamHalfClose) {
   ASSERT_TRUE(fake_upstream_connection_->waitForHalfClose());
 }
 
+// Test that the streams of a downstream connection offloaded to kernel TLS end gracefully when
+// splicing is enabled: the close_notify alerts are proxied as half closes, not as errors.
+TEST_P(TcpProxySslIntegrationTest, KernelTlsSpliceGracefulClose) {
+  config_helper_.addConfigModifier([&](envoy::config::bootstrap::v3::Bootstrap& bootstrap) -> void {
+    auto* filter_chain =
+        bootstrap.mutable_static_resources()->mutable_listeners(0)->mutable_filter_chains(0);
+    auto* config_blob = filter_chain->mutable_filters(0)->mutable_typed_config();
+    auto tcp_proxy_config = MessageUtil::anyConvert<API_NO_BOOST(
+        envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy)>(*config_blob);
+    tcp_proxy_config.set_use_splice(true);
+    config_blob->PackFrom(tcp_proxy_config);
+
+    auto* tls_blob = filter_chain->mutable_transport_socket()->mutable_typed_config();
+    auto tls_context = MessageUtil::anyConvert<
+        envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext>(*tls_blob);
+    auto* common_tls_context = tls_context.mutable_common_tls_context();
+    common_tls_context->set_kernel_tls_offload(true);
+    common_tls_context->mutable_tls_params()->set_tls_maximum_protocol_version(
+        envoy::extensions::transport_sockets::tls::v3::TlsParameters::TLSv1_2);
+    tls_blob->PackFrom(tls_context);
+  });
+  setupConnections();
+  sendAndReceiveTlsData("hello", "world");
+  EXPECT_EQ(0, test_server_->counter("tcp.tcp_stats.downstream_cx_splice_total")->value());
+}
+
 } // namespace Envoy
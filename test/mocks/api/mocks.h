@@ -109,6 +109,23 @@ class MockLinuxOsSysCalls : public LinuxOsSysCallsImpl {
 public:
   // Api::LinuxOsSysCalls
   MOCK_METHOD(SysCallIntResult, sched_getaffinity, (pid_t pid, size_t cpusetsize, cpu_set_t* mask));
+  MOCK_METHOD(SysCallIntResult, sched_setaffinity,
+              (pid_t pid, size_t cpusetsize, const cpu_set_t* mask));
+  MOCK_METHOD(SysCallIntResult, getcpu, (unsigned* cpu, unsigned* node));
+  MOCK_METHOD(SysCallIntResult, set_mempolicy,
+              (int mode, const unsigned long* nodemask, unsigned long maxnode));
+  MOCK_METHOD(SysCallIntResult, get_mempolicy,
+              (int* mode, unsigned long* nodemask, unsigned long maxnode, void* addr,
+               unsigned long flags));
+  MOCK_METHOD(SysCallIntResult, pipe2, (int pipefd[2], int flags));
+  MOCK_METHOD(SysCallSizeResult, splice,
+              (int fd_in, loff_t* off_in, int fd_out, loff_t* off_out, size_t len,
+               unsigned int flags));
+  MOCK_METHOD(SysCallIntResult, io_uring_setup, (unsigned entries, io_uring_params* params));
+  MOCK_METHOD(SysCallIntResult, io_uring_enter,
+              (int fd, unsigned to_submit, unsigned min_complete, unsigned flags));
+  MOCK_METHOD(SysCallIntResult, io_uring_register,
+              (int fd, unsigned opcode, const void* arg, unsigned nr_args));
 };
 #endif
 
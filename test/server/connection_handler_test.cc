@@ -217,7 +217,7 @@ public:
       // If so, dispatcher would not create new network listener.
       return listeners_.back().get();
     }
-    EXPECT_CALL(*socket_factory_, getListenSocket()).WillOnce(Return(listeners_.back()->socket_));
+    EXPECT_CALL(*socket_factory_, getListenSocket(_)).WillOnce(Return(listeners_.back()->socket_));
     if (socket_type == Network::Socket::Type::Stream) {
       EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
           .WillOnce(Invoke([listener, listener_callbacks](Network::SocketSharedPtr&&,
@@ -1234,7 +1234,7 @@ TEST_F(ConnectionHandlerTest, TcpBacklogCustom) {
   TestListener* test_listener = addListener(
       1, true, false, "test_tcp_backlog", nullptr, nullptr, nullptr, nullptr,
       Network::Socket::Type::Stream, std::chrono::milliseconds(), false, nullptr, custom_backlog);
-  EXPECT_CALL(*socket_factory_, getListenSocket()).WillOnce(Return(listeners_.back()->socket_));
+  EXPECT_CALL(*socket_factory_, getListenSocket(_)).WillOnce(Return(listeners_.back()->socket_));
   EXPECT_CALL(*socket_factory_, localAddress()).WillOnce(ReturnRef(local_address_));
   EXPECT_CALL(dispatcher_, createListener_(_, _, _, _))
       .WillOnce(Invoke([custom_backlog](Network::SocketSharedPtr&&, Network::TcpListenerCallbacks&,
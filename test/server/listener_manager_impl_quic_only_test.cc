@@ -102,7 +102,7 @@ udp_writer_config:
   EXPECT_EQ(1u, manager_->listeners().size());
   EXPECT_FALSE(manager_->listeners()[0].get().udpListenerFactory()->isTransportConnectionless());
   Network::SocketSharedPtr listen_socket =
-      manager_->listeners().front().get().listenSocketFactory().getListenSocket();
+      manager_->listeners().front().get().listenSocketFactory().getListenSocket(0);
 
   Network::UdpPacketWriterPtr udp_packet_writer =
       manager_->listeners().front().get().udpPacketWriterFactory()->get().createUdpPacketWriter(
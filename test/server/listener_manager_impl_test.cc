@@ -19,6 +19,7 @@
 #include "common/init/manager_impl.h"
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_handle_impl.h"
+#include "common/network/reuse_port_cpu_steering_socket_option_impl.h"
 #include "common/network/utility.h"
 #include "common/protobuf/protobuf.h"
 
@@ -40,6 +41,7 @@ namespace Server {
 namespace {
 
 using testing::AtLeast;
+using testing::ByMove;
 using testing::InSequence;
 using testing::Return;
 using testing::ReturnRef;
@@ -4014,6 +4016,80 @@ TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortListenerEnabledForTcp) {
                    /* expected_creation_params */ {true, false});
 }
 
+// Validate that the CPU balancer adds its steering program to the reuse_port options.
+TEST_F(ListenerManagerImplWithRealFiltersTest, CpuBalanceListener) {
+  auto listener = createIPv4Listener("CpuBalanceListener");
+  listener.set_reuse_port(true);
+  listener.mutable_address()->mutable_socket_address()->set_port_value(0);
+  listener.mutable_connection_balance_config()->mutable_cpu_balance();
+
+  if (!Network::ReusePortCpuSteeringSocketOptionImpl::isSupported()) {
+    EXPECT_THROW_WITH_MESSAGE(manager_->addOrUpdateListener(listener, "", true), EnvoyException,
+                              "error adding listener '127.0.0.1:0': cpu_balance is not supported "
+                              "on this platform");
+    EXPECT_EQ(0U, manager_->listeners().size());
+    return;
+  }
+
+  // The program is only attached once the workers listen on their sockets.
+  expectCreateListenSocket(envoy::config::core::v3::SocketOption::STATE_PREBIND,
+                           /* expected_num_options */ 2,
+                           /* expected_creation_params */ {true, false});
+  expectSetsockopt(ENVOY_SOCKET_SO_REUSEPORT.level(), ENVOY_SOCKET_SO_REUSEPORT.option(),
+                   /* expected_value */ 1);
+  manager_->addOrUpdateListener(listener, "", true);
+  EXPECT_EQ(1U, manager_->listeners().size());
+}
+
+// With CPU balance, the sockets of the workers listen in worker order once the first worker gets
+// its socket, so that socket i of the SO_REUSEPORT group is worker i's.
+TEST_F(ListenerManagerImplWithRealFiltersTest, CpuBalanceListenerSocketsListenInWorkerOrder) {
+  if (!Network::ReusePortCpuSteeringSocketOptionImpl::isSupported()) {
+    return;
+  }
+  server_.options_.concurrency_ = 2;
+  auto listener = createIPv4Listener("CpuBalanceListener");
+  listener.set_reuse_port(true);
+  listener.mutable_connection_balance_config()->mutable_cpu_balance();
+
+  std::vector<std::shared_ptr<NiceMock<Network::MockListenSocket>>> sockets;
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([&sockets](auto, auto, auto, auto) -> Network::SocketSharedPtr {
+        sockets.push_back(std::make_shared<NiceMock<Network::MockListenSocket>>());
+        return sockets.back();
+      }));
+  manager_->addOrUpdateListener(listener, "", true);
+  ASSERT_EQ(2, sockets.size());
+  Network::ListenSocketFactory& socket_factory =
+      manager_->listeners().front().get().listenSocketFactory();
+
+  {
+    InSequence s;
+    EXPECT_CALL(*sockets[0], listen(_)).WillOnce(Return(Api::SysCallIntResult{0, 0}));
+    EXPECT_CALL(*sockets[1], listen(_)).WillOnce(Return(Api::SysCallIntResult{0, 0}));
+  }
+  auto duplicate = std::make_unique<NiceMock<Network::MockListenSocket>>();
+  Network::Socket* duplicate_ptr = duplicate.get();
+  EXPECT_CALL(*sockets[1], duplicate()).WillOnce(Return(ByMove(std::move(duplicate))));
+  EXPECT_EQ(duplicate_ptr, socket_factory.getListenSocket(1).get());
+
+  // The sockets only start listening once.
+  EXPECT_CALL(*sockets[0], duplicate())
+      .WillOnce(Return(ByMove(std::make_unique<NiceMock<Network::MockListenSocket>>())));
+  EXPECT_NE(nullptr, socket_factory.getListenSocket(0));
+}
+
+TEST_F(ListenerManagerImplWithRealFiltersTest, CpuBalanceRequiresReusePort) {
+  auto listener = createIPv4Listener("CpuBalanceListener");
+  listener.mutable_connection_balance_config()->mutable_cpu_balance();
+
+  EXPECT_THROW_WITH_MESSAGE(
+      manager_->addOrUpdateListener(listener, "", true), EnvoyException,
+      "error adding listener '127.0.0.1:1111': cpu_balance requires reuse_port to be set");
+  EXPECT_EQ(0U, manager_->listeners().size());
+}
+
 TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortListenerDisabled) {
   auto listener = createIPv4Listener("UdpListener");
   listener.mutable_address()->mutable_socket_address()->set_protocol(
@@ -4961,7 +5037,7 @@ filter_chains:
   manager_->addOrUpdateListener(listener, "", true);
   EXPECT_EQ(1U, manager_->listeners().size());
   Network::SocketSharedPtr listen_socket =
-      manager_->listeners().front().get().listenSocketFactory().getListenSocket();
+      manager_->listeners().front().get().listenSocketFactory().getListenSocket(0);
   Network::UdpPacketWriterPtr udp_packet_writer =
       manager_->listeners().front().get().udpPacketWriterFactory()->get().createUdpPacketWriter(
           listen_socket->ioHandle(), manager_->listeners()[0].get().listenerScope());
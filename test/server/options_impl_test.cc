@@ -75,6 +75,37 @@ TEST_F(OptionsImplTest, InvalidSocketMode) {
       MalformedArgvException, "error: invalid socket-mode 'foo'");
 }
 
+TEST_F(OptionsImplTest, InvalidFileFlushRingBufferBytes) {
+  EXPECT_THROW_WITH_REGEX(
+      createOptionsImpl("envoy --file-flush-ring-buffer-bytes 4095"), MalformedArgvException,
+      "error: file-flush-ring-buffer-bytes must be 0 or at least 4096, got 4095");
+}
+
+TEST_F(OptionsImplTest, InvalidCpuSet) {
+  EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy --worker-cpu-set 3-1"), MalformedArgvException,
+                          "error: invalid CPU list '3-1' for --worker-cpu-set");
+  EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy --worker-cpu-set 0,,1"), MalformedArgvException,
+                          "error: invalid CPU list '0,,1' for --worker-cpu-set");
+  EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy --main-thread-cpu-set 1024"),
+                          MalformedArgvException,
+                          "error: invalid CPU list '1024' for --main-thread-cpu-set");
+}
+
+TEST_F(OptionsImplTest, NumaLocalMemoryRequiresWorkerCpuSet) {
+  EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy --numa-local-memory"), MalformedArgvException,
+                          "error: --numa-local-memory requires --worker-cpu-set");
+}
+
+#if defined(__linux__)
+TEST_F(OptionsImplTest, CpuSets) {
+  std::unique_ptr<OptionsImpl> options = createOptionsImpl(
+      "envoy --worker-cpu-set 0-2,8 --main-thread-cpu-set 4 --numa-local-memory");
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2, 8}), options->workerCpuSet());
+  EXPECT_EQ(std::vector<uint32_t>({4}), options->mainThreadCpuSet());
+  EXPECT_TRUE(options->numaLocalMemoryEnabled());
+}
+#endif
+
 TEST_F(OptionsImplTest, V1Disallowed) {
   std::unique_ptr<OptionsImpl> options = createOptionsImpl(
       "envoy --mode validate --concurrency 2 -c hello --admin-address-path path --restart-epoch 1 "
@@ -89,7 +120,7 @@ TEST_F(OptionsImplTest, All) {
       "envoy --mode validate --concurrency 2 -c hello --admin-address-path path --restart-epoch 0 "
       "--local-address-ip-version v6 -l info --component-log-level upstream:debug,connection:trace "
       "--service-cluster cluster --service-node node --service-zone zone "
-      "--file-flush-interval-msec 9000 "
+      "--file-flush-interval-msec 9000 --file-flush-ring-buffer-bytes 65536 "
       "--drain-time-s 60 --log-format [%v] --enable-fine-grain-logging --parent-shutdown-time-s 90 "
       "--log-path "
       "/foo/bar "
@@ -112,6 +143,7 @@ TEST_F(OptionsImplTest, All) {
   EXPECT_EQ("node", options->serviceNodeName());
   EXPECT_EQ("zone", options->serviceZone());
   EXPECT_EQ(std::chrono::milliseconds(9000), options->fileFlushIntervalMsec());
+  EXPECT_EQ(65536U, options->fileFlushRingBufferBytes());
   EXPECT_EQ(std::chrono::seconds(60), options->drainTime());
   EXPECT_EQ(std::chrono::seconds(90), options->parentShutdownTime());
   EXPECT_TRUE(options->hotRestartDisabled());
@@ -173,6 +205,7 @@ TEST_F(OptionsImplTest, SetAll) {
   options->setLogPath("/foo/bar");
   options->setRestartEpoch(44);
   options->setFileFlushIntervalMsec(std::chrono::milliseconds(45));
+  options->setFileFlushRingBufferBytes(8192);
   options->setMode(Server::Mode::Validate);
   options->setServiceClusterName("cluster_foo");
   options->setServiceNodeName("node_foo");
@@ -180,6 +213,9 @@ TEST_F(OptionsImplTest, SetAll) {
   options->setHotRestartDisabled(!options->hotRestartDisabled());
   options->setSignalHandling(!options->signalHandlingEnabled());
   options->setCpusetThreads(!options->cpusetThreadsEnabled());
+  options->setWorkerCpuSet({0, 2});
+  options->setMainThreadCpuSet({1});
+  options->setNumaLocalMemory(true);
   options->setAllowUnkownFields(true);
   options->setRejectUnknownFieldsDynamic(true);
   options->setSocketPath("/foo/envoy_domain_socket");
@@ -204,6 +240,7 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(std::chrono::seconds(43), options->parentShutdownTime());
   EXPECT_EQ(44, options->restartEpoch());
   EXPECT_EQ(std::chrono::milliseconds(45), options->fileFlushIntervalMsec());
+  EXPECT_EQ(8192U, options->fileFlushRingBufferBytes());
   EXPECT_EQ(Server::Mode::Validate, options->mode());
   EXPECT_EQ("cluster_foo", options->serviceClusterName());
   EXPECT_EQ("node_foo", options->serviceNodeName());
@@ -211,6 +248,9 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(!hot_restart_disabled, options->hotRestartDisabled());
   EXPECT_EQ(!signal_handling_enabled, options->signalHandlingEnabled());
   EXPECT_EQ(!cpuset_threads_enabled, options->cpusetThreadsEnabled());
+  EXPECT_EQ(std::vector<uint32_t>({0, 2}), options->workerCpuSet());
+  EXPECT_EQ(std::vector<uint32_t>({1}), options->mainThreadCpuSet());
+  EXPECT_TRUE(options->numaLocalMemoryEnabled());
   EXPECT_TRUE(options->allowUnknownStaticFields());
   EXPECT_TRUE(options->rejectUnknownDynamicFields());
   EXPECT_EQ("/foo/envoy_domain_socket", options->socketPath());
@@ -237,6 +277,8 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(options->restartEpoch(), command_line_options->restart_epoch());
   EXPECT_EQ(options->fileFlushIntervalMsec().count() / 1000,
             command_line_options->file_flush_interval().seconds());
+  EXPECT_EQ(options->fileFlushRingBufferBytes(),
+            command_line_options->file_flush_ring_buffer_bytes());
   EXPECT_EQ(envoy::admin::v3::CommandLineOptions::Validate, command_line_options->mode());
   EXPECT_EQ(options->serviceClusterName(), command_line_options->service_cluster());
   EXPECT_EQ(options->serviceNodeName(), command_line_options->service_node());
@@ -244,6 +286,9 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(options->hotRestartDisabled(), command_line_options->disable_hot_restart());
   EXPECT_EQ(options->mutexTracingEnabled(), command_line_options->enable_mutex_tracing());
   EXPECT_EQ(options->cpusetThreadsEnabled(), command_line_options->cpuset_threads());
+  EXPECT_THAT(command_line_options->worker_cpu_set(), testing::ElementsAre(0, 2));
+  EXPECT_THAT(command_line_options->main_thread_cpu_set(), testing::ElementsAre(1));
+  EXPECT_TRUE(command_line_options->numa_local_memory());
   EXPECT_EQ(options->socketPath(), command_line_options->socket_path());
   EXPECT_EQ(options->socketMode(), command_line_options->socket_mode());
 }
@@ -259,8 +304,12 @@ TEST_F(OptionsImplTest, DefaultParams) {
   EXPECT_EQ(spdlog::level::warn, options->logLevel());
   EXPECT_EQ("@envoy_domain_socket", options->socketPath());
   EXPECT_EQ(0, options->socketMode());
+  EXPECT_EQ(0U, options->fileFlushRingBufferBytes());
   EXPECT_FALSE(options->hotRestartDisabled());
   EXPECT_FALSE(options->cpusetThreadsEnabled());
+  EXPECT_TRUE(options->workerCpuSet().empty());
+  EXPECT_TRUE(options->mainThreadCpuSet().empty());
+  EXPECT_FALSE(options->numaLocalMemoryEnabled());
 
   // Validate that CommandLineOptions is constructed correctly with default params.
   Server::CommandLineOptionsPtr command_line_options = options->toCommandLineOptions();
@@ -275,6 +324,8 @@ TEST_F(OptionsImplTest, DefaultParams) {
   EXPECT_EQ(0, command_line_options->socket_mode());
   EXPECT_FALSE(command_line_options->disable_hot_restart());
   EXPECT_FALSE(command_line_options->cpuset_threads());
+  EXPECT_EQ(0, command_line_options->worker_cpu_set_size());
+  EXPECT_FALSE(command_line_options->numa_local_memory());
   EXPECT_FALSE(command_line_options->allow_unknown_static_fields());
   EXPECT_FALSE(command_line_options->reject_unknown_dynamic_fields());
 }
@@ -426,8 +477,14 @@ TEST_F(OptionsImplTest, SaneTestConstructor) {
   EXPECT_EQ(regular_options_impl->mode(), test_options_impl.mode());
   EXPECT_EQ(regular_options_impl->fileFlushIntervalMsec(),
             test_options_impl.fileFlushIntervalMsec());
+  EXPECT_EQ(regular_options_impl->fileFlushRingBufferBytes(),
+            test_options_impl.fileFlushRingBufferBytes());
   EXPECT_EQ(regular_options_impl->hotRestartDisabled(), test_options_impl.hotRestartDisabled());
   EXPECT_EQ(regular_options_impl->cpusetThreadsEnabled(), test_options_impl.cpusetThreadsEnabled());
+  EXPECT_EQ(regular_options_impl->workerCpuSet(), test_options_impl.workerCpuSet());
+  EXPECT_EQ(regular_options_impl->mainThreadCpuSet(), test_options_impl.mainThreadCpuSet());
+  EXPECT_EQ(regular_options_impl->numaLocalMemoryEnabled(),
+            test_options_impl.numaLocalMemoryEnabled());
 }
 
 TEST_F(OptionsImplTest, SetBothConcurrencyAndCpuset) {
@@ -16,6 +16,7 @@
 #include "test/mocks/protobuf/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/registry.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -129,7 +130,7 @@ private:
   }
 };
 
-class OverloadManagerImplTest : public testing::Test {
+class OverloadManagerImplTest : public Event::TestUsingSimulatedTime, public testing::Test {
 protected:
   OverloadManagerImplTest()
       : factory1_("envoy.resource_monitors.fake_resource1"),
@@ -355,6 +356,67 @@ TEST_F(OverloadManagerImplTest, ScaledTrigger) {
   EXPECT_EQ(100, scale_percent_gauge.value());
 }
 
+constexpr char kPredictiveConfig[] = R"YAML(
+  refresh_interval:
+    seconds: 1
+  resource_monitors:
+    - name: envoy.resource_monitors.fake_resource1
+  actions:
+    - name: envoy.overload_actions.dummy_action
+      triggers:
+        - name: envoy.resource_monitors.fake_resource1
+          predictive:
+            value: 0.9
+            horizon:
+              seconds: 2
+)YAML";
+
+TEST_F(OverloadManagerImplTest, PredictiveTrigger) {
+  setDispatcherExpectation();
+
+  auto manager(createOverloadManager(kPredictiveConfig));
+  manager->start();
+  const auto& action_state =
+      manager->getThreadLocalOverloadState().getState("envoy.overload_actions.dummy_action");
+  Stats::Gauge& active_gauge = stats_.gauge("overload.envoy.overload_actions.dummy_action.active",
+                                            Stats::Gauge::ImportMode::Accumulate);
+
+  const auto update = [&](double pressure) {
+    simTime().advanceTimeWait(std::chrono::seconds(1));
+    factory1_.monitor_->setPressure(pressure);
+    timer_cb_();
+  };
+
+  // The smoothed rate of change is 0.05/s, then 0.125/s: the pressure predicted in 2 seconds
+  // stays under the threshold.
+  update(0.2);
+  update(0.3);
+  EXPECT_FALSE(action_state.isSaturated());
+  update(0.5);
+  EXPECT_FALSE(action_state.isSaturated());
+  EXPECT_EQ(0, active_gauge.value());
+
+  // The smoothed rate of change is 0.1625/s, so the pressure is predicted to reach 1.025.
+  update(0.7);
+  EXPECT_TRUE(action_state.isSaturated());
+  EXPECT_EQ(1, active_gauge.value());
+
+  // The pressure stops rising, so the prediction falls back to 0.8625.
+  update(0.7);
+  EXPECT_FALSE(action_state.isSaturated());
+
+  // A falling pressure above the threshold saturates the trigger.
+  update(0.95);
+  update(0.92);
+  EXPECT_TRUE(action_state.isSaturated());
+
+  update(0.5);
+  EXPECT_FALSE(action_state.isSaturated());
+  EXPECT_EQ(0, active_gauge.value());
+
+  manager->stop();
+}
+
 TEST_F(OverloadManagerImplTest, FailedUpdates) {
   setDispatcherExpectation();
   auto manager(createOverloadManager(kRegularStateConfig));
@@ -2,24 +2,33 @@
 
 #include "common/api/api_impl.h"
 #include "common/event/dispatcher_impl.h"
+#include "common/stats/isolated_store_impl.h"
 
 #include "server/worker_impl.h"
 
+#include "test/mocks/api/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/guard_dog.h"
 #include "test/mocks/server/instance.h"
 #include "test/mocks/server/overload_manager.h"
 #include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
 
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#endif
+
 using testing::_;
+using testing::DoAll;
 using testing::InSequence;
 using testing::Invoke;
 using testing::InvokeWithoutArgs;
 using testing::NiceMock;
 using testing::Return;
+using testing::SetArgPointee;
 using testing::Throw;
 
 namespace Envoy {
@@ -28,11 +37,14 @@ namespace {
 
 class WorkerImplTest : public testing::Test {
 public:
-  WorkerImplTest()
-      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("worker_test")),
+  WorkerImplTest() : WorkerImplTest(WorkerPlacement{}) {}
+
+  explicit WorkerImplTest(const WorkerPlacement& placement)
+      : api_(Api::createApiForTest(stats_store_)),
+        dispatcher_(api_->allocateDispatcher("worker_test")),
         no_exit_timer_(dispatcher_->createTimer([]() -> void {})),
         worker_(tls_, hooks_, std::move(dispatcher_), Network::ConnectionHandlerPtr{handler_},
-                overload_manager_, *api_) {
+                overload_manager_, *api_, placement) {
     // In the real worker the watchdog has timers that prevent exit. Here we need to prevent event
     // loop exit since we use mock timers.
     no_exit_timer_->enableTimer(std::chrono::hours(1));
@@ -49,6 +61,7 @@ public:
   Network::MockConnectionHandler* handler_ = new Network::MockConnectionHandler();
   NiceMock<MockGuardDog> guard_dog_;
   NiceMock<MockOverloadManager> overload_manager_;
+  Stats::IsolatedStoreImpl stats_store_;
   Api::ApiPtr api_;
   Event::DispatcherPtr dispatcher_;
   DefaultListenerHooks hooks_;
@@ -160,6 +173,71 @@ TEST_F(WorkerImplTest, ListenerException) {
   worker_.stop();
 }
 
+// A worker which isn't pinned doesn't report placement stats.
+TEST_F(WorkerImplTest, NotPinned) {
+  worker_.start(guard_dog_);
+  worker_.stop();
+  EXPECT_EQ(nullptr, TestUtility::findCounter(stats_store_, "server.worker_test.cpu_time_us"));
+}
+
+#ifdef __linux__
+class WorkerImplPlacementTest : public WorkerImplTest {
+public:
+  WorkerImplPlacementTest() : WorkerImplTest(WorkerPlacement{3, true}) {}
+
+  // Waits until the worker has run everything posted to it so far.
+  void waitForWorker() {
+    ConditionalInitializer ci;
+    NiceMock<Network::MockListenerConfig> listener;
+    EXPECT_CALL(*handler_, addListener(_, _));
+    worker_.addListener(absl::nullopt, listener, [&ci](bool) -> void { ci.setReady(); });
+    ci.waitReady();
+  }
+
+  Api::MockLinuxOsSysCalls linux_os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls_{&linux_os_sys_calls_};
+};
+
+// A pinned worker prefers the NUMA node of its CPU for its memory, and samples which node the
+// memory it allocates comes from.
+TEST_F(WorkerImplPlacementTest, PinnedToCpu) {
+  EXPECT_CALL(linux_os_sys_calls_, sched_setaffinity(0, sizeof(cpu_set_t), _))
+      .WillOnce(Invoke([](pid_t, size_t, const cpu_set_t* mask) -> Api::SysCallIntResult {
+        EXPECT_EQ(1, CPU_COUNT(mask));
+        EXPECT_TRUE(CPU_ISSET(3, mask));
+        return {0, 0};
+      }));
+  EXPECT_CALL(linux_os_sys_calls_, getcpu(_, _))
+      .WillOnce(DoAll(SetArgPointee<0>(3), SetArgPointee<1>(1),
+                      Return(Api::SysCallIntResult{0, 0})));
+  EXPECT_CALL(linux_os_sys_calls_, set_mempolicy(MPOL_PREFERRED, _, _))
+      .WillOnce(Invoke([](int, const unsigned long* nodemask, unsigned long maxnode) {
+        EXPECT_EQ(1UL << 1, nodemask[0]);
+        EXPECT_GT(maxnode, 1UL);
+        return Api::SysCallIntResult{0, 0};
+      }));
+  // The allocator hands the worker memory from another node.
+  ConditionalInitializer sampled;
+  EXPECT_CALL(linux_os_sys_calls_, get_mempolicy(_, nullptr, 0, _, MPOL_F_NODE | MPOL_F_ADDR))
+      .WillOnce(DoAll(SetArgPointee<0>(0), InvokeWithoutArgs([&sampled]() { sampled.setReady(); }),
+                      Return(Api::SysCallIntResult{0, 0})))
+      .WillRepeatedly(Return(Api::SysCallIntResult{-1, ENOSYS}));
+
+  worker_.start(guard_dog_);
+  sampled.waitReady();
+  waitForWorker();
+
+  EXPECT_EQ(1, TestUtility::findGauge(stats_store_, "server.worker_test.numa_node")->value());
+  EXPECT_EQ(1,
+            TestUtility::findCounter(stats_store_, "server.worker_test.memory_samples")->value());
+  EXPECT_EQ(1, TestUtility::findCounter(stats_store_, "server.worker_test.remote_memory_samples")
+                   ->value());
+  EXPECT_NE(nullptr, TestUtility::findCounter(stats_store_, "server.worker_test.cpu_time_us"));
+
+  worker_.stop();
+}
+#endif
+
 } // namespace
 } // namespace Server
 } // namespace Envoy